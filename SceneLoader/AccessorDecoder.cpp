@@ -0,0 +1,368 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "AccessorDecoder.h"
+#include "AccessorElements.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static uint8_t PackUnorm8(float value)
+    {
+        return static_cast<uint8_t>(min(max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+
+    AccessorDecoder::AccessorDecoder(
+        const Document& gltfDocument,
+        shared_ptr<GLTFResourceReader> gltfResourceReader,
+        shared_ptr<GLTFSource> gltfSource,
+        shared_ptr<LoadLimiter> limiter) :
+        m_gltfDocument(gltfDocument),
+        m_gltfResourceReader(gltfResourceReader),
+        m_gltfSource(gltfSource),
+        m_limiter(limiter)
+    {
+    }
+
+    ArenaArray<const uint8_t>
+    AccessorDecoder::GetBufferBytes(const string& bufferId)
+    {
+        lock_guard<mutex> lock(m_bufferLock);
+
+        auto it = m_bufferBytes.find(bufferId);
+
+        if (it != m_bufferBytes.end())
+        {
+            return it->second;
+        }
+
+        const Buffer& buffer = m_gltfDocument.buffers.Get(bufferId);
+
+        ArenaArray<const uint8_t> inPlace;
+
+        if (m_gltfSource && m_gltfSource->TryGetBufferBytes(buffer, &inPlace))
+        {
+            m_bufferBytes.emplace(bufferId, inPlace);
+            return inPlace;
+        }
+
+        // ResourceReader only hands out buffer views, so ask for one spanning the whole buffer.
+        BufferView wholeBuffer;
+        wholeBuffer.bufferId = buffer.id;
+        wholeBuffer.byteOffset = 0;
+        wholeBuffer.byteLength = buffer.byteLength;
+
+        // The SDK reads the declared length into memory of its own, which is copied from there.
+        m_limiter->ChargeDecodedBytes(buffer.byteLength, 2);
+
+        ArenaArray<uint8_t> bytes = m_bufferArena.AllocateArray<uint8_t>(buffer.byteLength);
+        {
+            vector<uint8_t> data = m_gltfResourceReader->ReadBinaryData<uint8_t>(m_gltfDocument, wholeBuffer);
+            memcpy(bytes.data, data.data(), min(data.size(), bytes.size));
+        }
+
+        ArenaArray<const uint8_t> result{ bytes.data, bytes.size };
+        m_bufferBytes.emplace(bufferId, result);
+
+        return result;
+    }
+
+    ArenaArray<const uint8_t>
+    AccessorDecoder::GetBufferViewBytes(const BufferView& bufferView)
+    {
+        ArenaArray<const uint8_t> bufferBytes = GetBufferBytes(bufferView.bufferId);
+
+        if (bufferView.byteOffset > bufferBytes.size || bufferView.byteLength > bufferBytes.size - bufferView.byteOffset)
+        {
+            throw InvalidGLTFException("Buffer view " + bufferView.id + " is out of the bounds of its buffer");
+        }
+
+        return { bufferBytes.data + bufferView.byteOffset, bufferView.byteLength };
+    }
+
+    ArenaArray<float>
+    AccessorDecoder::ReadFloats(DecodeArena& arena, const Accessor& accessor)
+    {
+        const size_t componentCount = Accessor::GetTypeCount(accessor.type);
+        const size_t componentSize = Accessor::GetComponentTypeSize(accessor.componentType);
+        const size_t elementSize = componentCount * componentSize;
+
+        m_limiter->ChargeDecodedBytes(accessor.count, componentCount * sizeof(float));
+
+        ArenaArray<float> result = arena.AllocateArray<float>(accessor.count * componentCount);
+
+        if (accessor.bufferViewId.empty())
+        {
+            // Only valid for sparse accessors: the base values are all zero.
+            memset(result.data, 0, result.ByteLength());
+        }
+        else
+        {
+            const BufferView& bufferView = m_gltfDocument.bufferViews.Get(accessor.bufferViewId);
+            ArenaArray<const uint8_t> viewBytes = GetBufferViewBytes(bufferView);
+            const size_t stride = bufferView.byteStride ? bufferView.byteStride.Get() : elementSize;
+
+            if (!IsElementRangeInBounds(viewBytes.size, accessor.byteOffset, accessor.count, elementSize, stride))
+            {
+                throw InvalidGLTFException("Accessor " + accessor.id + " is out of the bounds of its buffer view");
+            }
+
+            ConvertElementsToFloats(viewBytes.data + accessor.byteOffset, accessor.count, stride, componentCount, accessor.componentType, accessor.normalized, result.data);
+        }
+
+        if (accessor.sparse.count > 0)
+        {
+            DecodeArena::Scope scratch(arena);
+
+            ArenaArray<uint32_t> sparseIndices;
+            ArenaArray<float> sparseValues;
+            ReadSparseElements(arena, accessor, &sparseIndices, &sparseValues);
+
+            for (size_t i = 0; i < sparseIndices.size; ++i)
+            {
+                memcpy(result.data + sparseIndices[i] * componentCount, sparseValues.data + i * componentCount, componentCount * sizeof(float));
+            }
+        }
+
+        return result;
+    }
+
+    bool
+    AccessorDecoder::TryReadSparseFloats(DecodeArena& arena, const Accessor& accessor, ArenaArray<uint32_t>* pIndices, ArenaArray<float>* pValues)
+    {
+        if (!accessor.bufferViewId.empty() || accessor.sparse.count == 0)
+        {
+            return false;
+        }
+
+        ReadSparseElements(arena, accessor, pIndices, pValues);
+
+        return true;
+    }
+
+    void
+    AccessorDecoder::ReadSparseElements(DecodeArena& arena, const Accessor& accessor, ArenaArray<uint32_t>* pIndices, ArenaArray<float>* pValues)
+    {
+        const size_t componentCount = Accessor::GetTypeCount(accessor.type);
+        const size_t componentSize = Accessor::GetComponentTypeSize(accessor.componentType);
+        const size_t elementSize = componentCount * componentSize;
+
+        const BufferView& indicesView = m_gltfDocument.bufferViews.Get(accessor.sparse.indicesBufferViewId);
+        const BufferView& valuesView = m_gltfDocument.bufferViews.Get(accessor.sparse.valuesBufferViewId);
+        ArenaArray<const uint8_t> indexBytes = GetBufferViewBytes(indicesView);
+        ArenaArray<const uint8_t> valueBytes = GetBufferViewBytes(valuesView);
+        const size_t indexSize = Accessor::GetComponentTypeSize(accessor.sparse.indicesComponentType);
+
+        if (!IsElementRangeInBounds(indexBytes.size, accessor.sparse.indicesByteOffset, accessor.sparse.count, indexSize, indexSize) ||
+            !IsElementRangeInBounds(valueBytes.size, accessor.sparse.valuesByteOffset, accessor.sparse.count, elementSize, elementSize))
+        {
+            throw InvalidGLTFException("Sparse accessor " + accessor.id + " is out of the bounds of its buffer views");
+        }
+
+        m_limiter->ChargeDecodedBytes(accessor.sparse.count, sizeof(uint32_t) + componentCount * sizeof(float));
+
+        *pIndices = arena.AllocateArray<uint32_t>(accessor.sparse.count);
+        *pValues = arena.AllocateArray<float>(accessor.sparse.count * componentCount);
+
+        ConvertIndices(indexBytes.data + accessor.sparse.indicesByteOffset, accessor.sparse.count, accessor.sparse.indicesComponentType, pIndices->data);
+
+        for (uint32_t target : *pIndices)
+        {
+            if (target >= accessor.count)
+            {
+                throw InvalidGLTFException("Sparse accessor " + accessor.id + " references an element past its count");
+            }
+        }
+
+        ConvertElementsToFloats(valueBytes.data + accessor.sparse.valuesByteOffset, accessor.sparse.count, elementSize, componentCount, accessor.componentType, accessor.normalized, pValues->data);
+    }
+
+    ArenaArray<uint32_t>
+    AccessorDecoder::ReadColors(DecodeArena& arena, const Accessor& accessor)
+    {
+        const size_t componentCount = Accessor::GetTypeCount(accessor.type);
+
+        if (componentCount != 3 && componentCount != 4)
+        {
+            throw InvalidGLTFException("Color accessor " + accessor.id + " must be VEC3 or VEC4");
+        }
+
+        // Colors stored as integers are always normalized.
+        Accessor normalizedAccessor = accessor;
+        normalizedAccessor.normalized = true;
+
+        m_limiter->ChargeDecodedBytes(accessor.count, sizeof(uint32_t));
+
+        ArenaArray<uint32_t> result = arena.AllocateArray<uint32_t>(accessor.count);
+
+        DecodeArena::Scope scratch(arena);
+        ArenaArray<float> components = ReadFloats(arena, normalizedAccessor);
+
+        for (size_t i = 0; i < accessor.count; ++i)
+        {
+            const float* pColor = components.data + i * componentCount;
+
+            uint32_t r = PackUnorm8(pColor[0]);
+            uint32_t g = PackUnorm8(pColor[1]);
+            uint32_t b = PackUnorm8(pColor[2]);
+            uint32_t a = componentCount == 4 ? PackUnorm8(pColor[3]) : 255;
+
+            result[i] = r | (g << 8) | (b << 16) | (a << 24);
+        }
+
+        return result;
+    }
+
+    ArenaArray<uint32_t>
+    AccessorDecoder::ReadIndices(DecodeArena& arena, const Accessor& accessor)
+    {
+        if (accessor.type != TYPE_SCALAR)
+        {
+            throw InvalidGLTFException("Index accessor " + accessor.id + " must be SCALAR");
+        }
+
+        const BufferView& bufferView = m_gltfDocument.bufferViews.Get(accessor.bufferViewId);
+        ArenaArray<const uint8_t> viewBytes = GetBufferViewBytes(bufferView);
+        const size_t indexSize = Accessor::GetComponentTypeSize(accessor.componentType);
+
+        if (!IsElementRangeInBounds(viewBytes.size, accessor.byteOffset, accessor.count, indexSize, indexSize))
+        {
+            throw InvalidGLTFException("Index accessor " + accessor.id + " is out of the bounds of its buffer view");
+        }
+
+        m_limiter->ChargeDecodedBytes(accessor.count, sizeof(uint32_t));
+
+        ArenaArray<uint32_t> result = arena.AllocateArray<uint32_t>(accessor.count);
+        ConvertIndices(viewBytes.data + accessor.byteOffset, accessor.count, accessor.componentType, result.data);
+
+        return result;
+    }
+
+    ArenaArray<uint16_t>
+    AccessorDecoder::ReadTriangulatedIndices16(DecodeArena& arena, const MeshPrimitive& meshPrimitive)
+    {
+        // Reserve the result before opening the scratch scope that holds the source indices.
+        size_t sourceCount;
+
+        if (!meshPrimitive.indicesAccessorId.empty())
+        {
+            sourceCount = m_gltfDocument.accessors.Get(meshPrimitive.indicesAccessorId).count;
+        }
+        else
+        {
+            const Accessor& positions = m_gltfDocument.accessors.Get(meshPrimitive.GetAttributeAccessorId(ACCESSOR_POSITION));
+            sourceCount = positions.count;
+        }
+
+        size_t triangleCount;
+
+        switch (meshPrimitive.mode)
+        {
+        case MESH_TRIANGLES:
+            triangleCount = sourceCount / 3;
+            break;
+
+        case MESH_TRIANGLE_STRIP:
+        case MESH_TRIANGLE_FAN:
+            triangleCount = sourceCount >= 3 ? sourceCount - 2 : 0;
+            break;
+
+        default:
+            throw InvalidGLTFException("Only triangle primitives can be triangulated");
+        }
+
+        m_limiter->ChargeDecodedBytes(triangleCount, 3 * sizeof(uint16_t));
+
+        ArenaArray<uint16_t> result = arena.AllocateArray<uint16_t>(triangleCount * 3);
+
+        DecodeArena::Scope scratch(arena);
+        ArenaArray<uint32_t> sourceIndices;
+
+        if (!meshPrimitive.indicesAccessorId.empty())
+        {
+            sourceIndices = ReadIndices(arena, m_gltfDocument.accessors.Get(meshPrimitive.indicesAccessorId));
+        }
+
+        auto sourceIndex = [&](size_t i) -> uint16_t
+        {
+            uint32_t index = sourceIndices.data ? sourceIndices[i] : static_cast<uint32_t>(i);
+
+            if (index > UINT16_MAX)
+            {
+                throw InvalidGLTFException("Primitive needs 32-bit indices");
+            }
+
+            return static_cast<uint16_t>(index);
+        };
+
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            uint16_t* pTriangle = result.data + t * 3;
+
+            switch (meshPrimitive.mode)
+            {
+            case MESH_TRIANGLES:
+                pTriangle[0] = sourceIndex(t * 3);
+                pTriangle[1] = sourceIndex(t * 3 + 1);
+                pTriangle[2] = sourceIndex(t * 3 + 2);
+                break;
+
+            case MESH_TRIANGLE_STRIP:
+                // Keep the winding consistent on odd triangles.
+                pTriangle[0] = sourceIndex(t);
+                pTriangle[1] = sourceIndex((t & 1) ? t + 2 : t + 1);
+                pTriangle[2] = sourceIndex((t & 1) ? t + 1 : t + 2);
+                break;
+
+            case MESH_TRIANGLE_FAN:
+            default:
+                pTriangle[0] = sourceIndex(t + 1);
+                pTriangle[1] = sourceIndex(t + 2);
+                pTriangle[2] = sourceIndex(0);
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    ArenaArray<const uint8_t>
+    AccessorDecoder::ReadImageBytes(DecodeArena& arena, const Image& image)
+    {
+        if (!image.bufferViewId.empty())
+        {
+            return GetBufferViewBytes(m_gltfDocument.bufferViews.Get(image.bufferViewId));
+        }
+
+        ArenaArray<const uint8_t> inPlace;
+
+        if (m_gltfSource && m_gltfSource->TryGetUriBytes(image.uri, &inPlace))
+        {
+            return inPlace;
+        }
+
+        // The source resolves every file it can, so the SDK can only read data URIs the source
+        // doesn't decode. It decodes them into memory of its own, no larger than the URI, which
+        // is charged before it does.
+        if (!IsDataUri(image.uri))
+        {
+            throw GLTFException("Image " + image.id + " refers to " + image.uri + ", which can't be read");
+        }
+
+        m_limiter->ChargeDecodedBytes(image.uri.size());
+
+        vector<uint8_t> data = m_gltfResourceReader->ReadBinaryData(m_gltfDocument, image);
+
+        m_limiter->ChargeDecodedBytes(data.size());
+
+        ArenaArray<uint8_t> bytes = arena.AllocateArray<uint8_t>(data.size());
+        memcpy(bytes.data, data.data(), data.size());
+
+        return { bytes.data, bytes.size };
+    }
+} // namespace SceneLoader
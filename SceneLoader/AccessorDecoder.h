@@ -0,0 +1,76 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+#include "GLTFSource.h"
+#include "LoadLimits.h"
+
+namespace SceneLoader
+{
+    // Reads accessors, indices and images straight from the glTF buffers into a
+    // DecodeArena, replacing the std::vector round trips of MeshPrimitiveUtils and
+    // ResourceReader. Buffers that GLTFSource can hand out in place (GLB binary chunk,
+    // external files) are used directly; anything else is fetched once per load and
+    // kept for the lifetime of the decoder. Everything it decodes is charged to the
+    // LoadLimiter of the load before it is allocated.
+    class AccessorDecoder
+    {
+    public:
+        AccessorDecoder(
+            const Microsoft::glTF::Document& gltfDocument,
+            std::shared_ptr<Microsoft::glTF::GLTFResourceReader> gltfResourceReader,
+            std::shared_ptr<GLTFSource> gltfSource,
+            std::shared_ptr<LoadLimiter> limiter);
+
+        // Float attributes (POSITION, NORMAL, TANGENT, TEXCOORD_n). Integer components
+        // are converted, and normalized if the accessor says so.
+        ArenaArray<float> ReadFloats(DecodeArena& arena, const Microsoft::glTF::Accessor& accessor);
+
+        // Sparse accessors without a buffer view, such as most morph targets, as the
+        // (element index, value) pairs they store instead of a dense array. Returns false
+        // for any other accessor.
+        bool TryReadSparseFloats(
+            DecodeArena& arena,
+            const Microsoft::glTF::Accessor& accessor,
+            ArenaArray<uint32_t>* pIndices,
+            ArenaArray<float>* pValues);
+
+        // COLOR_n packed as RGBA8, matching MeshPrimitiveUtils::GetColors.
+        ArenaArray<uint32_t> ReadColors(DecodeArena& arena, const Microsoft::glTF::Accessor& accessor);
+
+        // Index list for a triangle list, strip or fan; synthesized when the primitive has no indices.
+        ArenaArray<uint16_t> ReadTriangulatedIndices16(DecodeArena& arena, const Microsoft::glTF::MeshPrimitive& meshPrimitive);
+
+        // Encoded image bytes. Images stored in a buffer view are returned in place.
+        ArenaArray<const uint8_t> ReadImageBytes(DecodeArena& arena, const Microsoft::glTF::Image& image);
+
+        ArenaArray<const uint8_t> GetBufferViewBytes(const Microsoft::glTF::BufferView& bufferView);
+
+        size_t BufferBytes() const { return m_bufferArena.PeakBytes(); }
+
+    private:
+        ArenaArray<const uint8_t> GetBufferBytes(const std::string& bufferId);
+
+        ArenaArray<uint32_t> ReadIndices(DecodeArena& arena, const Microsoft::glTF::Accessor& accessor);
+
+        void ReadSparseElements(
+            DecodeArena& arena,
+            const Microsoft::glTF::Accessor& accessor,
+            ArenaArray<uint32_t>* pIndices,
+            ArenaArray<float>* pValues);
+
+        const Microsoft::glTF::Document& m_gltfDocument;
+        std::shared_ptr<Microsoft::glTF::GLTFResourceReader> m_gltfResourceReader;
+        std::shared_ptr<GLTFSource> m_gltfSource;
+        std::shared_ptr<LoadLimiter> m_limiter;
+
+        // Buffers that only the glTF SDK can decode live here for the duration of the load.
+        // Accessors are read from several threads at once, see GLTFVisitor::DecodeMeshPrimitives.
+        std::mutex m_bufferLock;
+        DecodeArena m_bufferArena;
+        std::unordered_map<std::string, ArenaArray<const uint8_t>> m_bufferBytes;
+    };
+} // SceneLoader
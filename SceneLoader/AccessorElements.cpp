@@ -0,0 +1,158 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "AccessorElements.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static constexpr uint32_t c_componentByte = 5120;
+    static constexpr uint32_t c_componentUnsignedByte = 5121;
+    static constexpr uint32_t c_componentShort = 5122;
+    static constexpr uint32_t c_componentUnsignedShort = 5123;
+    static constexpr uint32_t c_componentUnsignedInt = 5125;
+    static constexpr uint32_t c_componentFloat = 5126;
+
+    size_t
+    GetAccessorComponentSize(uint32_t componentType)
+    {
+        switch (componentType)
+        {
+        case c_componentByte:
+        case c_componentUnsignedByte:
+            return 1;
+
+        case c_componentShort:
+        case c_componentUnsignedShort:
+            return 2;
+
+        case c_componentUnsignedInt:
+        case c_componentFloat:
+            return 4;
+
+        default:
+            return 0;
+        }
+    }
+
+    bool
+    IsElementRangeInBounds(size_t byteLength, size_t byteOffset, size_t count, size_t elementSize, size_t stride)
+    {
+        if (count == 0)
+        {
+            return byteOffset <= byteLength;
+        }
+
+        if (byteOffset > byteLength || elementSize > byteLength - byteOffset)
+        {
+            return false;
+        }
+
+        return (count - 1) <= (byteLength - byteOffset - elementSize) / stride;
+    }
+
+    // One loop per component type, so that the type isn't looked at again for every component.
+    // Normalized components are divided by the largest value of the type.
+    template<typename T>
+    static void ConvertElements(const uint8_t* pSource, size_t count, size_t stride, size_t componentCount, bool normalized, float* pDest)
+    {
+        const float divisor = normalized ? static_cast<float>(numeric_limits<T>::max()) : 1.0f;
+
+        for (size_t i = 0; i < count; ++i, pSource += stride)
+        {
+            for (size_t c = 0; c < componentCount; ++c)
+            {
+                T value;
+                memcpy(&value, pSource + c * sizeof(T), sizeof(value));
+
+                float converted = static_cast<float>(value) / divisor;
+
+                // The most negative integer would go just past -1.
+                *pDest++ = (is_signed<T>::value && normalized) ? max(converted, -1.0f) : converted;
+            }
+        }
+    }
+
+    void
+    ConvertElementsToFloats(const uint8_t* pSource, size_t count, size_t stride, size_t componentCount, uint32_t componentType, bool normalized, float* pDest)
+    {
+        switch (componentType)
+        {
+        case c_componentByte:
+            ConvertElements<int8_t>(pSource, count, stride, componentCount, normalized, pDest);
+            break;
+
+        case c_componentUnsignedByte:
+            ConvertElements<uint8_t>(pSource, count, stride, componentCount, normalized, pDest);
+            break;
+
+        case c_componentShort:
+            ConvertElements<int16_t>(pSource, count, stride, componentCount, normalized, pDest);
+            break;
+
+        case c_componentUnsignedShort:
+            ConvertElements<uint16_t>(pSource, count, stride, componentCount, normalized, pDest);
+            break;
+
+        // Never normalized.
+        case c_componentUnsignedInt:
+            ConvertElements<uint32_t>(pSource, count, stride, componentCount, false, pDest);
+            break;
+
+        case c_componentFloat:
+            if (stride == componentCount * sizeof(float))
+            {
+                memcpy(pDest, pSource, count * stride);
+            }
+            else
+            {
+                ConvertElements<float>(pSource, count, stride, componentCount, false, pDest);
+            }
+            break;
+
+        default:
+            throw InvalidGLTFException("Unsupported accessor component type");
+        }
+    }
+
+    template<typename T>
+    static void ConvertIndices(const uint8_t* pSource, size_t count, uint32_t* pDest)
+    {
+        for (size_t i = 0; i < count; ++i, pSource += sizeof(T))
+        {
+            T value;
+            memcpy(&value, pSource, sizeof(value));
+            pDest[i] = value;
+        }
+    }
+
+    void
+    ConvertIndices(const uint8_t* pSource, size_t count, uint32_t componentType, uint32_t* pDest)
+    {
+        switch (componentType)
+        {
+        case c_componentUnsignedByte:
+            ConvertIndices<uint8_t>(pSource, count, pDest);
+            break;
+
+        case c_componentUnsignedShort:
+            ConvertIndices<uint16_t>(pSource, count, pDest);
+            break;
+
+        case c_componentUnsignedInt:
+            if (count > 0)
+            {
+                memcpy(pDest, pSource, count * sizeof(uint32_t));
+            }
+            break;
+
+        default:
+            throw InvalidGLTFException("Index accessors must use an unsigned integer component type");
+        }
+    }
+} // SceneLoader
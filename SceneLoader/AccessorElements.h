@@ -0,0 +1,34 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // The element conversions of AccessorDecoder, on raw buffer view bytes. Component types are
+    // the numbers glTF uses for them, from 5120 (BYTE) to 5126 (FLOAT).
+
+    // Size of one component in bytes, 0 for an unknown type.
+    size_t GetAccessorComponentSize(uint32_t componentType);
+
+    // True if count elements of elementSize bytes, stride bytes apart and starting at
+    // byteOffset, fit in byteLength bytes.
+    bool IsElementRangeInBounds(size_t byteLength, size_t byteOffset, size_t count, size_t elementSize, size_t stride);
+
+    // Converts count elements of componentCount components each, stride bytes apart, to packed
+    // floats. Integer components are normalized if asked to, signed ones clamped to -1. Throws
+    // InvalidGLTFException for an unknown component type.
+    void ConvertElementsToFloats(
+        const uint8_t* pSource,
+        size_t count,
+        size_t stride,
+        size_t componentCount,
+        uint32_t componentType,
+        bool normalized,
+        float* pDest);
+
+    // Converts count tightly packed indices. Throws InvalidGLTFException unless the component
+    // type is an unsigned integer.
+    void ConvertIndices(const uint8_t* pSource, size_t count, uint32_t componentType, uint32_t* pDest);
+} // SceneLoader
@@ -0,0 +1,286 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "AnimationCurve.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    // Bounds the cost of growing a single segment over very long, almost constant curves.
+    static constexpr size_t c_maxSegmentKeys = 1024;
+
+    static Vec4 LoadPadded(const float* pSource, size_t componentCount)
+    {
+        float padded[4] = {};
+        memcpy(padded, pSource, componentCount * sizeof(float));
+        return Vec4::Load(padded);
+    }
+
+    static Vec4 Normalize(Vec4 value)
+    {
+        float lengthSquared = Dot(value, value);
+        return lengthSquared > 0.0f ? value * Vec4::Splat(1.0f / sqrtf(lengthSquared)) : value;
+    }
+
+    // Linear or step interpolation between two keys of a curve.
+    static Vec4 InterpolateKeys(const AnimationCurve& curve, size_t first, size_t second, float time)
+    {
+        Vec4 a = Vec4::Load(curve.Value(first));
+
+        if (curve.interpolation == CurveInterpolation::Step)
+        {
+            return time < curve.times[second] ? a : Vec4::Load(curve.Value(second));
+        }
+
+        float span = curve.times[second] - curve.times[first];
+        float s = span > 0.0f ? (time - curve.times[first]) / span : 0.0f;
+
+        Vec4 value = MultiplyAdd(Vec4::Load(curve.Value(second)) - a, Vec4::Splat(s), a);
+
+        return curve.isRotation ? Normalize(value) : value;
+    }
+
+    static void AppendKey(AnimationCurve& curve, float time, Vec4 value)
+    {
+        if (curve.isRotation)
+        {
+            value = Normalize(value);
+
+            // q and -q are the same rotation; keep neighbors on the same hemisphere so
+            // that interpolating between them takes the short way around.
+            if (!curve.times.empty() && Dot(value, Vec4::Load(curve.Value(curve.KeyCount() - 1))) < 0.0f)
+            {
+                value = Vec4::Zero() - value;
+            }
+        }
+
+        float stored[4];
+        value.Store(stored);
+
+        curve.times.push_back(time);
+        curve.values.insert(curve.values.end(), stored, stored + 4);
+    }
+
+    AnimationCurve
+    BuildAnimationCurve(
+        const float* times,
+        size_t keyCount,
+        const float* values,
+        size_t componentCount,
+        CurveInterpolation interpolation,
+        bool isRotation,
+        float samplesPerSecond)
+    {
+        assert(componentCount >= 1 && componentCount <= 4);
+
+        AnimationCurve curve;
+        curve.isRotation = isRotation;
+        curve.interpolation = (interpolation == CurveInterpolation::Step) ? CurveInterpolation::Step : CurveInterpolation::Linear;
+
+        if (interpolation != CurveInterpolation::CubicSpline)
+        {
+            curve.times.reserve(keyCount);
+            curve.values.reserve(keyCount * 4);
+
+            for (size_t key = 0; key < keyCount; ++key)
+            {
+                AppendKey(curve, times[key], LoadPadded(values + key * componentCount, componentCount));
+            }
+
+            return curve;
+        }
+
+        // In-tangent, value and out-tangent of a key.
+        auto tangentIn = [&](size_t key) { return LoadPadded(values + (key * 3) * componentCount, componentCount); };
+        auto value = [&](size_t key) { return LoadPadded(values + (key * 3 + 1) * componentCount, componentCount); };
+        auto tangentOut = [&](size_t key) { return LoadPadded(values + (key * 3 + 2) * componentCount, componentCount); };
+
+        for (size_t key = 0; key + 1 < keyCount; ++key)
+        {
+            float span = times[key + 1] - times[key];
+            size_t sampleCount = max<size_t>(1, static_cast<size_t>(ceilf(span * samplesPerSecond)));
+
+            Vec4 p0 = value(key);
+            Vec4 p1 = value(key + 1);
+            Vec4 m0 = tangentOut(key) * Vec4::Splat(span);
+            Vec4 m1 = tangentIn(key + 1) * Vec4::Splat(span);
+
+            for (size_t sample = 0; sample < sampleCount; ++sample)
+            {
+                float s = static_cast<float>(sample) / sampleCount;
+                float s2 = s * s;
+                float s3 = s2 * s;
+
+                // Cubic Hermite basis.
+                Vec4 point =
+                    p0 * Vec4::Splat(2.0f * s3 - 3.0f * s2 + 1.0f) +
+                    m0 * Vec4::Splat(s3 - 2.0f * s2 + s) +
+                    p1 * Vec4::Splat(-2.0f * s3 + 3.0f * s2) +
+                    m1 * Vec4::Splat(s3 - s2);
+
+                AppendKey(curve, times[key] + span * s, point);
+            }
+        }
+
+        if (keyCount > 0)
+        {
+            AppendKey(curve, times[keyCount - 1], value(keyCount - 1));
+        }
+
+        return curve;
+    }
+
+    // True if the keys strictly between first and last are reproduced within tolerance
+    // by interpolating between first and last alone.
+    static bool IsSegmentWithinTolerance(const AnimationCurve& curve, size_t first, size_t last, float tolerance)
+    {
+        for (size_t key = first + 1; key < last; ++key)
+        {
+            Vec4 predicted = InterpolateKeys(curve, first, last, curve.times[key]);
+            Vec4 error = Abs(predicted - Vec4::Load(curve.Value(key)));
+
+            if (HorizontalMax(error) > tolerance)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void
+    SimplifyAnimationCurve(AnimationCurve& curve, float tolerance)
+    {
+        const size_t keyCount = curve.KeyCount();
+
+        if (keyCount <= 2)
+        {
+            return;
+        }
+
+        vector<size_t> keptKeys;
+        keptKeys.push_back(0);
+
+        if (curve.interpolation == CurveInterpolation::Step)
+        {
+            // A step key is redundant when it repeats the value being held.
+            for (size_t key = 1; key + 1 < keyCount; ++key)
+            {
+                Vec4 difference = Vec4::Load(curve.Value(key)) - Vec4::Load(curve.Value(keptKeys.back()));
+
+                if (HorizontalMax(Abs(difference)) > tolerance)
+                {
+                    keptKeys.push_back(key);
+                }
+            }
+
+            keptKeys.push_back(keyCount - 1);
+        }
+        else
+        {
+            // Greedily extend each segment for as long as it still covers the keys it skips.
+            size_t anchor = 0;
+
+            while (anchor + 1 < keyCount)
+            {
+                size_t end = anchor + 1;
+
+                while (end + 1 < keyCount && end + 1 - anchor <= c_maxSegmentKeys && IsSegmentWithinTolerance(curve, anchor, end + 1, tolerance))
+                {
+                    ++end;
+                }
+
+                keptKeys.push_back(end);
+                anchor = end;
+            }
+        }
+
+        if (keptKeys.size() == keyCount)
+        {
+            return;
+        }
+
+        AnimationCurve simplified;
+        simplified.interpolation = curve.interpolation;
+        simplified.isRotation = curve.isRotation;
+        simplified.times.reserve(keptKeys.size());
+        simplified.values.reserve(keptKeys.size() * 4);
+
+        for (size_t key : keptKeys)
+        {
+            simplified.times.push_back(curve.times[key]);
+            simplified.values.insert(simplified.values.end(), curve.Value(key), curve.Value(key) + 4);
+        }
+
+        curve = move(simplified);
+    }
+
+    bool
+    IsAnimationCurveConstant(const AnimationCurve& curve, float tolerance)
+    {
+        if (curve.KeyCount() == 0)
+        {
+            return true;
+        }
+
+        Vec4 first = Vec4::Load(curve.Value(0));
+
+        for (size_t key = 1; key < curve.KeyCount(); ++key)
+        {
+            if (HorizontalMax(Abs(Vec4::Load(curve.Value(key)) - first)) > tolerance)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void
+    EvaluateAnimationCurve(const AnimationCurve& curve, float time, float* pValue)
+    {
+        const size_t keyCount = curve.KeyCount();
+
+        if (keyCount == 0)
+        {
+            memset(pValue, 0, 4 * sizeof(float));
+            return;
+        }
+
+        size_t next = upper_bound(curve.times.begin(), curve.times.end(), time) - curve.times.begin();
+
+        if (next == 0)
+        {
+            memcpy(pValue, curve.Value(0), 4 * sizeof(float));
+        }
+        else if (next == keyCount)
+        {
+            memcpy(pValue, curve.Value(keyCount - 1), 4 * sizeof(float));
+        }
+        else
+        {
+            InterpolateKeys(curve, next - 1, next, time).Store(pValue);
+        }
+    }
+
+    float
+    MeasureAnimationCurveError(const AnimationCurve& original, const AnimationCurve& simplified)
+    {
+        Vec4 maxError = Vec4::Zero();
+
+        for (size_t key = 0; key < original.KeyCount(); ++key)
+        {
+            float value[4];
+            EvaluateAnimationCurve(simplified, original.times[key], value);
+
+            maxError = Max(maxError, Abs(Vec4::Load(value) - Vec4::Load(original.Value(key))));
+        }
+
+        return HorizontalMax(maxError);
+    }
+} // namespace SceneLoader
@@ -0,0 +1,57 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    enum class CurveInterpolation
+    {
+        Linear,
+        Step,
+        CubicSpline,
+    };
+
+    // Keyframes of one animated translation, rotation or scale. Values are padded to four
+    // floats per key so that they can be processed as a Vec4; rotations are unit quaternions
+    // (x, y, z, w) on a continuous hemisphere. Only Linear and Step curves are stored,
+    // cubic splines are resampled when the curve is built.
+    struct AnimationCurve
+    {
+        CurveInterpolation interpolation = CurveInterpolation::Linear;
+        bool isRotation = false;
+        std::vector<float> times;
+        std::vector<float> values;
+
+        size_t KeyCount() const { return times.size(); }
+        const float* Value(size_t key) const { return &values[key * 4]; }
+    };
+
+    // Builds a curve from glTF sampler data. Cubic spline outputs hold an in-tangent, a value
+    // and an out-tangent per key; they are sampled samplesPerSecond times per second, and at
+    // least once per key, into a linear curve.
+    AnimationCurve BuildAnimationCurve(
+        const float* times,
+        size_t keyCount,
+        const float* values,
+        size_t componentCount,
+        CurveInterpolation interpolation,
+        bool isRotation,
+        float samplesPerSecond);
+
+    // Removes every key that interpolating between the remaining keys reproduces within
+    // tolerance, measured as the largest per-component difference at the original key times.
+    // Because both curves are piecewise linear this also bounds the error between keys.
+    // The first and last keys are always kept.
+    void SimplifyAnimationCurve(AnimationCurve& curve, float tolerance);
+
+    // True if every key is within tolerance of the first one.
+    bool IsAnimationCurveConstant(const AnimationCurve& curve, float tolerance);
+
+    // Samples the curve, clamping outside of its time range. Rotations are normalized.
+    void EvaluateAnimationCurve(const AnimationCurve& curve, float time, float* pValue);
+
+    // Largest per-component difference between the two curves at the key times of original.
+    float MeasureAnimationCurveError(const AnimationCurve& original, const AnimationCurve& simplified);
+} // SceneLoader
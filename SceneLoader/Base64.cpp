@@ -0,0 +1,363 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "Base64.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BASE64_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define BASE64_NEON
+#include <arm_neon.h>
+#endif
+
+// MSVC allows any intrinsic anywhere; GCC and Clang need the functions to be tagged.
+#if defined(BASE64_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BASE64_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BASE64_TARGET(isa)
+#endif
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr uint8_t c_invalid = 0xFF;
+
+    struct Base64Table
+    {
+        uint8_t values[256];
+
+        Base64Table()
+        {
+            memset(values, c_invalid, sizeof(values));
+
+            const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+            for (uint8_t i = 0; i < 64; ++i)
+            {
+                values[static_cast<uint8_t>(alphabet[i])] = i;
+            }
+        }
+    };
+
+    static const Base64Table s_base64Table;
+
+    // Handles whatever the vector loops leave over, including padding.
+    static bool DecodeBase64Scalar(const uint8_t* source, size_t length, uint8_t* destination, size_t* pDecodedLength)
+    {
+        if (length >= 1 && source[length - 1] == '=')
+        {
+            --length;
+
+            if (length >= 1 && source[length - 1] == '=')
+            {
+                --length;
+            }
+        }
+
+        if (length % 4 == 1)
+        {
+            return false;
+        }
+
+        const uint8_t* table = s_base64Table.values;
+        uint8_t* out = destination;
+        size_t i = 0;
+
+        for (; i + 4 <= length; i += 4)
+        {
+            uint32_t a = table[source[i]];
+            uint32_t b = table[source[i + 1]];
+            uint32_t c = table[source[i + 2]];
+            uint32_t d = table[source[i + 3]];
+
+            if ((a | b | c | d) == c_invalid || ((a | b | c | d) & 0xC0))
+            {
+                return false;
+            }
+
+            uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+            out[0] = static_cast<uint8_t>(triple >> 16);
+            out[1] = static_cast<uint8_t>(triple >> 8);
+            out[2] = static_cast<uint8_t>(triple);
+            out += 3;
+        }
+
+        size_t tail = length - i;
+
+        if (tail > 0)
+        {
+            uint32_t a = table[source[i]];
+            uint32_t b = table[source[i + 1]];
+            uint32_t c = (tail == 3) ? table[source[i + 2]] : 0;
+
+            if ((a | b | c) & 0xC0)
+            {
+                return false;
+            }
+
+            uint32_t triple = (a << 18) | (b << 12) | (c << 6);
+            *out++ = static_cast<uint8_t>(triple >> 16);
+
+            if (tail == 3)
+            {
+                *out++ = static_cast<uint8_t>(triple >> 8);
+            }
+        }
+
+        *pDecodedLength = out - destination;
+        return true;
+    }
+
+#if defined(BASE64_X86)
+    // Maps 16 characters to their 6-bit values. Anything outside the alphabet,
+    // including bytes >= 0x80 which compare as negative, clears a bit in *pValidMask.
+    BASE64_TARGET("ssse3")
+    static __m128i TranslateBase64(__m128i input, int* pValidMask)
+    {
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8('Z' + 1)));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8('z' + 1)));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8('9' + 1)));
+        __m128i plus = _mm_cmpeq_epi8(input, _mm_set1_epi8('+'));
+        __m128i slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+
+        __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+        shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+        shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+        shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+        *pValidMask = _mm_movemask_epi8(valid);
+
+        return _mm_add_epi8(input, shift);
+    }
+
+    // Packs four 6-bit values per 32-bit lane into three bytes in the low 24 bits, in output order.
+    BASE64_TARGET("ssse3")
+    static __m128i PackBase64(__m128i values)
+    {
+        __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+        return _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    }
+
+    // 16 characters in, 12 bytes out (16 stored). Stops at the first invalid block.
+    BASE64_TARGET("ssse3")
+    static size_t DecodeBase64SSSE3(const uint8_t* source, size_t length, uint8_t* destination, size_t* pWritten)
+    {
+        size_t consumed = 0;
+        uint8_t* out = destination;
+
+        // Keep enough characters back that the 16 byte store stays inside the output.
+        while (length - consumed >= 32)
+        {
+            int validMask;
+            __m128i values = TranslateBase64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + consumed)), &validMask);
+
+            if (validMask != 0xFFFF)
+            {
+                break;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), PackBase64(values));
+            consumed += 16;
+            out += 12;
+        }
+
+        *pWritten = out - destination;
+        return consumed;
+    }
+
+    BASE64_TARGET("avx2")
+    static inline __m256i InRangeAVX2(__m256i value, char first, char last)
+    {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(value, _mm256_set1_epi8(first - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), value));
+    }
+
+    // Same as the SSSE3 loop, 32 characters at a time.
+    BASE64_TARGET("avx2")
+    static size_t DecodeBase64AVX2(const uint8_t* source, size_t length, uint8_t* destination, size_t* pWritten)
+    {
+        size_t consumed = 0;
+        uint8_t* out = destination;
+
+        while (length - consumed >= 64)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + consumed));
+
+            __m256i upper = InRangeAVX2(input, 'A', 'Z');
+            __m256i lower = InRangeAVX2(input, 'a', 'z');
+            __m256i digit = InRangeAVX2(input, '0', '9');
+            __m256i plus = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('+'));
+            __m256i slash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+
+            __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+
+            if (_mm256_movemask_epi8(valid) != -1)
+            {
+                break;
+            }
+
+            __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+')));
+            shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/')));
+
+            __m256i values = _mm256_add_epi8(input, shift);
+            __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            __m256i quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+
+            // pshufb works per 128-bit lane, so each lane ends up with 12 bytes that are then joined.
+            __m256i bytes = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes);
+            consumed += 32;
+            out += 24;
+        }
+
+        *pWritten = out - destination;
+        return consumed;
+    }
+
+    enum class Base64Path
+    {
+        Scalar,
+        SSSE3,
+        AVX2,
+    };
+
+    static Base64Path DetectBase64Path()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        bool hasSSSE3 = (info[2] & (1 << 9)) != 0;
+        bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+        bool hasAVX2 = false;
+
+        if (maxLeaf >= 7 && hasOSXSAVE && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            hasAVX2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        bool hasSSSE3 = __builtin_cpu_supports("ssse3");
+        bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+        return hasAVX2 ? Base64Path::AVX2 : hasSSSE3 ? Base64Path::SSSE3 : Base64Path::Scalar;
+    }
+#endif // BASE64_X86
+
+#if defined(BASE64_NEON)
+    static uint8x16_t TranslateBase64(uint8x16_t input, uint8x16_t* pValid)
+    {
+        auto inRange = [](uint8x16_t value, uint8_t first, uint8_t last)
+        {
+            return vandq_u8(vcgeq_u8(value, vdupq_n_u8(first)), vcleq_u8(value, vdupq_n_u8(last)));
+        };
+
+        uint8x16_t upper = inRange(input, 'A', 'Z');
+        uint8x16_t lower = inRange(input, 'a', 'z');
+        uint8x16_t digit = inRange(input, '0', '9');
+        uint8x16_t plus = vceqq_u8(input, vdupq_n_u8('+'));
+        uint8x16_t slash = vceqq_u8(input, vdupq_n_u8('/'));
+
+        uint8x16_t shift = vandq_u8(upper, vdupq_n_u8(static_cast<uint8_t>(-'A')));
+        shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8(static_cast<uint8_t>(26 - 'a'))));
+        shift = vorrq_u8(shift, vandq_u8(digit, vdupq_n_u8(static_cast<uint8_t>(52 - '0'))));
+        shift = vorrq_u8(shift, vandq_u8(plus, vdupq_n_u8(static_cast<uint8_t>(62 - '+'))));
+        shift = vorrq_u8(shift, vandq_u8(slash, vdupq_n_u8(static_cast<uint8_t>(63 - '/'))));
+
+        *pValid = vandq_u8(*pValid, vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(vorrq_u8(digit, plus), slash)));
+
+        return vaddq_u8(input, shift);
+    }
+
+    // 64 characters in, 48 bytes out. vld4/vst3 do the (de)interleaving.
+    static size_t DecodeBase64NEON(const uint8_t* source, size_t length, uint8_t* destination, size_t* pWritten)
+    {
+        size_t consumed = 0;
+        uint8_t* out = destination;
+
+        // The last quartet may be padded, so it is always left to the scalar code.
+        while (length - consumed >= 68)
+        {
+            uint8x16x4_t input = vld4q_u8(source + consumed);
+            uint8x16_t valid = vdupq_n_u8(0xFF);
+
+            uint8x16_t a = TranslateBase64(input.val[0], &valid);
+            uint8x16_t b = TranslateBase64(input.val[1], &valid);
+            uint8x16_t c = TranslateBase64(input.val[2], &valid);
+            uint8x16_t d = TranslateBase64(input.val[3], &valid);
+
+            if (vminvq_u8(valid) != 0xFF)
+            {
+                break;
+            }
+
+            uint8x16x3_t output;
+            output.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+            output.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+            output.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+            vst3q_u8(out, output);
+
+            consumed += 64;
+            out += 48;
+        }
+
+        *pWritten = out - destination;
+        return consumed;
+    }
+#endif // BASE64_NEON
+
+    bool
+    DecodeBase64(const char* source, size_t length, uint8_t* destination, size_t* pDecodedLength)
+    {
+        const uint8_t* input = reinterpret_cast<const uint8_t*>(source);
+        size_t consumed = 0;
+        size_t written = 0;
+
+#if defined(BASE64_X86)
+        static const Base64Path s_path = DetectBase64Path();
+
+        if (s_path == Base64Path::AVX2)
+        {
+            consumed = DecodeBase64AVX2(input, length, destination, &written);
+        }
+        else if (s_path == Base64Path::SSSE3)
+        {
+            consumed = DecodeBase64SSSE3(input, length, destination, &written);
+        }
+#elif defined(BASE64_NEON)
+        consumed = DecodeBase64NEON(input, length, destination, &written);
+#endif
+
+        size_t tailLength;
+
+        if (!DecodeBase64Scalar(input + consumed, length - consumed, destination + written, &tailLength))
+        {
+            return false;
+        }
+
+        *pDecodedLength = written + tailLength;
+        return true;
+    }
+} // namespace SceneLoader
@@ -0,0 +1,19 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Size of the buffer DecodeBase64 needs for length input characters.
+    inline size_t GetBase64DecodedLengthBound(size_t length)
+    {
+        return (length / 4 + 1) * 3;
+    }
+
+    // Decodes standard (RFC 4648) base64, with or without padding. Uses AVX2, SSSE3 or
+    // NEON when available. Returns false if the input contains anything outside the
+    // alphabet, including whitespace.
+    bool DecodeBase64(const char* source, size_t length, uint8_t* destination, size_t* pDecodedLength);
+} // SceneLoader
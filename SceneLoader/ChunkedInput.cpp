@@ -0,0 +1,177 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ChunkedInput.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static uint32_t ReadUInt32(const uint8_t* pSource)
+    {
+        uint32_t value;
+        memcpy(&value, pSource, sizeof(value));
+        return value;
+    }
+
+    ChunkedInput::ChunkedInput(shared_ptr<LoadLimiter> limiter) :
+        m_limiter(move(limiter))
+    {
+    }
+
+    void ChunkedInput::Append(const uint8_t* pData, size_t byteLength)
+    {
+        if (IsGLB())
+        {
+            byteLength = static_cast<size_t>(min<uint64_t>(byteLength, m_glbLength - m_bytes.size()));
+        }
+
+        // Within the capacity reserved for a GLB this never moves the bytes.
+        m_bytes.insert(m_bytes.end(), pData, pData + byteLength);
+
+        if (!m_isHeaderRead && m_bytes.size() >= c_glbHeaderSize)
+        {
+            ReadHeader();
+        }
+
+        if (IsGLB() && m_jsonLength == 0 && m_bytes.size() >= c_glbHeaderSize + c_glbChunkHeaderSize)
+        {
+            const uint64_t jsonLength = ReadUInt32(m_bytes.data() + c_glbHeaderSize);
+
+            if (ReadUInt32(m_bytes.data() + c_glbHeaderSize + 4) != c_glbChunkTypeJson)
+            {
+                throw InvalidGLTFException("The first GLB chunk must be JSON");
+            }
+
+            if (jsonLength == 0 || jsonLength > m_glbLength - c_glbHeaderSize - c_glbChunkHeaderSize)
+            {
+                throw InvalidGLTFException("GLB chunk is out of the bounds of the file");
+            }
+
+            m_jsonLength = jsonLength;
+        }
+    }
+
+    void ChunkedInput::ReadHeader()
+    {
+        m_isHeaderRead = true;
+
+        if (ReadUInt32(m_bytes.data()) != c_glbMagic)
+        {
+            return;
+        }
+
+        if (ReadUInt32(m_bytes.data() + 4) != c_glbVersion)
+        {
+            throw GLTFException("Unsupported GLB version");
+        }
+
+        const uint64_t glbLength = ReadUInt32(m_bytes.data() + 8);
+
+        if (glbLength < c_glbHeaderSize + c_glbChunkHeaderSize)
+        {
+            throw InvalidGLTFException("GLB length is too small for its JSON chunk");
+        }
+
+        // Nothing has been handed out yet, so this is the one time the bytes may move.
+        if (m_bytes.size() > glbLength)
+        {
+            m_bytes.resize(static_cast<size_t>(glbLength));
+        }
+
+        // The header is as untrusted as the rest of the file.
+        if (m_limiter)
+        {
+            m_limiter->ChargeDecodedBytes(glbLength);
+        }
+
+        m_bytes.reserve(static_cast<size_t>(glbLength));
+        m_glbLength = glbLength;
+    }
+
+    bool ChunkedInput::TryGetJson(ArenaArray<const uint8_t>* pJson) const
+    {
+        const uint64_t offset = c_glbHeaderSize + c_glbChunkHeaderSize;
+
+        if (m_jsonLength == 0 || !HasRange(offset, m_jsonLength))
+        {
+            return false;
+        }
+
+        *pJson = { m_bytes.data() + offset, static_cast<size_t>(m_jsonLength) };
+        return true;
+    }
+
+    bool ChunkedInput::TryGetBinaryChunk(uint64_t* pOffset, uint64_t* pLength) const
+    {
+        // The binary chunk, when there is one, follows the JSON chunk.
+        const uint64_t chunkHeaderOffset = c_glbHeaderSize + c_glbChunkHeaderSize + m_jsonLength;
+
+        if (m_jsonLength == 0 || !HasRange(chunkHeaderOffset, c_glbChunkHeaderSize))
+        {
+            return false;
+        }
+
+        const uint64_t chunkLength = ReadUInt32(m_bytes.data() + chunkHeaderOffset);
+
+        if (ReadUInt32(m_bytes.data() + chunkHeaderOffset + 4) != c_glbChunkTypeBin ||
+            chunkLength > m_glbLength - chunkHeaderOffset - c_glbChunkHeaderSize)
+        {
+            return false;
+        }
+
+        *pOffset = chunkHeaderOffset + c_glbChunkHeaderSize;
+        *pLength = chunkLength;
+        return true;
+    }
+
+    bool ChunkedInput::IsJsonReady() const
+    {
+        ArenaArray<const uint8_t> json;
+        uint64_t binaryChunkOffset;
+        uint64_t binaryChunkLength;
+
+        return TryGetJson(&json) && (TryGetBinaryChunk(&binaryChunkOffset, &binaryChunkLength) || IsComplete());
+    }
+
+    void ChunkedInput::AwaitRange(uint64_t offset, uint64_t length, size_t tag)
+    {
+        // Ranges that can't fit in any file are never handed back.
+        const uint64_t end = (length <= UINT64_MAX - offset) ? offset + length : UINT64_MAX;
+
+        auto position = upper_bound(m_awaitedRanges.begin(), m_awaitedRanges.end(), end, [](uint64_t rangeEnd, const AwaitedRange& range)
+        {
+            return rangeEnd > range.end;
+        });
+
+        m_awaitedRanges.insert(position, { end, tag });
+    }
+
+    vector<size_t> ChunkedInput::TakeArrivedRanges()
+    {
+        vector<size_t> tags;
+
+        while (!m_awaitedRanges.empty() && m_awaitedRanges.back().end <= m_bytes.size())
+        {
+            tags.push_back(m_awaitedRanges.back().tag);
+            m_awaitedRanges.pop_back();
+        }
+
+        return tags;
+    }
+
+    void ChunkedInput::CheckComplete() const
+    {
+        // A file cut short inside the GLB header doesn't even declare its length.
+        const bool isGLBHeaderCut = !m_isHeaderRead && m_bytes.size() >= 4 && ReadUInt32(m_bytes.data()) == c_glbMagic;
+
+        if ((IsGLB() && !IsComplete()) || isGLBHeaderCut)
+        {
+            throw InvalidGLTFException("The GLB ended before the length its header declares");
+        }
+    }
+} // SceneLoader
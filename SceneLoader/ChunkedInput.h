@@ -0,0 +1,88 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+#include "GLBContainer.h"
+#include "LoadLimits.h"
+
+namespace SceneLoader
+{
+    // Collects a .gltf or .glb file that arrives in pieces, and tells which parts of it are
+    // in. Once the GLB header has arrived the whole file is allocated, so bytes handed out
+    // by TryGetJson, or read at ranges HasRange reports, stay where they are while the rest
+    // is appended. A .gltf file is all JSON, and nothing of it is usable before it ends.
+    //
+    // Ranges of the file can be awaited, such as the images in the binary chunk, and are
+    // handed back by TakeArrivedRanges once all of their bytes are in.
+    class ChunkedInput
+    {
+    public:
+        // The length the GLB header declares is charged to the limiter, if there is one,
+        // before it is allocated.
+        explicit ChunkedInput(std::shared_ptr<LoadLimiter> limiter = nullptr);
+
+        // Copies the next bytes of the file. Bytes past the length a GLB header declares are
+        // dropped. Throws GLTFException for GLB versions other than 2, InvalidGLTFException
+        // for a GLB header or JSON chunk header that can't be right, and LoadLimitException
+        // for a GLB longer than the limiter allows.
+        void Append(const uint8_t* pData, size_t byteLength);
+
+        const uint8_t* Data() const { return m_bytes.data(); }
+        uint64_t Size() const { return m_bytes.size(); }
+
+        // Both false until the first 12 bytes are in.
+        bool IsGLB() const { return m_glbLength > 0; }
+        bool IsComplete() const { return IsGLB() && m_bytes.size() == m_glbLength; }
+
+        // The JSON chunk of a GLB once all of it is in.
+        bool TryGetJson(ArenaArray<const uint8_t>* pJson) const;
+
+        // Where the binary chunk of a GLB is, once its chunk header is in. Its bytes arrive
+        // later; see HasRange.
+        bool TryGetBinaryChunk(uint64_t* pOffset, uint64_t* pLength) const;
+
+        bool HasRange(uint64_t offset, uint64_t length) const
+        {
+            return offset <= m_bytes.size() && length <= m_bytes.size() - offset;
+        }
+
+        // True once the JSON chunk of a GLB is in, along with the header of the binary chunk
+        // after it, if there is one; from then on the JSON can be read and the images in the
+        // binary chunk located. The chunk header costs waiting for 8 more bytes.
+        bool IsJsonReady() const;
+
+        // Awaits the given range of the file; the tag is handed back by TakeArrivedRanges once
+        // all of its bytes are in.
+        void AwaitRange(uint64_t offset, uint64_t length, size_t tag);
+
+        // The tags of the awaited ranges that are in now, in the order their last bytes
+        // arrived. Each is handed out once.
+        std::vector<size_t> TakeArrivedRanges();
+
+        size_t AwaitedRangeCount() const { return m_awaitedRanges.size(); }
+
+        // Throws InvalidGLTFException when a GLB ended before the length its header declares.
+        void CheckComplete() const;
+
+    private:
+        struct AwaitedRange
+        {
+            uint64_t end;
+            size_t tag;
+        };
+
+        void ReadHeader();
+
+        std::shared_ptr<LoadLimiter> m_limiter;
+        std::vector<uint8_t> m_bytes;
+        bool m_isHeaderRead = false;
+        uint64_t m_glbLength = 0;
+        uint64_t m_jsonLength = 0;
+
+        // Ordered by the end of their bytes, last first, so only the back has to be looked at.
+        std::vector<AwaitedRange> m_awaitedRanges;
+    };
+} // SceneLoader
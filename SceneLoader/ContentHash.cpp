@@ -0,0 +1,162 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ContentHash.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr uint64_t c_prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t c_prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t c_prime3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t c_prime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t c_prime5 = 0x27D4EB2F165667C5ULL;
+
+    static inline uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static inline uint64_t Read64(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static inline uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static inline uint64_t Round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * c_prime2;
+        accumulator = RotateLeft(accumulator, 31);
+        return accumulator * c_prime1;
+    }
+
+    static inline uint64_t MergeRound(uint64_t accumulator, uint64_t lane)
+    {
+        accumulator ^= Round(0, lane);
+        return accumulator * c_prime1 + c_prime4;
+    }
+
+    ContentHasher::ContentHasher(uint64_t seed) :
+        m_seed(seed)
+    {
+        m_lanes[0] = seed + c_prime1 + c_prime2;
+        m_lanes[1] = seed + c_prime2;
+        m_lanes[2] = seed;
+        m_lanes[3] = seed - c_prime1;
+    }
+
+    void
+    ContentHasher::Append(const void* data, size_t byteLength)
+    {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        const uint8_t* const pEnd = p + byteLength;
+
+        m_totalLength += byteLength;
+
+        if (m_pendingLength + byteLength < sizeof(m_pending))
+        {
+            memcpy(m_pending + m_pendingLength, p, byteLength);
+            m_pendingLength += byteLength;
+            return;
+        }
+
+        if (m_pendingLength > 0)
+        {
+            size_t fill = sizeof(m_pending) - m_pendingLength;
+            memcpy(m_pending + m_pendingLength, p, fill);
+            p += fill;
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                m_lanes[lane] = Round(m_lanes[lane], Read64(m_pending + lane * 8));
+            }
+
+            m_pendingLength = 0;
+        }
+
+        while (pEnd - p >= 32)
+        {
+            m_lanes[0] = Round(m_lanes[0], Read64(p));
+            m_lanes[1] = Round(m_lanes[1], Read64(p + 8));
+            m_lanes[2] = Round(m_lanes[2], Read64(p + 16));
+            m_lanes[3] = Round(m_lanes[3], Read64(p + 24));
+            p += 32;
+        }
+
+        m_pendingLength = static_cast<size_t>(pEnd - p);
+        memcpy(m_pending, p, m_pendingLength);
+    }
+
+    uint64_t
+    ContentHasher::Finish() const
+    {
+        uint64_t hash;
+
+        if (m_totalLength >= 32)
+        {
+            hash = RotateLeft(m_lanes[0], 1) + RotateLeft(m_lanes[1], 7) + RotateLeft(m_lanes[2], 12) + RotateLeft(m_lanes[3], 18);
+            hash = MergeRound(hash, m_lanes[0]);
+            hash = MergeRound(hash, m_lanes[1]);
+            hash = MergeRound(hash, m_lanes[2]);
+            hash = MergeRound(hash, m_lanes[3]);
+        }
+        else
+        {
+            hash = m_seed + c_prime5;
+        }
+
+        hash += m_totalLength;
+
+        const uint8_t* p = m_pending;
+        const uint8_t* const pEnd = m_pending + m_pendingLength;
+
+        while (pEnd - p >= 8)
+        {
+            hash ^= Round(0, Read64(p));
+            hash = RotateLeft(hash, 27) * c_prime1 + c_prime4;
+            p += 8;
+        }
+
+        if (pEnd - p >= 4)
+        {
+            hash ^= static_cast<uint64_t>(Read32(p)) * c_prime1;
+            hash = RotateLeft(hash, 23) * c_prime2 + c_prime3;
+            p += 4;
+        }
+
+        while (p < pEnd)
+        {
+            hash ^= (*p) * c_prime5;
+            hash = RotateLeft(hash, 11) * c_prime1;
+            ++p;
+        }
+
+        hash ^= hash >> 33;
+        hash *= c_prime2;
+        hash ^= hash >> 29;
+        hash *= c_prime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+    uint64_t
+    ComputeContentHash(const void* data, size_t byteLength, uint64_t seed)
+    {
+        ContentHasher hasher(seed);
+        hasher.Append(data, byteLength);
+        return hasher.Finish();
+    }
+} // namespace SceneLoader
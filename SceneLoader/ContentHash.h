@@ -0,0 +1,28 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // 64-bit non-cryptographic hash (XXH64) used to key cached and deduplicated data.
+    uint64_t ComputeContentHash(const void* data, size_t byteLength, uint64_t seed = 0);
+
+    // Incremental form of ComputeContentHash for data that arrives in pieces.
+    class ContentHasher
+    {
+    public:
+        explicit ContentHasher(uint64_t seed = 0);
+
+        void Append(const void* data, size_t byteLength);
+        uint64_t Finish() const;
+
+    private:
+        uint64_t m_lanes[4];
+        uint8_t m_pending[32];
+        size_t m_pendingLength = 0;
+        uint64_t m_totalLength = 0;
+        uint64_t m_seed;
+    };
+} // SceneLoader
@@ -0,0 +1,211 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "DecodeArena.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr align_val_t c_blockAlignment{ 64 };
+
+    static uint8_t* AllocateBlock(size_t byteLength)
+    {
+        return static_cast<uint8_t*>(::operator new(byteLength, c_blockAlignment));
+    }
+
+    static void FreeBlock(uint8_t* block)
+    {
+        ::operator delete(block, c_blockAlignment);
+    }
+
+    DecodeBlockPool&
+    DecodeBlockPool::Instance()
+    {
+        static DecodeBlockPool s_pool;
+        return s_pool;
+    }
+
+    DecodeBlockPool::~DecodeBlockPool()
+    {
+        Trim();
+    }
+
+    bool
+    DecodeBlockPool::SizeClassFromBytes(size_t bytes, size_t* pSizeClass)
+    {
+        size_t sizeClass = 0;
+
+        while (sizeClass < c_sizeClassCount && (size_t(1) << (c_minBlockShift + sizeClass)) < bytes)
+        {
+            ++sizeClass;
+        }
+
+        *pSizeClass = sizeClass;
+
+        return sizeClass < c_sizeClassCount;
+    }
+
+    uint8_t*
+    DecodeBlockPool::Acquire(size_t minimumBytes, size_t* pBlockBytes)
+    {
+        size_t sizeClass;
+
+        if (!SizeClassFromBytes(minimumBytes, &sizeClass))
+        {
+            // Too big to be worth pooling.
+            *pBlockBytes = minimumBytes;
+            return AllocateBlock(minimumBytes);
+        }
+
+        size_t blockBytes = size_t(1) << (c_minBlockShift + sizeClass);
+        *pBlockBytes = blockBytes;
+
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            auto& freeBlocks = m_freeBlocks[sizeClass];
+
+            if (!freeBlocks.empty())
+            {
+                uint8_t* block = freeBlocks.back();
+                freeBlocks.pop_back();
+                m_retainedBytes -= blockBytes;
+                return block;
+            }
+        }
+
+        return AllocateBlock(blockBytes);
+    }
+
+    void
+    DecodeBlockPool::Release(uint8_t* block, size_t blockBytes)
+    {
+        size_t sizeClass;
+
+        if (SizeClassFromBytes(blockBytes, &sizeClass) && (size_t(1) << (c_minBlockShift + sizeClass)) == blockBytes)
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            if (m_retainedBytes + blockBytes <= c_maxRetainedBytes)
+            {
+                m_freeBlocks[sizeClass].push_back(block);
+                m_retainedBytes += blockBytes;
+                return;
+            }
+        }
+
+        FreeBlock(block);
+    }
+
+    void
+    DecodeBlockPool::Trim()
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        for (auto& freeBlocks : m_freeBlocks)
+        {
+            for (uint8_t* block : freeBlocks)
+            {
+                FreeBlock(block);
+            }
+
+            freeBlocks.clear();
+        }
+
+        m_retainedBytes = 0;
+    }
+
+    size_t
+    DecodeBlockPool::RetainedBytes() const
+    {
+        lock_guard<mutex> lock(m_lock);
+        return m_retainedBytes;
+    }
+
+    DecodeArena::~DecodeArena()
+    {
+        Release();
+    }
+
+    void*
+    DecodeArena::Allocate(size_t byteLength, size_t alignment)
+    {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+        if (byteLength == 0)
+        {
+            byteLength = 1;
+        }
+
+        // Try the current block first, then any block left over from a rewound Scope.
+        while (m_blockIndex < m_blocks.size())
+        {
+            Block& block = m_blocks[m_blockIndex];
+            size_t alignedOffset = (m_blockOffset + alignment - 1) & ~(alignment - 1);
+
+            if (alignedOffset <= block.capacity && byteLength <= block.capacity - alignedOffset)
+            {
+                // The padding is held as much as the bytes asked for.
+                m_usedBytes += alignedOffset + byteLength - m_blockOffset;
+                m_peakBytes = max(m_peakBytes, m_usedBytes);
+                m_blockOffset = alignedOffset + byteLength;
+
+                return block.data + alignedOffset;
+            }
+
+            // So is the tail of a block that is moved past, until a Scope rewinds to before it.
+            m_usedBytes += block.capacity - m_blockOffset;
+            ++m_blockIndex;
+            m_blockOffset = 0;
+        }
+
+        if (byteLength > SIZE_MAX - alignment)
+        {
+            throw bad_alloc();
+        }
+
+        Block newBlock;
+        newBlock.data = DecodeBlockPool::Instance().Acquire(max(byteLength + alignment, c_defaultBlockBytes), &newBlock.capacity);
+        m_blocks.push_back(newBlock);
+        m_reservedBytes += newBlock.capacity;
+
+        m_blockIndex = m_blocks.size() - 1;
+        m_blockOffset = 0;
+
+        return Allocate(byteLength, alignment);
+    }
+
+    void
+    DecodeArena::Release()
+    {
+        for (auto& block : m_blocks)
+        {
+            DecodeBlockPool::Instance().Release(block.data, block.capacity);
+        }
+
+        m_blocks.clear();
+        m_blockIndex = 0;
+        m_blockOffset = 0;
+        m_usedBytes = 0;
+        m_reservedBytes = 0;
+    }
+
+    DecodeArena::Scope::Scope(DecodeArena& arena) :
+        m_arena(arena),
+        m_blockIndex(arena.m_blockIndex),
+        m_blockOffset(arena.m_blockOffset),
+        m_usedBytes(arena.m_usedBytes)
+    {
+    }
+
+    DecodeArena::Scope::~Scope()
+    {
+        m_arena.m_blockIndex = m_blockIndex;
+        m_arena.m_blockOffset = m_blockOffset;
+        m_arena.m_usedBytes = m_usedBytes;
+    }
+} // namespace SceneLoader
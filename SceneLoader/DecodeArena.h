@@ -0,0 +1,129 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // std::span is only available in C++20 :(
+    template<typename T>
+    struct ArenaArray
+    {
+        T* data = nullptr;
+        size_t size = 0;
+
+        T* begin() const { return data; }
+        T* end() const { return data + size; }
+        T& operator[](size_t index) const { return data[index]; }
+        size_t ByteLength() const { return size * sizeof(T); }
+        bool empty() const { return size == 0; }
+    };
+
+    // Process-wide pool of large blocks bucketed by power-of-two size classes.
+    // Blocks released by a DecodeArena are kept here so that the next load reuses
+    // them instead of going back to the heap.
+    class DecodeBlockPool
+    {
+    public:
+        static DecodeBlockPool& Instance();
+
+        uint8_t* Acquire(size_t minimumBytes, size_t* pBlockBytes);
+        void Release(uint8_t* block, size_t blockBytes);
+
+        // Returns every retained block to the heap.
+        void Trim();
+
+        size_t RetainedBytes() const;
+
+    private:
+        DecodeBlockPool() = default;
+        ~DecodeBlockPool();
+
+        static constexpr size_t c_minBlockShift = 16;           // 64 KB
+        static constexpr size_t c_sizeClassCount = 15;          // 64 KB .. 1 GB
+        static constexpr size_t c_maxRetainedBytes = 256u << 20;
+
+        static bool SizeClassFromBytes(size_t bytes, size_t* pSizeClass);
+
+        mutable std::mutex m_lock;
+        std::vector<uint8_t*> m_freeBlocks[c_sizeClassCount];
+        size_t m_retainedBytes = 0;
+    };
+
+    // Monotonic allocator for the transient buffers of a single load: decoded
+    // accessors, image bytes, triangulated indices and converted pixels.
+    // Nothing is freed individually; Scope rewinds to a marker so that per-primitive
+    // or per-image scratch memory is recycled, and every block goes back to the
+    // DecodeBlockPool in one step when the arena is destroyed.
+    class DecodeArena
+    {
+    public:
+        DecodeArena() = default;
+        ~DecodeArena();
+
+        DecodeArena(const DecodeArena&) = delete;
+        DecodeArena& operator=(const DecodeArena&) = delete;
+
+        void* Allocate(size_t byteLength, size_t alignment = c_defaultAlignment);
+
+        template<typename T>
+        ArenaArray<T> AllocateArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "DecodeArena never runs destructors");
+
+            if (count > SIZE_MAX / sizeof(T))
+            {
+                throw std::bad_alloc();
+            }
+
+            ArenaArray<T> result;
+            result.data = static_cast<T*>(Allocate(count * sizeof(T), alignof(T) > c_defaultAlignment ? alignof(T) : c_defaultAlignment));
+            result.size = count;
+            return result;
+        }
+
+        // Gives every block back to the pool. Previously returned pointers become invalid.
+        void Release();
+
+        // The bytes of the blocks up to the current position, including alignment padding
+        // and the tails of blocks too small for a later allocation.
+        size_t CurrentBytes() const { return m_usedBytes; }
+        size_t PeakBytes() const { return m_peakBytes; }
+        size_t ReservedBytes() const { return m_reservedBytes; }
+
+        // Rewinds the arena to the position it had when the scope was opened.
+        class Scope
+        {
+        public:
+            explicit Scope(DecodeArena& arena);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            DecodeArena& m_arena;
+            size_t m_blockIndex;
+            size_t m_blockOffset;
+            size_t m_usedBytes;
+        };
+
+    private:
+        static constexpr size_t c_defaultAlignment = 16;
+        static constexpr size_t c_defaultBlockBytes = 1u << 20;
+
+        struct Block
+        {
+            uint8_t* data;
+            size_t capacity;
+        };
+
+        std::vector<Block> m_blocks;
+        size_t m_blockIndex = 0;
+        size_t m_blockOffset = 0;
+        size_t m_usedBytes = 0;
+        size_t m_peakBytes = 0;
+        size_t m_reservedBytes = 0;
+    };
+} // SceneLoader
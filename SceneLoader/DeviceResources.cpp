@@ -0,0 +1,70 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "UtilForIntermingledNamespaces.h"
+#include "DeviceResources.h"
+
+using namespace std;
+
+namespace winrt {
+    using namespace Windows::UI::Composition;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    com_ptr<ABI::Windows::UI::Composition::ICompositionGraphicsDevice>
+    DeviceResources::GraphicsDevice(Compositor compositor)
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        void* identity = GetObjectIdentity(compositor);
+
+        for (auto it = m_graphicsDevices.begin(); it != m_graphicsDevices.end();)
+        {
+            if (it->first != identity && (!it->second.compositor.get() || !it->second.graphicsDevice.get()))
+            {
+                it = m_graphicsDevices.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        CompositorDevice& device = m_graphicsDevices[identity];
+
+        // Another compositor may have been created where a released one was.
+        if (device.compositor.get() == compositor)
+        {
+            if (auto graphicsDevice = device.graphicsDevice.get())
+            {
+                return graphicsDevice.as<ABI::Windows::UI::Composition::ICompositionGraphicsDevice>();
+            }
+        }
+
+        // Loads that get here first wait for the device rather than each creating one.
+        auto graphicsDevice = CreateCompositionGraphicsDevice(compositor);
+
+        device.compositor = make_weak(compositor);
+        device.graphicsDevice = make_weak(graphicsDevice.as<CompositionGraphicsDevice>());
+
+        return graphicsDevice;
+    }
+
+    IWICImagingFactory*
+    DeviceResources::ImagingFactory()
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        if (!m_imagingFactory)
+        {
+            m_imagingFactory = CreateImagingFactory();
+        }
+
+        return m_imagingFactory.get();
+    }
+} // SceneLoader
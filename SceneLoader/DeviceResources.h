@@ -0,0 +1,41 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "ImageDecoder.h"
+
+namespace SceneLoader
+{
+    // The graphics devices and the WIC factory that every load of a SceneLoader shares, so
+    // that loads don't each create a D3D and a D2D device. Everything here can be called from
+    // any thread; the devices are multithreaded, see CreateCompositionGraphicsDevice.
+    class DeviceResources
+    {
+    public:
+        // One per compositor, shared for as long as something else holds it, such as the surfaces
+        // of a loaded scene or a load in progress; created again after that.
+        winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionGraphicsDevice> GraphicsDevice(
+            winrt::Windows::UI::Composition::Compositor compositor);
+
+        // Created on first use.
+        IWICImagingFactory* ImagingFactory();
+
+    private:
+        // Both are weak: a device holds on to its compositor, so holding the device would keep
+        // the compositor and the device alive for as long as the SceneLoader.
+        struct CompositorDevice
+        {
+            winrt::weak_ref<winrt::Windows::UI::Composition::Compositor> compositor;
+            winrt::weak_ref<winrt::Windows::UI::Composition::CompositionGraphicsDevice> graphicsDevice;
+        };
+
+        std::mutex m_lock;
+
+        // Keyed by the identity of the compositor. Entries whose compositor or device is gone
+        // are dropped by the next call.
+        std::unordered_map<void*, CompositorDevice> m_graphicsDevices;
+        winrt::com_ptr<IWICImagingFactory> m_imagingFactory;
+    };
+} // SceneLoader
@@ -0,0 +1,87 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLBContainer.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static uint32_t ReadUInt32(const uint8_t* pSource)
+    {
+        uint32_t value;
+        memcpy(&value, pSource, sizeof(value));
+        return value;
+    }
+
+    GLBContainer ParseGLBContainer(const uint8_t* data, uint64_t byteLength)
+    {
+        GLBContainer container;
+        container.isGLB = byteLength >= c_glbHeaderSize && ReadUInt32(data) == c_glbMagic;
+
+        if (!container.isGLB)
+        {
+            container.json = { data, static_cast<size_t>(byteLength) };
+            return container;
+        }
+
+        if (ReadUInt32(data + 4) != c_glbVersion)
+        {
+            throw GLTFException("Unsupported GLB version");
+        }
+
+        // The declared length may be shorter than the file, never longer.
+        uint64_t glbLength = ReadUInt32(data + 8);
+
+        if (glbLength > byteLength)
+        {
+            throw InvalidGLTFException("GLB length is larger than the file");
+        }
+
+        uint64_t offset = c_glbHeaderSize;
+        bool isFirstChunk = true;
+
+        while (offset + c_glbChunkHeaderSize <= glbLength)
+        {
+            uint64_t chunkLength = ReadUInt32(data + offset);
+            uint32_t chunkType = ReadUInt32(data + offset + 4);
+            offset += c_glbChunkHeaderSize;
+
+            if (chunkLength > glbLength - offset)
+            {
+                throw InvalidGLTFException("GLB chunk is out of the bounds of the file");
+            }
+
+            ArenaArray<const uint8_t> chunk{ data + offset, static_cast<size_t>(chunkLength) };
+
+            if (isFirstChunk)
+            {
+                if (chunkType != c_glbChunkTypeJson)
+                {
+                    throw InvalidGLTFException("The first GLB chunk must be JSON");
+                }
+
+                container.json = chunk;
+            }
+            else if (chunkType == c_glbChunkTypeBin && container.binaryChunk.empty())
+            {
+                container.binaryChunk = chunk;
+            }
+
+            // Unknown chunk types are skipped, as required by the spec.
+            isFirstChunk = false;
+            offset += chunkLength;
+        }
+
+        if (isFirstChunk)
+        {
+            throw InvalidGLTFException("GLB has no JSON chunk");
+        }
+
+        return container;
+    }
+} // SceneLoader
@@ -0,0 +1,31 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+
+namespace SceneLoader
+{
+    constexpr uint32_t c_glbMagic = 0x46546C67;          // "glTF"
+    constexpr uint32_t c_glbVersion = 2;
+    constexpr uint32_t c_glbChunkTypeJson = 0x4E4F534A;  // "JSON"
+    constexpr uint32_t c_glbChunkTypeBin = 0x004E4942;   // "BIN\0"
+    constexpr size_t c_glbHeaderSize = 12;
+    constexpr size_t c_glbChunkHeaderSize = 8;
+
+    // Where the JSON and the binary chunk of a document are. A .gltf file is all JSON and
+    // has no binary chunk.
+    struct GLBContainer
+    {
+        bool isGLB = false;
+        ArenaArray<const uint8_t> json;
+        ArenaArray<const uint8_t> binaryChunk;
+    };
+
+    // Reads the GLB header and chunk table, if the bytes start with one; only the headers are
+    // touched. Throws GLTFException for GLB versions other than 2 and InvalidGLTFException for
+    // chunks that don't fit the file.
+    GLBContainer ParseGLBContainer(const uint8_t* data, uint64_t byteLength);
+} // SceneLoader
@@ -0,0 +1,135 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLTFSource.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    shared_ptr<GLTFSource>
+    GLTFSource::Open(const wstring& path, shared_ptr<IResourceResolver> resolver)
+    {
+        auto file = MappedFile::Open(path);
+
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        if (!resolver)
+        {
+            resolver = make_shared<MappedFileResourceResolver>(GetParentFolder(path));
+        }
+
+        return shared_ptr<GLTFSource>(new GLTFSource(move(file), move(resolver)));
+    }
+
+    GLTFSource::GLTFSource(const uint8_t* data, uint64_t byteLength, shared_ptr<IResourceResolver> resolver) :
+        m_data(data),
+        m_size(byteLength),
+        m_resolver(move(resolver))
+    {
+        ParseContainer();
+    }
+
+    GLTFSource::GLTFSource(unique_ptr<MappedFile> file, shared_ptr<IResourceResolver> resolver) :
+        m_file(move(file)),
+        m_resolver(move(resolver))
+    {
+        m_data = m_file->Data();
+        m_size = m_file->Size();
+
+        ParseContainer();
+    }
+
+    void
+    GLTFSource::ParseContainer()
+    {
+        GLBContainer container = ParseGLBContainer(m_data, m_size);
+
+        m_isGLB = container.isGLB;
+        m_json = container.json;
+        m_binaryChunk = container.binaryChunk;
+    }
+
+    bool
+    GLTFSource::TryGetBufferBytes(const Buffer& buffer, ArenaArray<const uint8_t>* pBytes)
+    {
+        if (buffer.uri.empty())
+        {
+            // Only the first buffer of a GLB may omit the uri, and it refers to the binary chunk.
+            if (!m_isGLB || buffer.byteLength > m_binaryChunk.size)
+            {
+                throw InvalidGLTFException("Buffer " + buffer.id + " has no uri and no matching GLB binary chunk");
+            }
+
+            *pBytes = { m_binaryChunk.data, buffer.byteLength };
+            return true;
+        }
+
+        if (!TryGetUriBytes(buffer.uri, pBytes))
+        {
+            return false;
+        }
+
+        if (buffer.byteLength > pBytes->size)
+        {
+            throw InvalidGLTFException("Buffer " + buffer.id + " is larger than the data its uri refers to");
+        }
+
+        pBytes->size = buffer.byteLength;
+        return true;
+    }
+
+    bool
+    GLTFSource::TryGetUriBytes(const string& uri, ArenaArray<const uint8_t>* pBytes)
+    {
+        if (IsDataUri(uri))
+        {
+            return m_dataUriResolver.TryResolve(uri, pBytes);
+        }
+
+        return m_resolver && m_resolver->TryResolve(uri, pBytes);
+    }
+
+    void
+    GLTFSource::Prefetch(const Document& gltfDocument, const SceneDependencies& dependencies)
+    {
+        PrefetchResources(gltfDocument, dependencies, m_dataUriResolver);
+
+        if (m_resolver)
+        {
+            PrefetchResources(gltfDocument, dependencies, *m_resolver);
+        }
+    }
+
+    bool
+    GLTFSource::TryAppendResourceStamps(string* pStamps) const
+    {
+        vector<string> uris;
+
+        try
+        {
+            uris = GetExternalResourceUris(reinterpret_cast<const char*>(m_json.data), m_json.size);
+        }
+        catch (const InvalidGLTFException&)
+        {
+            return false;
+        }
+
+        for (const auto& uri : uris)
+        {
+            if (!m_resolver || !m_resolver->TryAppendStamp(uri, pStamps))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // namespace SceneLoader
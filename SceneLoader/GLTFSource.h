@@ -0,0 +1,67 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+#include "GLBContainer.h"
+#include "MappedFile.h"
+#include "ResourceResolver.h"
+
+namespace SceneLoader
+{
+    // The bytes of a .gltf or .glb document, either owned by the caller or mapped from
+    // a file, plus an IResourceResolver for the external files it references. Buffers are
+    // handed out in place so that nothing is ever copied into process memory as a whole,
+    // and all sizes and offsets are 64-bit.
+    class GLTFSource
+    {
+    public:
+        // Maps the file. Without a resolver, external buffers and images are mapped from
+        // the folder of the file. Returns nullptr if the file can't be opened.
+        static std::shared_ptr<GLTFSource> Open(const std::wstring& path, std::shared_ptr<IResourceResolver> resolver = nullptr);
+
+        // Wraps memory owned by the caller, which must outlive the source.
+        // Without a resolver only embedded and GLB resources are available.
+        GLTFSource(const uint8_t* data, uint64_t byteLength, std::shared_ptr<IResourceResolver> resolver = nullptr);
+
+        const uint8_t* Data() const { return m_data; }
+        uint64_t Size() const { return m_size; }
+
+        bool IsGLB() const { return m_isGLB; }
+
+        // The JSON chunk of a GLB, otherwise the whole document.
+        ArenaArray<const uint8_t> JsonBytes() const { return m_json; }
+
+        // Bytes of a buffer that can be used in place: the GLB binary chunk, an external
+        // file or a decoded base64 data URI.
+        bool TryGetBufferBytes(const Microsoft::glTF::Buffer& buffer, ArenaArray<const uint8_t>* pBytes);
+
+        // Bytes of a base64 data URI or of a file referenced by a relative URI, see IResourceResolver.
+        bool TryGetUriBytes(const std::string& uri, ArenaArray<const uint8_t>* pBytes);
+
+        // Resolves the external resources and data URIs that a load depends on up front, see PrefetchResources.
+        void Prefetch(const Microsoft::glTF::Document& gltfDocument, const SceneDependencies& dependencies);
+
+        // Appends the stamp of every external buffer and image the document references, see
+        // IResourceResolver::TryAppendStamp. Returns false if one of them has none, or if the
+        // JSON is malformed, which the parse that follows reports.
+        bool TryAppendResourceStamps(std::string* pStamps) const;
+
+    private:
+        GLTFSource(std::unique_ptr<MappedFile> file, std::shared_ptr<IResourceResolver> resolver);
+
+        void ParseContainer();
+
+        std::unique_ptr<MappedFile> m_file;
+        const uint8_t* m_data = nullptr;
+        uint64_t m_size = 0;
+        std::shared_ptr<IResourceResolver> m_resolver;
+        DataUriResourceResolver m_dataUriResolver;
+
+        bool m_isGLB = false;
+        ArenaArray<const uint8_t> m_json;
+        ArenaArray<const uint8_t> m_binaryChunk;
+    };
+} // SceneLoader
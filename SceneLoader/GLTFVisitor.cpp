@@ -11,19 +11,25 @@ using namespace std;
 using namespace Microsoft::glTF;
 
 namespace winrt {
+    using namespace Windows::Graphics::DirectX;
     using namespace Windows::UI::Composition;
     using namespace Windows::UI::Composition::Scenes;
 }
 using namespace winrt;
 
-extern std::wstringstream s_export;
-
 namespace SceneLoader
 {
     GLTFVisitor::GLTFVisitor(Compositor compositor,
         SceneNode rootSceneNode,
         shared_ptr<SceneResourceSet> resourceSet,
         shared_ptr<GLTFResourceReader> gltfResourceReader,
+        shared_ptr<AccessorDecoder> accessorDecoder,
+        shared_ptr<DecodeArena> decodeArena,
+        shared_ptr<SceneCacheWriter> sceneCacheWriter,
+        shared_ptr<SharedLoadResources> sharedResources,
+        shared_ptr<DeviceResources> deviceResources,
+        shared_ptr<LoadLimiter> limiter,
+        const LoadOptions& loadOptions,
         Document& gltfDocument,
         Scene& gltfScene) :
         m_compositor(compositor),
@@ -31,9 +37,22 @@ namespace SceneLoader
         m_sceneNodeMap(single_threaded_map<hstring, SceneNode>()),
         m_resourceSet(resourceSet),
         m_gltfResourceReader(gltfResourceReader),
+        m_accessorDecoder(accessorDecoder),
+        m_decodeArena(decodeArena),
+        m_sceneCacheWriter(sceneCacheWriter),
+        m_sharedResources(sharedResources),
+        m_deviceResources(deviceResources),
+        m_limiter(limiter),
+        m_loadOptions(loadOptions),
         m_gltfDocument(gltfDocument),
         m_gltfScene(gltfScene)
     {
+        if (m_loadOptions.buildPickIndex)
+        {
+            m_pickIndexBuilder = make_unique<PickIndexBuilder>();
+        }
+
+        PlanTriangleBudgets();
     }
 
     HRESULT GLTFVisitor::EnsureGraphicsDevice()
@@ -42,43 +61,7 @@ namespace SceneLoader
 
         if (!m_graphicsDevice)
         {
-            // Initialize DX
-            winrt::com_ptr<ID3D11Device> cpDevice;
-            winrt::com_ptr<ID3D11DeviceContext> cpContext;
-            UINT creationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-            D3D_FEATURE_LEVEL featureLevels[] =
-            {
-                D3D_FEATURE_LEVEL_11_1,
-                D3D_FEATURE_LEVEL_11_0,
-                D3D_FEATURE_LEVEL_10_1,
-                D3D_FEATURE_LEVEL_10_0,
-                D3D_FEATURE_LEVEL_9_3,
-                D3D_FEATURE_LEVEL_9_2,
-                D3D_FEATURE_LEVEL_9_1
-            };
-            D3D_FEATURE_LEVEL usedFeatureLevel;
-
-            hr = D3D11CreateDevice(
-                nullptr,
-                D3D_DRIVER_TYPE_HARDWARE,
-                nullptr,
-                creationFlags,
-                featureLevels,
-                ARRAYSIZE(featureLevels),
-                D3D11_SDK_VERSION,
-                cpDevice.put(),
-                &usedFeatureLevel,
-                cpContext.put());
-
-            winrt::com_ptr<ID2D1Factory1> cpD2DFactory;
-            winrt::com_ptr<ID2D1Device> cpD2D1Device;
-            winrt::com_ptr<ID3D11Device1> cpd3dDevice = cpDevice.as<ID3D11Device1>();
-            hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, __uuidof(ID2D1Factory1), cpD2DFactory.put_void());
-            winrt::com_ptr<IDXGIDevice> cpDxgiDevice = cpd3dDevice.as<IDXGIDevice>();
-            cpD2DFactory->CreateDevice(cpDxgiDevice.get(), cpD2D1Device.put());
-
-            winrt::com_ptr<ABI::Windows::UI::Composition::ICompositorInterop> cpCompositorInterop = m_compositor.as< ABI::Windows::UI::Composition::ICompositorInterop>();
-            cpCompositorInterop->CreateGraphicsDevice(/*cpDevice*/cpD2D1Device.get(), m_graphicsDevice.put());
+            m_graphicsDevice = m_deviceResources->GraphicsDevice(m_compositor);
 
             assert(m_graphicsDevice);
         }
@@ -86,6 +69,29 @@ namespace SceneLoader
         return hr;
     }
 
+    IWICImagingFactory* GLTFVisitor::ImagingFactory()
+    {
+        return m_deviceResources->ImagingFactory();
+    }
+
+    void GLTFVisitor::FillMeshAttribute(
+        const SceneMesh& mesh,
+        SceneAttributeSemantic semantic,
+        DirectXPixelFormat format,
+        const void* data,
+        size_t byteLength)
+    {
+        mesh.FillMeshAttribute(
+            semantic,
+            format,
+            CopyArrayOfBytesToMemoryBuffer((BYTE*)data, byteLength));
+
+        if (m_sceneCacheWriter)
+        {
+            m_sceneCacheWriter->RecordMeshAttribute(mesh, semantic, format, data, byteLength);
+        }
+    }
+
     winrt::Windows::UI::Composition::CompositionMipmapSurface
     GLTFVisitor::EnsureMipMapSurfaceId(
         const std::string id,
@@ -5,15 +5,48 @@
 #pragma once
 
 #include "SceneResourceSet.h"
+#include "AccessorDecoder.h"
+#include "SceneCache.h"
+#include "LoadOptions.h"
+#include "AnimationCurve.h"
+#include "SkinningKernel.h"
+#include "MorphTargetBlender.h"
+#include "TextureAtlas.h"
+#include "TexelAnalysis.h"
+#include "LoadStatistics.h"
+#include "MeshCleanup.h"
+#include "MeshSimplifier.h"
+#include "MeshInstancing.h"
+#include "SharedLoadResources.h"
+#include "DeviceResources.h"
+#include "LoadLimits.h"
+#include "SceneBounds.h"
+#include "PickIndex.h"
 
 namespace SceneLoader
 {
+    // A primitive whose morph target weights can still be changed after loading.
+    struct MorphedPrimitive
+    {
+        // The SceneNode of the glTF node that instantiates the mesh.
+        winrt::Windows::UI::Composition::Scenes::SceneNode node{ nullptr };
+        winrt::Windows::UI::Composition::Scenes::SceneMesh mesh{ nullptr };
+        std::shared_ptr<MorphTargetBlender> blender;
+    };
+
     struct GLTFVisitor
     {
         GLTFVisitor(winrt::Windows::UI::Composition::Compositor compositor,
                     winrt::Windows::UI::Composition::Scenes::SceneNode rootSceneNode,
                     std::shared_ptr<SceneResourceSet> resourceSet,
                     std::shared_ptr<Microsoft::glTF::GLTFResourceReader> gltfResourceReader,
+                    std::shared_ptr<AccessorDecoder> accessorDecoder,
+                    std::shared_ptr<DecodeArena> decodeArena,
+                    std::shared_ptr<SceneCacheWriter> sceneCacheWriter,
+                    std::shared_ptr<SharedLoadResources> sharedResources,
+                    std::shared_ptr<DeviceResources> deviceResources,
+                    std::shared_ptr<LoadLimiter> limiter,
+                    const LoadOptions& loadOptions,
                     Microsoft::glTF::Document& gltfDocument,
                     Microsoft::glTF::Scene& gltfScene);
 
@@ -44,6 +77,40 @@ namespace SceneLoader
         // Camera
         void operator()(const Microsoft::glTF::Camera&, Microsoft::glTF::VisitState, const Microsoft::glTF::VisitDefaultAction&);
 
+        // Animation. Not reached by Visit; call after it returns.
+        void ImportAnimations();
+
+        const std::vector<MorphedPrimitive>& MorphedPrimitives() const { return m_morphedPrimitives; }
+
+        // Packs the small textures that the Image visitor kept back into shared atlases and moves
+        // the texture coordinates of the primitives that sample them. The ones that can't be
+        // atlased get surfaces of their own. Call after Visit, before the materials are created.
+        void BuildTextureAtlases(LoadStatistics& statistics);
+
+        // Decodes, on the thread pool, the vertex and index streams of the primitives that Visit
+        // will reach, except for those that depend on the node that instantiates them: morphed
+        // and skinned ones. The MeshPrimitive visitor then only creates the scene objects, in
+        // the same order and from the same bytes as without this. Call before Visit.
+        void DecodeMeshPrimitives();
+
+        // Decode memory held by the streams of DecodeMeshPrimitives.
+        size_t DecodedMeshBytes() const;
+
+        // What CleanUpMeshPrimitive did to the primitives visited so far.
+        const MeshCleanupCounts& MeshCleanupTotals() const { return m_meshCleanupCounts; }
+
+        const MeshInstancingCounts& MeshInstancingTotals() const { return m_meshInstancingCounts; }
+
+        // What SimplifyMeshPrimitive did to the primitives visited so far.
+        const MeshSimplifyCounts& MeshSimplifyTotals() const { return m_meshSimplifyCounts; }
+
+        // The bounds and counts of what the scene draws, see SceneMetadata. Call after Visit.
+        SceneMetadata FinishSceneMetadata();
+
+        // Builds the pick index of what the scene draws. Null unless the options ask for one.
+        // Call after Visit.
+        std::shared_ptr<const PickIndex> FinishPickIndex();
+
         HRESULT EnsureGraphicsDevice();
 
 
@@ -54,6 +121,170 @@ namespace SceneLoader
             winrt::Windows::Graphics::DirectX::DirectXAlphaMode alphaMode);
 
     private:
+        // Copies the data into the mesh and, when a cache file is being produced, into the SceneCacheWriter.
+        void FillMeshAttribute(
+            const winrt::Windows::UI::Composition::Scenes::SceneMesh& mesh,
+            winrt::Windows::UI::Composition::Scenes::SceneAttributeSemantic semantic,
+            winrt::Windows::Graphics::DirectX::DirectXPixelFormat format,
+            const void* data,
+            size_t byteLength);
+
+        // Decodes the sampler of one animation channel. Scratch memory comes from m_decodeArena.
+        AnimationCurve ReadChannelCurve(const Microsoft::glTF::Animation& animation, const Microsoft::glTF::AnimationChannel& channel);
+
+        // Index of the parent of every document node, or c_noParentNode, indexed like m_gltfDocument.nodes.
+        const std::vector<size_t>& EnsureNodeParentIndices();
+
+        static constexpr size_t c_noParentNode = SIZE_MAX;
+
+        // World matrix of every document node in its own transform, which is where the SceneNodes
+        // put it, indexed like m_gltfDocument.nodes.
+        const std::vector<winrt::Windows::Foundation::Numerics::float4x4>& EnsureRestWorldMatrices();
+
+        // World matrix of every document node in the skinning pose, for joints only; the rest
+        // matrices without a pose. Indexed like m_gltfDocument.nodes.
+        const std::vector<winrt::Windows::Foundation::Numerics::float4x4>& EnsurePosedWorldMatrices();
+
+        // Joint matrices of skin for a mesh instantiated by meshNode, computed once per pair.
+        const std::vector<SkinningMatrix>& EnsureJointMatrices(const Microsoft::glTF::Skin& skin, const Microsoft::glTF::Node& meshNode);
+
+        // Blends the morph targets of the primitive with the weights of the node being visited
+        // and returns the blender, or nullptr if there are no targets. The blended vertices are
+        // copied into the arena.
+        std::shared_ptr<MorphTargetBlender> CreateMorphTargetBlender(
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            ArenaArray<float>* pPositions,
+            ArenaArray<float>* pNormals);
+
+        MorphTargetDeltas ReadMorphTargetDeltas(const std::string& accessorId, size_t vertexCount);
+
+        // One vertex or index stream of a primitive, in the format it is filled in with.
+        struct DecodedAttribute
+        {
+            winrt::Windows::UI::Composition::Scenes::SceneAttributeSemantic semantic;
+            winrt::Windows::Graphics::DirectX::DirectXPixelFormat format;
+            const void* data;
+            size_t byteLength;
+        };
+
+        // The streams of one primitive, in the order they are filled in. When the mesh was
+        // simplified, flat normals were generated or the mesh was cleaned up, the vertices no
+        // longer match the accessors; vertexSources then holds the vertex of the accessors each
+        // vertex was copied from.
+        struct DecodedPrimitive
+        {
+            std::vector<DecodedAttribute> attributes;
+            ArenaArray<uint16_t> vertexSources;
+            MeshCleanupCounts cleanupCounts;
+            MeshSimplifyCounts simplifyCounts;
+        };
+
+        // Reads the streams of the primitive into the arena, simplifying the mesh when it is over
+        // budget, see SimplifyMeshPrimitive, generating normals and tangents that are missing,
+        // see GenerateVertexFrames, and cleaning up the mesh when the options ask for it, see
+        // CleanUpMeshPrimitive. Non-empty posed arrays stand in for the primitive's own
+        // positions and normals. Only reads the document, so several primitives can be decoded
+        // at once.
+        DecodedPrimitive DecodeMeshPrimitive(
+            DecodeArena& arena,
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            ArenaArray<float> posedPositions,
+            ArenaArray<float> posedNormals);
+
+        // glTF asks for flat normals when a primitive has none, and for MikkTSpace tangents when
+        // its material has a normal texture but the primitive has no tangents.
+        void GenerateVertexFrames(
+            DecodeArena& arena,
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            DecodedPrimitive* pDecoded,
+            ArenaArray<uint16_t>* pIndices);
+
+        // Splits the triangle budgets of the options over the primitives below the scene, in
+        // proportion to their triangles times the nodes and instances that draw them, and
+        // fills m_simplifyRatios for those over budget.
+        void PlanTriangleBudgets();
+
+        // Collapses edges of the primitive until it has its share of the budgets, see SimplifyMesh,
+        // and drops the vertices left unused. Normals and texture coordinates weigh in on which
+        // edges go. Morphed primitives are left alone, the blender needs the vertices of the
+        // accessors.
+        void SimplifyMeshPrimitive(
+            DecodeArena& arena,
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            DecodedPrimitive* pDecoded,
+            ArenaArray<uint16_t>* pIndices);
+
+        // Replaces every stream of the primitive with the elements of the given vertices, in
+        // that order, and keeps vertexSources pointing at the vertices of the accessors. The
+        // streams must have one element per vertex.
+        static void GatherVertices(DecodeArena& arena, const std::vector<uint32_t>& sources, DecodedPrimitive* pDecoded);
+
+        // Welds the vertices that are the same in every stream and drops the triangles without
+        // area, see CleanUpMesh. Morphed primitives are left alone, the blender needs the
+        // vertices of the accessors.
+        void CleanUpMeshPrimitive(
+            DecodeArena& arena,
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            DecodedPrimitive* pDecoded,
+            ArenaArray<uint16_t>* pIndices);
+
+        // Starts the bounds of the path through the scene to the node being visited. localMatrix
+        // places the node in its parent, or a root of the scene in the scene.
+        void BeginNodeBounds(
+            const Microsoft::glTF::Node& node,
+            const Microsoft::glTF::Node* nodeParent,
+            const winrt::Windows::Foundation::Numerics::float4x4& localMatrix);
+
+        // Adds the positions of a primitive of the node being visited, at each of its instances,
+        // to the bounds of the scene and of the path to the node, and to the pick index if there
+        // is one, and counts the primitive.
+        void AddPrimitiveBounds(const Microsoft::glTF::MeshPrimitive& meshPrimitive, const DecodedPrimitive& primitive);
+
+        // Reads the EXT_mesh_gpu_instancing transforms of the node being visited, if it has any,
+        // for the primitives of its mesh.
+        void BeginMeshInstances(const Microsoft::glTF::Mesh& mesh);
+
+        // Draws a primitive of the mesh being visited at every instance, renderComponent at the
+        // first. The instance nodes are created for the first primitive that gets here; a mesh
+        // with one primitive puts its renderers on them, others a child node per primitive.
+        void AddInstanceRenderers(
+            const winrt::Windows::UI::Composition::Scenes::SceneMeshRendererComponent& renderComponent);
+
+        // When instanceBatchMaxVertices asks for it, merges the instances of a small primitive into
+        // meshes of up to 65536 vertices, transformed on the CPU. Returns false, having done
+        // nothing, for primitives that don't qualify.
+        bool TryAddInstanceBatches(
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            const DecodedPrimitive& primitive,
+            const winrt::Windows::UI::Composition::Scenes::SceneMetallicRoughnessMaterial& material);
+
+        // Uploads tightly packed premultiplied BGRA pixels and the levels filtered from them,
+        // recording them in the scene cache as well, in the narrowest layout the usage allows.
+        void UploadMipChain(
+            const winrt::Windows::UI::Composition::CompositionMipmapSurface& mipmap,
+            ArenaArray<uint8_t> pixels,
+            uint32_t width,
+            uint32_t height,
+            const TexelUsage& usage);
+
+        // The factory that every load of the SceneLoader shares.
+        IWICImagingFactory* ImagingFactory();
+
+        // What the materials of the document sample from the image. Images that no material
+        // uses are assumed to be sampled for everything.
+        const TexelUsage& GetImageUsage(const std::string& imageId);
+
+        // Ignore for pixels that are all opaque, so that the compositor can skip blending them.
+        static winrt::Windows::Graphics::DirectX::DirectXAlphaMode ChooseAlphaMode(ArenaArray<uint8_t> pixels);
+
+        // Poses the primitive if the node being visited has a skin. Non-empty arrays are used
+        // instead of the primitive's own vertices and replaced with the skinned ones. Returns
+        // false, leaving the arrays alone, for primitives that aren't skinned.
+        bool SkinMeshPrimitive(
+            const Microsoft::glTF::MeshPrimitive& meshPrimitive,
+            ArenaArray<float>* pPositions,
+            ArenaArray<float>* pNormals);
+
         winrt::Windows::UI::Composition::Compositor m_compositor{ nullptr };
 
         winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionGraphicsDevice> m_graphicsDevice{ nullptr };
@@ -73,5 +304,106 @@ namespace SceneLoader
 
         std::shared_ptr<Microsoft::glTF::GLTFResourceReader> m_gltfResourceReader;
         std::shared_ptr<SceneResourceSet> m_resourceSet;
+
+        // Transient decode buffers for this load. See DecodeArena.
+        std::shared_ptr<AccessorDecoder> m_accessorDecoder;
+        std::shared_ptr<DecodeArena> m_decodeArena;
+
+        // Null unless the load was asked to populate a scene cache.
+        std::shared_ptr<SceneCacheWriter> m_sceneCacheWriter;
+
+        // Null unless the load is part of a batch, see SceneLoader::LoadMany.
+        std::shared_ptr<SharedLoadResources> m_sharedResources;
+
+        // Shared by every load of the SceneLoader, on any thread.
+        std::shared_ptr<DeviceResources> m_deviceResources;
+
+        // The limits of the load, also charged by m_accessorDecoder.
+        std::shared_ptr<LoadLimiter> m_limiter;
+
+        LoadOptions m_loadOptions;
+
+        // The glTF node whose mesh is being visited.
+        const Microsoft::glTF::Node* m_currentGltfNode = nullptr;
+
+        std::vector<size_t> m_nodeParentIndices;
+        std::vector<winrt::Windows::Foundation::Numerics::float4x4> m_restWorldMatrices;
+        std::vector<winrt::Windows::Foundation::Numerics::float4x4> m_posedWorldMatrices;
+
+        // Keyed by skin id and mesh node id.
+        std::map<std::pair<std::string, std::string>, std::vector<SkinningMatrix>> m_jointMatrices;
+
+        std::vector<MorphedPrimitive> m_morphedPrimitives;
+
+        // Streams decoded by DecodeMeshPrimitives, keyed by the primitive in m_gltfDocument, and
+        // the arenas of the threads that decoded them.
+        std::unordered_map<const Microsoft::glTF::MeshPrimitive*, DecodedPrimitive> m_decodedPrimitives;
+        std::vector<std::shared_ptr<DecodeArena>> m_decodedPrimitiveArenas;
+
+        MeshCleanupCounts m_meshCleanupCounts;
+
+        // The fraction of its triangles each primitive over budget keeps, keyed like
+        // m_decodedPrimitives. Filled before decoding starts and only read after.
+        std::unordered_map<const Microsoft::glTF::MeshPrimitive*, float> m_simplifyRatios;
+        MeshSimplifyCounts m_meshSimplifyCounts;
+
+        // EXT_mesh_gpu_instancing of the mesh being visited. The matrices are computed for the
+        // first batched primitive, the nodes created for the first one that isn't.
+        bool m_isMeshInstanced = false;
+        size_t m_meshPrimitiveCount = 0;
+        MeshInstances m_meshInstances;
+        std::vector<InstanceMatrix> m_meshInstanceMatrices;
+        std::vector<winrt::Windows::UI::Composition::Scenes::SceneNode> m_meshInstanceNodes;
+
+        MeshInstancingCounts m_meshInstancingCounts;
+
+        // One path through the scene to a node of the document. The box is what the node draws
+        // itself until FinishSceneMetadata adds what its descendants draw.
+        struct NodeVisit
+        {
+            size_t nodeIndex;
+            size_t parentVisit;
+            winrt::Windows::Foundation::Numerics::float4x4 worldMatrix;
+            BoundingBox box;
+        };
+
+        static constexpr size_t c_noNodeVisit = SIZE_MAX;
+
+        // Visits in the order Visit made them, so a parent always comes before its children.
+        // The latest visit of each node, indexed like m_gltfDocument.nodes, is the one on the
+        // path being visited.
+        std::vector<NodeVisit> m_nodeVisits;
+        std::vector<size_t> m_latestNodeVisits;
+        size_t m_currentNodeVisit = c_noNodeVisit;
+
+        SceneBoundsBuilder m_sceneBounds;
+        SceneMetadata m_sceneMetadata;
+
+        // Null unless the options ask for a pick index.
+        std::unique_ptr<PickIndexBuilder> m_pickIndexBuilder;
+
+        // Decoded textures small enough for an atlas, by image id, and the primitives that may
+        // sample them. Only collected when atlasing is on.
+        struct AtlasCandidate
+        {
+            std::vector<uint8_t> pixels;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        struct TexturedPrimitive
+        {
+            winrt::Windows::UI::Composition::Scenes::SceneMesh mesh{ nullptr };
+            std::string materialId;
+            std::string texCoordAccessorIds[2];
+            std::vector<uint16_t> vertexSources; // See DecodedPrimitive.
+        };
+
+        std::map<std::string, AtlasCandidate> m_atlasCandidates;
+
+        // Filled by the first GetImageUsage.
+        std::unordered_map<std::string, TexelUsage> m_imageUsages;
+        bool m_areImageUsagesKnown = false;
+        std::vector<TexturedPrimitive> m_texturedPrimitives;
     };
 } // SceneLoader
\ No newline at end of file
@@ -0,0 +1,208 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "UtilForIntermingledNamespaces.h"
+#include "GLTFVisitor.h"
+#include "AnimationCurve.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace winrt {
+    using namespace Windows::Foundation;
+    using namespace Windows::Foundation::Numerics;
+    using namespace Windows::UI::Composition;
+    using namespace Windows::UI::Composition::Scenes;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    // Cubic splines are resampled at this rate before they are simplified.
+    static constexpr float c_animationSamplesPerSecond = 30.0f;
+
+    // Largest per-component error allowed when keys are removed: scene units for
+    // translation and scale, quaternion components (about 0.01 degrees) for rotation.
+    static constexpr float c_translationTolerance = 1e-4f;
+    static constexpr float c_rotationTolerance = 1e-4f;
+    static constexpr float c_scaleTolerance = 1e-4f;
+
+    static CurveInterpolation GetCurveInterpolation(InterpolationType interpolation)
+    {
+        switch (interpolation)
+        {
+        case INTERPOLATION_STEP:
+            return CurveInterpolation::Step;
+        case INTERPOLATION_CUBICSPLINE:
+            return CurveInterpolation::CubicSpline;
+        case INTERPOLATION_LINEAR:
+        default:
+            return CurveInterpolation::Linear;
+        }
+    }
+
+    // Translation, rotation and scale channels only.
+    AnimationCurve GLTFVisitor::ReadChannelCurve(const Animation& animation, const AnimationChannel& channel)
+    {
+        const AnimationSampler& sampler = animation.samplers.Get(channel.samplerId);
+        const Accessor& inputAccessor = m_gltfDocument.accessors.Get(sampler.inputAccessorId);
+        const Accessor& outputAccessor = m_gltfDocument.accessors.Get(sampler.outputAccessorId);
+
+        auto times = m_accessorDecoder->ReadFloats(*m_decodeArena, inputAccessor);
+        auto values = m_accessorDecoder->ReadFloats(*m_decodeArena, outputAccessor);
+
+        const bool isRotation = channel.target.path == TARGET_ROTATION;
+        const size_t componentCount = isRotation ? 4 : 3;
+        const CurveInterpolation interpolation = GetCurveInterpolation(sampler.interpolation);
+        const size_t valuesPerKey = (interpolation == CurveInterpolation::CubicSpline) ? 3 : 1;
+
+        if (times.empty() || values.size < times.size * valuesPerKey * componentCount)
+        {
+            throw InvalidGLTFException("Animation sampler " + sampler.id + " has fewer outputs than inputs");
+        }
+
+        return BuildAnimationCurve(
+            times.data,
+            times.size,
+            values.data,
+            componentCount,
+            interpolation,
+            isRotation,
+            c_animationSamplesPerSecond);
+    }
+
+    // Animations aren't part of the default scene traversal, so SceneLoader calls this
+    // once Visit is done and every SceneNode exists. Only the first animation is played.
+    void GLTFVisitor::ImportAnimations()
+    {
+        if (m_gltfDocument.animations.Size() == 0)
+        {
+            return;
+        }
+
+        const Animation& animation = m_gltfDocument.animations[0];
+
+        struct Track
+        {
+            SceneNode sceneNode{ nullptr };
+            TargetPath path;
+            AnimationCurve curve;
+        };
+
+        vector<Track> tracks;
+        float duration = 0.0f;
+
+        {
+            DecodeArena::Scope scratch(*m_decodeArena);
+
+            for (const auto& channel : animation.channels.Elements())
+            {
+                if (channel.target.path != TARGET_TRANSLATION && channel.target.path != TARGET_ROTATION && channel.target.path != TARGET_SCALE)
+                {
+                    SceneResourceSet::UnimplementedFeatureFound();
+                    continue;
+                }
+
+                // Nodes outside of the default scene have no SceneNode.
+                SceneNode sceneNode = m_sceneNodeMap.TryLookup(GetHSTRINGFromStdString(channel.target.nodeId));
+
+                if (!sceneNode)
+                {
+                    continue;
+                }
+
+                Track track;
+                track.sceneNode = sceneNode;
+                track.path = channel.target.path;
+                track.curve = ReadChannelCurve(animation, channel);
+
+                duration = max(duration, track.curve.times.back());
+                tracks.push_back(move(track));
+            }
+        }
+
+        // Composition needs at least a millisecond; anything shorter is a static pose.
+        const bool isAnimated = duration >= 0.001f;
+
+        auto linear = m_compositor.CreateLinearEasingFunction();
+
+        // A single step that holds the previous key until this one is reached.
+        auto step = m_compositor.CreateStepEasingFunction();
+
+        for (auto& track : tracks)
+        {
+            const float tolerance =
+                (track.path == TARGET_TRANSLATION) ? c_translationTolerance :
+                (track.path == TARGET_ROTATION) ? c_rotationTolerance :
+                c_scaleTolerance;
+
+            auto transform = track.sceneNode.Transform();
+            const float* first = track.curve.Value(0);
+
+            if (!isAnimated || IsAnimationCurveConstant(track.curve, tolerance))
+            {
+                // No animation object at all, just the pose.
+                switch (track.path)
+                {
+                case TARGET_TRANSLATION: transform.Translation({ first[0], first[1], first[2] }); break;
+                case TARGET_ROTATION: transform.Orientation({ first[0], first[1], first[2], first[3] }); break;
+                case TARGET_SCALE: transform.Scale({ first[0], first[1], first[2] }); break;
+                }
+
+                continue;
+            }
+
+            SimplifyAnimationCurve(track.curve, tolerance);
+
+            const AnimationCurve& curve = track.curve;
+            CompositionEasingFunction easing = (curve.interpolation == CurveInterpolation::Step) ? CompositionEasingFunction(step) : CompositionEasingFunction(linear);
+            KeyFrameAnimation keyFrameAnimation{ nullptr };
+
+            if (track.path == TARGET_ROTATION)
+            {
+                auto quaternionAnimation = m_compositor.CreateQuaternionKeyFrameAnimation();
+
+                // Hold the first key until the curve starts.
+                if (curve.times.front() > 0.0f)
+                {
+                    quaternionAnimation.InsertKeyFrame(0.0f, { first[0], first[1], first[2], first[3] });
+                }
+
+                for (size_t key = 0; key < curve.KeyCount(); ++key)
+                {
+                    const float* value = curve.Value(key);
+                    quaternionAnimation.InsertKeyFrame(curve.times[key] / duration, { value[0], value[1], value[2], value[3] }, easing);
+                }
+
+                keyFrameAnimation = quaternionAnimation;
+            }
+            else
+            {
+                auto vectorAnimation = m_compositor.CreateVector3KeyFrameAnimation();
+
+                if (curve.times.front() > 0.0f)
+                {
+                    vectorAnimation.InsertKeyFrame(0.0f, { first[0], first[1], first[2] });
+                }
+
+                for (size_t key = 0; key < curve.KeyCount(); ++key)
+                {
+                    const float* value = curve.Value(key);
+                    vectorAnimation.InsertKeyFrame(curve.times[key] / duration, { value[0], value[1], value[2] }, easing);
+                }
+
+                keyFrameAnimation = vectorAnimation;
+            }
+
+            keyFrameAnimation.Duration(chrono::duration_cast<TimeSpan>(chrono::duration<float>(duration)));
+            keyFrameAnimation.IterationBehavior(AnimationIterationBehavior::Forever);
+
+            transform.StartAnimation(
+                (track.path == TARGET_TRANSLATION) ? L"Translation" : (track.path == TARGET_ROTATION) ? L"Orientation" : L"Scale",
+                keyFrameAnimation);
+        }
+    }
+} // SceneLoader
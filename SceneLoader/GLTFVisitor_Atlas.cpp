@@ -0,0 +1,361 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLTFVisitor.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace winrt {
+    using namespace Windows::Graphics::DirectX;
+    using namespace Windows::UI::Composition;
+    using namespace Windows::UI::Composition::Scenes;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    static AtlasWrapMode ToAtlasWrapMode(WrapMode wrapMode)
+    {
+        switch (wrapMode)
+        {
+        case Wrap_CLAMP_TO_EDGE:
+            return AtlasWrapMode::ClampToEdge;
+
+        case Wrap_MIRRORED_REPEAT:
+            return AtlasWrapMode::MirroredRepeat;
+
+        case Wrap_REPEAT:
+        default:
+            return AtlasWrapMode::Repeat;
+        }
+    }
+
+    void GLTFVisitor::BuildTextureAtlases(LoadStatistics& statistics)
+    {
+        statistics.atlasedTextureCount = 0;
+        statistics.atlasCount = 0;
+        statistics.atlasOverheadBytes = 0;
+
+        if (m_atlasCandidates.empty())
+        {
+            return;
+        }
+
+        struct ImageUse
+        {
+            bool isAtlasable = true;
+            bool hasWrapModes = false;
+            AtlasWrapMode wrapU = AtlasWrapMode::Repeat;
+            AtlasWrapMode wrapV = AtlasWrapMode::Repeat;
+        };
+
+        map<string, ImageUse> imageUses;
+
+        for (const auto& candidate : m_atlasCandidates)
+        {
+            imageUses[candidate.first];
+        }
+
+        auto disqualify = [&](const string& imageId)
+        {
+            auto use = imageUses.find(imageId);
+
+            if (use != imageUses.end())
+            {
+                use->second.isAtlasable = false;
+            }
+        };
+
+        // The image each material samples through TEXCOORD_0 and TEXCOORD_1. The coordinates of a
+        // set can only be moved into one tile, so a set that samples several images keeps them
+        // all out of the atlases.
+        map<string, array<string, 2>> materialImages;
+
+        for (const auto& primitive : m_texturedPrimitives)
+        {
+            if (materialImages.count(primitive.materialId))
+            {
+                continue;
+            }
+
+            array<string, 2>& images = materialImages[primitive.materialId];
+            array<bool, 2> isShared = { false, false };
+
+            const Material& material = m_gltfDocument.materials.Get(primitive.materialId);
+            const TextureInfo* textureInfos[] =
+            {
+                &material.metallicRoughness.baseColorTexture,
+                &material.metallicRoughness.metallicRoughnessTexture,
+                &material.normalTexture,
+                &material.occlusionTexture,
+                &material.emissiveTexture,
+            };
+
+            for (const TextureInfo* pTextureInfo : textureInfos)
+            {
+                if (pTextureInfo->textureId.empty())
+                {
+                    continue;
+                }
+
+                const Texture& texture = m_gltfDocument.textures.Get(pTextureInfo->textureId);
+
+                if (pTextureInfo->texCoord > 1)
+                {
+                    disqualify(texture.imageId);
+                    continue;
+                }
+
+                string& image = images[pTextureInfo->texCoord];
+
+                if (image.empty())
+                {
+                    image = texture.imageId;
+                }
+                else if (image != texture.imageId)
+                {
+                    isShared[pTextureInfo->texCoord] = true;
+                }
+
+                auto use = imageUses.find(texture.imageId);
+
+                if (use == imageUses.end())
+                {
+                    continue;
+                }
+
+                // glTF samples with repeat when a texture has no sampler.
+                AtlasWrapMode wrapU = AtlasWrapMode::Repeat;
+                AtlasWrapMode wrapV = AtlasWrapMode::Repeat;
+
+                if (!texture.samplerId.empty())
+                {
+                    const Sampler& sampler = m_gltfDocument.samplers.Get(texture.samplerId);
+
+                    wrapU = ToAtlasWrapMode(sampler.wrapS);
+                    wrapV = ToAtlasWrapMode(sampler.wrapT);
+                }
+
+                // The gutter can only hold one way of wrapping.
+                if (!use->second.hasWrapModes)
+                {
+                    use->second.hasWrapModes = true;
+                    use->second.wrapU = wrapU;
+                    use->second.wrapV = wrapV;
+                }
+                else if (use->second.wrapU != wrapU || use->second.wrapV != wrapV)
+                {
+                    use->second.isAtlasable = false;
+                }
+            }
+
+            for (const TextureInfo* pTextureInfo : textureInfos)
+            {
+                if (!pTextureInfo->textureId.empty() && pTextureInfo->texCoord <= 1 && isShared[pTextureInfo->texCoord])
+                {
+                    disqualify(m_gltfDocument.textures.Get(pTextureInfo->textureId).imageId);
+                }
+            }
+        }
+
+        // Coordinates that repeat the texture would repeat the atlas instead.
+        for (const auto& primitive : m_texturedPrimitives)
+        {
+            const array<string, 2>& images = materialImages[primitive.materialId];
+
+            for (size_t set = 0; set < 2; ++set)
+            {
+                auto use = imageUses.find(images[set]);
+
+                if (use == imageUses.end() || !use->second.isAtlasable || primitive.texCoordAccessorIds[set].empty())
+                {
+                    continue;
+                }
+
+                DecodeArena::Scope scratch(*m_decodeArena);
+
+                const AtlasCandidate& candidate = m_atlasCandidates.at(images[set]);
+                auto texCoords = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(primitive.texCoordAccessorIds[set]));
+
+                if (!TexCoordsFitTile(texCoords.data, texCoords.size / 2, { candidate.width, candidate.height }, use->second.wrapU, use->second.wrapV))
+                {
+                    use->second.isAtlasable = false;
+                }
+            }
+        }
+
+        // Textures share atlases with others that wrap the same way. All surfaces are
+        // premultiplied BGRA, so that is all there is to match.
+        map<pair<AtlasWrapMode, AtlasWrapMode>, vector<string>> groups;
+
+        for (const auto& use : imageUses)
+        {
+            if (use.second.isAtlasable && use.second.hasWrapModes)
+            {
+                groups[make_pair(use.second.wrapU, use.second.wrapV)].push_back(use.first);
+            }
+        }
+
+        struct Placement
+        {
+            AtlasTile tile;
+            AtlasSize page;
+        };
+
+        map<string, Placement> placements;
+
+        for (const auto& group : groups)
+        {
+            const vector<string>& imageIds = group.second;
+
+            // A texture alone in its atlas saves nothing.
+            if (imageIds.size() < 2)
+            {
+                continue;
+            }
+
+            vector<AtlasSize> sizes;
+
+            for (const auto& imageId : imageIds)
+            {
+                const AtlasCandidate& candidate = m_atlasCandidates.at(imageId);
+                sizes.push_back({ candidate.width, candidate.height });
+            }
+
+            AtlasLayout layout = PackAtlas(sizes);
+
+            for (uint32_t page = 0; page < layout.pages.size(); ++page)
+            {
+                DecodeArena::Scope scratch(*m_decodeArena);
+
+                const AtlasSize& pageSize = layout.pages[page];
+                ArenaArray<uint8_t> pagePixels = m_decodeArena->AllocateArray<uint8_t>(static_cast<size_t>(pageSize.width) * 4 * pageSize.height);
+                memset(pagePixels.data, 0, pagePixels.ByteLength());
+
+                TexelUsage pageUsage{ 0, true };
+
+                for (size_t i = 0; i < imageIds.size(); ++i)
+                {
+                    if (layout.tiles[i].page == page)
+                    {
+                        const TexelUsage& usage = GetImageUsage(imageIds[i]);
+                        pageUsage.channels |= usage.channels;
+                        pageUsage.isNormalMap &= usage.isNormalMap;
+
+                        CopyTileWithGutter(pagePixels.data, static_cast<size_t>(pageSize.width) * 4, layout.tiles[i], m_atlasCandidates.at(imageIds[i]).pixels.data(), group.first.first, group.first.second);
+                    }
+                }
+
+                // Nothing samples the space between the tiles.
+                if (!(pageUsage.channels & TexelChannel_Alpha))
+                {
+                    MakeTexelsOpaque(pagePixels.data, pagePixels.size / 4);
+                }
+
+                CompositionMipmapSurface atlas = EnsureMipMapSurfaceId(
+                    "atlas " + to_string(statistics.atlasCount),
+                    { static_cast<int32_t>(pageSize.width), static_cast<int32_t>(pageSize.height) },
+                    DirectXPixelFormat::B8G8R8A8UIntNormalized,
+                    ChooseAlphaMode(pagePixels));
+
+                UploadMipChain(atlas, pagePixels, pageSize.width, pageSize.height, pageUsage);
+
+                for (size_t i = 0; i < imageIds.size(); ++i)
+                {
+                    if (layout.tiles[i].page == page)
+                    {
+                        m_resourceSet->StoreAtlasedImage(imageIds[i], atlas);
+                        placements[imageIds[i]] = { layout.tiles[i], pageSize };
+                    }
+                }
+
+                ++statistics.atlasCount;
+            }
+
+            statistics.atlasOverheadBytes += GetAtlasOverheadBytes(layout);
+        }
+
+        statistics.atlasedTextureCount = static_cast<uint32_t>(placements.size());
+
+        // Move the coordinates of every primitive that samples an atlased texture into its tile.
+        for (const auto& primitive : m_texturedPrimitives)
+        {
+            const array<string, 2>& images = materialImages[primitive.materialId];
+
+            for (size_t set = 0; set < 2; ++set)
+            {
+                auto placement = placements.find(images[set]);
+
+                if (placement == placements.end() || primitive.texCoordAccessorIds[set].empty())
+                {
+                    continue;
+                }
+
+                DecodeArena::Scope scratch(*m_decodeArena);
+
+                const ImageUse& use = imageUses.at(images[set]);
+                auto texCoords = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(primitive.texCoordAccessorIds[set]));
+
+                RemapTexCoordsToTile(texCoords.data, texCoords.size / 2, placement->second.tile, placement->second.page, use.wrapU, use.wrapV);
+
+                if (!primitive.vertexSources.empty())
+                {
+                    // The vertices no longer match the accessors, see DecodedPrimitive.
+                    auto cornerTexCoords = m_decodeArena->AllocateArray<float>(primitive.vertexSources.size() * 2);
+
+                    for (size_t vertex = 0; vertex < primitive.vertexSources.size(); ++vertex)
+                    {
+                        const size_t source = primitive.vertexSources[vertex];
+
+                        if (source * 2 + 1 >= texCoords.size)
+                        {
+                            throw InvalidGLTFException("Mesh primitive has fewer texture coordinates than positions");
+                        }
+
+                        cornerTexCoords[vertex * 2] = texCoords[source * 2];
+                        cornerTexCoords[vertex * 2 + 1] = texCoords[source * 2 + 1];
+                    }
+
+                    texCoords = cornerTexCoords;
+                }
+
+                FillMeshAttribute(
+                    primitive.mesh,
+                    (set == 0) ? SceneAttributeSemantic::TexCoord0 : SceneAttributeSemantic::TexCoord1,
+                    DirectXPixelFormat::R32G32Float,
+                    texCoords.data,
+                    texCoords.ByteLength());
+            }
+        }
+
+        // Everything else gets a surface of its own after all.
+        for (const auto& candidate : m_atlasCandidates)
+        {
+            if (placements.count(candidate.first))
+            {
+                continue;
+            }
+
+            DecodeArena::Scope scratch(*m_decodeArena);
+
+            const AtlasCandidate& texture = candidate.second;
+
+            // ForEachMipLevel only reads the top level.
+            ArenaArray<uint8_t> pixels = { const_cast<uint8_t*>(texture.pixels.data()), texture.pixels.size() };
+
+            CompositionMipmapSurface mipmap = EnsureMipMapSurfaceId(
+                candidate.first,
+                { static_cast<int32_t>(texture.width), static_cast<int32_t>(texture.height) },
+                DirectXPixelFormat::B8G8R8A8UIntNormalized,
+                ChooseAlphaMode(pixels));
+
+            UploadMipChain(mipmap, pixels, texture.width, texture.height, GetImageUsage(candidate.first));
+        }
+
+        m_atlasCandidates.clear();
+    }
+} // SceneLoader
@@ -0,0 +1,169 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLTFVisitor.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace winrt {
+    using namespace Windows::Foundation::Numerics;
+    using namespace Windows::UI::Composition::Scenes;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    // The rows of an instance matrix are for column vectors, float4x4 is for row vectors.
+    static float4x4 ToFloat4x4(const InstanceMatrix& matrix)
+    {
+        const auto& rows = matrix.rows;
+
+        return float4x4(
+            rows[0][0], rows[1][0], rows[2][0], 0.0f,
+            rows[0][1], rows[1][1], rows[2][1], 0.0f,
+            rows[0][2], rows[1][2], rows[2][2], 0.0f,
+            rows[0][3], rows[1][3], rows[2][3], 1.0f);
+    }
+
+    void GLTFVisitor::BeginNodeBounds(const Node& node, const Node* nodeParent, const float4x4& localMatrix)
+    {
+        if (m_latestNodeVisits.size() != m_gltfDocument.nodes.Size())
+        {
+            m_latestNodeVisits.assign(m_gltfDocument.nodes.Size(), c_noNodeVisit);
+        }
+
+        NodeVisit visit;
+        visit.nodeIndex = m_gltfDocument.nodes.GetIndex(node.id);
+        visit.parentVisit = nodeParent ? m_latestNodeVisits[m_gltfDocument.nodes.GetIndex(nodeParent->id)] : c_noNodeVisit;
+        visit.worldMatrix = (visit.parentVisit == c_noNodeVisit) ? localMatrix : localMatrix * m_nodeVisits[visit.parentVisit].worldMatrix;
+
+        m_currentNodeVisit = m_nodeVisits.size();
+        m_latestNodeVisits[visit.nodeIndex] = m_currentNodeVisit;
+        m_nodeVisits.push_back(visit);
+    }
+
+    void GLTFVisitor::AddPrimitiveBounds(const MeshPrimitive& meshPrimitive, const DecodedPrimitive& primitive)
+    {
+        const DecodedAttribute* pPositions = nullptr;
+        const DecodedAttribute* pIndices = nullptr;
+
+        for (const auto& attribute : primitive.attributes)
+        {
+            if (attribute.semantic == SceneAttributeSemantic::Vertex)
+            {
+                pPositions = &attribute;
+            }
+            else if (attribute.semantic == SceneAttributeSemantic::Index)
+            {
+                pIndices = &attribute;
+            }
+        }
+
+        m_sceneMetadata.primitiveCount++;
+
+        if (!pPositions || m_currentNodeVisit == c_noNodeVisit)
+        {
+            return;
+        }
+
+        const size_t vertexCount = pPositions->byteLength / (3 * sizeof(float));
+        const uint64_t triangleCount = pIndices ? pIndices->byteLength / (3 * sizeof(uint16_t)) : vertexCount / 3;
+
+        // TryAddInstanceBatches finds these computed already.
+        if (m_isMeshInstanced && m_meshInstanceMatrices.empty())
+        {
+            m_meshInstanceMatrices.resize(m_meshInstances.count);
+
+            ComputeInstanceMatrices(m_meshInstances, 0, m_meshInstances.count, m_meshInstanceMatrices.data());
+        }
+
+        const size_t instanceCount = m_isMeshInstanced ? m_meshInstances.count : 1;
+
+        m_sceneMetadata.vertexCount += vertexCount;
+        m_sceneMetadata.drawnTriangleCount += triangleCount * instanceCount;
+
+        const float* pData = static_cast<const float*>(pPositions->data);
+
+        NodeVisit& visit = m_nodeVisits[m_currentNodeVisit];
+        vector<float4x4> worldMatrices(instanceCount);
+
+        for (size_t i = 0; i < instanceCount; ++i)
+        {
+            worldMatrices[i] = m_isMeshInstanced ? ToFloat4x4(m_meshInstanceMatrices[i]) * visit.worldMatrix : visit.worldMatrix;
+        }
+
+        // Copied out of the decode arena, which the next primitive reuses. Instances only
+        // transform the points on the hull of the mesh.
+        visit.box.Add(m_sceneBounds.AddInstances(pData, vertexCount, &worldMatrices[0].m11, instanceCount));
+
+        if (m_pickIndexBuilder)
+        {
+            // The visitor is handed the primitives of the document, not copies.
+            const Mesh& mesh = m_gltfDocument.meshes.Get(m_currentGltfNode->meshId);
+            const uint32_t primitiveIndex = static_cast<uint32_t>(&meshPrimitive - mesh.primitives.data());
+
+            m_pickIndexBuilder->AddPrimitive(
+                m_gltfDocument.nodes[visit.nodeIndex].id,
+                primitiveIndex,
+                pData,
+                vertexCount,
+                pIndices ? static_cast<const uint16_t*>(pIndices->data) : nullptr,
+                pIndices ? pIndices->byteLength / sizeof(uint16_t) : 0,
+                &worldMatrices[0].m11,
+                instanceCount);
+        }
+    }
+
+    SceneMetadata GLTFVisitor::FinishSceneMetadata()
+    {
+        // Backwards through the pre-order, every visit is complete before it is added to its parent.
+        for (size_t v = m_nodeVisits.size(); v-- > 0;)
+        {
+            const NodeVisit& visit = m_nodeVisits[v];
+
+            if (visit.parentVisit != c_noNodeVisit && !visit.box.IsEmpty())
+            {
+                m_nodeVisits[visit.parentVisit].box.Add(visit.box);
+            }
+        }
+
+        SceneMetadata metadata = m_sceneMetadata;
+        metadata.box = m_sceneBounds.Box();
+        metadata.sphere = m_sceneBounds.ComputeSphere();
+        metadata.nodeCount = m_nodeVisits.size();
+
+        // The paths to a node share its entry.
+        vector<size_t> entries(m_gltfDocument.nodes.Size(), SIZE_MAX);
+
+        for (const auto& visit : m_nodeVisits)
+        {
+            if (visit.box.IsEmpty())
+            {
+                continue;
+            }
+
+            size_t& entry = entries[visit.nodeIndex];
+
+            if (entry == SIZE_MAX)
+            {
+                entry = metadata.nodeBounds.size();
+                metadata.nodeBounds.push_back({ m_gltfDocument.nodes[visit.nodeIndex].id, visit.box });
+            }
+            else
+            {
+                metadata.nodeBounds[entry].box.Add(visit.box);
+            }
+        }
+
+        return metadata;
+    }
+
+    shared_ptr<const PickIndex> GLTFVisitor::FinishPickIndex()
+    {
+        return m_pickIndexBuilder ? m_pickIndexBuilder->Build() : nullptr;
+    }
+} // SceneLoader
@@ -4,8 +4,11 @@
 
 #include "pch.h"
 
+#include "UtilForIntermingledNamespaces.h"
 #include "GLTFVisitor.h"
-#include "wincodec.h"
+#include "ImageDecoder.h"
+#include "MipChain.h"
+#include "SceneSelection.h"
 
 using namespace std;
 using namespace Microsoft::glTF;
@@ -24,186 +27,146 @@ namespace SceneLoader
     {
         if (alreadyVisited == VisitState::New)
         {
-            std::vector<uint8_t> imageData = m_gltfResourceReader->ReadBinaryData(m_gltfDocument, image);
+            // Encoded and converted pixels are only needed until every level has been uploaded.
+            DecodeArena::Scope scratch(*m_decodeArena);
 
-            const void* pSource = static_cast<const void*>(imageData.data());
+            ArenaArray<const uint8_t> imageData = m_accessorDecoder->ReadImageBytes(*m_decodeArena, image);
 
-            // Create input stream for memory
-            com_ptr<IWICImagingFactory> cpWIC;
-            winrt::check_hresult(CoCreateInstance(
-                CLSID_WICImagingFactory,
-                NULL,
-                CLSCTX_INPROC_SERVER,
-                __uuidof(cpWIC),
-                (LPVOID*)&cpWIC));
+            // Composition has no narrower surface formats that a SceneMaterial can sample, so
+            // the channels that aren't used only save blending and cache space.
+            const TexelUsage& usage = GetImageUsage(image.id);
+            const bool keepAlpha = (usage.channels & TexelChannel_Alpha) != 0;
 
-            com_ptr<IWICStream> cpStream;
-            winrt::check_hresult(cpWIC->CreateStream(cpStream.put()));
-            winrt::check_hresult(cpStream->InitializeFromMemory(static_cast<BYTE*>(const_cast<void*>(pSource)),
-                static_cast<UINT>(imageData.size())));
+            DirectXPixelFormat pixelFormat = DirectXPixelFormat::B8G8R8A8UIntNormalized;
 
-            com_ptr<IWICBitmapDecoder> cpDecoder;
-            winrt::check_hresult(cpWIC->CreateDecoderFromStream(cpStream.get(), nullptr, WICDecodeMetadataCacheOnDemand, cpDecoder.put()));
+            if (m_loadOptions.atlasMaxTextureSize > 0)
+            {
+                SizeInt32 encodedSize = GetEncodedImageSize(ImagingFactory(), imageData.data, imageData.size);
+                const uint32_t width = static_cast<uint32_t>(encodedSize.Width);
+                const uint32_t height = static_cast<uint32_t>(encodedSize.Height);
 
-            com_ptr<IWICBitmapFrameDecode> cpSource;
-            winrt::check_hresult(cpDecoder->GetFrame(0, cpSource.put()));
+                if (width <= m_loadOptions.atlasMaxTextureSize && height <= m_loadOptions.atlasMaxTextureSize && FitsAtlasPage(width, height))
+                {
+                    // Placed once every material and primitive is known, see BuildTextureAtlases.
+                    AtlasCandidate candidate;
+                    ArenaArray<uint8_t> pixels = DecodeImagePixels(ImagingFactory(), *m_decodeArena, imageData.data, imageData.size, keepAlpha, &candidate.width, &candidate.height, m_limiter.get());
+                    candidate.pixels.assign(pixels.begin(), pixels.end());
 
-            UINT imageWidth = 0;
-            UINT imageHeight = 0;
-            winrt::check_hresult(cpSource->GetSize(&imageWidth, &imageHeight));
-            SizeInt32 size{ static_cast<int32_t>(imageWidth), static_cast<int32_t>(imageHeight) }; // FIXME: conversion from 'UINT' to 'int32_t' requires a narrowing conversion
-            DirectXPixelFormat pixelFormat = DirectXPixelFormat::B8G8R8A8UIntNormalized; // Warning: SceneResourceSet::EnsureMipMapSurfaceId hard codes these values
-            DirectXAlphaMode alphaMode = DirectXAlphaMode::Premultiplied; // Warning: SceneResourceSet::EnsureMipMapSurfaceId hard codes these values
+                    m_atlasCandidates.emplace(image.id, move(candidate));
+                    return;
+                }
+            }
 
-            CompositionMipmapSurface mipmap = EnsureMipMapSurfaceId(
-                image.id,
-                size,
-                pixelFormat,
-                alphaMode
-                );
+            if (m_loadOptions.deferTextureDecode)
+            {
+                // Only the header is read now. The encoded bytes outlive the decode buffers of
+                // this load, so they are copied; see TextureDecodeQueue. The pixels count
+                // against the limits of the load all the same.
+                SizeInt32 encodedSize = GetEncodedImageSize(ImagingFactory(), imageData.data, imageData.size);
+                m_limiter->ChargeImage(static_cast<uint32_t>(encodedSize.Width), static_cast<uint32_t>(encodedSize.Height));
+
+                CompositionMipmapSurface mipmap = EnsureMipMapSurfaceId(
+                    image.id,
+                    encodedSize,
+                    pixelFormat,
+                    keepAlpha ? DirectXAlphaMode::Premultiplied : DirectXAlphaMode::Ignore);
+
+                m_resourceSet->AddDeferredImage(image.id, mipmap, make_shared<vector<uint8_t>>(imageData.begin(), imageData.end()));
+                return;
+            }
+
+            uint32_t imageWidth = 0;
+            uint32_t imageHeight = 0;
+            ArenaArray<uint8_t> pixels;
 
-            com_ptr<ID2D1Bitmap> cpCurrentSourceBitmap;
+            // Images of a batch were decoded up front, once for every load that uses them.
+            uint64_t sharedImageKey = 0;
+            const DecodedImage* pDecodedImage = nullptr;
 
-            // Create highest resolution source bitmap
+            if (m_sharedResources)
             {
-                com_ptr<ID2D1DeviceContext> cpD2DContext;
-
-                // Create Scalar
-                com_ptr<IWICBitmapScaler> cpScaler;
-                winrt::check_hresult(cpWIC->CreateBitmapScaler(cpScaler.put()));
-
-                winrt::check_hresult(cpScaler->Initialize(
-                    cpSource.get(),                     // Bitmap source to scale.
-                    imageWidth,                         // Scale width to half of original.
-                    imageHeight,                        // Scale height to half of original.
-                    WICBitmapInterpolationModeFant));   // Use Fant mode interpolation.
-
-                com_ptr<IWICFormatConverter> cpConverter;
-
-                winrt::check_hresult(cpWIC->CreateFormatConverter(cpConverter.put()));
-                winrt::check_hresult(cpConverter->Initialize(
-                    cpScaler.get(),
-                    /*WicPixelFormatFromDirectXPixelFormat(pixelFormat, alphaMode)*/GUID_WICPixelFormat32bppPBGRA,
-                    WICBitmapDitherTypeNone,
-                    nullptr,
-                    0.0f,
-                    WICBitmapPaletteTypeMedianCut));
-
-                CompositionDrawingSurface cpDrawingSurface = mipmap.GetDrawingSurfaceForLevel(0);
-                com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop> cpDrawingSurfaceInterop = cpDrawingSurface.as<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>();
-
-                POINT surfaceUpdateOffset;
-                winrt::check_hresult(cpDrawingSurfaceInterop->BeginDraw(
-                    nullptr,
-                    IID_PPV_ARGS(cpD2DContext.put()),
-                    &surfaceUpdateOffset));
-
-                com_ptr<ID2D1BitmapRenderTarget> cpCompatibleRenderTarget;
-                winrt::check_hresult(cpD2DContext->CreateCompatibleRenderTarget(cpCompatibleRenderTarget.put()));
-
-                winrt::check_hresult(cpCompatibleRenderTarget->CreateBitmapFromWicBitmap(
-                    cpConverter.get(),
-                    nullptr,
-                    cpCurrentSourceBitmap.put()));
-
-                winrt::check_hresult(cpDrawingSurfaceInterop->EndDraw());
+                sharedImageKey = SharedLoadResources::GetImageKey(imageData.data, imageData.size, keepAlpha);
+                pDecodedImage = m_sharedResources->FindDecodedImage(sharedImageKey);
             }
 
-            float sourceBitmapDpiX, sourceBitmapDpiY;
-                
-            cpCurrentSourceBitmap->GetDpi(&sourceBitmapDpiX, &sourceBitmapDpiY);
-
-            for (UINT i = 0; i < mipmap.LevelCount(); ++i)
+            if (pDecodedImage)
             {
-                CompositionDrawingSurface cpDrawingSurface = mipmap.GetDrawingSurfaceForLevel(i);
-                com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop> cpDrawingSurfaceInterop = cpDrawingSurface.as<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>();
-                com_ptr<ID2D1DeviceContext> cpD2DContext;
+                imageWidth = pDecodedImage->width;
+                imageHeight = pDecodedImage->height;
+                pixels = { const_cast<uint8_t*>(pDecodedImage->pixels.data()), pDecodedImage->pixels.size() };
 
-#ifndef NDEBUG
+                if (CompositionMipmapSurface sharedMipmap = m_sharedResources->FindSurface(sharedImageKey))
                 {
-                    D2D1_SIZE_U sourceSize2 = cpCurrentSourceBitmap->GetPixelSize();
-
-                    assert(sourceSize2.width == imageWidth);
-                    assert(sourceSize2.height == imageHeight);
+                    m_resourceSet->StoreSharedImage(image.id, sharedMipmap);
+
+                    if (m_sceneCacheWriter)
+                    {
+                        // The cache file of this load needs the levels as much as the first one did.
+                        ForEachMipLevel(*m_decodeArena, pixels, imageWidth, imageHeight, sharedMipmap.LevelCount(),
+                            [&](uint32_t level, uint32_t levelWidth, uint32_t levelHeight, const uint8_t* levelPixels)
+                        {
+                            m_sceneCacheWriter->RecordMipmapLevel(sharedMipmap, level, levelWidth, levelHeight, levelPixels, levelWidth * 4, usage);
+                        });
+                    }
+
+                    return;
                 }
-#endif
-
-                POINT surfaceUpdateOffset;
-                winrt::check_hresult(cpDrawingSurfaceInterop->BeginDraw(
-                    nullptr,
-                    IID_PPV_ARGS(cpD2DContext.put()),
-                    &surfaceUpdateOffset));
-                
-                D2D1_RECT_F destRect;
-                destRect.left = (float)surfaceUpdateOffset.x;
-                destRect.top = (float)surfaceUpdateOffset.y;
-                destRect.right = (float)(destRect.left + imageWidth);
-                destRect.bottom = (float)(destRect.top + imageHeight);
-
-                cpD2DContext->SetPrimitiveBlend(D2D1_PRIMITIVE_BLEND_COPY);
-
-                cpD2DContext->DrawBitmap(
-                    cpCurrentSourceBitmap.get(),
-                    &destRect,
-                    1.0f,
-                    D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
-                    );
-
-                // For debugging, turn this on to clobber the contents with red
-#if 0
-                com_ptr<ID2D1SolidColorBrush> cpSolidColorBrush;
-                winrt::check_hresult(cpD2DContext->CreateSolidColorBrush(D2D1::ColorF::ColorF(1.0f, 0.0f, 0.0f), cpSolidColorBrush.put()));
-
-                cpD2DContext->FillRectangle(
-                    &destRect,
-                    cpSolidColorBrush.get()
-                );
-#endif
-
-                winrt::check_hresult(cpD2DContext->Flush());
-
-                winrt::check_hresult(cpDrawingSurfaceInterop->EndDraw());
+            }
+            else
+            {
+                pixels = DecodeImagePixels(ImagingFactory(), *m_decodeArena, imageData.data, imageData.size, keepAlpha, &imageWidth, &imageHeight, m_limiter.get());
+            }
 
-                // Update image size
-#undef max
-                imageWidth = std::max(imageWidth / 2, 1U);
-                imageHeight = std::max(imageHeight / 2, 1U);
+            SizeInt32 size{ static_cast<int32_t>(imageWidth), static_cast<int32_t>(imageHeight) }; // FIXME: conversion from 'UINT' to 'int32_t' requires a narrowing conversion
 
-                // Now we need to generate the next level source bitmap that's going to be used for 
-                // the next imagewidth/height.  Note that imageWidth/Height have already been divided
-                // by 2.
-                com_ptr<ID2D1BitmapRenderTarget> cpNewD2DTarget;
+            CompositionMipmapSurface mipmap = EnsureMipMapSurfaceId(
+                image.id,
+                size,
+                pixelFormat,
+                ChooseAlphaMode(pixels)
+                );
 
-                D2D1_SIZE_F newDesiredSizeF = D2D1::SizeF(static_cast<float>(imageWidth) / sourceBitmapDpiX, static_cast<float>(imageHeight) / sourceBitmapDpiY);
+            UploadMipChain(mipmap, pixels, imageWidth, imageHeight, usage);
 
-                // Compatible Target should match format
-                winrt::check_hresult(cpD2DContext->CreateCompatibleRenderTarget(
-                    newDesiredSizeF,
-                    D2D1::SizeU(imageWidth, imageHeight),
-                    cpCurrentSourceBitmap->GetPixelFormat(),
-                    D2D1_COMPATIBLE_RENDER_TARGET_OPTIONS_NONE,
-                    cpNewD2DTarget.put()
-                    ));
+            if (pDecodedImage)
+            {
+                m_sharedResources->StoreSurface(sharedImageKey, mipmap);
+            }
+        }
+    }
 
-                cpNewD2DTarget->BeginDraw();
+    const TexelUsage& GLTFVisitor::GetImageUsage(const string& imageId)
+    {
+        if (!m_areImageUsagesKnown)
+        {
+            m_imageUsages = CollectImageUsages(m_gltfDocument);
+            m_areImageUsagesKnown = true;
+        }
 
-                cpNewD2DTarget->DrawBitmap(
-                    cpCurrentSourceBitmap.get(),
-                    D2D1::RectF(0.0f, 0.0f, newDesiredSizeF.width, newDesiredSizeF.height),
-                    1.0f,
-                    D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
-                    );
+        static const TexelUsage s_unknownUsage{};
 
-                winrt::check_hresult(cpNewD2DTarget->Flush());
+        auto usage = m_imageUsages.find(imageId);
+        return (usage != m_imageUsages.end()) ? usage->second : s_unknownUsage;
+    }
 
-                winrt::check_hresult(cpNewD2DTarget->EndDraw());
+    DirectXAlphaMode GLTFVisitor::ChooseAlphaMode(ArenaArray<uint8_t> pixels)
+    {
+        return AnalyzeTexels(pixels.data, pixels.size / 4).isOpaque ? DirectXAlphaMode::Ignore : DirectXAlphaMode::Premultiplied;
+    }
 
-                com_ptr<ID2D1Bitmap> cpNewBitmap;
-                winrt::check_hresult(cpNewD2DTarget->GetBitmap(cpNewBitmap.put()));
+    void GLTFVisitor::UploadMipChain(const CompositionMipmapSurface& mipmap, ArenaArray<uint8_t> pixels, uint32_t width, uint32_t height, const TexelUsage& usage)
+    {
+        // The mip chain is built on the CPU so that the finished levels can also be
+        // stored in the scene cache and uploaded from there on later loads.
+        ForEachMipLevel(*m_decodeArena, pixels, width, height, mipmap.LevelCount(),
+            [&](uint32_t level, uint32_t levelWidth, uint32_t levelHeight, const uint8_t* levelPixels)
+        {
+            UploadMipmapLevel(mipmap, level, levelWidth, levelHeight, levelPixels, levelWidth * 4);
 
-                // Now that we've generated the next level of bitmap, replace our current one
-                cpCurrentSourceBitmap = cpNewBitmap;
+            if (m_sceneCacheWriter)
+            {
+                m_sceneCacheWriter->RecordMipmapLevel(mipmap, level, levelWidth, levelHeight, levelPixels, levelWidth * 4, usage);
             }
-        }
+        });
     }
 }
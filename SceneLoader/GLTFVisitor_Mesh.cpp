@@ -30,6 +30,8 @@ namespace SceneLoader
             m_latestSceneNode.Children().Append(sceneNodeForTheGLTFMesh);
 
             m_latestSceneNode = sceneNodeForTheGLTFMesh;
+
+            BeginMeshInstances(mesh);
         }
     }
 }
\ No newline at end of file
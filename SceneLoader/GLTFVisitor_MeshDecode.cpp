@@ -0,0 +1,655 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLTFVisitor.h"
+#include "MeshCleanup.h"
+#include "MeshSimplifier.h"
+#include "NormalGenerator.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace winrt {
+    using namespace Windows::Graphics::DirectX;
+    using namespace Windows::UI::Composition::Scenes;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    // Bytes per vertex of the formats DecodeMeshPrimitive fills streams in.
+    static size_t GetVertexElementSize(DirectXPixelFormat format)
+    {
+        switch (format)
+        {
+        case DirectXPixelFormat::R32G32B32A32Float:
+            return 4 * sizeof(float);
+        case DirectXPixelFormat::R32G32B32Float:
+            return 3 * sizeof(float);
+        case DirectXPixelFormat::R32G32Float:
+            return 2 * sizeof(float);
+        default:
+            return sizeof(uint32_t);
+        }
+    }
+
+    // What a unit of difference in normals and texture coordinates costs a collapse, against
+    // a distance the size of the mesh; see SimplifierAttribute. A tenth of the texture costs
+    // as much as moving the surface by a hundredth of the mesh.
+    static constexpr float c_simplifyNormalWeight = 0.001f;
+    static constexpr float c_simplifyTexCoordWeight = 0.01f;
+
+    // Triangles a primitive draws, from the counts of its accessors.
+    static uint64_t CountTriangles(const Document& gltfDocument, const MeshPrimitive& meshPrimitive)
+    {
+        string accessorId = meshPrimitive.indicesAccessorId;
+
+        if (accessorId.empty() && !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_POSITION, accessorId))
+        {
+            return 0;
+        }
+
+        const size_t count = gltfDocument.accessors.Get(accessorId).count;
+
+        switch (meshPrimitive.mode)
+        {
+        case MESH_TRIANGLES:
+            return count / 3;
+        case MESH_TRIANGLE_STRIP:
+        case MESH_TRIANGLE_FAN:
+            return (count >= 3) ? count - 2 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    GLTFVisitor::DecodedPrimitive GLTFVisitor::DecodeMeshPrimitive(
+        DecodeArena& arena,
+        const MeshPrimitive& meshPrimitive,
+        ArenaArray<float> posedPositions,
+        ArenaArray<float> posedNormals)
+    {
+        DecodedPrimitive decoded;
+        vector<DecodedAttribute>& attributes = decoded.attributes;
+
+        for (const auto& value : meshPrimitive.attributes)
+        {
+            const Accessor& accessor = m_gltfDocument.accessors.Get(value.second);
+
+            if (value.first == ACCESSOR_POSITION)
+            {
+                auto data = !posedPositions.empty() ? posedPositions : m_accessorDecoder->ReadFloats(arena, accessor);
+
+                attributes.push_back({ SceneAttributeSemantic::Vertex, DirectXPixelFormat::R32G32B32Float, data.data, data.ByteLength() });
+            }
+            else if (value.first == ACCESSOR_NORMAL)
+            {
+                auto data = !posedNormals.empty() ? posedNormals : m_accessorDecoder->ReadFloats(arena, accessor);
+
+                attributes.push_back({ SceneAttributeSemantic::Normal, DirectXPixelFormat::R32G32B32Float, data.data, data.ByteLength() });
+            }
+            else if (value.first == ACCESSOR_TANGENT)
+            {
+                auto data = m_accessorDecoder->ReadFloats(arena, accessor);
+
+                attributes.push_back({ SceneAttributeSemantic::Tangent, DirectXPixelFormat::R32G32B32A32Float, data.data, data.ByteLength() });
+            }
+            else if ((value.first == ACCESSOR_TEXCOORD_0) || (value.first == ACCESSOR_TEXCOORD_1))
+            {
+                auto data = m_accessorDecoder->ReadFloats(arena, accessor);
+
+                attributes.push_back({
+                    (value.first == ACCESSOR_TEXCOORD_0) ? SceneAttributeSemantic::TexCoord0 : SceneAttributeSemantic::TexCoord1,
+                    DirectXPixelFormat::R32G32Float,
+                    data.data,
+                    data.ByteLength() });
+            }
+            else if (value.first == ACCESSOR_COLOR_0)
+            {
+                auto data = m_accessorDecoder->ReadColors(arena, accessor);
+
+                attributes.push_back({ SceneAttributeSemantic::Color, DirectXPixelFormat::R32UInt, data.data, data.ByteLength() });
+            }
+        }
+
+        auto indices = m_accessorDecoder->ReadTriangulatedIndices16(arena, meshPrimitive);
+
+        SimplifyMeshPrimitive(arena, meshPrimitive, &decoded, &indices);
+
+        GenerateVertexFrames(arena, meshPrimitive, &decoded, &indices);
+
+        if (m_loadOptions.cleanUpMeshes)
+        {
+            CleanUpMeshPrimitive(arena, meshPrimitive, &decoded, &indices);
+        }
+
+        attributes.push_back({ SceneAttributeSemantic::Index, DirectXPixelFormat::R16UInt, indices.data, indices.ByteLength() });
+
+        return decoded;
+    }
+
+    void GLTFVisitor::GenerateVertexFrames(
+        DecodeArena& arena,
+        const MeshPrimitive& meshPrimitive,
+        DecodedPrimitive* pDecoded,
+        ArenaArray<uint16_t>* pIndices)
+    {
+        vector<DecodedAttribute>& attributes = pDecoded->attributes;
+
+        auto findAttribute = [&](SceneAttributeSemantic semantic) -> DecodedAttribute*
+        {
+            auto attribute = find_if(attributes.begin(), attributes.end(), [&](const DecodedAttribute& a) { return a.semantic == semantic; });
+            return (attribute != attributes.end()) ? &*attribute : nullptr;
+        };
+
+        const DecodedAttribute* pPositions = findAttribute(SceneAttributeSemantic::Vertex);
+
+        if (!pPositions || pPositions->byteLength < 3 * sizeof(float))
+        {
+            return;
+        }
+
+        size_t vertexCount = pPositions->byteLength / (3 * sizeof(float));
+
+        const bool needsNormals = !findAttribute(SceneAttributeSemantic::Normal);
+
+        // Tangents follow the U of the coordinates the normal texture is sampled with.
+        optional<SceneAttributeSemantic> tangentTexCoords;
+
+        if (!findAttribute(SceneAttributeSemantic::Tangent) && !meshPrimitive.materialId.empty())
+        {
+            const auto& normalTexture = m_gltfDocument.materials.Get(meshPrimitive.materialId).normalTexture;
+            const SceneAttributeSemantic semantic = (normalTexture.texCoord == 0) ? SceneAttributeSemantic::TexCoord0 : SceneAttributeSemantic::TexCoord1;
+
+            if (!normalTexture.textureId.empty() && normalTexture.texCoord < 2 && findAttribute(semantic))
+            {
+                tangentTexCoords = semantic;
+            }
+        }
+
+        const bool needsTangents = tangentTexCoords.has_value();
+
+        if (!needsNormals && !needsTangents)
+        {
+            return;
+        }
+
+        for (uint16_t index : *pIndices)
+        {
+            if (index >= vertexCount)
+            {
+                throw InvalidGLTFException("Mesh primitive has an index past its last vertex");
+            }
+        }
+
+        // Flat normals need a vertex per triangle corner. Morphed primitives keep their vertices
+        // for the blender, and primitives with more corners than 16-bit indices can address, or
+        // with streams of different lengths, fall back to smooth normals.
+        bool isFlat = needsNormals &&
+            !m_loadOptions.smoothGeneratedNormals &&
+            meshPrimitive.targets.empty() &&
+            pIndices->size <= static_cast<size_t>(UINT16_MAX) + 1;
+
+        for (const auto& attribute : attributes)
+        {
+            isFlat = isFlat && (attribute.byteLength % vertexCount == 0);
+        }
+
+        if (isFlat)
+        {
+            for (auto& attribute : attributes)
+            {
+                const size_t elementSize = attribute.byteLength / vertexCount;
+                const uint8_t* source = static_cast<const uint8_t*>(attribute.data);
+                auto corners = arena.AllocateArray<uint8_t>(pIndices->size * elementSize);
+
+                for (size_t corner = 0; corner < pIndices->size; ++corner)
+                {
+                    memcpy(corners.data + corner * elementSize, source + (*pIndices)[corner] * elementSize, elementSize);
+                }
+
+                attribute.data = corners.data;
+                attribute.byteLength = corners.ByteLength();
+            }
+
+            // The corners may already be simplified vertices, see SimplifyMeshPrimitive.
+            auto vertexSources = arena.AllocateArray<uint16_t>(pIndices->size);
+
+            for (size_t corner = 0; corner < pIndices->size; ++corner)
+            {
+                vertexSources[corner] = pDecoded->vertexSources.empty() ? (*pIndices)[corner] : pDecoded->vertexSources[(*pIndices)[corner]];
+            }
+
+            pDecoded->vertexSources = vertexSources;
+
+            *pIndices = arena.AllocateArray<uint16_t>(vertexSources.size);
+
+            for (size_t corner = 0; corner < pIndices->size; ++corner)
+            {
+                (*pIndices)[corner] = static_cast<uint16_t>(corner);
+            }
+
+            vertexCount = pIndices->size;
+        }
+
+        const float* positions = static_cast<const float*>(findAttribute(SceneAttributeSemantic::Vertex)->data);
+
+        if (needsNormals)
+        {
+            auto normals = arena.AllocateArray<float>(vertexCount * 3);
+
+            if (isFlat)
+            {
+                GenerateFlatNormals(positions, vertexCount, normals.data);
+            }
+            else
+            {
+                GenerateSmoothNormals(positions, vertexCount, pIndices->data, pIndices->size, normals.data);
+            }
+
+            attributes.push_back({ SceneAttributeSemantic::Normal, DirectXPixelFormat::R32G32B32Float, normals.data, normals.ByteLength() });
+        }
+
+        if (needsTangents)
+        {
+            const DecodedAttribute* pNormals = findAttribute(SceneAttributeSemantic::Normal);
+            const DecodedAttribute* pTexCoords = findAttribute(*tangentTexCoords);
+
+            if (pNormals->byteLength < vertexCount * 3 * sizeof(float) || pTexCoords->byteLength < vertexCount * 2 * sizeof(float))
+            {
+                throw InvalidGLTFException("Mesh primitive has fewer normals or texture coordinates than positions");
+            }
+
+            auto tangents = arena.AllocateArray<float>(vertexCount * 4);
+
+            GenerateTangents(
+                positions,
+                static_cast<const float*>(pNormals->data),
+                static_cast<const float*>(pTexCoords->data),
+                vertexCount,
+                pIndices->data,
+                pIndices->size,
+                tangents.data);
+
+            attributes.push_back({ SceneAttributeSemantic::Tangent, DirectXPixelFormat::R32G32B32A32Float, tangents.data, tangents.ByteLength() });
+        }
+    }
+
+    void GLTFVisitor::CleanUpMeshPrimitive(
+        DecodeArena& arena,
+        const MeshPrimitive& meshPrimitive,
+        DecodedPrimitive* pDecoded,
+        ArenaArray<uint16_t>* pIndices)
+    {
+        vector<DecodedAttribute>& attributes = pDecoded->attributes;
+
+        auto positions = find_if(attributes.begin(), attributes.end(), [](const DecodedAttribute& a) { return a.semantic == SceneAttributeSemantic::Vertex; });
+
+        if (!meshPrimitive.targets.empty() || positions == attributes.end() || positions->byteLength < 3 * sizeof(float))
+        {
+            return;
+        }
+
+        const size_t vertexCount = positions->byteLength / (3 * sizeof(float));
+
+        // Every stream needs a value for every vertex; colors are the only ones compared bit for bit.
+        vector<MeshStream> streams;
+
+        for (const auto& attribute : attributes)
+        {
+            const size_t elementSize = GetVertexElementSize(attribute.format);
+
+            if (attribute.byteLength != vertexCount * elementSize)
+            {
+                return;
+            }
+
+            streams.push_back({ static_cast<const uint8_t*>(attribute.data), elementSize, attribute.format != DirectXPixelFormat::R32UInt });
+        }
+
+        for (uint16_t index : *pIndices)
+        {
+            if (index >= vertexCount)
+            {
+                throw InvalidGLTFException("Mesh primitive has an index past its last vertex");
+            }
+        }
+
+        auto indices = arena.AllocateArray<uint16_t>(pIndices->size);
+        copy(pIndices->begin(), pIndices->end(), indices.data);
+
+        size_t indexCount = indices.size;
+        const float tolerance = (m_loadOptions.meshWeldTolerance > 0.0f) ? m_loadOptions.meshWeldTolerance : 0.0f;
+
+        vector<uint32_t> sources = CleanUpMesh(
+            streams.data(),
+            streams.size(),
+            positions - attributes.begin(),
+            vertexCount,
+            indices.data,
+            &indexCount,
+            tolerance);
+
+        // A mesh without triangles left is kept as it was rather than given empty streams.
+        if (indexCount == 0)
+        {
+            return;
+        }
+
+        pDecoded->cleanupCounts = { vertexCount, sources.size(), pIndices->size, indexCount };
+
+        GatherVertices(arena, sources, pDecoded);
+
+        indices.size = indexCount;
+        *pIndices = indices;
+    }
+
+    void GLTFVisitor::SimplifyMeshPrimitive(
+        DecodeArena& arena,
+        const MeshPrimitive& meshPrimitive,
+        DecodedPrimitive* pDecoded,
+        ArenaArray<uint16_t>* pIndices)
+    {
+        auto ratio = m_simplifyRatios.find(&meshPrimitive);
+
+        if (ratio == m_simplifyRatios.end() || !meshPrimitive.targets.empty())
+        {
+            return;
+        }
+
+        const vector<DecodedAttribute>& attributes = pDecoded->attributes;
+
+        auto positions = find_if(attributes.begin(), attributes.end(), [](const DecodedAttribute& a) { return a.semantic == SceneAttributeSemantic::Vertex; });
+
+        if (positions == attributes.end() || positions->byteLength < 3 * sizeof(float))
+        {
+            return;
+        }
+
+        const size_t vertexCount = positions->byteLength / (3 * sizeof(float));
+
+        vector<SimplifierAttribute> weightedAttributes;
+
+        for (const auto& attribute : attributes)
+        {
+            if (attribute.byteLength != vertexCount * GetVertexElementSize(attribute.format))
+            {
+                return;
+            }
+
+            if (attribute.semantic == SceneAttributeSemantic::Normal)
+            {
+                weightedAttributes.push_back({ static_cast<const float*>(attribute.data), 3, c_simplifyNormalWeight });
+            }
+            else if (attribute.semantic == SceneAttributeSemantic::TexCoord0 || attribute.semantic == SceneAttributeSemantic::TexCoord1)
+            {
+                weightedAttributes.push_back({ static_cast<const float*>(attribute.data), 2, c_simplifyTexCoordWeight });
+            }
+        }
+
+        for (uint16_t index : *pIndices)
+        {
+            if (index >= vertexCount)
+            {
+                throw InvalidGLTFException("Mesh primitive has an index past its last vertex");
+            }
+        }
+
+        const size_t triangleCount = pIndices->size / 3;
+        const size_t targetTriangleCount = max<size_t>(1, static_cast<size_t>(triangleCount * ratio->second));
+
+        auto indices = arena.AllocateArray<uint16_t>(pIndices->size);
+        copy(pIndices->begin(), pIndices->end(), indices.data);
+
+        const SimplifyResult result = SimplifyMesh(
+            static_cast<const float*>(positions->data),
+            vertexCount,
+            weightedAttributes.data(),
+            weightedAttributes.size(),
+            indices.data,
+            indices.size,
+            targetTriangleCount * 3);
+
+        if (result.indexCount == 0 || result.indexCount == triangleCount * 3)
+        {
+            return;
+        }
+
+        // Only the vertices the triangles still use are kept, in the order they are first used.
+        vector<uint32_t> sources;
+        vector<uint32_t> compactedVertices(vertexCount, UINT32_MAX);
+
+        for (size_t i = 0; i < result.indexCount; ++i)
+        {
+            uint32_t& compactedVertex = compactedVertices[indices[i]];
+
+            if (compactedVertex == UINT32_MAX)
+            {
+                compactedVertex = static_cast<uint32_t>(sources.size());
+                sources.push_back(indices[i]);
+            }
+
+            indices[i] = static_cast<uint16_t>(compactedVertex);
+        }
+
+        GatherVertices(arena, sources, pDecoded);
+
+        pDecoded->simplifyCounts = { triangleCount, result.indexCount / 3, result.error };
+
+        indices.size = result.indexCount;
+        *pIndices = indices;
+    }
+
+    void GLTFVisitor::GatherVertices(DecodeArena& arena, const vector<uint32_t>& sources, DecodedPrimitive* pDecoded)
+    {
+        for (auto& attribute : pDecoded->attributes)
+        {
+            const size_t elementSize = GetVertexElementSize(attribute.format);
+            const uint8_t* source = static_cast<const uint8_t*>(attribute.data);
+            auto gathered = arena.AllocateArray<uint8_t>(sources.size() * elementSize);
+
+            for (size_t vertex = 0; vertex < sources.size(); ++vertex)
+            {
+                memcpy(gathered.data + vertex * elementSize, source + sources[vertex] * elementSize, elementSize);
+            }
+
+            attribute.data = gathered.data;
+            attribute.byteLength = gathered.ByteLength();
+        }
+
+        // The sources may already be unwelded corners, see GenerateVertexFrames.
+        auto vertexSources = arena.AllocateArray<uint16_t>(sources.size());
+
+        for (size_t vertex = 0; vertex < sources.size(); ++vertex)
+        {
+            vertexSources[vertex] = pDecoded->vertexSources.empty() ? static_cast<uint16_t>(sources[vertex]) : pDecoded->vertexSources[sources[vertex]];
+        }
+
+        pDecoded->vertexSources = vertexSources;
+    }
+
+    void GLTFVisitor::PlanTriangleBudgets()
+    {
+        if (m_loadOptions.triangleBudget == 0 && m_loadOptions.meshTriangleBudget == 0)
+        {
+            return;
+        }
+
+        // How often each mesh below the scene is drawn: once per node, or once per instance.
+        unordered_map<string, uint64_t> meshDrawCounts;
+        vector<string> meshIds;
+        vector<string> pending(m_gltfScene.nodes.begin(), m_gltfScene.nodes.end());
+
+        while (!pending.empty())
+        {
+            string nodeId = move(pending.back());
+            pending.pop_back();
+
+            const Node& node = m_gltfDocument.nodes.Get(nodeId);
+
+            if (!node.meshId.empty())
+            {
+                MeshInstancingAccessors accessors;
+                uint64_t drawCount = 1;
+
+                if (TryGetMeshInstancing(m_gltfDocument, node, &accessors))
+                {
+                    const string& accessorId =
+                        !accessors.translationAccessorId.empty() ? accessors.translationAccessorId :
+                        !accessors.rotationAccessorId.empty() ? accessors.rotationAccessorId :
+                        accessors.scaleAccessorId;
+
+                    drawCount = m_gltfDocument.accessors.Get(accessorId).count;
+                }
+
+                auto meshDrawCount = meshDrawCounts.emplace(node.meshId, 0);
+
+                if (meshDrawCount.second)
+                {
+                    meshIds.push_back(node.meshId);
+                }
+
+                meshDrawCount.first->second += drawCount;
+            }
+
+            pending.insert(pending.end(), node.children.begin(), node.children.end());
+        }
+
+        // The mesh budget first, then whatever the scene budget still asks for, spread evenly.
+        // Morphed primitives can't be simplified and take their share off the top.
+        struct MeshBudget
+        {
+            const Mesh* pMesh;
+            uint64_t drawCount;
+            double ratio;
+        };
+
+        vector<MeshBudget> meshBudgets;
+        double fixedTriangles = 0.0;
+        double simplifiedTriangles = 0.0;
+
+        for (const auto& meshId : meshIds)
+        {
+            const Mesh& mesh = m_gltfDocument.meshes.Get(meshId);
+            uint64_t meshFixedTriangles = 0;
+            uint64_t meshTriangles = 0;
+
+            for (const auto& meshPrimitive : mesh.primitives)
+            {
+                (meshPrimitive.targets.empty() ? meshTriangles : meshFixedTriangles) += CountTriangles(m_gltfDocument, meshPrimitive);
+            }
+
+            double ratio = 1.0;
+
+            if (m_loadOptions.meshTriangleBudget > 0 && meshFixedTriangles + meshTriangles > m_loadOptions.meshTriangleBudget && meshTriangles > 0)
+            {
+                const uint64_t available = (m_loadOptions.meshTriangleBudget > meshFixedTriangles) ? m_loadOptions.meshTriangleBudget - meshFixedTriangles : 0;
+                ratio = static_cast<double>(available) / meshTriangles;
+            }
+
+            const uint64_t drawCount = meshDrawCounts[meshId];
+
+            fixedTriangles += static_cast<double>(drawCount) * meshFixedTriangles;
+            simplifiedTriangles += static_cast<double>(drawCount) * meshTriangles * ratio;
+
+            meshBudgets.push_back({ &mesh, drawCount, ratio });
+        }
+
+        double sceneRatio = 1.0;
+
+        if (m_loadOptions.triangleBudget > 0 && fixedTriangles + simplifiedTriangles > m_loadOptions.triangleBudget && simplifiedTriangles > 0.0)
+        {
+            sceneRatio = max(static_cast<double>(m_loadOptions.triangleBudget) - fixedTriangles, 0.0) / simplifiedTriangles;
+        }
+
+        for (const auto& meshBudget : meshBudgets)
+        {
+            const double ratio = meshBudget.ratio * sceneRatio;
+
+            if (ratio >= 1.0 || meshBudget.drawCount == 0)
+            {
+                continue;
+            }
+
+            for (const auto& meshPrimitive : meshBudget.pMesh->primitives)
+            {
+                if (meshPrimitive.targets.empty())
+                {
+                    m_simplifyRatios[&meshPrimitive] = static_cast<float>(ratio);
+                }
+            }
+        }
+    }
+
+    void GLTFVisitor::DecodeMeshPrimitives()
+    {
+        // Plan: every primitive of every mesh below the scene, in the order Visit reaches them.
+        vector<const MeshPrimitive*> primitives;
+        unordered_set<string> plannedNodeIds;
+        unordered_set<string> plannedMeshIds;
+        vector<string> pending(m_gltfScene.nodes.rbegin(), m_gltfScene.nodes.rend());
+
+        while (!pending.empty())
+        {
+            string nodeId = move(pending.back());
+            pending.pop_back();
+
+            if (!plannedNodeIds.insert(nodeId).second)
+            {
+                continue;
+            }
+
+            const Node& node = m_gltfDocument.nodes.Get(nodeId);
+
+            if (!node.meshId.empty() && plannedMeshIds.insert(node.meshId).second)
+            {
+                for (const auto& meshPrimitive : m_gltfDocument.meshes.Get(node.meshId).primitives)
+                {
+                    // The vertices of these depend on the node; they are decoded as they are visited.
+                    string jointsAccessorId;
+
+                    if (meshPrimitive.targets.empty() && !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_JOINTS_0, jointsAccessorId))
+                    {
+                        primitives.push_back(&meshPrimitive);
+                    }
+                }
+            }
+
+            pending.insert(pending.end(), node.children.rbegin(), node.children.rend());
+        }
+
+        // Decode: each thread fills an arena of its own, kept until the scene is built.
+        vector<DecodedPrimitive> decoded(primitives.size());
+        concurrency::combinable<shared_ptr<DecodeArena>> arenas([]() { return make_shared<DecodeArena>(); });
+
+        concurrency::parallel_for(size_t(0), primitives.size(), [&](size_t i)
+        {
+            decoded[i] = DecodeMeshPrimitive(*arenas.local(), *primitives[i], {}, {});
+        });
+
+        arenas.combine_each([&](const shared_ptr<DecodeArena>& arena)
+        {
+            m_decodedPrimitiveArenas.push_back(arena);
+        });
+
+        for (size_t i = 0; i < primitives.size(); ++i)
+        {
+            m_decodedPrimitives.emplace(primitives[i], move(decoded[i]));
+        }
+    }
+
+    size_t GLTFVisitor::DecodedMeshBytes() const
+    {
+        size_t byteLength = 0;
+
+        for (const auto& arena : m_decodedPrimitiveArenas)
+        {
+            byteLength += arena->PeakBytes();
+        }
+
+        return byteLength;
+    }
+} // SceneLoader
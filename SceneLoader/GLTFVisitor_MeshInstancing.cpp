@@ -0,0 +1,256 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLTFVisitor.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace winrt {
+    using namespace Windows::Graphics::DirectX;
+    using namespace Windows::UI::Composition::Scenes;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    // Vertices a merged mesh can have with 16-bit indices.
+    static constexpr size_t c_maxBatchVertexCount = static_cast<size_t>(UINT16_MAX) + 1;
+
+    void GLTFVisitor::BeginMeshInstances(const Mesh& mesh)
+    {
+        m_isMeshInstanced = false;
+        m_meshPrimitiveCount = mesh.primitives.size();
+        m_meshInstances = {};
+        m_meshInstanceMatrices.clear();
+        m_meshInstanceNodes.clear();
+
+        MeshInstancingAccessors accessors;
+
+        if (!m_currentGltfNode || !TryGetMeshInstancing(m_gltfDocument, *m_currentGltfNode, &accessors))
+        {
+            return;
+        }
+
+        m_isMeshInstanced = true;
+        m_meshInstances = ReadMeshInstances(*m_accessorDecoder, *m_decodeArena, m_gltfDocument, accessors);
+
+        m_meshInstancingCounts.instanceCount += m_meshInstances.count;
+    }
+
+    void GLTFVisitor::AddInstanceRenderers(const SceneMeshRendererComponent& renderComponent)
+    {
+        if (m_meshInstanceNodes.empty())
+        {
+            m_meshInstanceNodes.reserve(m_meshInstances.count);
+
+            for (size_t i = 0; i < m_meshInstances.count; ++i)
+            {
+                const float* translation = &m_meshInstances.translations[i * 3];
+                const float* rotation = &m_meshInstances.rotations[i * 4];
+                const float* scale = &m_meshInstances.scales[i * 3];
+
+                auto instanceNode = SceneNode::Create(m_compositor);
+                instanceNode.Transform().Translation({ translation[0], translation[1], translation[2] });
+                instanceNode.Transform().Orientation({ rotation[0], rotation[1], rotation[2], rotation[3] });
+                instanceNode.Transform().Scale({ scale[0], scale[1], scale[2] });
+
+                m_latestSceneNode.Children().Append(instanceNode);
+                m_meshInstanceNodes.push_back(instanceNode);
+            }
+
+            m_meshInstancingCounts.instanceNodeCount += m_meshInstanceNodes.size();
+        }
+
+        for (size_t i = 0; i < m_meshInstanceNodes.size(); ++i)
+        {
+            SceneMeshRendererComponent instanceRenderComponent = renderComponent;
+
+            if (i > 0)
+            {
+                instanceRenderComponent = SceneMeshRendererComponent::Create(m_compositor);
+                instanceRenderComponent.Mesh(renderComponent.Mesh());
+                instanceRenderComponent.Material(renderComponent.Material());
+            }
+
+            // The cache, like the rest of the loader, expects one renderer per node.
+            if (m_meshPrimitiveCount == 1)
+            {
+                m_meshInstanceNodes[i].Components().Append(instanceRenderComponent);
+            }
+            else
+            {
+                auto primitiveNode = SceneNode::Create(m_compositor);
+                primitiveNode.Components().Append(instanceRenderComponent);
+
+                m_meshInstanceNodes[i].Children().Append(primitiveNode);
+            }
+        }
+
+        if (m_meshPrimitiveCount != 1)
+        {
+            m_meshInstancingCounts.instanceNodeCount += m_meshInstanceNodes.size();
+        }
+    }
+
+    bool GLTFVisitor::TryAddInstanceBatches(
+        const MeshPrimitive& meshPrimitive,
+        const DecodedPrimitive& primitive,
+        const SceneMetallicRoughnessMaterial& material)
+    {
+        const vector<DecodedAttribute>& attributes = primitive.attributes;
+
+        auto findAttribute = [&](SceneAttributeSemantic semantic) -> const DecodedAttribute*
+        {
+            auto attribute = find_if(attributes.begin(), attributes.end(), [&](const DecodedAttribute& a) { return a.semantic == semantic; });
+            return (attribute != attributes.end()) ? &*attribute : nullptr;
+        };
+
+        const DecodedAttribute* pPositions = findAttribute(SceneAttributeSemantic::Vertex);
+        const DecodedAttribute* pIndices = findAttribute(SceneAttributeSemantic::Index);
+
+        if (m_loadOptions.instanceBatchMaxVertices == 0 || meshPrimitive.mode != MESH_TRIANGLES || !pPositions || !pIndices)
+        {
+            return false;
+        }
+
+        const size_t vertexCount = pPositions->byteLength / (3 * sizeof(float));
+
+        if (vertexCount == 0 || vertexCount > m_loadOptions.instanceBatchMaxVertices || vertexCount > c_maxBatchVertexCount)
+        {
+            return false;
+        }
+
+        // Every stream has to be one element per vertex for the copies to line up.
+        for (const auto& attribute : attributes)
+        {
+            if (attribute.semantic == SceneAttributeSemantic::Index)
+            {
+                continue;
+            }
+
+            const size_t elementSize = attribute.byteLength / vertexCount;
+
+            if (attribute.byteLength % vertexCount != 0 ||
+                (attribute.semantic == SceneAttributeSemantic::Normal && elementSize != 3 * sizeof(float)) ||
+                (attribute.semantic == SceneAttributeSemantic::Tangent && elementSize != 4 * sizeof(float)))
+            {
+                return false;
+            }
+        }
+
+        const uint16_t* indices = static_cast<const uint16_t*>(pIndices->data);
+        const size_t indexCount = pIndices->byteLength / sizeof(uint16_t);
+
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            if (indices[i] >= vertexCount)
+            {
+                return false;
+            }
+        }
+
+        if (m_meshInstanceMatrices.empty())
+        {
+            m_meshInstanceMatrices.resize(m_meshInstances.count);
+
+            ComputeInstanceMatrices(m_meshInstances, 0, m_meshInstances.count, m_meshInstanceMatrices.data());
+        }
+
+        const size_t instancesPerBatch = c_maxBatchVertexCount / vertexCount;
+
+        for (size_t first = 0; first < m_meshInstances.count; first += instancesPerBatch)
+        {
+            const size_t batchInstanceCount = min(instancesPerBatch, m_meshInstances.count - first);
+
+            DecodeArena::Scope scratch(*m_decodeArena);
+
+            auto batchMesh = SceneMesh::Create(m_compositor);
+            batchMesh.PrimitiveTopology(DirectXPrimitiveTopology::TriangleList);
+
+            for (const auto& attribute : attributes)
+            {
+                auto batch = m_decodeArena->AllocateArray<uint8_t>(attribute.byteLength * batchInstanceCount);
+
+                for (size_t i = 0; i < batchInstanceCount; ++i)
+                {
+                    const InstanceMatrix& matrix = m_meshInstanceMatrices[first + i];
+                    void* pDestination = batch.data + i * attribute.byteLength;
+
+                    switch (attribute.semantic)
+                    {
+                    case SceneAttributeSemantic::Vertex:
+                        TransformInstancePositions(matrix, static_cast<const float*>(attribute.data), vertexCount, static_cast<float*>(pDestination));
+                        break;
+
+                    case SceneAttributeSemantic::Normal:
+                        TransformInstanceNormals(matrix, static_cast<const float*>(attribute.data), vertexCount, static_cast<float*>(pDestination));
+                        break;
+
+                    case SceneAttributeSemantic::Tangent:
+                        TransformInstanceTangents(matrix, static_cast<const float*>(attribute.data), vertexCount, static_cast<float*>(pDestination));
+                        break;
+
+                    case SceneAttributeSemantic::Index:
+                    {
+                        uint16_t* batchIndices = static_cast<uint16_t*>(pDestination);
+                        const size_t firstVertex = i * vertexCount;
+
+                        for (size_t index = 0; index < indexCount; ++index)
+                        {
+                            batchIndices[index] = static_cast<uint16_t>(indices[index] + firstVertex);
+                        }
+                        break;
+                    }
+
+                    default:
+                        memcpy(pDestination, attribute.data, attribute.byteLength);
+                        break;
+                    }
+                }
+
+                FillMeshAttribute(batchMesh, attribute.semantic, attribute.format, batch.data, batch.ByteLength());
+            }
+
+            auto renderComponent = SceneMeshRendererComponent::Create(m_compositor);
+            renderComponent.Mesh(batchMesh);
+            renderComponent.Material(material);
+
+            auto batchNode = SceneNode::Create(m_compositor);
+            batchNode.Components().Append(renderComponent);
+
+            m_latestSceneNode.Children().Append(batchNode);
+            m_resourceSet->SetLatestMeshRendererComponent(renderComponent);
+
+            if (m_loadOptions.atlasMaxTextureSize > 0 && !meshPrimitive.materialId.empty())
+            {
+                TexturedPrimitive texturedPrimitive;
+                texturedPrimitive.mesh = batchMesh;
+                texturedPrimitive.materialId = meshPrimitive.materialId;
+                meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_TEXCOORD_0, texturedPrimitive.texCoordAccessorIds[0]);
+                meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_TEXCOORD_1, texturedPrimitive.texCoordAccessorIds[1]);
+
+                // Every instance repeats the vertices of the accessors.
+                texturedPrimitive.vertexSources.reserve(vertexCount * batchInstanceCount);
+
+                for (size_t i = 0; i < batchInstanceCount; ++i)
+                {
+                    for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+                    {
+                        texturedPrimitive.vertexSources.push_back(primitive.vertexSources.empty() ? static_cast<uint16_t>(vertex) : primitive.vertexSources[vertex]);
+                    }
+                }
+
+                m_texturedPrimitives.push_back(move(texturedPrimitive));
+            }
+
+            m_meshInstancingCounts.instanceNodeCount++;
+            m_meshInstancingCounts.batchMeshCount++;
+        }
+
+        return true;
+    }
+} // SceneLoader
@@ -17,8 +17,6 @@ namespace winrt {
 }
 using namespace winrt;
 
-extern vector<uint8_t> s_binExportVector;
-
 namespace SceneLoader
 {
     // Mesh Primitive
@@ -26,18 +24,21 @@ namespace SceneLoader
     {
         if (state == VisitState::New)
         {
-            static uint16_t sCounter = 0;
-
             auto sceneNodeForTheGLTFMeshPrimitive = SceneNode::Create(m_compositor);
 
-            // m_latestSceneNode is sceneNodeForTheGLTFMesh
-            m_latestSceneNode.Children().Append(sceneNodeForTheGLTFMeshPrimitive);
+            // m_latestSceneNode is sceneNodeForTheGLTFMesh. Instanced meshes place their
+            // renderers on the instance nodes instead, see AddInstanceRenderers.
+            if (!m_isMeshInstanced)
+            {
+                m_latestSceneNode.Children().Append(sceneNodeForTheGLTFMeshPrimitive);
+            }
 
 
             // We want all MeshPrimitives of a Mesh to be siblings.
             // That's why we don't define m_latestSceneNode as sceneNodeForTheGLTFMeshPrimitive.
 
             auto curMaterial = m_resourceSet->EnsureMaterialById(meshPrimitive.materialId);
+            m_resourceSet->CountMaterialReference(meshPrimitive.materialId);
 
             auto mesh = SceneMesh::Create(m_compositor);
 
@@ -50,72 +51,53 @@ namespace SceneLoader
                 SceneResourceSet::UnimplementedFeatureFound();
             }
 
-            for (auto value : meshPrimitive.attributes)
+            // Everything decoded for this primitive is copied into MemoryBuffers below,
+            // so the scratch memory can be recycled for the next primitive.
+            DecodeArena::Scope scratch(*m_decodeArena);
+
+            auto decoded = m_decodedPrimitives.find(&meshPrimitive);
+
+            shared_ptr<MorphTargetBlender> morphTargetBlender;
+            bool isSkinned = false;
+            DecodedPrimitive primitive;
+
+            if (decoded != m_decodedPrimitives.end())
             {
-                if (value.first == ACCESSOR_POSITION)
-                {
-                    auto accessorId = meshPrimitive.GetAttributeAccessorId(value.first);
-                    auto& accessor = m_gltfDocument.accessors[accessorId];
-
-                    auto data = MeshPrimitiveUtils::GetPositions(m_gltfDocument, *m_gltfResourceReader, accessor);
-
-                    mesh.FillMeshAttribute(
-                        SceneAttributeSemantic::Vertex,
-                        DirectXPixelFormat::R32G32B32Float,
-                        CopyArrayOfBytesToMemoryBuffer((BYTE*)data.data(), data.size() * sizeof(float)));
-                }
-                else if (value.first == ACCESSOR_NORMAL)
-                {
-                    auto accessorId = meshPrimitive.GetAttributeAccessorId(value.first);
-                    auto& accessor = m_gltfDocument.accessors[accessorId];
-                    auto data = MeshPrimitiveUtils::GetNormals(m_gltfDocument, *m_gltfResourceReader, accessor);
-
-                    mesh.FillMeshAttribute(
-                        SceneAttributeSemantic::Normal,
-                        DirectXPixelFormat::R32G32B32Float,
-                        CopyArrayOfBytesToMemoryBuffer((BYTE*)data.data(), data.size() * sizeof(float)));
-                }
-                else if (value.first == ACCESSOR_TANGENT)
-                {
-                    auto accessorId = meshPrimitive.GetAttributeAccessorId(value.first);
-                    auto& accessor = m_gltfDocument.accessors[accessorId];
-                    auto data = MeshPrimitiveUtils::GetTangents(m_gltfDocument, *m_gltfResourceReader, accessor);
-
-                    mesh.FillMeshAttribute(
-                        SceneAttributeSemantic::Tangent,
-                        DirectXPixelFormat::R32G32B32A32Float,
-                        CopyArrayOfBytesToMemoryBuffer((BYTE*)data.data(), data.size() * sizeof(float)));
-                }
-                else if ((value.first == ACCESSOR_TEXCOORD_0) || (value.first == ACCESSOR_TEXCOORD_1))
-                {
-                    auto accessorId = meshPrimitive.GetAttributeAccessorId(value.first);
-                    auto& accessor = m_gltfDocument.accessors[accessorId];
-                    auto data = MeshPrimitiveUtils::GetTexCoords(m_gltfDocument, *m_gltfResourceReader, accessor);
-
-                    mesh.FillMeshAttribute(
-                        (value.first == ACCESSOR_TEXCOORD_0) ? SceneAttributeSemantic::TexCoord0 : SceneAttributeSemantic::TexCoord1,
-                        DirectXPixelFormat::R32G32Float,
-                        CopyArrayOfBytesToMemoryBuffer((BYTE*)data.data(), data.size() * sizeof(float)));
-                }
-                else if (value.first == ACCESSOR_COLOR_0)
-                {
-                    auto accessorId = meshPrimitive.GetAttributeAccessorId(value.first);
-                    auto& accessor = m_gltfDocument.accessors[accessorId];
-                    auto data = MeshPrimitiveUtils::GetColors(m_gltfDocument, *m_gltfResourceReader, accessor);
-
-                    mesh.FillMeshAttribute(
-                        SceneAttributeSemantic::Color,
-                        DirectXPixelFormat::R32UInt,
-                        CopyArrayOfBytesToMemoryBuffer((BYTE*)data.data(), data.size() * sizeof(uint32_t)));
-                }
-            } // for attributes
-
-            auto indices = MeshPrimitiveUtils::GetTriangulatedIndices16(m_gltfDocument, *m_gltfResourceReader, meshPrimitive);
-
-            mesh.FillMeshAttribute(
-                SceneAttributeSemantic::Index,
-                DirectXPixelFormat::R16UInt,
-                CopyArrayOfBytesToMemoryBuffer((BYTE*)indices.data(), indices.size() * sizeof(uint16_t)));
+                primitive = move(decoded->second);
+                m_decodedPrimitives.erase(decoded);
+            }
+            else
+            {
+                // Morph targets are applied first, then the skin.
+                ArenaArray<float> posedPositions;
+                ArenaArray<float> posedNormals;
+
+                morphTargetBlender = CreateMorphTargetBlender(meshPrimitive, &posedPositions, &posedNormals);
+                isSkinned = SkinMeshPrimitive(meshPrimitive, &posedPositions, &posedNormals);
+
+                primitive = DecodeMeshPrimitive(*m_decodeArena, meshPrimitive, posedPositions, posedNormals);
+            }
+
+            m_meshCleanupCounts.Add(primitive.cleanupCounts);
+            m_meshSimplifyCounts.Add(primitive.simplifyCounts);
+
+            AddPrimitiveBounds(meshPrimitive, primitive);
+
+            // Morphed meshes stay shared so that SetMorphTargetWeights reaches every instance.
+            if (m_isMeshInstanced && !morphTargetBlender && TryAddInstanceBatches(meshPrimitive, primitive, curMaterial))
+            {
+                return;
+            }
+
+            for (const auto& attribute : primitive.attributes)
+            {
+                FillMeshAttribute(
+                    mesh,
+                    attribute.semantic,
+                    attribute.format,
+                    attribute.data,
+                    attribute.byteLength);
+            }
 
             //
             // Creates SceneRendererComponent, attaches MeshRenderer and add as component of the SceneNode
@@ -126,9 +108,38 @@ namespace SceneLoader
 
             renderComponent.Material(curMaterial);
 
-            sceneNodeForTheGLTFMeshPrimitive.Components().Append(renderComponent);
+            if (m_loadOptions.atlasMaxTextureSize > 0 && !meshPrimitive.materialId.empty())
+            {
+                TexturedPrimitive texturedPrimitive;
+                texturedPrimitive.mesh = mesh;
+                texturedPrimitive.materialId = meshPrimitive.materialId;
+                meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_TEXCOORD_0, texturedPrimitive.texCoordAccessorIds[0]);
+                meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_TEXCOORD_1, texturedPrimitive.texCoordAccessorIds[1]);
+                texturedPrimitive.vertexSources.assign(primitive.vertexSources.begin(), primitive.vertexSources.end());
+
+                m_texturedPrimitives.push_back(move(texturedPrimitive));
+            }
+
+            if (m_isMeshInstanced)
+            {
+                AddInstanceRenderers(renderComponent);
+            }
+            else
+            {
+                sceneNodeForTheGLTFMeshPrimitive.Components().Append(renderComponent);
+            }
+
+            // Skinned primitives stay baked with the weights they were loaded with.
+            if (morphTargetBlender && !isSkinned)
+            {
+                MorphedPrimitive morphedPrimitive;
+                morphedPrimitive.node = m_sceneNodeMap.Lookup(GetHSTRINGFromStdString(m_currentGltfNode->id));
+                morphedPrimitive.mesh = mesh;
+                morphedPrimitive.blender = morphTargetBlender;
+
+                m_morphedPrimitives.push_back(morphedPrimitive);
+            }
 
-            sCounter++;
             m_resourceSet->SetLatestMeshRendererComponent(renderComponent);
         }
     }
@@ -0,0 +1,113 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "GLTFVisitor.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+using namespace winrt;
+
+namespace SceneLoader
+{
+    MorphTargetDeltas GLTFVisitor::ReadMorphTargetDeltas(const string& accessorId, size_t vertexCount)
+    {
+        if (accessorId.empty())
+        {
+            return MorphTargetDeltas::None();
+        }
+
+        const Accessor& accessor = m_gltfDocument.accessors.Get(accessorId);
+
+        if (accessor.type != TYPE_VEC3 || accessor.count != vertexCount)
+        {
+            throw InvalidGLTFException("Morph target accessor " + accessor.id + " must be a VEC3 with one element per vertex");
+        }
+
+        DecodeArena::Scope scratch(*m_decodeArena);
+
+        ArenaArray<uint32_t> indices;
+        ArenaArray<float> values;
+
+        // Sparse targets stay sparse so that blending only touches the vertices they move.
+        if (m_accessorDecoder->TryReadSparseFloats(*m_decodeArena, accessor, &indices, &values))
+        {
+            return MorphTargetDeltas::Sparse(indices.data, values.data, indices.size);
+        }
+
+        values = m_accessorDecoder->ReadFloats(*m_decodeArena, accessor);
+
+        return MorphTargetDeltas::Dense(values.data, vertexCount);
+    }
+
+    shared_ptr<MorphTargetBlender> GLTFVisitor::CreateMorphTargetBlender(const MeshPrimitive& meshPrimitive, ArenaArray<float>* pPositions, ArenaArray<float>* pNormals)
+    {
+        string positionAccessorId;
+
+        if (meshPrimitive.targets.empty() || !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_POSITION, positionAccessorId))
+        {
+            return nullptr;
+        }
+
+        shared_ptr<MorphTargetBlender> blender;
+
+        {
+            DecodeArena::Scope scratch(*m_decodeArena);
+
+            auto positions = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(positionAccessorId));
+            const size_t vertexCount = positions.size / 3;
+
+            ArenaArray<float> normals;
+            string normalAccessorId;
+
+            if (meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_NORMAL, normalAccessorId))
+            {
+                normals = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(normalAccessorId));
+
+                if (normals.size != vertexCount * 3)
+                {
+                    throw InvalidGLTFException("Mesh primitive has a different number of normals and positions");
+                }
+            }
+
+            blender = make_shared<MorphTargetBlender>(positions.data, normals.empty() ? nullptr : normals.data, vertexCount);
+
+            for (const auto& target : meshPrimitive.targets)
+            {
+                blender->AddTarget(
+                    ReadMorphTargetDeltas(target.positionsAccessorId, vertexCount),
+                    ReadMorphTargetDeltas(target.normalsAccessorId, vertexCount));
+            }
+        }
+
+        // Weights on the node override the defaults of the mesh.
+        const vector<float>* pWeights = nullptr;
+
+        if (m_currentGltfNode)
+        {
+            pWeights = !m_currentGltfNode->weights.empty() ? &m_currentGltfNode->weights : &m_gltfDocument.meshes.Get(m_currentGltfNode->meshId).weights;
+        }
+
+        if (pWeights)
+        {
+            blender->SetWeights(pWeights->data(), pWeights->size());
+        }
+
+        // The blender keeps its own copy; these go to the mesh and the skin.
+        const size_t vertexCount = blender->VertexCount();
+
+        *pPositions = m_decodeArena->AllocateArray<float>(vertexCount * 3);
+        memcpy(pPositions->data, blender->Positions(), pPositions->ByteLength());
+
+        if (blender->Normals())
+        {
+            *pNormals = m_decodeArena->AllocateArray<float>(vertexCount * 3);
+            memcpy(pNormals->data, blender->Normals(), pNormals->ByteLength());
+        }
+
+        return blender;
+    }
+} // SceneLoader
@@ -20,26 +20,85 @@ using namespace std;
 
 namespace SceneLoader
 {
+    const vector<size_t>& GLTFVisitor::EnsureNodeParentIndices()
+    {
+        const size_t nodeCount = m_gltfDocument.nodes.Size();
+
+        if (m_nodeParentIndices.size() != nodeCount)
+        {
+            m_nodeParentIndices.assign(nodeCount, c_noParentNode);
+
+            for (size_t n = 0; n < nodeCount; ++n)
+            {
+                for (const auto& childId : m_gltfDocument.nodes[n].children)
+                {
+                    m_nodeParentIndices[m_gltfDocument.nodes.GetIndex(childId)] = n;
+                }
+            }
+        }
+
+        return m_nodeParentIndices;
+    }
+
+    // The matrix a SceneNode with this transform applies, for row vectors.
+    static float4x4 ComposeMatrix(const float3& scale, const quaternion& rotation, const float3& translation)
+    {
+        return make_float4x4_scale(scale) * make_float4x4_from_quaternion(rotation) * make_float4x4_translation(translation);
+    }
+
     // Node
     void GLTFVisitor::operator()(const Node& node, const Node* nodeParent)
     {
+        m_limiter->CheckTime();
+
         wstring nodeID{ node.id.begin(), node.id.end() };
 
         auto sceneNode = SceneNode::Create(m_compositor);
         sceneNode.Comment(nodeID);
 
         m_latestSceneNode = sceneNode;
+        m_currentGltfNode = &node;
         m_sceneNodeMap.Insert(GetHSTRINGFromStdString(node.id), sceneNode);
 
+        // Where the parent of a root of the scene puts it, for the bounds.
+        float4x4 ancestorMatrix = float4x4::identity();
+
         if (!nodeParent)
         {
-            m_rootSceneNode.Children().Append(sceneNode);
+            SceneNode parentSceneNode = m_rootSceneNode;
+            size_t parentIndex = EnsureNodeParentIndices()[m_gltfDocument.nodes.GetIndex(node.id)];
+
+            // A subtree selected out of a deeper hierarchy keeps the placement its ancestors give it.
+            if (parentIndex != c_noParentNode)
+            {
+                array<float, 16> ancestorMatrix;
+                memcpy(ancestorMatrix.data(), &EnsureRestWorldMatrices()[parentIndex], sizeof(ancestorMatrix));
+
+                float3 scale;
+                quaternion rotation;
+                float3 translation;
+
+                DecomposeMatrix(ancestorMatrix, &scale, &rotation, &translation);
+
+                parentSceneNode = SceneNode::Create(m_compositor);
+                parentSceneNode.Transform().Scale(scale);
+                parentSceneNode.Transform().Orientation(rotation);
+                parentSceneNode.Transform().Translation(translation);
+
+                m_rootSceneNode.Children().Append(parentSceneNode);
+
+                ancestorMatrix = ComposeMatrix(scale, rotation, translation);
+            }
+
+            parentSceneNode.Children().Append(sceneNode);
         }
         else
         {
             m_sceneNodeMap.Lookup(GetHSTRINGFromStdString(nodeParent->id)).Children().Append(sceneNode);
         }
 
+        float4x4 localMatrix = float4x4::identity();
+
         switch (node.GetTransformationType())
         {
         case TRANSFORMATION_MATRIX:
@@ -56,12 +115,19 @@ namespace SceneLoader
             sceneNode.Transform().Scale(scale);
             sceneNode.Transform().Translation(translation);
             sceneNode.Transform().Orientation(rotation);
+
+            localMatrix = ComposeMatrix(scale, rotation, translation);
             break;
 
         case TRANSFORMATION_TRS:
             sceneNode.Transform().Scale({ node.scale.x, node.scale.y, node.scale.z });
             sceneNode.Transform().Orientation({ node.rotation.x, node.rotation.y, node.rotation.z, node.rotation.w });
             sceneNode.Transform().Translation({ node.translation.x, node.translation.y, node.translation.z });
+
+            localMatrix = ComposeMatrix(
+                { node.scale.x, node.scale.y, node.scale.z },
+                { node.rotation.x, node.rotation.y, node.rotation.z, node.rotation.w },
+                { node.translation.x, node.translation.y, node.translation.z });
             break;
 
         case TRANSFORMATION_IDENTITY:
@@ -69,5 +135,7 @@ namespace SceneLoader
             // Move along. Nothing to see here.
             break;
         }
+
+        BeginNodeBounds(node, nodeParent, localMatrix * ancestorMatrix);
     }
 } // SceneLoader
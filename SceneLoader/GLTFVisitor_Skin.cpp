@@ -1,22 +1,337 @@
-// Licensed to the .NET Foundation under one or more agreements.
-// The .NET Foundation licenses this file to you under the MIT license.
-// See the LICENSE file in the project root for more information.
-
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
 #include "pch.h"
 
 #include "GLTFVisitor.h"
 
+using namespace std;
 using namespace Microsoft::glTF;
 
+namespace winrt {
+    using namespace Windows::Foundation::Numerics;
+}
 using namespace winrt;
 
 namespace SceneLoader
 {
+    // Vertices per parallel_for iteration; small enough to spread a character over all
+    // cores, large enough to keep the scheduling overhead out of the profile.
+    static constexpr size_t c_skinningChunkVertices = 4096;
+
+    struct NodePose
+    {
+        float3 translation;
+        quaternion rotation;
+        float3 scale;
+    };
+
+    static float4x4 LoadMatrix(const float* pValues)
+    {
+        // glTF matrices are column-major for column vectors, which is the memory
+        // layout of a row-vector float4x4.
+        float4x4 matrix;
+        memcpy(&matrix, pValues, sizeof(matrix));
+        return matrix;
+    }
+
+    static SkinningMatrix ToSkinningMatrix(const float4x4& m)
+    {
+        return SkinningMatrix{ {
+            { m.m11, m.m21, m.m31, m.m41 },
+            { m.m12, m.m22, m.m32, m.m42 },
+            { m.m13, m.m23, m.m33, m.m43 },
+        } };
+    }
+
     // Skin
     void GLTFVisitor::operator()(const Skin& /*skin*/, VisitState /*alreadyVisited*/, const VisitDefaultAction&)
     {
+        // Skins are visited after the mesh of their node; see SkinMeshPrimitive.
+    }
+
+    static vector<NodePose> GetRestPoses(const Document& gltfDocument)
+    {
+        vector<NodePose> poses(gltfDocument.nodes.Size());
+
+        for (size_t n = 0; n < poses.size(); ++n)
+        {
+            const Node& node = gltfDocument.nodes[n];
+
+            poses[n].translation = { node.translation.x, node.translation.y, node.translation.z };
+            poses[n].rotation = { node.rotation.x, node.rotation.y, node.rotation.z, node.rotation.w };
+            poses[n].scale = { node.scale.x, node.scale.y, node.scale.z };
+        }
+
+        return poses;
+    }
+
+    // Nodes with a matrix keep it in every pose; animations only target TRS nodes.
+    static vector<float4x4> ComputeWorldMatrices(const Document& gltfDocument, const vector<size_t>& parents, const vector<NodePose>& poses, size_t noParent)
+    {
+        const size_t nodeCount = poses.size();
+
+        vector<float4x4> worldMatrices(nodeCount);
+        vector<bool> isComputed(nodeCount, false);
+        vector<size_t> chain;
+
+        for (size_t n = 0; n < nodeCount; ++n)
+        {
+            // Walk up to the first node that is done, then come back down.
+            chain.clear();
+
+            for (size_t ancestor = n; ancestor != noParent && !isComputed[ancestor]; ancestor = parents[ancestor])
+            {
+                if (chain.size() == nodeCount)
+                {
+                    throw InvalidGLTFException("Node hierarchy contains a cycle");
+                }
+
+                chain.push_back(ancestor);
+            }
+
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            {
+                const size_t index = *it;
+                const Node& node = gltfDocument.nodes[index];
+                const NodePose& pose = poses[index];
+
+                float4x4 local = (node.GetTransformationType() == TRANSFORMATION_MATRIX) ?
+                    LoadMatrix(node.matrix.values.data()) :
+                    make_float4x4_scale(pose.scale) * make_float4x4_from_quaternion(pose.rotation) * make_float4x4_translation(pose.translation);
+
+                worldMatrices[index] = (parents[index] == noParent) ? local : local * worldMatrices[parents[index]];
+                isComputed[index] = true;
+            }
+        }
+
+        return worldMatrices;
+    }
+
+    const vector<float4x4>& GLTFVisitor::EnsureRestWorldMatrices()
+    {
+        if (m_restWorldMatrices.size() != m_gltfDocument.nodes.Size())
+        {
+            m_restWorldMatrices = ComputeWorldMatrices(m_gltfDocument, EnsureNodeParentIndices(), GetRestPoses(m_gltfDocument), c_noParentNode);
+        }
+
+        return m_restWorldMatrices;
+    }
+
+    const vector<float4x4>& GLTFVisitor::EnsurePosedWorldMatrices()
+    {
+        if (!m_loadOptions.skinningPoseTime || m_gltfDocument.animations.Size() == 0)
+        {
+            return EnsureRestWorldMatrices();
+        }
+
+        if (m_posedWorldMatrices.size() == m_gltfDocument.nodes.Size())
+        {
+            return m_posedWorldMatrices;
+        }
+
+        vector<NodePose> poses = GetRestPoses(m_gltfDocument);
+        const Animation& animation = m_gltfDocument.animations[0];
+
+        DecodeArena::Scope scratch(*m_decodeArena);
+
+        for (const auto& channel : animation.channels.Elements())
+        {
+            if (channel.target.path != TARGET_TRANSLATION && channel.target.path != TARGET_ROTATION && channel.target.path != TARGET_SCALE)
+            {
+                continue;
+            }
+
+            NodePose& pose = poses[m_gltfDocument.nodes.GetIndex(channel.target.nodeId)];
+
+            float value[4];
+            EvaluateAnimationCurve(ReadChannelCurve(animation, channel), *m_loadOptions.skinningPoseTime, value);
+
+            switch (channel.target.path)
+            {
+            case TARGET_TRANSLATION: pose.translation = { value[0], value[1], value[2] }; break;
+            case TARGET_ROTATION: pose.rotation = { value[0], value[1], value[2], value[3] }; break;
+            case TARGET_SCALE: pose.scale = { value[0], value[1], value[2] }; break;
+            }
+        }
+
+        m_posedWorldMatrices = ComputeWorldMatrices(m_gltfDocument, EnsureNodeParentIndices(), poses, c_noParentNode);
+
+        return m_posedWorldMatrices;
     }
 
+    const vector<SkinningMatrix>& GLTFVisitor::EnsureJointMatrices(const Skin& skin, const Node& meshNode)
+    {
+        auto key = make_pair(skin.id, meshNode.id);
+        auto existing = m_jointMatrices.find(key);
 
+        if (existing != m_jointMatrices.end())
+        {
+            return existing->second;
+        }
 
-}
\ No newline at end of file
+        const auto& posedWorldMatrices = EnsurePosedWorldMatrices();
+        const size_t jointCount = skin.jointIds.size();
+
+        // The SceneNode of the mesh node places it with its rest transform, whatever the pose,
+        // so take that out again: joint = inverseBind * posedJointWorld * inverse(restMeshWorld).
+        float4x4 meshWorldInverse;
+
+        if (!invert(EnsureRestWorldMatrices()[m_gltfDocument.nodes.GetIndex(meshNode.id)], &meshWorldInverse))
+        {
+            meshWorldInverse = float4x4::identity();
+        }
+
+        DecodeArena::Scope scratch(*m_decodeArena);
+
+        ArenaArray<float> inverseBindMatrices;
+
+        if (!skin.inverseBindMatricesAccessorId.empty())
+        {
+            inverseBindMatrices = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(skin.inverseBindMatricesAccessorId));
+
+            if (inverseBindMatrices.size < jointCount * 16)
+            {
+                throw InvalidGLTFException("Skin " + skin.id + " has fewer inverse bind matrices than joints");
+            }
+        }
+
+        vector<SkinningMatrix> jointMatrices(jointCount);
+
+        for (size_t joint = 0; joint < jointCount; ++joint)
+        {
+            float4x4 inverseBind = inverseBindMatrices.empty() ? float4x4::identity() : LoadMatrix(inverseBindMatrices.data + joint * 16);
+            const float4x4& jointWorld = posedWorldMatrices[m_gltfDocument.nodes.GetIndex(skin.jointIds[joint])];
+
+            jointMatrices[joint] = ToSkinningMatrix(inverseBind * jointWorld * meshWorldInverse);
+        }
+
+        return m_jointMatrices.emplace(key, move(jointMatrices)).first->second;
+    }
+
+    // Composition has no skinning of its own, so skinned primitives are baked into the pose
+    // on the CPU. Tangents are left in the bind pose.
+    bool GLTFVisitor::SkinMeshPrimitive(const MeshPrimitive& meshPrimitive, ArenaArray<float>* pPositions, ArenaArray<float>* pNormals)
+    {
+        string positionAccessorId;
+        string jointsAccessorId;
+        string weightsAccessorId;
+
+        if (!m_currentGltfNode ||
+            m_currentGltfNode->skinId.empty() ||
+            !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_POSITION, positionAccessorId) ||
+            !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_JOINTS_0, jointsAccessorId) ||
+            !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_WEIGHTS_0, weightsAccessorId))
+        {
+            return false;
+        }
+
+        const Skin& skin = m_gltfDocument.skins.Get(m_currentGltfNode->skinId);
+        const auto& jointMatrices = EnsureJointMatrices(skin, *m_currentGltfNode);
+
+        // Already morphed vertices take the place of the primitive's own.
+        auto positions = !pPositions->empty() ? *pPositions : m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(positionAccessorId));
+        auto joints = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(jointsAccessorId));
+        auto weights = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(weightsAccessorId));
+
+        ArenaArray<float> normals = *pNormals;
+        string normalAccessorId;
+
+        if (normals.empty() && meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_NORMAL, normalAccessorId))
+        {
+            normals = m_accessorDecoder->ReadFloats(*m_decodeArena, m_gltfDocument.accessors.Get(normalAccessorId));
+        }
+
+        const size_t vertexCount = positions.size / 3;
+
+        if (joints.size < vertexCount * 4 || weights.size < vertexCount * 4 || (!normals.empty() && normals.size < vertexCount * 3))
+        {
+            throw InvalidGLTFException("Skinned mesh primitive has fewer joints, weights or normals than positions");
+        }
+
+        // Split into one stream per component.
+        SkinningStreams streams;
+        streams.vertexCount = vertexCount;
+
+        for (size_t component = 0; component < 3; ++component)
+        {
+            auto position = m_decodeArena->AllocateArray<float>(vertexCount);
+
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                position[vertex] = positions[vertex * 3 + component];
+            }
+
+            streams.position[component] = position.data;
+
+            if (!normals.empty())
+            {
+                auto normal = m_decodeArena->AllocateArray<float>(vertexCount);
+
+                for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+                {
+                    normal[vertex] = normals[vertex * 3 + component];
+                }
+
+                streams.normal[component] = normal.data;
+            }
+        }
+
+        ArenaArray<uint16_t> jointStreams[4];
+        ArenaArray<float> weightStreams[4];
+
+        for (size_t influence = 0; influence < 4; ++influence)
+        {
+            jointStreams[influence] = m_decodeArena->AllocateArray<uint16_t>(vertexCount);
+            weightStreams[influence] = m_decodeArena->AllocateArray<float>(vertexCount);
+
+            streams.joints[influence] = jointStreams[influence].data;
+            streams.weights[influence] = weightStreams[influence].data;
+        }
+
+        const float jointCount = static_cast<float>(jointMatrices.size());
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            const float* vertexJoints = joints.data + vertex * 4;
+            const float* vertexWeights = weights.data + vertex * 4;
+
+            const float weightSum = vertexWeights[0] + vertexWeights[1] + vertexWeights[2] + vertexWeights[3];
+
+            for (size_t influence = 0; influence < 4; ++influence)
+            {
+                if (!(vertexJoints[influence] >= 0.0f && vertexJoints[influence] < jointCount))
+                {
+                    throw InvalidGLTFException("Skinned mesh primitive references a joint that skin " + skin.id + " doesn't have");
+                }
+
+                jointStreams[influence][vertex] = static_cast<uint16_t>(vertexJoints[influence]);
+
+                // Exporters don't always normalize; a vertex without weights follows its first joint.
+                weightStreams[influence][vertex] = (weightSum > 0.0f) ? vertexWeights[influence] / weightSum : (influence == 0 ? 1.0f : 0.0f);
+            }
+        }
+
+        *pPositions = m_decodeArena->AllocateArray<float>(vertexCount * 3);
+
+        if (!normals.empty())
+        {
+            *pNormals = m_decodeArena->AllocateArray<float>(vertexCount * 3);
+        }
+
+        const size_t chunkCount = (vertexCount + c_skinningChunkVertices - 1) / c_skinningChunkVertices;
+        float* skinnedPositions = pPositions->data;
+        float* skinnedNormals = pNormals->data;
+
+        concurrency::parallel_for(size_t(0), chunkCount, [&](size_t chunk)
+        {
+            const size_t begin = chunk * c_skinningChunkVertices;
+            const size_t end = min(vertexCount, begin + c_skinningChunkVertices);
+
+            SkinVertices(streams, jointMatrices.data(), begin, end, skinnedPositions, skinnedNormals);
+        });
+
+        return true;
+    }
+} // SceneLoader
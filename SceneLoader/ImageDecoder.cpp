@@ -0,0 +1,109 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ImageDecoder.h"
+#include "ImageHeaderProbe.h"
+#include "TexelAnalysis.h"
+
+using namespace std;
+
+namespace winrt {
+    using namespace Windows::Graphics;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    static com_ptr<IWICBitmapFrameDecode> DecodeFirstFrame(IWICImagingFactory* pWIC, const uint8_t* pData, size_t byteLength)
+    {
+        if (byteLength > UINT32_MAX)
+        {
+            throw_hresult(E_BOUNDS);
+        }
+
+        // Create input stream for memory
+        com_ptr<IWICStream> cpStream;
+        check_hresult(pWIC->CreateStream(cpStream.put()));
+        check_hresult(cpStream->InitializeFromMemory(const_cast<BYTE*>(pData), static_cast<UINT>(byteLength)));
+
+        com_ptr<IWICBitmapDecoder> cpDecoder;
+        check_hresult(pWIC->CreateDecoderFromStream(cpStream.get(), nullptr, WICDecodeMetadataCacheOnDemand, cpDecoder.put()));
+
+        com_ptr<IWICBitmapFrameDecode> cpSource;
+        check_hresult(cpDecoder->GetFrame(0, cpSource.put()));
+
+        return cpSource;
+    }
+
+    com_ptr<IWICImagingFactory> CreateImagingFactory()
+    {
+        com_ptr<IWICImagingFactory> cpWIC;
+        check_hresult(CoCreateInstance(
+            CLSID_WICImagingFactory,
+            NULL,
+            CLSCTX_INPROC_SERVER,
+            __uuidof(cpWIC),
+            (LPVOID*)&cpWIC));
+
+        return cpWIC;
+    }
+
+    SizeInt32 GetEncodedImageSize(IWICImagingFactory* pWIC, const uint8_t* pData, size_t byteLength)
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        if (!ProbeImageSize(pData, byteLength, &width, &height))
+        {
+            // WIC reads the header too, it just takes longer to get there.
+            check_hresult(DecodeFirstFrame(pWIC, pData, byteLength)->GetSize(&width, &height));
+        }
+
+        return { static_cast<int32_t>(width), static_cast<int32_t>(height) };
+    }
+
+    ArenaArray<uint8_t> DecodeImagePixels(IWICImagingFactory* pWIC, DecodeArena& arena, const uint8_t* pData, size_t byteLength, bool keepAlpha, uint32_t* pWidth, uint32_t* pHeight, LoadLimiter* pLimiter)
+    {
+        com_ptr<IWICBitmapFrameDecode> cpSource = DecodeFirstFrame(pWIC, pData, byteLength);
+
+        UINT width = 0;
+        UINT height = 0;
+        check_hresult(cpSource->GetSize(&width, &height));
+
+        if (pLimiter)
+        {
+            pLimiter->ChargeImage(width, height);
+        }
+
+        com_ptr<IWICFormatConverter> cpConverter;
+        check_hresult(pWIC->CreateFormatConverter(cpConverter.put()));
+        check_hresult(cpConverter->Initialize(
+            cpSource.get(),
+            keepAlpha ? GUID_WICPixelFormat32bppPBGRA : GUID_WICPixelFormat32bppBGRA,
+            WICBitmapDitherTypeNone,
+            nullptr,
+            0.0f,
+            WICBitmapPaletteTypeMedianCut));
+
+        // Convert into arena memory rather than letting WIC allocate its own copy.
+        ArenaArray<uint8_t> pixels = arena.AllocateArray<uint8_t>(static_cast<size_t>(width) * 4 * height);
+        check_hresult(cpConverter->CopyPixels(
+            nullptr,
+            width * 4,
+            static_cast<UINT>(pixels.size),
+            pixels.data));
+
+        if (!keepAlpha)
+        {
+            MakeTexelsOpaque(pixels.data, static_cast<size_t>(width) * height);
+        }
+
+        *pWidth = width;
+        *pHeight = height;
+
+        return pixels;
+    }
+} // SceneLoader
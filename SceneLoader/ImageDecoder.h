@@ -0,0 +1,34 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+#include "LoadLimits.h"
+#include "wincodec.h"
+
+namespace SceneLoader
+{
+    // The factory is free-threaded; one can serve every decode of a load, or of a batch of them.
+    winrt::com_ptr<IWICImagingFactory> CreateImagingFactory();
+
+    // Size of an encoded image. Read from the header when ProbeImageSize knows the format,
+    // otherwise from the first frame that WIC decodes.
+    winrt::Windows::Graphics::SizeInt32 GetEncodedImageSize(IWICImagingFactory* pWIC, const uint8_t* pData, size_t byteLength);
+
+    // Decodes the first frame of an encoded image with WIC into tightly packed, premultiplied
+    // BGRA pixels allocated from the arena. The calling thread must have entered COM.
+    // Without keepAlpha the color is left as it is and alpha is 255, for images whose alpha
+    // nothing samples. The image is charged to the limiter, if there is one, once its size is
+    // known and before its pixels are allocated.
+    ArenaArray<uint8_t> DecodeImagePixels(
+        IWICImagingFactory* pWIC,
+        DecodeArena& arena,
+        const uint8_t* pData,
+        size_t byteLength,
+        bool keepAlpha,
+        uint32_t* pWidth,
+        uint32_t* pHeight,
+        LoadLimiter* pLimiter);
+} // SceneLoader
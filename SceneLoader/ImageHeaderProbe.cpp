@@ -0,0 +1,221 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ImageHeaderProbe.h"
+
+namespace SceneLoader
+{
+    static uint32_t ReadBigEndian16(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 8) | p[1];
+    }
+
+    static uint32_t ReadBigEndian32(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+    static uint32_t ReadLittleEndian16(const uint8_t* p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8);
+    }
+
+    static uint32_t ReadLittleEndian32(const uint8_t* p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    static bool ProbePng(const uint8_t* pData, size_t byteLength, uint32_t* pWidth, uint32_t* pHeight)
+    {
+        static const uint8_t c_signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+        // The IHDR chunk always comes first.
+        if (byteLength < 24 || memcmp(pData, c_signature, sizeof(c_signature)) != 0 || memcmp(pData + 12, "IHDR", 4) != 0)
+        {
+            return false;
+        }
+
+        *pWidth = ReadBigEndian32(pData + 16);
+        *pHeight = ReadBigEndian32(pData + 20);
+        return true;
+    }
+
+    static bool ProbeJpeg(const uint8_t* pData, size_t byteLength, uint32_t* pWidth, uint32_t* pHeight)
+    {
+        if (byteLength < 4 || pData[0] != 0xFF || pData[1] != 0xD8)
+        {
+            return false;
+        }
+
+        // Walk the marker segments up to the first start-of-frame.
+        size_t position = 2;
+
+        while (position + 4 <= byteLength)
+        {
+            if (pData[position] != 0xFF)
+            {
+                return false;
+            }
+
+            const uint8_t marker = pData[position + 1];
+
+            if (marker == 0xFF)
+            {
+                // Fill byte.
+                ++position;
+                continue;
+            }
+
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+            {
+                // No payload.
+                position += 2;
+                continue;
+            }
+
+            if (marker == 0xD9 || marker == 0xDA)
+            {
+                // End of image or start of scan before any frame header.
+                return false;
+            }
+
+            const size_t segmentLength = ReadBigEndian16(pData + position + 2);
+
+            // SOF0 to SOF15, except DHT (C4), JPG (C8) and DAC (CC).
+            const bool isStartOfFrame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+
+            if (isStartOfFrame)
+            {
+                if (segmentLength < 7 || position + 9 > byteLength)
+                {
+                    return false;
+                }
+
+                *pHeight = ReadBigEndian16(pData + position + 5);
+                *pWidth = ReadBigEndian16(pData + position + 7);
+                return true;
+            }
+
+            if (segmentLength < 2)
+            {
+                return false;
+            }
+
+            position += 2 + segmentLength;
+        }
+
+        return false;
+    }
+
+    static bool ProbeGif(const uint8_t* pData, size_t byteLength, uint32_t* pWidth, uint32_t* pHeight)
+    {
+        if (byteLength < 10 || (memcmp(pData, "GIF87a", 6) != 0 && memcmp(pData, "GIF89a", 6) != 0))
+        {
+            return false;
+        }
+
+        *pWidth = ReadLittleEndian16(pData + 6);
+        *pHeight = ReadLittleEndian16(pData + 8);
+        return true;
+    }
+
+    static bool ProbeBmp(const uint8_t* pData, size_t byteLength, uint32_t* pWidth, uint32_t* pHeight)
+    {
+        if (byteLength < 26 || pData[0] != 'B' || pData[1] != 'M')
+        {
+            return false;
+        }
+
+        const uint32_t infoHeaderSize = ReadLittleEndian32(pData + 14);
+
+        if (infoHeaderSize == 12)
+        {
+            // BITMAPCOREHEADER
+            *pWidth = ReadLittleEndian16(pData + 18);
+            *pHeight = ReadLittleEndian16(pData + 20);
+            return true;
+        }
+
+        if (infoHeaderSize < 40)
+        {
+            return false;
+        }
+
+        // Negative heights are top-down bitmaps.
+        const int32_t width = static_cast<int32_t>(ReadLittleEndian32(pData + 18));
+        const int32_t height = static_cast<int32_t>(ReadLittleEndian32(pData + 22));
+
+        if (width <= 0 || height == INT32_MIN)
+        {
+            return false;
+        }
+
+        *pWidth = static_cast<uint32_t>(width);
+        *pHeight = static_cast<uint32_t>(height < 0 ? -height : height);
+        return true;
+    }
+
+    bool ProbeImageSize(const uint8_t* pData, size_t byteLength, uint32_t* pWidth, uint32_t* pHeight)
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        if (!ProbePng(pData, byteLength, &width, &height) &&
+            !ProbeJpeg(pData, byteLength, &width, &height) &&
+            !ProbeGif(pData, byteLength, &width, &height) &&
+            !ProbeBmp(pData, byteLength, &width, &height))
+        {
+            return false;
+        }
+
+        if (width == 0 || height == 0 || width > INT32_MAX || height > INT32_MAX)
+        {
+            return false;
+        }
+
+        *pWidth = width;
+        *pHeight = height;
+        return true;
+    }
+
+    const char* ProbeImageMimeType(const uint8_t* pData, size_t byteLength)
+    {
+        static const uint8_t c_pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        static const uint8_t c_ktx2Signature[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        if (byteLength >= sizeof(c_pngSignature) && memcmp(pData, c_pngSignature, sizeof(c_pngSignature)) == 0)
+        {
+            return "image/png";
+        }
+
+        if (byteLength >= 3 && pData[0] == 0xFF && pData[1] == 0xD8 && pData[2] == 0xFF)
+        {
+            return "image/jpeg";
+        }
+
+        if (byteLength >= 6 && (memcmp(pData, "GIF87a", 6) == 0 || memcmp(pData, "GIF89a", 6) == 0))
+        {
+            return "image/gif";
+        }
+
+        if (byteLength >= 2 && pData[0] == 'B' && pData[1] == 'M')
+        {
+            return "image/bmp";
+        }
+
+        if (byteLength >= 12 && memcmp(pData, "RIFF", 4) == 0 && memcmp(pData + 8, "WEBP", 4) == 0)
+        {
+            return "image/webp";
+        }
+
+        if (byteLength >= sizeof(c_ktx2Signature) && memcmp(pData, c_ktx2Signature, sizeof(c_ktx2Signature)) == 0)
+        {
+            return "image/ktx2";
+        }
+
+        return nullptr;
+    }
+} // SceneLoader
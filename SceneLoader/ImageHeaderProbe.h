@@ -0,0 +1,16 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Reads the pixel size of a PNG, JPEG, GIF or BMP image from its header, without
+    // decoding anything. Returns false for other formats and truncated or corrupt headers.
+    bool ProbeImageSize(const uint8_t* pData, size_t byteLength, uint32_t* pWidth, uint32_t* pHeight);
+
+    // The mime type of an image from its signature: PNG, JPEG, GIF and BMP, which the loader
+    // decodes, and WebP and KTX2, which glTF extensions use. nullptr for anything else.
+    const char* ProbeImageMimeType(const uint8_t* pData, size_t byteLength);
+} // SceneLoader
@@ -0,0 +1,210 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "InstanceTransforms.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    // Loads four packed xyz triplets as one Vec4 per component. The last triplet is read
+    // on its own so that nothing past it is touched.
+    static inline void LoadTriplets(const float* p, Vec4* pX, Vec4* pY, Vec4* pZ)
+    {
+        Vec4 a = Vec4::Load(p);
+        Vec4 b = Vec4::Load(p + 3);
+        Vec4 c = Vec4::Load(p + 6);
+        Vec4 d = Vec4::Set(p[9], p[10], p[11], 0.0f);
+
+        Transpose(a, b, c, d);
+
+        *pX = a;
+        *pY = b;
+        *pZ = c;
+    }
+
+    // Four instances, one per lane: T * R * S, and R * S^-1 for the normals.
+    static void ComputeFourInstanceMatrices(
+        const float* translations,
+        const float* rotations,
+        const float* scales,
+        size_t count,
+        InstanceMatrix* pMatrices)
+    {
+        Vec4 tx, ty, tz;
+        Vec4 sx, sy, sz;
+
+        LoadTriplets(translations, &tx, &ty, &tz);
+        LoadTriplets(scales, &sx, &sy, &sz);
+
+        Vec4 qx = Vec4::Load(rotations);
+        Vec4 qy = Vec4::Load(rotations + 4);
+        Vec4 qz = Vec4::Load(rotations + 8);
+        Vec4 qw = Vec4::Load(rotations + 12);
+
+        Transpose(qx, qy, qz, qw);
+
+        const Vec4 one = Vec4::Splat(1.0f);
+        const Vec4 x2 = qx + qx;
+        const Vec4 y2 = qy + qy;
+        const Vec4 z2 = qz + qz;
+
+        const Vec4 xx = qx * x2;
+        const Vec4 yy = qy * y2;
+        const Vec4 zz = qz * z2;
+        const Vec4 xy = qx * y2;
+        const Vec4 xz = qx * z2;
+        const Vec4 yz = qy * z2;
+        const Vec4 wx = qw * x2;
+        const Vec4 wy = qw * y2;
+        const Vec4 wz = qw * z2;
+
+        const Vec4 rotation[3][3] =
+        {
+            { one - (yy + zz), xy - wz, xz + wy },
+            { xy + wz, one - (xx + zz), yz - wx },
+            { xz - wy, yz + wx, one - (xx + yy) },
+        };
+
+        // s / max(s^2, FLT_MIN) is 1 / s, except that a zero scale gives zero instead of infinity.
+        const Vec4 smallest = Vec4::Splat(FLT_MIN);
+        const Vec4 inverseScale[3] =
+        {
+            sx / Max(sx * sx, smallest),
+            sy / Max(sy * sy, smallest),
+            sz / Max(sz * sz, smallest),
+        };
+
+        const Vec4 translation[3] = { tx, ty, tz };
+        const Vec4 zero = Vec4::Zero();
+
+        for (size_t row = 0; row < 3; ++row)
+        {
+            Vec4 a = rotation[row][0] * sx;
+            Vec4 b = rotation[row][1] * sy;
+            Vec4 c = rotation[row][2] * sz;
+            Vec4 d = translation[row];
+
+            Transpose(a, b, c, d);
+
+            const Vec4 rows[4] = { a, b, c, d };
+
+            Vec4 na = rotation[row][0] * inverseScale[0];
+            Vec4 nb = rotation[row][1] * inverseScale[1];
+            Vec4 nc = rotation[row][2] * inverseScale[2];
+            Vec4 nd = zero;
+
+            Transpose(na, nb, nc, nd);
+
+            const Vec4 normalRows[4] = { na, nb, nc, nd };
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                rows[i].Store(pMatrices[i].rows[row]);
+                normalRows[i].Store(pMatrices[i].normalRows[row]);
+            }
+        }
+    }
+
+    void ComputeInstanceMatrices(const MeshInstances& instances, size_t begin, size_t end, InstanceMatrix* pMatrices)
+    {
+        size_t i = begin;
+
+        for (; i + 4 <= end; i += 4)
+        {
+            ComputeFourInstanceMatrices(
+                &instances.translations[i * 3],
+                &instances.rotations[i * 4],
+                &instances.scales[i * 3],
+                4,
+                pMatrices + (i - begin));
+        }
+
+        if (i < end)
+        {
+            // The last few go through padded copies, with identity transforms in the unused lanes.
+            float translations[12] = {};
+            float rotations[16] = { 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+            float scales[12] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+            const size_t count = end - i;
+
+            memcpy(translations, &instances.translations[i * 3], count * 3 * sizeof(float));
+            memcpy(rotations, &instances.rotations[i * 4], count * 4 * sizeof(float));
+            memcpy(scales, &instances.scales[i * 3], count * 3 * sizeof(float));
+
+            ComputeFourInstanceMatrices(translations, rotations, scales, count, pMatrices + (i - begin));
+        }
+    }
+
+    // The columns of a matrix stored by rows, with the fourth row zero.
+    static inline void LoadColumns(const float rows[3][4], Vec4* pColumns)
+    {
+        pColumns[0] = Vec4::Load(rows[0]);
+        pColumns[1] = Vec4::Load(rows[1]);
+        pColumns[2] = Vec4::Load(rows[2]);
+        pColumns[3] = Vec4::Zero();
+
+        Transpose(pColumns[0], pColumns[1], pColumns[2], pColumns[3]);
+    }
+
+    static inline Vec4 TransformDirection(const Vec4* columns, const float* direction)
+    {
+        return MultiplyAdd(columns[0], Vec4::Splat(direction[0]), MultiplyAdd(columns[1], Vec4::Splat(direction[1]), columns[2] * Vec4::Splat(direction[2])));
+    }
+
+    static inline Vec4 Normalize(Vec4 direction, Vec4 fallback)
+    {
+        const float lengthSquared = Dot(direction, direction);
+
+        return (lengthSquared > 0.0f) ? direction * Vec4::Splat(1.0f / sqrtf(lengthSquared)) : fallback;
+    }
+
+    void TransformInstancePositions(const InstanceMatrix& matrix, const float* positions, size_t vertexCount, float* pPositions)
+    {
+        Vec4 columns[4];
+        LoadColumns(matrix.rows, columns);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            float position[4];
+            (TransformDirection(columns, positions + vertex * 3) + columns[3]).Store(position);
+            memcpy(pPositions + vertex * 3, position, 3 * sizeof(float));
+        }
+    }
+
+    void TransformInstanceNormals(const InstanceMatrix& matrix, const float* normals, size_t vertexCount, float* pNormals)
+    {
+        Vec4 columns[4];
+        LoadColumns(matrix.normalRows, columns);
+
+        const Vec4 fallback = Vec4::Set(0.0f, 0.0f, 1.0f, 0.0f);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            float normal[4];
+            Normalize(TransformDirection(columns, normals + vertex * 3), fallback).Store(normal);
+            memcpy(pNormals + vertex * 3, normal, 3 * sizeof(float));
+        }
+    }
+
+    void TransformInstanceTangents(const InstanceMatrix& matrix, const float* tangents, size_t vertexCount, float* pTangents)
+    {
+        Vec4 columns[4];
+        LoadColumns(matrix.rows, columns);
+
+        const Vec4 fallback = Vec4::Set(1.0f, 0.0f, 0.0f, 0.0f);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            float tangent[4];
+            Normalize(TransformDirection(columns, tangents + vertex * 4), fallback).Store(tangent);
+            tangent[3] = tangents[vertex * 4 + 3];
+            memcpy(pTangents + vertex * 4, tangent, 4 * sizeof(float));
+        }
+    }
+} // SceneLoader
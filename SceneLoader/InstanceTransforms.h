@@ -0,0 +1,37 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Translations and scales packed xyz, rotations as unit quaternions xyzw. Attributes the
+    // extension leaves out are filled with the identity.
+    struct MeshInstances
+    {
+        size_t count = 0;
+        std::vector<float> translations;
+        std::vector<float> rotations;
+        std::vector<float> scales;
+    };
+
+    // The transform of an instance, stored by output component like SkinningMatrix, so that
+    // x' = rows[0] . (x, y, z, 1). Normals go through normalRows, the rotation divided by the
+    // scale, and need renormalizing; a zero scale maps them to zero.
+    struct InstanceMatrix
+    {
+        float rows[3][4];
+        float normalRows[3][4];
+    };
+
+    // Converts the transforms of instances [begin, end), four at a time.
+    void ComputeInstanceMatrices(const MeshInstances& instances, size_t begin, size_t end, InstanceMatrix* pMatrices);
+
+    // Copies of packed vertex streams moved by one instance, for merging instances into one mesh.
+    // Normals and tangents are renormalized, falling back to +Z and +X when they vanish; tangents
+    // keep their handedness in w.
+    void TransformInstancePositions(const InstanceMatrix& matrix, const float* positions, size_t vertexCount, float* pPositions);
+    void TransformInstanceNormals(const InstanceMatrix& matrix, const float* normals, size_t vertexCount, float* pNormals);
+    void TransformInstanceTangents(const InstanceMatrix& matrix, const float* tangents, size_t vertexCount, float* pTangents);
+} // SceneLoader
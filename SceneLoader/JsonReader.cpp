@@ -0,0 +1,518 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "JsonReader.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static int HexDigitValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static void AppendUtf8(string& text, uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            text.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            text.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+            text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            text.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+            text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            text.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+            text.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+            text.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+
+    JsonReader::JsonReader(const char* text, size_t length) :
+        m_begin(text),
+        m_position(text),
+        m_end(text + length)
+    {
+        // A UTF-8 byte order mark is tolerated, as rapidjson does.
+        if (length >= 3 && memcmp(text, "\xEF\xBB\xBF", 3) == 0)
+        {
+            m_position += 3;
+        }
+    }
+
+    void JsonReader::Fail(const char* message) const
+    {
+        throw InvalidGLTFException("Invalid JSON at byte " + to_string(m_position - m_begin) + ": " + message);
+    }
+
+    void JsonReader::SkipWhitespace()
+    {
+        while (m_position < m_end && (*m_position == ' ' || *m_position == '\n' || *m_position == '\r' || *m_position == '\t'))
+        {
+            ++m_position;
+        }
+    }
+
+    void JsonReader::Expect(char c)
+    {
+        if (m_position >= m_end || *m_position != c)
+        {
+            Fail(m_position >= m_end ? "Unexpected end of input" : "Unexpected character");
+        }
+
+        ++m_position;
+    }
+
+    JsonValueType JsonReader::PeekType()
+    {
+        SkipWhitespace();
+
+        if (m_position >= m_end)
+        {
+            Fail("Unexpected end of input");
+        }
+
+        switch (*m_position)
+        {
+        case '{': return JsonValueType::Object;
+        case '[': return JsonValueType::Array;
+        case '"': return JsonValueType::String;
+        case 't':
+        case 'f': return JsonValueType::Boolean;
+        case 'n': return JsonValueType::Null;
+        default:
+            if (*m_position == '-' || IsDigit(*m_position))
+            {
+                return JsonValueType::Number;
+            }
+
+            Fail("Unexpected character");
+        }
+    }
+
+    void JsonReader::BeginObject()
+    {
+        SkipWhitespace();
+        Expect('{');
+        m_isFirst.push_back(true);
+    }
+
+    bool JsonReader::NextMember(string_view* pKey)
+    {
+        SkipWhitespace();
+
+        if (m_position < m_end && *m_position == '}')
+        {
+            ++m_position;
+            m_isFirst.pop_back();
+            return false;
+        }
+
+        if (!m_isFirst.back())
+        {
+            Expect(',');
+        }
+
+        m_isFirst.back() = false;
+
+        *pKey = ReadStringView();
+
+        SkipWhitespace();
+        Expect(':');
+
+        return true;
+    }
+
+    void JsonReader::BeginArray()
+    {
+        SkipWhitespace();
+        Expect('[');
+        m_isFirst.push_back(true);
+    }
+
+    bool JsonReader::NextElement()
+    {
+        SkipWhitespace();
+
+        if (m_position < m_end && *m_position == ']')
+        {
+            ++m_position;
+            m_isFirst.pop_back();
+            return false;
+        }
+
+        if (!m_isFirst.back())
+        {
+            Expect(',');
+        }
+
+        m_isFirst.back() = false;
+
+        return true;
+    }
+
+    string_view JsonReader::ReadStringView()
+    {
+        SkipWhitespace();
+        Expect('"');
+
+        const char* start = m_position;
+
+        // Most strings in a glTF document are short and have no escapes.
+        while (m_position < m_end && *m_position != '"' && *m_position != '\\')
+        {
+            if (static_cast<unsigned char>(*m_position) < 0x20)
+            {
+                Fail("Control character in string");
+            }
+
+            ++m_position;
+        }
+
+        if (m_position < m_end && *m_position == '"')
+        {
+            return string_view(start, m_position++ - start);
+        }
+
+        m_scratch.assign(start, m_position);
+
+        while (true)
+        {
+            if (m_position >= m_end)
+            {
+                Fail("Unterminated string");
+            }
+
+            const char c = *m_position++;
+
+            if (c == '"')
+            {
+                break;
+            }
+
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                --m_position;
+                Fail("Control character in string");
+            }
+
+            if (c != '\\')
+            {
+                m_scratch.push_back(c);
+                continue;
+            }
+
+            if (m_position >= m_end)
+            {
+                Fail("Unterminated string");
+            }
+
+            switch (*m_position++)
+            {
+            case '"': m_scratch.push_back('"'); break;
+            case '\\': m_scratch.push_back('\\'); break;
+            case '/': m_scratch.push_back('/'); break;
+            case 'b': m_scratch.push_back('\b'); break;
+            case 'f': m_scratch.push_back('\f'); break;
+            case 'n': m_scratch.push_back('\n'); break;
+            case 'r': m_scratch.push_back('\r'); break;
+            case 't': m_scratch.push_back('\t'); break;
+            case 'u':
+            {
+                auto readCodeUnit = [this]()
+                {
+                    if (m_end - m_position < 4)
+                    {
+                        Fail("Truncated \\u escape");
+                    }
+
+                    uint32_t value = 0;
+
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const int digit = HexDigitValue(*m_position++);
+
+                        if (digit < 0)
+                        {
+                            Fail("Invalid \\u escape");
+                        }
+
+                        value = (value << 4) | static_cast<uint32_t>(digit);
+                    }
+
+                    return value;
+                };
+
+                uint32_t codePoint = readCodeUnit();
+
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+                {
+                    if (m_end - m_position < 2 || m_position[0] != '\\' || m_position[1] != 'u')
+                    {
+                        Fail("Unpaired surrogate in \\u escape");
+                    }
+
+                    m_position += 2;
+
+                    const uint32_t low = readCodeUnit();
+
+                    if (low < 0xDC00 || low > 0xDFFF)
+                    {
+                        Fail("Unpaired surrogate in \\u escape");
+                    }
+
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF)
+                {
+                    Fail("Unpaired surrogate in \\u escape");
+                }
+
+                AppendUtf8(m_scratch, codePoint);
+                break;
+            }
+            default:
+                --m_position;
+                Fail("Invalid escape sequence");
+            }
+        }
+
+        return m_scratch;
+    }
+
+    string JsonReader::ReadString()
+    {
+        return string(ReadStringView());
+    }
+
+    double JsonReader::ReadNumber()
+    {
+        SkipWhitespace();
+
+        // Check the JSON number grammar first; from_chars also accepts forms JSON doesn't, like "01" or "1.".
+        const char* start = m_position;
+        const char* p = m_position;
+
+        if (p < m_end && *p == '-') ++p;
+
+        if (p < m_end && *p == '0')
+        {
+            ++p;
+        }
+        else if (p < m_end && IsDigit(*p))
+        {
+            while (p < m_end && IsDigit(*p)) ++p;
+        }
+        else
+        {
+            Fail("Expected a number");
+        }
+
+        if (p < m_end && *p == '.')
+        {
+            ++p;
+
+            if (p >= m_end || !IsDigit(*p))
+            {
+                m_position = p;
+                Fail("Expected a digit after the decimal point");
+            }
+
+            while (p < m_end && IsDigit(*p)) ++p;
+        }
+
+        if (p < m_end && (*p == 'e' || *p == 'E'))
+        {
+            ++p;
+
+            if (p < m_end && (*p == '+' || *p == '-')) ++p;
+
+            if (p >= m_end || !IsDigit(*p))
+            {
+                m_position = p;
+                Fail("Expected a digit in the exponent");
+            }
+
+            while (p < m_end && IsDigit(*p)) ++p;
+        }
+
+        double value = 0.0;
+        auto result = from_chars(start, p, value);
+
+        // Out of range values are what strtod would make of them, like rapidjson does.
+        if (result.ec == errc::result_out_of_range)
+        {
+            value = strtod(string(start, p).c_str(), nullptr);
+        }
+        else if (result.ec != errc() || result.ptr != p)
+        {
+            Fail("Expected a number");
+        }
+
+        m_position = p;
+
+        return value;
+    }
+
+    float JsonReader::ReadFloat()
+    {
+        return static_cast<float>(ReadNumber());
+    }
+
+    size_t JsonReader::ReadIndex()
+    {
+        SkipWhitespace();
+
+        if (m_position >= m_end || !IsDigit(*m_position))
+        {
+            Fail("Expected a non-negative integer");
+        }
+
+        size_t value = 0;
+
+        while (m_position < m_end && IsDigit(*m_position))
+        {
+            const size_t digit = static_cast<size_t>(*m_position - '0');
+
+            if (value > (SIZE_MAX - digit) / 10)
+            {
+                Fail("Integer is too large");
+            }
+
+            value = value * 10 + digit;
+            ++m_position;
+        }
+
+        if (m_position < m_end && (*m_position == '.' || *m_position == 'e' || *m_position == 'E'))
+        {
+            Fail("Expected a non-negative integer");
+        }
+
+        return value;
+    }
+
+    bool JsonReader::ReadBoolean()
+    {
+        SkipWhitespace();
+
+        if (m_end - m_position >= 4 && memcmp(m_position, "true", 4) == 0)
+        {
+            m_position += 4;
+            return true;
+        }
+
+        if (m_end - m_position >= 5 && memcmp(m_position, "false", 5) == 0)
+        {
+            m_position += 5;
+            return false;
+        }
+
+        Fail("Expected true or false");
+    }
+
+    string_view JsonReader::SkipValue()
+    {
+        const JsonValueType type = PeekType();
+        const char* start = m_position;
+
+        switch (type)
+        {
+        case JsonValueType::Null:
+            if (m_end - m_position < 4 || memcmp(m_position, "null", 4) != 0)
+            {
+                Fail("Expected null");
+            }
+
+            m_position += 4;
+            break;
+
+        case JsonValueType::Boolean:
+            ReadBoolean();
+            break;
+
+        case JsonValueType::Number:
+            ReadNumber();
+            break;
+
+        case JsonValueType::String:
+            ReadStringView();
+            break;
+
+        case JsonValueType::Object:
+        case JsonValueType::Array:
+        {
+            // Only nesting and strings are tracked; the contents are checked by whoever
+            // parses the text later. No recursion, so deep nesting can't overflow the stack.
+            string closers;
+
+            do
+            {
+                if (m_position >= m_end)
+                {
+                    Fail("Unexpected end of input");
+                }
+
+                const char c = *m_position;
+
+                if (c == '"')
+                {
+                    ReadStringView();
+                    continue;
+                }
+
+                if (c == '{' || c == '[')
+                {
+                    closers.push_back(c == '{' ? '}' : ']');
+                }
+                else if (c == '}' || c == ']')
+                {
+                    if (closers.back() != c)
+                    {
+                        Fail("Mismatched bracket");
+                    }
+
+                    closers.pop_back();
+                }
+
+                ++m_position;
+            } while (!closers.empty());
+
+            break;
+        }
+        }
+
+        return string_view(start, m_position - start);
+    }
+
+    void JsonReader::ExpectEnd()
+    {
+        SkipWhitespace();
+
+        if (m_position != m_end)
+        {
+            Fail("Unexpected text after the document");
+        }
+    }
+} // SceneLoader
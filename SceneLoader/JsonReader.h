@@ -0,0 +1,79 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    enum class JsonValueType
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Object,
+        Array,
+    };
+
+    // Reads JSON text front to back, one value at a time, without building a tree. The
+    // caller walks the structure it expects:
+    //
+    //     reader.BeginObject();
+    //     while (reader.NextMember(&key)) { ... read or skip the value ... }
+    //
+    // Every value has to be read or skipped before the next member or element. Malformed
+    // text throws InvalidGLTFException with the byte offset of the problem.
+    class JsonReader
+    {
+    public:
+        JsonReader(const char* text, size_t length);
+
+        JsonValueType PeekType();
+
+        void BeginObject();
+
+        // Moves to the next member and returns its key, which stays valid until the
+        // next call. Returns false at the end of the object.
+        bool NextMember(std::string_view* pKey);
+
+        void BeginArray();
+
+        // Returns false at the end of the array.
+        bool NextElement();
+
+        std::string ReadString();
+        double ReadNumber();
+        float ReadFloat();
+
+        // A non-negative integer, as used for indices, counts and byte offsets.
+        size_t ReadIndex();
+
+        bool ReadBoolean();
+
+        // Skips the next value and returns its text, unparsed.
+        std::string_view SkipValue();
+
+        // Throws if there is anything but whitespace after the top-level value.
+        void ExpectEnd();
+
+        [[noreturn]] void Fail(const char* message) const;
+
+    private:
+        void SkipWhitespace();
+        void Expect(char c);
+
+        // Reads a string into m_scratch unless it has no escapes, in which case the
+        // returned view points into the text itself.
+        std::string_view ReadStringView();
+
+        const char* m_begin;
+        const char* m_position;
+        const char* m_end;
+
+        // One entry per open object or array; true until its first member or element.
+        std::vector<bool> m_isFirst;
+
+        std::string m_scratch;
+    };
+} // SceneLoader
@@ -0,0 +1,252 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "LoadLimits.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    const char* GetLoadLimitName(LoadLimit limit)
+    {
+        switch (limit)
+        {
+        case LoadLimit::DecodedBytes: return "MaxDecodedBytes";
+        case LoadLimit::ImagePixels: return "MaxImagePixels";
+        case LoadLimit::PrimitiveVertices: return "MaxPrimitiveVertices";
+        case LoadLimit::NodeCount: return "MaxNodeCount";
+        case LoadLimit::HierarchyDepth: return "MaxHierarchyDepth";
+        case LoadLimit::LoadTime: return "MaxLoadTime";
+        }
+
+        return "Unknown";
+    }
+
+    LoadLimitException::LoadLimitException(LoadLimit limit, uint64_t value, uint64_t maximum) :
+        GLTFException(string(GetLoadLimitName(limit)) + " exceeded: " + to_string(value) + " is more than " + to_string(maximum)),
+        m_limit(limit),
+        m_value(value),
+        m_maximum(maximum)
+    {
+    }
+
+    DocumentLimitChecker::DocumentLimitChecker(const LoadLimits& limits) :
+        m_limits(limits)
+    {
+    }
+
+    bool DocumentLimitChecker::ChecksHierarchy() const
+    {
+        return m_limits.maxNodeCount > 0 || m_limits.maxHierarchyDepth > 0;
+    }
+
+    void DocumentLimitChecker::AddNode()
+    {
+        if (!ChecksHierarchy())
+        {
+            return;
+        }
+
+        if (m_limits.maxNodeCount > 0 && m_childFirst.size() >= m_limits.maxNodeCount)
+        {
+            throw LoadLimitException(LoadLimit::NodeCount, m_childFirst.size() + 1, m_limits.maxNodeCount);
+        }
+
+        m_childFirst.push_back(m_children.size());
+    }
+
+    void DocumentLimitChecker::AddChild(size_t childIndex)
+    {
+        if (ChecksHierarchy())
+        {
+            m_children.push_back(childIndex);
+        }
+    }
+
+    void DocumentLimitChecker::CheckHierarchy()
+    {
+        if (!ChecksHierarchy())
+        {
+            return;
+        }
+
+        const size_t nodeCount = m_childFirst.size();
+
+        auto childEnd = [&](size_t node)
+        {
+            return (node + 1 < nodeCount) ? m_childFirst[node + 1] : m_children.size();
+        };
+
+        // Per node, once all of its children are done: the nodes on the longest path down
+        // from it and the nodes under it, itself included. Zero until then.
+        vector<uint64_t> depths(nodeCount, 0);
+        vector<uint64_t> counts(nodeCount, 0);
+
+        // Depth first, without recursion, so deep hierarchies can't overflow the stack.
+        vector<pair<size_t, size_t>> path; // node, next child
+        vector<bool> isOnPath(nodeCount, false);
+
+        for (size_t root = 0; root < nodeCount; ++root)
+        {
+            if (depths[root] > 0)
+            {
+                continue;
+            }
+
+            path.emplace_back(root, m_childFirst[root]);
+            isOnPath[root] = true;
+
+            while (!path.empty())
+            {
+                const size_t node = path.back().first;
+
+                if (path.back().second < childEnd(node))
+                {
+                    const size_t child = m_children[path.back().second++];
+
+                    if (child >= nodeCount)
+                    {
+                        throw InvalidGLTFException("Node " + to_string(node) + " has child " + to_string(child) + ", which isn't a node");
+                    }
+
+                    if (isOnPath[child])
+                    {
+                        throw InvalidGLTFException("Node " + to_string(child) + " is its own descendant");
+                    }
+
+                    if (depths[child] == 0)
+                    {
+                        if (m_limits.maxHierarchyDepth > 0 && path.size() >= m_limits.maxHierarchyDepth)
+                        {
+                            throw LoadLimitException(LoadLimit::HierarchyDepth, path.size() + 1, m_limits.maxHierarchyDepth);
+                        }
+
+                        path.emplace_back(child, m_childFirst[child]);
+                        isOnPath[child] = true;
+                    }
+
+                    continue;
+                }
+
+                uint64_t depth = 0;
+                uint64_t count = 1;
+
+                for (size_t i = m_childFirst[node]; i < childEnd(node); ++i)
+                {
+                    const size_t child = m_children[i];
+
+                    depth = max(depth, depths[child]);
+                    count = (counts[child] > UINT64_MAX - count) ? UINT64_MAX : count + counts[child];
+                }
+
+                ++depth;
+
+                if (m_limits.maxHierarchyDepth > 0 && depth > m_limits.maxHierarchyDepth)
+                {
+                    throw LoadLimitException(LoadLimit::HierarchyDepth, depth, m_limits.maxHierarchyDepth);
+                }
+
+                if (m_limits.maxNodeCount > 0 && count > m_limits.maxNodeCount)
+                {
+                    throw LoadLimitException(LoadLimit::NodeCount, count, m_limits.maxNodeCount);
+                }
+
+                depths[node] = depth;
+                counts[node] = count;
+                isOnPath[node] = false;
+                path.pop_back();
+            }
+        }
+    }
+
+    void DocumentLimitChecker::AddAccessor(uint64_t count)
+    {
+        if (m_limits.maxPrimitiveVertices == 0)
+        {
+            return;
+        }
+
+        if (m_pendingVertexAccessors.erase(m_accessorCounts.size()) > 0)
+        {
+            CheckVertexCount(count);
+        }
+
+        m_accessorCounts.push_back(count);
+    }
+
+    void DocumentLimitChecker::AddVertexAccessor(size_t accessorIndex)
+    {
+        if (m_limits.maxPrimitiveVertices == 0)
+        {
+            return;
+        }
+
+        if (accessorIndex < m_accessorCounts.size())
+        {
+            CheckVertexCount(m_accessorCounts[accessorIndex]);
+        }
+        else
+        {
+            m_pendingVertexAccessors.insert(accessorIndex);
+        }
+    }
+
+    void DocumentLimitChecker::CheckVertexCount(uint64_t count) const
+    {
+        if (count > m_limits.maxPrimitiveVertices)
+        {
+            throw LoadLimitException(LoadLimit::PrimitiveVertices, count, m_limits.maxPrimitiveVertices);
+        }
+    }
+
+    LoadLimiter::LoadLimiter(const LoadLimits& limits) :
+        m_limits(limits),
+        m_start(chrono::steady_clock::now())
+    {
+    }
+
+    void LoadLimiter::ChargeDecodedBytes(uint64_t elementCount, size_t elementSize)
+    {
+        // Counts from the document can be anything; past 64 bits they are over any limit.
+        const uint64_t byteLength = (elementSize > 0 && elementCount > UINT64_MAX / elementSize) ? UINT64_MAX : elementCount * elementSize;
+        const uint64_t decodedBytes = m_decodedBytes.fetch_add(byteLength) + byteLength;
+
+        if (m_limits.maxDecodedBytes > 0 && (decodedBytes > m_limits.maxDecodedBytes || decodedBytes < byteLength))
+        {
+            throw LoadLimitException(LoadLimit::DecodedBytes, max(decodedBytes, byteLength), m_limits.maxDecodedBytes);
+        }
+
+        CheckTime();
+    }
+
+    void LoadLimiter::ChargeImage(uint32_t width, uint32_t height)
+    {
+        const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+
+        if (m_limits.maxImagePixels > 0 && pixelCount > m_limits.maxImagePixels)
+        {
+            throw LoadLimitException(LoadLimit::ImagePixels, pixelCount, m_limits.maxImagePixels);
+        }
+
+        ChargeDecodedBytes(pixelCount, 4);
+    }
+
+    void LoadLimiter::CheckTime() const
+    {
+        if (m_limits.maxLoadTime.count() <= 0)
+        {
+            return;
+        }
+
+        const auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - m_start);
+
+        if (elapsed > m_limits.maxLoadTime)
+        {
+            throw LoadLimitException(LoadLimit::LoadTime, elapsed.count(), m_limits.maxLoadTime.count());
+        }
+    }
+} // SceneLoader
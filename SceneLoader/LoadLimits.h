@@ -0,0 +1,131 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Caps on what a load of an untrusted file may take. Zero is no limit.
+    struct LoadLimits
+    {
+        // Bytes of every accessor, index list, buffer and image the load decodes, intermediate
+        // copies included, and of a GLB that arrives in pieces, see ChunkedInput.
+        uint64_t maxDecodedBytes = 0;
+
+        // Width times height of any one image.
+        uint64_t maxImagePixels = 0;
+
+        // Elements of any one vertex attribute or morph target accessor of a mesh.
+        uint64_t maxPrimitiveVertices = 0;
+
+        // Nodes of the document, and nodes under any one node or scene counting every path
+        // to them.
+        uint64_t maxNodeCount = 0;
+
+        // Nodes on the longest path from a node down, the node included.
+        uint32_t maxHierarchyDepth = 0;
+
+        // From the start of the load. Checked between steps, so a single image or primitive
+        // can overrun it.
+        std::chrono::milliseconds maxLoadTime{ 0 };
+
+        bool IsLimited() const
+        {
+            return maxDecodedBytes || maxImagePixels || maxPrimitiveVertices || maxNodeCount || maxHierarchyDepth || maxLoadTime.count();
+        }
+    };
+
+    enum class LoadLimit
+    {
+        DecodedBytes,
+        ImagePixels,
+        PrimitiveVertices,
+        NodeCount,
+        HierarchyDepth,
+        LoadTime,
+    };
+
+    // The name of the SceneLoadOptions property that sets the limit, such as "MaxNodeCount".
+    const char* GetLoadLimitName(LoadLimit limit);
+
+    // Thrown before the allocation or the work that would go over a limit.
+    class LoadLimitException : public Microsoft::glTF::GLTFException
+    {
+    public:
+        LoadLimitException(LoadLimit limit, uint64_t value, uint64_t maximum);
+
+        LoadLimit Limit() const { return m_limit; }
+
+        // What the load would have reached, and the limit. Milliseconds for LoadTime.
+        uint64_t Value() const { return m_value; }
+        uint64_t Maximum() const { return m_maximum; }
+
+    private:
+        LoadLimit m_limit;
+        uint64_t m_value;
+        uint64_t m_maximum;
+    };
+
+    // Checks the node count, hierarchy depth and vertex counts of a document while it is read,
+    // by index, so that a document over the limits fails before the rest of it is read; see
+    // DeserializeStreaming. Does nothing without those limits.
+    class DocumentLimitChecker
+    {
+    public:
+        explicit DocumentLimitChecker(const LoadLimits& limits);
+
+        // Nodes and accessors are added in the order of the document.
+        void AddNode();
+
+        // A child of the node added last. Checked by CheckHierarchy.
+        void AddChild(size_t childIndex);
+
+        // Once every node is in. Checks the depth of every node and the nodes under it, every
+        // path counted, without following a node twice. Throws InvalidGLTFException for a
+        // child that isn't a node and for a node that is its own descendant.
+        void CheckHierarchy();
+
+        void AddAccessor(uint64_t count);
+
+        // An accessor of a vertex attribute or morph target, before or after it is added.
+        void AddVertexAccessor(size_t accessorIndex);
+
+    private:
+        bool ChecksHierarchy() const;
+        void CheckVertexCount(uint64_t count) const;
+
+        LoadLimits m_limits;
+
+        // The children of node i are m_children[m_childFirst[i]] up to the next node's first.
+        std::vector<size_t> m_childFirst;
+        std::vector<size_t> m_children;
+
+        std::vector<uint64_t> m_accessorCounts;
+        std::unordered_set<size_t> m_pendingVertexAccessors;
+    };
+
+    // The budget of one load, starting when it is created. Shared by every thread of the load.
+    class LoadLimiter
+    {
+    public:
+        explicit LoadLimiter(const LoadLimits& limits);
+
+        const LoadLimits& Limits() const { return m_limits; }
+
+        // Adds the bytes of elements the load is about to decode, and checks the time.
+        void ChargeDecodedBytes(uint64_t elementCount, size_t elementSize = 1);
+
+        // Checks the pixels of an image about to be decoded and charges its 32-bit pixels.
+        void ChargeImage(uint32_t width, uint32_t height);
+
+        void CheckTime() const;
+
+        uint64_t DecodedBytes() const { return m_decodedBytes; }
+
+    private:
+        LoadLimits m_limits;
+        std::chrono::steady_clock::time_point m_start;
+        std::atomic<uint64_t> m_decodedBytes{ 0 };
+    };
+} // SceneLoader
@@ -0,0 +1,87 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "LoadLimits.h"
+
+namespace SceneLoader
+{
+    // Settings for one load. Set by callers through SceneLoadOptions.
+    struct LoadOptions
+    {
+        // Where preprocessed scenes are cached, see SceneCache. Empty turns caching off.
+        std::wstring cacheFolderPath;
+
+        // Folder that external buffers and images are resolved against.
+        std::wstring resourceFolderPath;
+
+        // Map external files rather than reading them, see IResourceResolver.
+        bool mapResourceFiles = true;
+
+        // Time in the first animation at which skinned meshes are posed. Without it
+        // they are posed with the node transforms of the document.
+        std::optional<float> skinningPoseTime;
+
+        // Scene to load. The default scene of the document when not set.
+        std::optional<size_t> sceneIndex;
+
+        // When either is set, only the subtrees of the scene rooted at a node with one of
+        // these names, or accepted by the filter, are loaded. See SelectScene.
+        std::vector<std::string> nodeNames;
+        std::function<bool(const std::string& nodeName)> nodeFilter;
+
+        // Create texture surfaces from the image headers and leave decoding and uploading their
+        // pixels to the TextureDecodeQueue, so that the load doesn't wait for them.
+        bool deferTextureDecode = false;
+
+        // Textures at most this many texels wide and high are packed into shared atlases, see
+        // GLTFVisitor::BuildTextureAtlases. Zero turns atlasing off.
+        uint32_t atlasMaxTextureSize = 0;
+
+        // Decode the vertex and index streams of the primitives on the thread pool before the
+        // scene is built, see GLTFVisitor::DecodeMeshPrimitives. The scene is the same either way.
+        bool parallelMeshDecode = true;
+
+        // Read the JSON with DeserializeStreaming instead of the DOM based Deserialize of the
+        // glTF SDK. Uses a fraction of the memory on documents with many nodes and accessors.
+        // Off until StreamingDeserializerTests has been run against the SDK it's compared with.
+        bool streamingDeserialize = false;
+
+        // Primitives without normals get flat ones, as glTF asks for, unless this is set; see
+        // GLTFVisitor::GenerateVertexFrames.
+        bool smoothGeneratedNormals = false;
+
+        // Weld duplicate vertices, then drop degenerate triangles and unused vertices, see
+        // CleanUpMesh. Vertices weld when no float component differs by more than the
+        // tolerance; zero only welds identical ones.
+        bool cleanUpMeshes = false;
+        float meshWeldTolerance = 0.0f;
+
+        // Instances of EXT_mesh_gpu_instancing primitives with at most this many vertices are
+        // merged into shared meshes instead of each getting a scene node, see
+        // GLTFVisitor::TryAddInstanceBatches. Zero gives every instance a node.
+        uint32_t instanceBatchMaxVertices = 0;
+
+        // Triangles the scene may draw, instances included, and triangles per mesh. Meshes over
+        // budget are simplified before they are built, see GLTFVisitor::SimplifyMeshPrimitive.
+        // Zero is no budget.
+        uint64_t triangleBudget = 0;
+        uint32_t meshTriangleBudget = 0;
+
+        // What the load may decode and how long it may take, see LoadLimiter. Loads that hit a
+        // limit throw LoadLimitException. Scenes read from the scene cache aren't checked.
+        LoadLimits limits;
+
+        // The world node scales the scene so that its longest side is this long and its box
+        // is centered vertically, see SceneLoader::FinishLoad. Zero leaves the scene as it is.
+        float fitSize = 300.0f;
+
+        // Builds a PickIndex over the triangles the scene draws. The index needs the node and
+        // primitive of every triangle, which the scene cache doesn't keep, so these loads skip it.
+        bool buildPickIndex = false;
+
+        bool HasNodeSelection() const { return !nodeNames.empty() || nodeFilter; }
+    };
+} // SceneLoader
@@ -0,0 +1,46 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Numbers gathered while loading one asset. Surfaced to callers through SceneLoadStatistics.
+    struct LoadStatistics
+    {
+        // Largest amount of transient decode memory (see DecodeArena) in use at once.
+        uint64_t peakDecodeBytes = 0;
+
+        // Decode memory kept by DecodeBlockPool for the next load once this one finished.
+        uint64_t pooledDecodeBytes = 0;
+
+        // Textures handed to the TextureDecodeQueue instead of being decoded during the load.
+        uint32_t deferredTextureCount = 0;
+
+        // Textures packed into atlases, and the atlas surfaces that replaced them.
+        uint32_t atlasedTextureCount = 0;
+        uint32_t atlasCount = 0;
+
+        // Atlas memory, mip levels included, taken by gutters, alignment and unused space.
+        uint64_t atlasOverheadBytes = 0;
+
+        // Vertices and indices of the primitives CleanUpMesh changed, before and after.
+        uint64_t cleanupVerticesBefore = 0;
+        uint64_t cleanupVerticesAfter = 0;
+        uint64_t cleanupIndicesBefore = 0;
+        uint64_t cleanupIndicesAfter = 0;
+
+        // Instances from EXT_mesh_gpu_instancing, the scene nodes that place them and the
+        // meshes that merged them.
+        uint64_t meshInstanceCount = 0;
+        uint64_t instanceNodeCount = 0;
+        uint64_t instanceBatchMeshCount = 0;
+
+        // Triangles of the primitives that were simplified to fit the triangle budgets, before
+        // and after, and the largest error of any of them relative to the size of its mesh.
+        uint64_t simplifiedTrianglesBefore = 0;
+        uint64_t simplifiedTrianglesAfter = 0;
+        float maxSimplificationError = 0.0f;
+    };
+} // SceneLoader
@@ -0,0 +1,130 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "MappedFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace SceneLoader
+{
+#ifdef _WIN32
+    unique_ptr<MappedFile>
+    MappedFile::Open(const wstring& path)
+    {
+        unique_ptr<MappedFile> mappedFile(new MappedFile());
+
+        CREATEFILE2_EXTENDED_PARAMETERS parameters = {};
+        parameters.dwSize = sizeof(parameters);
+        parameters.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+        parameters.dwFileFlags = FILE_FLAG_SEQUENTIAL_SCAN;
+
+        mappedFile->m_file = CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &parameters);
+
+        if (mappedFile->m_file == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(mappedFile->m_file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            return nullptr;
+        }
+
+        if (static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX)
+        {
+            // Doesn't fit in the address space of a 32-bit process.
+            return nullptr;
+        }
+
+        mappedFile->m_size = static_cast<uint64_t>(fileSize.QuadPart);
+
+        mappedFile->m_mapping = CreateFileMappingFromApp(mappedFile->m_file, nullptr, PAGE_READONLY, mappedFile->m_size, nullptr);
+
+        if (!mappedFile->m_mapping)
+        {
+            return nullptr;
+        }
+
+        mappedFile->m_data = static_cast<const uint8_t*>(MapViewOfFileFromApp(mappedFile->m_mapping, FILE_MAP_READ, 0, static_cast<SIZE_T>(mappedFile->m_size)));
+
+        if (!mappedFile->m_data)
+        {
+            return nullptr;
+        }
+
+        return mappedFile;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+        }
+    }
+#else
+    unique_ptr<MappedFile>
+    MappedFile::Open(const wstring& path)
+    {
+        const int file = open(filesystem::path(path).c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (file < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat status;
+
+        if (fstat(file, &status) != 0 || status.st_size <= 0 || static_cast<uint64_t>(status.st_size) > SIZE_MAX)
+        {
+            close(file);
+            return nullptr;
+        }
+
+        // The mapping keeps the file open.
+        void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+        close(file);
+
+        if (data == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        unique_ptr<MappedFile> mappedFile(new MappedFile());
+        mappedFile->m_data = static_cast<const uint8_t*>(data);
+        mappedFile->m_size = static_cast<uint64_t>(status.st_size);
+
+        return mappedFile;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+        }
+    }
+#endif
+} // namespace SceneLoader
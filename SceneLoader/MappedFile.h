@@ -0,0 +1,35 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Read-only memory mapping of a whole file. Elsewhere than on Windows it is an mmap, for
+    // the modules that are tested there.
+    class MappedFile
+    {
+    public:
+        // Returns nullptr if the file does not exist or cannot be mapped.
+        static std::unique_ptr<MappedFile> Open(const std::wstring& path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* Data() const { return m_data; }
+        uint64_t Size() const { return m_size; }
+
+    private:
+        MappedFile() = default;
+
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#endif
+        const uint8_t* m_data = nullptr;
+        uint64_t m_size = 0;
+    };
+} // SceneLoader
@@ -0,0 +1,221 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "MeshCleanup.h"
+#include "ContentHash.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr uint32_t c_unassignedVertex = UINT32_MAX;
+
+    // Grid coordinates past this are not welded; they wouldn't fit the cell key.
+    static constexpr double c_maxGridCoordinate = 4.0e18;
+
+    static bool AreVerticesEqual(const MeshStream* streams, size_t streamCount, uint32_t a, uint32_t b, float tolerance)
+    {
+        for (size_t s = 0; s < streamCount; ++s)
+        {
+            const MeshStream& stream = streams[s];
+            const uint8_t* pA = stream.data + a * stream.elementSize;
+            const uint8_t* pB = stream.data + b * stream.elementSize;
+
+            if (tolerance > 0.0f && stream.isFloat)
+            {
+                for (size_t offset = 0; offset + sizeof(float) <= stream.elementSize; offset += sizeof(float))
+                {
+                    float valueA;
+                    float valueB;
+                    memcpy(&valueA, pA + offset, sizeof(float));
+                    memcpy(&valueB, pB + offset, sizeof(float));
+
+                    // NaN never welds.
+                    if (!(fabsf(valueA - valueB) <= tolerance))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else if (memcmp(pA, pB, stream.elementSize) != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static uint64_t HashVertex(const MeshStream* streams, size_t streamCount, uint32_t vertex)
+    {
+        uint64_t hash = 0;
+
+        for (size_t s = 0; s < streamCount; ++s)
+        {
+            hash = ComputeContentHash(streams[s].data + vertex * streams[s].elementSize, streams[s].elementSize, hash);
+        }
+
+        return hash;
+    }
+
+    static uint64_t HashGridCell(int64_t x, int64_t y, int64_t z)
+    {
+        return (static_cast<uint64_t>(x) * 73856093u) ^ (static_cast<uint64_t>(y) * 19349663u) ^ (static_cast<uint64_t>(z) * 83492791u);
+    }
+
+    // Hands out the first vertex seen that equals a given one.
+    class VertexWelder
+    {
+    public:
+        VertexWelder(const MeshStream* streams, size_t streamCount, size_t positionStream, float tolerance) :
+            m_streams(streams),
+            m_streamCount(streamCount),
+            m_positions(reinterpret_cast<const float*>(streams[positionStream].data)),
+            m_tolerance(tolerance)
+        {
+        }
+
+        uint32_t Weld(uint32_t vertex)
+        {
+            if (m_tolerance == 0.0f)
+            {
+                const uint64_t hash = HashVertex(m_streams, m_streamCount, vertex);
+
+                for (auto range = m_vertices.equal_range(hash); range.first != range.second; ++range.first)
+                {
+                    if (AreVerticesEqual(m_streams, m_streamCount, range.first->second, vertex, 0.0f))
+                    {
+                        return range.first->second;
+                    }
+                }
+
+                m_vertices.emplace(hash, vertex);
+                return vertex;
+            }
+
+            // Cells are as wide as the tolerance, so a match is at most one cell away.
+            int64_t cell[3];
+
+            for (size_t component = 0; component < 3; ++component)
+            {
+                const double coordinate = floor(static_cast<double>(m_positions[vertex * 3 + component]) / m_tolerance);
+
+                if (!(fabs(coordinate) < c_maxGridCoordinate))
+                {
+                    return vertex;
+                }
+
+                cell[component] = static_cast<int64_t>(coordinate);
+            }
+
+            for (int64_t dx = -1; dx <= 1; ++dx)
+            {
+                for (int64_t dy = -1; dy <= 1; ++dy)
+                {
+                    for (int64_t dz = -1; dz <= 1; ++dz)
+                    {
+                        const uint64_t hash = HashGridCell(cell[0] + dx, cell[1] + dy, cell[2] + dz);
+
+                        for (auto range = m_vertices.equal_range(hash); range.first != range.second; ++range.first)
+                        {
+                            if (AreVerticesEqual(m_streams, m_streamCount, range.first->second, vertex, m_tolerance))
+                            {
+                                return range.first->second;
+                            }
+                        }
+                    }
+                }
+            }
+
+            m_vertices.emplace(HashGridCell(cell[0], cell[1], cell[2]), vertex);
+            return vertex;
+        }
+
+    private:
+        const MeshStream* m_streams;
+        size_t m_streamCount;
+        const float* m_positions;
+        float m_tolerance;
+
+        // Vertices kept so far, by content hash or by grid cell.
+        unordered_multimap<uint64_t, uint32_t> m_vertices;
+    };
+
+    static bool HasArea(const float* positions, uint32_t a, uint32_t b, uint32_t c)
+    {
+        const float* p0 = positions + a * 3;
+        const float* p1 = positions + b * 3;
+        const float* p2 = positions + c * 3;
+
+        const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+        const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+        return (e1[1] * e2[2] - e1[2] * e2[1]) != 0.0f ||
+            (e1[2] * e2[0] - e1[0] * e2[2]) != 0.0f ||
+            (e1[0] * e2[1] - e1[1] * e2[0]) != 0.0f;
+    }
+
+    vector<uint32_t> CleanUpMesh(
+        const MeshStream* streams,
+        size_t streamCount,
+        size_t positionStream,
+        size_t vertexCount,
+        uint16_t* indices,
+        size_t* pIndexCount,
+        float tolerance)
+    {
+        const float* positions = reinterpret_cast<const float*>(streams[positionStream].data);
+        const size_t triangleCount = *pIndexCount / 3;
+
+        // Weld, in the order the triangles use the vertices.
+        VertexWelder welder(streams, streamCount, positionStream, tolerance);
+        vector<uint32_t> welded(vertexCount, c_unassignedVertex);
+
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+        {
+            uint32_t& vertex = welded[indices[i]];
+
+            if (vertex == c_unassignedVertex)
+            {
+                vertex = welder.Weld(indices[i]);
+            }
+        }
+
+        // Keep the triangles that still have three distinct corners and some area, and number
+        // the vertices they use in the order they use them. Indices are only ever written
+        // behind the triangle being read.
+        vector<uint32_t> compacted(vertexCount, c_unassignedVertex);
+        vector<uint32_t> sources;
+        size_t indexCount = 0;
+
+        for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            const uint32_t a = welded[indices[triangle * 3]];
+            const uint32_t b = welded[indices[triangle * 3 + 1]];
+            const uint32_t c = welded[indices[triangle * 3 + 2]];
+
+            if (a == b || b == c || a == c || !HasArea(positions, a, b, c))
+            {
+                continue;
+            }
+
+            for (uint32_t corner : { a, b, c })
+            {
+                if (compacted[corner] == c_unassignedVertex)
+                {
+                    compacted[corner] = static_cast<uint32_t>(sources.size());
+                    sources.push_back(corner);
+                }
+
+                indices[indexCount++] = static_cast<uint16_t>(compacted[corner]);
+            }
+        }
+
+        *pIndexCount = indexCount;
+
+        return sources;
+    }
+} // SceneLoader
@@ -0,0 +1,52 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // One per-vertex stream of a primitive.
+    struct MeshStream
+    {
+        const uint8_t* data = nullptr;
+        size_t elementSize = 0;
+
+        // Float streams are compared with the weld tolerance, anything else bit for bit.
+        bool isFloat = false;
+    };
+
+    // Vertex and index counts of the primitives that went through CleanUpMesh.
+    struct MeshCleanupCounts
+    {
+        uint64_t verticesBefore = 0;
+        uint64_t verticesAfter = 0;
+        uint64_t indicesBefore = 0;
+        uint64_t indicesAfter = 0;
+
+        void Add(const MeshCleanupCounts& other)
+        {
+            verticesBefore += other.verticesBefore;
+            verticesAfter += other.verticesAfter;
+            indicesBefore += other.indicesBefore;
+            indicesAfter += other.indicesAfter;
+        }
+    };
+
+    // Welds the vertices of a triangle list that are the same in every stream, drops the
+    // triangles that have no area and the vertices no triangle uses. With a zero tolerance
+    // vertices weld when they are bit for bit identical; otherwise when no float component
+    // differs by more than the tolerance, found through a hash grid over the positions.
+    //
+    // positionStream is the index of the packed xyz float stream in streams. Indices must be
+    // less than vertexCount; they are rewritten in place and *pIndexCount updated. Returns the
+    // old vertex each new vertex is taken from, in the order the triangles first use them.
+    std::vector<uint32_t> CleanUpMesh(
+        const MeshStream* streams,
+        size_t streamCount,
+        size_t positionStream,
+        size_t vertexCount,
+        uint16_t* indices,
+        size_t* pIndexCount,
+        float tolerance);
+} // SceneLoader
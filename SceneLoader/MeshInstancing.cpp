@@ -0,0 +1,166 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "MeshInstancing.h"
+#include "JsonReader.h"
+#include "SimdMath.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    bool TryGetMeshInstancing(const Document& gltfDocument, const Node& node, MeshInstancingAccessors* pAccessors)
+    {
+        auto extension = node.extensions.find(c_meshGpuInstancingExtension);
+
+        if (node.meshId.empty() || extension == node.extensions.end())
+        {
+            return false;
+        }
+
+        *pAccessors = {};
+
+        JsonReader reader(extension->second.data(), extension->second.size());
+        bool hasAttributes = false;
+        string_view key;
+
+        reader.BeginObject();
+
+        while (reader.NextMember(&key))
+        {
+            if (key != "attributes")
+            {
+                reader.SkipValue();
+                continue;
+            }
+
+            reader.BeginObject();
+
+            // Custom attributes, such as _ID, are not drawn with.
+            while (reader.NextMember(&key))
+            {
+                string* pAccessorId =
+                    (key == "TRANSLATION") ? &pAccessors->translationAccessorId :
+                    (key == "ROTATION") ? &pAccessors->rotationAccessorId :
+                    (key == "SCALE") ? &pAccessors->scaleAccessorId :
+                    nullptr;
+
+                if (!pAccessorId)
+                {
+                    reader.SkipValue();
+                    continue;
+                }
+
+                const size_t index = reader.ReadIndex();
+
+                if (index >= gltfDocument.accessors.Size())
+                {
+                    throw InvalidGLTFException("EXT_mesh_gpu_instancing of node " + node.id + " refers to an accessor that doesn't exist");
+                }
+
+                *pAccessorId = gltfDocument.accessors[index].id;
+                hasAttributes = true;
+            }
+        }
+
+        reader.ExpectEnd();
+
+        if (!hasAttributes)
+        {
+            throw InvalidGLTFException("EXT_mesh_gpu_instancing of node " + node.id + " has no TRANSLATION, ROTATION or SCALE");
+        }
+
+        return true;
+    }
+
+    // Scales each quaternion to unit length; normalized integer rotations are only close to it.
+    static void NormalizeRotations(float* rotations, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Vec4 rotation = Vec4::Load(rotations + i * 4);
+            const float lengthSquared = Dot(rotation, rotation);
+
+            if (lengthSquared > 0.0f)
+            {
+                (rotation * Vec4::Splat(1.0f / sqrtf(lengthSquared))).Store(rotations + i * 4);
+            }
+            else
+            {
+                Vec4::Set(0.0f, 0.0f, 0.0f, 1.0f).Store(rotations + i * 4);
+            }
+        }
+    }
+
+    MeshInstances ReadMeshInstances(
+        AccessorDecoder& accessorDecoder,
+        DecodeArena& arena,
+        const Document& gltfDocument,
+        const MeshInstancingAccessors& accessors)
+    {
+        DecodeArena::Scope scratch(arena);
+
+        MeshInstances instances;
+        bool hasCount = false;
+
+        auto readAttribute = [&](const string& accessorId, AccessorType type, vector<float>* pValues)
+        {
+            if (accessorId.empty())
+            {
+                return;
+            }
+
+            const Accessor& accessor = gltfDocument.accessors.Get(accessorId);
+
+            if (accessor.type != type)
+            {
+                throw InvalidGLTFException("Accessor " + accessor.id + " has the wrong type for EXT_mesh_gpu_instancing");
+            }
+
+            if (hasCount && accessor.count != instances.count)
+            {
+                throw InvalidGLTFException("The accessors of EXT_mesh_gpu_instancing must have the same count");
+            }
+
+            instances.count = accessor.count;
+            hasCount = true;
+
+            auto values = accessorDecoder.ReadFloats(arena, accessor);
+            pValues->assign(values.begin(), values.end());
+        };
+
+        readAttribute(accessors.translationAccessorId, TYPE_VEC3, &instances.translations);
+        readAttribute(accessors.rotationAccessorId, TYPE_VEC4, &instances.rotations);
+        readAttribute(accessors.scaleAccessorId, TYPE_VEC3, &instances.scales);
+
+        if (accessors.translationAccessorId.empty())
+        {
+            instances.translations.assign(instances.count * 3, 0.0f);
+        }
+
+        if (accessors.rotationAccessorId.empty())
+        {
+            instances.rotations.resize(instances.count * 4);
+
+            for (size_t i = 0; i < instances.count; ++i)
+            {
+                Vec4::Set(0.0f, 0.0f, 0.0f, 1.0f).Store(&instances.rotations[i * 4]);
+            }
+        }
+        else
+        {
+            NormalizeRotations(instances.rotations.data(), instances.count);
+        }
+
+        if (accessors.scaleAccessorId.empty())
+        {
+            instances.scales.assign(instances.count * 3, 1.0f);
+        }
+
+        return instances;
+    }
+} // SceneLoader
@@ -0,0 +1,47 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "AccessorDecoder.h"
+#include "InstanceTransforms.h"
+
+namespace SceneLoader
+{
+    constexpr char c_meshGpuInstancingExtension[] = "EXT_mesh_gpu_instancing";
+
+    // What the loader made of the EXT_mesh_gpu_instancing nodes of a scene.
+    struct MeshInstancingCounts
+    {
+        uint64_t instanceCount = 0;
+
+        // Scene nodes created to place instances, and the meshes that merged them instead.
+        uint64_t instanceNodeCount = 0;
+        uint64_t batchMeshCount = 0;
+    };
+
+    // The accessors of the EXT_mesh_gpu_instancing extension of a node. Each instance draws the
+    // mesh of the node with the node's transform followed by its own.
+    struct MeshInstancingAccessors
+    {
+        std::string translationAccessorId;
+        std::string rotationAccessorId;
+        std::string scaleAccessorId;
+    };
+
+    // Returns false if the node has no mesh or no EXT_mesh_gpu_instancing. Throws
+    // InvalidGLTFException if the extension is malformed or names accessors that don't exist.
+    bool TryGetMeshInstancing(
+        const Microsoft::glTF::Document& gltfDocument,
+        const Microsoft::glTF::Node& node,
+        MeshInstancingAccessors* pAccessors);
+
+    // Scratch memory comes from the arena. Throws InvalidGLTFException if the accessors
+    // don't have the type or the count the extension asks for.
+    MeshInstances ReadMeshInstances(
+        AccessorDecoder& accessorDecoder,
+        DecodeArena& arena,
+        const Microsoft::glTF::Document& gltfDocument,
+        const MeshInstancingAccessors& accessors);
+} // SceneLoader
@@ -0,0 +1,745 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "MeshSimplifier.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr uint32_t c_noVertex = UINT32_MAX;
+
+    // Marks a vertex with more than one open edge going in, or out.
+    static constexpr uint32_t c_manyVertices = UINT32_MAX - 1;
+
+    // Collapses happen in passes over the whole mesh; this bounds them for meshes that barely shrink.
+    static constexpr size_t c_maxPassCount = 100;
+
+    // Q(p) = p'Ap + 2b'p + c: the squared distances of p to the planes of the triangles around a
+    // position, each weighted by the area of its triangle.
+    struct Quadric
+    {
+        float a00 = 0.0f, a11 = 0.0f, a22 = 0.0f, a01 = 0.0f, a02 = 0.0f, a12 = 0.0f;
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+        float c = 0.0f;
+        float weight = 0.0f;
+
+        void AddPlane(const float* normal, float distance, float area)
+        {
+            a00 += area * normal[0] * normal[0];
+            a11 += area * normal[1] * normal[1];
+            a22 += area * normal[2] * normal[2];
+            a01 += area * normal[0] * normal[1];
+            a02 += area * normal[0] * normal[2];
+            a12 += area * normal[1] * normal[2];
+            b0 += area * normal[0] * distance;
+            b1 += area * normal[1] * distance;
+            b2 += area * normal[2] * distance;
+            c += area * distance * distance;
+            weight += area;
+        }
+
+        void Add(const Quadric& other)
+        {
+            a00 += other.a00; a11 += other.a11; a22 += other.a22;
+            a01 += other.a01; a02 += other.a02; a12 += other.a12;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        float Evaluate(const float* p) const
+        {
+            const float x = p[0];
+            const float y = p[1];
+            const float z = p[2];
+
+            const float error =
+                a00 * x * x + a11 * y * y + a22 * z * z +
+                2.0f * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                2.0f * (b0 * x + b1 * y + b2 * z) +
+                c;
+
+            // Rounding can take it just below zero.
+            return max(error, 0.0f);
+        }
+    };
+
+    enum class VertexKind : uint8_t
+    {
+        // Every edge has a twin, and no other vertex is at the same position.
+        Manifold,
+
+        // One of two vertices at a position that a texture or normal seam splits.
+        Seam,
+
+        // On an open border, or anything more involved. Never moves.
+        Locked,
+    };
+
+    // The triangles around each vertex, or around each position when remap is given.
+    class TriangleAdjacency
+    {
+    public:
+        void Build(const uint16_t* indices, size_t triangleCount, const uint32_t* remap, size_t vertexCount)
+        {
+            m_offsets.assign(vertexCount + 1, 0);
+
+            for (size_t i = 0; i < triangleCount * 3; ++i)
+            {
+                m_offsets[Corner(indices, remap, i) + 1]++;
+            }
+
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                m_offsets[vertex + 1] += m_offsets[vertex];
+            }
+
+            m_triangles.resize(triangleCount * 3);
+            vector<uint32_t> cursors(m_offsets.begin(), m_offsets.end() - 1);
+
+            for (size_t i = 0; i < triangleCount * 3; ++i)
+            {
+                m_triangles[cursors[Corner(indices, remap, i)]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        const uint32_t* begin(uint32_t vertex) const { return m_triangles.data() + m_offsets[vertex]; }
+        const uint32_t* end(uint32_t vertex) const { return m_triangles.data() + m_offsets[vertex + 1]; }
+
+        static uint32_t Corner(const uint16_t* indices, const uint32_t* remap, size_t i)
+        {
+            return remap ? remap[indices[i]] : indices[i];
+        }
+
+        // Whether a triangle around from has the edge from -> to.
+        bool HasEdge(const uint16_t* indices, const uint32_t* remap, uint32_t from, uint32_t to) const
+        {
+            for (const uint32_t* triangle = begin(from); triangle != end(from); ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    if (Corner(indices, remap, *triangle * 3 + corner) == from && Corner(indices, remap, *triangle * 3 + (corner + 1) % 3) == to)
+                    {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        vector<uint32_t> m_offsets;
+        vector<uint32_t> m_triangles;
+    };
+
+    struct Collapse
+    {
+        uint32_t vertex;
+        uint32_t target;
+        float cost;
+    };
+
+    static void Cross(const float* a, const float* b, const float* c, float* pNormal)
+    {
+        const float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+        pNormal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        pNormal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        pNormal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+
+    static float Length(const float* v)
+    {
+        return sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    }
+
+    // Every vertex is mapped to the first one at the same position.
+    static vector<uint32_t> WeldPositions(const float* positions, size_t vertexCount)
+    {
+        struct Key
+        {
+            uint32_t bits[3];
+
+            bool operator==(const Key& other) const
+            {
+                return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                return (static_cast<size_t>(key.bits[0]) * 73856093u) ^ (static_cast<size_t>(key.bits[1]) * 19349663u) ^ (static_cast<size_t>(key.bits[2]) * 83492791u);
+            }
+        };
+
+        vector<uint32_t> remap(vertexCount);
+        unordered_map<Key, uint32_t, KeyHash> firstAtPosition;
+        firstAtPosition.reserve(vertexCount);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            Key key;
+
+            for (size_t component = 0; component < 3; ++component)
+            {
+                // -0 and +0 weld.
+                const float value = (positions[vertex * 3 + component] == 0.0f) ? 0.0f : positions[vertex * 3 + component];
+                memcpy(&key.bits[component], &value, sizeof(value));
+            }
+
+            remap[vertex] = firstAtPosition.emplace(key, static_cast<uint32_t>(vertex)).first->second;
+        }
+
+        return remap;
+    }
+
+    class Simplifier
+    {
+    public:
+        Simplifier(
+            const float* positions,
+            size_t vertexCount,
+            const SimplifierAttribute* attributes,
+            size_t attributeCount,
+            uint16_t* indices,
+            size_t triangleCount) :
+            m_vertexCount(vertexCount),
+            m_attributes(attributes),
+            m_attributeCount(attributeCount),
+            m_indices(indices),
+            m_triangleCount(triangleCount),
+            m_remap(WeldPositions(positions, vertexCount)),
+            m_quadrics(vertexCount),
+            m_kinds(vertexCount),
+            m_openOut(vertexCount),
+            m_openIn(vertexCount),
+            m_wedges(vertexCount),
+            m_collapseTargets(vertexCount),
+            m_isLocked(vertexCount)
+        {
+            // Errors are measured in a cube of unit size, so that they compare across meshes.
+            float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+            float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                for (size_t component = 0; component < 3; ++component)
+                {
+                    minimum[component] = min(minimum[component], positions[vertex * 3 + component]);
+                    maximum[component] = max(maximum[component], positions[vertex * 3 + component]);
+                }
+            }
+
+            const float extent = max(max(maximum[0] - minimum[0], maximum[1] - minimum[1]), maximum[2] - minimum[2]);
+            const float scale = (extent > 0.0f) ? 1.0f / extent : 1.0f;
+
+            m_points.resize(vertexCount * 3);
+
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                for (size_t component = 0; component < 3; ++component)
+                {
+                    m_points[vertex * 3 + component] = (positions[vertex * 3 + component] - minimum[component]) * scale;
+                }
+            }
+
+            for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+            {
+                const float* p0 = Point(m_indices[triangle * 3]);
+                float normal[3];
+
+                Cross(p0, Point(m_indices[triangle * 3 + 1]), Point(m_indices[triangle * 3 + 2]), normal);
+
+                const float length = Length(normal);
+
+                if (length == 0.0f)
+                {
+                    continue;
+                }
+
+                for (float& component : normal)
+                {
+                    component /= length;
+                }
+
+                const float distance = -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]);
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    m_quadrics[m_remap[m_indices[triangle * 3 + corner]]].AddPlane(normal, distance, length * 0.5f);
+                }
+            }
+
+            for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+            {
+                m_collapseTargets[vertex] = static_cast<uint32_t>(vertex);
+            }
+        }
+
+        SimplifyResult Run(size_t targetTriangleCount)
+        {
+            for (size_t pass = 0; pass < c_maxPassCount && m_triangleCount > targetTriangleCount; ++pass)
+            {
+                ClassifyVertices();
+
+                if (!CollapseEdges(targetTriangleCount))
+                {
+                    break;
+                }
+
+                ApplyCollapses();
+            }
+
+            return { m_triangleCount * 3, m_error };
+        }
+
+    private:
+        const float* Point(uint32_t vertex) const { return &m_points[vertex * 3]; }
+
+        void ClassifyVertices()
+        {
+            m_vertexAdjacency.Build(m_indices, m_triangleCount, nullptr, m_vertexCount);
+            m_positionAdjacency.Build(m_indices, m_triangleCount, m_remap.data(), m_vertexCount);
+
+            fill(m_openOut.begin(), m_openOut.end(), c_noVertex);
+            fill(m_openIn.begin(), m_openIn.end(), c_noVertex);
+
+            // Open edges between vertices; a seam leaves them open even where positions close them.
+            for (size_t triangle = 0; triangle < m_triangleCount; ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t from = m_indices[triangle * 3 + corner];
+                    const uint32_t to = m_indices[triangle * 3 + (corner + 1) % 3];
+
+                    if (!m_vertexAdjacency.HasEdge(m_indices, nullptr, to, from))
+                    {
+                        m_openOut[from] = (m_openOut[from] == c_noVertex) ? to : c_manyVertices;
+                        m_openIn[to] = (m_openIn[to] == c_noVertex) ? from : c_manyVertices;
+                    }
+                }
+            }
+
+            // Up to two vertices in use at each position, and how many there are.
+            vector<uint32_t> wedgeCounts(m_vertexCount, 0);
+            vector<uint32_t> firstWedges(m_vertexCount, c_noVertex);
+
+            for (size_t i = 0; i < m_triangleCount * 3; ++i)
+            {
+                const uint32_t vertex = m_indices[i];
+                const uint32_t position = m_remap[vertex];
+
+                if (firstWedges[position] == c_noVertex)
+                {
+                    firstWedges[position] = vertex;
+                    wedgeCounts[position] = 1;
+                    m_wedges[vertex] = vertex;
+                }
+                else if (firstWedges[position] != vertex && m_wedges[firstWedges[position]] != vertex)
+                {
+                    if (wedgeCounts[position] == 1)
+                    {
+                        m_wedges[firstWedges[position]] = vertex;
+                        m_wedges[vertex] = firstWedges[position];
+                    }
+
+                    wedgeCounts[position]++;
+                }
+            }
+
+            auto isSingle = [](uint32_t vertex) { return vertex != c_noVertex && vertex != c_manyVertices; };
+
+            for (size_t i = 0; i < m_triangleCount * 3; ++i)
+            {
+                const uint32_t vertex = m_indices[i];
+                const uint32_t wedgeCount = wedgeCounts[m_remap[vertex]];
+
+                if (wedgeCount == 1)
+                {
+                    m_kinds[vertex] = (m_openOut[vertex] == c_noVertex && m_openIn[vertex] == c_noVertex) ? VertexKind::Manifold : VertexKind::Locked;
+                }
+                else if (wedgeCount == 2)
+                {
+                    // The open edges of the two sides of a seam run along the same positions, in opposite directions.
+                    const uint32_t wedge = m_wedges[vertex];
+
+                    const bool isSeam =
+                        isSingle(m_openOut[vertex]) && isSingle(m_openIn[vertex]) && isSingle(m_openOut[wedge]) && isSingle(m_openIn[wedge]) &&
+                        m_remap[m_openIn[vertex]] == m_remap[m_openOut[wedge]] &&
+                        m_remap[m_openOut[vertex]] == m_remap[m_openIn[wedge]] &&
+                        m_remap[m_openIn[vertex]] != m_remap[m_openOut[vertex]];
+
+                    m_kinds[vertex] = isSeam ? VertexKind::Seam : VertexKind::Locked;
+                }
+                else
+                {
+                    m_kinds[vertex] = VertexKind::Locked;
+                }
+            }
+        }
+
+        float GetAttributeCost(uint32_t vertex, uint32_t target) const
+        {
+            float cost = 0.0f;
+
+            for (size_t a = 0; a < m_attributeCount; ++a)
+            {
+                const SimplifierAttribute& attribute = m_attributes[a];
+
+                for (size_t component = 0; component < attribute.componentCount; ++component)
+                {
+                    const float difference = attribute.data[vertex * attribute.componentCount + component] - attribute.data[target * attribute.componentCount + component];
+                    cost += attribute.weight * difference * difference;
+                }
+            }
+
+            return cost;
+        }
+
+        // The other side of a seam collapse: the wedge of vertex moves to the wedge of target.
+        uint32_t GetSeamTarget(uint32_t vertex, uint32_t target) const
+        {
+            return (target == m_openOut[vertex]) ? m_openIn[m_wedges[vertex]] : m_openOut[m_wedges[vertex]];
+        }
+
+        float GetCost(uint32_t vertex, uint32_t target) const
+        {
+            const Quadric& quadric = m_quadrics[m_remap[vertex]];
+            float cost = quadric.Evaluate(Point(target)) + quadric.weight * GetAttributeCost(vertex, target);
+
+            if (m_kinds[vertex] == VertexKind::Seam)
+            {
+                cost += quadric.weight * GetAttributeCost(m_wedges[vertex], GetSeamTarget(vertex, target));
+            }
+
+            return cost;
+        }
+
+        // Whether moving position onto target turns a triangle around it over, or flattens it.
+        bool HasTriangleFlip(uint32_t position, uint32_t target) const
+        {
+            for (const uint32_t* triangle = m_positionAdjacency.begin(position); triangle != m_positionAdjacency.end(position); ++triangle)
+            {
+                uint32_t corners[3];
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    corners[corner] = m_remap[m_indices[*triangle * 3 + corner]];
+                }
+
+                if (corners[0] == target || corners[1] == target || corners[2] == target)
+                {
+                    continue;
+                }
+
+                const float* moved[3];
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    moved[corner] = Point((corners[corner] == position) ? target : corners[corner]);
+                }
+
+                float before[3];
+                float after[3];
+
+                Cross(Point(corners[0]), Point(corners[1]), Point(corners[2]), before);
+                Cross(moved[0], moved[1], moved[2], after);
+
+                const float lengthAfter = Length(after);
+                const float dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+
+                if (lengthAfter == 0.0f || dot < 0.25f * Length(before) * lengthAfter)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Whether moving position onto target folds the surface onto itself, which the flip test
+        // can't see: their only common neighbors may be the far corners of the triangles on their
+        // edge, and no triangle around position may end up on the corners of one around target.
+        // Otherwise the collapse leaves an edge with more than two triangles, or two triangles
+        // back to back, as collapsing any edge of a tetrahedron would.
+        bool FoldsSurface(uint32_t position, uint32_t target) const
+        {
+            uint32_t neighbors[64];
+            size_t neighborCount = 0;
+
+            uint32_t edgeCorners[64];
+            size_t edgeCornerCount = 0;
+
+            for (const uint32_t* triangle = m_positionAdjacency.begin(position); triangle != m_positionAdjacency.end(position); ++triangle)
+            {
+                uint32_t corners[3];
+                bool hasTarget = false;
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    corners[corner] = m_remap[m_indices[*triangle * 3 + corner]];
+                    hasTarget = hasTarget || (corners[corner] == target);
+                }
+
+                for (uint32_t corner : corners)
+                {
+                    uint32_t* pList = hasTarget ? edgeCorners : neighbors;
+                    size_t& count = hasTarget ? edgeCornerCount : neighborCount;
+
+                    if (corner == position || corner == target || find(pList, pList + count, corner) != pList + count)
+                    {
+                        continue;
+                    }
+
+                    // Too many to tell; such a vertex is better left alone anyway.
+                    if (count == size(neighbors))
+                    {
+                        return true;
+                    }
+
+                    pList[count++] = corner;
+                }
+            }
+
+            for (const uint32_t* triangle = m_positionAdjacency.begin(target); triangle != m_positionAdjacency.end(target); ++triangle)
+            {
+                uint32_t others[2];
+                size_t otherCount = 0;
+                bool isOnEdge = false;
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t neighbor = m_remap[m_indices[*triangle * 3 + corner]];
+
+                    if (neighbor == position)
+                    {
+                        isOnEdge = true;
+                        break;
+                    }
+
+                    if (neighbor == target)
+                    {
+                        continue;
+                    }
+
+                    if (find(neighbors, neighbors + neighborCount, neighbor) != neighbors + neighborCount &&
+                        find(edgeCorners, edgeCorners + edgeCornerCount, neighbor) == edgeCorners + edgeCornerCount)
+                    {
+                        return true;
+                    }
+
+                    others[otherCount++] = neighbor;
+                }
+
+                // The triangles on the edge go away; any other with the same two corners as a moved
+                // triangle would be its twin.
+                if (!isOnEdge && otherCount == 2 && HasTriangleWith(position, target, others[0], others[1]))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Whether a triangle around position, without target, has both corners a and b.
+        bool HasTriangleWith(uint32_t position, uint32_t target, uint32_t a, uint32_t b) const
+        {
+            for (const uint32_t* triangle = m_positionAdjacency.begin(position); triangle != m_positionAdjacency.end(position); ++triangle)
+            {
+                bool hasA = false;
+                bool hasB = false;
+                bool hasTarget = false;
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t neighbor = m_remap[m_indices[*triangle * 3 + corner]];
+
+                    hasA = hasA || (neighbor == a);
+                    hasB = hasB || (neighbor == b);
+                    hasTarget = hasTarget || (neighbor == target);
+                }
+
+                if (hasA && hasB && !hasTarget)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Picks the cheapest collapses whose neighborhoods don't overlap. Returns false if there are none.
+        bool CollapseEdges(size_t targetTriangleCount)
+        {
+            vector<Collapse> collapses;
+            collapses.reserve(m_triangleCount * 3);
+
+            for (size_t triangle = 0; triangle < m_triangleCount; ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t a = m_indices[triangle * 3 + corner];
+                    const uint32_t b = m_indices[triangle * 3 + (corner + 1) % 3];
+
+                    for (const auto& edge : { make_pair(a, b), make_pair(b, a) })
+                    {
+                        const uint32_t vertex = edge.first;
+                        const uint32_t target = edge.second;
+
+                        const bool canCollapse =
+                            m_kinds[vertex] == VertexKind::Manifold ||
+                            (m_kinds[vertex] == VertexKind::Seam && (target == m_openOut[vertex] || target == m_openIn[vertex]));
+
+                        if (canCollapse && m_remap[vertex] != m_remap[target])
+                        {
+                            collapses.push_back({ vertex, target, GetCost(vertex, target) });
+                        }
+                    }
+                }
+            }
+
+            sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+            fill(m_isLocked.begin(), m_isLocked.end(), false);
+
+            size_t triangleCount = m_triangleCount;
+            bool hasCollapsed = false;
+
+            for (const Collapse& collapse : collapses)
+            {
+                if (triangleCount <= targetTriangleCount)
+                {
+                    break;
+                }
+
+                const uint32_t position = m_remap[collapse.vertex];
+                const uint32_t target = m_remap[collapse.target];
+
+                if (m_isLocked[position] || m_isLocked[target] || HasTriangleFlip(position, target) || FoldsSurface(position, target))
+                {
+                    continue;
+                }
+
+                m_collapseTargets[collapse.vertex] = collapse.target;
+
+                if (m_kinds[collapse.vertex] == VertexKind::Seam)
+                {
+                    m_collapseTargets[m_wedges[collapse.vertex]] = GetSeamTarget(collapse.vertex, collapse.target);
+                }
+
+                // Nothing around the collapse moves again in this pass, so the flip test stays valid.
+                for (const uint32_t* triangle = m_positionAdjacency.begin(position); triangle != m_positionAdjacency.end(position); ++triangle)
+                {
+                    bool isRemoved = false;
+
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        const uint32_t neighbor = m_remap[m_indices[*triangle * 3 + corner]];
+
+                        m_isLocked[neighbor] = true;
+                        isRemoved = isRemoved || (neighbor == target);
+                    }
+
+                    triangleCount -= isRemoved ? 1 : 0;
+                }
+
+                m_isLocked[target] = true;
+
+                const Quadric& quadric = m_quadrics[position];
+
+                if (quadric.weight > 0.0f)
+                {
+                    m_error = max(m_error, sqrtf(quadric.Evaluate(Point(target)) / quadric.weight));
+                }
+
+                m_quadrics[target].Add(quadric);
+                hasCollapsed = true;
+            }
+
+            return hasCollapsed;
+        }
+
+        void ApplyCollapses()
+        {
+            size_t indexCount = 0;
+
+            for (size_t triangle = 0; triangle < m_triangleCount; ++triangle)
+            {
+                const uint32_t a = m_collapseTargets[m_indices[triangle * 3]];
+                const uint32_t b = m_collapseTargets[m_indices[triangle * 3 + 1]];
+                const uint32_t c = m_collapseTargets[m_indices[triangle * 3 + 2]];
+
+                if (m_remap[a] == m_remap[b] || m_remap[b] == m_remap[c] || m_remap[a] == m_remap[c])
+                {
+                    continue;
+                }
+
+                m_indices[indexCount++] = static_cast<uint16_t>(a);
+                m_indices[indexCount++] = static_cast<uint16_t>(b);
+                m_indices[indexCount++] = static_cast<uint16_t>(c);
+            }
+
+            m_triangleCount = indexCount / 3;
+
+            for (size_t vertex = 0; vertex < m_vertexCount; ++vertex)
+            {
+                m_collapseTargets[vertex] = static_cast<uint32_t>(vertex);
+            }
+        }
+
+        size_t m_vertexCount;
+        const SimplifierAttribute* m_attributes;
+        size_t m_attributeCount;
+        uint16_t* m_indices;
+        size_t m_triangleCount;
+
+        vector<float> m_points;
+
+        // By vertex: the first vertex at the same position, which holds the quadric of the position.
+        vector<uint32_t> m_remap;
+        vector<Quadric> m_quadrics;
+
+        // Refreshed every pass. m_wedges holds the other vertex at the position of a seam vertex.
+        TriangleAdjacency m_vertexAdjacency;
+        TriangleAdjacency m_positionAdjacency;
+        vector<VertexKind> m_kinds;
+        vector<uint32_t> m_openOut;
+        vector<uint32_t> m_openIn;
+        vector<uint32_t> m_wedges;
+
+        vector<uint32_t> m_collapseTargets;
+        vector<bool> m_isLocked;
+
+        float m_error = 0.0f;
+    };
+
+    SimplifyResult SimplifyMesh(
+        const float* positions,
+        size_t vertexCount,
+        const SimplifierAttribute* attributes,
+        size_t attributeCount,
+        uint16_t* indices,
+        size_t indexCount,
+        size_t targetIndexCount)
+    {
+        const size_t triangleCount = indexCount / 3;
+
+        if (triangleCount * 3 <= targetIndexCount || vertexCount == 0)
+        {
+            return { triangleCount * 3, 0.0f };
+        }
+
+        Simplifier simplifier(positions, vertexCount, attributes, attributeCount, indices, triangleCount);
+
+        return simplifier.Run(targetIndexCount / 3);
+    }
+} // SceneLoader
@@ -0,0 +1,58 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Triangles of the primitives that were simplified, and the largest SimplifyResult::error.
+    struct MeshSimplifyCounts
+    {
+        uint64_t trianglesBefore = 0;
+        uint64_t trianglesAfter = 0;
+        float maxError = 0.0f;
+
+        void Add(const MeshSimplifyCounts& other)
+        {
+            trianglesBefore += other.trianglesBefore;
+            trianglesAfter += other.trianglesAfter;
+            maxError = std::max(maxError, other.maxError);
+        }
+    };
+
+    // A per-vertex float stream whose values the simplifier tries to keep, such as normals or
+    // texture coordinates. A unit of difference costs weight times as much as a distance the
+    // size of the mesh.
+    struct SimplifierAttribute
+    {
+        const float* data = nullptr;
+        size_t componentCount = 0;
+        float weight = 0.0f;
+    };
+
+    struct SimplifyResult
+    {
+        size_t indexCount = 0;
+
+        // The largest distance a collapse moved the surface by, relative to the size of the mesh.
+        float error = 0.0f;
+    };
+
+    // Collapses edges of a triangle list, cheapest first by quadric error plus the attribute
+    // difference, until at most targetIndexCount indices are left or no collapse remains that
+    // keeps the mesh intact. Vertices on open borders never move. Vertices that texture or
+    // normal seams split move in pairs along the seam, so it stays closed. Triangles that
+    // would flip are not made.
+    //
+    // Positions are packed xyz. Indices must be less than vertexCount; they are rewritten in
+    // place and only ever refer to existing vertices, so unused ones can be compacted after.
+    SimplifyResult SimplifyMesh(
+        const float* positions,
+        size_t vertexCount,
+        const SimplifierAttribute* attributes,
+        size_t attributeCount,
+        uint16_t* indices,
+        size_t indexCount,
+        size_t targetIndexCount);
+} // SceneLoader
@@ -0,0 +1,42 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "MipChain.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    void DownsampleMipLevel32(
+        const uint8_t* pSource,
+        uint32_t sourceWidth,
+        uint32_t sourceHeight,
+        size_t sourcePitch,
+        uint8_t* pDest)
+    {
+        const uint32_t destWidth = NextMipDimension(sourceWidth);
+        const uint32_t destHeight = NextMipDimension(sourceHeight);
+
+        for (uint32_t y = 0; y < destHeight; ++y)
+        {
+            const uint8_t* pRow0 = pSource + static_cast<size_t>(min(y * 2, sourceHeight - 1)) * sourcePitch;
+            const uint8_t* pRow1 = pSource + static_cast<size_t>(min(y * 2 + 1, sourceHeight - 1)) * sourcePitch;
+            uint8_t* pOut = pDest + static_cast<size_t>(y) * destWidth * 4;
+
+            for (uint32_t x = 0; x < destWidth; ++x)
+            {
+                const size_t x0 = static_cast<size_t>(min(x * 2, sourceWidth - 1)) * 4;
+                const size_t x1 = static_cast<size_t>(min(x * 2 + 1, sourceWidth - 1)) * 4;
+
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    uint32_t sum = pRow0[x0 + c] + pRow0[x1 + c] + pRow1[x0 + c] + pRow1[x1 + c];
+                    pOut[x * 4 + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+    }
+} // namespace SceneLoader
@@ -0,0 +1,55 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+
+namespace SceneLoader
+{
+    // Size of the next mip level down, never smaller than 1.
+    inline uint32_t NextMipDimension(uint32_t dimension)
+    {
+        return dimension > 1 ? dimension / 2 : 1;
+    }
+
+    // 2x2 box filter over 4-byte pixels (premultiplied BGRA). Odd source sizes reuse the
+    // last row or column. The destination is tightly packed at NextMipDimension of the source.
+    void DownsampleMipLevel32(
+        const uint8_t* pSource,
+        uint32_t sourceWidth,
+        uint32_t sourceHeight,
+        size_t sourcePitch,
+        uint8_t* pDest);
+
+    // Calls upload(level, width, height, pixels) for the first levelCount levels of the chain
+    // that starts with the given tightly packed 4-byte pixels. Lower levels are filtered
+    // into arena memory.
+    template<typename Upload>
+    void ForEachMipLevel(
+        DecodeArena& arena,
+        ArenaArray<uint8_t> pixels,
+        uint32_t width,
+        uint32_t height,
+        uint32_t levelCount,
+        const Upload& upload)
+    {
+        for (uint32_t level = 0; level < levelCount; ++level)
+        {
+            upload(level, width, height, static_cast<const uint8_t*>(pixels.data));
+
+            if (level + 1 < levelCount)
+            {
+                ArenaArray<uint8_t> nextPixels = arena.AllocateArray<uint8_t>(
+                    static_cast<size_t>(NextMipDimension(width)) * 4 * NextMipDimension(height));
+
+                DownsampleMipLevel32(pixels.data, width, height, static_cast<size_t>(width) * 4, nextPixels.data);
+
+                pixels = nextPixels;
+                width = NextMipDimension(width);
+                height = NextMipDimension(height);
+            }
+        }
+    }
+} // SceneLoader
@@ -0,0 +1,244 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "MorphTargetBlender.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr uint32_t c_maxIncrementalUpdates = 64;
+
+    // pDest += weight * deltas. Sparse deltas only touch their own vertices.
+    static void AccumulateDeltas(const MorphTargetDeltas& deltas, float weight, size_t vertexCount, float* pDest)
+    {
+        const Vec4 w = Vec4::Splat(weight);
+
+        if (deltas.isSparse)
+        {
+            const float* pValue = deltas.values.data();
+
+            // Adds zero to the x of the next vertex, which is why the destination is padded.
+            for (uint32_t index : deltas.indices)
+            {
+                float* p = pDest + index * 3;
+                MultiplyAdd(w, Vec4::Load(pValue), Vec4::Load(p)).Store(p);
+                pValue += 4;
+            }
+
+            return;
+        }
+
+        const float* pValue = deltas.values.data();
+        const size_t count = vertexCount * 3;
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+        {
+            MultiplyAdd(w, Vec4::Load(pValue + i), Vec4::Load(pDest + i)).Store(pDest + i);
+            MultiplyAdd(w, Vec4::Load(pValue + i + 4), Vec4::Load(pDest + i + 4)).Store(pDest + i + 4);
+            MultiplyAdd(w, Vec4::Load(pValue + i + 8), Vec4::Load(pDest + i + 8)).Store(pDest + i + 8);
+            MultiplyAdd(w, Vec4::Load(pValue + i + 12), Vec4::Load(pDest + i + 12)).Store(pDest + i + 12);
+        }
+
+        for (; i + 4 <= count; i += 4)
+        {
+            MultiplyAdd(w, Vec4::Load(pValue + i), Vec4::Load(pDest + i)).Store(pDest + i);
+        }
+
+        for (; i < count; ++i)
+        {
+            pDest[i] += weight * pValue[i];
+        }
+    }
+
+    MorphTargetDeltas MorphTargetDeltas::Dense(const float* pValues, size_t vertexCount)
+    {
+        MorphTargetDeltas deltas;
+        deltas.values.assign(pValues, pValues + vertexCount * 3);
+        return deltas;
+    }
+
+    MorphTargetDeltas MorphTargetDeltas::Sparse(const uint32_t* pIndices, const float* pValues, size_t count)
+    {
+        MorphTargetDeltas deltas;
+        deltas.isSparse = true;
+        deltas.indices.assign(pIndices, pIndices + count);
+        deltas.values.resize(count * 4);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            deltas.values[i * 4 + 0] = pValues[i * 3 + 0];
+            deltas.values[i * 4 + 1] = pValues[i * 3 + 1];
+            deltas.values[i * 4 + 2] = pValues[i * 3 + 2];
+            deltas.values[i * 4 + 3] = 0.0f;
+        }
+
+        return deltas;
+    }
+
+    MorphTargetBlender::MorphTargetBlender(const float* basePositions, const float* baseNormals, size_t vertexCount) :
+        m_vertexCount(vertexCount),
+        m_basePositions(basePositions, basePositions + vertexCount * 3)
+    {
+        m_positions.resize(vertexCount * 3 + 1);
+
+        if (baseNormals)
+        {
+            m_baseNormals.assign(baseNormals, baseNormals + vertexCount * 3);
+            m_normalSums.resize(vertexCount * 3 + 1);
+            m_normals.resize(vertexCount * 3);
+        }
+
+        BlendAll();
+    }
+
+    void MorphTargetBlender::AddTarget(MorphTargetDeltas positions, MorphTargetDeltas normals)
+    {
+        Target target;
+        target.positions = move(positions);
+        target.normals = m_baseNormals.empty() ? MorphTargetDeltas::None() : move(normals);
+
+        m_targets.push_back(move(target));
+    }
+
+    MorphTargetBlender::Changes MorphTargetBlender::SetWeights(const float* weights, size_t weightCount)
+    {
+        Changes changes;
+
+        bool anyWeight = false;
+        size_t changedTargetCount = 0;
+
+        for (size_t t = 0; t < m_targets.size(); ++t)
+        {
+            const float weight = t < weightCount ? weights[t] : 0.0f;
+            anyWeight |= weight != 0.0f;
+
+            if (weight != m_targets[t].weight)
+            {
+                ++changedTargetCount;
+            }
+        }
+
+        if (changedTargetCount == 0)
+        {
+            return changes;
+        }
+
+        changes.positions = true;
+        changes.normals = !m_normals.empty();
+
+        if (!anyWeight || ++m_incrementalUpdateCount > c_maxIncrementalUpdates)
+        {
+            // Back at the base, or due for a rebuild: start over from exact values.
+            for (size_t t = 0; t < m_targets.size(); ++t)
+            {
+                m_targets[t].weight = t < weightCount ? weights[t] : 0.0f;
+            }
+
+            BlendAll();
+            return changes;
+        }
+
+        // Only add the difference that each changed target makes.
+        vector<const MorphTargetDeltas*> changedNormals;
+        bool touchesAllNormals = false;
+
+        for (size_t t = 0; t < m_targets.size(); ++t)
+        {
+            Target& target = m_targets[t];
+            const float weight = t < weightCount ? weights[t] : 0.0f;
+            const float weightChange = weight - target.weight;
+
+            if (weightChange == 0.0f)
+            {
+                continue;
+            }
+
+            target.weight = weight;
+
+            AccumulateDeltas(target.positions, weightChange, m_vertexCount, m_positions.data());
+
+            if (!m_normals.empty())
+            {
+                AccumulateDeltas(target.normals, weightChange, m_vertexCount, m_normalSums.data());
+                touchesAllNormals |= !target.normals.isSparse;
+                changedNormals.push_back(&target.normals);
+            }
+        }
+
+        if (m_normals.empty())
+        {
+            return changes;
+        }
+
+        if (touchesAllNormals)
+        {
+            for (size_t vertex = 0; vertex < m_vertexCount; ++vertex)
+            {
+                Renormalize(vertex);
+            }
+        }
+        else
+        {
+            for (const MorphTargetDeltas* pDeltas : changedNormals)
+            {
+                for (uint32_t vertex : pDeltas->indices)
+                {
+                    Renormalize(vertex);
+                }
+            }
+        }
+
+        return changes;
+    }
+
+    void MorphTargetBlender::BlendAll()
+    {
+        m_incrementalUpdateCount = 0;
+
+        copy(m_basePositions.begin(), m_basePositions.end(), m_positions.begin());
+
+        if (!m_normals.empty())
+        {
+            copy(m_baseNormals.begin(), m_baseNormals.end(), m_normalSums.begin());
+        }
+
+        for (const auto& target : m_targets)
+        {
+            if (target.weight == 0.0f)
+            {
+                continue;
+            }
+
+            AccumulateDeltas(target.positions, target.weight, m_vertexCount, m_positions.data());
+
+            if (!m_normals.empty())
+            {
+                AccumulateDeltas(target.normals, target.weight, m_vertexCount, m_normalSums.data());
+            }
+        }
+
+        for (size_t vertex = 0; vertex < m_normals.size() / 3; ++vertex)
+        {
+            Renormalize(vertex);
+        }
+    }
+
+    void MorphTargetBlender::Renormalize(size_t vertex)
+    {
+        const float* pSum = m_normalSums.data() + vertex * 3;
+        float* pNormal = m_normals.data() + vertex * 3;
+
+        const float lengthSquared = pSum[0] * pSum[0] + pSum[1] * pSum[1] + pSum[2] * pSum[2];
+        const float scale = 1.0f / sqrtf(max(lengthSquared, 1e-30f));
+
+        pNormal[0] = pSum[0] * scale;
+        pNormal[1] = pSum[1] * scale;
+        pNormal[2] = pSum[2] * scale;
+    }
+} // SceneLoader
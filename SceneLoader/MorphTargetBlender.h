@@ -0,0 +1,83 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Per-vertex xyz deltas of one attribute of one morph target. Dense deltas have an
+    // entry for every vertex; sparse ones only for the vertices in indices.
+    struct MorphTargetDeltas
+    {
+        bool isSparse = false;
+        std::vector<uint32_t> indices;
+
+        // Dense: 3 floats per vertex. Sparse: 4 floats per index, the last one zero, so
+        // that a delta can be added with a single Vec4.
+        std::vector<float> values;
+
+        static MorphTargetDeltas Dense(const float* pValues, size_t vertexCount);
+        static MorphTargetDeltas Sparse(const uint32_t* pIndices, const float* pValues, size_t count);
+
+        // A target that leaves this attribute alone.
+        static MorphTargetDeltas None() { return Sparse(nullptr, nullptr, 0); }
+    };
+
+    // Blends the morph targets of one primitive on the CPU and keeps the result, so that
+    // later weight changes only redo the work for the targets whose weight changed.
+    class MorphTargetBlender
+    {
+    public:
+        // baseNormals may be null.
+        MorphTargetBlender(const float* basePositions, const float* baseNormals, size_t vertexCount);
+
+        // Dense deltas must have VertexCount entries. Normal deltas are ignored when the
+        // primitive has no normals.
+        void AddTarget(MorphTargetDeltas positions, MorphTargetDeltas normals);
+
+        size_t TargetCount() const { return m_targets.size(); }
+        size_t VertexCount() const { return m_vertexCount; }
+
+        struct Changes
+        {
+            bool positions = false;
+            bool normals = false;
+        };
+
+        // Targets past weightCount get a weight of zero. Returns which outputs changed.
+        Changes SetWeights(const float* weights, size_t weightCount);
+
+        // Packed xyz, vertexCount entries. Normals is null if the primitive has none.
+        const float* Positions() const { return m_positions.data(); }
+        const float* Normals() const { return m_normals.empty() ? nullptr : m_normals.data(); }
+
+    private:
+        struct Target
+        {
+            MorphTargetDeltas positions;
+            MorphTargetDeltas normals;
+            float weight = 0.0f;
+        };
+
+        // Recomputes everything from the base, skipping zero-weight targets.
+        void BlendAll();
+
+        void Renormalize(size_t vertex);
+
+        size_t m_vertexCount;
+        std::vector<Target> m_targets;
+
+        std::vector<float> m_basePositions;
+        std::vector<float> m_baseNormals;
+
+        // One float of padding at the end of each for the Vec4 that sparse deltas add.
+        std::vector<float> m_positions;
+        std::vector<float> m_normalSums;
+
+        std::vector<float> m_normals;
+
+        // Incremental updates accumulate rounding error; start over after this many.
+        uint32_t m_incrementalUpdateCount = 0;
+    };
+} // SceneLoader
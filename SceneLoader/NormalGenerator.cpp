@@ -0,0 +1,404 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "NormalGenerator.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    // The triangle kernels work on four triangles, or four vertices, at a time: one
+    // vector per lane, one Vec4 per component.
+    struct Vec3x4
+    {
+        Vec4 x;
+        Vec4 y;
+        Vec4 z;
+    };
+
+    static inline Vec3x4 operator-(const Vec3x4& a, const Vec3x4& b)
+    {
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    static inline Vec3x4 operator*(const Vec3x4& a, Vec4 s)
+    {
+        return { a.x * s, a.y * s, a.z * s };
+    }
+
+    static inline Vec4 Dot(const Vec3x4& a, const Vec3x4& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    static inline Vec3x4 Cross(const Vec3x4& a, const Vec3x4& b)
+    {
+        return {
+            a.y * b.z - a.z * b.y,
+            a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x,
+        };
+    }
+
+    // Zero stays zero, and so does anything too short to have a direction.
+    static inline Vec3x4 Normalize(const Vec3x4& a)
+    {
+        const Vec4 length = Max(Sqrt(Dot(a, a)), Vec4::Splat(FLT_MIN));
+        return { a.x / length, a.y / length, a.z / length };
+    }
+
+    static inline Vec3x4 Gather3(const float* p, const uint32_t* elements)
+    {
+        return {
+            Vec4::Set(p[elements[0] * 3 + 0], p[elements[1] * 3 + 0], p[elements[2] * 3 + 0], p[elements[3] * 3 + 0]),
+            Vec4::Set(p[elements[0] * 3 + 1], p[elements[1] * 3 + 1], p[elements[2] * 3 + 1], p[elements[3] * 3 + 1]),
+            Vec4::Set(p[elements[0] * 3 + 2], p[elements[1] * 3 + 2], p[elements[2] * 3 + 2], p[elements[3] * 3 + 2]),
+        };
+    }
+
+    static inline void Store(const Vec3x4& a, float (*pComponents)[4])
+    {
+        a.x.Store(pComponents[0]);
+        a.y.Store(pComponents[1]);
+        a.z.Store(pComponents[2]);
+    }
+
+    // Vertex indices of the corners of triangles [first, first + 4). Lanes past the last
+    // triangle repeat it; their results are ignored.
+    static inline void GetCorners(const uint16_t* indices, size_t triangleCount, size_t first, uint32_t (*pCorners)[4])
+    {
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            const size_t triangle = min(first + lane, triangleCount - 1);
+
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                pCorners[corner][lane] = indices ? indices[triangle * 3 + corner] : static_cast<uint32_t>(triangle * 3 + corner);
+            }
+        }
+    }
+
+    // A normalized vector is stored as is; anything that was too short to normalize is
+    // replaced by the fallback.
+    static inline void StoreUnitOr(const float (*pComponents)[4], size_t lane, const float* fallback, float* pDestination)
+    {
+        const float x = pComponents[0][lane];
+        const float y = pComponents[1][lane];
+        const float z = pComponents[2][lane];
+
+        if (x * x + y * y + z * z > 0.5f)
+        {
+            pDestination[0] = x;
+            pDestination[1] = y;
+            pDestination[2] = z;
+        }
+        else
+        {
+            pDestination[0] = fallback[0];
+            pDestination[1] = fallback[1];
+            pDestination[2] = fallback[2];
+        }
+    }
+
+    static const float c_defaultNormal[3] = { 0.0f, 0.0f, 1.0f };
+
+    void GenerateFlatNormals(const float* positions, size_t vertexCount, float* normals)
+    {
+        const size_t triangleCount = vertexCount / 3;
+
+        for (size_t first = 0; first < triangleCount; first += 4)
+        {
+            uint32_t corners[3][4];
+            GetCorners(nullptr, triangleCount, first, corners);
+
+            const Vec3x4 p0 = Gather3(positions, corners[0]);
+            const Vec3x4 p1 = Gather3(positions, corners[1]);
+            const Vec3x4 p2 = Gather3(positions, corners[2]);
+
+            float faceNormals[3][4];
+            Store(Normalize(Cross(p1 - p0, p2 - p0)), faceNormals);
+
+            for (size_t lane = 0; lane < min<size_t>(4, triangleCount - first); ++lane)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    StoreUnitOr(faceNormals, lane, c_defaultNormal, normals + corners[corner][lane] * 3);
+                }
+            }
+        }
+
+        // Vertices that don't make up a whole triangle.
+        for (size_t vertex = triangleCount * 3; vertex < vertexCount; ++vertex)
+        {
+            memcpy(normals + vertex * 3, c_defaultNormal, sizeof(c_defaultNormal));
+        }
+    }
+
+    struct PositionKey
+    {
+        uint32_t bits[3];
+
+        bool operator==(const PositionKey& other) const
+        {
+            return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+        }
+    };
+
+    struct PositionKeyHash
+    {
+        size_t operator()(const PositionKey& key) const
+        {
+            return (static_cast<size_t>(key.bits[0]) * 73856093u) ^ (static_cast<size_t>(key.bits[1]) * 19349663u) ^ (static_cast<size_t>(key.bits[2]) * 83492791u);
+        }
+    };
+
+    void GenerateSmoothNormals(
+        const float* positions,
+        size_t vertexCount,
+        const uint16_t* indices,
+        size_t indexCount,
+        float* normals)
+    {
+        // The first vertex at each position collects the triangles of all of them.
+        vector<uint32_t> welded(vertexCount);
+        unordered_map<PositionKey, uint32_t, PositionKeyHash> firstAtPosition;
+        firstAtPosition.reserve(vertexCount);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            PositionKey key;
+
+            for (size_t component = 0; component < 3; ++component)
+            {
+                // -0 and +0 weld.
+                const float value = (positions[vertex * 3 + component] == 0.0f) ? 0.0f : positions[vertex * 3 + component];
+                memcpy(&key.bits[component], &value, sizeof(value));
+            }
+
+            welded[vertex] = firstAtPosition.emplace(key, static_cast<uint32_t>(vertex)).first->second;
+        }
+
+        // The cross product is twice the area of the triangle, which is the weight.
+        vector<float> sums(vertexCount * 3, 0.0f);
+        const size_t triangleCount = indexCount / 3;
+
+        for (size_t first = 0; first < triangleCount; first += 4)
+        {
+            uint32_t corners[3][4];
+            GetCorners(indices, triangleCount, first, corners);
+
+            const Vec3x4 p0 = Gather3(positions, corners[0]);
+            const Vec3x4 p1 = Gather3(positions, corners[1]);
+            const Vec3x4 p2 = Gather3(positions, corners[2]);
+
+            float faceNormals[3][4];
+            Store(Cross(p1 - p0, p2 - p0), faceNormals);
+
+            for (size_t lane = 0; lane < min<size_t>(4, triangleCount - first); ++lane)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    float* pSum = sums.data() + welded[corners[corner][lane]] * 3;
+
+                    pSum[0] += faceNormals[0][lane];
+                    pSum[1] += faceNormals[1][lane];
+                    pSum[2] += faceNormals[2][lane];
+                }
+            }
+        }
+
+        for (size_t first = 0; first < vertexCount; first += 4)
+        {
+            uint32_t sources[4];
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                sources[lane] = welded[min(first + lane, vertexCount - 1)];
+            }
+
+            float vertexNormals[3][4];
+            Store(Normalize(Gather3(sums.data(), sources)), vertexNormals);
+
+            for (size_t lane = 0; lane < min<size_t>(4, vertexCount - first); ++lane)
+            {
+                StoreUnitOr(vertexNormals, lane, c_defaultNormal, normals + (first + lane) * 3);
+            }
+        }
+    }
+
+    // Angle between the edges from the corner p to a and to b.
+    static float GetCornerAngle(const float* p, const float* a, const float* b)
+    {
+        const float e0[3] = { a[0] - p[0], a[1] - p[1], a[2] - p[2] };
+        const float e1[3] = { b[0] - p[0], b[1] - p[1], b[2] - p[2] };
+
+        const float lengths = sqrtf((e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]) * (e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]));
+
+        if (!(lengths > 0.0f))
+        {
+            return 0.0f;
+        }
+
+        const float cosine = (e0[0] * e1[0] + e0[1] * e1[1] + e0[2] * e1[2]) / lengths;
+
+        return acosf(max(-1.0f, min(1.0f, cosine)));
+    }
+
+    // Any unit vector perpendicular to the unit vector n.
+    static void GetPerpendicular(const float* n, float* pResult)
+    {
+        // Cross with the axis n is least aligned with.
+        const float axis[3] = { fabsf(n[0]) < 0.9f ? 1.0f : 0.0f, fabsf(n[0]) < 0.9f ? 0.0f : 1.0f, 0.0f };
+
+        float x = n[1] * axis[2] - n[2] * axis[1];
+        float y = n[2] * axis[0] - n[0] * axis[2];
+        float z = n[0] * axis[1] - n[1] * axis[0];
+
+        const float length = sqrtf(x * x + y * y + z * z);
+
+        if (!(length > 0.0f))
+        {
+            // n itself is zero.
+            pResult[0] = 1.0f;
+            pResult[1] = 0.0f;
+            pResult[2] = 0.0f;
+            return;
+        }
+
+        pResult[0] = x / length;
+        pResult[1] = y / length;
+        pResult[2] = z / length;
+    }
+
+    void GenerateTangents(
+        const float* positions,
+        const float* normals,
+        const float* texCoords,
+        size_t vertexCount,
+        const uint16_t* indices,
+        size_t indexCount,
+        float* tangents)
+    {
+        vector<float> sums(vertexCount * 3, 0.0f);
+        vector<float> handedness(vertexCount, 0.0f);
+
+        const size_t triangleCount = indexCount / 3;
+
+        for (size_t first = 0; first < triangleCount; first += 4)
+        {
+            uint32_t corners[3][4];
+            GetCorners(indices, triangleCount, first, corners);
+
+            const Vec3x4 p0 = Gather3(positions, corners[0]);
+            const Vec3x4 e1 = Gather3(positions, corners[1]) - p0;
+            const Vec3x4 e2 = Gather3(positions, corners[2]) - p0;
+
+            Vec4 u[3];
+            Vec4 v[3];
+
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t* c = corners[corner];
+
+                u[corner] = Vec4::Set(texCoords[c[0] * 2], texCoords[c[1] * 2], texCoords[c[2] * 2], texCoords[c[3] * 2]);
+                v[corner] = Vec4::Set(texCoords[c[0] * 2 + 1], texCoords[c[1] * 2 + 1], texCoords[c[2] * 2 + 1], texCoords[c[3] * 2 + 1]);
+            }
+
+            const Vec4 du1 = u[1] - u[0];
+            const Vec4 dv1 = v[1] - v[0];
+            const Vec4 du2 = u[2] - u[0];
+            const Vec4 dv2 = v[2] - v[0];
+
+            // dP/dU scaled by the signed area of the triangle in texture space.
+            const Vec3x4 scaledTangent = e1 * dv2 - e2 * dv1;
+            const Vec4 area = du1 * dv2 - du2 * dv1;
+
+            float faceTangents[3][4];
+            float areas[4];
+
+            Store(Normalize(scaledTangent), faceTangents);
+            area.Store(areas);
+
+            for (size_t lane = 0; lane < min<size_t>(4, triangleCount - first); ++lane)
+            {
+                // No texture space, no tangent.
+                if (areas[lane] == 0.0f)
+                {
+                    continue;
+                }
+
+                // Unscaling by the area flips the tangent of mirrored triangles back to +U.
+                const float sign = (areas[lane] > 0.0f) ? 1.0f : -1.0f;
+                const float faceTangent[3] = { faceTangents[0][lane] * sign, faceTangents[1][lane] * sign, faceTangents[2][lane] * sign };
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertex = corners[corner][lane];
+                    const float* n = normals + vertex * 3;
+
+                    // In the plane of the vertex normal.
+                    const float d = n[0] * faceTangent[0] + n[1] * faceTangent[1] + n[2] * faceTangent[2];
+                    float t[3] = { faceTangent[0] - n[0] * d, faceTangent[1] - n[1] * d, faceTangent[2] - n[2] * d };
+
+                    const float length = sqrtf(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+
+                    if (!(length > 0.0f))
+                    {
+                        continue;
+                    }
+
+                    const float weight = GetCornerAngle(
+                        positions + vertex * 3,
+                        positions + corners[(corner + 1) % 3][lane] * 3,
+                        positions + corners[(corner + 2) % 3][lane] * 3);
+
+                    float* pSum = sums.data() + vertex * 3;
+
+                    pSum[0] += t[0] / length * weight;
+                    pSum[1] += t[1] / length * weight;
+                    pSum[2] += t[2] / length * weight;
+
+                    handedness[vertex] += sign * weight;
+                }
+            }
+        }
+
+        for (size_t first = 0; first < vertexCount; first += 4)
+        {
+            uint32_t vertices[4];
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                vertices[lane] = static_cast<uint32_t>(min(first + lane, vertexCount - 1));
+            }
+
+            // Orthogonalize once more, the averaged tangent drifts off the plane.
+            const Vec3x4 n = Gather3(normals, vertices);
+            const Vec3x4 t = Gather3(sums.data(), vertices);
+
+            float vertexTangents[3][4];
+            Store(Normalize(t - n * Dot(n, t)), vertexTangents);
+
+            for (size_t lane = 0; lane < min<size_t>(4, vertexCount - first); ++lane)
+            {
+                const size_t vertex = first + lane;
+                float* pTangent = tangents + vertex * 4;
+
+                pTangent[0] = vertexTangents[0][lane];
+                pTangent[1] = vertexTangents[1][lane];
+                pTangent[2] = vertexTangents[2][lane];
+
+                if (pTangent[0] * pTangent[0] + pTangent[1] * pTangent[1] + pTangent[2] * pTangent[2] < 0.5f)
+                {
+                    GetPerpendicular(normals + vertex * 3, pTangent);
+                }
+
+                pTangent[3] = (handedness[vertex] < 0.0f) ? -1.0f : 1.0f;
+            }
+        }
+    }
+} // SceneLoader
@@ -0,0 +1,41 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Generate the NORMAL and TANGENT attributes that glTF leaves to the client when a
+    // primitive has none. Positions and normals are packed xyz, texture coordinates uv and
+    // tangents xyzw, with the handedness in w. Indices describe a triangle list and must be
+    // less than vertexCount; null indices mean 0, 1, 2, ...
+    //
+    // Degenerate triangles contribute nothing. A vertex that ends up without a direction
+    // gets +Z as its normal, and as its tangent any unit vector perpendicular to its normal.
+
+    // One normal per triangle, for a triangle list without shared vertices.
+    void GenerateFlatNormals(const float* positions, size_t vertexCount, float* normals);
+
+    // Area-weighted average of the normals of the triangles around each vertex. Vertices at
+    // the same position are smoothed together, so seams in the texture coordinates stay smooth.
+    void GenerateSmoothNormals(
+        const float* positions,
+        size_t vertexCount,
+        const uint16_t* indices,
+        size_t indexCount,
+        float* normals);
+
+    // Tangents along +U, as MikkTSpace computes them for vertices it doesn't split: the
+    // per-triangle tangents are projected onto the plane of the vertex normal and averaged
+    // with the corner angles as weights. The handedness follows the orientation of the
+    // texture coordinates.
+    void GenerateTangents(
+        const float* positions,
+        const float* normals,
+        const float* texCoords,
+        size_t vertexCount,
+        const uint16_t* indices,
+        size_t indexCount,
+        float* tangents);
+} // SceneLoader
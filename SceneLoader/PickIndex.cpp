@@ -0,0 +1,865 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "PickIndex.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    // Leaves hold a pack of triangles, or this many instances.
+    static constexpr uint32_t c_leafSize = 4;
+
+    // Centroids are sorted into this many bins along each axis to find the split of least
+    // SAH cost.
+    static constexpr size_t c_binCount = 16;
+
+    // Ranges of at least this many boxes build their two halves in parallel.
+    static constexpr uint32_t c_parallelBuildCount = 4096;
+
+    // Deeper ranges are split in half instead, so no hierarchy is deeper than this plus 32,
+    // which bounds the stack of a traversal.
+    static constexpr size_t c_maxSahDepth = 64;
+    static constexpr size_t c_maxStackSize = 3 * (c_maxSahDepth + 32) + 4;
+
+    // Boxes are entered a little further along the ray, so that rounding can't miss a
+    // triangle that lies on a face of its box.
+    static constexpr float c_boxSlack = 1.0f + 4.0f * FLT_EPSILON;
+
+    // Smaller direction components are taken as this, so that a ray in the plane of a face
+    // gives no zero times infinity.
+    static constexpr float c_minDirection = 1e-30f;
+
+    static void AddPoint(BoundingBox* pBox, const float* point)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            pBox->min[axis] = min(pBox->min[axis], point[axis]);
+            pBox->max[axis] = max(pBox->max[axis], point[axis]);
+        }
+    }
+
+    static float HalfArea(const BoundingBox& box)
+    {
+        const float x = box.max[0] - box.min[0];
+        const float y = box.max[1] - box.min[1];
+        const float z = box.max[2] - box.min[2];
+
+        return x * y + y * z + z * x;
+    }
+
+    // A point through a float4x4 for row vectors.
+    static void TransformPoint(const float* matrix, const float* point, float* pResult)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            pResult[axis] = point[0] * matrix[axis] + point[1] * matrix[4 + axis] + point[2] * matrix[8 + axis] + matrix[12 + axis];
+        }
+    }
+
+    // Inverts a float4x4 for row vectors whose last column is that of an affine transform.
+    // Returns false for one that flattens space.
+    static bool InvertAffine(const float* m, float (*pInverse)[3])
+    {
+        const float a = m[0], b = m[1], c = m[2];
+        const float d = m[4], e = m[5], f = m[6];
+        const float g = m[8], h = m[9], i = m[10];
+
+        const float determinant = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+
+        if (!(fabsf(determinant) > FLT_MIN) || !isfinite(determinant))
+        {
+            return false;
+        }
+
+        const float s = 1.0f / determinant;
+
+        pInverse[0][0] = (e * i - f * h) * s;
+        pInverse[0][1] = (c * h - b * i) * s;
+        pInverse[0][2] = (b * f - c * e) * s;
+        pInverse[1][0] = (f * g - d * i) * s;
+        pInverse[1][1] = (a * i - c * g) * s;
+        pInverse[1][2] = (c * d - a * f) * s;
+        pInverse[2][0] = (d * h - e * g) * s;
+        pInverse[2][1] = (b * g - a * h) * s;
+        pInverse[2][2] = (a * e - b * d) * s;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            pInverse[3][axis] = -(m[12] * pInverse[0][axis] + m[13] * pInverse[1][axis] + m[14] * pInverse[2][axis]);
+        }
+
+        return true;
+    }
+
+    //
+    // Building
+    //
+
+    // A node of the binary tree a hierarchy is built as first. Leaves have a count.
+    struct BinaryNode
+    {
+        BoundingBox box;
+        uint32_t children[2];
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Nodes are allocated from the front of a vector large enough for any tree over the
+    // boxes, so the halves of a range can be built at the same time.
+    struct BinaryBuild
+    {
+        const BoundingBox* boxes;
+        vector<float> centroids;
+        vector<uint32_t> order;
+        vector<BinaryNode> nodes;
+        atomic<uint32_t> nodeCount{ 0 };
+    };
+
+    // Partitions the range at the bin boundary of least SAH cost. Returns nullptr when no
+    // boundary has boxes on both sides.
+    static uint32_t* PartitionBySah(BinaryBuild& build, uint32_t* begin, uint32_t* end, const BoundingBox& centroidBox)
+    {
+        struct Bin
+        {
+            BoundingBox box;
+            uint32_t count = 0;
+        };
+
+        Bin bins[3][c_binCount];
+        float scales[3];
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float extent = centroidBox.max[axis] - centroidBox.min[axis];
+            scales[axis] = (extent > 0.0f) ? c_binCount / extent : 0.0f;
+        }
+
+        auto binOf = [&](uint32_t box, int axis)
+        {
+            const size_t bin = static_cast<size_t>((build.centroids[box * 3 + axis] - centroidBox.min[axis]) * scales[axis]);
+            return min(bin, c_binCount - 1);
+        };
+
+        for (const uint32_t* p = begin; p != end; ++p)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                Bin& bin = bins[axis][binOf(*p, axis)];
+                bin.box.Add(build.boxes[*p]);
+                bin.count++;
+            }
+        }
+
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        size_t bestBin = 0;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (scales[axis] == 0.0f)
+            {
+                continue;
+            }
+
+            // Boundary b has bins [0, b) on the left and [b, c_binCount) on the right.
+            float rightCosts[c_binCount] = {};
+            uint32_t rightCounts[c_binCount] = {};
+            BoundingBox right;
+            uint32_t rightCount = 0;
+
+            for (size_t b = c_binCount - 1; b > 0; --b)
+            {
+                right.Add(bins[axis][b].box);
+                rightCount += bins[axis][b].count;
+                rightCounts[b] = rightCount;
+                rightCosts[b] = rightCount > 0 ? HalfArea(right) * rightCount : 0.0f;
+            }
+
+            BoundingBox left;
+            uint32_t leftCount = 0;
+
+            for (size_t b = 1; b < c_binCount; ++b)
+            {
+                left.Add(bins[axis][b - 1].box);
+                leftCount += bins[axis][b - 1].count;
+
+                if (leftCount == 0 || rightCounts[b] == 0)
+                {
+                    continue;
+                }
+
+                const float cost = HalfArea(left) * leftCount + rightCosts[b];
+
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b;
+                }
+            }
+        }
+
+        if (bestAxis < 0)
+        {
+            return nullptr;
+        }
+
+        return partition(begin, end, [&](uint32_t box) { return binOf(box, bestAxis) < bestBin; });
+    }
+
+    static uint32_t BuildBinaryNode(BinaryBuild& build, uint32_t first, uint32_t count, size_t depth)
+    {
+        const uint32_t index = build.nodeCount++;
+        BinaryNode& node = build.nodes[index];
+
+        uint32_t* begin = build.order.data() + first;
+        uint32_t* end = begin + count;
+
+        BoundingBox centroidBox;
+
+        for (const uint32_t* p = begin; p != end; ++p)
+        {
+            node.box.Add(build.boxes[*p]);
+            AddPoint(&centroidBox, &build.centroids[*p * 3]);
+        }
+
+        if (count <= c_leafSize)
+        {
+            node.first = first;
+            node.count = count;
+            return index;
+        }
+
+        uint32_t* middle = (depth < c_maxSahDepth) ? PartitionBySah(build, begin, end, centroidBox) : nullptr;
+
+        // Boxes on top of each other, or a range too deep. Halving it along the longest side
+        // of the centroids always splits it.
+        if (!middle)
+        {
+            int axis = 0;
+
+            for (int a = 1; a < 3; ++a)
+            {
+                if (centroidBox.max[a] - centroidBox.min[a] > centroidBox.max[axis] - centroidBox.min[axis])
+                {
+                    axis = a;
+                }
+            }
+
+            middle = begin + count / 2;
+
+            nth_element(begin, middle, end, [&](uint32_t a, uint32_t b)
+            {
+                return build.centroids[a * 3 + axis] < build.centroids[b * 3 + axis];
+            });
+        }
+
+        const uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+        uint32_t left = 0;
+        uint32_t right = 0;
+
+        if (count >= c_parallelBuildCount)
+        {
+            concurrency::parallel_invoke(
+                [&] { left = BuildBinaryNode(build, first, leftCount, depth + 1); },
+                [&] { right = BuildBinaryNode(build, first + leftCount, count - leftCount, depth + 1); });
+        }
+        else
+        {
+            left = BuildBinaryNode(build, first, leftCount, depth + 1);
+            right = BuildBinaryNode(build, first + leftCount, count - leftCount, depth + 1);
+        }
+
+        node.children[0] = left;
+        node.children[1] = right;
+        node.first = 0;
+        node.count = 0;
+
+        return index;
+    }
+
+    // Makes a node of four out of the binary node and the inner nodes below it with the
+    // largest boxes.
+    static int32_t CollapseNode(const BinaryBuild& build, uint32_t binaryIndex, vector<PickBvhNode>* pNodes, vector<pair<uint32_t, uint32_t>>* pLeaves)
+    {
+        uint32_t slots[4];
+        size_t slotCount = 0;
+
+        const BinaryNode& binary = build.nodes[binaryIndex];
+
+        if (binary.count > 0)
+        {
+            slots[slotCount++] = binaryIndex;
+        }
+        else
+        {
+            slots[slotCount++] = binary.children[0];
+            slots[slotCount++] = binary.children[1];
+
+            while (slotCount < 4)
+            {
+                size_t widest = SIZE_MAX;
+                float widestArea = -1.0f;
+
+                for (size_t s = 0; s < slotCount; ++s)
+                {
+                    const BinaryNode& child = build.nodes[slots[s]];
+
+                    if (child.count == 0 && HalfArea(child.box) > widestArea)
+                    {
+                        widest = s;
+                        widestArea = HalfArea(child.box);
+                    }
+                }
+
+                if (widest == SIZE_MAX)
+                {
+                    break;
+                }
+
+                const BinaryNode& opened = build.nodes[slots[widest]];
+                slots[widest] = opened.children[0];
+                slots[slotCount++] = opened.children[1];
+            }
+        }
+
+        const size_t nodeIndex = pNodes->size();
+        pNodes->emplace_back();
+
+        PickBvhNode node = {};
+
+        for (size_t s = 0; s < 4; ++s)
+        {
+            if (s >= slotCount)
+            {
+                node.children[s] = c_emptyPickChild;
+                continue;
+            }
+
+            const BinaryNode& child = build.nodes[slots[s]];
+
+            node.minX[s] = child.box.min[0];
+            node.minY[s] = child.box.min[1];
+            node.minZ[s] = child.box.min[2];
+            node.maxX[s] = child.box.max[0];
+            node.maxY[s] = child.box.max[1];
+            node.maxZ[s] = child.box.max[2];
+
+            if (child.count > 0)
+            {
+                node.children[s] = ~static_cast<int32_t>(pLeaves->size());
+                pLeaves->emplace_back(child.first, child.count);
+            }
+            else
+            {
+                node.children[s] = CollapseNode(build, slots[s], pNodes, pLeaves);
+            }
+        }
+
+        (*pNodes)[nodeIndex] = node;
+
+        return static_cast<int32_t>(nodeIndex);
+    }
+
+    // A hierarchy over boxes. Leaves are ranges of pOrder, which lists the boxes in the order
+    // the leaves have them.
+    static void BuildHierarchy(const vector<BoundingBox>& boxes, vector<PickBvhNode>* pNodes, vector<pair<uint32_t, uint32_t>>* pLeaves, vector<uint32_t>* pOrder)
+    {
+        const uint32_t count = static_cast<uint32_t>(boxes.size());
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        BinaryBuild build;
+        build.boxes = boxes.data();
+        build.centroids.resize(size_t(count) * 3);
+        build.order.resize(count);
+        build.nodes.resize(size_t(count) * 2 - 1);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                build.centroids[size_t(i) * 3 + axis] = (boxes[i].min[axis] + boxes[i].max[axis]) * 0.5f;
+            }
+
+            build.order[i] = i;
+        }
+
+        BuildBinaryNode(build, 0, count, 0);
+
+        pNodes->reserve(build.nodeCount / 2 + 1);
+        CollapseNode(build, 0, pNodes, pLeaves);
+
+        *pOrder = move(build.order);
+    }
+
+    // Nine floats per triangle.
+    static PickMesh BuildMesh(const vector<float>& vertices, const vector<uint32_t>& triangles, const vector<uint32_t>& draws)
+    {
+        PickMesh mesh;
+        vector<BoundingBox> boxes(triangles.size());
+
+        for (size_t t = 0; t < boxes.size(); ++t)
+        {
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                AddPoint(&boxes[t], &vertices[t * 9 + corner * 3]);
+            }
+
+            mesh.box.Add(boxes[t]);
+        }
+
+        vector<pair<uint32_t, uint32_t>> leaves;
+        vector<uint32_t> order;
+
+        BuildHierarchy(boxes, &mesh.nodes, &leaves, &order);
+
+        mesh.packs.resize(leaves.size());
+
+        for (size_t l = 0; l < leaves.size(); ++l)
+        {
+            PickTrianglePack& pack = mesh.packs[l];
+
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                const uint32_t t = order[leaves[l].first + min(lane, leaves[l].second - 1)];
+                const float* v = &vertices[size_t(t) * 9];
+
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    pack.v0[axis][lane] = v[axis];
+                    pack.edge1[axis][lane] = v[3 + axis] - v[axis];
+                    pack.edge2[axis][lane] = v[6 + axis] - v[axis];
+                }
+
+                pack.triangles[lane] = triangles[t];
+                pack.draws[lane] = draws[t];
+            }
+        }
+
+        return mesh;
+    }
+
+    void PickIndexBuilder::AddPrimitive(
+        const string& nodeId,
+        uint32_t primitiveIndex,
+        const float* positions,
+        size_t vertexCount,
+        const uint16_t* indices,
+        size_t indexCount,
+        const float* transforms,
+        size_t transformCount)
+    {
+        if (transformCount == 0)
+        {
+            return;
+        }
+
+        const uint32_t draw = static_cast<uint32_t>(m_draws.size());
+        m_draws.push_back({ nodeId, primitiveIndex });
+
+        // Instanced primitives stay in the space of their mesh.
+        const bool isInstanced = transformCount > 1;
+        const uint32_t soupIndex = isInstanced ? static_cast<uint32_t>(m_soups.size()) : 0;
+
+        if (isInstanced)
+        {
+            m_soups.emplace_back();
+        }
+
+        TriangleSoup& soup = m_soups[soupIndex];
+
+        const size_t triangleCount = (indices ? indexCount : vertexCount) / 3;
+        soup.vertices.reserve(soup.vertices.size() + triangleCount * 9);
+
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            float triangle[9];
+            bool isFinite = true;
+
+            for (size_t corner = 0; corner < 3 && isFinite; ++corner)
+            {
+                const size_t vertex = indices ? indices[t * 3 + corner] : t * 3 + corner;
+
+                if (vertex >= vertexCount)
+                {
+                    isFinite = false;
+                    break;
+                }
+
+                float* pCorner = triangle + corner * 3;
+
+                if (isInstanced)
+                {
+                    memcpy(pCorner, positions + vertex * 3, 3 * sizeof(float));
+                }
+                else
+                {
+                    TransformPoint(transforms, positions + vertex * 3, pCorner);
+                }
+
+                isFinite = isfinite(pCorner[0]) && isfinite(pCorner[1]) && isfinite(pCorner[2]);
+            }
+
+            if (!isFinite)
+            {
+                continue;
+            }
+
+            soup.vertices.insert(soup.vertices.end(), triangle, triangle + 9);
+            soup.triangles.push_back(static_cast<uint32_t>(t));
+            soup.draws.push_back(draw);
+        }
+
+        if (isInstanced)
+        {
+            for (size_t i = 0; i < transformCount; ++i)
+            {
+                MeshInstance instance;
+                instance.mesh = soupIndex;
+                instance.instanceIndex = static_cast<uint32_t>(i);
+                memcpy(instance.transform, transforms + i * 16, sizeof(instance.transform));
+
+                m_instances.push_back(instance);
+            }
+        }
+    }
+
+    shared_ptr<const PickIndex> PickIndexBuilder::Build()
+    {
+        auto index = make_shared<PickIndex>();
+        index->m_meshes.resize(m_soups.size());
+
+        concurrency::parallel_for(size_t(0), m_soups.size(), [&](size_t i)
+        {
+            index->m_meshes[i] = BuildMesh(m_soups[i].vertices, m_soups[i].triangles, m_soups[i].draws);
+        });
+
+        for (const auto& soup : m_soups)
+        {
+            index->m_triangleCount += soup.triangles.size();
+        }
+
+        m_soups.clear();
+
+        vector<PickInstance> instances;
+        vector<BoundingBox> boxes;
+
+        if (!index->m_meshes[0].packs.empty())
+        {
+            instances.push_back({ 0, 0, false, {} });
+            boxes.push_back(index->m_meshes[0].box);
+        }
+
+        for (const auto& meshInstance : m_instances)
+        {
+            const PickMesh& mesh = index->m_meshes[meshInstance.mesh];
+
+            PickInstance instance = { meshInstance.mesh, meshInstance.instanceIndex, true, {} };
+
+            // Instances scaled flat can't be hit.
+            if (mesh.packs.empty() || !InvertAffine(meshInstance.transform, instance.sceneToMesh))
+            {
+                continue;
+            }
+
+            BoundingBox box;
+
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                const float point[3] =
+                {
+                    (corner & 1) ? mesh.box.max[0] : mesh.box.min[0],
+                    (corner & 2) ? mesh.box.max[1] : mesh.box.min[1],
+                    (corner & 4) ? mesh.box.max[2] : mesh.box.min[2],
+                };
+
+                float transformed[3];
+                TransformPoint(meshInstance.transform, point, transformed);
+                AddPoint(&box, transformed);
+            }
+
+            if (!isfinite(HalfArea(box)))
+            {
+                continue;
+            }
+
+            instances.push_back(instance);
+            boxes.push_back(box);
+        }
+
+        vector<uint32_t> order;
+        BuildHierarchy(boxes, &index->m_instanceNodes, &index->m_instanceLeaves, &order);
+
+        index->m_instances.reserve(order.size());
+
+        for (uint32_t i : order)
+        {
+            index->m_instances.push_back(instances[i]);
+        }
+
+        index->m_draws = move(m_draws);
+        m_instances.clear();
+
+        return index;
+    }
+
+    //
+    // Picking
+    //
+
+    // A ray in every lane.
+    struct RayLanes
+    {
+        Vec4 origin[3];
+        Vec4 direction[3];
+        Vec4 inverseDirection[3];
+
+        RayLanes(const float* o, const float* d)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float nonZero = (fabsf(d[axis]) < c_minDirection) ? copysignf(c_minDirection, d[axis]) : d[axis];
+
+                origin[axis] = Vec4::Splat(o[axis]);
+                direction[axis] = Vec4::Splat(d[axis]);
+                inverseDirection[axis] = Vec4::Splat(1.0f / nonZero);
+            }
+        }
+    };
+
+    // Visits the leaves whose boxes the ray enters before *pClosest, nearest first. Visiting
+    // a leaf can make *pClosest shorter, which skips the leaves behind it.
+    template<typename VisitLeaf>
+    static void Traverse(const vector<PickBvhNode>& nodes, const RayLanes& ray, const float* pClosest, VisitLeaf&& visitLeaf)
+    {
+        if (nodes.empty())
+        {
+            return;
+        }
+
+        struct Entry
+        {
+            int32_t child;
+            float distance;
+        };
+
+        Entry stack[c_maxStackSize];
+        size_t stackSize = 0;
+
+        stack[stackSize++] = { 0, 0.0f };
+
+        while (stackSize > 0)
+        {
+            const Entry entry = stack[--stackSize];
+
+            if (entry.distance >= *pClosest)
+            {
+                continue;
+            }
+
+            if (entry.child < 0)
+            {
+                visitLeaf(static_cast<uint32_t>(~entry.child));
+                continue;
+            }
+
+            const PickBvhNode& node = nodes[entry.child];
+
+            const Vec4 x0 = (Vec4::Load(node.minX) - ray.origin[0]) * ray.inverseDirection[0];
+            const Vec4 x1 = (Vec4::Load(node.maxX) - ray.origin[0]) * ray.inverseDirection[0];
+            const Vec4 y0 = (Vec4::Load(node.minY) - ray.origin[1]) * ray.inverseDirection[1];
+            const Vec4 y1 = (Vec4::Load(node.maxY) - ray.origin[1]) * ray.inverseDirection[1];
+            const Vec4 z0 = (Vec4::Load(node.minZ) - ray.origin[2]) * ray.inverseDirection[2];
+            const Vec4 z1 = (Vec4::Load(node.maxZ) - ray.origin[2]) * ray.inverseDirection[2];
+
+            const Vec4 entering = Max(Max(Min(x0, x1), Min(y0, y1)), Max(Min(z0, z1), Vec4::Zero()));
+            const Vec4 leaving = Min(Min(Max(x0, x1), Max(y0, y1)), Min(Max(z0, z1), Vec4::Splat(*pClosest))) * Vec4::Splat(c_boxSlack);
+
+            float enterings[4];
+            float leavings[4];
+
+            entering.Store(enterings);
+            leaving.Store(leavings);
+
+            // Sorted furthest first, so that the nearest is popped first.
+            Entry hits[4];
+            size_t hitCount = 0;
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                if (node.children[lane] == c_emptyPickChild || !(enterings[lane] <= leavings[lane]))
+                {
+                    continue;
+                }
+
+                size_t position = hitCount++;
+
+                while (position > 0 && hits[position - 1].distance < enterings[lane])
+                {
+                    hits[position] = hits[position - 1];
+                    --position;
+                }
+
+                hits[position] = { node.children[lane], enterings[lane] };
+            }
+
+            for (size_t h = 0; h < hitCount; ++h)
+            {
+                stack[stackSize++] = hits[h];
+            }
+        }
+    }
+
+    // Moller-Trumbore for the four triangles of the pack. Returns the lane of the nearest hit
+    // before *pClosest, which it moves there, or -1.
+    static int IntersectPack(const PickTrianglePack& pack, const RayLanes& ray, float* pClosest, float* pU, float* pV)
+    {
+        const Vec4 e1x = Vec4::Load(pack.edge1[0]);
+        const Vec4 e1y = Vec4::Load(pack.edge1[1]);
+        const Vec4 e1z = Vec4::Load(pack.edge1[2]);
+        const Vec4 e2x = Vec4::Load(pack.edge2[0]);
+        const Vec4 e2y = Vec4::Load(pack.edge2[1]);
+        const Vec4 e2z = Vec4::Load(pack.edge2[2]);
+
+        const Vec4& dx = ray.direction[0];
+        const Vec4& dy = ray.direction[1];
+        const Vec4& dz = ray.direction[2];
+
+        const Vec4 px = dy * e2z - dz * e2y;
+        const Vec4 py = dz * e2x - dx * e2z;
+        const Vec4 pz = dx * e2y - dy * e2x;
+
+        // Zero for a ray in the plane of the triangle, which then has no number for u, v or t.
+        const Vec4 inverseDeterminant = Vec4::Splat(1.0f) / MultiplyAdd(e1x, px, MultiplyAdd(e1y, py, e1z * pz));
+
+        const Vec4 tx = ray.origin[0] - Vec4::Load(pack.v0[0]);
+        const Vec4 ty = ray.origin[1] - Vec4::Load(pack.v0[1]);
+        const Vec4 tz = ray.origin[2] - Vec4::Load(pack.v0[2]);
+
+        const Vec4 qx = ty * e1z - tz * e1y;
+        const Vec4 qy = tz * e1x - tx * e1z;
+        const Vec4 qz = tx * e1y - ty * e1x;
+
+        const Vec4 u = MultiplyAdd(tx, px, MultiplyAdd(ty, py, tz * pz)) * inverseDeterminant;
+        const Vec4 v = MultiplyAdd(dx, qx, MultiplyAdd(dy, qy, dz * qz)) * inverseDeterminant;
+        const Vec4 t = MultiplyAdd(e2x, qx, MultiplyAdd(e2y, qy, e2z * qz)) * inverseDeterminant;
+
+        // Not negative when the hit is inside the triangle and ahead of the origin.
+        const Vec4 inside = Min(Min(u, v), Min(Vec4::Splat(1.0f) - (u + v), t));
+        const Vec4 isHit = Select(CompareLess(inside, Vec4::Zero()), Vec4::Zero(), CompareLess(t, Vec4::Splat(*pClosest)));
+
+        if (!AnyTrue(isHit))
+        {
+            return -1;
+        }
+
+        float insides[4];
+        float distances[4];
+        float us[4];
+        float vs[4];
+
+        inside.Store(insides);
+        t.Store(distances);
+        u.Store(us);
+        v.Store(vs);
+
+        int nearest = -1;
+
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            if (insides[lane] >= 0.0f && distances[lane] < *pClosest)
+            {
+                nearest = lane;
+                *pClosest = distances[lane];
+                *pU = us[lane];
+                *pV = vs[lane];
+            }
+        }
+
+        return nearest;
+    }
+
+    bool PickIndex::Pick(const float* origin, const float* direction, PickHit* pHit) const
+    {
+        const RayLanes sceneRay(origin, direction);
+
+        // Affine transforms keep distances along the ray in lengths of its direction, so one
+        // closest distance serves every instance.
+        float closest = FLT_MAX;
+
+        const PickInstance* pHitInstance = nullptr;
+        const PickTrianglePack* pHitPack = nullptr;
+        int hitLane = -1;
+        float u = 0.0f;
+        float v = 0.0f;
+
+        Traverse(m_instanceNodes, sceneRay, &closest, [&](uint32_t leaf)
+        {
+            const auto& range = m_instanceLeaves[leaf];
+
+            for (uint32_t i = range.first; i < range.first + range.second; ++i)
+            {
+                const PickInstance& instance = m_instances[i];
+                const PickMesh& mesh = m_meshes[instance.mesh];
+
+                const RayLanes* pRay = &sceneRay;
+                optional<RayLanes> meshRay;
+
+                if (instance.isTransformed)
+                {
+                    const auto& m = instance.sceneToMesh;
+                    float meshOrigin[3];
+                    float meshDirection[3];
+
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        meshDirection[axis] = direction[0] * m[0][axis] + direction[1] * m[1][axis] + direction[2] * m[2][axis];
+                        meshOrigin[axis] = origin[0] * m[0][axis] + origin[1] * m[1][axis] + origin[2] * m[2][axis] + m[3][axis];
+                    }
+
+                    meshRay.emplace(meshOrigin, meshDirection);
+                    pRay = &*meshRay;
+                }
+
+                Traverse(mesh.nodes, *pRay, &closest, [&](uint32_t packIndex)
+                {
+                    const PickTrianglePack& pack = mesh.packs[packIndex];
+                    const int lane = IntersectPack(pack, *pRay, &closest, &u, &v);
+
+                    if (lane >= 0)
+                    {
+                        pHitInstance = &instance;
+                        pHitPack = &pack;
+                        hitLane = lane;
+                    }
+                });
+            }
+        });
+
+        if (!pHitPack)
+        {
+            return false;
+        }
+
+        const PickDraw& draw = m_draws[pHitPack->draws[hitLane]];
+
+        pHit->nodeId = draw.nodeId;
+        pHit->primitiveIndex = draw.primitiveIndex;
+        pHit->instanceIndex = pHitInstance->instanceIndex;
+        pHit->triangleIndex = pHitPack->triangles[hitLane];
+        pHit->distance = closest;
+        pHit->barycentrics[0] = u;
+        pHit->barycentrics[1] = v;
+
+        return true;
+    }
+} // SceneLoader
@@ -0,0 +1,157 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneBounds.h"
+
+namespace SceneLoader
+{
+    // Where a ray first hits a loaded scene.
+    struct PickHit
+    {
+        std::string nodeId;
+
+        // The primitive in the mesh of the node, the instance for EXT_mesh_gpu_instancing nodes
+        // and zero for others, and the triangle in the primitive as it was built.
+        uint32_t primitiveIndex = 0;
+        uint32_t instanceIndex = 0;
+        uint32_t triangleIndex = 0;
+
+        // Along the ray, in lengths of its direction, and the weights of the second and third
+        // vertices of the triangle at the hit. The first vertex has the rest.
+        float distance = 0.0f;
+        float barycentrics[2] = {};
+    };
+
+    // Four children of a node of a PickIndex hierarchy, their boxes laid out to be tested
+    // against a ray together. A child that isn't negative is a node, else the complement of a
+    // leaf; unused children are c_emptyPickChild.
+    struct PickBvhNode
+    {
+        float minX[4];
+        float minY[4];
+        float minZ[4];
+        float maxX[4];
+        float maxY[4];
+        float maxZ[4];
+        int32_t children[4];
+    };
+
+    constexpr int32_t c_emptyPickChild = INT32_MIN;
+
+    // The triangles of a leaf, one per lane, with the edges from their first vertex. Leaves of
+    // fewer than four repeat their last triangle.
+    struct PickTrianglePack
+    {
+        float v0[3][4];
+        float edge1[3][4];
+        float edge2[3][4];
+        uint32_t triangles[4];
+        uint32_t draws[4];
+    };
+
+    // A hierarchy over triangles, with one pack per leaf.
+    struct PickMesh
+    {
+        std::vector<PickBvhNode> nodes;
+        std::vector<PickTrianglePack> packs;
+        BoundingBox box;
+    };
+
+    // A mesh placed in the scene. The mesh of the triangles drawn once is already in the
+    // space of the scene and isn't transformed.
+    struct PickInstance
+    {
+        uint32_t mesh;
+        uint32_t instanceIndex;
+        bool isTransformed;
+
+        // From the space of the scene to that of the mesh, like a float4x4 for row vectors
+        // without its last column.
+        float sceneToMesh[4][3];
+    };
+
+    // The primitive a node draws.
+    struct PickDraw
+    {
+        std::string nodeId;
+        uint32_t primitiveIndex;
+    };
+
+    // Bounding volume hierarchies over the triangles a scene draws, for picking.
+    //
+    // Triangles drawn once are moved into the space of the scene and share a hierarchy. The
+    // primitives of EXT_mesh_gpu_instancing nodes keep a hierarchy of their own in the space
+    // of their mesh, and a second one over the boxes of the instances leads to them. Both are
+    // binned SAH trees collapsed into nodes of four children, whose boxes are tested at once,
+    // and leaves of four triangles, which are tested at once too.
+    class PickIndex
+    {
+    public:
+        // The first hit of a ray in the space of the scene, the one SceneMetadata is in.
+        // Returns false when the ray misses. Safe to call from several threads at once.
+        bool Pick(const float* origin, const float* direction, PickHit* pHit) const;
+
+        uint64_t TriangleCount() const { return m_triangleCount; }
+
+    private:
+        friend class PickIndexBuilder;
+
+        std::vector<PickMesh> m_meshes;
+        std::vector<PickDraw> m_draws;
+
+        // Instances are in the order of the leaves of the hierarchy over them.
+        std::vector<PickInstance> m_instances;
+        std::vector<PickBvhNode> m_instanceNodes;
+        std::vector<std::pair<uint32_t, uint32_t>> m_instanceLeaves; // first, count
+
+        uint64_t m_triangleCount = 0;
+    };
+
+    // Collects the triangles of a scene while it is built, see GLTFVisitor::AddPrimitiveBounds.
+    class PickIndexBuilder
+    {
+    public:
+        // A primitive drawn by a node, once per transform. Transforms are laid out like a
+        // float4x4, for row vectors. More than one makes the primitive instanced. Without
+        // indices the vertices are taken three at a time. Triangles with vertices that aren't
+        // finite can't be hit and are left out.
+        void AddPrimitive(
+            const std::string& nodeId,
+            uint32_t primitiveIndex,
+            const float* positions,
+            size_t vertexCount,
+            const uint16_t* indices,
+            size_t indexCount,
+            const float* transforms,
+            size_t transformCount);
+
+        // Builds the hierarchies of the meshes side by side, and the top of large ones in
+        // parallel too.
+        std::shared_ptr<const PickIndex> Build();
+
+    private:
+        // Nine floats per triangle, with the primitive triangle and draw of each.
+        struct TriangleSoup
+        {
+            std::vector<float> vertices;
+            std::vector<uint32_t> triangles;
+            std::vector<uint32_t> draws;
+        };
+
+        struct MeshInstance
+        {
+            uint32_t mesh;
+            uint32_t instanceIndex;
+            float transform[16];
+        };
+
+        std::vector<PickDraw> m_draws;
+
+        // The first is drawn once, in the space of the scene.
+        std::vector<TriangleSoup> m_soups = std::vector<TriangleSoup>(1);
+        std::vector<MeshInstance> m_instances;
+    };
+} // SceneLoader
@@ -0,0 +1,382 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ResourceResolver.h"
+#include "Base64.h"
+#include "ContentHash.h"
+#include "JsonReader.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static bool IsExternalUri(const string& uri)
+    {
+        return !uri.empty() && !IsDataUri(uri);
+    }
+
+    vector<string>
+    GetExternalResourceUris(const char* json, size_t length)
+    {
+        vector<string> uris;
+
+        JsonReader reader(json, length);
+        string_view key;
+
+        reader.BeginObject();
+
+        while (reader.NextMember(&key))
+        {
+            if ((key != "buffers" && key != "images") || reader.PeekType() != JsonValueType::Array)
+            {
+                reader.SkipValue();
+                continue;
+            }
+
+            reader.BeginArray();
+
+            while (reader.NextElement())
+            {
+                if (reader.PeekType() != JsonValueType::Object)
+                {
+                    reader.SkipValue();
+                    continue;
+                }
+
+                reader.BeginObject();
+
+                while (reader.NextMember(&key))
+                {
+                    // Data URIs are part of the document and already hashed with it;
+                    // skipping them also saves copying them.
+                    if (key != "uri" || reader.PeekType() != JsonValueType::String)
+                    {
+                        reader.SkipValue();
+                        continue;
+                    }
+
+                    string_view text = reader.SkipValue();
+
+                    if (text.compare(0, 6, "\"data:") == 0)
+                    {
+                        continue;
+                    }
+
+                    JsonReader uriReader(text.data(), text.size());
+                    string uri = uriReader.ReadString();
+
+                    if (IsExternalUri(uri))
+                    {
+                        uris.push_back(move(uri));
+                    }
+                }
+            }
+        }
+
+        sort(uris.begin(), uris.end());
+        uris.erase(unique(uris.begin(), uris.end()), uris.end());
+
+        return uris;
+    }
+
+    static bool AppendFileStamp(const wstring& path, string* pStamp)
+    {
+        error_code error;
+        uint64_t size = filesystem::file_size(path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        auto lastWriteTime = filesystem::last_write_time(path, error);
+
+        if (error)
+        {
+            return false;
+        }
+
+        // The path covers the resource folder as well as the uri.
+        const filesystem::path filePath(path);
+        const auto& pathBytes = filePath.native();
+        pStamp->append(reinterpret_cast<const char*>(pathBytes.data()), pathBytes.size() * sizeof(pathBytes[0]));
+        pStamp->push_back('\0');
+        pStamp->append(to_string(size) + ' ' + to_string(lastWriteTime.time_since_epoch().count()));
+        pStamp->push_back('\0');
+
+        return true;
+    }
+
+#ifdef _WIN32
+    static bool ReadWholeFile(const wstring& path, vector<uint8_t>* pBytes)
+    {
+        CREATEFILE2_EXTENDED_PARAMETERS parameters = {};
+        parameters.dwSize = sizeof(parameters);
+        parameters.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+        parameters.dwFileFlags = FILE_FLAG_SEQUENTIAL_SCAN;
+
+        HANDLE file = CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &parameters);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        bool succeeded = GetFileSizeEx(file, &fileSize) && static_cast<uint64_t>(fileSize.QuadPart) <= SIZE_MAX;
+
+        if (succeeded)
+        {
+            pBytes->resize(static_cast<size_t>(fileSize.QuadPart));
+
+            // ReadFile takes a DWORD, so large files are read in pieces.
+            size_t offset = 0;
+
+            while (succeeded && offset < pBytes->size())
+            {
+                DWORD bytesToRead = static_cast<DWORD>(min<size_t>(pBytes->size() - offset, 1u << 30));
+                DWORD bytesRead = 0;
+
+                succeeded = ReadFile(file, pBytes->data() + offset, bytesToRead, &bytesRead, nullptr) && bytesRead == bytesToRead;
+                offset += bytesRead;
+            }
+        }
+
+        CloseHandle(file);
+
+        return succeeded;
+    }
+#else
+    static bool ReadWholeFile(const wstring& path, vector<uint8_t>* pBytes)
+    {
+        ifstream file(filesystem::path(path), ios::binary | ios::ate);
+
+        if (!file)
+        {
+            return false;
+        }
+
+        const streamoff fileSize = file.tellg();
+
+        if (fileSize < 0 || static_cast<uint64_t>(fileSize) > SIZE_MAX)
+        {
+            return false;
+        }
+
+        pBytes->resize(static_cast<size_t>(fileSize));
+        file.seekg(0);
+
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(pBytes->data()), fileSize));
+    }
+#endif
+
+    DirectoryResourceResolver::DirectoryResourceResolver(wstring folder) :
+        m_folder(move(folder))
+    {
+    }
+
+    bool
+    DirectoryResourceResolver::Handles(const string& uri) const
+    {
+        return IsExternalUri(uri);
+    }
+
+    bool
+    DirectoryResourceResolver::TryResolve(const string& uri, ArenaArray<const uint8_t>* pBytes)
+    {
+        if (!Handles(uri))
+        {
+            return false;
+        }
+
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            auto it = m_files.find(uri);
+            if (it != m_files.end())
+            {
+                *pBytes = { it->second.data(), it->second.size() };
+                return true;
+            }
+        }
+
+        // Read outside of the lock so that prefetching actually overlaps.
+        wstring path;
+        vector<uint8_t> bytes;
+
+        if (!TryGetPathFromRelativeUri(m_folder, uri, &path) || !ReadWholeFile(path, &bytes))
+        {
+            return false;
+        }
+
+        lock_guard<mutex> lock(m_lock);
+
+        // Another thread may have won the race; its copy is as good as ours.
+        auto it = m_files.emplace(uri, move(bytes)).first;
+        *pBytes = { it->second.data(), it->second.size() };
+
+        return true;
+    }
+
+    bool
+    DirectoryResourceResolver::TryAppendStamp(const string& uri, string* pStamp) const
+    {
+        wstring path;
+        return Handles(uri) && TryGetPathFromRelativeUri(m_folder, uri, &path) && AppendFileStamp(path, pStamp);
+    }
+
+    MappedFileResourceResolver::MappedFileResourceResolver(wstring folder) :
+        m_folder(move(folder))
+    {
+    }
+
+    bool
+    MappedFileResourceResolver::Handles(const string& uri) const
+    {
+        return IsExternalUri(uri);
+    }
+
+    bool
+    MappedFileResourceResolver::TryResolve(const string& uri, ArenaArray<const uint8_t>* pBytes)
+    {
+        if (!Handles(uri))
+        {
+            return false;
+        }
+
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            auto it = m_files.find(uri);
+            if (it != m_files.end())
+            {
+                *pBytes = { it->second->Data(), static_cast<size_t>(it->second->Size()) };
+                return true;
+            }
+        }
+
+        wstring path;
+
+        if (!TryGetPathFromRelativeUri(m_folder, uri, &path))
+        {
+            return false;
+        }
+
+        auto file = MappedFile::Open(path);
+
+        if (!file)
+        {
+            return false;
+        }
+
+        lock_guard<mutex> lock(m_lock);
+
+        auto it = m_files.emplace(uri, move(file)).first;
+        *pBytes = { it->second->Data(), static_cast<size_t>(it->second->Size()) };
+
+        return true;
+    }
+
+    bool
+    MappedFileResourceResolver::TryAppendStamp(const string& uri, string* pStamp) const
+    {
+        wstring path;
+        return Handles(uri) && TryGetPathFromRelativeUri(m_folder, uri, &path) && AppendFileStamp(path, pStamp);
+    }
+
+    bool
+    DataUriResourceResolver::Handles(const string& uri) const
+    {
+        return IsDataUri(uri);
+    }
+
+    bool
+    DataUriResourceResolver::TryResolve(const string& uri, ArenaArray<const uint8_t>* pBytes)
+    {
+        // data:[<media type>][;base64],<data>
+        size_t comma = uri.find(',');
+
+        if (!Handles(uri) || comma == string::npos || comma < 12 || uri.compare(comma - 7, 7, ";base64") != 0)
+        {
+            return false;
+        }
+
+        const UriKey key = { ComputeContentHash(uri.data(), uri.size()), uri.size() };
+
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            auto it = m_decoded.find(key);
+            if (it != m_decoded.end() && !it->second.empty())
+            {
+                *pBytes = { it->second.data(), it->second.size() };
+                return true;
+            }
+        }
+
+        const char* encoded = uri.data() + comma + 1;
+        size_t encodedLength = uri.size() - comma - 1;
+
+        vector<uint8_t> decoded(GetBase64DecodedLengthBound(encodedLength));
+        size_t decodedLength;
+
+        if (!DecodeBase64(encoded, encodedLength, decoded.data(), &decodedLength))
+        {
+            return false;
+        }
+
+        decoded.resize(decodedLength);
+
+        lock_guard<mutex> lock(m_lock);
+
+        auto& entry = m_decoded[key];
+
+        if (entry.empty())
+        {
+            entry = move(decoded);
+        }
+
+        *pBytes = { entry.data(), entry.size() };
+        return true;
+    }
+
+    void
+    PrefetchResources(const Document& gltfDocument, const SceneDependencies& dependencies, IResourceResolver& resolver)
+    {
+        // Pointers, so that large data URIs aren't copied.
+        vector<const string*> uris;
+
+        for (const auto& bufferId : dependencies.bufferIds)
+        {
+            const Buffer& buffer = gltfDocument.buffers.Get(bufferId);
+
+            if (resolver.Handles(buffer.uri))
+            {
+                uris.push_back(&buffer.uri);
+            }
+        }
+
+        for (const auto& imageId : dependencies.imageIds)
+        {
+            const Image& image = gltfDocument.images.Get(imageId);
+
+            if (resolver.Handles(image.uri))
+            {
+                uris.push_back(&image.uri);
+            }
+        }
+
+        sort(uris.begin(), uris.end(), [](const string* a, const string* b) { return *a < *b; });
+        uris.erase(unique(uris.begin(), uris.end(), [](const string* a, const string* b) { return *a == *b; }), uris.end());
+
+        concurrency::parallel_for_each(uris.begin(), uris.end(), [&resolver](const string* uri)
+        {
+            ArenaArray<const uint8_t> bytes;
+            resolver.TryResolve(*uri, &bytes);
+        });
+    }
+} // namespace SceneLoader
@@ -0,0 +1,117 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+#include "MappedFile.h"
+#include "ResourceUri.h"
+#include "SceneSelection.h"
+
+namespace SceneLoader
+{
+    // Turns the uri of an external buffer or image into bytes. Resolved bytes stay valid
+    // for the lifetime of the resolver, and TryResolve may be called from several threads.
+    class IResourceResolver
+    {
+    public:
+        virtual ~IResourceResolver() = default;
+
+        // True for the kind of uri this resolver is meant for.
+        virtual bool Handles(const std::string& uri) const = 0;
+
+        // Returns false if the uri can't be resolved.
+        virtual bool TryResolve(const std::string& uri, ArenaArray<const uint8_t>* pBytes) = 0;
+
+        // Appends text that changes whenever the bytes behind uri do, without reading them,
+        // for scene cache keys. Returns false if there's no telling, and the load isn't cached.
+        virtual bool TryAppendStamp(const std::string& /*uri*/, std::string* /*pStamp*/) const { return false; }
+    };
+
+    // The uris of the buffers and images in glTF JSON that aren't data URIs, sorted and
+    // without duplicates. Throws InvalidGLTFException for malformed JSON.
+    std::vector<std::string> GetExternalResourceUris(const char* json, size_t length);
+
+    // Reads files relative to a folder into memory. Uris that would name a file outside of
+    // the folder aren't resolved, see TryGetPathFromRelativeUri.
+    class DirectoryResourceResolver : public IResourceResolver
+    {
+    public:
+        explicit DirectoryResourceResolver(std::wstring folder);
+
+        bool Handles(const std::string& uri) const override;
+        bool TryResolve(const std::string& uri, ArenaArray<const uint8_t>* pBytes) override;
+
+        // The path, size and last write time of the file.
+        bool TryAppendStamp(const std::string& uri, std::string* pStamp) const override;
+
+    private:
+        std::wstring m_folder;
+
+        std::mutex m_lock;
+        std::unordered_map<std::string, std::vector<uint8_t>> m_files;
+    };
+
+    // Maps files relative to a folder, so that even very large buffers are only paged in
+    // as they are read. Like DirectoryResourceResolver, only files in the folder.
+    class MappedFileResourceResolver : public IResourceResolver
+    {
+    public:
+        explicit MappedFileResourceResolver(std::wstring folder);
+
+        bool Handles(const std::string& uri) const override;
+        bool TryResolve(const std::string& uri, ArenaArray<const uint8_t>* pBytes) override;
+
+        // The path, size and last write time of the file.
+        bool TryAppendStamp(const std::string& uri, std::string* pStamp) const override;
+
+    private:
+        std::wstring m_folder;
+
+        std::mutex m_lock;
+        std::unordered_map<std::string, std::unique_ptr<MappedFile>> m_files;
+    };
+
+    // Decodes base64 data URIs with DecodeBase64, once per uri, into memory that buffers,
+    // accessors and images then share. Other data URIs are left to the glTF SDK.
+    // Decoded bytes are keyed by the content hash and the length of the uri, so that equal
+    // uris share them wherever their strings live.
+    class DataUriResourceResolver : public IResourceResolver
+    {
+    public:
+        bool Handles(const std::string& uri) const override;
+        bool TryResolve(const std::string& uri, ArenaArray<const uint8_t>* pBytes) override;
+
+    private:
+        struct UriKey
+        {
+            uint64_t hash;
+            size_t length;
+
+            bool operator==(const UriKey& other) const
+            {
+                return hash == other.hash && length == other.length;
+            }
+        };
+
+        struct UriKeyHash
+        {
+            size_t operator()(const UriKey& key) const
+            {
+                return static_cast<size_t>(key.hash);
+            }
+        };
+
+        std::mutex m_lock;
+        std::unordered_map<UriKey, std::vector<uint8_t>, UriKeyHash> m_decoded;
+    };
+
+    // Resolves the buffers and images in dependencies that the resolver handles in
+    // parallel, so that decoding never waits on I/O or base64. Resources that fail to
+    // resolve are skipped here and reported when they are actually used.
+    void PrefetchResources(
+        const Microsoft::glTF::Document& gltfDocument,
+        const SceneDependencies& dependencies,
+        IResourceResolver& resolver);
+} // SceneLoader
@@ -0,0 +1,208 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ResourceUri.h"
+
+#ifndef _WIN32
+#include <codecvt>
+#include <locale>
+#endif
+
+using namespace std;
+
+namespace SceneLoader
+{
+#ifdef _WIN32
+    static constexpr wchar_t c_pathSeparator = L'\\';
+#else
+    static constexpr wchar_t c_pathSeparator = L'/';
+#endif
+
+    bool
+    IsDataUri(const string& uri)
+    {
+        return uri.compare(0, 5, "data:") == 0;
+    }
+
+    wstring
+    GetParentFolder(const wstring& path)
+    {
+        size_t separator = path.find_last_of(L"\\/");
+        return separator == wstring::npos ? wstring() : path.substr(0, separator);
+    }
+
+    static int GetHexDigitValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+
+        return -1;
+    }
+
+    // A '%' that isn't followed by two hex digits is kept as it is.
+    static string DecodePercentEscapes(const string& uri)
+    {
+        string decoded;
+        decoded.reserve(uri.size());
+
+        for (size_t i = 0; i < uri.size(); ++i)
+        {
+            const int high = uri[i] == '%' && i + 2 < uri.size() ? GetHexDigitValue(uri[i + 1]) : -1;
+            const int low = high >= 0 ? GetHexDigitValue(uri[i + 2]) : -1;
+
+            if (low >= 0)
+            {
+                decoded.push_back(static_cast<char>(high * 16 + low));
+                i += 2;
+            }
+            else
+            {
+                decoded.push_back(uri[i]);
+            }
+        }
+
+        return decoded;
+    }
+
+    static bool TryConvertUtf8(const string& text, wstring* pText)
+    {
+        if (text.empty())
+        {
+            pText->clear();
+            return true;
+        }
+
+#ifdef _WIN32
+        const int length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, text.data(), static_cast<int>(text.size()), nullptr, 0);
+
+        if (length <= 0)
+        {
+            return false;
+        }
+
+        pText->resize(length);
+        MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, text.data(), static_cast<int>(text.size()), &(*pText)[0], length);
+
+        return true;
+#else
+        // A truncated sequence at the end isn't an error to from_bytes, it's just not converted.
+        wstring_convert<codecvt_utf8<wchar_t>> converter;
+
+        try
+        {
+            *pText = converter.from_bytes(text);
+        }
+        catch (const range_error&)
+        {
+            return false;
+        }
+
+        return converter.converted() == text.size();
+#endif
+    }
+
+    // Windows drops trailing dots and spaces from a path segment, which would make "..." or
+    // ".. " name the parent folder.
+    static bool IsAmbiguousSegment(const wstring& segment)
+    {
+        return segment != L"." && segment != L".." && (segment.back() == L'.' || segment.back() == L' ');
+    }
+
+    bool
+    TryGetPathFromRelativeUri(const wstring& folder, const string& uri, wstring* pPath)
+    {
+        const string decoded = DecodePercentEscapes(uri);
+
+        // The segments are checked after the conversion, so that no encoding of a separator
+        // or a dot gets past them.
+        wstring relative;
+
+        if (decoded.find('\0') != string::npos || !TryConvertUtf8(decoded, &relative))
+        {
+            return false;
+        }
+
+        // Rooted: "/a", "\a" and "\\server\share". Any colon is a drive, a scheme or an
+        // alternate data stream.
+        if (relative.empty() || relative[0] == L'/' || relative[0] == L'\\' || relative.find(L':') != wstring::npos)
+        {
+            return false;
+        }
+
+        vector<wstring> segments;
+        size_t start = 0;
+
+        while (start <= relative.size())
+        {
+            size_t end = relative.find_first_of(L"/\\", start);
+
+            if (end == wstring::npos)
+            {
+                end = relative.size();
+            }
+
+            wstring segment = relative.substr(start, end - start);
+            start = end + 1;
+
+            if (segment.empty() || segment == L".")
+            {
+                continue;
+            }
+
+            if (IsAmbiguousSegment(segment))
+            {
+                return false;
+            }
+
+            if (segment == L"..")
+            {
+                if (segments.empty())
+                {
+                    return false;
+                }
+
+                segments.pop_back();
+                continue;
+            }
+
+            segments.push_back(move(segment));
+        }
+
+        // The folder itself isn't a resource.
+        if (segments.empty())
+        {
+            return false;
+        }
+
+        wstring path = folder;
+
+        for (const auto& segment : segments)
+        {
+            if (!path.empty() && path.back() != L'\\' && path.back() != L'/')
+            {
+                path.push_back(c_pathSeparator);
+            }
+
+            path += segment;
+        }
+
+        *pPath = move(path);
+
+        return true;
+    }
+} // SceneLoader
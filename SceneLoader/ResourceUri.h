@@ -0,0 +1,19 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    bool IsDataUri(const std::string& uri);
+
+    // Folder part of a file path, empty if there is none.
+    std::wstring GetParentFolder(const std::wstring& path);
+
+    // Converts a percent-encoded relative uri to a path under folder. Returns false for a uri
+    // that could name anything else: rooted and drive-qualified paths, other schemes, ".."
+    // past the start, an encoded NUL and invalid UTF-8, decoded or not. "." and ".." are
+    // resolved here, so the path has neither.
+    bool TryGetPathFromRelativeUri(const std::wstring& folder, const std::string& uri, std::wstring* pPath);
+} // SceneLoader
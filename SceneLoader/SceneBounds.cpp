@@ -0,0 +1,610 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "SceneBounds.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    // Spheres are grown by this fraction of their size, so that the rounding of the passes
+    // that moved their center can't leave a point just outside.
+    static constexpr float c_sphereSlack = 1e-5f;
+
+    // Times the sphere of the scene is shrunk and grown again, see ComputeSphere, and by how much.
+    static constexpr size_t c_refinePassCount = 8;
+    static constexpr float c_refineShrink = 0.9f;
+
+    // Points are only dropped as not on the convex hull when they are this fraction of the
+    // size of the primitive inside it, far more than rounding can move them.
+    static constexpr float c_hullMargin = 1e-4f;
+
+    // The directions the hull that drops points is spanned from: the axes, the diagonals of
+    // the faces of a cube and those through its corners. Only compared, so not normalized.
+    static constexpr float c_hullDirections[13][3] =
+    {
+        { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 },
+        { 1, 1, 0 }, { 1, -1, 0 }, { 1, 0, 1 }, { 1, 0, -1 }, { 0, 1, 1 }, { 0, 1, -1 },
+        { 1, 1, 1 }, { 1, 1, -1 }, { 1, -1, 1 }, { 1, -1, -1 },
+    };
+
+    // Four transformed points, one per lane.
+    struct PointLanes
+    {
+        Vec4 x;
+        Vec4 y;
+        Vec4 z;
+    };
+
+    // The point of each lane with the smallest projection so far.
+    struct ExtremeLanes
+    {
+        Vec4 projection;
+        Vec4 x;
+        Vec4 y;
+        Vec4 z;
+    };
+
+    // The elements of a float4x4 that act on points, each in every lane.
+    struct MatrixLanes
+    {
+        Vec4 m[4][3];
+
+        explicit MatrixLanes(const float* transform)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int column = 0; column < 3; ++column)
+                {
+                    m[row][column] = Vec4::Splat(transform[row * 4 + column]);
+                }
+            }
+        }
+    };
+
+    // Transforms the four points from first on. Past the end the last point is repeated,
+    // which changes neither the extremes nor the sphere.
+    static inline PointLanes LoadTransformedPoints(const float* positions, size_t count, size_t first, const MatrixLanes& matrix)
+    {
+        float padded[12];
+        const float* p = positions + first * 3;
+
+        if (first + 4 > count)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                memcpy(padded + i * 3, positions + min(first + i, count - 1) * 3, 3 * sizeof(float));
+            }
+
+            p = padded;
+        }
+
+        Vec4 a = Vec4::Load(p);
+        Vec4 b = Vec4::Load(p + 3);
+        Vec4 c = Vec4::Load(p + 6);
+        Vec4 d = Vec4::Set(p[9], p[10], p[11], 0.0f);
+
+        Transpose(a, b, c, d);
+
+        const auto& m = matrix.m;
+
+        PointLanes points;
+        points.x = MultiplyAdd(a, m[0][0], MultiplyAdd(b, m[1][0], MultiplyAdd(c, m[2][0], m[3][0])));
+        points.y = MultiplyAdd(a, m[0][1], MultiplyAdd(b, m[1][1], MultiplyAdd(c, m[2][1], m[3][1])));
+        points.z = MultiplyAdd(a, m[0][2], MultiplyAdd(b, m[1][2], MultiplyAdd(c, m[2][2], m[3][2])));
+
+        return points;
+    }
+
+    static inline void KeepSmaller(ExtremeLanes& extreme, Vec4 projection, const PointLanes& points)
+    {
+        const Vec4 isSmaller = CompareLess(projection, extreme.projection);
+
+        extreme.projection = Select(isSmaller, projection, extreme.projection);
+        extreme.x = Select(isSmaller, points.x, extreme.x);
+        extreme.y = Select(isSmaller, points.y, extreme.y);
+        extreme.z = Select(isSmaller, points.z, extreme.z);
+    }
+
+    // Moves the sphere towards the point and makes it just large enough to take in both the
+    // point and the sphere it was.
+    static void GrowToPoint(BoundingSphere* pSphere, const float* point)
+    {
+        const float offset[3] =
+        {
+            point[0] - pSphere->center[0],
+            point[1] - pSphere->center[1],
+            point[2] - pSphere->center[2],
+        };
+
+        const float distanceSquared = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+
+        if (distanceSquared <= pSphere->radius * pSphere->radius)
+        {
+            return;
+        }
+
+        const float distance = sqrtf(distanceSquared);
+        const float radius = (pSphere->radius + distance) * 0.5f;
+        const float shift = (radius - pSphere->radius) / distance;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            pSphere->center[axis] += offset[axis] * shift;
+        }
+
+        pSphere->radius = radius;
+    }
+
+    // The sphere through the two extremes of the direction they are furthest apart along,
+    // grown to take in the others.
+    static BoundingSphere SphereOfExtremes(const float (*points)[3], size_t count)
+    {
+        size_t widest = 0;
+        float widestSquared = -1.0f;
+
+        for (size_t i = 0; i + 1 < count; i += 2)
+        {
+            float distanceSquared = 0.0f;
+
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float difference = points[i + 1][axis] - points[i][axis];
+                distanceSquared += difference * difference;
+            }
+
+            if (distanceSquared > widestSquared)
+            {
+                widest = i;
+                widestSquared = distanceSquared;
+            }
+        }
+
+        BoundingSphere sphere;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            sphere.center[axis] = (points[widest][axis] + points[widest + 1][axis]) * 0.5f;
+        }
+
+        sphere.radius = sqrtf(widestSquared) * 0.5f;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            GrowToPoint(&sphere, points[i]);
+        }
+
+        return sphere;
+    }
+
+    static bool IsInside(const BoundingSphere& inner, const BoundingSphere& outer)
+    {
+        float distanceSquared = 0.0f;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float difference = inner.center[axis] - outer.center[axis];
+            distanceSquared += difference * difference;
+        }
+
+        return sqrtf(distanceSquared) + inner.radius <= outer.radius;
+    }
+
+    // Ritter's pass, four points at a time, growing only for the lanes outside.
+    static void GrowToPoints(BoundingSphere* pSphere, const float* positions, size_t count, const MatrixLanes& matrix)
+    {
+        Vec4 centerX = Vec4::Splat(pSphere->center[0]);
+        Vec4 centerY = Vec4::Splat(pSphere->center[1]);
+        Vec4 centerZ = Vec4::Splat(pSphere->center[2]);
+        Vec4 radiusSquared = Vec4::Splat(pSphere->radius * pSphere->radius);
+
+        for (size_t first = 0; first < count; first += 4)
+        {
+            const PointLanes points = LoadTransformedPoints(positions, count, first, matrix);
+
+            const Vec4 dx = points.x - centerX;
+            const Vec4 dy = points.y - centerY;
+            const Vec4 dz = points.z - centerZ;
+            const Vec4 distanceSquared = MultiplyAdd(dx, dx, MultiplyAdd(dy, dy, dz * dz));
+
+            if (!AnyTrue(CompareLess(radiusSquared, distanceSquared)))
+            {
+                continue;
+            }
+
+            float x[4];
+            float y[4];
+            float z[4];
+
+            points.x.Store(x);
+            points.y.Store(y);
+            points.z.Store(z);
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                const float point[3] = { x[lane], y[lane], z[lane] };
+                GrowToPoint(pSphere, point);
+            }
+
+            centerX = Vec4::Splat(pSphere->center[0]);
+            centerY = Vec4::Splat(pSphere->center[1]);
+            centerZ = Vec4::Splat(pSphere->center[2]);
+            radiusSquared = Vec4::Splat(pSphere->radius * pSphere->radius);
+        }
+    }
+
+    // The plane of a face of a convex hull, its normal unit length and pointing out.
+    struct HullPlane
+    {
+        float normal[3];
+        float distance;
+
+        float DistanceTo(const float* point) const
+        {
+            return normal[0] * point[0] + normal[1] * point[1] + normal[2] * point[2] - distance;
+        }
+    };
+
+    // The planes of the faces of the convex hull of a few points, every plane through three of
+    // them with none of the others further out than margin. When the points are all in one
+    // plane that plane is returned, and nothing is inside it.
+    static vector<HullPlane> FindHullPlanes(const vector<array<float, 3>>& points, float margin)
+    {
+        vector<HullPlane> planes;
+        const size_t count = points.size();
+
+        for (size_t a = 0; a < count; ++a)
+        {
+            for (size_t b = a + 1; b < count; ++b)
+            {
+                for (size_t c = b + 1; c < count; ++c)
+                {
+                    const float* p = points[a].data();
+                    const float ab[3] = { points[b][0] - p[0], points[b][1] - p[1], points[b][2] - p[2] };
+                    const float ac[3] = { points[c][0] - p[0], points[c][1] - p[1], points[c][2] - p[2] };
+
+                    HullPlane plane;
+                    plane.normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+                    plane.normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+                    plane.normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+
+                    const float length = sqrtf(plane.normal[0] * plane.normal[0] + plane.normal[1] * plane.normal[1] + plane.normal[2] * plane.normal[2]);
+
+                    // Three points in a line span no plane.
+                    if (!(length > margin * margin))
+                    {
+                        continue;
+                    }
+
+                    for (float& component : plane.normal)
+                    {
+                        component /= length;
+                    }
+
+                    plane.distance = plane.normal[0] * p[0] + plane.normal[1] * p[1] + plane.normal[2] * p[2];
+
+                    bool isAnyAbove = false;
+                    bool isAnyBelow = false;
+
+                    for (const auto& point : points)
+                    {
+                        const float distance = plane.DistanceTo(point.data());
+                        isAnyAbove |= distance > margin;
+                        isAnyBelow |= distance < -margin;
+                    }
+
+                    if (isAnyAbove && isAnyBelow)
+                    {
+                        continue;
+                    }
+
+                    if (isAnyAbove)
+                    {
+                        for (float& component : plane.normal)
+                        {
+                            component = -component;
+                        }
+
+                        plane.distance = -plane.distance;
+                    }
+
+                    // Faces with more than three corners would be found once per three of them.
+                    const bool isFound = any_of(planes.begin(), planes.end(), [&](const HullPlane& other)
+                    {
+                        return other.normal[0] * plane.normal[0] + other.normal[1] * plane.normal[1] + other.normal[2] * plane.normal[2] > 0.0f &&
+                            fabsf(other.DistanceTo(points[a].data())) <= margin &&
+                            fabsf(other.DistanceTo(points[b].data())) <= margin &&
+                            fabsf(other.DistanceTo(points[c].data())) <= margin;
+                    });
+
+                    if (!isFound)
+                    {
+                        planes.push_back(plane);
+                    }
+                }
+            }
+        }
+
+        return planes;
+    }
+
+    // The positions that may be furthest out along some direction after any affine transform,
+    // in their order: every point on the convex hull, and some just inside it. Points with
+    // coordinates that aren't numbers are kept, as AddPoints knows what to do with them.
+    static shared_ptr<const vector<float>> SelectHullPoints(const float* positions, size_t count)
+    {
+        // The extremes along each direction both ways, and how far out the points go.
+        size_t extremes[26] = {};
+        float projections[26];
+        fill(begin(projections), end(projections), -FLT_MAX);
+
+        float extent = 0.0f;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* p = positions + i * 3;
+
+            for (size_t direction = 0; direction < 13; ++direction)
+            {
+                const float* d = c_hullDirections[direction];
+                const float projection = d[0] * p[0] + d[1] * p[1] + d[2] * p[2];
+
+                if (projection > projections[direction * 2])
+                {
+                    projections[direction * 2] = projection;
+                    extremes[direction * 2] = i;
+                }
+
+                if (-projection > projections[direction * 2 + 1])
+                {
+                    projections[direction * 2 + 1] = -projection;
+                    extremes[direction * 2 + 1] = i;
+                }
+            }
+
+            extent = max(extent, max(max(fabsf(p[0]), fabsf(p[1])), fabsf(p[2])));
+        }
+
+        sort(begin(extremes), end(extremes));
+
+        vector<array<float, 3>> corners;
+
+        for (size_t i = 0; i < 26; ++i)
+        {
+            if (i == 0 || extremes[i] != extremes[i - 1])
+            {
+                const float* p = positions + extremes[i] * 3;
+                corners.push_back({ p[0], p[1], p[2] });
+            }
+        }
+
+        const float margin = extent * c_hullMargin;
+        const vector<HullPlane> planes = FindHullPlanes(corners, margin);
+
+        auto selected = make_shared<vector<float>>();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* p = positions + i * 3;
+
+            // Not well inside every plane, or there are too few planes to be inside any.
+            const bool isInside = planes.size() >= 4 && all_of(planes.begin(), planes.end(), [&](const HullPlane& plane)
+            {
+                return plane.DistanceTo(p) < -margin;
+            });
+
+            if (!isInside)
+            {
+                selected->insert(selected->end(), p, p + 3);
+            }
+        }
+
+        return selected;
+    }
+
+    static void AddSlack(BoundingSphere* pSphere)
+    {
+        const float extent = max(max(fabsf(pSphere->center[0]), fabsf(pSphere->center[1])), fabsf(pSphere->center[2]));
+
+        pSphere->radius += (pSphere->radius + extent) * c_sphereSlack;
+    }
+
+    BoundingBox SceneBoundsBuilder::AddPoints(shared_ptr<const vector<float>> positions, const float* transform)
+    {
+        BoundingBox box;
+        const size_t count = positions->size() / 3;
+
+        if (count == 0)
+        {
+            return box;
+        }
+
+        const MatrixLanes matrix(transform);
+
+        // Extreme 2k is the smallest along direction k, 2k + 1 the largest. The first three
+        // directions are the axes, so their extremes are the box as well. Projections on the
+        // diagonals are only compared, so they aren't normalized.
+        ExtremeLanes extremes[c_extremeCount];
+
+        for (auto& extreme : extremes)
+        {
+            extreme.projection = Vec4::Splat(FLT_MAX);
+            extreme.x = extreme.y = extreme.z = Vec4::Zero();
+        }
+
+        const Vec4 zero = Vec4::Zero();
+
+        for (size_t first = 0; first < count; first += 4)
+        {
+            const PointLanes points = LoadTransformedPoints(positions->data(), count, first, matrix);
+
+            const Vec4 xy = points.x + points.y;
+            const Vec4 xMinusY = points.x - points.y;
+
+            const Vec4 projections[c_extremeCount / 2] =
+            {
+                points.x,
+                points.y,
+                points.z,
+                xy + points.z,
+                xy - points.z,
+                xMinusY + points.z,
+                xMinusY - points.z,
+            };
+
+            for (size_t direction = 0; direction < c_extremeCount / 2; ++direction)
+            {
+                KeepSmaller(extremes[direction * 2], projections[direction], points);
+                KeepSmaller(extremes[direction * 2 + 1], zero - projections[direction], points);
+            }
+        }
+
+        // The smallest lane of each extreme.
+        float points[c_extremeCount][3];
+
+        for (size_t i = 0; i < c_extremeCount; ++i)
+        {
+            float projection[4];
+            float x[4];
+            float y[4];
+            float z[4];
+
+            extremes[i].projection.Store(projection);
+            extremes[i].x.Store(x);
+            extremes[i].y.Store(y);
+            extremes[i].z.Store(z);
+
+            size_t lane = 0;
+
+            for (size_t l = 1; l < 4; ++l)
+            {
+                if (projection[l] < projection[lane])
+                {
+                    lane = l;
+                }
+            }
+
+            points[i][0] = x[lane];
+            points[i][1] = y[lane];
+            points[i][2] = z[lane];
+
+            if (projection[lane] < m_extremes[i].projection)
+            {
+                m_extremes[i].projection = projection[lane];
+                memcpy(m_extremes[i].point, points[i], sizeof(points[i]));
+            }
+
+            if (i < 6)
+            {
+                const int axis = static_cast<int>(i / 2);
+
+                if (i % 2 == 0)
+                {
+                    box.min[axis] = projection[lane];
+                }
+                else
+                {
+                    box.max[axis] = -projection[lane];
+                }
+            }
+        }
+
+        // Points that aren't numbers are never an extreme. When there were only those, nothing was added.
+        if (box.IsEmpty())
+        {
+            return box;
+        }
+
+        m_box.Add(box);
+
+        PointGroup group;
+        group.positions = move(positions);
+        memcpy(group.transform, transform, sizeof(group.transform));
+        group.sphere = SphereOfExtremes(points, c_extremeCount);
+
+        GrowToPoints(&group.sphere, group.positions->data(), count, matrix);
+        AddSlack(&group.sphere);
+
+        m_groups.push_back(move(group));
+
+        return box;
+    }
+
+    BoundingBox SceneBoundsBuilder::AddInstances(const float* positions, size_t vertexCount, const float* transforms, size_t instanceCount)
+    {
+        // The hull is worth finding when it saves transforming the rest more than once.
+        auto points = (instanceCount > 1)
+            ? SelectHullPoints(positions, vertexCount)
+            : make_shared<const vector<float>>(positions, positions + vertexCount * 3);
+
+        BoundingBox box;
+
+        for (size_t i = 0; i < instanceCount; ++i)
+        {
+            box.Add(AddPoints(points, transforms + i * 16));
+        }
+
+        return box;
+    }
+
+    BoundingSphere SceneBoundsBuilder::ComputeSphere() const
+    {
+        if (m_groups.empty())
+        {
+            return BoundingSphere();
+        }
+
+        float points[c_extremeCount][3];
+
+        for (size_t i = 0; i < c_extremeCount; ++i)
+        {
+            memcpy(points[i], m_extremes[i].point, sizeof(points[i]));
+        }
+
+        // The points furthest out over every group give a sphere that most groups are inside
+        // of already. Only the points of the others are gone over again.
+        BoundingSphere best = SphereOfExtremes(points, c_extremeCount);
+
+        // What Ritter's pass ends with depends on the order it grows in, and it is loose around
+        // groups far apart. Each pass after the first shrinks the best sphere so far and grows
+        // it again, starting from another group, until that no longer makes it smaller.
+        const size_t groupCount = m_groups.size();
+
+        for (size_t pass = 0; pass <= c_refinePassCount; ++pass)
+        {
+            BoundingSphere sphere = best;
+            size_t start = 0;
+
+            if (pass > 0)
+            {
+                sphere.radius *= c_refineShrink;
+                start = pass * groupCount / (c_refinePassCount + 1);
+            }
+
+            for (size_t i = 0; i < groupCount; ++i)
+            {
+                const PointGroup& group = m_groups[(start + i) % groupCount];
+
+                if (!IsInside(group.sphere, sphere))
+                {
+                    GrowToPoints(&sphere, group.positions->data(), group.positions->size() / 3, MatrixLanes(group.transform));
+                }
+            }
+
+            if (pass > 0 && sphere.radius >= best.radius)
+            {
+                break;
+            }
+
+            best = sphere;
+        }
+
+        AddSlack(&best);
+
+        return best;
+    }
+} // SceneLoader
@@ -0,0 +1,112 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // Empty until something is added.
+    struct BoundingBox
+    {
+        float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+        float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+        bool IsEmpty() const { return min[0] > max[0]; }
+
+        void Add(const BoundingBox& other)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                min[axis] = std::min(min[axis], other.min[axis]);
+                max[axis] = std::max(max[axis], other.max[axis]);
+            }
+        }
+    };
+
+    // Empty while the radius is negative.
+    struct BoundingSphere
+    {
+        float center[3] = {};
+        float radius = -1.0f;
+
+        bool IsEmpty() const { return radius < 0.0f; }
+    };
+
+    // What is drawn below one node of the document, over every path through the scene to it.
+    struct NodeBounds
+    {
+        std::string nodeId;
+        BoundingBox box;
+    };
+
+    // The geometry of a loaded scene, in the space of its root node, before the scene is
+    // fitted into the world node. Collected while the scene is built, see GLTFVisitor.
+    struct SceneMetadata
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+
+        // Nodes that draw something or have descendants that do, in the order they are first
+        // reached.
+        std::vector<NodeBounds> nodeBounds;
+
+        // Scene nodes made for the nodes of the document, one per path to them, the distinct
+        // primitives built and their vertices, and the triangles drawn by every node and instance.
+        uint64_t nodeCount = 0;
+        uint64_t primitiveCount = 0;
+        uint64_t vertexCount = 0;
+        uint64_t drawnTriangleCount = 0;
+    };
+
+    // The box and bounding sphere of points added in groups, each with a transform of its own.
+    //
+    // The sphere starts from the points furthest along seven directions, the axes and the
+    // diagonals, and grows in one more pass to take in any point outside it: EPOS-14 followed
+    // by Ritter. Each group gets such a sphere when it is added. The sphere of the whole starts
+    // from the points furthest out over every group, and only the groups whose sphere isn't
+    // inside it already are gone over again, usually few.
+    //
+    // Instances of a mesh only go over the points that can be furthest out along some
+    // direction, whatever their transform: the points on the convex hull. Those are picked
+    // once, by dropping the points well inside the hull of the extremes along 13 directions.
+    class SceneBoundsBuilder
+    {
+    public:
+        // Adds packed xyz positions transformed by a matrix laid out like a float4x4, for row
+        // vectors, and returns the box of the transformed positions. The positions are kept
+        // for ComputeSphere; instances of a mesh can share them.
+        BoundingBox AddPoints(std::shared_ptr<const std::vector<float>> positions, const float* transform);
+
+        // Adds vertexCount packed xyz positions at each of instanceCount transforms, laid out
+        // like AddPoints takes them one after another, and returns the box of them all. The
+        // positions are copied.
+        BoundingBox AddInstances(const float* positions, size_t vertexCount, const float* transforms, size_t instanceCount);
+
+        const BoundingBox& Box() const { return m_box; }
+
+        // Contains every point added. Empty when there were none.
+        BoundingSphere ComputeSphere() const;
+
+    private:
+        // The point with the smallest projection on one of the directions or its opposite.
+        struct ExtremePoint
+        {
+            float projection = FLT_MAX;
+            float point[3] = {};
+        };
+
+        struct PointGroup
+        {
+            std::shared_ptr<const std::vector<float>> positions;
+            float transform[16];
+            BoundingSphere sphere;
+        };
+
+        static constexpr size_t c_extremeCount = 14;
+
+        BoundingBox m_box;
+        ExtremePoint m_extremes[c_extremeCount];
+        std::vector<PointGroup> m_groups;
+    };
+} // SceneLoader
@@ -0,0 +1,581 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "UtilForIntermingledNamespaces.h"
+#include "SceneCache.h"
+
+using namespace std;
+
+namespace winrt {
+    using namespace Windows::Foundation::Numerics;
+    using namespace Windows::Graphics;
+    using namespace Windows::Graphics::DirectX;
+    using namespace Windows::UI::Composition;
+    using namespace Windows::UI::Composition::Scenes;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    void
+    SceneCacheWriter::RecordMeshAttribute(
+        const SceneMesh& mesh,
+        SceneAttributeSemantic semantic,
+        DirectXPixelFormat format,
+        const void* data,
+        size_t byteLength)
+    {
+        RecordedAttribute attribute;
+        attribute.semantic = static_cast<int32_t>(semantic);
+        attribute.format = static_cast<int32_t>(format);
+        attribute.streamIndex = m_contents.AppendStream(data, byteLength);
+
+        auto& attributes = m_meshAttributes[GetObjectIdentity(mesh)];
+
+        // An attribute filled again, like moved texture coordinates, replaces the one recorded before.
+        auto existing = find_if(attributes.begin(), attributes.end(), [&](const RecordedAttribute& recorded)
+        {
+            return recorded.semantic == attribute.semantic;
+        });
+
+        if (existing != attributes.end())
+        {
+            *existing = attribute;
+        }
+        else
+        {
+            attributes.push_back(attribute);
+        }
+    }
+
+    void
+    SceneCacheWriter::RecordMipmapLevel(
+        const CompositionMipmapSurface& mipmap,
+        UINT level,
+        UINT width,
+        UINT height,
+        const BYTE* pixels,
+        UINT pitch,
+        const TexelUsage& usage)
+    {
+        auto& levels = m_surfaceLevels[GetObjectIdentity(mipmap)];
+
+        // Levels are recorded in order; anything else means the surface was redrawn.
+        if (levels.size() != level)
+        {
+            levels.clear();
+
+            if (level != 0)
+            {
+                return;
+            }
+        }
+
+        const size_t texelCount = static_cast<size_t>(width) * height;
+        vector<uint8_t> packed;
+
+        if (pitch != width * 4)
+        {
+            packed.resize(texelCount * 4);
+
+            for (UINT y = 0; y < height; ++y)
+            {
+                memcpy(packed.data() + static_cast<size_t>(y) * width * 4, pixels + static_cast<size_t>(y) * pitch, static_cast<size_t>(width) * 4);
+            }
+
+            pixels = packed.data();
+        }
+
+        RecordedLevel recordedLevel;
+        recordedLevel.width = width;
+        recordedLevel.height = height;
+
+        // Each level on its own: filtering keeps a texture opaque or gray, but shortens normals.
+        recordedLevel.layout = ChooseTexelLayout(AnalyzeTexels(pixels, texelCount), usage);
+
+        if (recordedLevel.layout == TexelLayout::Bgra8)
+        {
+            recordedLevel.streamIndex = m_contents.AppendStream(pixels, texelCount * 4);
+        }
+        else
+        {
+            vector<uint8_t> narrowed(texelCount * GetTexelLayoutBytes(recordedLevel.layout));
+            PackTexels(recordedLevel.layout, pixels, texelCount, narrowed.data());
+
+            recordedLevel.streamIndex = m_contents.AppendStream(narrowed.data(), narrowed.size());
+        }
+
+        levels.push_back(recordedLevel);
+    }
+
+    bool
+    SceneCacheWriter::Write(const SceneNode& rootNode, const SceneMetadata& metadata, const wstring& path, const SceneCacheKey& key)
+    {
+        if (!m_isValid)
+        {
+            return false;
+        }
+
+        auto& nodes = m_contents.nodes;
+        auto& meshes = m_contents.meshes;
+        auto& attributes = m_contents.attributes;
+        auto& uvMappings = m_contents.uvMappings;
+        auto& materials = m_contents.materials;
+        auto& inputs = m_contents.inputs;
+        auto& surfaces = m_contents.surfaces;
+        auto& levels = m_contents.levels;
+
+        unordered_map<void*, int32_t> meshIndices;
+        unordered_map<void*, int32_t> materialIndices;
+        unordered_map<void*, int32_t> surfaceIndices;
+
+        auto addString = [&](const hstring& value, uint32_t* pOffset, uint32_t* pLength)
+        {
+            m_contents.AppendString(to_string(value), pOffset, pLength);
+        };
+
+        auto addSurface = [&](const CompositionMipmapSurface& mipmap) -> int32_t
+        {
+            void* identity = GetObjectIdentity(mipmap);
+
+            auto it = surfaceIndices.find(identity);
+            if (it != surfaceIndices.end())
+            {
+                return it->second;
+            }
+
+            auto recorded = m_surfaceLevels.find(identity);
+            if (recorded == m_surfaceLevels.end() || recorded->second.size() != mipmap.LevelCount())
+            {
+                return -1;
+            }
+
+            CachedSurface surface = {};
+            surface.width = mipmap.SizeInt32().Width;
+            surface.height = mipmap.SizeInt32().Height;
+            surface.pixelFormat = static_cast<int32_t>(mipmap.PixelFormat());
+            surface.alphaMode = static_cast<int32_t>(mipmap.AlphaMode());
+            surface.levelFirst = static_cast<uint32_t>(levels.size());
+            surface.levelCount = static_cast<uint32_t>(recorded->second.size());
+            addString(mipmap.Comment(), &surface.commentOffset, &surface.commentLength);
+
+            for (const auto& level : recorded->second)
+            {
+                levels.push_back({ level.width, level.height, static_cast<uint32_t>(level.layout), level.streamIndex });
+            }
+
+            int32_t index = static_cast<int32_t>(surfaces.size());
+            surfaces.push_back(surface);
+            surfaceIndices.emplace(identity, index);
+
+            return index;
+        };
+
+        auto addInput = [&](const SceneMaterialInput& materialInput, int32_t* pIndex) -> bool
+        {
+            *pIndex = -1;
+
+            if (!materialInput)
+            {
+                return true;
+            }
+
+            auto surfaceInput = materialInput.try_as<SceneSurfaceMaterialInput>();
+            if (!surfaceInput)
+            {
+                return false;
+            }
+
+            auto mipmap = surfaceInput.Surface().try_as<CompositionMipmapSurface>();
+            if (!mipmap)
+            {
+                return false;
+            }
+
+            CachedInput input;
+            input.surface = addSurface(mipmap);
+            input.interpolationMode = static_cast<int32_t>(surfaceInput.BitmapInterpolationMode());
+            input.wrappingUMode = static_cast<int32_t>(surfaceInput.WrappingUMode());
+            input.wrappingVMode = static_cast<int32_t>(surfaceInput.WrappingVMode());
+
+            if (input.surface < 0)
+            {
+                return false;
+            }
+
+            *pIndex = static_cast<int32_t>(inputs.size());
+            inputs.push_back(input);
+
+            return true;
+        };
+
+        auto addMaterial = [&](const SceneMaterial& sceneMaterial, int32_t* pIndex) -> bool
+        {
+            *pIndex = -1;
+
+            if (!sceneMaterial)
+            {
+                return true;
+            }
+
+            void* identity = GetObjectIdentity(sceneMaterial);
+
+            auto it = materialIndices.find(identity);
+            if (it != materialIndices.end())
+            {
+                *pIndex = it->second;
+                return true;
+            }
+
+            auto material = sceneMaterial.try_as<SceneMetallicRoughnessMaterial>();
+            if (!material)
+            {
+                return false;
+            }
+
+            CachedMaterial cached = {};
+            float4 baseColor = material.BaseColorFactor();
+            float3 emissive = material.EmissiveFactor();
+            cached.baseColorFactor[0] = baseColor.x;
+            cached.baseColorFactor[1] = baseColor.y;
+            cached.baseColorFactor[2] = baseColor.z;
+            cached.baseColorFactor[3] = baseColor.w;
+            cached.emissiveFactor[0] = emissive.x;
+            cached.emissiveFactor[1] = emissive.y;
+            cached.emissiveFactor[2] = emissive.z;
+            cached.metallicFactor = material.MetallicFactor();
+            cached.roughnessFactor = material.RoughnessFactor();
+            cached.normalScale = material.NormalScale();
+            cached.occlusionStrength = material.OcclusionStrength();
+            cached.alphaCutoff = material.AlphaCutoff();
+            cached.alphaMode = static_cast<int32_t>(material.AlphaMode());
+            cached.isDoubleSided = material.IsDoubleSided() ? 1 : 0;
+            addString(material.Comment(), &cached.commentOffset, &cached.commentLength);
+
+            if (!addInput(material.BaseColorInput(), &cached.inputs[0]) ||
+                !addInput(material.MetallicRoughnessInput(), &cached.inputs[1]) ||
+                !addInput(material.NormalInput(), &cached.inputs[2]) ||
+                !addInput(material.OcclusionInput(), &cached.inputs[3]) ||
+                !addInput(material.EmissiveInput(), &cached.inputs[4]))
+            {
+                return false;
+            }
+
+            *pIndex = static_cast<int32_t>(materials.size());
+            materials.push_back(cached);
+            materialIndices.emplace(identity, *pIndex);
+
+            return true;
+        };
+
+        auto addMesh = [&](const SceneMesh& mesh, int32_t* pIndex) -> bool
+        {
+            void* identity = GetObjectIdentity(mesh);
+
+            auto it = meshIndices.find(identity);
+            if (it != meshIndices.end())
+            {
+                *pIndex = it->second;
+                return true;
+            }
+
+            auto recorded = m_meshAttributes.find(identity);
+            if (recorded == m_meshAttributes.end())
+            {
+                return false;
+            }
+
+            CachedMesh cached;
+            cached.topology = static_cast<int32_t>(mesh.PrimitiveTopology());
+            cached.attributeFirst = static_cast<uint32_t>(attributes.size());
+            cached.attributeCount = static_cast<uint32_t>(recorded->second.size());
+
+            for (const auto& attribute : recorded->second)
+            {
+                attributes.push_back({ attribute.semantic, attribute.format, attribute.streamIndex });
+            }
+
+            *pIndex = static_cast<int32_t>(meshes.size());
+            meshes.push_back(cached);
+            meshIndices.emplace(identity, *pIndex);
+
+            return true;
+        };
+
+        // Pre-order walk of everything below rootNode.
+        vector<pair<SceneNode, int32_t>> pending;
+
+        for (int32_t i = static_cast<int32_t>(rootNode.Children().Size()) - 1; i >= 0; --i)
+        {
+            pending.emplace_back(rootNode.Children().GetAt(i), -1);
+        }
+
+        while (!pending.empty())
+        {
+            SceneNode node = pending.back().first;
+            int32_t parent = pending.back().second;
+            pending.pop_back();
+
+            CachedNode cached = {};
+            cached.parent = parent;
+            cached.mesh = -1;
+            cached.material = -1;
+            addString(node.Comment(), &cached.commentOffset, &cached.commentLength);
+
+            float3 scale = node.Transform().Scale();
+            quaternion orientation = node.Transform().Orientation();
+            float3 translation = node.Transform().Translation();
+            cached.scale[0] = scale.x;
+            cached.scale[1] = scale.y;
+            cached.scale[2] = scale.z;
+            cached.orientation[0] = orientation.x;
+            cached.orientation[1] = orientation.y;
+            cached.orientation[2] = orientation.z;
+            cached.orientation[3] = orientation.w;
+            cached.translation[0] = translation.x;
+            cached.translation[1] = translation.y;
+            cached.translation[2] = translation.z;
+
+            for (const auto& component : node.Components())
+            {
+                auto renderer = component.try_as<SceneMeshRendererComponent>();
+
+                if (!renderer || cached.mesh >= 0)
+                {
+                    // Only one mesh renderer per node is produced by the loader.
+                    return false;
+                }
+
+                if (!addMesh(renderer.Mesh(), &cached.mesh) || !addMaterial(renderer.Material(), &cached.material))
+                {
+                    return false;
+                }
+
+                cached.uvMappingFirst = static_cast<uint32_t>(uvMappings.size());
+
+                for (const auto& mapping : renderer.UVMappings())
+                {
+                    CachedUVMapping uvMapping;
+                    addString(mapping.Key(), &uvMapping.nameOffset, &uvMapping.nameLength);
+                    uvMapping.semantic = static_cast<int32_t>(mapping.Value());
+                    uvMappings.push_back(uvMapping);
+                }
+
+                cached.uvMappingCount = static_cast<uint32_t>(uvMappings.size()) - cached.uvMappingFirst;
+            }
+
+            int32_t nodeIndex = static_cast<int32_t>(nodes.size());
+            nodes.push_back(cached);
+
+            for (int32_t i = static_cast<int32_t>(node.Children().Size()) - 1; i >= 0; --i)
+            {
+                pending.emplace_back(node.Children().GetAt(i), nodeIndex);
+            }
+        }
+
+        m_contents.SetMetadata(metadata);
+
+        return m_contents.Write(path, key);
+    }
+
+    SceneCacheReader::SceneCacheReader(unique_ptr<SceneCacheFile> file) :
+        m_file(move(file))
+    {
+    }
+
+    unique_ptr<SceneCacheReader>
+    SceneCacheReader::Open(const wstring& path, const SceneCacheKey& key)
+    {
+        auto file = SceneCacheFile::Open(path, key);
+
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        return unique_ptr<SceneCacheReader>(new SceneCacheReader(move(file)));
+    }
+
+    hstring
+    SceneCacheReader::String(uint32_t offset, uint32_t length) const
+    {
+        return to_hstring(m_file->String(offset, length));
+    }
+
+    void
+    SceneCacheReader::BuildScene(
+        Compositor compositor,
+        ICompositionGraphicsDevice3 graphicsDevice,
+        SceneNode rootNode) const
+    {
+        const auto& header = m_file->Header();
+
+        auto streamData = [&](uint32_t stream)
+        {
+            return const_cast<BYTE*>(m_file->StreamData(stream));
+        };
+
+        // Surfaces
+        vector<CompositionMipmapSurface> surfaces;
+        const CachedSurface* pSurfaces = m_file->Table<CachedSurface>(header.surfaces);
+        const CachedLevel* pLevels = m_file->Table<CachedLevel>(header.levels);
+        vector<uint8_t> unpacked;
+
+        for (uint64_t i = 0; i < header.surfaces.count; ++i)
+        {
+            const CachedSurface& cached = pSurfaces[i];
+
+            auto mipmap = graphicsDevice.CreateMipmapSurface(
+                SizeInt32{ cached.width, cached.height },
+                static_cast<DirectXPixelFormat>(cached.pixelFormat),
+                static_cast<DirectXAlphaMode>(cached.alphaMode));
+            mipmap.Comment(String(cached.commentOffset, cached.commentLength));
+
+            UINT levelCount = min(static_cast<UINT>(cached.levelCount), mipmap.LevelCount());
+
+            for (UINT level = 0; level < levelCount; ++level)
+            {
+                const CachedLevel& cachedLevel = pLevels[cached.levelFirst + level];
+                const TexelLayout layout = static_cast<TexelLayout>(cachedLevel.layout);
+                const BYTE* pixels = streamData(cachedLevel.stream);
+
+                // Only narrowed levels are copied; full ones go straight from the mapped pages.
+                if (layout != TexelLayout::Bgra8)
+                {
+                    const size_t texelCount = static_cast<size_t>(cachedLevel.width) * cachedLevel.height;
+                    unpacked.resize(texelCount * 4);
+                    UnpackTexels(layout, pixels, texelCount, unpacked.data());
+
+                    pixels = unpacked.data();
+                }
+
+                UploadMipmapLevel(mipmap, level, cachedLevel.width, cachedLevel.height, pixels, cachedLevel.width * 4);
+            }
+
+            surfaces.push_back(mipmap);
+        }
+
+        // Materials
+        vector<SceneMetallicRoughnessMaterial> materials;
+        const CachedMaterial* pMaterials = m_file->Table<CachedMaterial>(header.materials);
+        const CachedInput* pInputs = m_file->Table<CachedInput>(header.inputs);
+
+        auto createInput = [&](int32_t index) -> SceneSurfaceMaterialInput
+        {
+            if (index < 0)
+            {
+                return nullptr;
+            }
+
+            const CachedInput& cached = pInputs[index];
+
+            auto input = SceneSurfaceMaterialInput::Create(compositor);
+            input.Surface(surfaces[cached.surface]);
+            input.BitmapInterpolationMode(static_cast<CompositionBitmapInterpolationMode>(cached.interpolationMode));
+            input.WrappingUMode(static_cast<SceneWrappingMode>(cached.wrappingUMode));
+            input.WrappingVMode(static_cast<SceneWrappingMode>(cached.wrappingVMode));
+
+            return input;
+        };
+
+        for (uint64_t i = 0; i < header.materials.count; ++i)
+        {
+            const CachedMaterial& cached = pMaterials[i];
+
+            auto material = SceneMetallicRoughnessMaterial::Create(compositor);
+            material.Comment(String(cached.commentOffset, cached.commentLength));
+
+            if (auto input = createInput(cached.inputs[0])) { material.BaseColorInput(input); }
+            if (auto input = createInput(cached.inputs[1])) { material.MetallicRoughnessInput(input); }
+            if (auto input = createInput(cached.inputs[2])) { material.NormalInput(input); }
+            if (auto input = createInput(cached.inputs[3])) { material.OcclusionInput(input); }
+            if (auto input = createInput(cached.inputs[4])) { material.EmissiveInput(input); }
+
+            material.BaseColorFactor({ cached.baseColorFactor[0], cached.baseColorFactor[1], cached.baseColorFactor[2], cached.baseColorFactor[3] });
+            material.EmissiveFactor({ cached.emissiveFactor[0], cached.emissiveFactor[1], cached.emissiveFactor[2] });
+            material.MetallicFactor(cached.metallicFactor);
+            material.RoughnessFactor(cached.roughnessFactor);
+            material.NormalScale(cached.normalScale);
+            material.OcclusionStrength(cached.occlusionStrength);
+            material.AlphaMode(static_cast<SceneAlphaMode>(cached.alphaMode));
+            material.AlphaCutoff(cached.alphaCutoff);
+            material.IsDoubleSided(cached.isDoubleSided != 0);
+
+            materials.push_back(material);
+        }
+
+        // Meshes
+        vector<SceneMesh> meshes;
+        const CachedMesh* pMeshes = m_file->Table<CachedMesh>(header.meshes);
+        const CachedAttribute* pAttributes = m_file->Table<CachedAttribute>(header.attributes);
+
+        for (uint64_t i = 0; i < header.meshes.count; ++i)
+        {
+            const CachedMesh& cached = pMeshes[i];
+
+            auto mesh = SceneMesh::Create(compositor);
+            mesh.PrimitiveTopology(static_cast<DirectXPrimitiveTopology>(cached.topology));
+
+            for (uint32_t a = 0; a < cached.attributeCount; ++a)
+            {
+                const CachedAttribute& attribute = pAttributes[cached.attributeFirst + a];
+
+                mesh.FillMeshAttribute(
+                    static_cast<SceneAttributeSemantic>(attribute.semantic),
+                    static_cast<DirectXPixelFormat>(attribute.format),
+                    CopyArrayOfBytesToMemoryBuffer(streamData(attribute.stream), static_cast<size_t>(m_file->StreamByteLength(attribute.stream))));
+            }
+
+            meshes.push_back(mesh);
+        }
+
+        // Nodes
+        vector<SceneNode> nodes;
+        const CachedNode* pNodes = m_file->Table<CachedNode>(header.nodes);
+        const CachedUVMapping* pUVMappings = m_file->Table<CachedUVMapping>(header.uvMappings);
+
+        for (uint64_t i = 0; i < header.nodes.count; ++i)
+        {
+            const CachedNode& cached = pNodes[i];
+
+            auto node = SceneNode::Create(compositor);
+            node.Comment(String(cached.commentOffset, cached.commentLength));
+            node.Transform().Scale({ cached.scale[0], cached.scale[1], cached.scale[2] });
+            node.Transform().Orientation({ cached.orientation[0], cached.orientation[1], cached.orientation[2], cached.orientation[3] });
+            node.Transform().Translation({ cached.translation[0], cached.translation[1], cached.translation[2] });
+
+            if (cached.mesh >= 0)
+            {
+                auto renderComponent = SceneMeshRendererComponent::Create(compositor);
+                renderComponent.Mesh(meshes[cached.mesh]);
+
+                if (cached.material >= 0)
+                {
+                    renderComponent.Material(materials[cached.material]);
+                }
+
+                for (uint32_t m = 0; m < cached.uvMappingCount; ++m)
+                {
+                    const CachedUVMapping& uvMapping = pUVMappings[cached.uvMappingFirst + m];
+                    renderComponent.UVMappings().Insert(String(uvMapping.nameOffset, uvMapping.nameLength), static_cast<SceneAttributeSemantic>(uvMapping.semantic));
+                }
+
+                node.Components().Append(renderComponent);
+            }
+
+            if (cached.parent < 0)
+            {
+                rootNode.Children().Append(node);
+            }
+            else
+            {
+                nodes[cached.parent].Children().Append(node);
+            }
+
+            nodes.push_back(node);
+        }
+    }
+} // namespace SceneLoader
@@ -0,0 +1,92 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneCacheFile.h"
+#include "TexelAnalysis.h"
+
+namespace SceneLoader
+{
+    // Collects the decoded vertex/index streams and mip levels while a scene is loaded,
+    // then writes them together with the node, material and surface tables of the
+    // finished SceneNode tree, see SceneCacheContents.
+    class SceneCacheWriter
+    {
+    public:
+        void RecordMeshAttribute(
+            const winrt::Windows::UI::Composition::Scenes::SceneMesh& mesh,
+            winrt::Windows::UI::Composition::Scenes::SceneAttributeSemantic semantic,
+            winrt::Windows::Graphics::DirectX::DirectXPixelFormat format,
+            const void* data,
+            size_t byteLength);
+
+        void RecordMipmapLevel(
+            const winrt::Windows::UI::Composition::CompositionMipmapSurface& mipmap,
+            UINT level,
+            UINT width,
+            UINT height,
+            const BYTE* pixels,
+            UINT pitch,
+            const TexelUsage& usage);
+
+        // The scene uses something the cache can't represent; Write will do nothing.
+        void Invalidate() { m_isValid = false; }
+
+        // Returns false if the tree uses objects that were not recorded, or the file can't be written.
+        // The metadata is stored with the tree, so loads from the cache return it as well.
+        bool Write(
+            const winrt::Windows::UI::Composition::Scenes::SceneNode& rootNode,
+            const SceneMetadata& metadata,
+            const std::wstring& path,
+            const SceneCacheKey& key);
+
+    private:
+        struct RecordedAttribute
+        {
+            int32_t semantic;
+            int32_t format;
+            uint32_t streamIndex;
+        };
+
+        struct RecordedLevel
+        {
+            uint32_t width;
+            uint32_t height;
+            TexelLayout layout;
+            uint32_t streamIndex;
+        };
+
+        // Keyed by COM identity, see GetObjectIdentity.
+        std::unordered_map<void*, std::vector<RecordedAttribute>> m_meshAttributes;
+        std::unordered_map<void*, std::vector<RecordedLevel>> m_surfaceLevels;
+
+        SceneCacheContents m_contents;
+
+        bool m_isValid = true;
+    };
+
+    // Creates the scene objects of a SceneCacheFile and uploads vertex, index and pixel data
+    // straight from the mapped pages.
+    class SceneCacheReader
+    {
+    public:
+        // Returns nullptr if there is no usable cache file for this key.
+        static std::unique_ptr<SceneCacheReader> Open(const std::wstring& path, const SceneCacheKey& key);
+
+        void BuildScene(
+            winrt::Windows::UI::Composition::Compositor compositor,
+            winrt::Windows::UI::Composition::ICompositionGraphicsDevice3 graphicsDevice,
+            winrt::Windows::UI::Composition::Scenes::SceneNode rootNode) const;
+
+        SceneMetadata ReadMetadata() const { return m_file->ReadMetadata(); }
+
+    private:
+        SceneCacheReader(std::unique_ptr<SceneCacheFile> file);
+
+        winrt::hstring String(uint32_t offset, uint32_t length) const;
+
+        std::unique_ptr<SceneCacheFile> m_file;
+    };
+} // SceneLoader
@@ -0,0 +1,512 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "ContentHash.h"
+#include "MipChain.h"
+#include "TexelAnalysis.h"
+#include "SceneCacheFile.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static constexpr char c_cacheMagic[8] = { 'S', 'L', 'C', 'A', 'C', 'H', 'E', '\0' };
+    static constexpr uint32_t c_cacheFormatVersion = 4;
+    static constexpr size_t c_cacheAlignment = 16;
+
+    static size_t AlignUp(size_t value)
+    {
+        return (value + c_cacheAlignment - 1) & ~(c_cacheAlignment - 1);
+    }
+
+    // Creates a file next to path under a random name and opens it for writing. Creation fails
+    // if the name is taken, so writers in this process or another never share a file.
+    static FILE* CreateTemporaryFile(const wstring& path, wstring* pTemporaryPath)
+    {
+        random_device random;
+
+        for (int attempt = 0; attempt < 8; ++attempt)
+        {
+            wchar_t name[32];
+            swprintf(name, size(name), L".%08x%08x.tmp", random(), random());
+
+            *pTemporaryPath = path + name;
+
+#ifdef _WIN32
+            FILE* file = nullptr;
+            const errno_t error = _wfopen_s(&file, pTemporaryPath->c_str(), L"wbx");
+#else
+            FILE* file = fopen(filesystem::path(*pTemporaryPath).c_str(), "wbx");
+            const int error = file ? 0 : errno;
+#endif
+
+            if (file)
+            {
+                return file;
+            }
+
+            if (error != EEXIST)
+            {
+                return nullptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static bool IsTableInFile(const CacheTable& table, size_t elementSize, uint64_t fileSize)
+    {
+        return table.offset % c_cacheAlignment == 0 &&
+            table.offset <= fileSize &&
+            table.count <= (fileSize - table.offset) / elementSize;
+    }
+
+    static bool IsRangeInTable(uint64_t first, uint64_t count, uint64_t tableCount)
+    {
+        return first <= tableCount && count <= tableCount - first;
+    }
+
+    // Levels in the whole mip chain of a surface, down to 1x1.
+    static uint32_t GetMipChainLength(uint32_t width, uint32_t height)
+    {
+        uint32_t length = 1;
+
+        while (width > 1 || height > 1)
+        {
+            width = NextMipDimension(width);
+            height = NextMipDimension(height);
+            ++length;
+        }
+
+        return length;
+    }
+
+    wstring
+    GetSceneCachePath(const wstring& cacheFolder, const SceneCacheKey& key)
+    {
+        wstringstream name;
+        name << hex << setw(16) << setfill(L'0') << key.contentHash << L'-' << dec << c_sceneCacheLoaderVersion << L".slcache";
+
+        return (filesystem::path(cacheFolder) / name.str()).wstring();
+    }
+
+    uint32_t
+    SceneCacheContents::AppendStream(const void* data, size_t byteLength)
+    {
+        uint64_t hash = ComputeContentHash(data, byteLength);
+
+        auto range = m_streamsByHash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const auto& stream = m_streams[it->second];
+
+            if (stream.second == byteLength && memcmp(m_blob.data() + stream.first, data, byteLength) == 0)
+            {
+                return it->second;
+            }
+        }
+
+        size_t offset = AlignUp(m_blob.size());
+        m_blob.resize(offset + byteLength);
+        memcpy(m_blob.data() + offset, data, byteLength);
+
+        uint32_t streamIndex = static_cast<uint32_t>(m_streams.size());
+        m_streams.emplace_back(offset, byteLength);
+        m_streamsByHash.emplace(hash, streamIndex);
+
+        return streamIndex;
+    }
+
+    void
+    SceneCacheContents::AppendString(string_view value, uint32_t* pOffset, uint32_t* pLength)
+    {
+        *pOffset = static_cast<uint32_t>(m_strings.size());
+        *pLength = static_cast<uint32_t>(value.size());
+        m_strings.append(value);
+    }
+
+    void
+    SceneCacheContents::SetMetadata(const SceneMetadata& metadata)
+    {
+        memcpy(m_metadata.boxMin, metadata.box.min, sizeof(m_metadata.boxMin));
+        memcpy(m_metadata.boxMax, metadata.box.max, sizeof(m_metadata.boxMax));
+        memcpy(m_metadata.sphereCenter, metadata.sphere.center, sizeof(m_metadata.sphereCenter));
+        m_metadata.sphereRadius = metadata.sphere.radius;
+        m_metadata.nodeCount = metadata.nodeCount;
+        m_metadata.primitiveCount = metadata.primitiveCount;
+        m_metadata.vertexCount = metadata.vertexCount;
+        m_metadata.drawnTriangleCount = metadata.drawnTriangleCount;
+
+        m_nodeBounds.clear();
+        m_nodeBounds.reserve(metadata.nodeBounds.size());
+
+        for (const auto& bounds : metadata.nodeBounds)
+        {
+            CachedNodeBounds cached = {};
+            AppendString(bounds.nodeId, &cached.idOffset, &cached.idLength);
+            memcpy(cached.min, bounds.box.min, sizeof(cached.min));
+            memcpy(cached.max, bounds.box.max, sizeof(cached.max));
+
+            m_nodeBounds.push_back(cached);
+        }
+    }
+
+    bool
+    SceneCacheContents::Write(const wstring& path, const SceneCacheKey& key) const
+    {
+        CacheHeader header = {};
+        memcpy(header.magic, c_cacheMagic, sizeof(header.magic));
+        header.formatVersion = c_cacheFormatVersion;
+        header.loaderVersion = c_sceneCacheLoaderVersion;
+        header.contentHash = key.contentHash;
+        header.contentSize = key.contentSize;
+
+        size_t fileSize = AlignUp(sizeof(CacheHeader));
+
+        auto placeTable = [&](CacheTable* pTable, size_t count, size_t elementSize)
+        {
+            pTable->offset = fileSize;
+            pTable->count = count;
+            fileSize = AlignUp(fileSize + count * elementSize);
+        };
+
+        placeTable(&header.nodes, nodes.size(), sizeof(CachedNode));
+        placeTable(&header.meshes, meshes.size(), sizeof(CachedMesh));
+        placeTable(&header.attributes, attributes.size(), sizeof(CachedAttribute));
+        placeTable(&header.uvMappings, uvMappings.size(), sizeof(CachedUVMapping));
+        placeTable(&header.materials, materials.size(), sizeof(CachedMaterial));
+        placeTable(&header.inputs, inputs.size(), sizeof(CachedInput));
+        placeTable(&header.surfaces, surfaces.size(), sizeof(CachedSurface));
+        placeTable(&header.levels, levels.size(), sizeof(CachedLevel));
+        placeTable(&header.streams, m_streams.size(), sizeof(CachedStream));
+        placeTable(&header.strings, m_strings.size(), sizeof(char));
+        placeTable(&header.metadata, 1, sizeof(CachedMetadata));
+        placeTable(&header.nodeBounds, m_nodeBounds.size(), sizeof(CachedNodeBounds));
+
+        const size_t blobOffset = fileSize;
+        fileSize += m_blob.size();
+        header.fileSize = fileSize;
+
+        vector<CachedStream> streams;
+        streams.reserve(m_streams.size());
+
+        for (const auto& stream : m_streams)
+        {
+            streams.push_back({ blobOffset + stream.first, stream.second });
+        }
+
+        // Loads of the same scene, in this process or another, write temporary files of their own.
+        wstring temporaryPath;
+        error_code error;
+
+        {
+            FILE* file = CreateTemporaryFile(path, &temporaryPath);
+
+            if (!file)
+            {
+                return false;
+            }
+
+            // The tables come in the order of their offsets, so the file is written front to
+            // back, with zeros in the padding, and ends at fileSize.
+            uint64_t position = 0;
+            bool isWritten = true;
+
+            auto writeAt = [&](uint64_t offset, const void* data, size_t byteLength)
+            {
+                static const uint8_t c_padding[c_cacheAlignment] = {};
+                assert(offset >= position && offset - position < sizeof(c_padding));
+
+                isWritten = isWritten && fwrite(c_padding, 1, static_cast<size_t>(offset - position), file) == offset - position;
+                isWritten = isWritten && fwrite(data, 1, byteLength, file) == byteLength;
+                position = offset + byteLength;
+            };
+
+            writeAt(0, &header, sizeof(header));
+            writeAt(header.nodes.offset, nodes.data(), nodes.size() * sizeof(CachedNode));
+            writeAt(header.meshes.offset, meshes.data(), meshes.size() * sizeof(CachedMesh));
+            writeAt(header.attributes.offset, attributes.data(), attributes.size() * sizeof(CachedAttribute));
+            writeAt(header.uvMappings.offset, uvMappings.data(), uvMappings.size() * sizeof(CachedUVMapping));
+            writeAt(header.materials.offset, materials.data(), materials.size() * sizeof(CachedMaterial));
+            writeAt(header.inputs.offset, inputs.data(), inputs.size() * sizeof(CachedInput));
+            writeAt(header.surfaces.offset, surfaces.data(), surfaces.size() * sizeof(CachedSurface));
+            writeAt(header.levels.offset, levels.data(), levels.size() * sizeof(CachedLevel));
+            writeAt(header.streams.offset, streams.data(), streams.size() * sizeof(CachedStream));
+            writeAt(header.strings.offset, m_strings.data(), m_strings.size());
+            writeAt(header.metadata.offset, &m_metadata, sizeof(m_metadata));
+            writeAt(header.nodeBounds.offset, m_nodeBounds.data(), m_nodeBounds.size() * sizeof(CachedNodeBounds));
+            writeAt(blobOffset, m_blob.data(), m_blob.size());
+
+            if (fclose(file) != 0 || !isWritten)
+            {
+                filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        filesystem::rename(temporaryPath, path, error);
+
+        if (error)
+        {
+            filesystem::remove(temporaryPath, error);
+            return false;
+        }
+
+        return true;
+    }
+
+    SceneCacheFile::SceneCacheFile(unique_ptr<MappedFile> file) :
+        m_file(move(file))
+    {
+    }
+
+    unique_ptr<SceneCacheFile>
+    SceneCacheFile::Open(const wstring& path, const SceneCacheKey& key)
+    {
+        auto file = MappedFile::Open(path);
+
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        unique_ptr<SceneCacheFile> cacheFile(new SceneCacheFile(move(file)));
+
+        if (!cacheFile->Validate(key))
+        {
+            return nullptr;
+        }
+
+        return cacheFile;
+    }
+
+    bool
+    SceneCacheFile::Validate(const SceneCacheKey& key) const
+    {
+        const uint64_t fileSize = m_file->Size();
+
+        if (fileSize < sizeof(CacheHeader))
+        {
+            return false;
+        }
+
+        const auto& header = Header();
+
+        if (memcmp(header.magic, c_cacheMagic, sizeof(header.magic)) != 0 ||
+            header.formatVersion != c_cacheFormatVersion ||
+            header.loaderVersion != c_sceneCacheLoaderVersion ||
+            header.contentHash != key.contentHash ||
+            header.contentSize != key.contentSize ||
+            header.fileSize != fileSize)
+        {
+            return false;
+        }
+
+        if (!IsTableInFile(header.nodes, sizeof(CachedNode), fileSize) ||
+            !IsTableInFile(header.meshes, sizeof(CachedMesh), fileSize) ||
+            !IsTableInFile(header.attributes, sizeof(CachedAttribute), fileSize) ||
+            !IsTableInFile(header.uvMappings, sizeof(CachedUVMapping), fileSize) ||
+            !IsTableInFile(header.materials, sizeof(CachedMaterial), fileSize) ||
+            !IsTableInFile(header.inputs, sizeof(CachedInput), fileSize) ||
+            !IsTableInFile(header.surfaces, sizeof(CachedSurface), fileSize) ||
+            !IsTableInFile(header.levels, sizeof(CachedLevel), fileSize) ||
+            !IsTableInFile(header.streams, sizeof(CachedStream), fileSize) ||
+            !IsTableInFile(header.strings, sizeof(char), fileSize) ||
+            !IsTableInFile(header.metadata, sizeof(CachedMetadata), fileSize) ||
+            !IsTableInFile(header.nodeBounds, sizeof(CachedNodeBounds), fileSize) ||
+            header.metadata.count != 1)
+        {
+            return false;
+        }
+
+        auto isStringValid = [&](uint32_t offset, uint32_t length)
+        {
+            return IsRangeInTable(offset, length, header.strings.count);
+        };
+
+        auto isIndexValid = [](int32_t index, uint64_t count)
+        {
+            return index < 0 || static_cast<uint64_t>(index) < count;
+        };
+
+        const CachedStream* pStreams = Table<CachedStream>(header.streams);
+
+        for (uint64_t i = 0; i < header.streams.count; ++i)
+        {
+            if (pStreams[i].offset > fileSize || pStreams[i].byteLength > fileSize - pStreams[i].offset)
+            {
+                return false;
+            }
+        }
+
+        const CachedNodeBounds* pNodeBounds = Table<CachedNodeBounds>(header.nodeBounds);
+
+        for (uint64_t i = 0; i < header.nodeBounds.count; ++i)
+        {
+            if (!isStringValid(pNodeBounds[i].idOffset, pNodeBounds[i].idLength))
+            {
+                return false;
+            }
+        }
+
+        const CachedNode* pNodes = Table<CachedNode>(header.nodes);
+
+        for (uint64_t i = 0; i < header.nodes.count; ++i)
+        {
+            const CachedNode& node = pNodes[i];
+
+            if (node.parent >= static_cast<int64_t>(i) ||
+                !isIndexValid(node.mesh, header.meshes.count) ||
+                !isIndexValid(node.material, header.materials.count) ||
+                !IsRangeInTable(node.uvMappingFirst, node.uvMappingCount, header.uvMappings.count) ||
+                !isStringValid(node.commentOffset, node.commentLength))
+            {
+                return false;
+            }
+        }
+
+        const CachedMesh* pMeshes = Table<CachedMesh>(header.meshes);
+
+        for (uint64_t i = 0; i < header.meshes.count; ++i)
+        {
+            if (!IsRangeInTable(pMeshes[i].attributeFirst, pMeshes[i].attributeCount, header.attributes.count))
+            {
+                return false;
+            }
+        }
+
+        const CachedAttribute* pAttributes = Table<CachedAttribute>(header.attributes);
+
+        for (uint64_t i = 0; i < header.attributes.count; ++i)
+        {
+            if (pAttributes[i].stream >= header.streams.count)
+            {
+                return false;
+            }
+        }
+
+        const CachedUVMapping* pUVMappings = Table<CachedUVMapping>(header.uvMappings);
+
+        for (uint64_t i = 0; i < header.uvMappings.count; ++i)
+        {
+            if (!isStringValid(pUVMappings[i].nameOffset, pUVMappings[i].nameLength))
+            {
+                return false;
+            }
+        }
+
+        const CachedMaterial* pMaterials = Table<CachedMaterial>(header.materials);
+
+        for (uint64_t i = 0; i < header.materials.count; ++i)
+        {
+            for (int32_t input : pMaterials[i].inputs)
+            {
+                if (!isIndexValid(input, header.inputs.count))
+                {
+                    return false;
+                }
+            }
+
+            if (!isStringValid(pMaterials[i].commentOffset, pMaterials[i].commentLength))
+            {
+                return false;
+            }
+        }
+
+        const CachedInput* pInputs = Table<CachedInput>(header.inputs);
+
+        for (uint64_t i = 0; i < header.inputs.count; ++i)
+        {
+            if (pInputs[i].surface < 0 || static_cast<uint64_t>(pInputs[i].surface) >= header.surfaces.count)
+            {
+                return false;
+            }
+        }
+
+        const CachedLevel* pLevels = Table<CachedLevel>(header.levels);
+
+        for (uint64_t i = 0; i < header.levels.count; ++i)
+        {
+            if (pLevels[i].stream >= header.streams.count ||
+                pLevels[i].layout >= c_texelLayoutCount ||
+                pStreams[pLevels[i].stream].byteLength != static_cast<uint64_t>(pLevels[i].width) * pLevels[i].height * GetTexelLayoutBytes(static_cast<TexelLayout>(pLevels[i].layout)))
+            {
+                return false;
+            }
+        }
+
+        const CachedSurface* pSurfaces = Table<CachedSurface>(header.surfaces);
+
+        for (uint64_t i = 0; i < header.surfaces.count; ++i)
+        {
+            const CachedSurface& surface = pSurfaces[i];
+
+            if (surface.width <= 0 || surface.height <= 0)
+            {
+                return false;
+            }
+
+            uint32_t width = static_cast<uint32_t>(surface.width);
+            uint32_t height = static_cast<uint32_t>(surface.height);
+
+            if (surface.levelCount == 0 ||
+                surface.levelCount > GetMipChainLength(width, height) ||
+                !IsRangeInTable(surface.levelFirst, surface.levelCount, header.levels.count) ||
+                !isStringValid(surface.commentOffset, surface.commentLength))
+            {
+                return false;
+            }
+
+            // Each level is uploaded at the size it is stored at, which has to be the size of
+            // that level of the surface.
+
+            for (uint32_t level = 0; level < surface.levelCount; ++level)
+            {
+                const CachedLevel& cachedLevel = pLevels[surface.levelFirst + level];
+
+                if (cachedLevel.width != width || cachedLevel.height != height)
+                {
+                    return false;
+                }
+
+                width = NextMipDimension(width);
+                height = NextMipDimension(height);
+            }
+        }
+
+        return true;
+    }
+
+    SceneMetadata
+    SceneCacheFile::ReadMetadata() const
+    {
+        const auto& header = Header();
+        const CachedMetadata& cached = *Table<CachedMetadata>(header.metadata);
+
+        SceneMetadata metadata;
+        memcpy(metadata.box.min, cached.boxMin, sizeof(metadata.box.min));
+        memcpy(metadata.box.max, cached.boxMax, sizeof(metadata.box.max));
+        memcpy(metadata.sphere.center, cached.sphereCenter, sizeof(metadata.sphere.center));
+        metadata.sphere.radius = cached.sphereRadius;
+        metadata.nodeCount = cached.nodeCount;
+        metadata.primitiveCount = cached.primitiveCount;
+        metadata.vertexCount = cached.vertexCount;
+        metadata.drawnTriangleCount = cached.drawnTriangleCount;
+
+        const CachedNodeBounds* pNodeBounds = Table<CachedNodeBounds>(header.nodeBounds);
+        metadata.nodeBounds.resize(static_cast<size_t>(header.nodeBounds.count));
+
+        for (size_t i = 0; i < metadata.nodeBounds.size(); ++i)
+        {
+            NodeBounds& bounds = metadata.nodeBounds[i];
+            bounds.nodeId = String(pNodeBounds[i].idOffset, pNodeBounds[i].idLength);
+            memcpy(bounds.box.min, pNodeBounds[i].min, sizeof(bounds.box.min));
+            memcpy(bounds.box.max, pNodeBounds[i].max, sizeof(bounds.box.max));
+        }
+
+        return metadata;
+    }
+} // namespace SceneLoader
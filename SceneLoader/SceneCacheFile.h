@@ -0,0 +1,238 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "MappedFile.h"
+#include "SceneBounds.h"
+
+namespace SceneLoader
+{
+    // Bump whenever the loader produces different scene objects for the same input,
+    // so that stale cache files are ignored instead of loaded.
+    constexpr uint32_t c_sceneCacheLoaderVersion = 9;
+
+    struct SceneCacheKey
+    {
+        uint64_t contentHash;
+        uint64_t contentSize;
+    };
+
+    // <folder>\<content hash>-<loader version>.slcache
+    std::wstring GetSceneCachePath(const std::wstring& cacheFolder, const SceneCacheKey& key);
+
+    //
+    // File layout: CacheHeader, the tables it points at, a UTF-8 string table and
+    // finally the stream blob. Every table and stream starts on a 16 byte boundary.
+    //
+    struct CacheTable
+    {
+        uint64_t offset;
+        uint64_t count;
+    };
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t loaderVersion;
+        uint64_t contentHash;
+        uint64_t contentSize;
+        uint64_t fileSize;
+
+        CacheTable nodes;
+        CacheTable meshes;
+        CacheTable attributes;
+        CacheTable uvMappings;
+        CacheTable materials;
+        CacheTable inputs;
+        CacheTable surfaces;
+        CacheTable levels;
+        CacheTable streams;
+        CacheTable strings;
+        CacheTable metadata;
+        CacheTable nodeBounds;
+    };
+
+    // Nodes are stored in pre-order, so a parent always comes before its children.
+    struct CachedNode
+    {
+        int32_t parent;
+        uint32_t commentOffset;
+        uint32_t commentLength;
+        int32_t mesh;
+        int32_t material;
+        uint32_t uvMappingFirst;
+        uint32_t uvMappingCount;
+        float scale[3];
+        float orientation[4];
+        float translation[3];
+    };
+
+    struct CachedMesh
+    {
+        int32_t topology;
+        uint32_t attributeFirst;
+        uint32_t attributeCount;
+    };
+
+    struct CachedAttribute
+    {
+        int32_t semantic;
+        int32_t format;
+        uint32_t stream;
+    };
+
+    struct CachedUVMapping
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        int32_t semantic;
+    };
+
+    constexpr size_t c_cachedMaterialInputCount = 5;
+
+    // Inputs are BaseColor, MetallicRoughness, Normal, Occlusion, Emissive; -1 if unused.
+    struct CachedMaterial
+    {
+        float baseColorFactor[4];
+        float emissiveFactor[3];
+        float metallicFactor;
+        float roughnessFactor;
+        float normalScale;
+        float occlusionStrength;
+        float alphaCutoff;
+        int32_t alphaMode;
+        uint32_t isDoubleSided;
+        int32_t inputs[c_cachedMaterialInputCount];
+        uint32_t commentOffset;
+        uint32_t commentLength;
+    };
+
+    struct CachedInput
+    {
+        int32_t surface;
+        int32_t interpolationMode;
+        int32_t wrappingUMode;
+        int32_t wrappingVMode;
+    };
+
+    // The levels are the first levelCount of the mip chain of a width x height surface.
+    struct CachedSurface
+    {
+        int32_t width;
+        int32_t height;
+        int32_t pixelFormat;
+        int32_t alphaMode;
+        uint32_t levelFirst;
+        uint32_t levelCount;
+        uint32_t commentOffset;
+        uint32_t commentLength;
+    };
+
+    // Tightly packed pixels in a TexelLayout that keeps what the materials sample.
+    struct CachedLevel
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t layout;
+        uint32_t stream;
+    };
+
+    struct CachedStream
+    {
+        uint64_t offset;
+        uint64_t byteLength;
+    };
+
+    // Exactly one, a SceneMetadata without its node bounds. Empty boxes and spheres are
+    // stored as they are.
+    struct CachedMetadata
+    {
+        float boxMin[3];
+        float boxMax[3];
+        float sphereCenter[3];
+        float sphereRadius;
+        uint64_t nodeCount;
+        uint64_t primitiveCount;
+        uint64_t vertexCount;
+        uint64_t drawnTriangleCount;
+    };
+
+    struct CachedNodeBounds
+    {
+        uint32_t idOffset;
+        uint32_t idLength;
+        float min[3];
+        float max[3];
+    };
+
+    // The tables and streams of a cache file while they are put together, see SceneCacheWriter.
+    // Identical streams are stored once.
+    class SceneCacheContents
+    {
+    public:
+        std::vector<CachedNode> nodes;
+        std::vector<CachedMesh> meshes;
+        std::vector<CachedAttribute> attributes;
+        std::vector<CachedUVMapping> uvMappings;
+        std::vector<CachedMaterial> materials;
+        std::vector<CachedInput> inputs;
+        std::vector<CachedSurface> surfaces;
+        std::vector<CachedLevel> levels;
+
+        uint32_t AppendStream(const void* data, size_t byteLength);
+        void AppendString(std::string_view value, uint32_t* pOffset, uint32_t* pLength);
+
+        // Stored with the tables, so loads from the cache return it as well.
+        void SetMetadata(const SceneMetadata& metadata);
+
+        // Writes a temporary file next to path and moves it over path, so that a concurrent
+        // reader never maps a partial file. Returns false if the file can't be written.
+        bool Write(const std::wstring& path, const SceneCacheKey& key) const;
+
+    private:
+        std::string m_strings;
+        CachedMetadata m_metadata = {};
+        std::vector<CachedNodeBounds> m_nodeBounds;
+
+        std::vector<uint8_t> m_blob;
+        std::vector<std::pair<uint64_t, uint64_t>> m_streams; // offset, length
+        std::unordered_multimap<uint64_t, uint32_t> m_streamsByHash;
+    };
+
+    // A memory-mapped cache file whose tables were checked against each other and against
+    // the size of the file when it was opened, so they can be used without further checks.
+    class SceneCacheFile
+    {
+    public:
+        // Returns nullptr if there is no usable cache file for this key.
+        static std::unique_ptr<SceneCacheFile> Open(const std::wstring& path, const SceneCacheKey& key);
+
+        const CacheHeader& Header() const { return *reinterpret_cast<const CacheHeader*>(m_file->Data()); }
+
+        template<typename T>
+        const T* Table(const CacheTable& table) const
+        {
+            return reinterpret_cast<const T*>(m_file->Data() + table.offset);
+        }
+
+        const uint8_t* StreamData(uint32_t stream) const { return m_file->Data() + Table<CachedStream>(Header().streams)[stream].offset; }
+        uint64_t StreamByteLength(uint32_t stream) const { return Table<CachedStream>(Header().streams)[stream].byteLength; }
+
+        std::string_view String(uint32_t offset, uint32_t length) const
+        {
+            return std::string_view(Table<char>(Header().strings) + offset, length);
+        }
+
+        SceneMetadata ReadMetadata() const;
+
+    private:
+        SceneCacheFile(std::unique_ptr<MappedFile> file);
+
+        bool Validate(const SceneCacheKey& key) const;
+
+        std::unique_ptr<MappedFile> m_file;
+    };
+} // SceneLoader
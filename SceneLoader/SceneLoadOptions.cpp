@@ -0,0 +1,315 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+#include "SceneLoadOptions.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    hstring SceneLoadOptions::CacheFolderPath()
+    {
+        return hstring(m_options.cacheFolderPath);
+    }
+
+    void SceneLoadOptions::CacheFolderPath(hstring const& value)
+    {
+        m_options.cacheFolderPath = value;
+    }
+
+    hstring SceneLoadOptions::ResourceFolderPath()
+    {
+        return hstring(m_options.resourceFolderPath);
+    }
+
+    void SceneLoadOptions::ResourceFolderPath(hstring const& value)
+    {
+        m_options.resourceFolderPath = value;
+    }
+
+    bool SceneLoadOptions::MapResourceFiles()
+    {
+        return m_options.mapResourceFiles;
+    }
+
+    void SceneLoadOptions::MapResourceFiles(bool value)
+    {
+        m_options.mapResourceFiles = value;
+    }
+
+    winrt::Windows::Foundation::IReference<float> SceneLoadOptions::SkinningPoseTime()
+    {
+        if (!m_options.skinningPoseTime)
+        {
+            return nullptr;
+        }
+
+        return box_value(*m_options.skinningPoseTime).as<winrt::Windows::Foundation::IReference<float>>();
+    }
+
+    void SceneLoadOptions::SkinningPoseTime(winrt::Windows::Foundation::IReference<float> const& value)
+    {
+        if (value)
+        {
+            m_options.skinningPoseTime = value.Value();
+        }
+        else
+        {
+            m_options.skinningPoseTime.reset();
+        }
+    }
+
+    bool SceneLoadOptions::DeferTextureDecode()
+    {
+        return m_options.deferTextureDecode;
+    }
+
+    void SceneLoadOptions::DeferTextureDecode(bool value)
+    {
+        m_options.deferTextureDecode = value;
+    }
+
+    uint32_t SceneLoadOptions::AtlasMaxTextureSize()
+    {
+        return m_options.atlasMaxTextureSize;
+    }
+
+    void SceneLoadOptions::AtlasMaxTextureSize(uint32_t value)
+    {
+        m_options.atlasMaxTextureSize = value;
+    }
+
+    bool SceneLoadOptions::ParallelMeshDecode()
+    {
+        return m_options.parallelMeshDecode;
+    }
+
+    void SceneLoadOptions::ParallelMeshDecode(bool value)
+    {
+        m_options.parallelMeshDecode = value;
+    }
+
+    bool SceneLoadOptions::StreamingDeserialize()
+    {
+        return m_options.streamingDeserialize;
+    }
+
+    void SceneLoadOptions::StreamingDeserialize(bool value)
+    {
+        m_options.streamingDeserialize = value;
+    }
+
+    bool SceneLoadOptions::SmoothGeneratedNormals()
+    {
+        return m_options.smoothGeneratedNormals;
+    }
+
+    void SceneLoadOptions::SmoothGeneratedNormals(bool value)
+    {
+        m_options.smoothGeneratedNormals = value;
+    }
+
+    bool SceneLoadOptions::CleanUpMeshes()
+    {
+        return m_options.cleanUpMeshes;
+    }
+
+    void SceneLoadOptions::CleanUpMeshes(bool value)
+    {
+        m_options.cleanUpMeshes = value;
+    }
+
+    float SceneLoadOptions::MeshWeldTolerance()
+    {
+        return m_options.meshWeldTolerance;
+    }
+
+    void SceneLoadOptions::MeshWeldTolerance(float value)
+    {
+        if (!(value >= 0.0f))
+        {
+            throw hresult_invalid_argument(L"MeshWeldTolerance must be zero or more");
+        }
+
+        m_options.meshWeldTolerance = value;
+    }
+
+    uint32_t SceneLoadOptions::InstanceBatchMaxVertices()
+    {
+        return m_options.instanceBatchMaxVertices;
+    }
+
+    void SceneLoadOptions::InstanceBatchMaxVertices(uint32_t value)
+    {
+        m_options.instanceBatchMaxVertices = value;
+    }
+
+    uint64_t SceneLoadOptions::TriangleBudget()
+    {
+        return m_options.triangleBudget;
+    }
+
+    void SceneLoadOptions::TriangleBudget(uint64_t value)
+    {
+        m_options.triangleBudget = value;
+    }
+
+    uint32_t SceneLoadOptions::MeshTriangleBudget()
+    {
+        return m_options.meshTriangleBudget;
+    }
+
+    void SceneLoadOptions::MeshTriangleBudget(uint32_t value)
+    {
+        m_options.meshTriangleBudget = value;
+    }
+
+    uint64_t SceneLoadOptions::MaxDecodedBytes()
+    {
+        return m_options.limits.maxDecodedBytes;
+    }
+
+    void SceneLoadOptions::MaxDecodedBytes(uint64_t value)
+    {
+        m_options.limits.maxDecodedBytes = value;
+    }
+
+    uint64_t SceneLoadOptions::MaxImagePixels()
+    {
+        return m_options.limits.maxImagePixels;
+    }
+
+    void SceneLoadOptions::MaxImagePixels(uint64_t value)
+    {
+        m_options.limits.maxImagePixels = value;
+    }
+
+    uint64_t SceneLoadOptions::MaxPrimitiveVertices()
+    {
+        return m_options.limits.maxPrimitiveVertices;
+    }
+
+    void SceneLoadOptions::MaxPrimitiveVertices(uint64_t value)
+    {
+        m_options.limits.maxPrimitiveVertices = value;
+    }
+
+    uint64_t SceneLoadOptions::MaxNodeCount()
+    {
+        return m_options.limits.maxNodeCount;
+    }
+
+    void SceneLoadOptions::MaxNodeCount(uint64_t value)
+    {
+        m_options.limits.maxNodeCount = value;
+    }
+
+    uint32_t SceneLoadOptions::MaxHierarchyDepth()
+    {
+        return m_options.limits.maxHierarchyDepth;
+    }
+
+    void SceneLoadOptions::MaxHierarchyDepth(uint32_t value)
+    {
+        m_options.limits.maxHierarchyDepth = value;
+    }
+
+    winrt::Windows::Foundation::TimeSpan SceneLoadOptions::MaxLoadTime()
+    {
+        return std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(m_options.limits.maxLoadTime);
+    }
+
+    void SceneLoadOptions::MaxLoadTime(winrt::Windows::Foundation::TimeSpan const& value)
+    {
+        if (value.count() < 0)
+        {
+            throw hresult_invalid_argument(L"MaxLoadTime must be zero or more");
+        }
+
+        // Rounded up, so that a positive time never turns into no limit.
+        m_options.limits.maxLoadTime = std::chrono::ceil<std::chrono::milliseconds>(value);
+    }
+
+    float SceneLoadOptions::FitSize()
+    {
+        return m_options.fitSize;
+    }
+
+    void SceneLoadOptions::FitSize(float value)
+    {
+        if (!(value >= 0.0f && value <= FLT_MAX))
+        {
+            throw hresult_invalid_argument(L"FitSize must be zero or more");
+        }
+
+        m_options.fitSize = value;
+    }
+
+    bool SceneLoadOptions::BuildPickIndex()
+    {
+        return m_options.buildPickIndex;
+    }
+
+    void SceneLoadOptions::BuildPickIndex(bool value)
+    {
+        m_options.buildPickIndex = value;
+    }
+
+    winrt::Windows::Foundation::IReference<uint32_t> SceneLoadOptions::SceneIndex()
+    {
+        if (!m_options.sceneIndex)
+        {
+            return nullptr;
+        }
+
+        return box_value(static_cast<uint32_t>(*m_options.sceneIndex)).as<winrt::Windows::Foundation::IReference<uint32_t>>();
+    }
+
+    void SceneLoadOptions::SceneIndex(winrt::Windows::Foundation::IReference<uint32_t> const& value)
+    {
+        if (value)
+        {
+            m_options.sceneIndex = value.Value();
+        }
+        else
+        {
+            m_options.sceneIndex.reset();
+        }
+    }
+
+    winrt::Windows::Foundation::Collections::IVector<hstring> SceneLoadOptions::NodeNames()
+    {
+        return m_nodeNames;
+    }
+
+    SceneLoaderComponent::SceneNodeFilter SceneLoadOptions::NodeFilter()
+    {
+        return m_nodeFilter;
+    }
+
+    void SceneLoadOptions::NodeFilter(SceneLoaderComponent::SceneNodeFilter const& value)
+    {
+        m_nodeFilter = value;
+    }
+
+    ::SceneLoader::LoadOptions SceneLoadOptions::Options() const
+    {
+        ::SceneLoader::LoadOptions options = m_options;
+
+        // glTF names are UTF-8.
+        for (const auto& name : m_nodeNames)
+        {
+            options.nodeNames.push_back(to_string(name));
+        }
+
+        if (m_nodeFilter)
+        {
+            options.nodeFilter = [filter = m_nodeFilter](const std::string& nodeName)
+            {
+                return filter(to_hstring(nodeName));
+            };
+        }
+
+        return options;
+    }
+}
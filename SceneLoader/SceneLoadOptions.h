@@ -0,0 +1,105 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneLoadOptions.g.h"
+#include "LoadOptions.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    struct SceneLoadOptions : SceneLoadOptionsT<SceneLoadOptions>
+    {
+        SceneLoadOptions() = default;
+
+        hstring CacheFolderPath();
+        void CacheFolderPath(hstring const& value);
+
+        hstring ResourceFolderPath();
+        void ResourceFolderPath(hstring const& value);
+
+        bool MapResourceFiles();
+        void MapResourceFiles(bool value);
+
+        winrt::Windows::Foundation::IReference<float> SkinningPoseTime();
+        void SkinningPoseTime(winrt::Windows::Foundation::IReference<float> const& value);
+
+        bool DeferTextureDecode();
+        void DeferTextureDecode(bool value);
+
+        uint32_t AtlasMaxTextureSize();
+        void AtlasMaxTextureSize(uint32_t value);
+
+        bool ParallelMeshDecode();
+        void ParallelMeshDecode(bool value);
+
+        bool StreamingDeserialize();
+        void StreamingDeserialize(bool value);
+
+        bool SmoothGeneratedNormals();
+        void SmoothGeneratedNormals(bool value);
+
+        bool CleanUpMeshes();
+        void CleanUpMeshes(bool value);
+
+        float MeshWeldTolerance();
+        void MeshWeldTolerance(float value);
+
+        uint32_t InstanceBatchMaxVertices();
+        void InstanceBatchMaxVertices(uint32_t value);
+
+        uint64_t TriangleBudget();
+        void TriangleBudget(uint64_t value);
+
+        uint32_t MeshTriangleBudget();
+        void MeshTriangleBudget(uint32_t value);
+
+        uint64_t MaxDecodedBytes();
+        void MaxDecodedBytes(uint64_t value);
+
+        uint64_t MaxImagePixels();
+        void MaxImagePixels(uint64_t value);
+
+        uint64_t MaxPrimitiveVertices();
+        void MaxPrimitiveVertices(uint64_t value);
+
+        uint64_t MaxNodeCount();
+        void MaxNodeCount(uint64_t value);
+
+        uint32_t MaxHierarchyDepth();
+        void MaxHierarchyDepth(uint32_t value);
+
+        winrt::Windows::Foundation::TimeSpan MaxLoadTime();
+        void MaxLoadTime(winrt::Windows::Foundation::TimeSpan const& value);
+
+        float FitSize();
+        void FitSize(float value);
+
+        bool BuildPickIndex();
+        void BuildPickIndex(bool value);
+
+        winrt::Windows::Foundation::IReference<uint32_t> SceneIndex();
+        void SceneIndex(winrt::Windows::Foundation::IReference<uint32_t> const& value);
+
+        winrt::Windows::Foundation::Collections::IVector<hstring> NodeNames();
+
+        SceneLoaderComponent::SceneNodeFilter NodeFilter();
+        void NodeFilter(SceneLoaderComponent::SceneNodeFilter const& value);
+
+        ::SceneLoader::LoadOptions Options() const;
+
+    private:
+        ::SceneLoader::LoadOptions m_options;
+
+        winrt::Windows::Foundation::Collections::IVector<hstring> m_nodeNames{ single_threaded_vector<hstring>() };
+        SceneLoaderComponent::SceneNodeFilter m_nodeFilter{ nullptr };
+    };
+}
+
+namespace winrt::SceneLoaderComponent::factory_implementation
+{
+    struct SceneLoadOptions : SceneLoadOptionsT<SceneLoadOptions, implementation::SceneLoadOptions>
+    {
+    };
+}
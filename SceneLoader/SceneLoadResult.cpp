@@ -0,0 +1,95 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+#include "SceneLoadResult.h"
+#include "ScenePickIndex.h"
+
+namespace winrt {
+    using namespace Windows::Foundation::Collections;
+    using namespace Windows::Foundation::Numerics;
+    using namespace Windows::UI::Composition::Scenes;
+}
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    // Zero for an empty box.
+    static float3 ToFloat3(const float* values, bool isEmpty)
+    {
+        return isEmpty ? float3::zero() : float3(values[0], values[1], values[2]);
+    }
+
+    SceneLoadResult::SceneLoadResult(SceneNode node, ::SceneLoader::SceneMetadata metadata, std::shared_ptr<const ::SceneLoader::PickIndex> pickIndex) :
+        m_node(node),
+        m_metadata(std::move(metadata))
+    {
+        if (pickIndex)
+        {
+            m_pickIndex = make<implementation::ScenePickIndex>(std::move(pickIndex));
+        }
+    }
+
+    SceneNode SceneLoadResult::Node()
+    {
+        return m_node;
+    }
+
+    float3 SceneLoadResult::BoundsMin()
+    {
+        return ToFloat3(m_metadata.box.min, m_metadata.box.IsEmpty());
+    }
+
+    float3 SceneLoadResult::BoundsMax()
+    {
+        return ToFloat3(m_metadata.box.max, m_metadata.box.IsEmpty());
+    }
+
+    float3 SceneLoadResult::SphereCenter()
+    {
+        return ToFloat3(m_metadata.sphere.center, m_metadata.sphere.IsEmpty());
+    }
+
+    float SceneLoadResult::SphereRadius()
+    {
+        return m_metadata.sphere.IsEmpty() ? 0.0f : m_metadata.sphere.radius;
+    }
+
+    IVectorView<SceneLoaderComponent::SceneNodeBounds> SceneLoadResult::NodeBounds()
+    {
+        std::vector<SceneLoaderComponent::SceneNodeBounds> nodeBounds;
+        nodeBounds.reserve(m_metadata.nodeBounds.size());
+
+        for (const auto& node : m_metadata.nodeBounds)
+        {
+            nodeBounds.push_back({ to_hstring(node.nodeId), ToFloat3(node.box.min, false), ToFloat3(node.box.max, false) });
+        }
+
+        return single_threaded_vector<SceneLoaderComponent::SceneNodeBounds>(std::move(nodeBounds)).GetView();
+    }
+
+    uint64_t SceneLoadResult::NodeCount()
+    {
+        return m_metadata.nodeCount;
+    }
+
+    uint64_t SceneLoadResult::PrimitiveCount()
+    {
+        return m_metadata.primitiveCount;
+    }
+
+    uint64_t SceneLoadResult::VertexCount()
+    {
+        return m_metadata.vertexCount;
+    }
+
+    uint64_t SceneLoadResult::DrawnTriangleCount()
+    {
+        return m_metadata.drawnTriangleCount;
+    }
+
+    SceneLoaderComponent::ScenePickIndex SceneLoadResult::PickIndex()
+    {
+        return m_pickIndex;
+    }
+}
@@ -0,0 +1,37 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneLoadResult.g.h"
+#include "SceneBounds.h"
+#include "PickIndex.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    struct SceneLoadResult : SceneLoadResultT<SceneLoadResult>
+    {
+        SceneLoadResult(
+            winrt::Windows::UI::Composition::Scenes::SceneNode node,
+            ::SceneLoader::SceneMetadata metadata,
+            std::shared_ptr<const ::SceneLoader::PickIndex> pickIndex);
+
+        winrt::Windows::UI::Composition::Scenes::SceneNode Node();
+        winrt::Windows::Foundation::Numerics::float3 BoundsMin();
+        winrt::Windows::Foundation::Numerics::float3 BoundsMax();
+        winrt::Windows::Foundation::Numerics::float3 SphereCenter();
+        float SphereRadius();
+        winrt::Windows::Foundation::Collections::IVectorView<SceneLoaderComponent::SceneNodeBounds> NodeBounds();
+        uint64_t NodeCount();
+        uint64_t PrimitiveCount();
+        uint64_t VertexCount();
+        uint64_t DrawnTriangleCount();
+        SceneLoaderComponent::ScenePickIndex PickIndex();
+
+    private:
+        winrt::Windows::UI::Composition::Scenes::SceneNode m_node{ nullptr };
+        ::SceneLoader::SceneMetadata m_metadata;
+        SceneLoaderComponent::ScenePickIndex m_pickIndex{ nullptr };
+    };
+}
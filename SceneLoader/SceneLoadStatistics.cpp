@@ -0,0 +1,94 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+#include "SceneLoadStatistics.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    SceneLoadStatistics::SceneLoadStatistics(const ::SceneLoader::LoadStatistics& statistics) :
+        m_statistics(statistics)
+    {
+    }
+
+    uint64_t SceneLoadStatistics::PeakDecodeBytes()
+    {
+        return m_statistics.peakDecodeBytes;
+    }
+
+    uint64_t SceneLoadStatistics::PooledDecodeBytes()
+    {
+        return m_statistics.pooledDecodeBytes;
+    }
+
+    uint32_t SceneLoadStatistics::DeferredTextureCount()
+    {
+        return m_statistics.deferredTextureCount;
+    }
+
+    uint32_t SceneLoadStatistics::AtlasedTextureCount()
+    {
+        return m_statistics.atlasedTextureCount;
+    }
+
+    uint32_t SceneLoadStatistics::AtlasCount()
+    {
+        return m_statistics.atlasCount;
+    }
+
+    uint64_t SceneLoadStatistics::AtlasOverheadBytes()
+    {
+        return m_statistics.atlasOverheadBytes;
+    }
+
+    uint64_t SceneLoadStatistics::CleanupVerticesBefore()
+    {
+        return m_statistics.cleanupVerticesBefore;
+    }
+
+    uint64_t SceneLoadStatistics::CleanupVerticesAfter()
+    {
+        return m_statistics.cleanupVerticesAfter;
+    }
+
+    uint64_t SceneLoadStatistics::CleanupIndicesBefore()
+    {
+        return m_statistics.cleanupIndicesBefore;
+    }
+
+    uint64_t SceneLoadStatistics::CleanupIndicesAfter()
+    {
+        return m_statistics.cleanupIndicesAfter;
+    }
+
+    uint64_t SceneLoadStatistics::MeshInstanceCount()
+    {
+        return m_statistics.meshInstanceCount;
+    }
+
+    uint64_t SceneLoadStatistics::InstanceNodeCount()
+    {
+        return m_statistics.instanceNodeCount;
+    }
+
+    uint64_t SceneLoadStatistics::InstanceBatchMeshCount()
+    {
+        return m_statistics.instanceBatchMeshCount;
+    }
+
+    uint64_t SceneLoadStatistics::SimplifiedTrianglesBefore()
+    {
+        return m_statistics.simplifiedTrianglesBefore;
+    }
+
+    uint64_t SceneLoadStatistics::SimplifiedTrianglesAfter()
+    {
+        return m_statistics.simplifiedTrianglesAfter;
+    }
+
+    float SceneLoadStatistics::MaxSimplificationError()
+    {
+        return m_statistics.maxSimplificationError;
+    }
+}
@@ -0,0 +1,36 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneLoadStatistics.g.h"
+#include "LoadStatistics.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    struct SceneLoadStatistics : SceneLoadStatisticsT<SceneLoadStatistics>
+    {
+        SceneLoadStatistics(const ::SceneLoader::LoadStatistics& statistics);
+
+        uint64_t PeakDecodeBytes();
+        uint64_t PooledDecodeBytes();
+        uint32_t DeferredTextureCount();
+        uint32_t AtlasedTextureCount();
+        uint32_t AtlasCount();
+        uint64_t AtlasOverheadBytes();
+        uint64_t CleanupVerticesBefore();
+        uint64_t CleanupVerticesAfter();
+        uint64_t CleanupIndicesBefore();
+        uint64_t CleanupIndicesAfter();
+        uint64_t MeshInstanceCount();
+        uint64_t InstanceNodeCount();
+        uint64_t InstanceBatchMeshCount();
+        uint64_t SimplifiedTrianglesBefore();
+        uint64_t SimplifiedTrianglesAfter();
+        float MaxSimplificationError();
+
+    private:
+        ::SceneLoader::LoadStatistics m_statistics;
+    };
+}
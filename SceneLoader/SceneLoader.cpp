@@ -6,8 +6,15 @@
 #include "SceneLoader.h"
 
 #include "UtilForIntermingledNamespaces.h"
-#include "Bounds3D.h"
 #include "GLTFVisitor.h"
+#include "SceneLoadStatistics.h"
+#include "SceneProbeResult.h"
+#include "SceneLoadResult.h"
+#include "SceneStreamingLoad.h"
+#include "SceneLoadOptions.h"
+#include "ContentHash.h"
+#include "SceneSelection.h"
+#include "StreamingDeserializer.h"
 
 using namespace std;
 using namespace Microsoft::glTF;
@@ -16,6 +23,7 @@ using namespace SceneLoader;
 namespace winrt {
     using namespace Windows::ApplicationModel::Core;
     using namespace Windows::Foundation::Collections;
+    using namespace Windows::Graphics::DirectX;
     using namespace Windows::UI::Core;
     using namespace Windows::UI::Composition;
     using namespace Windows::UI::Composition::Scenes;
@@ -29,19 +37,51 @@ using namespace winrt;
 
 namespace winrt::SceneLoaderComponent::implementation
 {
+    // Read-only view of memory that supports seeking with 64-bit offsets.
     struct MemBuf : std::streambuf
     {
-        MemBuf(char* begin, char* end) {
-            this->setg(begin, begin, end);
+        MemBuf(const uint8_t* begin, const uint8_t* end) {
+            this->setg((char*)begin, (char*)begin, (char*)end);
+        }
+
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode) override
+        {
+            char* base = (direction == std::ios_base::beg) ? eback() : (direction == std::ios_base::cur) ? gptr() : egptr();
+
+            if (offset < eback() - base || offset > egptr() - base)
+            {
+                return pos_type(off_type(-1));
+            }
+
+            this->setg(eback(), base + offset, egptr());
+            return pos_type(gptr() - eback());
+        }
+
+        pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(position), std::ios_base::beg, which);
         }
     };
 
-    struct StreamReader : public IStreamReader
+    // Every stream gets its own read position.
+    struct MemoryStream : std::istream
     {
         MemBuf m_membuf;
 
-        StreamReader(BYTE* data, UINT32 capacity) :
-            m_membuf((char*)data, (char*)(data + capacity))
+        MemoryStream(const uint8_t* begin, const uint8_t* end) :
+            std::istream(nullptr),
+            m_membuf(begin, end)
+        {
+            rdbuf(&m_membuf);
+        }
+    };
+
+    struct StreamReader : public IStreamReader
+    {
+        shared_ptr<GLTFSource> m_gltfSource;
+
+        StreamReader(shared_ptr<GLTFSource> gltfSource) :
+            m_gltfSource(gltfSource)
         {
         }
 
@@ -50,9 +90,17 @@ namespace winrt::SceneLoaderComponent::implementation
 
         }
 
-        shared_ptr<istream> GetInputStream(const std::string&) const override
+        // The empty uri is the document itself, anything else is an external file next to it.
+        shared_ptr<istream> GetInputStream(const std::string& uri) const override
         {
-            auto spIfStream = make_shared<std::istream>(const_cast<MemBuf*>(&m_membuf));
+            ArenaArray<const uint8_t> bytes{ m_gltfSource->Data(), static_cast<size_t>(m_gltfSource->Size()) };
+
+            if (!uri.empty() && !m_gltfSource->TryGetUriBytes(uri, &bytes))
+            {
+                throw exception("failed to open file");
+            }
+
+            auto spIfStream = make_shared<MemoryStream>(bytes.data, bytes.data + bytes.size);
 
             if (spIfStream->fail())
             {
@@ -62,79 +110,626 @@ namespace winrt::SceneLoaderComponent::implementation
         }
     };
 
+    static LoadOptions GetLoadOptions(SceneLoaderComponent::SceneLoadOptions options)
+    {
+        return options ? get_self<implementation::SceneLoadOptions>(options)->Options() : LoadOptions();
+    }
+
+    // Seeds the content hash of the cache key, so that every selection of a document, every
+    // atlas size, every kind of generated normals, every mesh clean up, every instance batch
+    // size, every triangle budget and every way of resolving external files gets its own
+    // cache file. Zero for a plain load of the whole scene.
+    static uint64_t GetOptionsHashSeed(const LoadOptions& loadOptions)
+    {
+        if (!loadOptions.sceneIndex && loadOptions.nodeNames.empty() && loadOptions.atlasMaxTextureSize == 0 && !loadOptions.smoothGeneratedNormals && !loadOptions.cleanUpMeshes && loadOptions.instanceBatchMaxVertices == 0 &&
+            loadOptions.triangleBudget == 0 && loadOptions.meshTriangleBudget == 0 && loadOptions.resourceFolderPath.empty() && !loadOptions.mapResourceFiles)
+        {
+            return 0;
+        }
+
+        string selection = loadOptions.sceneIndex ? to_string(*loadOptions.sceneIndex) : string();
+
+        for (const auto& nodeName : loadOptions.nodeNames)
+        {
+            selection += '\0';
+            selection += nodeName;
+        }
+
+        // Atlases change the surfaces and texture coordinates that are stored.
+        if (loadOptions.atlasMaxTextureSize > 0)
+        {
+            selection += '\0';
+            selection += "atlas " + to_string(loadOptions.atlasMaxTextureSize);
+        }
+
+        // Smooth normals are stored instead of flat ones, with fewer vertices.
+        if (loadOptions.smoothGeneratedNormals)
+        {
+            selection += '\0';
+            selection += "smooth normals";
+        }
+
+        // Cleaned up meshes are stored with fewer vertices and triangles. The tolerance goes in
+        // bit for bit, to_string would round small ones to zero.
+        if (loadOptions.cleanUpMeshes)
+        {
+            uint32_t toleranceBits;
+            memcpy(&toleranceBits, &loadOptions.meshWeldTolerance, sizeof(toleranceBits));
+
+            selection += '\0';
+            selection += "clean up " + to_string(toleranceBits);
+        }
+
+        // Merged instances are stored as meshes rather than nodes.
+        if (loadOptions.instanceBatchMaxVertices > 0)
+        {
+            selection += '\0';
+            selection += "instance batches " + to_string(loadOptions.instanceBatchMaxVertices);
+        }
+
+        // Simplified meshes are stored with fewer triangles.
+        if (loadOptions.triangleBudget > 0 || loadOptions.meshTriangleBudget > 0)
+        {
+            selection += '\0';
+            selection += "triangle budget " + to_string(loadOptions.triangleBudget) + " " + to_string(loadOptions.meshTriangleBudget);
+        }
+
+        // The same uris name other files in another folder.
+        if (!loadOptions.resourceFolderPath.empty())
+        {
+            selection += '\0';
+            selection += "resource folder " + to_string(hstring(loadOptions.resourceFolderPath));
+        }
+
+        if (loadOptions.mapResourceFiles)
+        {
+            selection += '\0';
+            selection += "mapped resource files";
+        }
+
+        return ComputeContentHash(selection.data(), selection.size());
+    }
+
+    // Resolver for external buffers and images, relative to resourceFolderPath or else defaultFolder.
+    static shared_ptr<IResourceResolver> CreateResourceResolver(const LoadOptions& loadOptions, const wstring& defaultFolder)
+    {
+        wstring folder = !loadOptions.resourceFolderPath.empty() ? loadOptions.resourceFolderPath : defaultFolder;
+
+        if (folder.empty())
+        {
+            return nullptr;
+        }
+
+        if (loadOptions.mapResourceFiles)
+        {
+            return make_shared<MappedFileResourceResolver>(folder);
+        }
+
+        return make_shared<DirectoryResourceResolver>(folder);
+    }
+
     SceneNode SceneLoader::Load(IBuffer buffer, Compositor compositor)
+    {
+        return Load(buffer, compositor, nullptr);
+    }
+
+    SceneNode SceneLoader::Load(IBuffer buffer, Compositor compositor, SceneLoaderComponent::SceneLoadOptions options)
+    {
+        return LoadWithResult(buffer, compositor, options).Node();
+    }
+
+    SceneNode SceneLoader::LoadFromFile(hstring path, Compositor compositor, SceneLoaderComponent::SceneLoadOptions options)
+    {
+        return LoadFromFileWithResult(path, compositor, options).Node();
+    }
+
+    SceneLoaderComponent::SceneLoadResult SceneLoader::LoadWithResult(IBuffer buffer, Compositor compositor, SceneLoaderComponent::SceneLoadOptions options)
     {
         auto memoryBuffer = winrt::Windows::Storage::Streams::Buffer::CreateMemoryBufferOverIBuffer(buffer);
         auto memoryBufferReference = memoryBuffer.CreateReference();
         auto data = GetDataPointerFromMemoryBuffer(memoryBufferReference);
 
-        SceneNode worldNode = SceneNode::Create(compositor);
-        SceneNode rootNode = SceneNode::Create(compositor);
-        worldNode.Children().Append(rootNode);
+        LoadOptions loadOptions = GetLoadOptions(options);
 
-        //
-        // Parses the GLTF file and creates the WUC Scenes objects
-        //
-        ParseGLTF(data.first, data.second, compositor, rootNode);
+        return LoadFromSource(make_shared<GLTFSource>(data.first, data.second, CreateResourceResolver(loadOptions, wstring())), compositor, loadOptions);
+    }
+
+    SceneLoaderComponent::SceneLoadResult SceneLoader::LoadFromFileWithResult(hstring path, Compositor compositor, SceneLoaderComponent::SceneLoadOptions options)
+    {
+        LoadOptions loadOptions = GetLoadOptions(options);
+        wstring filePath(path);
+
+        auto gltfSource = GLTFSource::Open(filePath, CreateResourceResolver(loadOptions, GetParentFolder(filePath)));
+
+        if (!gltfSource)
+        {
+            throw_last_error();
+        }
+
+        return LoadFromSource(gltfSource, compositor, loadOptions);
+    }
+
+    // Data URIs are left to the probe, which only decodes as far as the image headers go.
+    static SceneLoaderComponent::SceneProbeResult ProbeSource(GLTFSource& gltfSource, const LoadOptions& loadOptions)
+    {
+        ProbeResult result = ProbeScene(gltfSource.Data(), gltfSource.Size(), loadOptions, [&](const string& uri, ArenaArray<const uint8_t>* pBytes)
+        {
+            return gltfSource.TryGetUriBytes(uri, pBytes);
+        });
+
+        return make<implementation::SceneProbeResult>(move(result));
+    }
+
+    SceneLoaderComponent::SceneProbeResult SceneLoader::Probe(IBuffer buffer, SceneLoaderComponent::SceneLoadOptions options)
+    {
+        auto memoryBuffer = winrt::Windows::Storage::Streams::Buffer::CreateMemoryBufferOverIBuffer(buffer);
+        auto memoryBufferReference = memoryBuffer.CreateReference();
+        auto data = GetDataPointerFromMemoryBuffer(memoryBufferReference);
+
+        LoadOptions loadOptions = GetLoadOptions(options);
+        GLTFSource gltfSource(data.first, data.second, CreateResourceResolver(loadOptions, wstring()));
+
+        return ProbeSource(gltfSource, loadOptions);
+    }
+
+    SceneLoaderComponent::SceneProbeResult SceneLoader::ProbeFile(hstring path, SceneLoaderComponent::SceneLoadOptions options)
+    {
+        LoadOptions loadOptions = GetLoadOptions(options);
+        wstring filePath(path);
+
+        auto gltfSource = GLTFSource::Open(filePath, CreateResourceResolver(loadOptions, GetParentFolder(filePath)));
+
+        if (!gltfSource)
+        {
+            throw_last_error();
+        }
+
+        return ProbeSource(*gltfSource, loadOptions);
+    }
+
+    SceneLoaderComponent::SceneStreamingLoad SceneLoader::BeginStreamingLoad(Compositor compositor, SceneLoaderComponent::SceneLoadOptions options)
+    {
+        LoadOptions loadOptions = GetLoadOptions(options);
+        auto resolver = CreateResourceResolver(loadOptions, wstring());
+
+        return make<implementation::SceneStreamingLoad>(get_strong(), compositor, move(loadOptions), move(resolver), make_shared<SharedLoadResources>(m_deviceResources));
+    }
+
+    SceneLoaderComponent::SceneLoadResult SceneLoader::LoadFromSource(
+        shared_ptr<GLTFSource> gltfSource,
+        Compositor compositor,
+        const LoadOptions& loadOptions,
+        shared_ptr<SharedLoadResources> sharedResources,
+        unique_ptr<Document> gltfDoc,
+        shared_ptr<LoadLimiter> limiter)
+    {
+        try
+        {
+            PendingLoad load = BeginLoad(gltfSource, compositor, loadOptions, *m_deviceResources);
+
+            if (limiter)
+            {
+                load.limiter = limiter;
+            }
+
+            if (!load.isLoadedFromCache)
+            {
+                //
+                // Parses the GLTF file and creates the WUC Scenes objects
+                //
+                auto document = gltfDoc ?
+                    PrepareDocument(gltfSource, loadOptions, sharedResources.get(), load.limiter, move(*gltfDoc)) :
+                    ParseDocument(gltfSource, loadOptions, sharedResources.get(), load.limiter);
+
+                DoIt(document->gltfDoc, document->scene, loadOptions, document->resourceReader, compositor, load, m_deviceResources, sharedResources);
+            }
+
+            SceneNode worldNode = FinishLoad(load, loadOptions);
+
+            PublishLoad(load);
+
+            return make<implementation::SceneLoadResult>(worldNode, move(load.metadata), move(load.pickIndex));
+        }
+        catch (const LoadLimitException& exception)
+        {
+            ThrowLoadLimitError(exception);
+        }
+    }
+
+    void SceneLoader::ThrowLoadLimitError(const LoadLimitException& exception)
+    {
+        throw hresult_error(HRESULT_FROM_WIN32(ERROR_NOT_ENOUGH_QUOTA), to_hstring(exception.what()));
+    }
+
+    IVectorView<SceneNode> SceneLoader::LoadMany(IIterable<IBuffer> buffers, Compositor compositor, SceneLoadOptions options)
+    {
+        LoadOptions loadOptions = GetLoadOptions(options);
+        auto sharedResources = make_shared<SharedLoadResources>(m_deviceResources);
+
+        // The buffers must stay accessible until every scene has been built.
+        vector<IMemoryBufferReference> memoryBufferReferences;
+        vector<PendingLoad> loads;
+
+        for (const IBuffer& buffer : buffers)
+        {
+            auto memoryBufferReference = winrt::Windows::Storage::Streams::Buffer::CreateMemoryBufferOverIBuffer(buffer).CreateReference();
+            auto data = GetDataPointerFromMemoryBuffer(memoryBufferReference);
+
+            auto gltfSource = make_shared<GLTFSource>(data.first, data.second, CreateResourceResolver(loadOptions, wstring()));
+
+            memoryBufferReferences.push_back(memoryBufferReference);
+            loads.push_back(BeginLoad(gltfSource, compositor, loadOptions, *m_deviceResources));
+        }
+
+        // Parsing, validation, prefetching and image decoding only touch the document being
+        // parsed and the thread-safe image table, so they run side by side. Composition
+        // objects are only created below, on this thread.
+        vector<unique_ptr<ParsedDocument>> documents(loads.size());
 
-        Bounds3D bounds = ComputeTreeBounds(
-            rootNode,
-            float4x4::identity());
+        auto worldNodes = single_threaded_vector<SceneNode>();
 
-        float lengthX = bounds.Max().x - bounds.Min().x;
-        float lengthY = bounds.Max().y - bounds.Min().y;
-        float lengthZ = bounds.Max().z - bounds.Min().z;
+        try
+        {
+            concurrency::parallel_for(size_t(0), loads.size(), [&](size_t i)
+            {
+                if (!loads[i].isLoadedFromCache)
+                {
+                    documents[i] = ParseDocument(loads[i].gltfSource, loadOptions, sharedResources.get(), loads[i].limiter);
+                }
+            });
+
+            for (size_t i = 0; i < loads.size(); ++i)
+            {
+                if (documents[i])
+                {
+                    DoIt(documents[i]->gltfDoc, documents[i]->scene, loadOptions, documents[i]->resourceReader, compositor, loads[i], m_deviceResources, sharedResources);
+
+                    // The decoded images stay with sharedResources for the loads that follow.
+                    documents[i].reset();
+                }
+
+                worldNodes.Append(FinishLoad(loads[i], loadOptions));
+
+                PublishLoad(loads[i]);
+            }
+        }
+        catch (const LoadLimitException& exception)
+        {
+            ThrowLoadLimitError(exception);
+        }
+
+        return worldNodes.GetView();
+    }
+
+    SceneLoader::PendingLoad SceneLoader::BeginLoad(shared_ptr<GLTFSource> gltfSource, Compositor compositor, const LoadOptions& loadOptions, DeviceResources& deviceResources)
+    {
+        PendingLoad load;
+        load.gltfSource = gltfSource;
+        load.limiter = make_shared<LoadLimiter>(loadOptions.limits);
+        load.worldNode = SceneNode::Create(compositor);
+        load.rootNode = SceneNode::Create(compositor);
+        load.worldNode.Children().Append(load.rootNode);
+
+        const wstring& cacheFolder = loadOptions.cacheFolderPath;
+
+        // There is no telling what a filter callback selects, so those loads aren't cached.
+        // Nor are loads that build a pick index, which needs the document the cache replaces.
+        // External buffers and images go into the key by path, size and write time rather than
+        // by content, which would mean reading them all on every load; a resolver that can't
+        // stamp its resources opts the load out of the cache.
+        string resourceStamps;
+
+        if (!cacheFolder.empty() && !loadOptions.nodeFilter && !loadOptions.buildPickIndex && gltfSource->TryAppendResourceStamps(&resourceStamps))
+        {
+            uint64_t seed = ComputeContentHash(resourceStamps.data(), resourceStamps.size(), GetOptionsHashSeed(loadOptions));
+
+            load.cacheKey.contentHash = ComputeContentHash(gltfSource->Data(), static_cast<size_t>(gltfSource->Size()), seed);
+            load.cacheKey.contentSize = gltfSource->Size();
+            load.cachePath = GetSceneCachePath(cacheFolder, load.cacheKey);
+
+            if (auto sceneCacheReader = SceneCacheReader::Open(load.cachePath, load.cacheKey))
+            {
+                auto graphicsDevice = deviceResources.GraphicsDevice(compositor);
+
+                sceneCacheReader->BuildScene(compositor, graphicsDevice.as<ICompositionGraphicsDevice3>(), load.rootNode);
+                load.metadata = sceneCacheReader->ReadMetadata();
+                load.isLoadedFromCache = true;
+            }
+            else
+            {
+                load.sceneCacheWriter = make_shared<SceneCacheWriter>();
+            }
+        }
+
+        return load;
+    }
+
+    SceneNode SceneLoader::FinishLoad(PendingLoad& load, const LoadOptions& loadOptions)
+    {
+        if (load.sceneCacheWriter)
+        {
+            // Best effort, a scene that can't be cached is simply parsed again next time.
+            load.sceneCacheWriter->Write(load.rootNode, load.metadata, load.cachePath, load.cacheKey);
+        }
+
+        const BoundingBox& box = load.metadata.box;
+
+        if (loadOptions.fitSize == 0.0f || box.IsEmpty())
+        {
+            return load.worldNode;
+        }
+
+        float lengthX = box.max[0] - box.min[0];
+        float lengthY = box.max[1] - box.min[1];
+        float lengthZ = box.max[2] - box.min[2];
 
         float maxDimension = max(lengthX, max(lengthY, lengthZ));
 
         if (maxDimension > 0.0f)
         {
-            float scaleFactor = 300.0f / maxDimension;
+            float scaleFactor = loadOptions.fitSize / maxDimension;
+
+            load.worldNode.Transform().Scale({ scaleFactor, scaleFactor, scaleFactor });
+            load.worldNode.Transform().Translation({ 0.0f, -(box.min[1] + box.max[1]) * scaleFactor / 2, 0.0f });
+        }
+
+        return load.worldNode;
+    }
+
+    void SceneLoader::PublishLoad(PendingLoad& load)
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        m_lastLoadStatistics = load.statistics;
+
+        // The identity of a released node may already belong to one of this load.
+        for (auto it = m_morphedNodes.begin(); it != m_morphedNodes.end();)
+        {
+            it = it->second->node.get() ? next(it) : m_morphedNodes.erase(it);
+        }
 
-            worldNode.Transform().Scale({ scaleFactor, scaleFactor, scaleFactor });
-            worldNode.Transform().Translation({ 0.0f, -(bounds.Min().y + bounds.Max().y) * scaleFactor / 2, 0.0f });
+        for (auto& morphedPrimitive : load.morphedPrimitives)
+        {
+            auto& morphedNode = m_morphedNodes[GetObjectIdentity(morphedPrimitive.node)];
 
+            if (!morphedNode)
+            {
+                morphedNode = make_shared<MorphedNode>();
+                morphedNode->node = make_weak(morphedPrimitive.node);
+            }
+
+            morphedNode->primitives.emplace_back(make_weak(morphedPrimitive.mesh), move(morphedPrimitive.blender));
         }
 
-        return worldNode;
+        load.morphedPrimitives.clear();
     }
 
-    void SceneLoader::ParseGLTF(BYTE* data, UINT32 capacity, Compositor& compositor, SceneNode& rootNode)
+    Document SceneLoader::DeserializeDocument(ArenaArray<const uint8_t> json, const LoadOptions& loadOptions)
     {
-        auto streamReader = make_shared<StreamReader>(data, capacity);
-        auto spifstream = streamReader->GetInputStream("");
-        auto resourceReader = make_shared<GLTFResourceReader>(streamReader);
+        Document gltfDoc;
+
+        if (loadOptions.streamingDeserialize)
+        {
+            gltfDoc = DeserializeStreaming(reinterpret_cast<const char*>(json.data), json.size, loadOptions.limits);
+        }
+        else
+        {
+            MemoryStream jsonStream(json.data, json.data + json.size);
+
+            gltfDoc = Deserialize(jsonStream);
+        }
 
-        //////////////////////////////////////////////////////////////////////////////
-        //
-        // Document
-        //
-        //////////////////////////////////////////////////////////////////////////////
-        Document gltfDoc = Deserialize(*spifstream);
         Validation::Validate(gltfDoc);
 
-        DoIt(gltfDoc, resourceReader, compositor, rootNode);
+        return gltfDoc;
+    }
+
+    unique_ptr<SceneLoader::ParsedDocument> SceneLoader::ParseDocument(shared_ptr<GLTFSource> gltfSource, const LoadOptions& loadOptions, SharedLoadResources* pSharedResources, shared_ptr<LoadLimiter> limiter)
+    {
+        return PrepareDocument(gltfSource, loadOptions, pSharedResources, limiter, DeserializeDocument(gltfSource->JsonBytes(), loadOptions));
+    }
+
+    unique_ptr<SceneLoader::ParsedDocument> SceneLoader::PrepareDocument(shared_ptr<GLTFSource> gltfSource, const LoadOptions& loadOptions, SharedLoadResources* pSharedResources, shared_ptr<LoadLimiter> limiter, Document gltfDoc)
+    {
+        auto document = make_unique<ParsedDocument>();
+        document->gltfDoc = move(gltfDoc);
+
+        auto streamReader = make_shared<StreamReader>(gltfSource);
+
+        if (gltfSource->IsGLB())
+        {
+            document->resourceReader = make_shared<GLBResourceReader>(streamReader, streamReader->GetInputStream(""));
+        }
+        else
+        {
+            document->resourceReader = make_shared<GLTFResourceReader>(streamReader);
+        }
+
+        // Only what the selected part of the document uses is read.
+        document->scene = SelectScene(document->gltfDoc, loadOptions);
+
+        // Visit recurses down the hierarchy and creates a scene node for every path to a node.
+        CheckSceneLimits(document->gltfDoc, document->scene, loadOptions.limits);
+
+        SceneDependencies dependencies = CollectSceneDependencies(document->gltfDoc, document->scene, loadOptions);
+
+        // Fetch external buffers and images, and decode data URIs, in parallel before decoding starts.
+        gltfSource->Prefetch(document->gltfDoc, dependencies);
+
+        limiter->CheckTime();
+
+        // Atlas candidates and deferred textures are decoded their own way, see the Image visitor.
+        if (pSharedResources && loadOptions.atlasMaxTextureSize == 0 && !loadOptions.deferTextureDecode)
+        {
+            AccessorDecoder accessorDecoder(document->gltfDoc, document->resourceReader, gltfSource, limiter);
+
+            pSharedResources->DecodeImages(document->gltfDoc, dependencies.imageIds, accessorDecoder, *limiter);
+        }
+
+        return document;
     }
 
-    void SceneLoader::DoIt(Document& gltfDoc, shared_ptr<GLTFResourceReader> resourceReader, Compositor& compositor, SceneNode& rootNode)
+    void SceneLoader::DoIt(Document& gltfDoc, Scene& scene, const LoadOptions& loadOptions, shared_ptr<GLTFResourceReader> resourceReader, Compositor& compositor, PendingLoad& load, shared_ptr<DeviceResources> deviceResources, shared_ptr<SharedLoadResources> sharedResources)
     {
+        LoadStatistics& statistics = load.statistics;
+        shared_ptr<SceneCacheWriter> sceneCacheWriter = load.sceneCacheWriter;
+
         //////////////////////////////////////////////////////////////////////////////
         //
         // Scene
         //
         //////////////////////////////////////////////////////////////////////////////
-        auto scene = gltfDoc.GetDefaultScene();
+        size_t sceneIndex;
+
+        if (loadOptions.HasNodeSelection())
+        {
+            // Visit walks the scenes of the document, so the selection is added as one more.
+            scene.id = to_string(gltfDoc.scenes.Size());
+            gltfDoc.scenes.Append(Scene(scene));
+            sceneIndex = gltfDoc.scenes.Size() - 1;
+        }
+        else
+        {
+            sceneIndex = gltfDoc.scenes.GetIndex(scene.id);
+        }
 
         shared_ptr<SceneResourceSet> resourceSet = make_shared<SceneResourceSet>(compositor);
 
-        Visit(gltfDoc, DefaultSceneIndex, GLTFVisitor(
+        // All transient decode memory of this load. It is handed back to the
+        // DecodeBlockPool in one go when these go out of scope.
+        shared_ptr<DecodeArena> decodeArena = make_shared<DecodeArena>();
+        shared_ptr<AccessorDecoder> accessorDecoder = make_shared<AccessorDecoder>(gltfDoc, resourceReader, load.gltfSource, load.limiter);
+
+        GLTFVisitor visitor(
             compositor,
-            rootNode,
+            load.rootNode,
             resourceSet,
             resourceReader,
+            accessorDecoder,
+            decodeArena,
+            sceneCacheWriter,
+            sharedResources,
+            deviceResources,
+            load.limiter,
+            loadOptions,
             gltfDoc,
-            scene));
+            scene);
+
+        if (loadOptions.parallelMeshDecode)
+        {
+            visitor.DecodeMeshPrimitives();
+        }
+
+        Visit(gltfDoc, sceneIndex, visitor);
+
+        visitor.ImportAnimations();
+
+        visitor.BuildTextureAtlases(statistics);
+
+        const MeshCleanupCounts& cleanupCounts = visitor.MeshCleanupTotals();
+        statistics.cleanupVerticesBefore = cleanupCounts.verticesBefore;
+        statistics.cleanupVerticesAfter = cleanupCounts.verticesAfter;
+        statistics.cleanupIndicesBefore = cleanupCounts.indicesBefore;
+        statistics.cleanupIndicesAfter = cleanupCounts.indicesAfter;
+
+        const MeshInstancingCounts& instancingCounts = visitor.MeshInstancingTotals();
+        statistics.meshInstanceCount = instancingCounts.instanceCount;
+        statistics.instanceNodeCount = instancingCounts.instanceNodeCount;
+        statistics.instanceBatchMeshCount = instancingCounts.batchMeshCount;
+
+        const MeshSimplifyCounts& simplifyCounts = visitor.MeshSimplifyTotals();
+        statistics.simplifiedTrianglesBefore = simplifyCounts.trianglesBefore;
+        statistics.simplifiedTrianglesAfter = simplifyCounts.trianglesAfter;
+        statistics.maxSimplificationError = simplifyCounts.maxError;
+
+        load.morphedPrimitives = visitor.MorphedPrimitives();
+        load.metadata = visitor.FinishSceneMetadata();
+        load.pickIndex = visitor.FinishPickIndex();
+
+        if (sceneCacheWriter && (gltfDoc.animations.Size() > 0 || !visitor.MorphedPrimitives().empty()))
+        {
+            // The cache only stores static scenes.
+            sceneCacheWriter->Invalidate();
+        }
+
+        if (sceneCacheWriter && loadOptions.deferTextureDecode)
+        {
+            // The mip levels of deferred textures are never seen by the writer.
+            sceneCacheWriter->Invalidate();
+        }
 
         resourceSet->CreateSceneMaterialObjects();
+
+        statistics.deferredTextureCount = static_cast<uint32_t>(resourceSet->QueueDeferredImages(TextureDecodeQueue::Instance()));
+
+        statistics.peakDecodeBytes = decodeArena->PeakBytes() + accessorDecoder->BufferBytes() + visitor.DecodedMeshBytes();
+
+        accessorDecoder.reset();
+        decodeArena.reset();
+
+        statistics.pooledDecodeBytes = DecodeBlockPool::Instance().RetainedBytes();
+    }
+
+    void SceneLoader::SetMorphTargetWeights(SceneNode node, array_view<float const> weights)
+    {
+        shared_ptr<MorphedNode> morphedNode;
+
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            auto it = m_morphedNodes.find(GetObjectIdentity(node));
+
+            // The entry may still be that of a released node whose identity node now has.
+            if (it != m_morphedNodes.end() && it->second->node.get() == node)
+            {
+                morphedNode = it->second;
+            }
+        }
+
+        if (!morphedNode)
+        {
+            throw hresult_invalid_argument(L"The node has no morph targets");
+        }
+
+        // Loads and calls for other nodes go on meanwhile.
+        lock_guard<mutex> lock(morphedNode->lock);
+
+        for (auto& [weakMesh, blender] : morphedNode->primitives)
+        {
+            // Meshes the app has replaced in the meantime aren't blended anymore.
+            auto mesh = weakMesh.get();
+
+            if (!mesh)
+            {
+                continue;
+            }
+
+            auto changes = blender->SetWeights(weights.data(), weights.size());
+            const size_t byteLength = blender->VertexCount() * 3 * sizeof(float);
+
+            // SceneMesh can only replace a whole attribute.
+            if (changes.positions)
+            {
+                mesh.FillMeshAttribute(
+                    SceneAttributeSemantic::Vertex,
+                    DirectXPixelFormat::R32G32B32Float,
+                    CopyArrayOfBytesToMemoryBuffer((BYTE*)blender->Positions(), byteLength));
+            }
+
+            if (changes.normals)
+            {
+                mesh.FillMeshAttribute(
+                    SceneAttributeSemantic::Normal,
+                    DirectXPixelFormat::R32G32B32Float,
+                    CopyArrayOfBytesToMemoryBuffer((BYTE*)blender->Normals(), byteLength));
+            }
+        }
+    }
+
+    SceneLoaderComponent::SceneLoadStatistics SceneLoader::LastLoadStatistics()
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        return make<implementation::SceneLoadStatistics>(m_lastLoadStatistics);
     }
 }
@@ -5,6 +5,13 @@
 #pragma once
 
 #include "SceneLoader.g.h"
+#include "LoadStatistics.h"
+#include "LoadOptions.h"
+#include "SceneCache.h"
+#include "GLTFSource.h"
+#include "GLTFVisitor.h"
+#include "SharedLoadResources.h"
+#include "DeviceResources.h"
 
 namespace winrt::SceneLoaderComponent::implementation
 {
@@ -13,18 +20,147 @@ namespace winrt::SceneLoaderComponent::implementation
         SceneLoader() = default;
 
         winrt::Windows::UI::Composition::Scenes::SceneNode Load(winrt::Windows::Storage::Streams::IBuffer buffer, winrt::Windows::UI::Composition::Compositor compositor);
+        winrt::Windows::UI::Composition::Scenes::SceneNode Load(winrt::Windows::Storage::Streams::IBuffer buffer, winrt::Windows::UI::Composition::Compositor compositor, SceneLoaderComponent::SceneLoadOptions options);
+
+        // Maps the file instead of reading it; external buffers are mapped from the same folder.
+        winrt::Windows::UI::Composition::Scenes::SceneNode LoadFromFile(winrt::hstring path, winrt::Windows::UI::Composition::Compositor compositor, SceneLoaderComponent::SceneLoadOptions options);
+
+        // Load and LoadFromFile that also return the bounds and counts of the scene.
+        SceneLoaderComponent::SceneLoadResult LoadWithResult(winrt::Windows::Storage::Streams::IBuffer buffer, winrt::Windows::UI::Composition::Compositor compositor, SceneLoaderComponent::SceneLoadOptions options);
+        SceneLoaderComponent::SceneLoadResult LoadFromFileWithResult(winrt::hstring path, winrt::Windows::UI::Composition::Compositor compositor, SceneLoaderComponent::SceneLoadOptions options);
+
+        // Reads the JSON and the image headers, never the buffers; see ProbeScene.
+        SceneLoaderComponent::SceneProbeResult Probe(winrt::Windows::Storage::Streams::IBuffer buffer, SceneLoaderComponent::SceneLoadOptions options);
+        SceneLoaderComponent::SceneProbeResult ProbeFile(winrt::hstring path, SceneLoaderComponent::SceneLoadOptions options);
+
+        // Loads a file handed over in chunks, decoding its images while the rest arrives.
+        SceneLoaderComponent::SceneStreamingLoad BeginStreamingLoad(winrt::Windows::UI::Composition::Compositor compositor, SceneLoaderComponent::SceneLoadOptions options);
+
+        // Parses the buffers and decodes their images in parallel, then builds the scenes one after the other.
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Windows::UI::Composition::Scenes::SceneNode> LoadMany(
+            winrt::Windows::Foundation::Collections::IIterable<winrt::Windows::Storage::Streams::IBuffer> buffers,
+            winrt::Windows::UI::Composition::Compositor compositor,
+            SceneLoaderComponent::SceneLoadOptions options);
+
+        void SetMorphTargetWeights(winrt::Windows::UI::Composition::Scenes::SceneNode node, winrt::array_view<float const> weights);
+
+        SceneLoaderComponent::SceneLoadStatistics LastLoadStatistics();
 
     private:
-        void ParseGLTF(
-            BYTE * data, 
-            UINT32 capacity,
-            winrt::Windows::UI::Composition::Compositor& compositor,
-            winrt::Windows::UI::Composition::Scenes::SceneNode& rootNode);
-        void DoIt(
+        friend struct SceneStreamingLoad;
+
+        // One scene being loaded: the nodes it goes into and, unless it came from the scene
+        // cache, where to cache it. What the load produces for the SceneLoader stays here until
+        // PublishLoad, so loads running at the same time share nothing but DeviceResources.
+        struct PendingLoad
+        {
+            std::shared_ptr<::SceneLoader::GLTFSource> gltfSource;
+            winrt::Windows::UI::Composition::Scenes::SceneNode worldNode{ nullptr };
+            winrt::Windows::UI::Composition::Scenes::SceneNode rootNode{ nullptr };
+            std::shared_ptr<::SceneLoader::SceneCacheWriter> sceneCacheWriter;
+            ::SceneLoader::SceneCacheKey cacheKey = {};
+            std::wstring cachePath;
+            bool isLoadedFromCache = false;
+
+            ::SceneLoader::LoadStatistics statistics;
+            std::vector<::SceneLoader::MorphedPrimitive> morphedPrimitives;
+            ::SceneLoader::SceneMetadata metadata;
+            std::shared_ptr<const ::SceneLoader::PickIndex> pickIndex;
+
+            // Started by BeginLoad unless the load came with one.
+            std::shared_ptr<::SceneLoader::LoadLimiter> limiter;
+        };
+
+        // A document parsed, validated and with its resources prefetched, ready to visit.
+        struct ParsedDocument
+        {
+            Microsoft::glTF::Document gltfDoc;
+            Microsoft::glTF::Scene scene;
+            std::shared_ptr<Microsoft::glTF::GLTFResourceReader> resourceReader;
+        };
+
+        // A load can share the images decoded for it ahead of time, start from the document
+        // when its JSON has already been deserialized, and go on with the limiter of what it
+        // already decoded.
+        SceneLoaderComponent::SceneLoadResult LoadFromSource(
+            std::shared_ptr<::SceneLoader::GLTFSource> gltfSource,
+            winrt::Windows::UI::Composition::Compositor compositor,
+            const ::SceneLoader::LoadOptions& loadOptions,
+            std::shared_ptr<::SceneLoader::SharedLoadResources> sharedResources = nullptr,
+            std::unique_ptr<Microsoft::glTF::Document> gltfDoc = nullptr,
+            std::shared_ptr<::SceneLoader::LoadLimiter> limiter = nullptr);
+
+        // Loads that go over a limit of their options fail with ERROR_NOT_ENOUGH_QUOTA and a
+        // message that starts with the name of the limit.
+        [[noreturn]] static void ThrowLoadLimitError(const ::SceneLoader::LoadLimitException& exception);
+
+        // Creates the nodes of the scene and fills them from the scene cache if it has them.
+        static PendingLoad BeginLoad(
+            std::shared_ptr<::SceneLoader::GLTFSource> gltfSource,
+            winrt::Windows::UI::Composition::Compositor compositor,
+            const ::SceneLoader::LoadOptions& loadOptions,
+            ::SceneLoader::DeviceResources& deviceResources);
+
+        // Writes the cache file and fits the scene into the world node, which is returned.
+        static winrt::Windows::UI::Composition::Scenes::SceneNode FinishLoad(PendingLoad& load, const ::SceneLoader::LoadOptions& loadOptions);
+
+        // Makes the statistics of the load the last ones and keeps its morphed primitives, weakly.
+        void PublishLoad(PendingLoad& load);
+
+        // Deserializes the JSON with the parser loadOptions ask for and validates the document.
+        static Microsoft::glTF::Document DeserializeDocument(
+            ::SceneLoader::ArenaArray<const uint8_t> json,
+            const ::SceneLoader::LoadOptions& loadOptions);
+
+        // Safe to call for several documents at once. Images are decoded ahead when the load is
+        // part of a batch. The scene is checked against the limits before anything is read.
+        static std::unique_ptr<ParsedDocument> ParseDocument(
+            std::shared_ptr<::SceneLoader::GLTFSource> gltfSource,
+            const ::SceneLoader::LoadOptions& loadOptions,
+            ::SceneLoader::SharedLoadResources* pSharedResources,
+            std::shared_ptr<::SceneLoader::LoadLimiter> limiter);
+
+        // ParseDocument for a document that has been deserialized already.
+        static std::unique_ptr<ParsedDocument> PrepareDocument(
+            std::shared_ptr<::SceneLoader::GLTFSource> gltfSource,
+            const ::SceneLoader::LoadOptions& loadOptions,
+            ::SceneLoader::SharedLoadResources* pSharedResources,
+            std::shared_ptr<::SceneLoader::LoadLimiter> limiter,
+            Microsoft::glTF::Document gltfDoc);
+
+        // Builds the scene of the document into the nodes of the load. Only touches the load,
+        // so several can run at once.
+        static void DoIt(
             Microsoft::glTF::Document & gltfDoc, 
+            Microsoft::glTF::Scene& scene,
+            const ::SceneLoader::LoadOptions& loadOptions,
             std::shared_ptr<Microsoft::glTF::GLTFResourceReader> resourceReader, 
             winrt::Windows::UI::Composition::Compositor& compositor,
-            winrt::Windows::UI::Composition::Scenes::SceneNode& rootNode);
+            PendingLoad& load,
+            std::shared_ptr<::SceneLoader::DeviceResources> deviceResources,
+            std::shared_ptr<::SceneLoader::SharedLoadResources> sharedResources);
+
+        // The graphics devices and WIC factory of every load, see DeviceResources.
+        std::shared_ptr<::SceneLoader::DeviceResources> m_deviceResources = std::make_shared<::SceneLoader::DeviceResources>();
+
+        // Guards what loads publish and what reads it back.
+        std::mutex m_lock;
+
+        ::SceneLoader::LoadStatistics m_lastLoadStatistics;
+
+        // The morphed primitives under one node. The node and its meshes are held weakly, so
+        // the blenders go once the app lets go of the scene. Weights are blended and uploaded
+        // under lock, one call at a time per node, rather than under m_lock.
+        struct MorphedNode
+        {
+            winrt::weak_ref<winrt::Windows::UI::Composition::Scenes::SceneNode> node;
+            std::vector<std::pair<winrt::weak_ref<winrt::Windows::UI::Composition::Scenes::SceneMesh>, std::shared_ptr<::SceneLoader::MorphTargetBlender>>> primitives;
+            std::mutex lock;
+        };
+
+        // Morphed nodes of the scenes that are still alive, keyed by the identity of the node.
+        // Entries of released nodes are dropped by PublishLoad.
+        std::unordered_map<void*, std::shared_ptr<MorphedNode>> m_morphedNodes;
     };
 }
 
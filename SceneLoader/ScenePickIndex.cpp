@@ -0,0 +1,46 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+#include "ScenePickIndex.h"
+
+namespace winrt {
+    using namespace Windows::Foundation::Numerics;
+}
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    ScenePickIndex::ScenePickIndex(std::shared_ptr<const ::SceneLoader::PickIndex> index) :
+        m_index(std::move(index))
+    {
+    }
+
+    bool ScenePickIndex::Pick(float3 const& origin, float3 const& direction, SceneLoaderComponent::ScenePickHit& hit)
+    {
+        const float rayOrigin[3] = { origin.x, origin.y, origin.z };
+        const float rayDirection[3] = { direction.x, direction.y, direction.z };
+
+        ::SceneLoader::PickHit pickHit;
+
+        if (!m_index->Pick(rayOrigin, rayDirection, &pickHit))
+        {
+            hit = {};
+            return false;
+        }
+
+        hit.NodeId = to_hstring(pickHit.nodeId);
+        hit.PrimitiveIndex = pickHit.primitiveIndex;
+        hit.InstanceIndex = pickHit.instanceIndex;
+        hit.TriangleIndex = pickHit.triangleIndex;
+        hit.Distance = pickHit.distance;
+        hit.Barycentrics = float2(pickHit.barycentrics[0], pickHit.barycentrics[1]);
+
+        return true;
+    }
+
+    uint64_t ScenePickIndex::TriangleCount()
+    {
+        return m_index->TriangleCount();
+    }
+}
@@ -0,0 +1,22 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "ScenePickIndex.g.h"
+#include "PickIndex.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    struct ScenePickIndex : ScenePickIndexT<ScenePickIndex>
+    {
+        ScenePickIndex(std::shared_ptr<const ::SceneLoader::PickIndex> index);
+
+        bool Pick(winrt::Windows::Foundation::Numerics::float3 const& origin, winrt::Windows::Foundation::Numerics::float3 const& direction, SceneLoaderComponent::ScenePickHit& hit);
+        uint64_t TriangleCount();
+
+    private:
+        std::shared_ptr<const ::SceneLoader::PickIndex> m_index;
+    };
+}
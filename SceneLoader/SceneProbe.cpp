@@ -0,0 +1,415 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "SceneProbe.h"
+#include "Base64.h"
+#include "GLBContainer.h"
+#include "ImageHeaderProbe.h"
+#include "MeshInstancing.h"
+#include "SceneSelection.h"
+#include "StreamingDeserializer.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    // Bytes of a data URI image decoded to look for its header. JPEG frame headers can sit
+    // behind a few metadata segments; the rest of the image is decoded if they aren't found.
+    static constexpr size_t c_imageHeaderBytes = 64 * 1024;
+
+    // Bytes each vertex stream takes once decoded, see GLTFVisitor::DecodeMeshPrimitive.
+    static constexpr uint64_t c_positionBytes = 3 * sizeof(float);
+    static constexpr uint64_t c_normalBytes = 3 * sizeof(float);
+    static constexpr uint64_t c_tangentBytes = 4 * sizeof(float);
+    static constexpr uint64_t c_texCoordBytes = 2 * sizeof(float);
+    static constexpr uint64_t c_colorBytes = sizeof(uint32_t);
+    static constexpr uint64_t c_texelBytes = 4;
+
+    static uint64_t CountPrimitiveTriangles(const Document& gltfDocument, const MeshPrimitive& meshPrimitive)
+    {
+        string accessorId = meshPrimitive.indicesAccessorId;
+
+        if (accessorId.empty() && !meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_POSITION, accessorId))
+        {
+            return 0;
+        }
+
+        const uint64_t count = gltfDocument.accessors.Get(accessorId).count;
+
+        switch (meshPrimitive.mode)
+        {
+        case MESH_TRIANGLES:
+            return count / 3;
+        case MESH_TRIANGLE_STRIP:
+        case MESH_TRIANGLE_FAN:
+            return (count >= 3) ? count - 2 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    // Decodes up to length bytes from offset of a base64 data URI. Every 4 characters are 3
+    // bytes, so the range is decoded from the group it starts in without touching the rest.
+    static bool DecodeDataUriRange(const string& uri, uint64_t offset, uint64_t length, vector<uint8_t>* pBytes)
+    {
+        // data:[<media type>][;base64],<data>
+        size_t comma = uri.find(',');
+
+        if (uri.compare(0, 5, "data:") != 0 || comma == string::npos || comma < 12 || uri.compare(comma - 7, 7, ";base64") != 0)
+        {
+            return false;
+        }
+
+        const char* payload = uri.data() + comma + 1;
+        const uint64_t payloadLength = uri.size() - comma - 1;
+        const uint64_t firstCharacter = offset / 3 * 4;
+        const uint64_t skip = offset % 3;
+
+        if (firstCharacter >= payloadLength)
+        {
+            return false;
+        }
+
+        length = min(length, payloadLength);
+
+        const size_t characterCount = static_cast<size_t>(min((skip + length + 2) / 3 * 4, payloadLength - firstCharacter));
+        size_t decodedLength = 0;
+
+        pBytes->resize(GetBase64DecodedLengthBound(characterCount));
+
+        if (!DecodeBase64(payload + firstCharacter, characterCount, pBytes->data(), &decodedLength) || decodedLength < skip)
+        {
+            return false;
+        }
+
+        pBytes->resize(static_cast<size_t>(min<uint64_t>(decodedLength, skip + length)));
+        pBytes->erase(pBytes->begin(), pBytes->begin() + static_cast<size_t>(skip));
+        return true;
+    }
+
+    class SceneProber
+    {
+    public:
+        SceneProber(const Document& gltfDocument, const GLBContainer& container, const LoadOptions& loadOptions, const ProbeUriResolver& resolveUri) :
+            m_gltfDocument(gltfDocument),
+            m_container(container),
+            m_loadOptions(loadOptions),
+            m_resolveUri(resolveUri)
+        {
+        }
+
+        void AddScene(const Scene& scene)
+        {
+            unordered_map<string, uint64_t> meshTriangleCounts;
+            unordered_set<string> visited;
+            vector<string> pending(scene.nodes.begin(), scene.nodes.end());
+
+            while (!pending.empty())
+            {
+                string nodeId = move(pending.back());
+                pending.pop_back();
+
+                if (!visited.insert(nodeId).second)
+                {
+                    continue;
+                }
+
+                const Node& node = m_gltfDocument.nodes.Get(nodeId);
+                m_result.nodeCount++;
+
+                if (!node.meshId.empty())
+                {
+                    uint64_t drawCount = 1;
+                    MeshInstancingAccessors accessors;
+
+                    if (TryGetMeshInstancing(m_gltfDocument, node, &accessors))
+                    {
+                        const string& accessorId =
+                            !accessors.translationAccessorId.empty() ? accessors.translationAccessorId :
+                            !accessors.rotationAccessorId.empty() ? accessors.rotationAccessorId :
+                            accessors.scaleAccessorId;
+
+                        drawCount = m_gltfDocument.accessors.Get(accessorId).count;
+                        m_result.meshInstanceCount += drawCount;
+                    }
+
+                    auto meshTriangleCount = meshTriangleCounts.emplace(node.meshId, 0);
+
+                    if (meshTriangleCount.second)
+                    {
+                        meshTriangleCount.first->second = AddMesh(m_gltfDocument.meshes.Get(node.meshId));
+                    }
+
+                    m_result.drawnTriangleCount += meshTriangleCount.first->second * drawCount;
+                }
+
+                pending.insert(pending.end(), node.children.begin(), node.children.end());
+            }
+
+            m_result.meshCount = meshTriangleCounts.size();
+            m_result.materialCount = m_materialIds.size();
+        }
+
+        void AddImages(const unordered_set<string>& imageIds)
+        {
+            // In document order, so that results don't depend on hashing.
+            for (size_t i = 0; i < m_gltfDocument.images.Size(); ++i)
+            {
+                const Image& image = m_gltfDocument.images[i];
+
+                if (imageIds.count(image.id) == 0)
+                {
+                    continue;
+                }
+
+                ProbedImage probed;
+                probed.imageId = image.id;
+                probed.mimeType = image.mimeType;
+
+                ProbeImage(image, &probed);
+
+                if (probed.width > 0)
+                {
+                    uint64_t width = probed.width;
+                    uint64_t height = probed.height;
+
+                    m_result.decodedBytes += width * height * c_texelBytes;
+
+                    for (;;)
+                    {
+                        m_result.gpuBytes += width * height * c_texelBytes;
+
+                        if (width == 1 && height == 1)
+                        {
+                            break;
+                        }
+
+                        width = max<uint64_t>(width / 2, 1);
+                        height = max<uint64_t>(height / 2, 1);
+                    }
+                }
+
+                m_result.images.push_back(move(probed));
+            }
+        }
+
+        void AddExtensions()
+        {
+            for (const auto& extension : m_gltfDocument.extensionsUsed)
+            {
+                if (extension != c_meshGpuInstancingExtension)
+                {
+                    m_result.unsupportedExtensions.push_back(extension);
+                }
+            }
+
+            for (const auto& extension : m_gltfDocument.extensionsRequired)
+            {
+                if (extension != c_meshGpuInstancingExtension)
+                {
+                    m_result.unsupportedRequiredExtensions.push_back(extension);
+                }
+            }
+
+            sort(m_result.unsupportedExtensions.begin(), m_result.unsupportedExtensions.end());
+            sort(m_result.unsupportedRequiredExtensions.begin(), m_result.unsupportedRequiredExtensions.end());
+        }
+
+        ProbeResult& Result() { return m_result; }
+
+    private:
+        // Adds the primitives of a mesh seen for the first time and returns the triangles it draws.
+        uint64_t AddMesh(const Mesh& mesh)
+        {
+            uint64_t meshTriangleCount = 0;
+
+            for (const auto& meshPrimitive : mesh.primitives)
+            {
+                const uint64_t triangleCount = CountPrimitiveTriangles(m_gltfDocument, meshPrimitive);
+                meshTriangleCount += triangleCount;
+
+                AddPrimitive(meshPrimitive, triangleCount * 3);
+            }
+
+            return meshTriangleCount;
+        }
+
+        // Mirrors what GLTFVisitor::DecodeMeshPrimitive and GenerateVertexFrames produce.
+        void AddPrimitive(const MeshPrimitive& meshPrimitive, uint64_t indexCount)
+        {
+            m_result.primitiveCount++;
+
+            string positionsAccessorId;
+
+            if (!meshPrimitive.TryGetAttributeAccessorId(ACCESSOR_POSITION, positionsAccessorId))
+            {
+                return;
+            }
+
+            uint64_t vertexCount = m_gltfDocument.accessors.Get(positionsAccessorId).count;
+            uint64_t vertexBytes = 0;
+            bool hasNormals = false;
+            bool hasTangents = false;
+            bool hasTexCoords[2] = {};
+
+            for (const auto& value : meshPrimitive.attributes)
+            {
+                if (value.first == ACCESSOR_POSITION)
+                {
+                    vertexBytes += c_positionBytes;
+                }
+                else if (value.first == ACCESSOR_NORMAL)
+                {
+                    vertexBytes += c_normalBytes;
+                    hasNormals = true;
+                }
+                else if (value.first == ACCESSOR_TANGENT)
+                {
+                    vertexBytes += c_tangentBytes;
+                    hasTangents = true;
+                }
+                else if (value.first == ACCESSOR_TEXCOORD_0 || value.first == ACCESSOR_TEXCOORD_1)
+                {
+                    vertexBytes += c_texCoordBytes;
+                    hasTexCoords[value.first == ACCESSOR_TEXCOORD_0 ? 0 : 1] = true;
+                }
+                else if (value.first == ACCESSOR_COLOR_0)
+                {
+                    vertexBytes += c_colorBytes;
+                }
+            }
+
+            if (!hasNormals)
+            {
+                vertexBytes += c_normalBytes;
+
+                // Flat normals take a vertex per triangle corner.
+                if (!m_loadOptions.smoothGeneratedNormals && meshPrimitive.targets.empty() && indexCount <= static_cast<uint64_t>(UINT16_MAX) + 1)
+                {
+                    vertexCount = indexCount;
+                }
+            }
+
+            if (!meshPrimitive.materialId.empty())
+            {
+                m_materialIds.insert(meshPrimitive.materialId);
+
+                const auto& normalTexture = m_gltfDocument.materials.Get(meshPrimitive.materialId).normalTexture;
+
+                if (!hasTangents && !normalTexture.textureId.empty() && normalTexture.texCoord < 2 && hasTexCoords[normalTexture.texCoord])
+                {
+                    vertexBytes += c_tangentBytes;
+                }
+            }
+
+            const uint64_t bufferBytes = vertexCount * vertexBytes + indexCount * sizeof(uint16_t);
+
+            // Morph targets keep their position, normal and tangent offsets for the blender.
+            uint64_t targetBytes = 0;
+
+            for (const auto& target : meshPrimitive.targets)
+            {
+                targetBytes += (!target.positionsAccessorId.empty() + !target.normalsAccessorId.empty() + !target.tangentsAccessorId.empty()) * vertexCount * 3 * sizeof(float);
+            }
+
+            m_result.vertexCount += vertexCount;
+            m_result.indexCount += indexCount;
+            m_result.decodedBytes += bufferBytes + targetBytes;
+            m_result.gpuBytes += bufferBytes;
+        }
+
+        void ProbeImage(const Image& image, ProbedImage* pProbed)
+        {
+            ArenaArray<const uint8_t> bytes;
+            vector<uint8_t> decoded;
+            string dataUri;
+            uint64_t dataUriOffset = 0;
+            uint64_t dataUriLength = UINT64_MAX;
+
+            if (!image.bufferViewId.empty())
+            {
+                const BufferView& bufferView = m_gltfDocument.bufferViews.Get(image.bufferViewId);
+                const Buffer& buffer = m_gltfDocument.buffers.Get(bufferView.bufferId);
+                ArenaArray<const uint8_t> bufferBytes;
+
+                if (buffer.uri.compare(0, 5, "data:") == 0)
+                {
+                    dataUri = buffer.uri;
+                    dataUriOffset = bufferView.byteOffset;
+                    dataUriLength = bufferView.byteLength;
+                }
+                else if (buffer.uri.empty())
+                {
+                    // Only the first buffer of a GLB may omit the uri.
+                    bufferBytes = m_container.binaryChunk;
+                }
+                else if (m_resolveUri)
+                {
+                    m_resolveUri(buffer.uri, &bufferBytes);
+                }
+
+                if (bufferView.byteOffset <= bufferBytes.size && bufferView.byteLength <= bufferBytes.size - bufferView.byteOffset)
+                {
+                    bytes = { bufferBytes.data + bufferView.byteOffset, bufferView.byteLength };
+                }
+            }
+            else if (image.uri.compare(0, 5, "data:") == 0)
+            {
+                dataUri = image.uri;
+            }
+            else if (m_resolveUri)
+            {
+                m_resolveUri(image.uri, &bytes);
+            }
+
+            if (!dataUri.empty() && DecodeDataUriRange(dataUri, dataUriOffset, min<uint64_t>(dataUriLength, c_imageHeaderBytes), &decoded))
+            {
+                bytes = { decoded.data(), decoded.size() };
+            }
+
+            if (bytes.empty())
+            {
+                return;
+            }
+
+            if (const char* mimeType = ProbeImageMimeType(bytes.data, bytes.size))
+            {
+                pProbed->mimeType = mimeType;
+            }
+
+            if (!ProbeImageSize(bytes.data, bytes.size, &pProbed->width, &pProbed->height) &&
+                decoded.size() == c_imageHeaderBytes &&
+                DecodeDataUriRange(dataUri, dataUriOffset, dataUriLength, &decoded))
+            {
+                ProbeImageSize(decoded.data(), decoded.size(), &pProbed->width, &pProbed->height);
+            }
+        }
+
+        const Document& m_gltfDocument;
+        const GLBContainer& m_container;
+        const LoadOptions& m_loadOptions;
+        const ProbeUriResolver& m_resolveUri;
+
+        unordered_set<string> m_materialIds;
+        ProbeResult m_result;
+    };
+
+    ProbeResult ProbeScene(const uint8_t* data, uint64_t byteLength, const LoadOptions& loadOptions, const ProbeUriResolver& resolveUri)
+    {
+        GLBContainer container = ParseGLBContainer(data, byteLength);
+
+        Document gltfDocument = DeserializeStreaming(reinterpret_cast<const char*>(container.json.data), container.json.size);
+        Scene scene = SelectScene(gltfDocument, loadOptions);
+
+        SceneProber prober(gltfDocument, container, loadOptions, resolveUri);
+        prober.AddScene(scene);
+        prober.AddImages(CollectSceneDependencies(gltfDocument, scene, loadOptions).imageIds);
+        prober.AddExtensions();
+
+        return move(prober.Result());
+    }
+} // SceneLoader
@@ -0,0 +1,74 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "DecodeArena.h"
+#include "LoadOptions.h"
+
+namespace SceneLoader
+{
+    // An image the probed scene uses, as far as its header tells.
+    struct ProbedImage
+    {
+        std::string imageId;
+
+        // From the signature of the bytes, else the mimeType of the document. Empty when
+        // neither is known.
+        std::string mimeType;
+
+        // Zero when the header couldn't be read; the image is then left out of the estimates.
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // What loading a scene would take, estimated from the JSON and the image headers. Counts
+    // are of the scene and node selection of the load options, before meshes are cleaned up
+    // or simplified.
+    struct ProbeResult
+    {
+        // Nodes of the scene, and the distinct meshes, primitives and materials they draw.
+        uint64_t nodeCount = 0;
+        uint64_t meshCount = 0;
+        uint64_t primitiveCount = 0;
+        uint64_t materialCount = 0;
+
+        // Instances from EXT_mesh_gpu_instancing.
+        uint64_t meshInstanceCount = 0;
+
+        // Vertices and 16-bit triangle list indices of the distinct primitives as the loader
+        // builds them, generated normals included.
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+
+        // Triangles drawn by every node and instance, which is what TriangleBudget limits.
+        uint64_t drawnTriangleCount = 0;
+
+        std::vector<ProbedImage> images;
+
+        // Vertex streams, indices and morph targets as decoded, plus 32-bit pixels for every image.
+        uint64_t decodedBytes = 0;
+
+        // Vertex and index buffers plus 32-bit textures with their full mip chains.
+        uint64_t gpuBytes = 0;
+
+        // Extensions the document uses, and those it requires, that the loader ignores. Sorted.
+        std::vector<std::string> unsupportedExtensions;
+        std::vector<std::string> unsupportedRequiredExtensions;
+    };
+
+    // Returns the bytes of a file referenced by a relative uri, false if it can't be read.
+    // Only the first bytes of images are looked at, so mapping the file is cheapest.
+    using ProbeUriResolver = std::function<bool(const std::string& uri, ArenaArray<const uint8_t>* pBytes)>;
+
+    // Reads the GLB container or .gltf JSON and the headers of the images the selected scene
+    // uses. Buffers are never read, so this takes about as long as parsing the JSON whatever
+    // the size of the asset. Images the resolver can't provide are listed with a zero size.
+    // Throws like a load does for malformed containers, JSON and scene selections.
+    ProbeResult ProbeScene(
+        const uint8_t* data,
+        uint64_t byteLength,
+        const LoadOptions& loadOptions,
+        const ProbeUriResolver& resolveUri);
+} // SceneLoader
@@ -0,0 +1,104 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+#include "SceneProbeResult.h"
+
+namespace winrt {
+    using namespace Windows::Foundation::Collections;
+}
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    static IVectorView<hstring> ToStringView(const std::vector<std::string>& strings)
+    {
+        std::vector<hstring> values;
+        values.reserve(strings.size());
+
+        for (const auto& value : strings)
+        {
+            values.push_back(to_hstring(value));
+        }
+
+        return single_threaded_vector<hstring>(std::move(values)).GetView();
+    }
+
+    SceneProbeResult::SceneProbeResult(::SceneLoader::ProbeResult result) :
+        m_result(std::move(result))
+    {
+    }
+
+    uint64_t SceneProbeResult::NodeCount()
+    {
+        return m_result.nodeCount;
+    }
+
+    uint64_t SceneProbeResult::MeshCount()
+    {
+        return m_result.meshCount;
+    }
+
+    uint64_t SceneProbeResult::PrimitiveCount()
+    {
+        return m_result.primitiveCount;
+    }
+
+    uint64_t SceneProbeResult::MaterialCount()
+    {
+        return m_result.materialCount;
+    }
+
+    uint64_t SceneProbeResult::MeshInstanceCount()
+    {
+        return m_result.meshInstanceCount;
+    }
+
+    uint64_t SceneProbeResult::VertexCount()
+    {
+        return m_result.vertexCount;
+    }
+
+    uint64_t SceneProbeResult::IndexCount()
+    {
+        return m_result.indexCount;
+    }
+
+    uint64_t SceneProbeResult::DrawnTriangleCount()
+    {
+        return m_result.drawnTriangleCount;
+    }
+
+    IVectorView<SceneLoaderComponent::SceneProbedImage> SceneProbeResult::Images()
+    {
+        std::vector<SceneLoaderComponent::SceneProbedImage> images;
+        images.reserve(m_result.images.size());
+
+        for (const auto& image : m_result.images)
+        {
+            images.push_back({ to_hstring(image.imageId), to_hstring(image.mimeType), image.width, image.height });
+        }
+
+        return single_threaded_vector<SceneLoaderComponent::SceneProbedImage>(std::move(images)).GetView();
+    }
+
+    uint64_t SceneProbeResult::DecodedBytes()
+    {
+        return m_result.decodedBytes;
+    }
+
+    uint64_t SceneProbeResult::GpuBytes()
+    {
+        return m_result.gpuBytes;
+    }
+
+    IVectorView<hstring> SceneProbeResult::UnsupportedExtensions()
+    {
+        return ToStringView(m_result.unsupportedExtensions);
+    }
+
+    IVectorView<hstring> SceneProbeResult::UnsupportedRequiredExtensions()
+    {
+        return ToStringView(m_result.unsupportedRequiredExtensions);
+    }
+}
@@ -0,0 +1,33 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneProbeResult.g.h"
+#include "SceneProbe.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    struct SceneProbeResult : SceneProbeResultT<SceneProbeResult>
+    {
+        SceneProbeResult(::SceneLoader::ProbeResult result);
+
+        uint64_t NodeCount();
+        uint64_t MeshCount();
+        uint64_t PrimitiveCount();
+        uint64_t MaterialCount();
+        uint64_t MeshInstanceCount();
+        uint64_t VertexCount();
+        uint64_t IndexCount();
+        uint64_t DrawnTriangleCount();
+        winrt::Windows::Foundation::Collections::IVectorView<SceneLoaderComponent::SceneProbedImage> Images();
+        uint64_t DecodedBytes();
+        uint64_t GpuBytes();
+        winrt::Windows::Foundation::Collections::IVectorView<hstring> UnsupportedExtensions();
+        winrt::Windows::Foundation::Collections::IVectorView<hstring> UnsupportedRequiredExtensions();
+
+    private:
+        ::SceneLoader::ProbeResult m_result;
+    };
+}
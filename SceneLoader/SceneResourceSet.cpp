@@ -19,7 +19,7 @@ using namespace winrt;
 namespace SceneLoader
 {
     // If you want to assert when we hit a feature we don't support yet, change this to true.
-    bool SceneResourceSet::s_assertOnUnimplementedFeature = false;
+    static constexpr bool c_assertOnUnimplementedFeature = false;
 
     SceneWrappingMode
     GLTFWrapModeToSceneWrapMode(Microsoft::glTF::WrapMode gltfWrapMode)
@@ -184,11 +184,14 @@ namespace SceneLoader
             SceneMetallicRoughnessMaterial sceneMaterial = EnsureMaterialById(materialIterator->second.id);
             Microsoft::glTF::Material material = materialIterator->second;
 
+            auto referenceCount = m_materialReferenceCounts.find(material.id);
+            const uint32_t primitiveCount = (referenceCount != m_materialReferenceCounts.end()) ? referenceCount->second : 0;
+
 
             // BaseColor
             if (material.metallicRoughness.baseColorTexture.textureId != "")
             {
-                auto materialInput = GetMaterialInputFromTextureId(material.metallicRoughness.baseColorTexture.textureId);
+                auto materialInput = GetMaterialInputFromTextureId(material.metallicRoughness.baseColorTexture.textureId, primitiveCount);
                 sceneMaterial.BaseColorInput(materialInput);
                 
                 if (m_latestMeshRendererComponent)
@@ -203,7 +206,7 @@ namespace SceneLoader
             // MetallicRoughness
             if (material.metallicRoughness.metallicRoughnessTexture.textureId != "")
             {
-                auto materialInput = GetMaterialInputFromTextureId(material.metallicRoughness.metallicRoughnessTexture.textureId);
+                auto materialInput = GetMaterialInputFromTextureId(material.metallicRoughness.metallicRoughnessTexture.textureId, primitiveCount);
                 sceneMaterial.MetallicRoughnessInput(materialInput);
             
                 if (m_latestMeshRendererComponent)
@@ -220,7 +223,7 @@ namespace SceneLoader
             // Normal
             if (material.normalTexture.textureId != "")
             {
-                auto materialInput = GetMaterialInputFromTextureId(material.normalTexture.textureId);
+                auto materialInput = GetMaterialInputFromTextureId(material.normalTexture.textureId, primitiveCount);
                 sceneMaterial.NormalInput(materialInput);
             
                 if (m_latestMeshRendererComponent)
@@ -235,7 +238,7 @@ namespace SceneLoader
             // Occlusion
             if (material.occlusionTexture.textureId != "")
             {
-                auto materialInput = GetMaterialInputFromTextureId(material.occlusionTexture.textureId);
+                auto materialInput = GetMaterialInputFromTextureId(material.occlusionTexture.textureId, primitiveCount);
                 sceneMaterial.OcclusionInput(materialInput);
             
                 if (m_latestMeshRendererComponent)
@@ -250,7 +253,7 @@ namespace SceneLoader
             // Emissive
             if (material.emissiveTexture.textureId != "")
             {
-                auto materialInput = GetMaterialInputFromTextureId(material.emissiveTexture.textureId);
+                auto materialInput = GetMaterialInputFromTextureId(material.emissiveTexture.textureId, primitiveCount);
                 sceneMaterial.EmissiveInput(materialInput);
             
                 if (m_latestMeshRendererComponent)
@@ -292,9 +295,8 @@ namespace SceneLoader
 
 
     SceneSurfaceMaterialInput
-    SceneResourceSet::GetMaterialInputFromTextureId(const std::string textureId)
+    SceneResourceSet::GetMaterialInputFromTextureId(const std::string textureId, uint32_t primitiveCount)
     {
-        static uint16_t sCount = 0;
         Microsoft::glTF::Sampler sampler;
         Microsoft::glTF::Texture texture;
 
@@ -308,20 +310,90 @@ namespace SceneLoader
 
         CompositionMipmapSurface mipMapSurface = LookupMipMapSurfaceId(texture.imageId);
 
+        auto deferredImage = m_deferredImages.find(texture.imageId);
+
+        if (deferredImage != m_deferredImages.end())
+        {
+            deferredImage->second.primitiveCount += primitiveCount;
+            deferredImage->second.isUsed = true;
+        }
+
         SceneSurfaceMaterialInput sceneSurfaceMaterialInput = SceneSurfaceMaterialInput::Create(m_compositor);
-        wstringstream ssitoa; ssitoa << sCount;
+        wstringstream ssitoa; ssitoa << m_materialInputCount;
         sceneSurfaceMaterialInput.Comment(ssitoa.str());
 
         SetSceneSampler(sceneSurfaceMaterialInput, sampler);
 
+        if (m_atlasedImageIds.count(texture.imageId))
+        {
+            sceneSurfaceMaterialInput.WrappingUMode(SceneWrappingMode::ClampToEdge);
+            sceneSurfaceMaterialInput.WrappingVMode(SceneWrappingMode::ClampToEdge);
+        }
+
         sceneSurfaceMaterialInput.Surface(mipMapSurface);
 
-        ++sCount;
+        ++m_materialInputCount;
 
         return sceneSurfaceMaterialInput;
     }
 
 
+    void
+    SceneResourceSet::CountMaterialReference(const std::string materialId)
+    {
+        ++m_materialReferenceCounts[materialId];
+    }
+
+
+    void
+    SceneResourceSet::AddDeferredImage(const std::string imageId, CompositionMipmapSurface mipmap, std::shared_ptr<const std::vector<uint8_t>> encodedImage)
+    {
+        DeferredImage& deferredImage = m_deferredImages[imageId];
+        deferredImage.mipmap = mipmap;
+        deferredImage.encodedImage = move(encodedImage);
+    }
+
+
+    size_t
+    SceneResourceSet::QueueDeferredImages(TextureDecodeQueue& queue)
+    {
+        size_t queuedCount = 0;
+
+        for (auto& deferredImage : m_deferredImages)
+        {
+            // Images that no material ends up using are never decoded.
+            if (deferredImage.second.isUsed)
+            {
+                queue.Enqueue(deferredImage.second.mipmap, move(deferredImage.second.encodedImage), deferredImage.second.primitiveCount);
+                ++queuedCount;
+            }
+        }
+
+        m_deferredImages.clear();
+
+        if (queuedCount > 0)
+        {
+            queue.Start();
+        }
+
+        return queuedCount;
+    }
+
+
+    void
+    SceneResourceSet::StoreAtlasedImage(const std::string imageId, CompositionMipmapSurface atlas)
+    {
+        m_sceneMipMapSurfaceMap.Insert(GetHSTRINGFromStdString(imageId), atlas);
+        m_atlasedImageIds.insert(imageId);
+    }
+
+    void
+    SceneResourceSet::StoreSharedImage(const std::string imageId, CompositionMipmapSurface surface)
+    {
+        m_sceneMipMapSurfaceMap.Insert(GetHSTRINGFromStdString(imageId), surface);
+    }
+
+
     void
     SceneResourceSet::SetSceneSampler(winrt::Windows::UI::Composition::Scenes::SceneSurfaceMaterialInput sceneSurfaceMaterialInput, Microsoft::glTF::Sampler sampler)
     {
@@ -341,7 +413,7 @@ namespace SceneLoader
     void
     SceneResourceSet::UnimplementedFeatureFound()
     {
-        if (s_assertOnUnimplementedFeature)
+        if (c_assertOnUnimplementedFeature)
         {
            assert(false);
         }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "TextureDecodeQueue.h"
+
 namespace SceneLoader
 {
     class SceneResourceSet
@@ -26,7 +28,8 @@ namespace SceneLoader
 
         void SetSceneSampler(winrt::Windows::UI::Composition::Scenes::SceneSurfaceMaterialInput materialInput, Microsoft::glTF::Sampler sampler);
 
-        winrt::Windows::UI::Composition::Scenes::SceneSurfaceMaterialInput GetMaterialInputFromTextureId(const std::string textureId);
+        // primitiveCount is the number of primitives drawn with the material that uses the texture.
+        winrt::Windows::UI::Composition::Scenes::SceneSurfaceMaterialInput GetMaterialInputFromTextureId(const std::string textureId, uint32_t primitiveCount);
 
         winrt::Windows::UI::Composition::CompositionMipmapSurface EnsureMipMapSurfaceId(
             const std::string id,
@@ -37,6 +40,28 @@ namespace SceneLoader
 
         winrt::Windows::UI::Composition::CompositionMipmapSurface LookupMipMapSurfaceId(const std::string id);
 
+        // Counts a primitive drawn with the material, so that the textures of the most used
+        // materials are decoded first.
+        void CountMaterialReference(const std::string materialId);
+
+        // Keeps the encoded image of a surface that was created without its pixels until a
+        // material uses it. See LoadOptions::deferTextureDecode.
+        void AddDeferredImage(
+            const std::string imageId,
+            winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap,
+            std::shared_ptr<const std::vector<uint8_t>> encodedImage);
+
+        // Hands the deferred images that materials use to the queue, prioritized by how many
+        // primitives draw with them, and starts decoding. Returns how many were queued.
+        size_t QueueDeferredImages(TextureDecodeQueue& queue);
+
+        // Makes the atlas the surface of an image packed into it. Its gutter stands in for the
+        // wrap modes of the texture, so the atlas is always sampled clamped.
+        void StoreAtlasedImage(const std::string imageId, winrt::Windows::UI::Composition::CompositionMipmapSurface atlas);
+
+        // Makes a surface that another load of the batch created the surface of an image.
+        void StoreSharedImage(const std::string imageId, winrt::Windows::UI::Composition::CompositionMipmapSurface surface);
+
         void SetLatestMeshRendererComponent(winrt::Windows::UI::Composition::Scenes::SceneMeshRendererComponent& meshRendererComponent);
 
         static void UnimplementedFeatureFound();
@@ -57,9 +82,23 @@ namespace SceneLoader
         std::map<winrt::hstring, Microsoft::glTF::Sampler> m_gltfSamplerMap;
         std::map<winrt::hstring, Microsoft::glTF::Material> m_gltfMaterialMap;
         std::map<winrt::hstring, Microsoft::glTF::Texture> m_gltfTextureMap;
+
+        struct DeferredImage
+        {
+            winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap{ nullptr };
+            std::shared_ptr<const std::vector<uint8_t>> encodedImage;
+            uint32_t primitiveCount = 0;
+            bool isUsed = false;
+        };
+
+        std::map<std::string, DeferredImage> m_deferredImages;
+        std::map<std::string, uint32_t> m_materialReferenceCounts;
+
+        std::unordered_set<std::string> m_atlasedImageIds;
     
         winrt::Windows::UI::Composition::Scenes::SceneMeshRendererComponent m_latestMeshRendererComponent{ nullptr };
 
-        static bool s_assertOnUnimplementedFeature;
+        // Numbers the material inputs of the load in their comments.
+        uint16_t m_materialInputCount = 0;
     };
 } // SceneLoader
\ No newline at end of file
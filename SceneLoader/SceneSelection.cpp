@@ -0,0 +1,392 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "SceneSelection.h"
+#include "MeshInstancing.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static bool IsNodeSelected(const Node& node, const LoadOptions& loadOptions)
+    {
+        if (find(loadOptions.nodeNames.begin(), loadOptions.nodeNames.end(), node.name) != loadOptions.nodeNames.end())
+        {
+            return true;
+        }
+
+        return loadOptions.nodeFilter && loadOptions.nodeFilter(node.name);
+    }
+
+    Scene SelectScene(const Document& gltfDocument, const LoadOptions& loadOptions)
+    {
+        if (loadOptions.sceneIndex && *loadOptions.sceneIndex >= gltfDocument.scenes.Size())
+        {
+            throw InvalidGLTFException("The document has no scene " + to_string(*loadOptions.sceneIndex));
+        }
+
+        const Scene& scene = loadOptions.sceneIndex ? gltfDocument.scenes[*loadOptions.sceneIndex] : gltfDocument.GetDefaultScene();
+
+        if (!loadOptions.HasNodeSelection())
+        {
+            return scene;
+        }
+
+        Scene selection = scene;
+        selection.nodes.clear();
+
+        // Depth first, so that the selected roots keep the order of the document.
+        vector<string> pending(scene.nodes.rbegin(), scene.nodes.rend());
+        unordered_set<string> visited;
+
+        while (!pending.empty())
+        {
+            string nodeId = move(pending.back());
+            pending.pop_back();
+
+            if (!visited.insert(nodeId).second)
+            {
+                continue;
+            }
+
+            const Node& node = gltfDocument.nodes.Get(nodeId);
+
+            if (IsNodeSelected(node, loadOptions))
+            {
+                selection.nodes.push_back(nodeId);
+                continue;
+            }
+
+            pending.insert(pending.end(), node.children.rbegin(), node.children.rend());
+        }
+
+        return selection;
+    }
+
+    class DependencyCollector
+    {
+    public:
+        DependencyCollector(const Document& gltfDocument) :
+            m_gltfDocument(gltfDocument)
+        {
+        }
+
+        void AddBufferView(const string& bufferViewId)
+        {
+            if (!bufferViewId.empty())
+            {
+                m_dependencies.bufferIds.insert(m_gltfDocument.bufferViews.Get(bufferViewId).bufferId);
+            }
+        }
+
+        void AddAccessor(const string& accessorId)
+        {
+            if (accessorId.empty())
+            {
+                return;
+            }
+
+            const Accessor& accessor = m_gltfDocument.accessors.Get(accessorId);
+
+            AddBufferView(accessor.bufferViewId);
+
+            if (accessor.sparse.count > 0)
+            {
+                AddBufferView(accessor.sparse.indicesBufferViewId);
+                AddBufferView(accessor.sparse.valuesBufferViewId);
+            }
+        }
+
+        void AddTexture(const string& textureId)
+        {
+            if (textureId.empty())
+            {
+                return;
+            }
+
+            const Texture& texture = m_gltfDocument.textures.Get(textureId);
+
+            if (texture.imageId.empty() || !m_dependencies.imageIds.insert(texture.imageId).second)
+            {
+                return;
+            }
+
+            AddBufferView(m_gltfDocument.images.Get(texture.imageId).bufferViewId);
+        }
+
+        void AddMaterial(const string& materialId)
+        {
+            if (materialId.empty() || !m_materialIds.insert(materialId).second)
+            {
+                return;
+            }
+
+            // The textures that SceneResourceSet::CreateSceneMaterialObjects reads.
+            const Material& material = m_gltfDocument.materials.Get(materialId);
+
+            AddTexture(material.metallicRoughness.baseColorTexture.textureId);
+            AddTexture(material.metallicRoughness.metallicRoughnessTexture.textureId);
+            AddTexture(material.normalTexture.textureId);
+            AddTexture(material.occlusionTexture.textureId);
+            AddTexture(material.emissiveTexture.textureId);
+        }
+
+        void AddMesh(const string& meshId)
+        {
+            if (meshId.empty() || !m_meshIds.insert(meshId).second)
+            {
+                return;
+            }
+
+            for (const auto& meshPrimitive : m_gltfDocument.meshes.Get(meshId).primitives)
+            {
+                for (const auto& attribute : meshPrimitive.attributes)
+                {
+                    AddAccessor(attribute.second);
+                }
+
+                AddAccessor(meshPrimitive.indicesAccessorId);
+
+                for (const auto& target : meshPrimitive.targets)
+                {
+                    AddAccessor(target.positionsAccessorId);
+                    AddAccessor(target.normalsAccessorId);
+                    AddAccessor(target.tangentsAccessorId);
+                }
+
+                AddMaterial(meshPrimitive.materialId);
+            }
+        }
+
+        // Returns false if the node was already added.
+        bool AddNode(const string& nodeId)
+        {
+            if (!m_nodeIds.insert(nodeId).second)
+            {
+                return false;
+            }
+
+            const Node& node = m_gltfDocument.nodes.Get(nodeId);
+
+            AddMesh(node.meshId);
+
+            MeshInstancingAccessors instancing;
+
+            if (TryGetMeshInstancing(m_gltfDocument, node, &instancing))
+            {
+                AddAccessor(instancing.translationAccessorId);
+                AddAccessor(instancing.rotationAccessorId);
+                AddAccessor(instancing.scaleAccessorId);
+            }
+
+            if (!node.skinId.empty())
+            {
+                AddAccessor(m_gltfDocument.skins.Get(node.skinId).inverseBindMatricesAccessorId);
+                m_hasSkins = true;
+            }
+
+            return true;
+        }
+
+        void AddAnimationChannels(const Animation& animation, bool allChannels)
+        {
+            for (const auto& channel : animation.channels.Elements())
+            {
+                if (allChannels || m_nodeIds.count(channel.target.nodeId) > 0)
+                {
+                    const AnimationSampler& sampler = animation.samplers.Get(channel.samplerId);
+
+                    AddAccessor(sampler.inputAccessorId);
+                    AddAccessor(sampler.outputAccessorId);
+                }
+            }
+        }
+
+        bool HasSkins() const { return m_hasSkins; }
+
+        SceneDependencies& Dependencies() { return m_dependencies; }
+
+    private:
+        const Document& m_gltfDocument;
+
+        SceneDependencies m_dependencies;
+
+        unordered_set<string> m_nodeIds;
+        unordered_set<string> m_meshIds;
+        unordered_set<string> m_materialIds;
+        bool m_hasSkins = false;
+    };
+
+    SceneDependencies CollectSceneDependencies(const Document& gltfDocument, const Scene& scene, const LoadOptions& loadOptions)
+    {
+        DependencyCollector collector(gltfDocument);
+
+        vector<string> pending(scene.nodes.begin(), scene.nodes.end());
+
+        while (!pending.empty())
+        {
+            string nodeId = move(pending.back());
+            pending.pop_back();
+
+            if (collector.AddNode(nodeId))
+            {
+                const Node& node = gltfDocument.nodes.Get(nodeId);
+                pending.insert(pending.end(), node.children.begin(), node.children.end());
+            }
+        }
+
+        // Only the first animation is imported, see GLTFVisitor::ImportAnimations.
+        if (gltfDocument.animations.Size() > 0)
+        {
+            const bool posesSkins = collector.HasSkins() && loadOptions.skinningPoseTime.has_value();
+
+            collector.AddAnimationChannels(gltfDocument.animations[0], posesSkins);
+        }
+
+        return move(collector.Dependencies());
+    }
+
+    unordered_map<string, TexelUsage> CollectImageUsages(const Document& gltfDocument)
+    {
+        unordered_map<string, TexelUsage> imageUsages;
+
+        for (const Material& material : gltfDocument.materials.Elements())
+        {
+            const bool isBlended = material.alphaMode != AlphaMode::ALPHA_OPAQUE;
+
+            const pair<const TextureInfo*, uint32_t> textureChannels[] =
+            {
+                { &material.metallicRoughness.baseColorTexture, TexelChannel_Red | TexelChannel_Green | TexelChannel_Blue | (isBlended ? static_cast<uint32_t>(TexelChannel_Alpha) : 0u) },
+                { &material.metallicRoughness.metallicRoughnessTexture, TexelChannel_Green | TexelChannel_Blue },
+                { &material.normalTexture, TexelChannel_Red | TexelChannel_Green | TexelChannel_Blue },
+                { &material.occlusionTexture, TexelChannel_Red },
+                { &material.emissiveTexture, TexelChannel_Red | TexelChannel_Green | TexelChannel_Blue },
+            };
+
+            for (const auto& textureChannel : textureChannels)
+            {
+                if (textureChannel.first->textureId.empty())
+                {
+                    continue;
+                }
+
+                const Texture& texture = gltfDocument.textures.Get(textureChannel.first->textureId);
+                const bool isNormalMap = textureChannel.first == &material.normalTexture;
+
+                // An occlusion map packed with metallic and roughness ends up with all three.
+                auto inserted = imageUsages.emplace(texture.imageId, TexelUsage{ 0, true });
+                inserted.first->second.channels |= textureChannel.second;
+                inserted.first->second.isNormalMap &= isNormalMap;
+            }
+        }
+
+        return imageUsages;
+    }
+
+    static void CheckAccessorCount(const Document& gltfDocument, const string& accessorId, const LoadLimits& limits)
+    {
+        if (accessorId.empty())
+        {
+            return;
+        }
+
+        const uint64_t count = gltfDocument.accessors.Get(accessorId).count;
+
+        if (count > limits.maxPrimitiveVertices)
+        {
+            throw LoadLimitException(LoadLimit::PrimitiveVertices, count, limits.maxPrimitiveVertices);
+        }
+    }
+
+    static void CheckMeshLimits(const Document& gltfDocument, const Mesh& mesh, const LoadLimits& limits)
+    {
+        for (const auto& meshPrimitive : mesh.primitives)
+        {
+            for (const auto& attribute : meshPrimitive.attributes)
+            {
+                CheckAccessorCount(gltfDocument, attribute.second, limits);
+            }
+
+            for (const auto& target : meshPrimitive.targets)
+            {
+                CheckAccessorCount(gltfDocument, target.positionsAccessorId, limits);
+                CheckAccessorCount(gltfDocument, target.normalsAccessorId, limits);
+                CheckAccessorCount(gltfDocument, target.tangentsAccessorId, limits);
+            }
+        }
+    }
+
+    void CheckSceneLimits(const Document& gltfDocument, const Scene& scene, const LoadLimits& limits)
+    {
+        if (limits.maxNodeCount > 0 && gltfDocument.nodes.Size() > limits.maxNodeCount)
+        {
+            throw LoadLimitException(LoadLimit::NodeCount, gltfDocument.nodes.Size(), limits.maxNodeCount);
+        }
+
+        if (limits.maxNodeCount == 0 && limits.maxHierarchyDepth == 0 && limits.maxPrimitiveVertices == 0)
+        {
+            return;
+        }
+
+        // Visit follows every path to a node, so that is what the node count counts, and the
+        // count bounds the walk. Without it a node is only followed again when reached deeper
+        // than before, which the depth limit bounds, and without that only once.
+        unordered_map<const Node*, uint64_t> deepestVisits;
+        unordered_set<string> checkedMeshIds;
+        vector<pair<const Node*, uint64_t>> pending;
+        uint64_t nodeCount = 0;
+
+        for (const auto& nodeId : scene.nodes)
+        {
+            pending.emplace_back(&gltfDocument.nodes.Get(nodeId), 1);
+        }
+
+        while (!pending.empty())
+        {
+            const Node* pNode = pending.back().first;
+            const uint64_t depth = pending.back().second;
+            pending.pop_back();
+
+            if (limits.maxNodeCount > 0)
+            {
+                if (++nodeCount > limits.maxNodeCount)
+                {
+                    throw LoadLimitException(LoadLimit::NodeCount, nodeCount, limits.maxNodeCount);
+                }
+            }
+            else
+            {
+                auto deepestVisit = deepestVisits.emplace(pNode, depth);
+
+                if (!deepestVisit.second)
+                {
+                    if (limits.maxHierarchyDepth == 0 || depth <= deepestVisit.first->second)
+                    {
+                        continue;
+                    }
+
+                    deepestVisit.first->second = depth;
+                }
+            }
+
+            if (limits.maxHierarchyDepth > 0 && depth > limits.maxHierarchyDepth)
+            {
+                throw LoadLimitException(LoadLimit::HierarchyDepth, depth, limits.maxHierarchyDepth);
+            }
+
+            if (limits.maxPrimitiveVertices > 0 && !pNode->meshId.empty() && checkedMeshIds.insert(pNode->meshId).second)
+            {
+                CheckMeshLimits(gltfDocument, gltfDocument.meshes.Get(pNode->meshId), limits);
+            }
+
+            for (const auto& childId : pNode->children)
+            {
+                pending.emplace_back(&gltfDocument.nodes.Get(childId), depth + 1);
+            }
+        }
+    }
+} // SceneLoader
@@ -0,0 +1,42 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "LoadOptions.h"
+#include "TexelAnalysis.h"
+
+namespace SceneLoader
+{
+    // The scene to visit for a load. Without a node selection in loadOptions this is the
+    // chosen scene of the document; with one it is a copy of that scene whose root nodes are
+    // the selected subtrees, found by searching from the roots down. Throws if the scene
+    // index doesn't exist.
+    Microsoft::glTF::Scene SelectScene(const Microsoft::glTF::Document& gltfDocument, const LoadOptions& loadOptions);
+
+    // Buffers and images that loading a scene reads.
+    struct SceneDependencies
+    {
+        std::unordered_set<std::string> bufferIds;
+        std::unordered_set<std::string> imageIds;
+    };
+
+    // Follows the nodes of the scene to the accessors, buffer views and images of their
+    // meshes, mesh instances, morph targets, skins and materials, and of the animation channels that target
+    // them. The whole first animation counts when skinned meshes are posed from it.
+    SceneDependencies CollectSceneDependencies(
+        const Microsoft::glTF::Document& gltfDocument,
+        const Microsoft::glTF::Scene& scene,
+        const LoadOptions& loadOptions);
+
+    // Checks the node count and hierarchy depth of the scene and the vertex counts of its
+    // primitives against the limits, without following a node more often than the limits
+    // allow, so cycles and shared subtrees can't keep it going. DeserializeStreaming checks
+    // the document while reading it already; this covers documents from the DOM based
+    // Deserialize and scenes whose roots together have too many nodes.
+    void CheckSceneLimits(const Microsoft::glTF::Document& gltfDocument, const Microsoft::glTF::Scene& scene, const LoadLimits& limits);
+
+    // What the materials of the document sample from each image they use, by image id.
+    std::unordered_map<std::string, TexelUsage> CollectImageUsages(const Microsoft::glTF::Document& gltfDocument);
+} // SceneLoader
@@ -0,0 +1,190 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+#include "SceneStreamingLoad.h"
+
+#include "UtilForIntermingledNamespaces.h"
+#include "SceneSelection.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+using namespace SceneLoader;
+
+namespace winrt {
+    using namespace Windows::UI::Composition;
+    using namespace Windows::UI::Composition::Scenes;
+    using namespace Windows::Storage::Streams;
+}
+using namespace winrt;
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    SceneStreamingLoad::SceneStreamingLoad(
+        com_ptr<SceneLoader> loader,
+        Compositor compositor,
+        LoadOptions loadOptions,
+        shared_ptr<IResourceResolver> resolver,
+        shared_ptr<SharedLoadResources> sharedResources) :
+        m_loader(move(loader)),
+        m_compositor(move(compositor)),
+        m_loadOptions(move(loadOptions)),
+        m_resolver(move(resolver)),
+        m_sharedResources(move(sharedResources)),
+        m_limiter(make_shared<LoadLimiter>(m_loadOptions.limits)),
+        m_input(m_limiter)
+    {
+    }
+
+    SceneStreamingLoad::~SceneStreamingLoad()
+    {
+        // The decodes read bytes this load owns. What they failed with only matters to Complete.
+        m_imageDecodes.cancel();
+
+        try
+        {
+            m_imageDecodes.wait();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void SceneStreamingLoad::Append(IBuffer chunk)
+    {
+        if (m_isCompleted)
+        {
+            throw hresult_illegal_method_call();
+        }
+
+        auto memoryBufferReference = winrt::Windows::Storage::Streams::Buffer::CreateMemoryBufferOverIBuffer(chunk).CreateReference();
+        auto data = GetDataPointerFromMemoryBuffer(memoryBufferReference);
+
+        try
+        {
+            m_input.Append(data.first, data.second);
+
+            ArenaArray<const uint8_t> json;
+
+            if (!m_gltfDoc && m_input.IsJsonReady() && m_input.TryGetJson(&json))
+            {
+                PlanImageDecodes(json);
+            }
+
+            m_limiter->CheckTime();
+        }
+        catch (const LoadLimitException& exception)
+        {
+            SceneLoader::ThrowLoadLimitError(exception);
+        }
+
+        StartImageDecodes();
+    }
+
+    SceneNode SceneStreamingLoad::Complete()
+    {
+        if (m_isCompleted)
+        {
+            throw hresult_illegal_method_call();
+        }
+
+        m_isCompleted = true;
+
+        // Images still being decoded read the bytes, and their failures are reported here.
+        try
+        {
+            m_imageDecodes.wait();
+        }
+        catch (const LoadLimitException& exception)
+        {
+            SceneLoader::ThrowLoadLimitError(exception);
+        }
+
+        m_input.CheckComplete();
+
+        // Whatever wasn't decoded ahead, such as images in data URIs, is decoded with the
+        // document, and images decoded already are skipped; see ParseDocument.
+        auto gltfSource = make_shared<GLTFSource>(m_input.Data(), m_input.Size(), m_resolver);
+
+        return m_loader->LoadFromSource(gltfSource, m_compositor, m_loadOptions, m_sharedResources, move(m_gltfDoc), m_limiter).Node();
+    }
+
+    void SceneStreamingLoad::PlanImageDecodes(ArenaArray<const uint8_t> json)
+    {
+        m_gltfDoc = make_unique<Document>(SceneLoader::DeserializeDocument(json, m_loadOptions));
+
+        // Atlas candidates and deferred textures are decoded their own way, see the Image visitor.
+        if (m_loadOptions.atlasMaxTextureSize > 0 || m_loadOptions.deferTextureDecode)
+        {
+            return;
+        }
+
+        uint64_t binaryChunkOffset = 0;
+        uint64_t binaryChunkLength = 0;
+        const bool hasBinaryChunk = m_input.TryGetBinaryChunk(&binaryChunkOffset, &binaryChunkLength);
+
+        const Scene scene = SelectScene(*m_gltfDoc, m_loadOptions);
+
+        CheckSceneLimits(*m_gltfDoc, scene, m_loadOptions.limits);
+        const auto imageUsages = CollectImageUsages(*m_gltfDoc);
+
+        for (const auto& imageId : CollectSceneDependencies(*m_gltfDoc, scene, m_loadOptions).imageIds)
+        {
+            const Image& image = m_gltfDoc->images.Get(imageId);
+
+            auto usage = imageUsages.find(imageId);
+            const bool keepAlpha = (usage == imageUsages.end()) || (usage->second.channels & TexelChannel_Alpha);
+
+            ArenaArray<const uint8_t> bytes;
+
+            // Images in external files are all there already.
+            if (image.bufferViewId.empty())
+            {
+                if (m_resolver && !image.uri.empty() && !IsDataUri(image.uri) && m_resolver->TryResolve(image.uri, &bytes))
+                {
+                    StartImageDecode(bytes.data, bytes.size, keepAlpha);
+                }
+
+                continue;
+            }
+
+            const BufferView& bufferView = m_gltfDoc->bufferViews.Get(image.bufferViewId);
+            const Microsoft::glTF::Buffer& buffer = m_gltfDoc->buffers.Get(bufferView.bufferId);
+
+            if (buffer.uri.empty())
+            {
+                // Only the first buffer of a GLB may omit the uri, and it refers to the binary chunk.
+                if (hasBinaryChunk && bufferView.byteOffset <= binaryChunkLength && bufferView.byteLength <= binaryChunkLength - bufferView.byteOffset)
+                {
+                    m_input.AwaitRange(binaryChunkOffset + bufferView.byteOffset, bufferView.byteLength, m_pendingImages.size());
+                    m_pendingImages.push_back({ binaryChunkOffset + bufferView.byteOffset, bufferView.byteLength, keepAlpha });
+                }
+            }
+            else if (m_resolver && !IsDataUri(buffer.uri) && m_resolver->TryResolve(buffer.uri, &bytes))
+            {
+                if (bufferView.byteOffset <= bytes.size && bufferView.byteLength <= bytes.size - bufferView.byteOffset)
+                {
+                    StartImageDecode(bytes.data + bufferView.byteOffset, bufferView.byteLength, keepAlpha);
+                }
+            }
+        }
+    }
+
+    void SceneStreamingLoad::StartImageDecodes()
+    {
+        for (size_t tag : m_input.TakeArrivedRanges())
+        {
+            const PendingImage& image = m_pendingImages[tag];
+            StartImageDecode(m_input.Data() + image.offset, static_cast<size_t>(image.length), image.keepAlpha);
+        }
+    }
+
+    void SceneStreamingLoad::StartImageDecode(const uint8_t* pData, size_t byteLength, bool keepAlpha)
+    {
+        m_imageDecodes.run([sharedResources = m_sharedResources, limiter = m_limiter, pData, byteLength, keepAlpha]()
+        {
+            sharedResources->DecodeImage(pData, byteLength, keepAlpha, *limiter);
+        });
+    }
+}
@@ -0,0 +1,62 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "SceneStreamingLoad.g.h"
+#include "SceneLoader.h"
+#include "ChunkedInput.h"
+
+namespace winrt::SceneLoaderComponent::implementation
+{
+    struct SceneStreamingLoad : SceneStreamingLoadT<SceneStreamingLoad>
+    {
+        SceneStreamingLoad(
+            com_ptr<SceneLoader> loader,
+            winrt::Windows::UI::Composition::Compositor compositor,
+            ::SceneLoader::LoadOptions loadOptions,
+            std::shared_ptr<::SceneLoader::IResourceResolver> resolver,
+            std::shared_ptr<::SceneLoader::SharedLoadResources> sharedResources);
+
+        ~SceneStreamingLoad();
+
+        void Append(winrt::Windows::Storage::Streams::IBuffer chunk);
+        winrt::Windows::UI::Composition::Scenes::SceneNode Complete();
+
+    private:
+        // An image in the GLB binary chunk, decoded once m_input hands its range back.
+        struct PendingImage
+        {
+            uint64_t offset;
+            uint64_t length;
+            bool keepAlpha;
+        };
+
+        // Deserializes the JSON and works out where the images of the scene are.
+        void PlanImageDecodes(::SceneLoader::ArenaArray<const uint8_t> json);
+
+        void StartImageDecodes();
+        void StartImageDecode(const uint8_t* pData, size_t byteLength, bool keepAlpha);
+
+        com_ptr<SceneLoader> m_loader;
+        winrt::Windows::UI::Composition::Compositor m_compositor;
+        ::SceneLoader::LoadOptions m_loadOptions;
+        std::shared_ptr<::SceneLoader::IResourceResolver> m_resolver;
+        std::shared_ptr<::SceneLoader::SharedLoadResources> m_sharedResources;
+
+        // Started with the load, so MaxLoadTime includes the time the file takes to arrive.
+        std::shared_ptr<::SceneLoader::LoadLimiter> m_limiter;
+
+        ::SceneLoader::ChunkedInput m_input;
+
+        // Deserialized as soon as the JSON chunk of a GLB is in. A .gltf is parsed by Complete.
+        std::unique_ptr<Microsoft::glTF::Document> m_gltfDoc;
+
+        // Indexed by the tags of the ranges m_input awaits.
+        std::vector<PendingImage> m_pendingImages;
+
+        concurrency::task_group m_imageDecodes;
+        bool m_isCompleted = false;
+    };
+}
@@ -0,0 +1,144 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "SharedLoadResources.h"
+#include "SceneSelection.h"
+#include "ContentHash.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace winrt {
+    using namespace Windows::UI::Composition;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    SharedLoadResources::SharedLoadResources(shared_ptr<DeviceResources> deviceResources) :
+        m_deviceResources(deviceResources)
+    {
+    }
+
+    uint64_t
+    SharedLoadResources::GetImageKey(const uint8_t* pData, size_t byteLength, bool keepAlpha)
+    {
+        // The same bytes decode to different pixels with and without alpha.
+        return ComputeContentHash(pData, byteLength, keepAlpha ? 1 : 0);
+    }
+
+    void
+    SharedLoadResources::DecodeImages(const Document& gltfDocument, const unordered_set<string>& imageIds, AccessorDecoder& accessorDecoder, LoadLimiter& limiter)
+    {
+        struct Job
+        {
+            ArenaArray<const uint8_t> encodedImage;
+            bool keepAlpha;
+        };
+
+        // Holds the encoded images that can't be read in place until they are decoded.
+        DecodeArena arena;
+
+        const auto imageUsages = CollectImageUsages(gltfDocument);
+        vector<Job> jobs;
+
+        for (const auto& imageId : imageIds)
+        {
+            auto usage = imageUsages.find(imageId);
+
+            Job job;
+            job.encodedImage = accessorDecoder.ReadImageBytes(arena, gltfDocument.images.Get(imageId));
+            job.keepAlpha = (usage == imageUsages.end()) || (usage->second.channels & TexelChannel_Alpha);
+
+            jobs.push_back(job);
+        }
+
+        concurrency::parallel_for(size_t(0), jobs.size(), [&](size_t i)
+        {
+            DecodeImage(jobs[i].encodedImage.data, jobs[i].encodedImage.size, jobs[i].keepAlpha, limiter);
+        });
+    }
+
+    void
+    SharedLoadResources::DecodeImage(const uint8_t* pData, size_t byteLength, bool keepAlpha, LoadLimiter& limiter)
+    {
+        const uint64_t key = GetImageKey(pData, byteLength, keepAlpha);
+
+        {
+            lock_guard<mutex> lock(m_lock);
+
+            // Whoever gets here first decodes it.
+            if (!m_decodedImages.emplace(key, nullptr).second)
+            {
+                return;
+            }
+        }
+
+        HRESULT hrInitialize = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        auto decodedImage = make_unique<DecodedImage>();
+        exception_ptr failure;
+
+        try
+        {
+            DecodeArena scratch;
+            ArenaArray<uint8_t> pixels = DecodeImagePixels(
+                m_deviceResources->ImagingFactory(),
+                scratch,
+                pData,
+                byteLength,
+                keepAlpha,
+                &decodedImage->width,
+                &decodedImage->height,
+                &limiter);
+
+            decodedImage->pixels.assign(pixels.begin(), pixels.end());
+        }
+        catch (...)
+        {
+            failure = current_exception();
+        }
+
+        if (SUCCEEDED(hrInitialize))
+        {
+            CoUninitialize();
+        }
+
+        if (failure)
+        {
+            rethrow_exception(failure);
+        }
+
+        lock_guard<mutex> lock(m_lock);
+        m_decodedImages[key] = move(decodedImage);
+    }
+
+    const DecodedImage*
+    SharedLoadResources::FindDecodedImage(uint64_t key) const
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        auto decodedImage = m_decodedImages.find(key);
+        return (decodedImage != m_decodedImages.end()) ? decodedImage->second.get() : nullptr;
+    }
+
+    CompositionMipmapSurface
+    SharedLoadResources::FindSurface(uint64_t key) const
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        auto surface = m_surfaces.find(key);
+        return (surface != m_surfaces.end()) ? surface->second : nullptr;
+    }
+
+    void
+    SharedLoadResources::StoreSurface(uint64_t key, CompositionMipmapSurface surface)
+    {
+        lock_guard<mutex> lock(m_lock);
+
+        m_surfaces.emplace(key, surface);
+    }
+} // SceneLoader
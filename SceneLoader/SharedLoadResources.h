@@ -0,0 +1,63 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "AccessorDecoder.h"
+#include "ImageDecoder.h"
+#include "TexelAnalysis.h"
+#include "DeviceResources.h"
+
+namespace SceneLoader
+{
+    // An image decoded ahead of the visit into tightly packed premultiplied BGRA pixels.
+    struct DecodedImage
+    {
+        std::vector<uint8_t> pixels;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // What the loads of one SceneLoader::LoadMany call, or the decodes of a SceneStreamingLoad
+    // and its load, share on top of the DeviceResources of the SceneLoader: a table of the
+    // images they use. Images with the same encoded bytes that
+    // are decoded the same way are decoded once and uploaded to a single surface.
+    class SharedLoadResources
+    {
+    public:
+        SharedLoadResources(std::shared_ptr<DeviceResources> deviceResources);
+
+        static uint64_t GetImageKey(const uint8_t* pData, size_t byteLength, bool keepAlpha);
+
+        // Decodes the images of a document that no other document has decoded yet, on the
+        // thread pool. Documents can be decoded concurrently; the accessor decoder is only
+        // used by the calling thread. The images are charged to the limiter of the load that
+        // decodes them first.
+        void DecodeImages(
+            const Microsoft::glTF::Document& gltfDocument,
+            const std::unordered_set<std::string>& imageIds,
+            AccessorDecoder& accessorDecoder,
+            LoadLimiter& limiter);
+
+        // Decodes one encoded image on the calling thread unless another load already has.
+        // The bytes only need to stay valid for the call.
+        void DecodeImage(const uint8_t* pData, size_t byteLength, bool keepAlpha, LoadLimiter& limiter);
+
+        // Null unless DecodeImages decoded the image.
+        const DecodedImage* FindDecodedImage(uint64_t key) const;
+
+        // Null until a load stores the surface it uploaded the image to.
+        winrt::Windows::UI::Composition::CompositionMipmapSurface FindSurface(uint64_t key) const;
+        void StoreSurface(uint64_t key, winrt::Windows::UI::Composition::CompositionMipmapSurface surface);
+
+    private:
+        std::shared_ptr<DeviceResources> m_deviceResources;
+
+        mutable std::mutex m_lock;
+
+        // Null while the image is being decoded.
+        std::unordered_map<uint64_t, std::unique_ptr<DecodedImage>> m_decodedImages;
+        std::unordered_map<uint64_t, winrt::Windows::UI::Composition::CompositionMipmapSurface> m_surfaces;
+    };
+} // SceneLoader
@@ -0,0 +1,186 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+// SSE2 is part of every x86/x64 target we build for and NEON of every ARM64 one,
+// so these need no runtime dispatch. Anything else falls back to plain floats.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SCENELOADER_SIMD_SSE
+#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define SCENELOADER_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace SceneLoader
+{
+    // Four floats processed together by the CPU-side geometry and animation kernels.
+    struct Vec4
+    {
+#if defined(SCENELOADER_SIMD_SSE)
+        __m128 v;
+#elif defined(SCENELOADER_SIMD_NEON)
+        float32x4_t v;
+#else
+        float v[4];
+#endif
+
+        static Vec4 Load(const float* p)
+        {
+            Vec4 r;
+#if defined(SCENELOADER_SIMD_SSE)
+            r.v = _mm_loadu_ps(p);
+#elif defined(SCENELOADER_SIMD_NEON)
+            r.v = vld1q_f32(p);
+#else
+            for (int i = 0; i < 4; ++i) { r.v[i] = p[i]; }
+#endif
+            return r;
+        }
+
+        static Vec4 Splat(float value)
+        {
+            Vec4 r;
+#if defined(SCENELOADER_SIMD_SSE)
+            r.v = _mm_set1_ps(value);
+#elif defined(SCENELOADER_SIMD_NEON)
+            r.v = vdupq_n_f32(value);
+#else
+            for (int i = 0; i < 4; ++i) { r.v[i] = value; }
+#endif
+            return r;
+        }
+
+        static Vec4 Zero()
+        {
+            return Splat(0.0f);
+        }
+
+        static Vec4 Set(float x, float y, float z, float w)
+        {
+            Vec4 r;
+#if defined(SCENELOADER_SIMD_SSE)
+            r.v = _mm_setr_ps(x, y, z, w);
+#elif defined(SCENELOADER_SIMD_NEON)
+            const float values[4] = { x, y, z, w };
+            r.v = vld1q_f32(values);
+#else
+            r.v[0] = x; r.v[1] = y; r.v[2] = z; r.v[3] = w;
+#endif
+            return r;
+        }
+
+        void Store(float* p) const
+        {
+#if defined(SCENELOADER_SIMD_SSE)
+            _mm_storeu_ps(p, v);
+#elif defined(SCENELOADER_SIMD_NEON)
+            vst1q_f32(p, v);
+#else
+            for (int i = 0; i < 4; ++i) { p[i] = v[i]; }
+#endif
+        }
+    };
+
+#if defined(SCENELOADER_SIMD_SSE)
+    inline Vec4 operator+(Vec4 a, Vec4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    inline Vec4 operator-(Vec4 a, Vec4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    inline Vec4 operator*(Vec4 a, Vec4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+    inline Vec4 Min(Vec4 a, Vec4 b) { return { _mm_min_ps(a.v, b.v) }; }
+    inline Vec4 Max(Vec4 a, Vec4 b) { return { _mm_max_ps(a.v, b.v) }; }
+    inline Vec4 Abs(Vec4 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+    inline Vec4 operator/(Vec4 a, Vec4 b) { return { _mm_div_ps(a.v, b.v) }; }
+    inline Vec4 Sqrt(Vec4 a) { return { _mm_sqrt_ps(a.v) }; }
+
+    // Rows to columns.
+    inline void Transpose(Vec4& a, Vec4& b, Vec4& c, Vec4& d)
+    {
+        _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+    }
+
+    inline float HorizontalMax(Vec4 a)
+    {
+        __m128 m = _mm_max_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(m);
+    }
+
+    inline float HorizontalSum(Vec4 a)
+    {
+        __m128 s = _mm_add_ps(a.v, _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(s);
+    }
+
+    // Masks are only meant for Select and AnyTrue; their lanes are all ones or all zeros.
+    inline Vec4 CompareLess(Vec4 a, Vec4 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+    inline Vec4 Select(Vec4 mask, Vec4 ifTrue, Vec4 ifFalse) { return { _mm_or_ps(_mm_and_ps(mask.v, ifTrue.v), _mm_andnot_ps(mask.v, ifFalse.v)) }; }
+    inline bool AnyTrue(Vec4 mask) { return _mm_movemask_ps(mask.v) != 0; }
+#elif defined(SCENELOADER_SIMD_NEON)
+    inline Vec4 operator+(Vec4 a, Vec4 b) { return { vaddq_f32(a.v, b.v) }; }
+    inline Vec4 operator-(Vec4 a, Vec4 b) { return { vsubq_f32(a.v, b.v) }; }
+    inline Vec4 operator*(Vec4 a, Vec4 b) { return { vmulq_f32(a.v, b.v) }; }
+    inline Vec4 Min(Vec4 a, Vec4 b) { return { vminq_f32(a.v, b.v) }; }
+    inline Vec4 Max(Vec4 a, Vec4 b) { return { vmaxq_f32(a.v, b.v) }; }
+    inline Vec4 Abs(Vec4 a) { return { vabsq_f32(a.v) }; }
+    inline Vec4 operator/(Vec4 a, Vec4 b) { return { vdivq_f32(a.v, b.v) }; }
+    inline Vec4 Sqrt(Vec4 a) { return { vsqrtq_f32(a.v) }; }
+
+    inline void Transpose(Vec4& a, Vec4& b, Vec4& c, Vec4& d)
+    {
+        float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+        float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+        a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+        b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+        c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+        d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+    }
+    inline float HorizontalMax(Vec4 a) { return vmaxvq_f32(a.v); }
+    inline float HorizontalSum(Vec4 a) { return vaddvq_f32(a.v); }
+
+    inline Vec4 CompareLess(Vec4 a, Vec4 b) { return { vreinterpretq_f32_u32(vcltq_f32(a.v, b.v)) }; }
+    inline Vec4 Select(Vec4 mask, Vec4 ifTrue, Vec4 ifFalse) { return { vbslq_f32(vreinterpretq_u32_f32(mask.v), ifTrue.v, ifFalse.v) }; }
+    inline bool AnyTrue(Vec4 mask) { return vmaxvq_u32(vreinterpretq_u32_f32(mask.v)) != 0; }
+#else
+    inline Vec4 operator+(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] + b.v[i]; } return r; }
+    inline Vec4 operator-(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] - b.v[i]; } return r; }
+    inline Vec4 operator*(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] * b.v[i]; } return r; }
+    inline Vec4 Min(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; } return r; }
+    inline Vec4 Max(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; } return r; }
+    inline Vec4 Abs(Vec4 a) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] < 0.0f ? -a.v[i] : a.v[i]; } return r; }
+    inline Vec4 operator/(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] / b.v[i]; } return r; }
+    inline Vec4 Sqrt(Vec4 a) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = sqrtf(a.v[i]); } return r; }
+
+    inline void Transpose(Vec4& a, Vec4& b, Vec4& c, Vec4& d)
+    {
+        Vec4 rows[4] = { a, b, c, d };
+        for (int i = 0; i < 4; ++i)
+        {
+            a.v[i] = rows[i].v[0];
+            b.v[i] = rows[i].v[1];
+            c.v[i] = rows[i].v[2];
+            d.v[i] = rows[i].v[3];
+        }
+    }
+    inline float HorizontalMax(Vec4 a) { return std::max(std::max(a.v[0], a.v[1]), std::max(a.v[2], a.v[3])); }
+    inline float HorizontalSum(Vec4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+
+    // Without a vector unit a mask lane is 1 for true and 0 for false.
+    inline Vec4 CompareLess(Vec4 a, Vec4 b) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = a.v[i] < b.v[i] ? 1.0f : 0.0f; } return r; }
+    inline Vec4 Select(Vec4 mask, Vec4 ifTrue, Vec4 ifFalse) { Vec4 r; for (int i = 0; i < 4; ++i) { r.v[i] = mask.v[i] != 0.0f ? ifTrue.v[i] : ifFalse.v[i]; } return r; }
+    inline bool AnyTrue(Vec4 mask) { return mask.v[0] != 0.0f || mask.v[1] != 0.0f || mask.v[2] != 0.0f || mask.v[3] != 0.0f; }
+#endif
+
+    // a * b + c
+    inline Vec4 MultiplyAdd(Vec4 a, Vec4 b, Vec4 c)
+    {
+        return a * b + c;
+    }
+
+    inline float Dot(Vec4 a, Vec4 b)
+    {
+        return HorizontalSum(a * b);
+    }
+} // SceneLoader
@@ -0,0 +1,166 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "SkinningKernel.h"
+#include "SimdMath.h"
+
+namespace SceneLoader
+{
+    // Weighted sum of the four joint matrices of one vertex, one Vec4 per row.
+    static inline void BlendJointMatrices(
+        const SkinningStreams& streams,
+        const SkinningMatrix* jointMatrices,
+        size_t vertex,
+        Vec4* pRows)
+    {
+        Vec4 row0 = Vec4::Zero();
+        Vec4 row1 = Vec4::Zero();
+        Vec4 row2 = Vec4::Zero();
+
+        for (size_t influence = 0; influence < 4; ++influence)
+        {
+            const SkinningMatrix& joint = jointMatrices[streams.joints[influence][vertex]];
+            const Vec4 weight = Vec4::Splat(streams.weights[influence][vertex]);
+
+            row0 = MultiplyAdd(weight, Vec4::Load(joint.rows[0]), row0);
+            row1 = MultiplyAdd(weight, Vec4::Load(joint.rows[1]), row1);
+            row2 = MultiplyAdd(weight, Vec4::Load(joint.rows[2]), row2);
+        }
+
+        pRows[0] = row0;
+        pRows[1] = row1;
+        pRows[2] = row2;
+    }
+
+    static inline void StorePacked(Vec4 x, Vec4 y, Vec4 z, float* pDestination)
+    {
+        float components[3][4];
+
+        x.Store(components[0]);
+        y.Store(components[1]);
+        z.Store(components[2]);
+
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+            pDestination[lane * 3 + 0] = components[0][lane];
+            pDestination[lane * 3 + 1] = components[1][lane];
+            pDestination[lane * 3 + 2] = components[2][lane];
+        }
+    }
+
+    static void SkinVertex(
+        const SkinningStreams& streams,
+        const SkinningMatrix* jointMatrices,
+        size_t vertex,
+        float* pPositions,
+        float* pNormals)
+    {
+        Vec4 blended[3];
+        BlendJointMatrices(streams, jointMatrices, vertex, blended);
+
+        float rows[3][4];
+        blended[0].Store(rows[0]);
+        blended[1].Store(rows[1]);
+        blended[2].Store(rows[2]);
+
+        const float px = streams.position[0][vertex];
+        const float py = streams.position[1][vertex];
+        const float pz = streams.position[2][vertex];
+
+        for (size_t component = 0; component < 3; ++component)
+        {
+            const float* row = rows[component];
+            pPositions[vertex * 3 + component] = row[0] * px + row[1] * py + row[2] * pz + row[3];
+        }
+
+        if (pNormals)
+        {
+            const float nx = streams.normal[0][vertex];
+            const float ny = streams.normal[1][vertex];
+            const float nz = streams.normal[2][vertex];
+
+            float normal[3];
+
+            for (size_t component = 0; component < 3; ++component)
+            {
+                const float* row = rows[component];
+                normal[component] = row[0] * nx + row[1] * ny + row[2] * nz;
+            }
+
+            const float lengthSquared = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+            const float scale = 1.0f / sqrtf(std::max(lengthSquared, 1e-30f));
+
+            for (size_t component = 0; component < 3; ++component)
+            {
+                pNormals[vertex * 3 + component] = normal[component] * scale;
+            }
+        }
+    }
+
+    void SkinVertices(
+        const SkinningStreams& streams,
+        const SkinningMatrix* jointMatrices,
+        size_t begin,
+        size_t end,
+        float* pPositions,
+        float* pNormals)
+    {
+        const bool hasNormals = pNormals && streams.normal[0];
+        size_t vertex = begin;
+
+        for (; vertex + 4 <= end; vertex += 4)
+        {
+            // Blend per vertex, where each matrix row is one load, then transpose so that
+            // m[row][column] holds that matrix element for all four vertices.
+            Vec4 m[3][4];
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                Vec4 rows[3];
+                BlendJointMatrices(streams, jointMatrices, vertex + lane, rows);
+
+                m[0][lane] = rows[0];
+                m[1][lane] = rows[1];
+                m[2][lane] = rows[2];
+            }
+
+            Transpose(m[0][0], m[0][1], m[0][2], m[0][3]);
+            Transpose(m[1][0], m[1][1], m[1][2], m[1][3]);
+            Transpose(m[2][0], m[2][1], m[2][2], m[2][3]);
+
+            const Vec4 px = Vec4::Load(streams.position[0] + vertex);
+            const Vec4 py = Vec4::Load(streams.position[1] + vertex);
+            const Vec4 pz = Vec4::Load(streams.position[2] + vertex);
+
+            StorePacked(
+                MultiplyAdd(m[0][0], px, MultiplyAdd(m[0][1], py, MultiplyAdd(m[0][2], pz, m[0][3]))),
+                MultiplyAdd(m[1][0], px, MultiplyAdd(m[1][1], py, MultiplyAdd(m[1][2], pz, m[1][3]))),
+                MultiplyAdd(m[2][0], px, MultiplyAdd(m[2][1], py, MultiplyAdd(m[2][2], pz, m[2][3]))),
+                pPositions + vertex * 3);
+
+            if (hasNormals)
+            {
+                const Vec4 nx = Vec4::Load(streams.normal[0] + vertex);
+                const Vec4 ny = Vec4::Load(streams.normal[1] + vertex);
+                const Vec4 nz = Vec4::Load(streams.normal[2] + vertex);
+
+                Vec4 x = MultiplyAdd(m[0][0], nx, MultiplyAdd(m[0][1], ny, m[0][2] * nz));
+                Vec4 y = MultiplyAdd(m[1][0], nx, MultiplyAdd(m[1][1], ny, m[1][2] * nz));
+                Vec4 z = MultiplyAdd(m[2][0], nx, MultiplyAdd(m[2][1], ny, m[2][2] * nz));
+
+                // Degenerate normals come out as tiny vectors instead of NaNs.
+                const Vec4 length = Sqrt(Max(MultiplyAdd(x, x, MultiplyAdd(y, y, z * z)), Vec4::Splat(1e-30f)));
+
+                StorePacked(x / length, y / length, z / length, pNormals + vertex * 3);
+            }
+        }
+
+        for (; vertex < end; ++vertex)
+        {
+            SkinVertex(streams, jointMatrices, vertex, pPositions, hasNormals ? pNormals : nullptr);
+        }
+    }
+} // SceneLoader
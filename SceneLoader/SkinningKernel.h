@@ -0,0 +1,37 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // The affine part of a row-vector joint matrix, stored by output component so
+    // that x' = rows[0] . (x, y, z, 1), and likewise for y' and z'.
+    struct SkinningMatrix
+    {
+        float rows[3][4];
+    };
+
+    // Vertex data split into one stream per component, so that four vertices fill a Vec4.
+    // Weights of a vertex are expected to sum to one.
+    struct SkinningStreams
+    {
+        size_t vertexCount = 0;
+        const float* position[3] = {};
+        const float* normal[3] = {};        // All null when the primitive has no normals.
+        const uint16_t* joints[4] = {};
+        const float* weights[4] = {};
+    };
+
+    // Skins vertices [begin, end) with four influences each and writes them as packed xyz to
+    // pPositions and pNormals, at the same vertex index. Normals are transformed by the blended
+    // matrix and renormalized. Disjoint ranges can be skinned on different threads.
+    void SkinVertices(
+        const SkinningStreams& streams,
+        const SkinningMatrix* jointMatrices,
+        size_t begin,
+        size_t end,
+        float* pPositions,
+        float* pNormals);
+} // SceneLoader
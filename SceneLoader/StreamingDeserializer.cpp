@@ -0,0 +1,856 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "JsonReader.h"
+#include "StreamingDeserializer.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+
+namespace SceneLoader
+{
+    static AccessorType ParseAccessorType(string_view type)
+    {
+        if (type == "SCALAR") return TYPE_SCALAR;
+        if (type == "VEC2") return TYPE_VEC2;
+        if (type == "VEC3") return TYPE_VEC3;
+        if (type == "VEC4") return TYPE_VEC4;
+        if (type == "MAT2") return TYPE_MAT2;
+        if (type == "MAT3") return TYPE_MAT3;
+        if (type == "MAT4") return TYPE_MAT4;
+
+        throw InvalidGLTFException("Unknown accessor type " + string(type));
+    }
+
+    static ComponentType ToComponentType(size_t value)
+    {
+        switch (value)
+        {
+        case COMPONENT_BYTE:
+        case COMPONENT_UNSIGNED_BYTE:
+        case COMPONENT_SHORT:
+        case COMPONENT_UNSIGNED_SHORT:
+        case COMPONENT_UNSIGNED_INT:
+        case COMPONENT_FLOAT:
+            return static_cast<ComponentType>(value);
+        }
+
+        throw InvalidGLTFException("Unknown accessor component type " + to_string(value));
+    }
+
+    static TargetPath ParseTargetPath(string_view path)
+    {
+        if (path == "translation") return TARGET_TRANSLATION;
+        if (path == "rotation") return TARGET_ROTATION;
+        if (path == "scale") return TARGET_SCALE;
+        if (path == "weights") return TARGET_WEIGHTS;
+
+        throw InvalidGLTFException("Unknown animation target path " + string(path));
+    }
+
+    static InterpolationType ParseInterpolationType(string_view interpolation)
+    {
+        if (interpolation == "LINEAR") return INTERPOLATION_LINEAR;
+        if (interpolation == "STEP") return INTERPOLATION_STEP;
+        if (interpolation == "CUBICSPLINE") return INTERPOLATION_CUBICSPLINE;
+
+        throw InvalidGLTFException("Unknown animation interpolation " + string(interpolation));
+    }
+
+    static AlphaMode ParseAlphaMode(string_view alphaMode)
+    {
+        if (alphaMode == "OPAQUE") return ALPHA_OPAQUE;
+        if (alphaMode == "BLEND") return ALPHA_BLEND;
+        if (alphaMode == "MASK") return ALPHA_MASK;
+
+        throw InvalidGLTFException("Unknown material alpha mode " + string(alphaMode));
+    }
+
+    static MeshMode ToMeshMode(size_t value)
+    {
+        if (value > MESH_TRIANGLE_FAN)
+        {
+            throw InvalidGLTFException("Unknown mesh primitive mode " + to_string(value));
+        }
+
+        return static_cast<MeshMode>(value);
+    }
+
+    static MagFilterMode ToMagFilterMode(size_t value)
+    {
+        if (value != MagFilter_NEAREST && value != MagFilter_LINEAR)
+        {
+            throw InvalidGLTFException("Unknown sampler magnification filter " + to_string(value));
+        }
+
+        return static_cast<MagFilterMode>(value);
+    }
+
+    static MinFilterMode ToMinFilterMode(size_t value)
+    {
+        switch (value)
+        {
+        case MinFilter_NEAREST:
+        case MinFilter_LINEAR:
+        case MinFilter_NEAREST_MIPMAP_NEAREST:
+        case MinFilter_LINEAR_MIPMAP_NEAREST:
+        case MinFilter_NEAREST_MIPMAP_LINEAR:
+        case MinFilter_LINEAR_MIPMAP_LINEAR:
+            return static_cast<MinFilterMode>(value);
+        }
+
+        throw InvalidGLTFException("Unknown sampler minification filter " + to_string(value));
+    }
+
+    static WrapMode ToWrapMode(size_t value)
+    {
+        if (value != Wrap_REPEAT && value != Wrap_CLAMP_TO_EDGE && value != Wrap_MIRRORED_REPEAT)
+        {
+            throw InvalidGLTFException("Unknown sampler wrap mode " + to_string(value));
+        }
+
+        return static_cast<WrapMode>(value);
+    }
+
+    static BufferViewTarget ToBufferViewTarget(size_t value)
+    {
+        if (value != ARRAY_BUFFER && value != ELEMENT_ARRAY_BUFFER)
+        {
+            throw InvalidGLTFException("Unknown buffer view target " + to_string(value));
+        }
+
+        return static_cast<BufferViewTarget>(value);
+    }
+
+    static void RequireMember(bool isPresent, const char* member, const char* object, const string& id)
+    {
+        if (!isPresent)
+        {
+            throw InvalidGLTFException(string(object) + (id.empty() ? "" : " " + id) + " has no " + member);
+        }
+    }
+
+    // The member functions each read one kind of object, the reader positioned on its
+    // opening brace. Members they don't know are skipped.
+    class StreamingDocumentReader
+    {
+    public:
+        StreamingDocumentReader(const char* json, size_t length, const LoadLimits& limits) :
+            m_reader(json, length),
+            m_limitChecker(limits)
+        {
+        }
+
+        Document Read()
+        {
+            Document document;
+            bool hasAsset = false;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "asset") { ReadAsset(document.asset); hasAsset = true; }
+                else if (key == "scene") document.defaultSceneId = ReadId();
+                else if (key == "extensionsUsed") ReadStringSet(document.extensionsUsed);
+                else if (key == "extensionsRequired") ReadStringSet(document.extensionsRequired);
+                else if (key == "accessors") ReadCollection(document.accessors, &StreamingDocumentReader::ReadAccessor);
+                else if (key == "animations") ReadCollection(document.animations, &StreamingDocumentReader::ReadAnimation);
+                else if (key == "buffers") ReadCollection(document.buffers, &StreamingDocumentReader::ReadBuffer);
+                else if (key == "bufferViews") ReadCollection(document.bufferViews, &StreamingDocumentReader::ReadBufferView);
+                else if (key == "images") ReadCollection(document.images, &StreamingDocumentReader::ReadImage);
+                else if (key == "materials") ReadCollection(document.materials, &StreamingDocumentReader::ReadMaterial);
+                else if (key == "meshes") ReadCollection(document.meshes, &StreamingDocumentReader::ReadMesh);
+                else if (key == "nodes") { ReadCollection(document.nodes, &StreamingDocumentReader::ReadNode); m_limitChecker.CheckHierarchy(); }
+                else if (key == "samplers") ReadCollection(document.samplers, &StreamingDocumentReader::ReadSampler);
+                else if (key == "scenes") ReadCollection(document.scenes, &StreamingDocumentReader::ReadScene);
+                else if (key == "skins") ReadCollection(document.skins, &StreamingDocumentReader::ReadSkin);
+                else if (key == "textures") ReadCollection(document.textures, &StreamingDocumentReader::ReadTexture);
+                else if (!ReadPropertyMember(key, document)) m_reader.SkipValue();
+            }
+
+            m_reader.ExpectEnd();
+
+            if (!hasAsset)
+            {
+                throw InvalidGLTFException("The document has no asset");
+            }
+
+            return document;
+        }
+
+    private:
+        // Every id in a glTF 2.0 document is an index. The strings are made once per index
+        // and copied from here; they are short enough to stay in the small string buffer.
+        // The table only grows one index at a time, as collections are read, so that an
+        // out of range reference can't make it huge.
+        string Id(size_t index)
+        {
+            if (index == m_indexIds.size())
+            {
+                m_indexIds.push_back(to_string(index));
+            }
+
+            return (index < m_indexIds.size()) ? m_indexIds[index] : to_string(index);
+        }
+
+        string ReadId()
+        {
+            return Id(m_reader.ReadIndex());
+        }
+
+        string ReadVertexAccessorId()
+        {
+            const size_t accessorIndex = m_reader.ReadIndex();
+
+            m_limitChecker.AddVertexAccessor(accessorIndex);
+
+            return Id(accessorIndex);
+        }
+
+        vector<string> ReadIdArray()
+        {
+            vector<string> ids;
+
+            m_reader.BeginArray();
+
+            while (m_reader.NextElement())
+            {
+                ids.push_back(ReadId());
+            }
+
+            return ids;
+        }
+
+        vector<float> ReadFloatArray()
+        {
+            vector<float> values;
+
+            m_reader.BeginArray();
+
+            while (m_reader.NextElement())
+            {
+                values.push_back(m_reader.ReadFloat());
+            }
+
+            return values;
+        }
+
+        void ReadFloats(float* pValues, size_t count)
+        {
+            size_t read = 0;
+
+            m_reader.BeginArray();
+
+            while (m_reader.NextElement())
+            {
+                if (read == count)
+                {
+                    m_reader.Fail("Too many array elements");
+                }
+
+                pValues[read++] = m_reader.ReadFloat();
+            }
+
+            if (read != count)
+            {
+                m_reader.Fail("Too few array elements");
+            }
+        }
+
+        void ReadStringSet(unordered_set<string>& strings)
+        {
+            m_reader.BeginArray();
+
+            while (m_reader.NextElement())
+            {
+                strings.insert(m_reader.ReadString());
+            }
+        }
+
+        // Extensions and extras stay text until someone asks for them.
+        bool ReadPropertyMember(string_view key, glTFProperty& property)
+        {
+            if (key == "extensions")
+            {
+                m_reader.BeginObject();
+
+                string_view name;
+
+                while (m_reader.NextMember(&name))
+                {
+                    // The view of the name doesn't survive SkipValue.
+                    string extensionName(name);
+
+                    property.extensions.emplace(move(extensionName), string(m_reader.SkipValue()));
+                }
+
+                return true;
+            }
+
+            if (key == "extras")
+            {
+                property.extras = string(m_reader.SkipValue());
+                return true;
+            }
+
+            return false;
+        }
+
+        bool ReadChildOfRootMember(string_view key, glTFChildOfRootProperty& property)
+        {
+            if (key == "name")
+            {
+                property.name = m_reader.ReadString();
+                return true;
+            }
+
+            return ReadPropertyMember(key, property);
+        }
+
+        template<typename T>
+        void ReadCollection(IndexedContainer<const T>& container, void (StreamingDocumentReader::*readElement)(T&))
+        {
+            m_reader.BeginArray();
+
+            while (m_reader.NextElement())
+            {
+                T element;
+                element.id = Id(container.Size());
+
+                (this->*readElement)(element);
+
+                container.Append(move(element));
+            }
+        }
+
+        void ReadAsset(Asset& asset)
+        {
+            bool hasVersion = false;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "version") { asset.version = m_reader.ReadString(); hasVersion = true; }
+                else if (key == "minVersion") asset.minVersion = m_reader.ReadString();
+                else if (key == "generator") asset.generator = m_reader.ReadString();
+                else if (key == "copyright") asset.copyright = m_reader.ReadString();
+                else if (!ReadPropertyMember(key, asset)) m_reader.SkipValue();
+            }
+
+            RequireMember(hasVersion, "version", "Asset", "");
+        }
+
+        void ReadAccessor(Accessor& accessor)
+        {
+            bool hasComponentType = false;
+            bool hasCount = false;
+            bool hasType = false;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "bufferView") accessor.bufferViewId = ReadId();
+                else if (key == "byteOffset") accessor.byteOffset = m_reader.ReadIndex();
+                else if (key == "componentType") { accessor.componentType = ToComponentType(m_reader.ReadIndex()); hasComponentType = true; }
+                else if (key == "normalized") accessor.normalized = m_reader.ReadBoolean();
+                else if (key == "count") { accessor.count = m_reader.ReadIndex(); hasCount = true; }
+                else if (key == "type") { accessor.type = ParseAccessorType(m_reader.ReadString()); hasType = true; }
+                else if (key == "max") accessor.max = ReadFloatArray();
+                else if (key == "min") accessor.min = ReadFloatArray();
+                else if (key == "sparse") ReadAccessorSparse(accessor);
+                else if (!ReadChildOfRootMember(key, accessor)) m_reader.SkipValue();
+            }
+
+            RequireMember(hasComponentType, "componentType", "Accessor", accessor.id);
+            RequireMember(hasCount, "count", "Accessor", accessor.id);
+            RequireMember(hasType, "type", "Accessor", accessor.id);
+
+            m_limitChecker.AddAccessor(accessor.count);
+        }
+
+        void ReadAccessorSparse(Accessor& accessor)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "count")
+                {
+                    accessor.sparse.count = m_reader.ReadIndex();
+                }
+                else if (key == "indices")
+                {
+                    m_reader.BeginObject();
+
+                    while (m_reader.NextMember(&key))
+                    {
+                        if (key == "bufferView") accessor.sparse.indicesBufferViewId = ReadId();
+                        else if (key == "byteOffset") accessor.sparse.indicesByteOffset = m_reader.ReadIndex();
+                        else if (key == "componentType") accessor.sparse.indicesComponentType = ToComponentType(m_reader.ReadIndex());
+                        else m_reader.SkipValue();
+                    }
+                }
+                else if (key == "values")
+                {
+                    m_reader.BeginObject();
+
+                    while (m_reader.NextMember(&key))
+                    {
+                        if (key == "bufferView") accessor.sparse.valuesBufferViewId = ReadId();
+                        else if (key == "byteOffset") accessor.sparse.valuesByteOffset = m_reader.ReadIndex();
+                        else m_reader.SkipValue();
+                    }
+                }
+                else
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            if (accessor.sparse.count > 0 && (accessor.sparse.indicesBufferViewId.empty() || accessor.sparse.valuesBufferViewId.empty()))
+            {
+                throw InvalidGLTFException("Sparse accessor " + accessor.id + " has no indices or values");
+            }
+        }
+
+        void ReadAnimation(Animation& animation)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "channels") ReadCollection(animation.channels, &StreamingDocumentReader::ReadAnimationChannel);
+                else if (key == "samplers") ReadCollection(animation.samplers, &StreamingDocumentReader::ReadAnimationSampler);
+                else if (!ReadChildOfRootMember(key, animation)) m_reader.SkipValue();
+            }
+        }
+
+        void ReadAnimationChannel(AnimationChannel& channel)
+        {
+            bool hasSampler = false;
+            bool hasPath = false;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "sampler")
+                {
+                    channel.samplerId = ReadId();
+                    hasSampler = true;
+                }
+                else if (key == "target")
+                {
+                    m_reader.BeginObject();
+
+                    while (m_reader.NextMember(&key))
+                    {
+                        if (key == "node") channel.target.nodeId = ReadId();
+                        else if (key == "path") { channel.target.path = ParseTargetPath(m_reader.ReadString()); hasPath = true; }
+                        else if (!ReadPropertyMember(key, channel.target)) m_reader.SkipValue();
+                    }
+                }
+                else if (!ReadPropertyMember(key, channel))
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            RequireMember(hasSampler, "sampler", "Animation channel", channel.id);
+            RequireMember(hasPath, "target path", "Animation channel", channel.id);
+        }
+
+        void ReadAnimationSampler(AnimationSampler& sampler)
+        {
+            sampler.interpolation = INTERPOLATION_LINEAR;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "input") sampler.inputAccessorId = ReadId();
+                else if (key == "output") sampler.outputAccessorId = ReadId();
+                else if (key == "interpolation") sampler.interpolation = ParseInterpolationType(m_reader.ReadString());
+                else if (!ReadPropertyMember(key, sampler)) m_reader.SkipValue();
+            }
+
+            RequireMember(!sampler.inputAccessorId.empty(), "input", "Animation sampler", sampler.id);
+            RequireMember(!sampler.outputAccessorId.empty(), "output", "Animation sampler", sampler.id);
+        }
+
+        void ReadBuffer(Buffer& buffer)
+        {
+            bool hasByteLength = false;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "uri") buffer.uri = m_reader.ReadString();
+                else if (key == "byteLength") { buffer.byteLength = m_reader.ReadIndex(); hasByteLength = true; }
+                else if (!ReadChildOfRootMember(key, buffer)) m_reader.SkipValue();
+            }
+
+            RequireMember(hasByteLength, "byteLength", "Buffer", buffer.id);
+        }
+
+        void ReadBufferView(BufferView& bufferView)
+        {
+            bool hasByteLength = false;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "buffer") bufferView.bufferId = ReadId();
+                else if (key == "byteOffset") bufferView.byteOffset = m_reader.ReadIndex();
+                else if (key == "byteLength") { bufferView.byteLength = m_reader.ReadIndex(); hasByteLength = true; }
+                else if (key == "byteStride") bufferView.byteStride = m_reader.ReadIndex();
+                else if (key == "target") bufferView.target = ToBufferViewTarget(m_reader.ReadIndex());
+                else if (!ReadChildOfRootMember(key, bufferView)) m_reader.SkipValue();
+            }
+
+            RequireMember(!bufferView.bufferId.empty(), "buffer", "Buffer view", bufferView.id);
+            RequireMember(hasByteLength, "byteLength", "Buffer view", bufferView.id);
+        }
+
+        void ReadImage(Image& image)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "uri") image.uri = m_reader.ReadString();
+                else if (key == "mimeType") image.mimeType = m_reader.ReadString();
+                else if (key == "bufferView") image.bufferViewId = ReadId();
+                else if (!ReadChildOfRootMember(key, image)) m_reader.SkipValue();
+            }
+        }
+
+        // readMember reads the members particular to normal and occlusion textures.
+        template<typename TTextureInfo, typename TReadMember>
+        void ReadTextureInfo(TTextureInfo& textureInfo, TReadMember readMember)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "index") textureInfo.textureId = ReadId();
+                else if (key == "texCoord") textureInfo.texCoord = m_reader.ReadIndex();
+                else if (!readMember(key) && !ReadPropertyMember(key, textureInfo)) m_reader.SkipValue();
+            }
+
+            RequireMember(!textureInfo.textureId.empty(), "index", "Texture reference of material", m_currentMaterialId);
+        }
+
+        template<typename TTextureInfo>
+        void ReadTextureInfo(TTextureInfo& textureInfo)
+        {
+            ReadTextureInfo(textureInfo, [](string_view) { return false; });
+        }
+
+        void ReadMaterial(Material& material)
+        {
+            m_currentMaterialId = material.id;
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "pbrMetallicRoughness")
+                {
+                    auto& pbr = material.metallicRoughness;
+
+                    m_reader.BeginObject();
+
+                    while (m_reader.NextMember(&key))
+                    {
+                        if (key == "baseColorFactor")
+                        {
+                            float color[4];
+                            ReadFloats(color, 4);
+                            pbr.baseColorFactor = Color4(color[0], color[1], color[2], color[3]);
+                        }
+                        else if (key == "baseColorTexture") ReadTextureInfo(pbr.baseColorTexture);
+                        else if (key == "metallicFactor") pbr.metallicFactor = m_reader.ReadFloat();
+                        else if (key == "roughnessFactor") pbr.roughnessFactor = m_reader.ReadFloat();
+                        else if (key == "metallicRoughnessTexture") ReadTextureInfo(pbr.metallicRoughnessTexture);
+                        else if (!ReadPropertyMember(key, pbr)) m_reader.SkipValue();
+                    }
+                }
+                else if (key == "normalTexture")
+                {
+                    ReadTextureInfo(material.normalTexture, [&](string_view member)
+                    {
+                        if (member != "scale")
+                        {
+                            return false;
+                        }
+
+                        material.normalTexture.scale = m_reader.ReadFloat();
+                        return true;
+                    });
+                }
+                else if (key == "occlusionTexture")
+                {
+                    ReadTextureInfo(material.occlusionTexture, [&](string_view member)
+                    {
+                        if (member != "strength")
+                        {
+                            return false;
+                        }
+
+                        material.occlusionTexture.strength = m_reader.ReadFloat();
+                        return true;
+                    });
+                }
+                else if (key == "emissiveTexture")
+                {
+                    ReadTextureInfo(material.emissiveTexture);
+                }
+                else if (key == "emissiveFactor")
+                {
+                    float color[3];
+                    ReadFloats(color, 3);
+                    material.emissiveFactor = Color3(color[0], color[1], color[2]);
+                }
+                else if (key == "alphaMode") material.alphaMode = ParseAlphaMode(m_reader.ReadString());
+                else if (key == "alphaCutoff") material.alphaCutoff = m_reader.ReadFloat();
+                else if (key == "doubleSided") material.doubleSided = m_reader.ReadBoolean();
+                else if (!ReadChildOfRootMember(key, material)) m_reader.SkipValue();
+            }
+        }
+
+        void ReadMesh(Mesh& mesh)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "primitives")
+                {
+                    m_reader.BeginArray();
+
+                    while (m_reader.NextElement())
+                    {
+                        mesh.primitives.emplace_back();
+                        ReadMeshPrimitive(mesh.primitives.back());
+                    }
+                }
+                else if (key == "weights")
+                {
+                    mesh.weights = ReadFloatArray();
+                }
+                else if (!ReadChildOfRootMember(key, mesh))
+                {
+                    m_reader.SkipValue();
+                }
+            }
+
+            if (mesh.primitives.empty())
+            {
+                throw InvalidGLTFException("Mesh " + mesh.id + " has no primitives");
+            }
+        }
+
+        void ReadMeshPrimitive(MeshPrimitive& meshPrimitive)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "attributes")
+                {
+                    m_reader.BeginObject();
+
+                    while (m_reader.NextMember(&key))
+                    {
+                        string semantic(key);
+
+                        meshPrimitive.attributes.emplace(move(semantic), ReadVertexAccessorId());
+                    }
+                }
+                else if (key == "indices") meshPrimitive.indicesAccessorId = ReadId();
+                else if (key == "material") meshPrimitive.materialId = ReadId();
+                else if (key == "mode") meshPrimitive.mode = ToMeshMode(m_reader.ReadIndex());
+                else if (key == "targets")
+                {
+                    m_reader.BeginArray();
+
+                    while (m_reader.NextElement())
+                    {
+                        MorphTarget target;
+
+                        m_reader.BeginObject();
+
+                        while (m_reader.NextMember(&key))
+                        {
+                            if (key == ACCESSOR_POSITION) target.positionsAccessorId = ReadVertexAccessorId();
+                            else if (key == ACCESSOR_NORMAL) target.normalsAccessorId = ReadVertexAccessorId();
+                            else if (key == ACCESSOR_TANGENT) target.tangentsAccessorId = ReadVertexAccessorId();
+                            else m_reader.SkipValue();
+                        }
+
+                        meshPrimitive.targets.push_back(move(target));
+                    }
+                }
+                else if (!ReadPropertyMember(key, meshPrimitive))
+                {
+                    m_reader.SkipValue();
+                }
+            }
+        }
+
+        void ReadNode(Node& node)
+        {
+            m_limitChecker.AddNode();
+
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "children")
+                {
+                    m_reader.BeginArray();
+
+                    while (m_reader.NextElement())
+                    {
+                        const size_t childIndex = m_reader.ReadIndex();
+
+                        m_limitChecker.AddChild(childIndex);
+                        node.children.push_back(Id(childIndex));
+                    }
+                }
+                else if (key == "mesh") node.meshId = ReadId();
+                else if (key == "skin") node.skinId = ReadId();
+                else if (key == "weights") node.weights = ReadFloatArray();
+                else if (key == "matrix") ReadFloats(node.matrix.values.data(), node.matrix.values.size());
+                else if (key == "translation")
+                {
+                    float translation[3];
+                    ReadFloats(translation, 3);
+                    node.translation = Vector3(translation[0], translation[1], translation[2]);
+                }
+                else if (key == "rotation")
+                {
+                    float rotation[4];
+                    ReadFloats(rotation, 4);
+                    node.rotation = Quaternion(rotation[0], rotation[1], rotation[2], rotation[3]);
+                }
+                else if (key == "scale")
+                {
+                    float scale[3];
+                    ReadFloats(scale, 3);
+                    node.scale = Vector3(scale[0], scale[1], scale[2]);
+                }
+                else if (!ReadChildOfRootMember(key, node)) m_reader.SkipValue();
+            }
+        }
+
+        void ReadSampler(Sampler& sampler)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "magFilter") sampler.magFilter = ToMagFilterMode(m_reader.ReadIndex());
+                else if (key == "minFilter") sampler.minFilter = ToMinFilterMode(m_reader.ReadIndex());
+                else if (key == "wrapS") sampler.wrapS = ToWrapMode(m_reader.ReadIndex());
+                else if (key == "wrapT") sampler.wrapT = ToWrapMode(m_reader.ReadIndex());
+                else if (!ReadChildOfRootMember(key, sampler)) m_reader.SkipValue();
+            }
+        }
+
+        void ReadScene(Scene& scene)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "nodes") scene.nodes = ReadIdArray();
+                else if (!ReadChildOfRootMember(key, scene)) m_reader.SkipValue();
+            }
+        }
+
+        void ReadSkin(Skin& skin)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "inverseBindMatrices") skin.inverseBindMatricesAccessorId = ReadId();
+                else if (key == "skeleton") skin.skeletonId = ReadId();
+                else if (key == "joints") skin.jointIds = ReadIdArray();
+                else if (!ReadChildOfRootMember(key, skin)) m_reader.SkipValue();
+            }
+
+            RequireMember(!skin.jointIds.empty(), "joints", "Skin", skin.id);
+        }
+
+        void ReadTexture(Texture& texture)
+        {
+            m_reader.BeginObject();
+
+            string_view key;
+
+            while (m_reader.NextMember(&key))
+            {
+                if (key == "sampler") texture.samplerId = ReadId();
+                else if (key == "source") texture.imageId = ReadId();
+                else if (!ReadChildOfRootMember(key, texture)) m_reader.SkipValue();
+            }
+        }
+
+        JsonReader m_reader;
+        DocumentLimitChecker m_limitChecker;
+        vector<string> m_indexIds;
+        string m_currentMaterialId;
+    };
+
+    Document DeserializeStreaming(const char* json, size_t length, const LoadLimits& limits)
+    {
+        return StreamingDocumentReader(json, length, limits).Read();
+    }
+} // SceneLoader
@@ -0,0 +1,20 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "LoadLimits.h"
+
+namespace SceneLoader
+{
+    // Fills a glTF 2.0 document straight from the JSON text, instead of going through a
+    // rapidjson DOM like Microsoft::glTF::Deserialize does, so the JSON structure is never
+    // held in memory twice. Ids are the index strings Deserialize would assign. Extensions
+    // and extras are kept as their unparsed text. Cameras are skipped, the loader has no
+    // use for them. Throws InvalidGLTFException for malformed JSON or glTF.
+    //
+    // The node count, hierarchy depth and vertex counts of the limits are checked as the
+    // nodes and accessors are read, see DocumentLimitChecker, and throw LoadLimitException.
+    Microsoft::glTF::Document DeserializeStreaming(const char* json, size_t length, const LoadLimits& limits = LoadLimits());
+} // SceneLoader
@@ -0,0 +1,256 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "TexelAnalysis.h"
+#include "SimdMath.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    // Texels between checks for whether there is anything left to find out.
+    static constexpr size_t c_analysisBlockTexels = 1024;
+
+    // Blue of the unit normal with the given red and green, as stored in a glTF normal map.
+    static Vec4 NormalZFromRedGreen(Vec4 red, Vec4 green)
+    {
+        const Vec4 scale = Vec4::Splat(2.0f / 255.0f);
+        const Vec4 one = Vec4::Splat(1.0f);
+
+        Vec4 x = red * scale - one;
+        Vec4 y = green * scale - one;
+        Vec4 z = Sqrt(Max(Vec4::Zero(), one - x * x - y * y));
+
+        return z * Vec4::Splat(127.5f) + Vec4::Splat(127.5f);
+    }
+
+    static float NormalZFromRedGreen(float red, float green)
+    {
+        float x = red * (2.0f / 255.0f) - 1.0f;
+        float y = green * (2.0f / 255.0f) - 1.0f;
+
+        return sqrtf(max(0.0f, 1.0f - x * x - y * y)) * 127.5f + 127.5f;
+    }
+
+    static void AnalyzeTexelsScalar(const uint8_t* pTexels, size_t begin, size_t end, TexelContent* pContent)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint8_t* pTexel = pTexels + i * 4;
+
+            pContent->isOpaque &= pTexel[3] == 255;
+            pContent->isGrayscale &= pTexel[0] == pTexel[1] && pTexel[1] == pTexel[2];
+            pContent->isUnitNormal &= fabsf(NormalZFromRedGreen(pTexel[2], pTexel[1]) - pTexel[0]) <= c_normalZTolerance;
+        }
+    }
+
+    TexelContent AnalyzeTexels(const uint8_t* pTexels, size_t texelCount)
+    {
+        TexelContent content = { true, true, true };
+        size_t i = 0;
+
+#if defined(SCENELOADER_SIMD_SSE) || defined(SCENELOADER_SIMD_NEON)
+        while (i + 4 <= texelCount && (content.isOpaque || content.isGrayscale || content.isUnitNormal))
+        {
+            const size_t blockEnd = min(texelCount & ~size_t(3), i + c_analysisBlockTexels);
+
+#if defined(SCENELOADER_SIMD_SSE)
+            const __m128i byteMask = _mm_set1_epi32(0xFF);
+            __m128i allBits = _mm_set1_epi32(-1);
+            __m128i grayBits = _mm_set1_epi32(-1);
+#else
+            const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+            uint32x4_t allBits = vdupq_n_u32(0xFFFFFFFF);
+            uint32x4_t grayBits = vdupq_n_u32(0xFFFFFFFF);
+#endif
+            Vec4 normalError = Vec4::Zero();
+
+            for (; i < blockEnd; i += 4)
+            {
+#if defined(SCENELOADER_SIMD_SSE)
+                __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pTexels + i * 4));
+
+                allBits = _mm_and_si128(allBits, texels);
+
+                // Byte 0 compares blue with green, byte 1 green with red.
+                grayBits = _mm_and_si128(grayBits, _mm_cmpeq_epi8(texels, _mm_srli_epi32(texels, 8)));
+
+                Vec4 blue = { _mm_cvtepi32_ps(_mm_and_si128(texels, byteMask)) };
+                Vec4 green = { _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 8), byteMask)) };
+                Vec4 red = { _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 16), byteMask)) };
+#else
+                uint32x4_t texels = vreinterpretq_u32_u8(vld1q_u8(pTexels + i * 4));
+
+                allBits = vandq_u32(allBits, texels);
+                grayBits = vandq_u32(grayBits, vreinterpretq_u32_u8(vceqq_u8(vreinterpretq_u8_u32(texels), vreinterpretq_u8_u32(vshrq_n_u32(texels, 8)))));
+
+                Vec4 blue = { vcvtq_f32_u32(vandq_u32(texels, byteMask)) };
+                Vec4 green = { vcvtq_f32_u32(vandq_u32(vshrq_n_u32(texels, 8), byteMask)) };
+                Vec4 red = { vcvtq_f32_u32(vandq_u32(vshrq_n_u32(texels, 16), byteMask)) };
+#endif
+                normalError = Max(normalError, Abs(NormalZFromRedGreen(red, green) - blue));
+            }
+
+            uint32_t allLanes[4];
+            uint32_t grayLanes[4];
+            float errorLanes[4];
+
+#if defined(SCENELOADER_SIMD_SSE)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(allLanes), allBits);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(grayLanes), grayBits);
+#else
+            vst1q_u32(allLanes, allBits);
+            vst1q_u32(grayLanes, grayBits);
+#endif
+            normalError.Store(errorLanes);
+
+            for (size_t lane = 0; lane < 4; ++lane)
+            {
+                content.isOpaque &= (allLanes[lane] >> 24) == 0xFF;
+                content.isGrayscale &= (grayLanes[lane] & 0xFFFF) == 0xFFFF;
+                content.isUnitNormal &= errorLanes[lane] <= c_normalZTolerance;
+            }
+        }
+#endif
+
+        AnalyzeTexelsScalar(pTexels, i, texelCount, &content);
+
+        return content;
+    }
+
+    TexelLayout ChooseTexelLayout(const TexelContent& content, const TexelUsage& usage)
+    {
+        if ((usage.channels & TexelChannel_Alpha) && !content.isOpaque)
+        {
+            return TexelLayout::Bgra8;
+        }
+
+        if (content.isGrayscale || !(usage.channels & (TexelChannel_Green | TexelChannel_Blue)))
+        {
+            return TexelLayout::Red8;
+        }
+
+        if (usage.isNormalMap && content.isUnitNormal)
+        {
+            return TexelLayout::RedGreenNormal8;
+        }
+
+        return TexelLayout::Bgr8;
+    }
+
+    size_t GetTexelLayoutBytes(TexelLayout layout)
+    {
+        switch (layout)
+        {
+        case TexelLayout::Bgr8: return 3;
+        case TexelLayout::Red8: return 1;
+        case TexelLayout::RedGreenNormal8: return 2;
+        case TexelLayout::Bgra8:
+        default: return 4;
+        }
+    }
+
+    void PackTexels(TexelLayout layout, const uint8_t* pBgra, size_t texelCount, uint8_t* pDest)
+    {
+        switch (layout)
+        {
+        case TexelLayout::Bgr8:
+            for (size_t i = 0; i < texelCount; ++i)
+            {
+                pDest[i * 3 + 0] = pBgra[i * 4 + 0];
+                pDest[i * 3 + 1] = pBgra[i * 4 + 1];
+                pDest[i * 3 + 2] = pBgra[i * 4 + 2];
+            }
+            break;
+
+        case TexelLayout::Red8:
+            for (size_t i = 0; i < texelCount; ++i)
+            {
+                pDest[i] = pBgra[i * 4 + 2];
+            }
+            break;
+
+        case TexelLayout::RedGreenNormal8:
+            for (size_t i = 0; i < texelCount; ++i)
+            {
+                pDest[i * 2 + 0] = pBgra[i * 4 + 2];
+                pDest[i * 2 + 1] = pBgra[i * 4 + 1];
+            }
+            break;
+
+        case TexelLayout::Bgra8:
+        default:
+            memcpy(pDest, pBgra, texelCount * 4);
+            break;
+        }
+    }
+
+    void UnpackTexels(TexelLayout layout, const uint8_t* pSource, size_t texelCount, uint8_t* pBgra)
+    {
+        uint32_t* pTexels = reinterpret_cast<uint32_t*>(pBgra);
+
+        switch (layout)
+        {
+        case TexelLayout::Bgr8:
+            for (size_t i = 0; i < texelCount; ++i)
+            {
+                pTexels[i] = pSource[i * 3] | (pSource[i * 3 + 1] << 8) | (pSource[i * 3 + 2] << 16) | 0xFF000000u;
+            }
+            break;
+
+        case TexelLayout::Red8:
+            for (size_t i = 0; i < texelCount; ++i)
+            {
+                pTexels[i] = pSource[i] * 0x010101u | 0xFF000000u;
+            }
+            break;
+
+        case TexelLayout::RedGreenNormal8:
+        {
+            size_t i = 0;
+
+            for (; i + 4 <= texelCount; i += 4)
+            {
+                const uint8_t* pPair = pSource + i * 2;
+
+                float blue[4];
+                NormalZFromRedGreen(
+                    Vec4::Set(pPair[0], pPair[2], pPair[4], pPair[6]),
+                    Vec4::Set(pPair[1], pPair[3], pPair[5], pPair[7])).Store(blue);
+
+                for (size_t lane = 0; lane < 4; ++lane)
+                {
+                    pTexels[i + lane] = static_cast<uint32_t>(blue[lane] + 0.5f) | (pPair[lane * 2 + 1] << 8) | (pPair[lane * 2] << 16) | 0xFF000000u;
+                }
+            }
+
+            for (; i < texelCount; ++i)
+            {
+                const uint8_t* pPair = pSource + i * 2;
+                const float blue = NormalZFromRedGreen(pPair[0], pPair[1]);
+
+                pTexels[i] = static_cast<uint32_t>(blue + 0.5f) | (pPair[1] << 8) | (pPair[0] << 16) | 0xFF000000u;
+            }
+            break;
+        }
+
+        case TexelLayout::Bgra8:
+        default:
+            memcpy(pBgra, pSource, texelCount * 4);
+            break;
+        }
+    }
+
+    void MakeTexelsOpaque(uint8_t* pTexels, size_t texelCount)
+    {
+        uint32_t* pTexel = reinterpret_cast<uint32_t*>(pTexels);
+
+        for (size_t i = 0; i < texelCount; ++i)
+        {
+            pTexel[i] |= 0xFF000000u;
+        }
+    }
+} // SceneLoader
@@ -0,0 +1,77 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    enum TexelChannel : uint32_t
+    {
+        TexelChannel_Red = 1,
+        TexelChannel_Green = 2,
+        TexelChannel_Blue = 4,
+        TexelChannel_Alpha = 8,
+        TexelChannel_All = 15,
+    };
+
+    // What the materials of a document sample from an image.
+    struct TexelUsage
+    {
+        // TexelChannel flags.
+        uint32_t channels = TexelChannel_All;
+
+        // Every texture that uses the image is a normal map.
+        bool isNormalMap = false;
+    };
+
+    // What the texels of a BGRA8 image hold. Found by AnalyzeTexels.
+    struct TexelContent
+    {
+        // Every alpha is 255.
+        bool isOpaque;
+
+        // Red, green and blue are the same in every texel.
+        bool isGrayscale;
+
+        // Blue is the z of the unit normal whose x and y are red and green, to within
+        // c_normalZTolerance, so that it can be computed instead of stored.
+        bool isUnitNormal;
+    };
+
+    // In 8-bit steps.
+    constexpr float c_normalZTolerance = 2.0f;
+
+    // Looks at every texel once, 4 at a time. Straight or premultiplied alpha alike.
+    TexelContent AnalyzeTexels(const uint8_t* pTexels, size_t texelCount);
+
+    // How the scene cache stores the texels of a mip level.
+    enum class TexelLayout : uint32_t
+    {
+        Bgra8 = 0,
+
+        // Alpha is 255 or not sampled.
+        Bgr8 = 1,
+
+        // Red only. Green and blue are the same or not sampled, alpha is 255 or not sampled.
+        Red8 = 2,
+
+        // Red and green of a normal map; blue is computed from them.
+        RedGreenNormal8 = 3,
+    };
+
+    constexpr uint32_t c_texelLayoutCount = 4;
+
+    // The narrowest layout that keeps what the image is sampled for.
+    TexelLayout ChooseTexelLayout(const TexelContent& content, const TexelUsage& usage);
+
+    size_t GetTexelLayoutBytes(TexelLayout layout);
+
+    // Converts tightly packed BGRA8 texels to the layout and back. Unpacked alpha is 255
+    // for every layout but Bgra8.
+    void PackTexels(TexelLayout layout, const uint8_t* pBgra, size_t texelCount, uint8_t* pDest);
+    void UnpackTexels(TexelLayout layout, const uint8_t* pSource, size_t texelCount, uint8_t* pBgra);
+
+    // Sets every alpha to 255, for images whose alpha isn't sampled.
+    void MakeTexelsOpaque(uint8_t* pTexels, size_t texelCount);
+} // SceneLoader
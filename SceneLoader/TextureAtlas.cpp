@@ -0,0 +1,260 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "TextureAtlas.h"
+#include "MipChain.h"
+
+using namespace std;
+
+namespace SceneLoader
+{
+    static uint32_t AlignToTile(uint32_t value)
+    {
+        return (value + c_atlasTileAlignment - 1) / c_atlasTileAlignment * c_atlasTileAlignment;
+    }
+
+    // Size of the slot a texture takes, gutter and alignment included.
+    static AtlasSize GetSlotSize(uint32_t width, uint32_t height)
+    {
+        return { AlignToTile(width + 2 * c_atlasGutter), AlignToTile(height + 2 * c_atlasGutter) };
+    }
+
+    static uint32_t WrapTexel(int64_t texel, uint32_t size, AtlasWrapMode wrapMode)
+    {
+        const int64_t n = size;
+
+        switch (wrapMode)
+        {
+        case AtlasWrapMode::Repeat:
+            return static_cast<uint32_t>(((texel % n) + n) % n);
+
+        case AtlasWrapMode::MirroredRepeat:
+        {
+            const int64_t period = ((texel % (2 * n)) + 2 * n) % (2 * n);
+            return static_cast<uint32_t>(period < n ? period : 2 * n - 1 - period);
+        }
+
+        case AtlasWrapMode::ClampToEdge:
+        default:
+            return static_cast<uint32_t>(min(max(texel, int64_t(0)), n - 1));
+        }
+    }
+
+    static uint64_t GetMipChainTexels(uint32_t width, uint32_t height)
+    {
+        uint64_t texels = 0;
+
+        for (;;)
+        {
+            texels += static_cast<uint64_t>(width) * height;
+
+            if (width == 1 && height == 1)
+            {
+                return texels;
+            }
+
+            width = NextMipDimension(width);
+            height = NextMipDimension(height);
+        }
+    }
+
+    bool FitsAtlasPage(uint32_t width, uint32_t height)
+    {
+        if (width == 0 || height == 0 || width > c_maxAtlasPageSize || height > c_maxAtlasPageSize)
+        {
+            return false;
+        }
+
+        AtlasSize slot = GetSlotSize(width, height);
+
+        return slot.width <= c_maxAtlasPageSize && slot.height <= c_maxAtlasPageSize;
+    }
+
+    AtlasLayout PackAtlas(const vector<AtlasSize>& sizes)
+    {
+        struct Shelf
+        {
+            uint32_t page;
+            uint32_t y;
+            uint32_t height;
+            uint32_t usedWidth;
+        };
+
+        vector<size_t> order(sizes.size());
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+
+        // Tallest first, so that each shelf is as tall as the first texture put on it.
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+        {
+            AtlasSize slotA = GetSlotSize(sizes[a].width, sizes[a].height);
+            AtlasSize slotB = GetSlotSize(sizes[b].width, sizes[b].height);
+
+            return slotA.height != slotB.height ? slotA.height > slotB.height : slotA.width > slotB.width;
+        });
+
+        AtlasLayout layout;
+        layout.tiles.resize(sizes.size());
+
+        vector<Shelf> shelves;
+        vector<uint32_t> pageUsedHeights;
+
+        for (size_t index : order)
+        {
+            AtlasSize slot = GetSlotSize(sizes[index].width, sizes[index].height);
+
+            // First shelf with room, then a new shelf on the first page with room, then a new page.
+            Shelf* pShelf = nullptr;
+
+            for (auto& shelf : shelves)
+            {
+                if (slot.height <= shelf.height && shelf.usedWidth + slot.width <= c_maxAtlasPageSize)
+                {
+                    pShelf = &shelf;
+                    break;
+                }
+            }
+
+            if (!pShelf)
+            {
+                uint32_t page = 0;
+
+                while (page < pageUsedHeights.size() && pageUsedHeights[page] + slot.height > c_maxAtlasPageSize)
+                {
+                    ++page;
+                }
+
+                if (page == pageUsedHeights.size())
+                {
+                    pageUsedHeights.push_back(0);
+                    layout.pages.push_back({ 0, 0 });
+                }
+
+                shelves.push_back({ page, pageUsedHeights[page], slot.height, 0 });
+                pageUsedHeights[page] += slot.height;
+                pShelf = &shelves.back();
+            }
+
+            AtlasTile& tile = layout.tiles[index];
+            tile.page = pShelf->page;
+            tile.x = pShelf->usedWidth + c_atlasGutter;
+            tile.y = pShelf->y + c_atlasGutter;
+            tile.width = sizes[index].width;
+            tile.height = sizes[index].height;
+
+            pShelf->usedWidth += slot.width;
+
+            AtlasSize& page = layout.pages[pShelf->page];
+            page.width = max(page.width, pShelf->usedWidth);
+            page.height = pageUsedHeights[pShelf->page];
+        }
+
+        return layout;
+    }
+
+    void CopyTileWithGutter(uint8_t* pPage, size_t pagePitch, const AtlasTile& tile, const uint8_t* pTexels, AtlasWrapMode wrapU, AtlasWrapMode wrapV)
+    {
+        const AtlasSize slot = GetSlotSize(tile.width, tile.height);
+        const uint32_t slotX = tile.x - c_atlasGutter;
+        const uint32_t slotY = tile.y - c_atlasGutter;
+
+        vector<uint32_t> sourceColumns(slot.width);
+
+        for (uint32_t x = 0; x < slot.width; ++x)
+        {
+            sourceColumns[x] = WrapTexel(static_cast<int64_t>(x) - c_atlasGutter, tile.width, wrapU);
+        }
+
+        for (uint32_t y = 0; y < slot.height; ++y)
+        {
+            const uint32_t sourceRow = WrapTexel(static_cast<int64_t>(y) - c_atlasGutter, tile.height, wrapV);
+            const uint32_t* pSource = reinterpret_cast<const uint32_t*>(pTexels + static_cast<size_t>(sourceRow) * tile.width * 4);
+            uint32_t* pDest = reinterpret_cast<uint32_t*>(pPage + (slotY + y) * pagePitch) + slotX;
+
+            // The tile itself is a straight copy.
+            memcpy(pDest + c_atlasGutter, pSource, static_cast<size_t>(tile.width) * 4);
+
+            for (uint32_t x = 0; x < c_atlasGutter; ++x)
+            {
+                pDest[x] = pSource[sourceColumns[x]];
+            }
+
+            for (uint32_t x = c_atlasGutter + tile.width; x < slot.width; ++x)
+            {
+                pDest[x] = pSource[sourceColumns[x]];
+            }
+        }
+    }
+
+    bool TexCoordsFitTile(const float* pTexCoords, size_t count, const AtlasSize& textureSize, AtlasWrapMode wrapU, AtlasWrapMode wrapV)
+    {
+        // Half the gutter, so that the filter footprint stays inside it.
+        const float slackU = (wrapU == AtlasWrapMode::ClampToEdge) ? FLT_MAX : 0.5f * c_atlasGutter / textureSize.width;
+        const float slackV = (wrapV == AtlasWrapMode::ClampToEdge) ? FLT_MAX : 0.5f * c_atlasGutter / textureSize.height;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float u = pTexCoords[i * 2];
+            const float v = pTexCoords[i * 2 + 1];
+
+            // Also rejects NaN.
+            if (!(u >= -slackU && u <= 1.0f + slackU && v >= -slackV && v <= 1.0f + slackV))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void RemapTexCoordsToTile(float* pTexCoords, size_t count, const AtlasTile& tile, const AtlasSize& page, AtlasWrapMode wrapU, AtlasWrapMode wrapV)
+    {
+        const float scaleU = static_cast<float>(tile.width) / page.width;
+        const float scaleV = static_cast<float>(tile.height) / page.height;
+        const float offsetU = static_cast<float>(tile.x) / page.width;
+        const float offsetV = static_cast<float>(tile.y) / page.height;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float u = pTexCoords[i * 2];
+            float v = pTexCoords[i * 2 + 1];
+
+            if (wrapU == AtlasWrapMode::ClampToEdge)
+            {
+                u = min(max(u, 0.0f), 1.0f);
+            }
+
+            if (wrapV == AtlasWrapMode::ClampToEdge)
+            {
+                v = min(max(v, 0.0f), 1.0f);
+            }
+
+            pTexCoords[i * 2] = offsetU + u * scaleU;
+            pTexCoords[i * 2 + 1] = offsetV + v * scaleV;
+        }
+    }
+
+    uint64_t GetAtlasOverheadBytes(const AtlasLayout& layout)
+    {
+        uint64_t pageTexels = 0;
+        uint64_t tileTexels = 0;
+
+        for (const auto& page : layout.pages)
+        {
+            pageTexels += GetMipChainTexels(page.width, page.height);
+        }
+
+        for (const auto& tile : layout.tiles)
+        {
+            tileTexels += GetMipChainTexels(tile.width, tile.height);
+        }
+
+        return (pageTexels > tileTexels ? pageTexels - tileTexels : 0) * 4;
+    }
+} // SceneLoader
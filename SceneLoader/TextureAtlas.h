@@ -0,0 +1,90 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+namespace SceneLoader
+{
+    // How a texture is addressed outside [0, 1]. Decides what the gutter around its tile holds.
+    enum class AtlasWrapMode
+    {
+        ClampToEdge,
+        Repeat,
+        MirroredRepeat,
+    };
+
+    // Texels around every tile that repeat the edge of the texture the way its wrap modes
+    // would, so that bilinear filtering at the edge doesn't pick up the neighbor.
+    constexpr uint32_t c_atlasGutter = 4;
+
+    // Tiles, gutter included, start and end on multiples of this. Box-filtered mip levels of
+    // a page keep tiles apart down to level 3, where the gutter is still half a texel. Lower
+    // levels blend neighbors at the edges, where the textures are a few texels across anyway.
+    constexpr uint32_t c_atlasTileAlignment = 8;
+
+    // Largest page, in texels a side.
+    constexpr uint32_t c_maxAtlasPageSize = 2048;
+
+    struct AtlasSize
+    {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Where the texels of a texture went. x and y are the first texel, inside the gutter.
+    struct AtlasTile
+    {
+        uint32_t page;
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    struct AtlasLayout
+    {
+        std::vector<AtlasSize> pages;
+
+        // Indexed like the sizes that were packed.
+        std::vector<AtlasTile> tiles;
+    };
+
+    // Whether a texture of this size fits a page together with its gutter.
+    bool FitsAtlasPage(uint32_t width, uint32_t height);
+
+    // Packs textures onto shelves, tallest first, using as few pages as that takes. Pages are
+    // trimmed to what they use. Every size must pass FitsAtlasPage.
+    AtlasLayout PackAtlas(const std::vector<AtlasSize>& sizes);
+
+    // Copies tightly packed 4-byte texels into their tile and fills the gutter and alignment
+    // around it from the texture, wrapped the way it would be sampled.
+    void CopyTileWithGutter(
+        uint8_t* pPage,
+        size_t pagePitch,
+        const AtlasTile& tile,
+        const uint8_t* pTexels,
+        AtlasWrapMode wrapU,
+        AtlasWrapMode wrapV);
+
+    // Whether texture coordinates can be moved into a tile: on axes that wrap they must stay
+    // within [0, 1], give or take what the gutter covers. Clamped axes take anything.
+    bool TexCoordsFitTile(
+        const float* pTexCoords,
+        size_t count,
+        const AtlasSize& textureSize,
+        AtlasWrapMode wrapU,
+        AtlasWrapMode wrapV);
+
+    // Moves interleaved u, v pairs of a texture into its tile. Coordinates on clamped axes are clamped first.
+    void RemapTexCoordsToTile(
+        float* pTexCoords,
+        size_t count,
+        const AtlasTile& tile,
+        const AtlasSize& page,
+        AtlasWrapMode wrapU,
+        AtlasWrapMode wrapV);
+
+    // Bytes of the page mip chains that hold no texture: gutters, alignment and unused space.
+    uint64_t GetAtlasOverheadBytes(const AtlasLayout& layout);
+} // SceneLoader
@@ -0,0 +1,154 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include "UtilForIntermingledNamespaces.h"
+#include "DecodeArena.h"
+#include "TextureDecodeQueue.h"
+#include "ImageDecoder.h"
+#include "MipChain.h"
+#include "wincodec.h"
+
+using namespace std;
+
+namespace winrt {
+    using namespace Windows::Graphics::DirectX;
+    using namespace Windows::UI::Composition;
+}
+using namespace winrt;
+
+namespace SceneLoader
+{
+    TextureDecodeQueue&
+    TextureDecodeQueue::Instance()
+    {
+        static TextureDecodeQueue s_queue;
+        return s_queue;
+    }
+
+    void
+    TextureDecodeQueue::Enqueue(CompositionMipmapSurface mipmap, shared_ptr<const vector<uint8_t>> encodedImage, uint32_t priority)
+    {
+        Job job;
+        job.priority = priority;
+        job.encodedImage = move(encodedImage);
+        job.levelSurfaces = GetMipmapLevelSurfaces(mipmap);
+        job.size = mipmap.SizeInt32();
+        job.keepAlpha = mipmap.AlphaMode() != DirectXAlphaMode::Ignore;
+
+        lock_guard<mutex> lock(m_lock);
+
+        job.sequence = m_nextSequence++;
+        m_jobs.push_back(move(job));
+        push_heap(m_jobs.begin(), m_jobs.end());
+    }
+
+    void
+    TextureDecodeQueue::Start()
+    {
+        // Leave a core to the thread that drives the UI.
+        const size_t processorCount = concurrency::GetProcessorCount();
+        const size_t maxWorkerCount = processorCount > 1 ? processorCount - 1 : 1;
+
+        lock_guard<mutex> lock(m_lock);
+
+        while (m_workerCount < min(m_jobs.size(), maxWorkerCount))
+        {
+            ++m_workerCount;
+
+            // The module must stay loaded while a worker runs its code.
+            ++get_module_lock();
+
+            concurrency::create_task([this]()
+            {
+                RunJobs();
+
+                --get_module_lock();
+            });
+        }
+    }
+
+    size_t
+    TextureDecodeQueue::PendingCount() const
+    {
+        lock_guard<mutex> lock(m_lock);
+        return m_jobs.size();
+    }
+
+    void
+    TextureDecodeQueue::RunJobs()
+    {
+        // WIC is COM, and PPL threads don't come with an apartment.
+        const HRESULT hrInitialize = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        {
+            DecodeArena arena;
+            com_ptr<IWICImagingFactory> cpWIC;
+
+            for (;;)
+            {
+                Job job;
+
+                {
+                    lock_guard<mutex> lock(m_lock);
+
+                    if (m_jobs.empty())
+                    {
+                        --m_workerCount;
+                        break;
+                    }
+
+                    pop_heap(m_jobs.begin(), m_jobs.end());
+                    job = move(m_jobs.back());
+                    m_jobs.pop_back();
+                }
+
+                DecodeArena::Scope scratch(arena);
+
+                try
+                {
+                    if (!cpWIC)
+                    {
+                        cpWIC = CreateImagingFactory();
+                    }
+
+                    DecodeJob(cpWIC.get(), arena, job);
+                }
+                catch (...)
+                {
+                    // Nobody is left to report to; a texture that can't be decoded stays blank.
+                }
+            }
+        }
+
+        if (SUCCEEDED(hrInitialize))
+        {
+            CoUninitialize();
+        }
+    }
+
+    void
+    TextureDecodeQueue::DecodeJob(IWICImagingFactory* pWIC, DecodeArena& arena, const Job& job)
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        ArenaArray<uint8_t> pixels = DecodeImagePixels(pWIC, arena, job.encodedImage->data(), job.encodedImage->size(), job.keepAlpha, &width, &height, nullptr);
+
+        // The surface was sized from the header; a decoder that disagrees has the wrong idea of the image.
+        if (static_cast<int32_t>(width) != job.size.Width || static_cast<int32_t>(height) != job.size.Height)
+        {
+            throw_hresult(WINCODEC_ERR_BADIMAGE);
+        }
+
+        ForEachMipLevel(arena, pixels, width, height, static_cast<uint32_t>(job.levelSurfaces.size()),
+            [&](uint32_t level, uint32_t levelWidth, uint32_t levelHeight, const uint8_t* levelPixels)
+        {
+            lock_guard<mutex> lock(m_uploadLock);
+
+            UploadSurfacePixels(job.levelSurfaces[level].get(), levelWidth, levelHeight, levelPixels, levelWidth * 4);
+        });
+    }
+} // SceneLoader
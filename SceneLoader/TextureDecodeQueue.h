@@ -0,0 +1,70 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include "ImageDecoder.h"
+
+namespace SceneLoader
+{
+    // Decodes and uploads, on background threads, the textures of loads made with
+    // LoadOptions::deferTextureDecode. Their surfaces already exist at their final size;
+    // they stay blank until their pixels arrive. Textures with the highest priority go
+    // first. A single queue serves the process, so that textures keep arriving after the
+    // SceneLoader that loaded them is gone.
+    class TextureDecodeQueue
+    {
+    public:
+        static TextureDecodeQueue& Instance();
+
+        // Takes the encoded image; nothing is decoded until Start is called.
+        void Enqueue(
+            winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap,
+            std::shared_ptr<const std::vector<uint8_t>> encodedImage,
+            uint32_t priority);
+
+        // Puts more threads to work if there are more textures waiting than threads decoding them.
+        void Start();
+
+        // Textures not picked up by a thread yet.
+        size_t PendingCount() const;
+
+    private:
+        struct Job
+        {
+            uint32_t priority;
+
+            // Equal priorities go in the order they were queued.
+            uint64_t sequence;
+
+            std::shared_ptr<const std::vector<uint8_t>> encodedImage;
+
+            // Obtained on the thread that created the mipmap; see GetMipmapLevelSurfaces.
+            std::vector<winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>> levelSurfaces;
+            winrt::Windows::Graphics::SizeInt32 size;
+
+            // False for surfaces created without alpha.
+            bool keepAlpha;
+
+            bool operator<(const Job& other) const
+            {
+                return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+            }
+        };
+
+        TextureDecodeQueue() = default;
+
+        void RunJobs();
+        void DecodeJob(IWICImagingFactory* pWIC, DecodeArena& arena, const Job& job);
+
+        mutable std::mutex m_lock;
+        std::vector<Job> m_jobs; // max-heap
+        uint64_t m_nextSequence = 0;
+        size_t m_workerCount = 0;
+
+        // Composition graphics devices draw through a single-threaded Direct2D factory, so
+        // uploads take turns; decoding and filtering don't.
+        std::mutex m_uploadLock;
+    };
+} // SceneLoader
@@ -20,7 +20,13 @@ namespace SceneLoader
     winrt::Windows::Foundation::MemoryBuffer
         CopyArrayOfBytesToMemoryBuffer(BYTE* data, size_t byteLength)
     {
-        winrt::Windows::Foundation::MemoryBuffer mb{ winrt::Windows::Foundation::MemoryBuffer(static_cast<UINT32>(byteLength)) }; // FIXME: Check bounds sizeof(size_t) > sizeof(UINT32) on x64
+        // MemoryBuffer capacity is a UINT32; a single mesh attribute can't be larger than that.
+        if (byteLength > UINT32_MAX)
+        {
+            winrt::throw_hresult(E_BOUNDS);
+        }
+
+        winrt::Windows::Foundation::MemoryBuffer mb{ winrt::Windows::Foundation::MemoryBuffer(static_cast<UINT32>(byteLength)) };
         winrt::Windows::Foundation::IMemoryBufferReference mbr = mb.CreateReference();
         winrt::com_ptr<Windows::Foundation::IMemoryBufferByteAccess> const mba{ mbr.as<Windows::Foundation::IMemoryBufferByteAccess>() };
 
@@ -28,10 +34,7 @@ namespace SceneLoader
             BYTE* bytes = nullptr;
             UINT32 capacity;
             mba->GetBuffer(&bytes, &capacity);
-            for (UINT32 i = 0; i < capacity; ++i)
-            {
-                bytes[i] = data[i];
-            }
+            memcpy(bytes, data, capacity);
         }
 
         return mb;
@@ -62,4 +65,135 @@ namespace SceneLoader
         return wcstring.get();
     }
 
+    winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionGraphicsDevice>
+        CreateCompositionGraphicsDevice(winrt::Windows::UI::Composition::Compositor compositor)
+    {
+        // Initialize DX
+        winrt::com_ptr<ID3D11Device> cpDevice;
+        winrt::com_ptr<ID3D11DeviceContext> cpContext;
+        UINT creationFlags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+        D3D_FEATURE_LEVEL featureLevels[] =
+        {
+            D3D_FEATURE_LEVEL_11_1,
+            D3D_FEATURE_LEVEL_11_0,
+            D3D_FEATURE_LEVEL_10_1,
+            D3D_FEATURE_LEVEL_10_0,
+            D3D_FEATURE_LEVEL_9_3,
+            D3D_FEATURE_LEVEL_9_2,
+            D3D_FEATURE_LEVEL_9_1
+        };
+        D3D_FEATURE_LEVEL usedFeatureLevel;
+
+        winrt::check_hresult(D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE_HARDWARE,
+            nullptr,
+            creationFlags,
+            featureLevels,
+            ARRAYSIZE(featureLevels),
+            D3D11_SDK_VERSION,
+            cpDevice.put(),
+            &usedFeatureLevel,
+            cpContext.put()));
+
+        // The device is shared by loads on any thread, see DeviceResources.
+        cpContext.as<ID3D11Multithread>()->SetMultithreadProtected(TRUE);
+
+        winrt::com_ptr<ID2D1Factory1> cpD2DFactory;
+        winrt::com_ptr<ID2D1Device> cpD2D1Device;
+        winrt::com_ptr<ID3D11Device1> cpd3dDevice = cpDevice.as<ID3D11Device1>();
+        winrt::check_hresult(D2D1CreateFactory(D2D1_FACTORY_TYPE_MULTI_THREADED, __uuidof(ID2D1Factory1), cpD2DFactory.put_void()));
+        winrt::com_ptr<IDXGIDevice> cpDxgiDevice = cpd3dDevice.as<IDXGIDevice>();
+        winrt::check_hresult(cpD2DFactory->CreateDevice(cpDxgiDevice.get(), cpD2D1Device.put()));
+
+        winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionGraphicsDevice> cpGraphicsDevice;
+        winrt::com_ptr<ABI::Windows::UI::Composition::ICompositorInterop> cpCompositorInterop = compositor.as<ABI::Windows::UI::Composition::ICompositorInterop>();
+        winrt::check_hresult(cpCompositorInterop->CreateGraphicsDevice(cpD2D1Device.get(), cpGraphicsDevice.put()));
+
+        return cpGraphicsDevice;
+    }
+
+    void
+        UploadMipmapLevel(
+            winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap,
+            UINT level,
+            UINT width,
+            UINT height,
+            const BYTE* pixels,
+            UINT pitch)
+    {
+        winrt::Windows::UI::Composition::CompositionDrawingSurface drawingSurface = mipmap.GetDrawingSurfaceForLevel(level);
+        winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop> cpDrawingSurfaceInterop = drawingSurface.as<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>();
+
+        UploadSurfacePixels(cpDrawingSurfaceInterop.get(), width, height, pixels, pitch);
+    }
+
+    std::vector<winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>>
+        GetMipmapLevelSurfaces(winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap)
+    {
+        std::vector<winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>> levelSurfaces(mipmap.LevelCount());
+
+        for (UINT level = 0; level < mipmap.LevelCount(); ++level)
+        {
+            levelSurfaces[level] = mipmap.GetDrawingSurfaceForLevel(level).as<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>();
+        }
+
+        return levelSurfaces;
+    }
+
+    void
+        UploadSurfacePixels(
+            ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop* pDrawingSurfaceInterop,
+            UINT width,
+            UINT height,
+            const BYTE* pixels,
+            UINT pitch)
+    {
+        winrt::com_ptr<ID2D1DeviceContext> cpD2DContext;
+
+        POINT surfaceUpdateOffset;
+        winrt::check_hresult(pDrawingSurfaceInterop->BeginDraw(
+            nullptr,
+            IID_PPV_ARGS(cpD2DContext.put()),
+            &surfaceUpdateOffset));
+
+        winrt::com_ptr<ID2D1Bitmap> cpBitmap;
+        winrt::check_hresult(cpD2DContext->CreateBitmap(
+            D2D1::SizeU(width, height),
+            pixels,
+            pitch,
+            D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)),
+            cpBitmap.put()));
+
+        D2D1_RECT_F destRect;
+        destRect.left = (float)surfaceUpdateOffset.x;
+        destRect.top = (float)surfaceUpdateOffset.y;
+        destRect.right = (float)(destRect.left + width);
+        destRect.bottom = (float)(destRect.top + height);
+
+        // The surface may have been created at a different DPI; draw in pixels.
+        cpD2DContext->SetUnitMode(D2D1_UNIT_MODE_PIXELS);
+        cpD2DContext->SetPrimitiveBlend(D2D1_PRIMITIVE_BLEND_COPY);
+
+        cpD2DContext->DrawBitmap(
+            cpBitmap.get(),
+            &destRect,
+            1.0f,
+            D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+
+        winrt::check_hresult(cpD2DContext->Flush());
+        winrt::check_hresult(pDrawingSurfaceInterop->EndDraw());
+    }
+
+    void*
+        GetObjectIdentity(const winrt::Windows::Foundation::IInspectable& object)
+    {
+        if (!object)
+        {
+            return nullptr;
+        }
+
+        return winrt::get_abi(object.as<winrt::Windows::Foundation::IUnknown>());
+    }
+
 } // namespace SceneLoader
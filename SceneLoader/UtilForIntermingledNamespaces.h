@@ -10,4 +10,32 @@ namespace SceneLoader {
     std::pair<BYTE*, UINT32> GetDataPointerFromMemoryBuffer(winrt::Windows::Foundation::IMemoryBufferReference);
 
     winrt::hstring GetHSTRINGFromStdString(const std::string& s);
+
+    // The device can be drawn to from several threads at once.
+    winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionGraphicsDevice> CreateCompositionGraphicsDevice(winrt::Windows::UI::Composition::Compositor compositor);
+
+    // Copies tightly packed or pitched premultiplied BGRA pixels into one level of a mipmap surface.
+    void UploadMipmapLevel(
+        winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap,
+        UINT level,
+        UINT width,
+        UINT height,
+        const BYTE* pixels,
+        UINT pitch);
+
+    // Drawing surface of every level of a mipmap. Unlike the mipmap itself these can be
+    // drawn to from any thread, see TextureDecodeQueue.
+    std::vector<winrt::com_ptr<ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop>> GetMipmapLevelSurfaces(
+        winrt::Windows::UI::Composition::CompositionMipmapSurface mipmap);
+
+    // UploadMipmapLevel for a level obtained from GetMipmapLevelSurfaces.
+    void UploadSurfacePixels(
+        ABI::Windows::UI::Composition::ICompositionDrawingSurfaceInterop* pDrawingSurfaceInterop,
+        UINT width,
+        UINT height,
+        const BYTE* pixels,
+        UINT pitch);
+
+    // COM identity of a WinRT object, usable as a map key regardless of the interface it was obtained through.
+    void* GetObjectIdentity(const winrt::Windows::Foundation::IInspectable& object);
 }
\ No newline at end of file
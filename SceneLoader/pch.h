@@ -12,18 +12,46 @@
 #define _SILENCE_CXX17_ITERATOR_BASE_CLASS_DEPRECATION_WARNING
 
 // std
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <istream>
 #include <streambuf>
+#include <functional>
 #include <map>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <type_traits>
 #include <utility>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <algorithm>
 #include <iomanip>
+#include <limits>
+#include <random>
+#include <cerrno>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#ifdef _WIN32
+
+// PPL
+#include <ppl.h>
+#include <ppltasks.h>
 
 // GLTF SDK
 #include <GLTFSDK/GLTF.h>
@@ -62,4 +90,12 @@
 
 
 // FIXME: WinRT ABI headers should be moved to UtilForIntermingledNamespaces.h/cpp
-#include <Windows.ui.composition.interop.h>
\ No newline at end of file
+#include <Windows.ui.composition.interop.h>
+
+#else
+
+// Elsewhere only the modules that need neither Windows nor Composition are built, for the
+// tests and benchmarks in Tests. That project supplies what they use of PPL and the GLTF SDK.
+#include "PortablePch.h"
+
+#endif
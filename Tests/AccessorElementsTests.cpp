@@ -0,0 +1,132 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "AccessorElements.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static constexpr uint32_t c_byte = 5120;
+static constexpr uint32_t c_unsignedByte = 5121;
+static constexpr uint32_t c_short = 5122;
+static constexpr uint32_t c_unsignedShort = 5123;
+static constexpr uint32_t c_unsignedInt = 5125;
+static constexpr uint32_t c_float = 5126;
+
+template<typename T>
+static vector<uint8_t> ToBytes(const vector<T>& values)
+{
+    vector<uint8_t> bytes(values.size() * sizeof(T));
+    memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+}
+
+static vector<float> Convert(const vector<uint8_t>& bytes, size_t count, size_t stride, size_t componentCount, uint32_t componentType, bool normalized)
+{
+    vector<float> floats(count * componentCount);
+    ConvertElementsToFloats(bytes.data(), count, stride, componentCount, componentType, normalized, floats.data());
+    return floats;
+}
+
+TEST(AccessorElementsTest, ComponentSizes)
+{
+    EXPECT_EQ(GetAccessorComponentSize(c_byte), 1u);
+    EXPECT_EQ(GetAccessorComponentSize(c_unsignedByte), 1u);
+    EXPECT_EQ(GetAccessorComponentSize(c_short), 2u);
+    EXPECT_EQ(GetAccessorComponentSize(c_unsignedShort), 2u);
+    EXPECT_EQ(GetAccessorComponentSize(c_unsignedInt), 4u);
+    EXPECT_EQ(GetAccessorComponentSize(c_float), 4u);
+    EXPECT_EQ(GetAccessorComponentSize(5124), 0u);
+    EXPECT_EQ(GetAccessorComponentSize(0), 0u);
+}
+
+TEST(AccessorElementsTest, RangeChecksDoNotOverflow)
+{
+    EXPECT_TRUE(IsElementRangeInBounds(12, 0, 1, 12, 12));
+    EXPECT_TRUE(IsElementRangeInBounds(40, 4, 3, 12, 12));
+    EXPECT_FALSE(IsElementRangeInBounds(40, 5, 3, 12, 12));
+
+    // The last element only needs its own bytes, not a whole stride.
+    EXPECT_TRUE(IsElementRangeInBounds(28, 0, 2, 12, 16));
+    EXPECT_FALSE(IsElementRangeInBounds(27, 0, 2, 12, 16));
+
+    EXPECT_TRUE(IsElementRangeInBounds(8, 8, 0, 12, 12));
+    EXPECT_FALSE(IsElementRangeInBounds(8, 9, 0, 12, 12));
+
+    // Counts and offsets from a hostile file must not wrap around.
+    EXPECT_FALSE(IsElementRangeInBounds(1024, 0, SIZE_MAX, 12, 12));
+    EXPECT_FALSE(IsElementRangeInBounds(1024, SIZE_MAX, 1, 4, 4));
+    EXPECT_FALSE(IsElementRangeInBounds(1024, 0, 2, SIZE_MAX, SIZE_MAX));
+}
+
+TEST(AccessorElementsTest, NormalizesIntegers)
+{
+    vector<float> bytes = Convert(ToBytes(vector<int8_t>{ -128, -127, 0, 127 }), 4, 1, 1, c_byte, true);
+    EXPECT_EQ(bytes, (vector<float>{ -1.0f, -1.0f, 0.0f, 1.0f }));
+
+    vector<float> unsignedBytes = Convert(ToBytes(vector<uint8_t>{ 0, 51, 255 }), 3, 1, 1, c_unsignedByte, true);
+    EXPECT_EQ(unsignedBytes, (vector<float>{ 0.0f, 51 / 255.0f, 1.0f }));
+
+    vector<float> shorts = Convert(ToBytes(vector<int16_t>{ -32768, -32767, 16384, 32767 }), 4, 2, 1, c_short, true);
+    EXPECT_EQ(shorts, (vector<float>{ -1.0f, -1.0f, 16384 / 32767.0f, 1.0f }));
+
+    vector<float> unsignedShorts = Convert(ToBytes(vector<uint16_t>{ 0, 65535 }), 2, 2, 1, c_unsignedShort, true);
+    EXPECT_EQ(unsignedShorts, (vector<float>{ 0.0f, 1.0f }));
+}
+
+TEST(AccessorElementsTest, KeepsIntegersUnlessNormalized)
+{
+    EXPECT_EQ(Convert(ToBytes(vector<int8_t>{ -128, 5 }), 2, 1, 1, c_byte, false), (vector<float>{ -128.0f, 5.0f }));
+    EXPECT_EQ(Convert(ToBytes(vector<uint16_t>{ 65535 }), 1, 2, 1, c_unsignedShort, false), (vector<float>{ 65535.0f }));
+    EXPECT_EQ(Convert(ToBytes(vector<uint32_t>{ 7, 100000 }), 2, 4, 1, c_unsignedInt, true), (vector<float>{ 7.0f, 100000.0f }));
+}
+
+// Interleaved vertices: only the first componentCount components of every stride are read.
+TEST(AccessorElementsTest, ReadsStridedElements)
+{
+    vector<float> interleaved = { 1, 2, 3, 99, 4, 5, 6, 99, 7, 8, 9, 99 };
+
+    EXPECT_EQ(Convert(ToBytes(interleaved), 3, 16, 3, c_float, false), (vector<float>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+    EXPECT_EQ(Convert(ToBytes(interleaved), 3, 16, 4, c_float, false), interleaved);
+
+    vector<uint16_t> texCoords = { 0, 65535, 0xAAAA, 65535, 0, 0xBBBB };
+    EXPECT_EQ(Convert(ToBytes(texCoords), 2, 6, 2, c_unsignedShort, true), (vector<float>{ 0.0f, 1.0f, 1.0f, 0.0f }));
+}
+
+TEST(AccessorElementsTest, RejectsUnknownComponentTypes)
+{
+    vector<uint8_t> bytes(16);
+    float floats[4];
+
+    EXPECT_THROW(ConvertElementsToFloats(bytes.data(), 1, 4, 1, 5124, false, floats), Microsoft::glTF::InvalidGLTFException);
+    EXPECT_THROW(ConvertElementsToFloats(bytes.data(), 1, 4, 1, 0, false, floats), Microsoft::glTF::InvalidGLTFException);
+}
+
+TEST(AccessorElementsTest, ConvertsIndices)
+{
+    vector<uint32_t> indices(3);
+
+    ConvertIndices(ToBytes(vector<uint8_t>{ 0, 200, 255 }).data(), 3, c_unsignedByte, indices.data());
+    EXPECT_EQ(indices, (vector<uint32_t>{ 0, 200, 255 }));
+
+    ConvertIndices(ToBytes(vector<uint16_t>{ 1, 65535, 300 }).data(), 3, c_unsignedShort, indices.data());
+    EXPECT_EQ(indices, (vector<uint32_t>{ 1, 65535, 300 }));
+
+    ConvertIndices(ToBytes(vector<uint32_t>{ 70000, 0, 5 }).data(), 3, c_unsignedInt, indices.data());
+    EXPECT_EQ(indices, (vector<uint32_t>{ 70000, 0, 5 }));
+}
+
+TEST(AccessorElementsTest, RejectsSignedAndFloatIndices)
+{
+    vector<uint8_t> bytes(16);
+    uint32_t indices[4];
+
+    EXPECT_THROW(ConvertIndices(bytes.data(), 2, c_short, indices), Microsoft::glTF::InvalidGLTFException);
+    EXPECT_THROW(ConvertIndices(bytes.data(), 2, c_byte, indices), Microsoft::glTF::InvalidGLTFException);
+    EXPECT_THROW(ConvertIndices(bytes.data(), 2, c_float, indices), Microsoft::glTF::InvalidGLTFException);
+}
@@ -0,0 +1,205 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "AnimationCurve.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static AnimationCurve BuildCurve(const vector<float>& times, const vector<float>& values, size_t componentCount, CurveInterpolation interpolation, bool isRotation = false)
+{
+    return BuildAnimationCurve(times.data(), times.size(), values.data(), componentCount, interpolation, isRotation, 30.0f);
+}
+
+// Largest per-component difference between the curves, sampled far more densely than
+// either has keys.
+static float MeasureDenseError(const AnimationCurve& original, const AnimationCurve& simplified, size_t componentCount)
+{
+    const float start = original.times.front();
+    const float end = original.times.back();
+    const int sampleCount = 20000;
+
+    float error = 0.0f;
+
+    for (int i = 0; i <= sampleCount; ++i)
+    {
+        float time = start + (end - start) * i / sampleCount;
+
+        float a[4];
+        float b[4];
+        EvaluateAnimationCurve(original, time, a);
+        EvaluateAnimationCurve(simplified, time, b);
+
+        for (size_t component = 0; component < componentCount; ++component)
+        {
+            error = max(error, fabs(a[component] - b[component]));
+        }
+    }
+
+    return error;
+}
+
+class AnimationCurveToleranceTest : public testing::TestWithParam<float>
+{
+};
+
+// The tolerance bounds the error at the keys and, both curves being linear, between them.
+TEST_P(AnimationCurveToleranceTest, SimplifiedCurveStaysWithinTolerance)
+{
+    const float tolerance = GetParam();
+
+    vector<float> times;
+    vector<float> values;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        float time = i / 60.0f;
+
+        times.push_back(time);
+        values.push_back(sin(time));
+        values.push_back(cos(2.0f * time));
+        values.push_back(0.5f * time);
+    }
+
+    AnimationCurve original = BuildCurve(times, values, 3, CurveInterpolation::Linear);
+    AnimationCurve simplified = original;
+    SimplifyAnimationCurve(simplified, tolerance);
+
+    EXPECT_LT(simplified.KeyCount(), original.KeyCount());
+    EXPECT_EQ(simplified.times.front(), original.times.front());
+    EXPECT_EQ(simplified.times.back(), original.times.back());
+
+    EXPECT_LE(MeasureAnimationCurveError(original, simplified), tolerance);
+    EXPECT_LE(MeasureDenseError(original, simplified, 3), tolerance * 1.001f);
+}
+
+INSTANTIATE_TEST_SUITE_P(Tolerances, AnimationCurveToleranceTest, testing::Values(1e-4f, 1e-3f, 1e-2f));
+
+TEST(AnimationCurveTest, ConstantCurveKeepsFirstAndLastKeys)
+{
+    vector<float> times = { 0, 1, 2, 3, 4 };
+    vector<float> values = { 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3 };
+
+    AnimationCurve curve = BuildCurve(times, values, 3, CurveInterpolation::Linear);
+
+    EXPECT_TRUE(IsAnimationCurveConstant(curve, 1e-6f));
+
+    SimplifyAnimationCurve(curve, 1e-6f);
+
+    ASSERT_EQ(curve.KeyCount(), 2u);
+    EXPECT_EQ(curve.times[0], 0.0f);
+    EXPECT_EQ(curve.times[1], 4.0f);
+}
+
+TEST(AnimationCurveTest, VaryingCurveIsNotConstant)
+{
+    vector<float> times = { 0, 1, 2 };
+    vector<float> values = { 0, 0, 0, 0, 0.1f, 0, 0, 0, 0 };
+
+    EXPECT_FALSE(IsAnimationCurveConstant(BuildCurve(times, values, 3, CurveInterpolation::Linear), 0.01f));
+}
+
+// Quaternions that flip sign from key to key are moved onto one hemisphere and normalized,
+// so interpolating between neighbors never takes the long way around.
+TEST(AnimationCurveTest, RotationsAreNormalizedOnOneHemisphere)
+{
+    vector<float> times;
+    vector<float> values;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        float angle = i * 0.05f;
+        float sign = (i % 2) ? -1.0f : 1.0f;
+
+        times.push_back(i * 0.1f);
+        values.insert(values.end(), { 0.0f, sign * sin(angle) * 2.0f, 0.0f, sign * cos(angle) * 2.0f });
+    }
+
+    AnimationCurve original = BuildCurve(times, values, 4, CurveInterpolation::Linear, true);
+
+    for (size_t key = 1; key < original.KeyCount(); ++key)
+    {
+        const float* a = original.Value(key - 1);
+        const float* b = original.Value(key);
+
+        EXPECT_GE(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3], 0.0f) << "key " << key;
+        EXPECT_NEAR(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3], 1.0f, 1e-5f) << "key " << key;
+    }
+
+    AnimationCurve simplified = original;
+    SimplifyAnimationCurve(simplified, 1e-3f);
+
+    EXPECT_LT(simplified.KeyCount(), original.KeyCount());
+    EXPECT_LE(MeasureAnimationCurveError(original, simplified), 1e-3f);
+}
+
+// Step curves only lose keys that repeat the value before them.
+TEST(AnimationCurveTest, StepCurveKeepsEveryChange)
+{
+    vector<float> times = { 0, 1, 2, 3, 4, 5 };
+    vector<float> values = { 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 2, 0, 0 };
+
+    AnimationCurve original = BuildCurve(times, values, 3, CurveInterpolation::Step);
+    AnimationCurve simplified = original;
+    SimplifyAnimationCurve(simplified, 1e-6f);
+
+    EXPECT_EQ(simplified.KeyCount(), 3u);
+    EXPECT_EQ(MeasureAnimationCurveError(original, simplified), 0.0f);
+
+    float value[4];
+    EvaluateAnimationCurve(simplified, 1.99f, value);
+    EXPECT_EQ(value[0], 0.0f);
+
+    EvaluateAnimationCurve(simplified, 2.5f, value);
+    EXPECT_EQ(value[0], 1.0f);
+}
+
+TEST(AnimationCurveTest, EvaluationClampsOutsideTheTimeRange)
+{
+    vector<float> times = { 1, 2 };
+    vector<float> values = { 3, 0, 0, 5, 0, 0 };
+
+    AnimationCurve curve = BuildCurve(times, values, 3, CurveInterpolation::Linear);
+
+    float value[4];
+    EvaluateAnimationCurve(curve, 0.0f, value);
+    EXPECT_EQ(value[0], 3.0f);
+
+    EvaluateAnimationCurve(curve, 1.5f, value);
+    EXPECT_FLOAT_EQ(value[0], 4.0f);
+
+    EvaluateAnimationCurve(curve, 9.0f, value);
+    EXPECT_EQ(value[0], 5.0f);
+}
+
+// Resampled splines pass through their keys, and a spline whose tangents make it a straight
+// line simplifies down to its ends.
+TEST(AnimationCurveTest, CubicSplinesAreResampledThroughTheirKeys)
+{
+    vector<float> times = { 0, 1, 2 };
+    vector<float> values = {
+        1, 1, 1, 0, 0, 0, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 2, 2, 2, 1, 1, 1,
+    };
+
+    AnimationCurve curve = BuildCurve(times, values, 3, CurveInterpolation::CubicSpline);
+
+    EXPECT_EQ(curve.interpolation, CurveInterpolation::Linear);
+    EXPECT_GE(curve.KeyCount(), 3u);
+
+    float value[4];
+    EvaluateAnimationCurve(curve, 1.0f, value);
+    EXPECT_NEAR(value[0], 1.0f, 1e-6f);
+
+    EvaluateAnimationCurve(curve, 0.5f, value);
+    EXPECT_NEAR(value[0], 0.5f, 1e-5f);
+
+    SimplifyAnimationCurve(curve, 1e-5f);
+    EXPECT_EQ(curve.KeyCount(), 2u);
+}
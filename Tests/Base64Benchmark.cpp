@@ -0,0 +1,41 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <random>
+
+#include "Base64.h"
+#include "Benchmark.h"
+
+using namespace std;
+using namespace SceneLoader;
+using namespace SceneLoaderBenchmark;
+
+// Decode throughput over the encoded text of a buffer the size of a large embedded mesh.
+int main()
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    mt19937 random(1);
+    string text(64 << 20, 'A');
+
+    for (auto& c : text)
+    {
+        c = alphabet[random() & 63];
+    }
+
+    vector<uint8_t> decoded(GetBase64DecodedLengthBound(text.size()));
+    size_t decodedLength = 0;
+
+    double seconds = MeasureSeconds(5, [&]()
+    {
+        if (!DecodeBase64(text.data(), text.size(), decoded.data(), &decodedLength))
+        {
+            abort();
+        }
+    });
+
+    ReportRate("DecodeBase64, 64 MiB of text", static_cast<double>(text.size()), "B", seconds);
+}
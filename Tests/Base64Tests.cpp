@@ -0,0 +1,132 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "Base64.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// A plain RFC 4648 encoder to check the decoder against.
+static string EncodeBase64(const vector<uint8_t>& bytes, bool pad)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    string text;
+    size_t i = 0;
+
+    for (; i + 3 <= bytes.size(); i += 3)
+    {
+        uint32_t group = bytes[i] << 16 | bytes[i + 1] << 8 | bytes[i + 2];
+        text += alphabet[group >> 18];
+        text += alphabet[(group >> 12) & 63];
+        text += alphabet[(group >> 6) & 63];
+        text += alphabet[group & 63];
+    }
+
+    if (bytes.size() - i == 1)
+    {
+        uint32_t group = bytes[i] << 16;
+        text += alphabet[group >> 18];
+        text += alphabet[(group >> 12) & 63];
+        text += pad ? "==" : "";
+    }
+    else if (bytes.size() - i == 2)
+    {
+        uint32_t group = bytes[i] << 16 | bytes[i + 1] << 8;
+        text += alphabet[group >> 18];
+        text += alphabet[(group >> 12) & 63];
+        text += alphabet[(group >> 6) & 63];
+        text += pad ? "=" : "";
+    }
+
+    return text;
+}
+
+static bool Decode(const string& text, vector<uint8_t>* pBytes)
+{
+    pBytes->resize(GetBase64DecodedLengthBound(text.size()));
+
+    size_t decodedLength = 0;
+    bool succeeded = DecodeBase64(text.data(), text.size(), pBytes->data(), &decodedLength);
+    pBytes->resize(decodedLength);
+
+    return succeeded;
+}
+
+// Every length up to a few vector blocks, so that each split between the vector loops
+// and the scalar tail is covered.
+TEST(Base64Test, DecodesWhatTheReferenceEncodes)
+{
+    mt19937 random(1);
+
+    for (size_t length = 0; length < 600; ++length)
+    {
+        vector<uint8_t> bytes(length);
+
+        for (auto& byte : bytes)
+        {
+            byte = static_cast<uint8_t>(random());
+        }
+
+        for (bool pad : { false, true })
+        {
+            vector<uint8_t> decoded;
+
+            ASSERT_TRUE(Decode(EncodeBase64(bytes, pad), &decoded)) << "length " << length << ", pad " << pad;
+            ASSERT_EQ(decoded, bytes) << "length " << length << ", pad " << pad;
+        }
+    }
+}
+
+TEST(Base64Test, DecodesKnownText)
+{
+    vector<uint8_t> decoded;
+
+    ASSERT_TRUE(Decode("TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsu", &decoded));
+    EXPECT_EQ(string(decoded.begin(), decoded.end()), "Many hands make light work.");
+
+    ASSERT_TRUE(Decode("", &decoded));
+    EXPECT_TRUE(decoded.empty());
+}
+
+// One bad character anywhere, in the vector part or the tail, fails the whole decode.
+TEST(Base64Test, RejectsCharactersOutsideTheAlphabet)
+{
+    mt19937 random(2);
+
+    vector<uint8_t> bytes(300);
+
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    const string text = EncodeBase64(bytes, true);
+
+    for (char bad : { '!', ' ', '\n', '-', '_', '=', '\0', static_cast<char>(0xC3), static_cast<char>(0xFF) })
+    {
+        for (size_t position = 0; position + 2 < text.size(); ++position)
+        {
+            string corrupt = text;
+            corrupt[position] = bad;
+
+            vector<uint8_t> decoded;
+            ASSERT_FALSE(Decode(corrupt, &decoded)) << "character " << static_cast<int>(bad) << " at " << position;
+        }
+    }
+}
+
+TEST(Base64Test, RejectsImpossibleLengths)
+{
+    vector<uint8_t> decoded;
+
+    EXPECT_FALSE(Decode("A", &decoded));
+    EXPECT_FALSE(Decode("QUJDR", &decoded));
+    EXPECT_FALSE(Decode("A===", &decoded));
+}
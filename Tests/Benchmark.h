@@ -0,0 +1,42 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// Timing for the benchmarks, which are plain programs that print one line per measurement:
+//
+//     <benchmark>  <rate> <unit>/s  (<seconds> s)
+namespace SceneLoaderBenchmark
+{
+    // Best of repetitions runs of function, in seconds. The best run is the one least
+    // disturbed by the rest of the machine.
+    template<typename Function>
+    double MeasureSeconds(int repetitions, const Function& function)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            function();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (i == 0 || seconds < best)
+            {
+                best = seconds;
+            }
+        }
+
+        return best;
+    }
+
+    inline void ReportRate(const char* name, double count, const char* unit, double seconds)
+    {
+        std::printf("%-48s %12.1f M%s/s  (%.4f s)\n", name, count / seconds / 1e6, unit, seconds);
+        std::fflush(stdout);
+    }
+}
@@ -0,0 +1,376 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "ChunkedInput.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static void AppendUInt32(vector<uint8_t>& bytes, uint32_t value)
+{
+    const uint8_t* pValue = reinterpret_cast<const uint8_t*>(&value);
+    bytes.insert(bytes.end(), pValue, pValue + sizeof(value));
+}
+
+// A GLB with the given JSON and binary chunk, whose header declares glbLength, or the
+// actual length when it is zero.
+static vector<uint8_t> MakeGLB(const string& json, const vector<uint8_t>& binary, uint32_t glbLength = 0)
+{
+    vector<uint8_t> bytes;
+
+    AppendUInt32(bytes, c_glbMagic);
+    AppendUInt32(bytes, c_glbVersion);
+    AppendUInt32(bytes, glbLength);
+    AppendUInt32(bytes, static_cast<uint32_t>(json.size()));
+    AppendUInt32(bytes, c_glbChunkTypeJson);
+    bytes.insert(bytes.end(), json.begin(), json.end());
+    AppendUInt32(bytes, static_cast<uint32_t>(binary.size()));
+    AppendUInt32(bytes, c_glbChunkTypeBin);
+    bytes.insert(bytes.end(), binary.begin(), binary.end());
+
+    if (glbLength == 0)
+    {
+        const uint32_t length = static_cast<uint32_t>(bytes.size());
+        memcpy(bytes.data() + 8, &length, sizeof(length));
+    }
+
+    return bytes;
+}
+
+static const string c_json = "{\"asset\":{\"version\":\"2.0\"}}    ";
+
+TEST(ChunkedInputTest, ByteByByte)
+{
+    const vector<uint8_t> binary(64, 0xAB);
+    const vector<uint8_t> glb = MakeGLB(c_json, binary);
+
+    ChunkedInput input;
+    ArenaArray<const uint8_t> json;
+    uint64_t binaryOffset = 0;
+    uint64_t binaryLength = 0;
+
+    for (size_t i = 0; i < glb.size(); ++i)
+    {
+        input.Append(&glb[i], 1);
+
+        EXPECT_EQ(input.IsGLB(), i + 1 >= c_glbHeaderSize);
+
+        if (!json.data && input.TryGetJson(&json))
+        {
+            EXPECT_EQ(i + 1, c_glbHeaderSize + c_glbChunkHeaderSize + c_json.size());
+        }
+    }
+
+    ASSERT_TRUE(input.IsComplete());
+    ASSERT_TRUE(input.TryGetBinaryChunk(&binaryOffset, &binaryLength));
+
+    // The JSON handed out early is where it was.
+    EXPECT_EQ(string(reinterpret_cast<const char*>(json.data), json.size), c_json);
+    EXPECT_EQ(binaryLength, binary.size());
+    EXPECT_EQ(memcmp(input.Data() + binaryOffset, binary.data(), binary.size()), 0);
+}
+
+TEST(ChunkedInputTest, BytesPastTheDeclaredLengthAreDropped)
+{
+    vector<uint8_t> glb = MakeGLB(c_json, {});
+    const size_t length = glb.size();
+    glb.resize(length + 100, 0xFF);
+
+    ChunkedInput input;
+    input.Append(glb.data(), glb.size());
+
+    EXPECT_TRUE(input.IsComplete());
+    EXPECT_EQ(input.Size(), length);
+}
+
+TEST(ChunkedInputTest, GLTFIsAllJson)
+{
+    ChunkedInput input;
+    input.Append(reinterpret_cast<const uint8_t*>(c_json.data()), c_json.size());
+
+    ArenaArray<const uint8_t> json;
+
+    EXPECT_FALSE(input.IsGLB());
+    EXPECT_FALSE(input.TryGetJson(&json));
+    EXPECT_EQ(input.Size(), c_json.size());
+}
+
+// A header that claims 4 GB is charged before anything is allocated for it.
+TEST(ChunkedInputTest, LyingLengthsAreChargedBeforeTheyAreAllocated)
+{
+    LoadLimits limits;
+    limits.maxDecodedBytes = 1 << 20;
+
+    auto limiter = make_shared<LoadLimiter>(limits);
+    const vector<uint8_t> glb = MakeGLB(c_json, {}, UINT32_MAX);
+
+    ChunkedInput input(limiter);
+
+    try
+    {
+        input.Append(glb.data(), c_glbHeaderSize);
+        FAIL() << "The length wasn't charged";
+    }
+    catch (const LoadLimitException& exception)
+    {
+        EXPECT_EQ(exception.Limit(), LoadLimit::DecodedBytes);
+        EXPECT_EQ(exception.Value(), UINT32_MAX);
+    }
+
+    ChunkedInput withinLimits(make_shared<LoadLimiter>(limits));
+    const vector<uint8_t> small = MakeGLB(c_json, vector<uint8_t>(1000));
+    withinLimits.Append(small.data(), small.size());
+
+    EXPECT_TRUE(withinLimits.IsComplete());
+}
+
+TEST(ChunkedInputTest, LyingChunkHeadersAreInvalid)
+{
+    // The JSON chunk claims more than the file holds.
+    vector<uint8_t> glb = MakeGLB(c_json, {});
+    const uint32_t jsonLength = static_cast<uint32_t>(glb.size());
+    memcpy(glb.data() + c_glbHeaderSize, &jsonLength, sizeof(jsonLength));
+
+    ChunkedInput longJson;
+    EXPECT_THROW(longJson.Append(glb.data(), glb.size()), Microsoft::glTF::InvalidGLTFException);
+
+    // Too short for even the JSON chunk header.
+    ChunkedInput shortFile;
+    const vector<uint8_t> tiny = MakeGLB(c_json, {}, c_glbHeaderSize);
+    EXPECT_THROW(shortFile.Append(tiny.data(), tiny.size()), Microsoft::glTF::InvalidGLTFException);
+
+    // The binary chunk claims more than the file holds; it is then not a binary chunk.
+    vector<uint8_t> binary = MakeGLB(c_json, vector<uint8_t>(16));
+    const uint32_t binaryLength = UINT32_MAX;
+    memcpy(binary.data() + c_glbHeaderSize + c_glbChunkHeaderSize + c_json.size(), &binaryLength, sizeof(binaryLength));
+
+    ChunkedInput longBinary;
+    longBinary.Append(binary.data(), binary.size());
+
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    EXPECT_FALSE(longBinary.TryGetBinaryChunk(&offset, &length));
+}
+
+TEST(ChunkedInputTest, OnlyVersion2)
+{
+    vector<uint8_t> glb = MakeGLB(c_json, {});
+    glb[4] = 1;
+
+    ChunkedInput input;
+    EXPECT_THROW(input.Append(glb.data(), glb.size()), Microsoft::glTF::GLTFException);
+}
+
+// Appends the file in three pieces, split at first and second.
+static void AppendInThree(ChunkedInput& input, const vector<uint8_t>& bytes, size_t first, size_t second)
+{
+    input.Append(bytes.data(), first);
+    input.Append(bytes.data() + first, second - first);
+    input.Append(bytes.data() + second, bytes.size() - second);
+}
+
+// Pieces may end anywhere: in the GLB header, in the JSON chunk header or its JSON, and in
+// the binary chunk header.
+TEST(ChunkedInputTest, SplitsAnywhere)
+{
+    const vector<uint8_t> binary(16, 0xAB);
+    const vector<uint8_t> glb = MakeGLB(c_json, binary);
+    const size_t binaryChunkOffset = c_glbHeaderSize + c_glbChunkHeaderSize + c_json.size();
+
+    for (size_t first = 0; first <= glb.size(); ++first)
+    {
+        for (size_t second = first; second <= glb.size(); ++second)
+        {
+            ChunkedInput input;
+            input.Append(glb.data(), first);
+
+            // Ready only once the binary chunk header is in as well.
+            EXPECT_EQ(input.IsJsonReady(), first >= binaryChunkOffset + c_glbChunkHeaderSize) << first;
+
+            input.Append(glb.data() + first, second - first);
+            EXPECT_EQ(input.IsJsonReady(), second >= binaryChunkOffset + c_glbChunkHeaderSize) << first << ", " << second;
+
+            input.Append(glb.data() + second, glb.size() - second);
+            ASSERT_TRUE(input.IsComplete());
+            ASSERT_TRUE(input.IsJsonReady());
+
+            ArenaArray<const uint8_t> json;
+            uint64_t offset = 0;
+            uint64_t length = 0;
+
+            ASSERT_TRUE(input.TryGetJson(&json));
+            ASSERT_TRUE(input.TryGetBinaryChunk(&offset, &length));
+
+            EXPECT_EQ(string(reinterpret_cast<const char*>(json.data), json.size), c_json);
+            EXPECT_EQ(offset, binaryChunkOffset + c_glbChunkHeaderSize);
+            EXPECT_EQ(length, binary.size());
+            EXPECT_EQ(memcmp(input.Data(), glb.data(), glb.size()), 0);
+        }
+    }
+}
+
+// A GLB without a binary chunk has its JSON ready once the file is complete.
+TEST(ChunkedInputTest, JsonWithoutBinaryChunk)
+{
+    vector<uint8_t> glb = MakeGLB(c_json, {});
+    glb.resize(glb.size() - c_glbChunkHeaderSize);
+    const uint32_t length = static_cast<uint32_t>(glb.size());
+    memcpy(glb.data() + 8, &length, sizeof(length));
+
+    ChunkedInput input;
+    input.Append(glb.data(), glb.size() - 1);
+    EXPECT_FALSE(input.IsJsonReady());
+
+    input.Append(glb.data() + glb.size() - 1, 1);
+    EXPECT_TRUE(input.IsJsonReady());
+}
+
+// Awaited ranges come back on the append that brings their last byte, and not before.
+TEST(ChunkedInputTest, RangesArriveMidStream)
+{
+    const vector<uint8_t> glb = MakeGLB(c_json, vector<uint8_t>(64, 0xAB));
+    const size_t binaryOffset = c_glbHeaderSize + 2 * c_glbChunkHeaderSize + c_json.size();
+
+    // Overlapping ranges, a range wholly inside another, one awaited twice and an empty one.
+    const vector<pair<uint64_t, uint64_t>> ranges =
+    {
+        { binaryOffset + 32, 32 },
+        { binaryOffset, 16 },
+        { binaryOffset + 8, 24 },
+        { binaryOffset + 10, 4 },
+        { binaryOffset, 16 },
+        { binaryOffset + 40, 0 },
+    };
+
+    ChunkedInput input;
+    size_t appended = 0;
+
+    while (!input.IsJsonReady())
+    {
+        input.Append(&glb[appended++], 1);
+    }
+
+    for (size_t tag = 0; tag < ranges.size(); ++tag)
+    {
+        input.AwaitRange(ranges[tag].first, ranges[tag].second, tag);
+    }
+
+    // Nothing of the binary chunk is in yet.
+    EXPECT_TRUE(input.TakeArrivedRanges().empty());
+
+    vector<size_t> arrived(ranges.size(), 0);
+
+    for (; appended < glb.size(); ++appended)
+    {
+        input.Append(&glb[appended], 1);
+
+        for (size_t tag : input.TakeArrivedRanges())
+        {
+            EXPECT_EQ(arrived[tag], 0u) << "Range " << tag << " arrived twice";
+            arrived[tag] = appended + 1;
+        }
+    }
+
+    for (size_t tag = 0; tag < ranges.size(); ++tag)
+    {
+        EXPECT_EQ(arrived[tag], ranges[tag].first + ranges[tag].second) << "Range " << tag;
+    }
+
+    EXPECT_EQ(input.AwaitedRangeCount(), 0u);
+}
+
+TEST(ChunkedInputTest, RangesAlreadyInArriveAtOnce)
+{
+    const vector<uint8_t> glb = MakeGLB(c_json, vector<uint8_t>(64, 0xAB));
+
+    ChunkedInput input;
+    input.Append(glb.data(), glb.size() - 8);
+
+    input.AwaitRange(glb.size() - 16, 8, 1);
+    input.AwaitRange(glb.size() - 16, 16, 2);
+    input.AwaitRange(glb.size() - 48, 8, 0);
+
+    // In the order their last bytes arrived.
+    EXPECT_EQ(input.TakeArrivedRanges(), vector<size_t>({ 0, 1 }));
+    EXPECT_TRUE(input.TakeArrivedRanges().empty());
+
+    input.Append(glb.data() + glb.size() - 8, 8);
+    EXPECT_EQ(input.TakeArrivedRanges(), vector<size_t>({ 2 }));
+}
+
+// Ranges past the end of the file are never handed back, even when they wrap around.
+TEST(ChunkedInputTest, RangesPastTheEndNeverArrive)
+{
+    const vector<uint8_t> glb = MakeGLB(c_json, vector<uint8_t>(16));
+
+    ChunkedInput input;
+    input.AwaitRange(glb.size(), 1, 0);
+    input.AwaitRange(8, UINT64_MAX, 1);
+    input.Append(glb.data(), glb.size());
+
+    EXPECT_TRUE(input.TakeArrivedRanges().empty());
+    EXPECT_EQ(input.AwaitedRangeCount(), 2u);
+}
+
+TEST(ChunkedInputTest, CompletingTruncatedStreams)
+{
+    const vector<uint8_t> glb = MakeGLB(c_json, vector<uint8_t>(16));
+
+    // Cut anywhere from inside the magic, which could also start a .gltf, up to the last byte.
+    for (size_t length = 4; length < glb.size(); ++length)
+    {
+        ChunkedInput input;
+        input.Append(glb.data(), length);
+
+        EXPECT_THROW(input.CheckComplete(), Microsoft::glTF::InvalidGLTFException) << length;
+    }
+
+    ChunkedInput complete;
+    complete.Append(glb.data(), glb.size());
+    EXPECT_NO_THROW(complete.CheckComplete());
+
+    // What a .gltf is made of is left to the JSON parser.
+    ChunkedInput gltf;
+    gltf.Append(reinterpret_cast<const uint8_t*>(c_json.data()), 10);
+    EXPECT_NO_THROW(gltf.CheckComplete());
+
+    ChunkedInput empty;
+    EXPECT_NO_THROW(empty.CheckComplete());
+}
+
+// However the header is split, its length is charged on the append that completes it, and
+// nothing is kept of a GLB the limiter refuses.
+TEST(ChunkedInputTest, OversizedLengthsAreChargedWhenTheHeaderIsIn)
+{
+    LoadLimits limits;
+    limits.maxDecodedBytes = 1 << 20;
+
+    const vector<uint8_t> glb = MakeGLB(c_json, {}, (1 << 20) + 1);
+
+    for (size_t first = 0; first < c_glbHeaderSize; ++first)
+    {
+        ChunkedInput input(make_shared<LoadLimiter>(limits));
+        input.Append(glb.data(), first);
+
+        EXPECT_FALSE(input.IsGLB());
+
+        try
+        {
+            input.Append(glb.data() + first, glb.size() - first);
+            FAIL() << "The length wasn't charged";
+        }
+        catch (const LoadLimitException& exception)
+        {
+            EXPECT_EQ(exception.Limit(), LoadLimit::DecodedBytes);
+            EXPECT_EQ(exception.Value(), (1u << 20) + 1);
+        }
+
+        EXPECT_FALSE(input.IsGLB());
+        EXPECT_FALSE(input.IsJsonReady());
+    }
+}
@@ -0,0 +1,213 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "ContentHash.h"
+#include "DecodeArena.h"
+#include "JsonReader.h"
+#include "MeshCleanup.h"
+#include "MeshSimplifier.h"
+#include "NormalGenerator.h"
+#include "SceneCacheFile.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// The portable stages of a load, run by many loads at once. Loads share nothing but what the
+// loader shares on purpose: the DecodeBlockPool and the cache folder. Configure with
+// -DSCENELOADER_SANITIZER=thread for ThreadSanitizer to check them.
+class ConcurrentLoadTest : public testing::Test
+{
+protected:
+    static constexpr int c_sceneCount = 16;
+
+    void SetUp() override
+    {
+        m_folder = filesystem::path(testing::TempDir()) / "ConcurrentLoadTest";
+
+        filesystem::remove_all(m_folder);
+        filesystem::create_directories(m_folder);
+
+        for (int scene = 0; scene < c_sceneCount; ++scene)
+        {
+            m_documents.push_back(MakeDocument(scene));
+        }
+    }
+
+    void TearDown() override
+    {
+        error_code error;
+        filesystem::remove_all(m_folder, error);
+    }
+
+    // A height field of a size that depends on the scene.
+    static string MakeDocument(int scene)
+    {
+        const int size = 24 + scene % 7;
+        string json = R"({"asset":{"version":"2.0"},"extras":{"size":)" + to_string(size) + R"(,"heights":[)";
+
+        for (int y = 0; y <= size; ++y)
+        {
+            for (int x = 0; x <= size; ++x)
+            {
+                json += ((x | y) ? "," : "") + to_string(sinf(x * 0.3f + scene) * cosf(y * 0.2f));
+            }
+        }
+
+        return json + "]}}";
+    }
+
+    // Parses the document, builds the mesh in an arena, generates normals, simplifies, cleans up,
+    // and goes through a cache file. Returns a hash of the indices read back from the cache.
+    uint64_t Load(int scene) const
+    {
+        const string& json = m_documents[scene];
+        JsonReader reader(json.data(), json.size());
+        string_view key;
+
+        DecodeArena arena;
+        ArenaArray<float> positions;
+        int gridSize = 0;
+
+        reader.BeginObject();
+
+        while (reader.NextMember(&key))
+        {
+            if (key != "extras")
+            {
+                reader.SkipValue();
+                continue;
+            }
+
+            reader.BeginObject();
+
+            while (reader.NextMember(&key))
+            {
+                if (key == "size")
+                {
+                    gridSize = static_cast<int>(reader.ReadIndex());
+                    positions = arena.AllocateArray<float>(static_cast<size_t>(gridSize + 1) * (gridSize + 1) * 3);
+                }
+                else if (key == "heights")
+                {
+                    reader.BeginArray();
+
+                    for (size_t vertex = 0; reader.NextElement(); ++vertex)
+                    {
+                        positions[vertex * 3] = static_cast<float>(vertex % (gridSize + 1));
+                        positions[vertex * 3 + 1] = static_cast<float>(vertex / (gridSize + 1));
+                        positions[vertex * 3 + 2] = reader.ReadFloat();
+                    }
+                }
+                else
+                {
+                    reader.SkipValue();
+                }
+            }
+        }
+
+        reader.ExpectEnd();
+
+        const size_t vertexCount = positions.size / 3;
+        auto indices = arena.AllocateArray<uint16_t>(static_cast<size_t>(gridSize) * gridSize * 6);
+        size_t indexCount = 0;
+
+        for (int y = 0; y < gridSize; ++y)
+        {
+            for (int x = 0; x < gridSize; ++x)
+            {
+                uint16_t a = static_cast<uint16_t>(y * (gridSize + 1) + x);
+                uint16_t b = static_cast<uint16_t>(a + 1);
+                uint16_t c = static_cast<uint16_t>(a + gridSize + 1);
+                uint16_t d = static_cast<uint16_t>(c + 1);
+
+                for (uint16_t index : { a, b, d, a, d, c })
+                {
+                    indices[indexCount++] = index;
+                }
+            }
+        }
+
+        auto normals = arena.AllocateArray<float>(vertexCount * 3);
+        GenerateSmoothNormals(positions.data, vertexCount, indices.data, indexCount, normals.data);
+
+        const SimplifierAttribute attribute = { normals.data, 3, 0.01f };
+        indexCount = SimplifyMesh(positions.data, vertexCount, &attribute, 1, indices.data, indexCount, indexCount / 4).indexCount;
+
+        const MeshStream streams[] = {
+            { reinterpret_cast<const uint8_t*>(positions.data), 12, true },
+            { reinterpret_cast<const uint8_t*>(normals.data), 12, true } };
+
+        auto sources = CleanUpMesh(streams, size(streams), 0, vertexCount, indices.data, &indexCount, 0.0f);
+
+        const SceneCacheKey cacheKey = { ComputeContentHash(json.data(), json.size()), json.size() };
+        const wstring path = GetSceneCachePath(m_folder.wstring(), cacheKey);
+
+        SceneCacheContents contents;
+        contents.meshes.push_back({ 4, 0, 1 });
+        contents.attributes.push_back({ 0, 57, contents.AppendStream(indices.data, indexCount * sizeof(uint16_t)) });
+
+        if (!contents.Write(path, cacheKey))
+        {
+            return 0;
+        }
+
+        auto file = SceneCacheFile::Open(path, cacheKey);
+
+        if (!file)
+        {
+            return 0;
+        }
+
+        return ComputeContentHash(file->StreamData(0), static_cast<size_t>(file->StreamByteLength(0)), sources.size());
+    }
+
+    filesystem::path m_folder;
+    vector<string> m_documents;
+};
+
+TEST_F(ConcurrentLoadTest, ConcurrentLoadsMatchSerialLoads)
+{
+    vector<uint64_t> expected;
+
+    for (int scene = 0; scene < c_sceneCount; ++scene)
+    {
+        expected.push_back(Load(scene));
+        ASSERT_NE(expected.back(), 0u) << "scene " << scene;
+    }
+
+    const int threadCount = 8;
+    const int loadsPerThread = 24;
+    atomic<int> mismatchCount{ 0 };
+    vector<thread> threads;
+
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (int i = 0; i < loadsPerThread; ++i)
+            {
+                const int scene = (t * loadsPerThread + i) % c_sceneCount;
+
+                if (Load(scene) != expected[scene])
+                {
+                    mismatchCount++;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(mismatchCount, 0);
+
+    // One cache file per scene, and no temporary file left behind.
+    EXPECT_EQ(distance(filesystem::directory_iterator(m_folder), filesystem::directory_iterator()), c_sceneCount);
+}
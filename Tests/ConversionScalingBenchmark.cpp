@@ -0,0 +1,171 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <atomic>
+#include <random>
+
+#include "AccessorElements.h"
+#include "Benchmark.h"
+#include "ContentHash.h"
+#include "DecodeArena.h"
+
+using namespace std;
+using namespace SceneLoader;
+using namespace SceneLoaderBenchmark;
+
+// A primitive as a buffer holds it: float positions, normalized short normals and unsigned
+// short texture coordinates interleaved, plus 32-bit indices.
+struct SyntheticPrimitive
+{
+    size_t vertexCount;
+    vector<uint8_t> vertices;
+    vector<uint8_t> indices;
+};
+
+static constexpr size_t c_vertexStride = 12 + 8 + 4;
+
+struct ConvertedStreams
+{
+    ArenaArray<float> positions;
+    ArenaArray<float> normals;
+    ArenaArray<float> texCoords;
+    ArenaArray<uint32_t> indices;
+};
+
+static ConvertedStreams ConvertPrimitive(DecodeArena& arena, const SyntheticPrimitive& primitive)
+{
+    const size_t vertexCount = primitive.vertexCount;
+    const size_t indexCount = primitive.indices.size() / 4;
+
+    ConvertedStreams streams;
+    streams.positions = arena.AllocateArray<float>(vertexCount * 3);
+    streams.normals = arena.AllocateArray<float>(vertexCount * 3);
+    streams.texCoords = arena.AllocateArray<float>(vertexCount * 2);
+    streams.indices = arena.AllocateArray<uint32_t>(indexCount);
+
+    ConvertElementsToFloats(primitive.vertices.data(), vertexCount, c_vertexStride, 3, 5126, false, streams.positions.data);
+    ConvertElementsToFloats(primitive.vertices.data() + 12, vertexCount, c_vertexStride, 3, 5122, true, streams.normals.data);
+    ConvertElementsToFloats(primitive.vertices.data() + 20, vertexCount, c_vertexStride, 2, 5123, true, streams.texCoords.data);
+    ConvertIndices(primitive.indices.data(), indexCount, 5125, streams.indices.data);
+
+    return streams;
+}
+
+// Converts every primitive with a given number of workers: each takes the next primitive until
+// none are left, converting into an arena of its own like the decode pass does. Returns a hash
+// of everything converted, in primitive order, which must not depend on the worker count.
+static uint64_t ConvertAll(const vector<SyntheticPrimitive>& primitives, unsigned workerCount)
+{
+    vector<ConvertedStreams> decoded(primitives.size());
+    vector<unique_ptr<DecodeArena>> arenas(workerCount);
+    atomic<size_t> next{ 0 };
+
+    auto work = [&](unsigned worker)
+    {
+        arenas[worker] = make_unique<DecodeArena>();
+
+        for (size_t i = next++; i < primitives.size(); i = next++)
+        {
+            decoded[i] = ConvertPrimitive(*arenas[worker], primitives[i]);
+        }
+    };
+
+    vector<thread> threads;
+
+    for (unsigned worker = 1; worker < workerCount; ++worker)
+    {
+        threads.emplace_back(work, worker);
+    }
+
+    work(0);
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ContentHasher hasher;
+
+    for (const auto& streams : decoded)
+    {
+        hasher.Append(streams.positions.data, streams.positions.ByteLength());
+        hasher.Append(streams.normals.data, streams.normals.ByteLength());
+        hasher.Append(streams.texCoords.data, streams.texCoords.ByteLength());
+        hasher.Append(streams.indices.data, streams.indices.ByteLength());
+    }
+
+    return hasher.Finish();
+}
+
+// Converts a synthetic scene of 2000 primitives from 100 to 100K vertices, a few large ones
+// among many small ones like in real assets, with 1, 2, 4, ... workers up to the core count,
+// or up to the worker count given as the argument.
+//
+// This is a proxy for the decode pass of GLTFVisitor::DecodeMeshPrimitives, which needs Windows
+// and Composition: only the accessor conversions that pass spends most of its time in, on a
+// thread loop of this file rather than concurrency::parallel_for, without planning, materials
+// or building the meshes. It shows how those conversions scale, not how a load does.
+int main(int argc, char** argv)
+{
+    mt19937 random(1);
+    vector<SyntheticPrimitive> primitives(2000);
+    size_t totalVertices = 0;
+
+    for (auto& primitive : primitives)
+    {
+        primitive.vertexCount = static_cast<size_t>(100 * pow(1000.0, pow(uniform_real_distribution<double>(0.0, 1.0)(random), 3.0)));
+        primitive.vertices.resize(primitive.vertexCount * c_vertexStride);
+        primitive.indices.resize(primitive.vertexCount * 2 * 3 * 4);
+
+        for (auto& byte : primitive.vertices)
+        {
+            byte = static_cast<uint8_t>(random());
+        }
+
+        uint32_t* indices = reinterpret_cast<uint32_t*>(primitive.indices.data());
+
+        for (size_t i = 0; i < primitive.indices.size() / 4; ++i)
+        {
+            indices[i] = static_cast<uint32_t>(random() % primitive.vertexCount);
+        }
+
+        totalVertices += primitive.vertexCount;
+    }
+
+    const uint64_t serialHash = ConvertAll(primitives, 1);
+    const unsigned coreCount = max(1u, thread::hardware_concurrency());
+    const unsigned maxWorkerCount = argc > 1 ? max(1, atoi(argv[1])) : coreCount;
+
+    vector<unsigned> workerCounts;
+
+    for (unsigned workerCount = 1; workerCount < maxWorkerCount; workerCount *= 2)
+    {
+        workerCounts.push_back(workerCount);
+    }
+
+    workerCounts.push_back(maxWorkerCount);
+
+    double serialSeconds = 0.0;
+
+    for (unsigned workerCount : workerCounts)
+    {
+        if (ConvertAll(primitives, workerCount) != serialHash)
+        {
+            printf("Converting with %u workers differs from converting serially\n", workerCount);
+            return 1;
+        }
+
+        double seconds = MeasureSeconds(5, [&]() { ConvertAll(primitives, workerCount); });
+
+        if (workerCount == 1)
+        {
+            serialSeconds = seconds;
+        }
+
+        string name = "Convert, workers: " + to_string(workerCount) + ", speedup " + to_string(serialSeconds / seconds).substr(0, 4);
+        ReportRate(name.c_str(), static_cast<double>(totalVertices), "vertices", seconds);
+    }
+}
@@ -0,0 +1,133 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "GLBContainer.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+using namespace SceneLoader;
+
+static void AppendUInt32(vector<uint8_t>& bytes, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        bytes.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+static void AppendChunk(vector<uint8_t>& glb, uint32_t type, const string& contents)
+{
+    AppendUInt32(glb, static_cast<uint32_t>(contents.size()));
+    AppendUInt32(glb, type);
+    glb.insert(glb.end(), contents.begin(), contents.end());
+}
+
+// A GLB of the given chunks, its header length covering them all.
+static vector<uint8_t> MakeGLB(const vector<pair<uint32_t, string>>& chunks)
+{
+    vector<uint8_t> glb;
+    AppendUInt32(glb, c_glbMagic);
+    AppendUInt32(glb, c_glbVersion);
+    AppendUInt32(glb, 0);
+
+    for (const auto& chunk : chunks)
+    {
+        AppendChunk(glb, chunk.first, chunk.second);
+    }
+
+    const uint32_t length = static_cast<uint32_t>(glb.size());
+    memcpy(&glb[8], &length, sizeof(length));
+
+    return glb;
+}
+
+static string Text(const ArenaArray<const uint8_t>& bytes)
+{
+    return string(reinterpret_cast<const char*>(bytes.data), bytes.size);
+}
+
+TEST(GLBContainerTest, TakesOtherInputAsJson)
+{
+    const string json = "{\"asset\":{\"version\":\"2.0\"}}";
+    const GLBContainer container = ParseGLBContainer(reinterpret_cast<const uint8_t*>(json.data()), json.size());
+
+    EXPECT_FALSE(container.isGLB);
+    EXPECT_EQ(json, Text(container.json));
+    EXPECT_TRUE(container.binaryChunk.empty());
+}
+
+TEST(GLBContainerTest, FindsTheChunks)
+{
+    const vector<uint8_t> glb = MakeGLB({ { c_glbChunkTypeJson, "{}  " }, { c_glbChunkTypeBin, "12345678" } });
+    const GLBContainer container = ParseGLBContainer(glb.data(), glb.size());
+
+    EXPECT_TRUE(container.isGLB);
+    EXPECT_EQ("{}  ", Text(container.json));
+    EXPECT_EQ("12345678", Text(container.binaryChunk));
+}
+
+TEST(GLBContainerTest, SkipsUnknownChunks)
+{
+    const vector<uint8_t> glb = MakeGLB({ { c_glbChunkTypeJson, "{}  " }, { 0x41424344, "skip" }, { c_glbChunkTypeBin, "1234" }, { c_glbChunkTypeBin, "5678" } });
+    const GLBContainer container = ParseGLBContainer(glb.data(), glb.size());
+
+    EXPECT_EQ("{}  ", Text(container.json));
+    EXPECT_EQ("1234", Text(container.binaryChunk));
+}
+
+// A file may go on past the length its header declares; the rest isn't part of the GLB.
+TEST(GLBContainerTest, StopsAtTheDeclaredLength)
+{
+    vector<uint8_t> glb = MakeGLB({ { c_glbChunkTypeJson, "{}  " } });
+    AppendChunk(glb, c_glbChunkTypeBin, "1234");
+
+    const GLBContainer container = ParseGLBContainer(glb.data(), glb.size());
+
+    EXPECT_EQ("{}  ", Text(container.json));
+    EXPECT_TRUE(container.binaryChunk.empty());
+}
+
+TEST(GLBContainerTest, RefusesOtherVersions)
+{
+    vector<uint8_t> glb = MakeGLB({ { c_glbChunkTypeJson, "{}  " } });
+    glb[4] = 1;
+
+    EXPECT_THROW(ParseGLBContainer(glb.data(), glb.size()), GLTFException);
+}
+
+TEST(GLBContainerTest, RefusesChunksOutsideTheFile)
+{
+    const vector<uint8_t> glb = MakeGLB({ { c_glbChunkTypeJson, "{}  " }, { c_glbChunkTypeBin, "12345678" } });
+
+    // Declared longer than the file.
+    vector<uint8_t> longer = glb;
+    longer[8] += 1;
+    EXPECT_THROW(ParseGLBContainer(longer.data(), longer.size()), InvalidGLTFException);
+
+    // The file cut short of the declared length.
+    EXPECT_THROW(ParseGLBContainer(glb.data(), glb.size() - 1), InvalidGLTFException);
+
+    // A chunk running past the declared length.
+    vector<uint8_t> chunk = glb;
+    chunk[c_glbHeaderSize + c_glbChunkHeaderSize + 4] = 9;
+    EXPECT_THROW(ParseGLBContainer(chunk.data(), chunk.size()), InvalidGLTFException);
+
+    // A chunk length that would wrap around.
+    vector<uint8_t> huge = glb;
+    memset(&huge[c_glbHeaderSize], 0xFF, 4);
+    EXPECT_THROW(ParseGLBContainer(huge.data(), huge.size()), InvalidGLTFException);
+}
+
+TEST(GLBContainerTest, NeedsJsonFirst)
+{
+    const vector<uint8_t> binFirst = MakeGLB({ { c_glbChunkTypeBin, "1234" }, { c_glbChunkTypeJson, "{}  " } });
+    EXPECT_THROW(ParseGLBContainer(binFirst.data(), binFirst.size()), InvalidGLTFException);
+
+    const vector<uint8_t> empty = MakeGLB({});
+    EXPECT_THROW(ParseGLBContainer(empty.data(), empty.size()), InvalidGLTFException);
+}
@@ -0,0 +1,203 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "ImageHeaderProbe.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static vector<uint8_t> MakePng(uint32_t width, uint32_t height)
+{
+    vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R' };
+
+    for (uint32_t value : { width, height })
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            png.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    png.insert(png.end(), { 8, 6, 0, 0, 0 });
+    return png;
+}
+
+// A JPEG whose frame header comes after metadataCount APP1 segments of segmentLength bytes.
+static vector<uint8_t> MakeJpeg(uint16_t width, uint16_t height, int metadataCount = 0, uint16_t segmentLength = 16, uint8_t frameMarker = 0xC0)
+{
+    vector<uint8_t> jpeg = { 0xFF, 0xD8 };
+
+    for (int i = 0; i < metadataCount; ++i)
+    {
+        jpeg.insert(jpeg.end(), { 0xFF, 0xE1, static_cast<uint8_t>(segmentLength >> 8), static_cast<uint8_t>(segmentLength) });
+        jpeg.insert(jpeg.end(), segmentLength - 2, 0x20);
+    }
+
+    jpeg.insert(jpeg.end(), { 0xFF, frameMarker, 0, 17, 8,
+        static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+        static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width), 3 });
+
+    return jpeg;
+}
+
+static vector<uint8_t> MakeGif(uint16_t width, uint16_t height, const char* version = "GIF89a")
+{
+    vector<uint8_t> gif(version, version + 6);
+    gif.insert(gif.end(), { static_cast<uint8_t>(width), static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(height), static_cast<uint8_t>(height >> 8), 0, 0 });
+    return gif;
+}
+
+static void AppendLittleEndian32(vector<uint8_t>& bytes, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        bytes.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+static vector<uint8_t> MakeBmp(int32_t width, int32_t height)
+{
+    vector<uint8_t> bmp = { 'B', 'M' };
+    bmp.resize(14);
+    AppendLittleEndian32(bmp, 40);
+    AppendLittleEndian32(bmp, static_cast<uint32_t>(width));
+    AppendLittleEndian32(bmp, static_cast<uint32_t>(height));
+    bmp.resize(54);
+    return bmp;
+}
+
+static pair<uint32_t, uint32_t> Probe(const vector<uint8_t>& bytes)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    if (!ProbeImageSize(bytes.data(), bytes.size(), &width, &height))
+    {
+        return { 0, 0 };
+    }
+
+    return { width, height };
+}
+
+TEST(ImageHeaderProbeTest, ReadsTheSizeOfEachFormat)
+{
+    EXPECT_EQ(make_pair(300u, 200u), Probe(MakePng(300, 200)));
+    EXPECT_EQ(make_pair(64u, 32u), Probe(MakeJpeg(64, 32)));
+    EXPECT_EQ(make_pair(10u, 12u), Probe(MakeGif(10, 12)));
+    EXPECT_EQ(make_pair(10u, 12u), Probe(MakeGif(10, 12, "GIF87a")));
+    EXPECT_EQ(make_pair(7u, 5u), Probe(MakeBmp(7, 5)));
+}
+
+TEST(ImageHeaderProbeTest, ReadsTopDownBitmaps)
+{
+    EXPECT_EQ(make_pair(7u, 5u), Probe(MakeBmp(7, -5)));
+
+    vector<uint8_t> core = { 'B', 'M' };
+    core.resize(14);
+    AppendLittleEndian32(core, 12);
+    core.insert(core.end(), { 9, 0, 3, 0, 1, 0, 24, 0 });
+    EXPECT_EQ(make_pair(9u, 3u), Probe(core));
+}
+
+TEST(ImageHeaderProbeTest, WalksJpegSegments)
+{
+    EXPECT_EQ(make_pair(640u, 480u), Probe(MakeJpeg(640, 480, 3)));
+    EXPECT_EQ(make_pair(640u, 480u), Probe(MakeJpeg(640, 480, 2, 0xFFF0)));
+
+    // Progressive.
+    EXPECT_EQ(make_pair(640u, 480u), Probe(MakeJpeg(640, 480, 1, 16, 0xC2)));
+
+    // Fill bytes and markers without a payload before the frame.
+    vector<uint8_t> jpeg = { 0xFF, 0xD8, 0xFF, 0xFF, 0xFF, 0x01 };
+    const vector<uint8_t> frame = MakeJpeg(33, 44);
+    jpeg.insert(jpeg.end(), frame.begin() + 2, frame.end());
+    EXPECT_EQ(make_pair(33u, 44u), Probe(jpeg));
+
+    // DHT has the number of a frame marker but isn't one.
+    vector<uint8_t> huffman = { 0xFF, 0xD8, 0xFF, 0xC4, 0, 6, 1, 2, 3, 4 };
+    huffman.insert(huffman.end(), frame.begin() + 2, frame.end());
+    EXPECT_EQ(make_pair(33u, 44u), Probe(huffman));
+}
+
+// Every header cut short anywhere is refused rather than read past its end.
+TEST(ImageHeaderProbeTest, RefusesTruncatedHeaders)
+{
+    const vector<vector<uint8_t>> images =
+    {
+        MakePng(300, 200),
+        MakeJpeg(64, 32, 2),
+        MakeGif(10, 12),
+        MakeBmp(7, 5),
+    };
+
+    for (const auto& image : images)
+    {
+        for (size_t length = 0; length < image.size(); ++length)
+        {
+            // A copy of exactly the truncated length, so that reading past it is caught by
+            // the sanitizers.
+            const vector<uint8_t> truncated(image.begin(), image.begin() + length);
+            const auto size = Probe(truncated);
+
+            // Everything after the size fields may be missing.
+            if (size != make_pair(0u, 0u))
+            {
+                EXPECT_EQ(size, Probe(image)) << "length " << length;
+            }
+        }
+    }
+
+    // Cut inside the size fields themselves.
+    const vector<uint8_t> png = MakePng(300, 200);
+    const vector<uint8_t> jpeg = MakeJpeg(64, 32, 2);
+    const vector<uint8_t> gif = MakeGif(10, 12);
+
+    EXPECT_EQ(make_pair(0u, 0u), Probe(vector<uint8_t>(png.begin(), png.begin() + 23)));
+    EXPECT_EQ(make_pair(0u, 0u), Probe(vector<uint8_t>(jpeg.begin(), jpeg.end() - 2)));
+    EXPECT_EQ(make_pair(0u, 0u), Probe(vector<uint8_t>(gif.begin(), gif.begin() + 9)));
+}
+
+TEST(ImageHeaderProbeTest, RefusesCorruptHeaders)
+{
+    EXPECT_EQ(make_pair(0u, 0u), Probe(MakePng(0, 200)));
+    EXPECT_EQ(make_pair(0u, 0u), Probe(MakePng(0x80000000u, 1)));
+    EXPECT_EQ(make_pair(0u, 0u), Probe(MakeJpeg(64, 0)));
+    EXPECT_EQ(make_pair(0u, 0u), Probe(MakeBmp(-7, 5)));
+    EXPECT_EQ(make_pair(0u, 0u), Probe(MakeBmp(7, INT32_MIN)));
+
+    vector<uint8_t> png = MakePng(300, 200);
+    memcpy(&png[12], "IEND", 4);
+    EXPECT_EQ(make_pair(0u, 0u), Probe(png));
+
+    // A scan before any frame, and a segment length too short to be one.
+    EXPECT_EQ(make_pair(0u, 0u), Probe({ 0xFF, 0xD8, 0xFF, 0xDA, 0, 8, 0, 0, 0, 0, 0, 0 }));
+    EXPECT_EQ(make_pair(0u, 0u), Probe({ 0xFF, 0xD8, 0xFF, 0xE0, 0, 1, 0, 0, 0, 0, 0, 0 }));
+    EXPECT_EQ(make_pair(0u, 0u), Probe({ 0xFF, 0xD8, 0x00, 0xE0, 0, 8, 0, 0, 0, 0, 0, 0 }));
+
+    EXPECT_EQ(make_pair(0u, 0u), Probe({ 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'E', 'B', 'P' }));
+}
+
+TEST(ImageHeaderProbeTest, ReadsMimeTypesFromSignatures)
+{
+    auto mimeType = [](const vector<uint8_t>& bytes)
+    {
+        const char* type = ProbeImageMimeType(bytes.data(), bytes.size());
+        return string(type ? type : "none");
+    };
+
+    EXPECT_EQ("image/png", mimeType(MakePng(1, 1)));
+    EXPECT_EQ("image/jpeg", mimeType(MakeJpeg(1, 1, 1)));
+    EXPECT_EQ("image/gif", mimeType(MakeGif(1, 1)));
+    EXPECT_EQ("image/bmp", mimeType(MakeBmp(1, 1)));
+    EXPECT_EQ("image/webp", mimeType({ 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'E', 'B', 'P' }));
+    EXPECT_EQ("image/ktx2", mimeType({ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' }));
+
+    EXPECT_EQ("none", mimeType({}));
+    EXPECT_EQ("none", mimeType({ 0x89, 'P', 'N', 'G' }));
+    EXPECT_EQ("none", mimeType({ 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E' }));
+}
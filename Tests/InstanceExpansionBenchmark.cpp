@@ -0,0 +1,111 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <random>
+
+#include "Benchmark.h"
+#include "InstanceTransforms.h"
+
+using namespace std;
+using namespace SceneLoader;
+using namespace SceneLoaderBenchmark;
+
+// The expansion stage of GLTFVisitor for 100K EXT_mesh_gpu_instancing instances of a cube
+// with normals and tangents: converting the instance transforms, and merging the instances
+// into batched meshes the way TryAddInstanceBatches does. Creating the composition objects
+// needs Windows, so for those only the counts are reported.
+int main()
+{
+    const size_t instanceCount = 100000;
+    const size_t vertexCount = 24;
+    const size_t indexCount = 36;
+
+    // Vertices a merged mesh can have with 16-bit indices, as in GLTFVisitor_MeshInstancing.cpp.
+    const size_t maxBatchVertexCount = static_cast<size_t>(UINT16_MAX) + 1;
+    const size_t instancesPerBatch = maxBatchVertexCount / vertexCount;
+    const size_t batchCount = (instanceCount + instancesPerBatch - 1) / instancesPerBatch;
+
+    mt19937 random(1);
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    MeshInstances instances;
+    instances.count = instanceCount;
+
+    for (size_t i = 0; i < instanceCount; ++i)
+    {
+        float rotation[4] = { value(random), value(random), value(random), value(random) };
+        float length = sqrtf(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] + rotation[3] * rotation[3]);
+
+        instances.translations.insert(instances.translations.end(), { 100 * value(random), 0.0f, 100 * value(random) });
+        instances.rotations.insert(instances.rotations.end(), { rotation[0] / length, rotation[1] / length, rotation[2] / length, rotation[3] / length });
+        instances.scales.insert(instances.scales.end(), { 1.0f, 1.0f + value(random) * 0.5f, 1.0f });
+    }
+
+    vector<float> positions(vertexCount * 3);
+    vector<float> normals(vertexCount * 3);
+    vector<float> tangents(vertexCount * 4);
+    vector<uint16_t> indices(indexCount);
+
+    for (auto& position : positions)
+    {
+        position = value(random);
+    }
+
+    for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        normals[vertex * 3 + vertex % 3] = (vertex & 1) ? -1.0f : 1.0f;
+        tangents[vertex * 4 + (vertex + 1) % 3] = 1.0f;
+        tangents[vertex * 4 + 3] = 1.0f;
+    }
+
+    for (size_t index = 0; index < indexCount; ++index)
+    {
+        indices[index] = static_cast<uint16_t>(random() % vertexCount);
+    }
+
+    vector<InstanceMatrix> matrices(instanceCount);
+
+    double seconds = MeasureSeconds(10, [&]()
+    {
+        ComputeInstanceMatrices(instances, 0, instanceCount, matrices.data());
+    });
+
+    ReportRate("ComputeInstanceMatrices", static_cast<double>(instanceCount), "instances", seconds);
+
+    vector<float> batchPositions(instancesPerBatch * vertexCount * 3);
+    vector<float> batchNormals(instancesPerBatch * vertexCount * 3);
+    vector<float> batchTangents(instancesPerBatch * vertexCount * 4);
+    vector<uint16_t> batchIndices(instancesPerBatch * indexCount);
+
+    seconds = MeasureSeconds(10, [&]()
+    {
+        for (size_t first = 0; first < instanceCount; first += instancesPerBatch)
+        {
+            const size_t batchInstanceCount = min(instancesPerBatch, instanceCount - first);
+
+            for (size_t i = 0; i < batchInstanceCount; ++i)
+            {
+                const InstanceMatrix& matrix = matrices[first + i];
+
+                TransformInstancePositions(matrix, positions.data(), vertexCount, &batchPositions[i * vertexCount * 3]);
+                TransformInstanceNormals(matrix, normals.data(), vertexCount, &batchNormals[i * vertexCount * 3]);
+                TransformInstanceTangents(matrix, tangents.data(), vertexCount, &batchTangents[i * vertexCount * 4]);
+
+                for (size_t index = 0; index < indexCount; ++index)
+                {
+                    batchIndices[i * indexCount + index] = static_cast<uint16_t>(indices[index] + i * vertexCount);
+                }
+            }
+        }
+    });
+
+    ReportRate("Instance batching, 24 vertices each", static_cast<double>(instanceCount), "instances", seconds);
+
+    // One node and one renderer per instance, sharing the mesh and the material; or one node,
+    // renderer and mesh per batch.
+    printf("%zu instances: %zu scene objects as instance nodes, %zu as %zu batches\n",
+        instanceCount, 2 * instanceCount, 3 * batchCount, batchCount);
+}
@@ -0,0 +1,239 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "InstanceTransforms.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// Random translations, unit rotations and positive scales.
+static MeshInstances MakeInstances(size_t count, uint32_t seed)
+{
+    mt19937 random(seed);
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    uniform_real_distribution<float> scale(0.25f, 4.0f);
+
+    MeshInstances instances;
+    instances.count = count;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float rotation[4] = { value(random), value(random), value(random), value(random) };
+        float length = sqrtf(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] + rotation[3] * rotation[3]);
+
+        for (auto& component : rotation)
+        {
+            component /= length;
+        }
+
+        instances.translations.insert(instances.translations.end(), { 10 * value(random), 10 * value(random), 10 * value(random) });
+        instances.rotations.insert(instances.rotations.end(), rotation, rotation + 4);
+        instances.scales.insert(instances.scales.end(), { scale(random), scale(random), scale(random) });
+    }
+
+    return instances;
+}
+
+// T * R * S in double precision, row r giving output component r.
+static void ReferenceMatrix(const MeshInstances& instances, size_t i, double (*pRows)[4])
+{
+    const float* t = &instances.translations[i * 3];
+    const float* q = &instances.rotations[i * 4];
+    const float* s = &instances.scales[i * 3];
+
+    const double x = q[0], y = q[1], z = q[2], w = q[3];
+    const double rotation[3][3] = {
+        { 1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y) },
+        { 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x) },
+        { 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y) } };
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t column = 0; column < 3; ++column)
+        {
+            pRows[row][column] = rotation[row][column] * s[column];
+        }
+
+        pRows[row][3] = t[row];
+    }
+}
+
+static void Cross(const float* a, const float* b, float* pResult)
+{
+    pResult[0] = a[1] * b[2] - a[2] * b[1];
+    pResult[1] = a[2] * b[0] - a[0] * b[2];
+    pResult[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static float Dot3(const float* a, const float* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Every range start and length around the four-instance groups, so each tail is covered.
+TEST(InstanceTransformsTest, MatricesMatchTheReference)
+{
+    const MeshInstances instances = MakeInstances(13, 1);
+
+    for (size_t begin = 0; begin < 5; ++begin)
+    {
+        for (size_t end = begin; end <= instances.count; ++end)
+        {
+            vector<InstanceMatrix> matrices(end - begin + 1);
+            memset(&matrices.back(), 0xcd, sizeof(InstanceMatrix));
+
+            ComputeInstanceMatrices(instances, begin, end, matrices.data());
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                double reference[3][4];
+                ReferenceMatrix(instances, i, reference);
+
+                for (size_t row = 0; row < 3; ++row)
+                {
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        ASSERT_NEAR(matrices[i - begin].rows[row][column], reference[row][column], 1e-4)
+                            << "range [" << begin << ", " << end << "), instance " << i << ", row " << row << ", column " << column;
+                    }
+                }
+            }
+
+            // Nothing is written past the range.
+            const uint8_t* past = reinterpret_cast<const uint8_t*>(&matrices.back());
+            ASSERT_TRUE(all_of(past, past + sizeof(InstanceMatrix), [](uint8_t b) { return b == 0xcd; }));
+        }
+    }
+}
+
+TEST(InstanceTransformsTest, PositionsGoThroughTheMatrix)
+{
+    const MeshInstances instances = MakeInstances(1, 2);
+    const float positions[] = { 0, 0, 0, 1, 0, 0, 0, -2, 0, 0.5f, 0.25f, 3 };
+
+    InstanceMatrix matrix;
+    ComputeInstanceMatrices(instances, 0, 1, &matrix);
+
+    float transformed[12];
+    TransformInstancePositions(matrix, positions, 4, transformed);
+
+    double reference[3][4];
+    ReferenceMatrix(instances, 0, reference);
+
+    for (size_t vertex = 0; vertex < 4; ++vertex)
+    {
+        for (size_t row = 0; row < 3; ++row)
+        {
+            const float* p = positions + vertex * 3;
+            double expected = reference[row][0] * p[0] + reference[row][1] * p[1] + reference[row][2] * p[2] + reference[row][3];
+
+            EXPECT_NEAR(transformed[vertex * 3 + row], expected, 1e-4) << "vertex " << vertex << ", row " << row;
+        }
+    }
+}
+
+// Under a non-uniform scale a normal stays perpendicular to the surface only through the
+// inverse transpose; transforming it like a position would tilt it.
+TEST(InstanceTransformsTest, NormalsStayPerpendicularToTheSurface)
+{
+    const MeshInstances instances = MakeInstances(64, 3);
+    vector<InstanceMatrix> matrices(instances.count);
+    ComputeInstanceMatrices(instances, 0, instances.count, matrices.data());
+
+    // A tilted triangle and its normal.
+    const float positions[] = { 0, 0, 0, 1, 0.5f, 0, 0, 1, 2 };
+    float normal[3];
+    Cross(positions + 3, positions + 6, normal);
+
+    for (size_t i = 0; i < instances.count; ++i)
+    {
+        float transformed[9];
+        TransformInstancePositions(matrices[i], positions, 3, transformed);
+
+        float transformedNormal[3];
+        TransformInstanceNormals(matrices[i], normal, 1, transformedNormal);
+
+        float edges[2][3];
+
+        for (size_t component = 0; component < 3; ++component)
+        {
+            edges[0][component] = transformed[3 + component] - transformed[component];
+            edges[1][component] = transformed[6 + component] - transformed[component];
+        }
+
+        float expected[3];
+        Cross(edges[0], edges[1], expected);
+
+        float length = sqrtf(Dot3(expected, expected));
+
+        ASSERT_NEAR(Dot3(transformedNormal, transformedNormal), 1.0f, 1e-5f) << "instance " << i;
+        ASSERT_NEAR(Dot3(transformedNormal, expected) / length, 1.0f, 1e-4f) << "instance " << i;
+    }
+}
+
+TEST(InstanceTransformsTest, TangentsKeepTheirHandedness)
+{
+    const MeshInstances instances = MakeInstances(1, 4);
+    const float tangents[] = { 1, 0, 0, 1, 0, 3, 0, -1 };
+
+    InstanceMatrix matrix;
+    ComputeInstanceMatrices(instances, 0, 1, &matrix);
+
+    float transformed[8];
+    TransformInstanceTangents(matrix, tangents, 2, transformed);
+
+    EXPECT_EQ(transformed[3], 1.0f);
+    EXPECT_EQ(transformed[7], -1.0f);
+
+    for (size_t vertex = 0; vertex < 2; ++vertex)
+    {
+        EXPECT_NEAR(Dot3(transformed + vertex * 4, transformed + vertex * 4), 1.0f, 1e-5f);
+    }
+}
+
+TEST(InstanceTransformsTest, ZeroScaleFallsBack)
+{
+    MeshInstances instances;
+    instances.count = 1;
+    instances.translations = { 1, 2, 3 };
+    instances.rotations = { 0, 0, 0, 1 };
+    instances.scales = { 0, 0, 0 };
+
+    InstanceMatrix matrix;
+    ComputeInstanceMatrices(instances, 0, 1, &matrix);
+
+    for (const auto& row : matrix.normalRows)
+    {
+        for (float value : row)
+        {
+            EXPECT_EQ(value, 0.0f);
+        }
+    }
+
+    const float position[] = { 5, 6, 7 };
+    const float normal[] = { 0, 1, 0 };
+    const float tangent[] = { 0, 1, 0, -1 };
+    float transformed[4];
+
+    TransformInstancePositions(matrix, position, 1, transformed);
+    EXPECT_EQ(transformed[0], 1.0f);
+    EXPECT_EQ(transformed[1], 2.0f);
+    EXPECT_EQ(transformed[2], 3.0f);
+
+    TransformInstanceNormals(matrix, normal, 1, transformed);
+    EXPECT_EQ(transformed[0], 0.0f);
+    EXPECT_EQ(transformed[1], 0.0f);
+    EXPECT_EQ(transformed[2], 1.0f);
+
+    TransformInstanceTangents(matrix, tangent, 1, transformed);
+    EXPECT_EQ(transformed[0], 1.0f);
+    EXPECT_EQ(transformed[1], 0.0f);
+    EXPECT_EQ(transformed[2], 0.0f);
+    EXPECT_EQ(transformed[3], -1.0f);
+}
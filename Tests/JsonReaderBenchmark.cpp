@@ -0,0 +1,214 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <json/json.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "Benchmark.h"
+#include "JsonReader.h"
+
+using namespace std;
+using namespace SceneLoader;
+using namespace SceneLoaderBenchmark;
+
+// The nodes of a document in the compact, index-addressed form StreamingDeserializer fills,
+// so that both parsers end up with the same tables.
+struct CompactNodes
+{
+    string names;
+    vector<uint32_t> nameEnds;
+    vector<uint32_t> meshes;
+    vector<float> translations;
+    vector<uint32_t> children;
+    vector<uint32_t> childEnds;
+};
+
+static CompactNodes ReadStreaming(const string& json)
+{
+    CompactNodes nodes;
+    JsonReader reader(json.data(), json.size());
+    string_view key;
+
+    reader.BeginObject();
+
+    while (reader.NextMember(&key))
+    {
+        if (key != "nodes")
+        {
+            reader.SkipValue();
+            continue;
+        }
+
+        reader.BeginArray();
+
+        while (reader.NextElement())
+        {
+            uint32_t mesh = UINT32_MAX;
+            float translation[3] = {};
+
+            reader.BeginObject();
+
+            while (reader.NextMember(&key))
+            {
+                if (key == "name")
+                {
+                    nodes.names += reader.ReadString();
+                }
+                else if (key == "mesh")
+                {
+                    mesh = static_cast<uint32_t>(reader.ReadIndex());
+                }
+                else if (key == "translation")
+                {
+                    reader.BeginArray();
+
+                    for (size_t i = 0; reader.NextElement(); ++i)
+                    {
+                        translation[min<size_t>(i, 2)] = reader.ReadFloat();
+                    }
+                }
+                else if (key == "children")
+                {
+                    reader.BeginArray();
+
+                    while (reader.NextElement())
+                    {
+                        nodes.children.push_back(static_cast<uint32_t>(reader.ReadIndex()));
+                    }
+                }
+                else
+                {
+                    reader.SkipValue();
+                }
+            }
+
+            nodes.nameEnds.push_back(static_cast<uint32_t>(nodes.names.size()));
+            nodes.meshes.push_back(mesh);
+            nodes.translations.insert(nodes.translations.end(), translation, translation + 3);
+            nodes.childEnds.push_back(static_cast<uint32_t>(nodes.children.size()));
+        }
+    }
+
+    reader.ExpectEnd();
+
+    return nodes;
+}
+
+// What the SDK's Deserialize does: a DOM of the whole document first, then the tables from it.
+static CompactNodes ReadDom(const string& json)
+{
+    Json::Value root;
+    string errors;
+
+    unique_ptr<Json::CharReader> parser(Json::CharReaderBuilder().newCharReader());
+
+    if (!parser->parse(json.data(), json.data() + json.size(), &root, &errors))
+    {
+        throw runtime_error(errors);
+    }
+
+    CompactNodes nodes;
+
+    for (const auto& node : root["nodes"])
+    {
+        nodes.names += node["name"].asString();
+        nodes.nameEnds.push_back(static_cast<uint32_t>(nodes.names.size()));
+        nodes.meshes.push_back(node.isMember("mesh") ? node["mesh"].asUInt() : UINT32_MAX);
+
+        for (Json::ArrayIndex i = 0; i < 3; ++i)
+        {
+            nodes.translations.push_back(node["translation"].isValidIndex(i) ? node["translation"][i].asFloat() : 0.0f);
+        }
+
+        for (const auto& child : node["children"])
+        {
+            nodes.children.push_back(child.asUInt());
+        }
+
+        nodes.childEnds.push_back(static_cast<uint32_t>(nodes.children.size()));
+    }
+
+    return nodes;
+}
+
+// VmHWM of /proc/self/status can be reset through clear_refs on Linux; elsewhere there's
+// no peak to report. The heap is trimmed first so what a previous run freed isn't counted
+// as resident.
+static void ResetPeakMemory()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+
+    if (FILE* file = fopen("/proc/self/clear_refs", "w"))
+    {
+        fputs("5", file);
+        fclose(file);
+    }
+}
+
+static size_t ReadStatusKilobytes(const char* field)
+{
+    size_t kilobytes = 0;
+
+    if (FILE* file = fopen("/proc/self/status", "r"))
+    {
+        char line[256];
+
+        while (fgets(line, sizeof(line), file))
+        {
+            if (strncmp(line, field, strlen(field)) == 0)
+            {
+                kilobytes = strtoull(line + strlen(field), nullptr, 10);
+            }
+        }
+
+        fclose(file);
+    }
+
+    return kilobytes;
+}
+
+template<typename Function>
+static void Measure(const char* name, const string& json, const Function& read)
+{
+    ResetPeakMemory();
+    const size_t baseKilobytes = ReadStatusKilobytes("VmHWM:");
+
+    size_t nodeCount = 0;
+    double seconds = MeasureSeconds(1, [&]() { nodeCount = read(json).meshes.size(); });
+
+    const size_t peakKilobytes = ReadStatusKilobytes("VmHWM:");
+
+    ReportRate(name, static_cast<double>(json.size()), "B", seconds);
+    printf("%-48s %12.1f MB peak, %zu nodes\n", "", (peakKilobytes - min(peakKilobytes, baseKilobytes)) / 1024.0, nodeCount);
+}
+
+// 300K nodes with a name, a mesh, a translation and a child each, about 25 MB of JSON.
+int main()
+{
+    string json = R"({"asset":{"version":"2.0"},"nodes":[)";
+
+    for (int i = 0; i < 300000; ++i)
+    {
+        json += (i ? "," : "");
+        json += R"({"name":"node)" + to_string(i) + R"(","mesh":)" + to_string(i % 100) + R"(,"translation":[1.5,2.25,-3e-2],"children":[)" + to_string(i + 1) + "]}";
+    }
+
+    json += "]}";
+
+    if (ReadStreaming(json).children != ReadDom(json).children)
+    {
+        printf("The parsers disagree\n");
+        return 1;
+    }
+
+    Measure("JsonReader, streaming", json, ReadStreaming);
+    Measure("jsoncpp DOM", json, ReadDom);
+}
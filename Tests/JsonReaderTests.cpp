@@ -0,0 +1,175 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "JsonReader.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// Reads any value back as compact text, so that what the reader saw can be compared with
+// what the JSON says. Nulls come out as the raw text SkipValue returns.
+static string Dump(JsonReader& reader)
+{
+    string text;
+
+    switch (reader.PeekType())
+    {
+    case JsonValueType::Object:
+    {
+        string_view key;
+        reader.BeginObject();
+        text += '{';
+
+        while (reader.NextMember(&key))
+        {
+            text += string(key) + ':' + Dump(reader) + ';';
+        }
+
+        text += '}';
+        break;
+    }
+
+    case JsonValueType::Array:
+        reader.BeginArray();
+        text += '[';
+
+        while (reader.NextElement())
+        {
+            text += Dump(reader) + ',';
+        }
+
+        text += ']';
+        break;
+
+    case JsonValueType::String:
+        text += '\'' + reader.ReadString() + '\'';
+        break;
+
+    case JsonValueType::Number:
+    {
+        char number[64];
+        snprintf(number, sizeof(number), "%g", reader.ReadNumber());
+        text += number;
+        break;
+    }
+
+    case JsonValueType::Boolean:
+        text += reader.ReadBoolean() ? "true" : "false";
+        break;
+
+    case JsonValueType::Null:
+        text += "raw(" + string(reader.SkipValue()) + ')';
+        break;
+    }
+
+    return text;
+}
+
+static string Read(const string& json)
+{
+    JsonReader reader(json.data(), json.size());
+    string text = Dump(reader);
+    reader.ExpectEnd();
+
+    return text;
+}
+
+TEST(JsonReaderTest, ReadsEveryKindOfValue)
+{
+    EXPECT_EQ(Read(R"( { "a" : [1, -2.5e2, 0, true, false, null, "x\n\u00e9\ud83d\ude00"], "b":{} , "c":[]} )"),
+        "{a:[1,-250,0,true,false,raw(null),'x\n\xc3\xa9\xf0\x9f\x98\x80',];b:{};c:[];}");
+
+    EXPECT_EQ(Read("\xEF\xBB\xBF[1]"), "[1,]");
+    EXPECT_EQ(Read("1e400"), "inf");
+}
+
+class JsonReaderMalformedTest : public testing::TestWithParam<const char*>
+{
+};
+
+TEST_P(JsonReaderMalformedTest, Throws)
+{
+    EXPECT_THROW(Read(GetParam()), Microsoft::glTF::InvalidGLTFException);
+}
+
+INSTANTIATE_TEST_SUITE_P(Documents, JsonReaderMalformedTest, testing::Values(
+    "{\"a\":1,}",
+    "[1,]",
+    "{\"a\" 1}",
+    "01",
+    "1.",
+    "[1 2]",
+    "\"\\ud800\"",
+    "\"abc",
+    "\"a\x01\"",
+    "\"\\q\"",
+    "{} x",
+    "-",
+    "1e",
+    "",
+    "[{]",
+    "nul"));
+
+// Skipped values come back as their text, brackets inside strings included.
+TEST(JsonReaderTest, SkipsValuesAsText)
+{
+    const string json = R"({"ext": {"k":[1,{"z":"}]"}]} , "n":3})";
+
+    JsonReader reader(json.data(), json.size());
+    string_view key;
+
+    reader.BeginObject();
+
+    ASSERT_TRUE(reader.NextMember(&key));
+    EXPECT_EQ(key, "ext");
+    EXPECT_EQ(reader.SkipValue(), R"({"k":[1,{"z":"}]"}]})");
+
+    ASSERT_TRUE(reader.NextMember(&key));
+    EXPECT_EQ(key, "n");
+    EXPECT_EQ(reader.ReadIndex(), 3u);
+
+    EXPECT_FALSE(reader.NextMember(&key));
+    reader.ExpectEnd();
+}
+
+TEST(JsonReaderTest, IndicesAreNonNegativeIntegers)
+{
+    for (const char* json : { "[1.5]", "[-1]", "[1e3]", "[99999999999999999999999]" })
+    {
+        JsonReader reader(json, strlen(json));
+        reader.BeginArray();
+        ASSERT_TRUE(reader.NextElement());
+
+        EXPECT_THROW(reader.ReadIndex(), Microsoft::glTF::InvalidGLTFException) << json;
+    }
+}
+
+TEST(JsonReaderTest, ReportsTheOffsetOfTheProblem)
+{
+    const string json = "[1, 2, x]";
+
+    try
+    {
+        Read(json);
+        FAIL() << "Expected an exception";
+    }
+    catch (const Microsoft::glTF::InvalidGLTFException& exception)
+    {
+        EXPECT_NE(string(exception.what()).find('7'), string::npos) << exception.what();
+    }
+}
+
+// Skipping doesn't recurse, so even absurd nesting can't exhaust the stack.
+TEST(JsonReaderTest, SkipsDeepNestingWithoutRecursion)
+{
+    string json = string(100000, '[') + string(100000, ']');
+
+    JsonReader reader(json.data(), json.size());
+
+    EXPECT_EQ(reader.SkipValue().size(), json.size());
+}
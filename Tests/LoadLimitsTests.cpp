@@ -0,0 +1,274 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "LoadLimits.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// Runs function and returns the limit it failed on.
+template<typename Function>
+static LoadLimit ExpectLimit(const Function& function, uint64_t* pValue = nullptr)
+{
+    try
+    {
+        function();
+    }
+    catch (const LoadLimitException& exception)
+    {
+        if (pValue)
+        {
+            *pValue = exception.Value();
+        }
+
+        return exception.Limit();
+    }
+
+    ADD_FAILURE() << "No limit was hit";
+    return LoadLimit::LoadTime;
+}
+
+// A chain of nodeCount nodes, each the only child of the one before.
+static void AddChain(DocumentLimitChecker& checker, size_t nodeCount)
+{
+    for (size_t node = 0; node < nodeCount; ++node)
+    {
+        checker.AddNode();
+
+        if (node + 1 < nodeCount)
+        {
+            checker.AddChild(node + 1);
+        }
+    }
+}
+
+TEST(DocumentLimitCheckerTest, FailsOnTheFirstNodeOverTheCount)
+{
+    LoadLimits limits;
+    limits.maxNodeCount = 1000;
+
+    DocumentLimitChecker checker(limits);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        checker.AddNode();
+    }
+
+    uint64_t value = 0;
+    EXPECT_EQ(ExpectLimit([&] { checker.AddNode(); }, &value), LoadLimit::NodeCount);
+    EXPECT_EQ(value, 1001u);
+}
+
+// A million nodes deep is checked without recursion, and fails as soon as the path down is
+// one node longer than the limit.
+TEST(DocumentLimitCheckerTest, DeepChainsHitTheDepthLimit)
+{
+    LoadLimits limits;
+    limits.maxHierarchyDepth = 64;
+
+    DocumentLimitChecker checker(limits);
+    AddChain(checker, 1000000);
+
+    uint64_t value = 0;
+    EXPECT_EQ(ExpectLimit([&] { checker.CheckHierarchy(); }, &value), LoadLimit::HierarchyDepth);
+    EXPECT_EQ(value, 65u);
+}
+
+TEST(DocumentLimitCheckerTest, DeepChainsWithinTheLimitsPass)
+{
+    LoadLimits limits;
+    limits.maxNodeCount = 1000000;
+
+    DocumentLimitChecker checker(limits);
+    AddChain(checker, 1000000);
+
+    EXPECT_NO_THROW(checker.CheckHierarchy());
+
+    limits.maxHierarchyDepth = 64;
+
+    DocumentLimitChecker shallow(limits);
+    AddChain(shallow, 64);
+
+    EXPECT_NO_THROW(shallow.CheckHierarchy());
+}
+
+// 60 layers of two nodes, each the parent of both nodes below it: 120 nodes, but 2^61 - 2
+// scene nodes once every path is followed. Each node is only followed once.
+TEST(DocumentLimitCheckerTest, SharedSubtreesCountEveryPath)
+{
+    LoadLimits limits;
+    limits.maxNodeCount = 100000;
+
+    DocumentLimitChecker checker(limits);
+
+    const size_t layerCount = 60;
+
+    for (size_t node = 0; node < layerCount * 2; ++node)
+    {
+        checker.AddNode();
+
+        if (node / 2 + 1 < layerCount)
+        {
+            checker.AddChild((node / 2 + 1) * 2);
+            checker.AddChild((node / 2 + 1) * 2 + 1);
+        }
+    }
+
+    uint64_t value = 0;
+    EXPECT_EQ(ExpectLimit([&] { checker.CheckHierarchy(); }, &value), LoadLimit::NodeCount);
+    EXPECT_GT(value, limits.maxNodeCount);
+    EXPECT_LE(value, 2 * limits.maxNodeCount + 1);
+}
+
+TEST(DocumentLimitCheckerTest, CyclesAreInvalid)
+{
+    LoadLimits limits;
+    limits.maxHierarchyDepth = 1000;
+
+    DocumentLimitChecker loop(limits);
+    loop.AddNode();
+    loop.AddChild(1);
+    loop.AddNode();
+    loop.AddChild(2);
+    loop.AddNode();
+    loop.AddChild(0);
+
+    EXPECT_THROW(loop.CheckHierarchy(), Microsoft::glTF::InvalidGLTFException);
+
+    DocumentLimitChecker self(limits);
+    self.AddNode();
+    self.AddChild(0);
+
+    EXPECT_THROW(self.CheckHierarchy(), Microsoft::glTF::InvalidGLTFException);
+}
+
+TEST(DocumentLimitCheckerTest, ChildrenMustBeNodes)
+{
+    LoadLimits limits;
+    limits.maxNodeCount = 10;
+
+    DocumentLimitChecker checker(limits);
+    checker.AddNode();
+    checker.AddChild(SIZE_MAX);
+
+    EXPECT_THROW(checker.CheckHierarchy(), Microsoft::glTF::InvalidGLTFException);
+}
+
+// Vertex accessors are checked whether the mesh comes before or after the accessor.
+TEST(DocumentLimitCheckerTest, HugeVertexCountsFailWhereverTheyAre)
+{
+    LoadLimits limits;
+    limits.maxPrimitiveVertices = 65536;
+
+    DocumentLimitChecker referencedFirst(limits);
+    referencedFirst.AddVertexAccessor(1);
+    referencedFirst.AddAccessor(100);
+
+    uint64_t value = 0;
+    EXPECT_EQ(ExpectLimit([&] { referencedFirst.AddAccessor(4000000000ull); }, &value), LoadLimit::PrimitiveVertices);
+    EXPECT_EQ(value, 4000000000ull);
+
+    DocumentLimitChecker declaredFirst(limits);
+    declaredFirst.AddAccessor(100);
+    declaredFirst.AddAccessor(UINT64_MAX);
+    declaredFirst.AddVertexAccessor(0);
+
+    EXPECT_EQ(ExpectLimit([&] { declaredFirst.AddVertexAccessor(1); }), LoadLimit::PrimitiveVertices);
+}
+
+// Animation inputs and the like aren't vertices.
+TEST(DocumentLimitCheckerTest, OtherAccessorsArentVertices)
+{
+    LoadLimits limits;
+    limits.maxPrimitiveVertices = 16;
+
+    DocumentLimitChecker checker(limits);
+    checker.AddAccessor(1000000);
+    checker.AddVertexAccessor(1);
+    checker.AddAccessor(16);
+
+    EXPECT_NO_THROW(checker.AddVertexAccessor(7));
+}
+
+TEST(DocumentLimitCheckerTest, NothingIsCheckedWithoutLimits)
+{
+    DocumentLimitChecker checker{ LoadLimits() };
+    checker.AddNode();
+    checker.AddChild(0);
+    checker.AddAccessor(UINT64_MAX);
+    checker.AddVertexAccessor(0);
+
+    EXPECT_NO_THROW(checker.CheckHierarchy());
+}
+
+TEST(LoadLimiterTest, ChargesAreAddedUp)
+{
+    LoadLimits limits;
+    limits.maxDecodedBytes = 1000;
+
+    LoadLimiter limiter(limits);
+    limiter.ChargeDecodedBytes(100, 4);
+    limiter.ChargeDecodedBytes(600);
+
+    EXPECT_EQ(limiter.DecodedBytes(), 1000u);
+
+    uint64_t value = 0;
+    EXPECT_EQ(ExpectLimit([&] { limiter.ChargeDecodedBytes(1); }, &value), LoadLimit::DecodedBytes);
+    EXPECT_EQ(value, 1001u);
+}
+
+// Element counts from the document times their size can be past 64 bits.
+TEST(LoadLimiterTest, OverflowingChargesAreOverTheLimit)
+{
+    LoadLimits limits;
+    limits.maxDecodedBytes = UINT64_MAX - 1;
+
+    LoadLimiter limiter(limits);
+
+    EXPECT_EQ(ExpectLimit([&] { limiter.ChargeDecodedBytes(UINT64_MAX / 2, 16); }), LoadLimit::DecodedBytes);
+
+    LoadLimiter wrapping(limits);
+    wrapping.ChargeDecodedBytes(UINT64_MAX / 2);
+
+    EXPECT_EQ(ExpectLimit([&] { wrapping.ChargeDecodedBytes(UINT64_MAX / 2 + 2); }), LoadLimit::DecodedBytes);
+}
+
+TEST(LoadLimiterTest, ImagesAreCheckedBeforeTheirPixelsAreCharged)
+{
+    LoadLimits limits;
+    limits.maxImagePixels = 4096 * 4096;
+
+    LoadLimiter limiter(limits);
+    limiter.ChargeImage(4096, 4096);
+
+    EXPECT_EQ(limiter.DecodedBytes(), 4096u * 4096u * 4u);
+
+    uint64_t value = 0;
+    EXPECT_EQ(ExpectLimit([&] { limiter.ChargeImage(32768, 32768); }, &value), LoadLimit::ImagePixels);
+    EXPECT_EQ(value, 32768ull * 32768ull);
+    EXPECT_EQ(limiter.DecodedBytes(), 4096u * 4096u * 4u);
+}
+
+TEST(LoadLimiterTest, TimeRunsFromTheStartOfTheLoad)
+{
+    LoadLimits limits;
+    limits.maxLoadTime = chrono::milliseconds(1);
+
+    LoadLimiter limiter(limits);
+    this_thread::sleep_for(chrono::milliseconds(20));
+
+    EXPECT_EQ(ExpectLimit([&] { limiter.CheckTime(); }), LoadLimit::LoadTime);
+    EXPECT_EQ(ExpectLimit([&] { limiter.ChargeDecodedBytes(1); }), LoadLimit::LoadTime);
+}
+
+TEST(LoadLimiterTest, MessagesStartWithTheOptionName)
+{
+    LoadLimitException exception(LoadLimit::HierarchyDepth, 65, 64);
+
+    EXPECT_EQ(string(exception.what()).rfind("MaxHierarchyDepth", 0), 0u) << exception.what();
+}
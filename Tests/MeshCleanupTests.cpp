@@ -0,0 +1,187 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include "MeshCleanup.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// An unindexed grid of c_size x c_size quads, as STL-derived assets come: six vertices per
+// quad with their own normal and color, followed by degenerate triangles and vertices that
+// no triangle uses.
+class MeshCleanupTest : public testing::Test
+{
+protected:
+    static constexpr size_t c_size = 50;
+    static constexpr size_t c_gridIndexCount = c_size * c_size * 6;
+
+    void SetUp() override
+    {
+        for (size_t y = 0; y < c_size; ++y)
+        {
+            for (size_t x = 0; x < c_size; ++x)
+            {
+                const float corners[4][3] = {
+                    { float(x), float(y), 0 },
+                    { float(x + 1), float(y), 0 },
+                    { float(x + 1), float(y + 1), 0 },
+                    { float(x), float(y + 1), 0 } };
+
+                for (size_t corner : { 0, 1, 2, 0, 2, 3 })
+                {
+                    AddVertex(corners[corner], 0xffffffff);
+                }
+            }
+        }
+
+        // Collinear, two coincident corners and a point.
+        const float degenerate[9][3] = {
+            { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 },
+            { 5, 5, 0 }, { 5, 5, 0 }, { 6, 6, 0 },
+            { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+
+        for (const auto& position : degenerate)
+        {
+            AddVertex(position, 0xffffffff);
+        }
+
+        m_indices.resize(m_positions.size() / 3);
+        iota(m_indices.begin(), m_indices.end(), uint16_t(0));
+
+        const float unused[3] = { 9, 9, 9 };
+
+        for (size_t i = 0; i < 5; ++i)
+        {
+            AddVertex(unused, 1);
+        }
+    }
+
+    void AddVertex(const float* position, uint32_t color)
+    {
+        m_positions.insert(m_positions.end(), position, position + 3);
+        m_normals.insert(m_normals.end(), { 0, 0, 1 });
+        m_colors.push_back(color);
+    }
+
+    vector<uint32_t> CleanUp(const vector<float>& positions, const vector<uint32_t>& colors, float tolerance)
+    {
+        const MeshStream streams[] = {
+            { reinterpret_cast<const uint8_t*>(positions.data()), 12, true },
+            { reinterpret_cast<const uint8_t*>(m_normals.data()), 12, true },
+            { reinterpret_cast<const uint8_t*>(colors.data()), 4, false } };
+
+        m_cleanIndices = m_indices;
+        size_t indexCount = m_cleanIndices.size();
+
+        auto sources = CleanUpMesh(streams, size(streams), 0, positions.size() / 3, m_cleanIndices.data(), &indexCount, tolerance);
+        m_cleanIndices.resize(indexCount);
+
+        return sources;
+    }
+
+    vector<float> m_positions;
+    vector<float> m_normals;
+    vector<uint32_t> m_colors;
+    vector<uint16_t> m_indices;
+    vector<uint16_t> m_cleanIndices;
+};
+
+TEST_F(MeshCleanupTest, WeldsIdenticalVerticesAndDropsTheRest)
+{
+    auto sources = CleanUp(m_positions, m_colors, 0.0f);
+
+    EXPECT_EQ(sources.size(), (c_size + 1) * (c_size + 1));
+    EXPECT_EQ(m_cleanIndices.size(), c_gridIndexCount);
+}
+
+TEST_F(MeshCleanupTest, KeepsTheTrianglesInOrder)
+{
+    auto sources = CleanUp(m_positions, m_colors, 0.0f);
+    ASSERT_EQ(m_cleanIndices.size(), c_gridIndexCount);
+
+    for (size_t i = 0; i < c_gridIndexCount; ++i)
+    {
+        ASSERT_LT(m_cleanIndices[i], sources.size());
+        ASSERT_EQ(memcmp(&m_positions[m_indices[i] * 3], &m_positions[sources[m_cleanIndices[i]] * 3], 12), 0) << "index " << i;
+    }
+}
+
+TEST_F(MeshCleanupTest, NumbersVerticesInTheOrderTrianglesUseThem)
+{
+    auto sources = CleanUp(m_positions, m_colors, 0.0f);
+    uint32_t next = 0;
+
+    for (uint16_t index : m_cleanIndices)
+    {
+        ASSERT_LE(index, next);
+        next = max<uint32_t>(next, index + 1u);
+    }
+
+    EXPECT_EQ(next, sources.size());
+}
+
+TEST_F(MeshCleanupTest, WeldsWithinTheTolerance)
+{
+    vector<float> jittered = m_positions;
+
+    for (size_t i = 0; i < jittered.size(); ++i)
+    {
+        jittered[i] += ((i * 7919) % 13) * 1e-6f;
+    }
+
+    auto welded = CleanUp(jittered, m_colors, 1e-4f);
+    EXPECT_EQ(welded.size(), (c_size + 1) * (c_size + 1));
+
+    // The jitter turns the collinear triangle into a sliver, which has some area.
+    EXPECT_EQ(m_cleanIndices.size(), c_gridIndexCount + 3);
+
+    auto exact = CleanUp(jittered, m_colors, 0.0f);
+    EXPECT_GT(exact.size(), welded.size());
+}
+
+TEST_F(MeshCleanupTest, KeepsVerticesThatDifferInAnotherStream)
+{
+    vector<uint32_t> colors = m_colors;
+
+    for (size_t i = 0; i < colors.size(); i += 2)
+    {
+        colors[i] = 0x12345678;
+    }
+
+    auto sources = CleanUp(m_positions, colors, 0.5f);
+    EXPECT_GT(sources.size(), (c_size + 1) * (c_size + 1));
+
+    for (size_t i = 0; i < m_cleanIndices.size(); ++i)
+    {
+        ASSERT_EQ(colors[m_indices[i]], colors[sources[m_cleanIndices[i]]]) << "index " << i;
+    }
+}
+
+TEST_F(MeshCleanupTest, SurvivesNonFinitePositionsAndTinyTolerances)
+{
+    vector<float> positions = m_positions;
+    positions[0] = NAN;
+    positions[3] = 1e30f;
+    positions[7] = -INFINITY;
+
+    auto sources = CleanUp(positions, m_colors, 1e-30f);
+
+    for (uint16_t index : m_cleanIndices)
+    {
+        ASSERT_LT(index, sources.size());
+    }
+}
+
+TEST_F(MeshCleanupTest, NoIndicesLeaveNoVertices)
+{
+    m_indices.clear();
+
+    EXPECT_TRUE(CleanUp(m_positions, m_colors, 0.0f).empty());
+    EXPECT_TRUE(m_cleanIndices.empty());
+}
@@ -0,0 +1,508 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <map>
+
+#include "MeshSimplifier.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+struct TestMesh
+{
+    vector<float> positions;
+    vector<float> texCoords;
+    vector<uint16_t> indices;
+
+    size_t VertexCount() const { return positions.size() / 3; }
+    const float* Position(size_t vertex) const { return &positions[vertex * 3]; }
+};
+
+// size x size quads in the z = height(x, y) surface, texture coordinates across the whole grid.
+template<typename Height>
+static TestMesh MakeGrid(int size, const Height& height)
+{
+    TestMesh mesh;
+
+    for (int y = 0; y <= size; ++y)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            mesh.positions.insert(mesh.positions.end(), { float(x), float(y), height(x, y) });
+            mesh.texCoords.insert(mesh.texCoords.end(), { float(x) / size, float(y) / size });
+        }
+    }
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            uint16_t a = static_cast<uint16_t>(y * (size + 1) + x);
+            uint16_t b = static_cast<uint16_t>(a + 1);
+            uint16_t c = static_cast<uint16_t>(a + size + 1);
+            uint16_t d = static_cast<uint16_t>(c + 1);
+
+            mesh.indices.insert(mesh.indices.end(), { a, b, d, a, d, c });
+        }
+    }
+
+    return mesh;
+}
+
+// A closed unit sphere, counter-clockwise from outside. With a seam the first column is
+// repeated at the end with other texture coordinates, as exporters write it.
+static TestMesh MakeSphere(int columns, int rows, bool hasSeam)
+{
+    const float pi = 3.14159265358979f;
+    const int vertexColumns = hasSeam ? columns + 1 : columns;
+
+    TestMesh mesh;
+
+    for (int row = 0; row <= rows; ++row)
+    {
+        for (int column = 0; column < vertexColumns; ++column)
+        {
+            float theta = pi * row / rows;
+            float phi = 2 * pi * (column % columns) / columns;
+
+            // The poles are one point, however many vertices they have.
+            float ring = (row == 0 || row == rows) ? 0.0f : sinf(theta);
+
+            mesh.positions.insert(mesh.positions.end(), { ring * cosf(phi), ring * sinf(phi), cosf(theta) });
+            mesh.texCoords.insert(mesh.texCoords.end(), { float(column) / columns, float(row) / rows });
+        }
+    }
+
+    auto vertex = [&](int row, int column)
+    {
+        return static_cast<uint16_t>(row * vertexColumns + (hasSeam ? column : column % columns));
+    };
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            uint16_t a = vertex(row, column);
+            uint16_t b = vertex(row, column + 1);
+            uint16_t c = vertex(row + 1, column);
+            uint16_t d = vertex(row + 1, column + 1);
+
+            if (row > 0)
+            {
+                mesh.indices.insert(mesh.indices.end(), { a, c, b });
+            }
+
+            if (row < rows - 1)
+            {
+                mesh.indices.insert(mesh.indices.end(), { b, c, d });
+            }
+        }
+    }
+
+    return mesh;
+}
+
+// A unit octahedron whose triangles are split in four levels times, with the new vertices
+// pushed out onto the sphere: closed, and without any two vertices at the same position.
+static TestMesh MakeGeosphere(int levels)
+{
+    TestMesh mesh;
+    mesh.positions = { 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1 };
+    mesh.indices = { 0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4, 2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5 };
+
+    for (int level = 0; level < levels; ++level)
+    {
+        map<pair<uint16_t, uint16_t>, uint16_t> midpoints;
+        vector<uint16_t> indices;
+
+        auto midpoint = [&](uint16_t a, uint16_t b)
+        {
+            auto inserted = midpoints.emplace(make_pair(min(a, b), max(a, b)), static_cast<uint16_t>(mesh.VertexCount()));
+
+            if (inserted.second)
+            {
+                float p[3];
+
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    p[i] = mesh.Position(a)[i] + mesh.Position(b)[i];
+                }
+
+                float length = sqrtf(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+                mesh.positions.insert(mesh.positions.end(), { p[0] / length, p[1] / length, p[2] / length });
+            }
+
+            return inserted.first->second;
+        };
+
+        for (size_t i = 0; i < mesh.indices.size(); i += 3)
+        {
+            uint16_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+            uint16_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+
+            indices.insert(indices.end(), { a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca });
+        }
+
+        mesh.indices = move(indices);
+    }
+
+    return mesh;
+}
+
+static void Subtract(const float* a, const float* b, double* pResult)
+{
+    for (size_t i = 0; i < 3; ++i)
+    {
+        pResult[i] = double(a[i]) - b[i];
+    }
+}
+
+static double Dot(const double* a, const double* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void Cross(const double* a, const double* b, double* pResult)
+{
+    pResult[0] = a[1] * b[2] - a[2] * b[1];
+    pResult[1] = a[2] * b[0] - a[0] * b[2];
+    pResult[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static void TriangleNormal(const TestMesh& mesh, const uint16_t* triangle, double* pNormal)
+{
+    double e1[3], e2[3];
+    Subtract(mesh.Position(triangle[1]), mesh.Position(triangle[0]), e1);
+    Subtract(mesh.Position(triangle[2]), mesh.Position(triangle[0]), e2);
+    Cross(e1, e2, pNormal);
+}
+
+// Squared distance from p to the triangle abc, from the closest point of the Voronoi region p is in.
+static double SquaredDistanceToTriangle(const float* p, const float* a, const float* b, const float* c)
+{
+    double ab[3], ac[3], ap[3];
+    Subtract(b, a, ab);
+    Subtract(c, a, ac);
+    Subtract(p, a, ap);
+
+    double d1 = Dot(ab, ap), d2 = Dot(ac, ap);
+    double closest[3];
+
+    auto at = [&](double v, double w)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            closest[i] = ab[i] * v + ac[i] * w;
+        }
+    };
+
+    double bp[3], cp[3];
+    Subtract(p, b, bp);
+    Subtract(p, c, cp);
+
+    double d3 = Dot(ab, bp), d4 = Dot(ac, bp);
+    double d5 = Dot(ab, cp), d6 = Dot(ac, cp);
+    double va = d3 * d6 - d5 * d4, vb = d5 * d2 - d1 * d6, vc = d1 * d4 - d3 * d2;
+
+    if (d1 <= 0 && d2 <= 0) at(0, 0);
+    else if (d3 >= 0 && d4 <= d3) at(1, 0);
+    else if (d6 >= 0 && d5 <= d6) at(0, 1);
+    else if (vc <= 0 && d1 >= 0 && d3 <= 0) at(d1 / (d1 - d3), 0);
+    else if (vb <= 0 && d2 >= 0 && d6 <= 0) at(0, d2 / (d2 - d6));
+    else if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0)
+    {
+        double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        at(1 - w, w);
+    }
+    else
+    {
+        double denominator = 1 / (va + vb + vc);
+        at(vb * denominator, vc * denominator);
+    }
+
+    double offset[3];
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        offset[i] = ap[i] - closest[i];
+    }
+
+    return Dot(offset, offset);
+}
+
+// How far the original vertices are from the simplified surface, relative to the largest
+// extent of the mesh as SimplifyResult::error is: a one-sided Hausdorff distance.
+static double MeasureError(const TestMesh& mesh, const uint16_t* indices, size_t indexCount)
+{
+    float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+    for (size_t vertex = 0; vertex < mesh.VertexCount(); ++vertex)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            minimum[i] = min(minimum[i], mesh.Position(vertex)[i]);
+            maximum[i] = max(maximum[i], mesh.Position(vertex)[i]);
+        }
+    }
+
+    double largest = 0.0;
+
+    for (size_t vertex = 0; vertex < mesh.VertexCount(); ++vertex)
+    {
+        double nearest = DBL_MAX;
+
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            nearest = min(nearest, SquaredDistanceToTriangle(
+                mesh.Position(vertex), mesh.Position(indices[i]), mesh.Position(indices[i + 1]), mesh.Position(indices[i + 2])));
+        }
+
+        largest = max(largest, nearest);
+    }
+
+    float extent = max(max(maximum[0] - minimum[0], maximum[1] - minimum[1]), maximum[2] - minimum[2]);
+
+    return sqrt(largest) / extent;
+}
+
+// Edges with no twin going the other way, between vertices identified by their position, so
+// that a seam doesn't count as open.
+static size_t CountOpenEdges(const TestMesh& mesh, const uint16_t* indices, size_t indexCount)
+{
+    map<tuple<float, float, float>, size_t> positionIds;
+    multiset<pair<size_t, size_t>> edges;
+
+    auto positionId = [&](uint16_t vertex)
+    {
+        const float* p = mesh.Position(vertex);
+        return positionIds.emplace(make_tuple(p[0], p[1], p[2]), positionIds.size()).first->second;
+    };
+
+    for (size_t i = 0; i < indexCount; i += 3)
+    {
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            edges.emplace(positionId(indices[i + corner]), positionId(indices[i + (corner + 1) % 3]));
+        }
+    }
+
+    size_t openEdgeCount = 0;
+
+    for (const auto& edge : edges)
+    {
+        openEdgeCount += edges.count({ edge.second, edge.first }) ? 0 : 1;
+    }
+
+    return openEdgeCount;
+}
+
+TEST(MeshSimplifierTest, FlatGridKeepsItsShapeAndBorder)
+{
+    const int size = 60;
+    TestMesh mesh = MakeGrid(size, [](int, int) { return 0.0f; });
+    const SimplifierAttribute texCoords = { mesh.texCoords.data(), 2, 0.5f };
+
+    auto result = SimplifyMesh(mesh.positions.data(), mesh.VertexCount(), &texCoords, 1, mesh.indices.data(), mesh.indices.size(), mesh.indices.size() / 10);
+
+    EXPECT_LE(result.indexCount, mesh.indices.size() / 4);
+    EXPECT_NEAR(result.error, 0.0f, 1e-5f);
+
+    vector<bool> isUsed(mesh.VertexCount());
+    double area = 0.0;
+
+    for (size_t i = 0; i < result.indexCount; i += 3)
+    {
+        double normal[3];
+        TriangleNormal(mesh, &mesh.indices[i], normal);
+
+        ASSERT_GT(normal[2], 0.0) << "triangle " << i / 3 << " flipped or vanished";
+        area += normal[2] / 2;
+
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            isUsed[mesh.indices[i + corner]] = true;
+        }
+    }
+
+    EXPECT_NEAR(area, size * size, 1e-3);
+
+    for (int y = 0; y <= size; ++y)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            if (x == 0 || y == 0 || x == size || y == size)
+            {
+                EXPECT_TRUE(isUsed[y * (size + 1) + x]) << "border vertex " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST(MeshSimplifierTest, ReachesTheTarget)
+{
+    TestMesh mesh = MakeGrid(40, [](int x, int y) { return sinf(x * 0.3f) * cosf(y * 0.2f); });
+
+    for (size_t target : { mesh.indices.size(), mesh.indices.size() / 2, mesh.indices.size() / 8 })
+    {
+        vector<uint16_t> indices = mesh.indices;
+        auto result = SimplifyMesh(mesh.positions.data(), mesh.VertexCount(), nullptr, 0, indices.data(), indices.size(), target);
+
+        EXPECT_LE(result.indexCount, target);
+        EXPECT_GT(result.indexCount, target * 9 / 10);
+        EXPECT_EQ(result.indexCount % 3, 0u);
+
+        if (target == mesh.indices.size())
+        {
+            EXPECT_EQ(result.error, 0.0f);
+        }
+
+        for (size_t i = 0; i < result.indexCount; ++i)
+        {
+            ASSERT_LT(indices[i], mesh.VertexCount());
+        }
+    }
+}
+
+enum class SphereKind
+{
+    UV,
+    UVWithSeam,
+    Geosphere,
+};
+
+struct SphereCase
+{
+    const char* name;
+    SphereKind kind;
+    size_t reduction;
+    double maxError;
+};
+
+class MeshSimplifierSphereTest : public testing::TestWithParam<SphereCase>
+{
+protected:
+    static TestMesh MakeMesh(SphereKind kind)
+    {
+        return (kind == SphereKind::Geosphere) ? MakeGeosphere(5) : MakeSphere(80, 40, kind == SphereKind::UVWithSeam);
+    }
+};
+
+// The simplified sphere stays closed, seams included, faces outwards, keeps its volume, and
+// the original vertices are about as far from it as the simplifier says. The reported error is
+// the distance to the planes of the quadrics, so the distance to the surface can be a bit more.
+TEST_P(MeshSimplifierSphereTest, StaysClosedAndClose)
+{
+    TestMesh mesh = MakeMesh(GetParam().kind);
+    const SimplifierAttribute texCoords = { mesh.texCoords.data(), 2, 0.5f };
+    const size_t attributeCount = mesh.texCoords.empty() ? 0 : 1;
+    const size_t targetIndexCount = mesh.indices.size() / GetParam().reduction;
+
+    auto result = SimplifyMesh(mesh.positions.data(), mesh.VertexCount(), &texCoords, attributeCount, mesh.indices.data(), mesh.indices.size(), targetIndexCount);
+
+    EXPECT_LE(result.indexCount, targetIndexCount);
+    EXPECT_GT(result.indexCount, targetIndexCount * 9 / 10);
+    EXPECT_EQ(CountOpenEdges(mesh, mesh.indices.data(), result.indexCount), 0u);
+
+    double volume = 0.0;
+
+    for (size_t i = 0; i < result.indexCount; i += 3)
+    {
+        double normal[3], center[3] = {};
+        TriangleNormal(mesh, &mesh.indices[i], normal);
+
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            for (size_t component = 0; component < 3; ++component)
+            {
+                center[component] += mesh.Position(mesh.indices[i + corner])[component] / 3.0;
+            }
+        }
+
+        ASSERT_GT(Dot(normal, center), 0.0) << "triangle " << i / 3 << " faces inwards";
+        volume += Dot(normal, center) / 6;
+    }
+
+    const double sphereVolume = 4.0 / 3.0 * 3.14159265358979;
+    const double measuredError = MeasureError(mesh, mesh.indices.data(), result.indexCount);
+
+    EXPECT_NEAR(volume / sphereVolume, 1.0, 0.1);
+    EXPECT_LT(measuredError, GetParam().maxError);
+    EXPECT_LE(measuredError, 1.25 * result.error);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Spheres,
+    MeshSimplifierSphereTest,
+    testing::Values(
+        SphereCase{ "UV", SphereKind::UV, 8, 0.05 },
+        SphereCase{ "UVWithSeam", SphereKind::UVWithSeam, 8, 0.05 },
+        SphereCase{ "Geosphere", SphereKind::Geosphere, 8, 0.02 },
+        SphereCase{ "GeosphereMuchSmaller", SphereKind::Geosphere, 32, 0.04 }),
+    [](const testing::TestParamInfo<SphereCase>& info) { return string(info.param.name); });
+
+// Closed meshes keep their volume: collapsing any edge of a tetrahedron would leave two
+// triangles back to back, so simplifying stops there.
+TEST(MeshSimplifierTest, ClosedMeshesStopAtATetrahedron)
+{
+    for (int levels = 0; levels < 4; ++levels)
+    {
+        TestMesh mesh = MakeGeosphere(levels);
+
+        auto result = SimplifyMesh(mesh.positions.data(), mesh.VertexCount(), nullptr, 0, mesh.indices.data(), mesh.indices.size(), 0);
+
+        EXPECT_EQ(result.indexCount, 12u) << "levels " << levels;
+        EXPECT_EQ(CountOpenEdges(mesh, mesh.indices.data(), result.indexCount), 0u) << "levels " << levels;
+    }
+}
+
+// Simplifying further moves the surface further, and the reported error says so.
+TEST(MeshSimplifierTest, ErrorGrowsWithTheReduction)
+{
+    TestMesh mesh = MakeGrid(50, [](int x, int y) { return 5.0f * sinf(x * 0.1f) * cosf(y * 0.1f); });
+
+    float previousError = 0.0f;
+    double previousMeasuredError = 0.0;
+
+    for (size_t reduction : { 4, 16, 64 })
+    {
+        vector<uint16_t> indices = mesh.indices;
+        auto result = SimplifyMesh(mesh.positions.data(), mesh.VertexCount(), nullptr, 0, indices.data(), indices.size(), indices.size() / reduction);
+        double measuredError = MeasureError(mesh, indices.data(), result.indexCount);
+
+        EXPECT_GE(result.error, previousError) << "reduction " << reduction;
+        EXPECT_GE(measuredError, previousMeasuredError * 0.9) << "reduction " << reduction;
+        EXPECT_LE(measuredError, 1.25 * result.error) << "reduction " << reduction;
+
+        previousError = result.error;
+        previousMeasuredError = measuredError;
+    }
+}
+
+// Collapses that cost texture coordinates are avoided while cheaper ones remain: with the
+// coordinates weighted, the folded grid keeps more of its texture mapping.
+TEST(MeshSimplifierTest, WeightedAttributesAreKept)
+{
+    TestMesh mesh = MakeGrid(40, [](int, int) { return 0.0f; });
+
+    // Texture coordinates that are anything but linear across the flat grid.
+    for (size_t vertex = 0; vertex < mesh.VertexCount(); ++vertex)
+    {
+        mesh.texCoords[vertex * 2] = sinf(mesh.Position(vertex)[0] * 0.7f) * 0.5f;
+    }
+
+    auto keptIndexCount = [&](float weight)
+    {
+        vector<uint16_t> indices = mesh.indices;
+        const SimplifierAttribute texCoords = { mesh.texCoords.data(), 2, weight };
+
+        auto result = SimplifyMesh(mesh.positions.data(), mesh.VertexCount(), &texCoords, 1, indices.data(), indices.size(), indices.size() / 20);
+        return result.indexCount;
+    };
+
+    EXPECT_GT(keptIndexCount(1.0f), keptIndexCount(0.0f));
+}
@@ -0,0 +1,270 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "NormalGenerator.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static float Dot3(const float* a, const float* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// The quad (0,0,0)-(1,1,0) facing +Z as two indexed triangles.
+static const float c_quadPositions[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+static const float c_quadNormals[] = { 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1 };
+static const uint16_t c_quadIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+// A UV sphere of unit radius, counter-clockwise from outside. The first and last column
+// are at the same positions with different texture coordinates, as exporters write seams.
+class NormalGeneratorSphereTest : public testing::Test
+{
+protected:
+    static constexpr int c_rows = 24;
+    static constexpr int c_columns = 48;
+
+    void SetUp() override
+    {
+        const float pi = 3.14159265358979f;
+
+        for (int row = 0; row <= c_rows; ++row)
+        {
+            for (int column = 0; column <= c_columns; ++column)
+            {
+                float theta = pi * row / c_rows;
+                float phi = 2 * pi * (column % c_columns) / c_columns;
+
+                m_positions.insert(m_positions.end(), { sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi) });
+                m_texCoords.insert(m_texCoords.end(), { static_cast<float>(column) / c_columns, static_cast<float>(row) / c_rows });
+            }
+        }
+
+        for (int row = 0; row < c_rows; ++row)
+        {
+            for (int column = 0; column < c_columns; ++column)
+            {
+                uint16_t a = static_cast<uint16_t>(row * (c_columns + 1) + column);
+                uint16_t b = static_cast<uint16_t>(a + 1);
+                uint16_t c = static_cast<uint16_t>(a + c_columns + 1);
+                uint16_t d = static_cast<uint16_t>(c + 1);
+
+                m_indices.insert(m_indices.end(), { a, b, c, b, d, c });
+            }
+        }
+
+        m_vertexCount = m_positions.size() / 3;
+        m_normals.resize(m_vertexCount * 3);
+
+        GenerateSmoothNormals(m_positions.data(), m_vertexCount, m_indices.data(), m_indices.size(), m_normals.data());
+    }
+
+    size_t Vertex(int row, int column) const
+    {
+        return static_cast<size_t>(row) * (c_columns + 1) + column;
+    }
+
+    vector<float> m_positions;
+    vector<float> m_texCoords;
+    vector<uint16_t> m_indices;
+    size_t m_vertexCount = 0;
+    vector<float> m_normals;
+};
+
+TEST(NormalGeneratorTest, FlatNormalsFollowTheWinding)
+{
+    const float positions[] = {
+        0, 0, 0, 1, 0, 0, 0, 1, 0,
+        0, 0, 0, 0, 1, 0, 1, 0, 0 };
+    float normals[18];
+
+    GenerateFlatNormals(positions, 6, normals);
+
+    for (size_t vertex = 0; vertex < 6; ++vertex)
+    {
+        EXPECT_FLOAT_EQ(normals[vertex * 3 + 0], 0.0f);
+        EXPECT_FLOAT_EQ(normals[vertex * 3 + 1], 0.0f);
+        EXPECT_FLOAT_EQ(normals[vertex * 3 + 2], vertex < 3 ? 1.0f : -1.0f);
+    }
+}
+
+TEST(NormalGeneratorTest, FlatNormalsOfDegenerateTrianglesAndLeftoversAreUp)
+{
+    // A point, a line and a vertex that belongs to no whole triangle.
+    const float positions[] = {
+        2, 2, 2, 2, 2, 2, 2, 2, 2,
+        0, 0, 0, 1, 1, 1, 2, 2, 2,
+        5, 5, 5 };
+    float normals[21];
+
+    GenerateFlatNormals(positions, 7, normals);
+
+    for (size_t vertex = 0; vertex < 7; ++vertex)
+    {
+        EXPECT_EQ(normals[vertex * 3 + 0], 0.0f);
+        EXPECT_EQ(normals[vertex * 3 + 1], 0.0f);
+        EXPECT_EQ(normals[vertex * 3 + 2], 1.0f);
+    }
+}
+
+TEST(NormalGeneratorTest, SmoothNormalsAreWeightedByArea)
+{
+    // A big triangle facing +Z and a small one facing +X share vertex 0.
+    const float positions[] = {
+        0, 0, 0, 4, 0, 0, 0, 4, 0,
+        0, 1, 0, 0, 0, 1 };
+    const uint16_t indices[] = { 0, 1, 2, 0, 3, 4 };
+    float normals[15];
+
+    GenerateSmoothNormals(positions, 5, indices, 6, normals);
+
+    // Areas 8 and 0.5.
+    float length = sqrtf(8.0f * 8.0f + 0.5f * 0.5f);
+
+    EXPECT_NEAR(normals[0], 0.5f / length, 1e-5f);
+    EXPECT_NEAR(normals[1], 0.0f, 1e-5f);
+    EXPECT_NEAR(normals[2], 8.0f / length, 1e-5f);
+    EXPECT_NEAR(normals[5], 1.0f, 1e-5f);
+    EXPECT_NEAR(normals[9], 1.0f, 1e-5f);
+}
+
+TEST(NormalGeneratorTest, SmoothNormalsWithoutIndicesAreFlat)
+{
+    float normals[12];
+
+    GenerateSmoothNormals(c_quadPositions, 3, nullptr, 3, normals);
+
+    for (size_t vertex = 0; vertex < 3; ++vertex)
+    {
+        EXPECT_NEAR(normals[vertex * 3 + 2], 1.0f, 1e-6f);
+    }
+}
+
+TEST(NormalGeneratorTest, VerticesWithoutTrianglesGetUp)
+{
+    float normals[12];
+
+    GenerateSmoothNormals(c_quadPositions, 4, c_quadIndices, 3, normals);
+
+    EXPECT_EQ(normals[9], 0.0f);
+    EXPECT_EQ(normals[10], 0.0f);
+    EXPECT_EQ(normals[11], 1.0f);
+}
+
+TEST_F(NormalGeneratorSphereTest, SmoothNormalsPointOutOfTheSphere)
+{
+    for (size_t vertex = 0; vertex < m_vertexCount; ++vertex)
+    {
+        ASSERT_GT(Dot3(&m_normals[vertex * 3], &m_positions[vertex * 3]), 0.99f) << "vertex " << vertex;
+    }
+}
+
+TEST_F(NormalGeneratorSphereTest, SeamsAreSmoothedTogether)
+{
+    for (int row = 0; row <= c_rows; ++row)
+    {
+        const float* first = &m_normals[Vertex(row, 0) * 3];
+        const float* last = &m_normals[Vertex(row, c_columns) * 3];
+
+        for (int component = 0; component < 3; ++component)
+        {
+            EXPECT_NEAR(first[component], last[component], 1e-5f) << "row " << row;
+        }
+    }
+}
+
+TEST_F(NormalGeneratorSphereTest, TangentsAreUnitPerpendicularAndAlongU)
+{
+    vector<float> tangents(m_vertexCount * 4);
+    GenerateTangents(m_positions.data(), m_normals.data(), m_texCoords.data(), m_vertexCount, m_indices.data(), m_indices.size(), tangents.data());
+
+    const float pi = 3.14159265358979f;
+
+    // The poles have no direction of increasing U; everywhere else it is +phi.
+    for (int row = 1; row < c_rows; ++row)
+    {
+        for (int column = 0; column <= c_columns; ++column)
+        {
+            size_t vertex = Vertex(row, column);
+            const float* tangent = &tangents[vertex * 4];
+            float phi = 2 * pi * (column % c_columns) / c_columns;
+            const float alongU[] = { -sinf(phi), 0.0f, cosf(phi) };
+
+            ASSERT_NEAR(Dot3(tangent, tangent), 1.0f, 1e-3f) << "vertex " << vertex;
+            ASSERT_NEAR(Dot3(tangent, &m_normals[vertex * 3]), 0.0f, 1e-3f) << "vertex " << vertex;
+            ASSERT_GT(Dot3(tangent, alongU), 0.99f) << "vertex " << vertex;
+            ASSERT_EQ(fabsf(tangent[3]), 1.0f) << "vertex " << vertex;
+        }
+    }
+}
+
+struct TangentCase
+{
+    const char* name;
+    float texCoords[8];
+    float tangentX;
+    float handedness;
+};
+
+class NormalGeneratorTangentTest : public testing::TestWithParam<TangentCase>
+{
+};
+
+TEST_P(NormalGeneratorTangentTest, TangentFollowsTheTextureCoordinates)
+{
+    float tangents[16];
+
+    GenerateTangents(c_quadPositions, c_quadNormals, GetParam().texCoords, 4, c_quadIndices, 6, tangents);
+
+    for (size_t vertex = 0; vertex < 4; ++vertex)
+    {
+        EXPECT_NEAR(tangents[vertex * 4 + 0], GetParam().tangentX, 1e-5f) << "vertex " << vertex;
+        EXPECT_NEAR(tangents[vertex * 4 + 1], 0.0f, 1e-5f) << "vertex " << vertex;
+        EXPECT_NEAR(tangents[vertex * 4 + 2], 0.0f, 1e-5f) << "vertex " << vertex;
+        EXPECT_EQ(tangents[vertex * 4 + 3], GetParam().handedness) << "vertex " << vertex;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Mappings,
+    NormalGeneratorTangentTest,
+    testing::Values(
+        TangentCase{ "Straight", { 0, 0, 1, 0, 1, 1, 0, 1 }, 1.0f, 1.0f },
+        TangentCase{ "MirroredU", { 1, 0, 0, 0, 0, 1, 1, 1 }, -1.0f, -1.0f },
+        TangentCase{ "FlippedV", { 0, 1, 1, 1, 1, 0, 0, 0 }, 1.0f, -1.0f }),
+    [](const testing::TestParamInfo<TangentCase>& info) { return string(info.param.name); });
+
+TEST(NormalGeneratorTest, TangentsWithoutTextureDirectionArePerpendicular)
+{
+    const float texCoords[8] = {};
+    float tangents[16];
+
+    GenerateTangents(c_quadPositions, c_quadNormals, texCoords, 4, c_quadIndices, 6, tangents);
+
+    for (size_t vertex = 0; vertex < 4; ++vertex)
+    {
+        const float* tangent = &tangents[vertex * 4];
+
+        EXPECT_NEAR(Dot3(tangent, tangent), 1.0f, 1e-5f) << "vertex " << vertex;
+        EXPECT_NEAR(Dot3(tangent, &c_quadNormals[vertex * 3]), 0.0f, 1e-5f) << "vertex " << vertex;
+    }
+}
+
+TEST(NormalGeneratorTest, TangentsOfZeroNormalsAreFinite)
+{
+    const float normals[12] = {};
+    const float texCoords[8] = {};
+    float tangents[16];
+
+    GenerateTangents(c_quadPositions, normals, texCoords, 4, c_quadIndices, 6, tangents);
+
+    for (float value : tangents)
+    {
+        EXPECT_TRUE(isfinite(value));
+    }
+}
@@ -0,0 +1,159 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <random>
+
+#include "Benchmark.h"
+#include "PickIndex.h"
+
+using namespace std;
+using namespace SceneLoader;
+using namespace SceneLoaderBenchmark;
+
+// Small triangles scattered through a cube of the given half size around the origin.
+static vector<float> ScatterTriangles(mt19937& random, size_t count, float halfSize, float triangleSize)
+{
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<float> positions(count * 9);
+
+    for (size_t t = 0; t < count; ++t)
+    {
+        const float center[3] = { value(random) * halfSize, value(random) * halfSize, value(random) * halfSize };
+
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                positions[t * 9 + corner * 3 + axis] = center[axis] + value(random) * triangleSize;
+            }
+        }
+    }
+
+    return positions;
+}
+
+// Rays from outside the scene towards points inside it.
+static vector<float> RandomRays(mt19937& random, size_t count, float reach)
+{
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<float> rays(count * 6);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            rays[i * 6 + axis] = value(random) * reach * 3.0f;
+            rays[i * 6 + 3 + axis] = value(random) * reach - rays[i * 6 + axis];
+        }
+    }
+
+    return rays;
+}
+
+static void MeasurePicks(const char* name, const PickIndex& index, const vector<float>& rays)
+{
+    const size_t rayCount = rays.size() / 6;
+    size_t hitCount = 0;
+
+    double seconds = MeasureSeconds(3, [&]()
+    {
+        hitCount = 0;
+
+        for (size_t i = 0; i < rayCount; ++i)
+        {
+            PickHit hit;
+            hitCount += index.Pick(&rays[i * 6], &rays[i * 6 + 3], &hit) ? 1 : 0;
+        }
+    });
+
+    ReportRate((string(name) + ", one thread").c_str(), static_cast<double>(rayCount), "rays", seconds);
+
+    const size_t threadCount = max(1u, thread::hardware_concurrency());
+
+    seconds = MeasureSeconds(3, [&]()
+    {
+        concurrency::parallel_for(size_t(0), threadCount, [&](size_t t)
+        {
+            for (size_t i = t; i < rayCount; i += threadCount)
+            {
+                PickHit hit;
+                index.Pick(&rays[i * 6], &rays[i * 6 + 3], &hit);
+            }
+        });
+    });
+
+    ReportRate((string(name) + ", " + to_string(threadCount) + " threads").c_str(), static_cast<double>(rayCount), "rays", seconds);
+    printf("    %zu of %zu rays hit\n", hitCount, rayCount);
+}
+
+// Building and querying a PickIndex: a million triangles drawn once, in 16 primitives, and
+// 10000 instances of a mesh of 1000 triangles.
+int main()
+{
+    mt19937 random(1);
+    const vector<float> identity = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+    const size_t primitiveCount = 16;
+    const size_t primitiveTriangleCount = 65536;
+
+    vector<vector<float>> primitives;
+
+    for (size_t primitive = 0; primitive < primitiveCount; ++primitive)
+    {
+        primitives.push_back(ScatterTriangles(random, primitiveTriangleCount, 100.0f, 0.5f));
+    }
+
+    shared_ptr<const PickIndex> sceneIndex;
+
+    double seconds = MeasureSeconds(3, [&]()
+    {
+        PickIndexBuilder builder;
+
+        for (size_t primitive = 0; primitive < primitiveCount; ++primitive)
+        {
+            builder.AddPrimitive("node", static_cast<uint32_t>(primitive), primitives[primitive].data(), primitiveTriangleCount * 3, nullptr, 0, identity.data(), 1);
+        }
+
+        sceneIndex = builder.Build();
+    });
+
+    ReportRate("Build, 1M triangles", static_cast<double>(sceneIndex->TriangleCount()), "triangles", seconds);
+
+    const size_t instanceCount = 10000;
+    const size_t meshTriangleCount = 1000;
+    const vector<float> mesh = ScatterTriangles(random, meshTriangleCount, 1.0f, 0.2f);
+
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<float> transforms;
+
+    for (size_t instance = 0; instance < instanceCount; ++instance)
+    {
+        const float angle = value(random) * 3.0f;
+        const float c = cosf(angle);
+        const float s = sinf(angle);
+
+        transforms.insert(transforms.end(), { c, 0, -s, 0, 0, 1, 0, 0, s, 0, c, 0, value(random) * 100.0f, value(random) * 100.0f, value(random) * 100.0f, 1 });
+    }
+
+    shared_ptr<const PickIndex> instanceIndex;
+
+    seconds = MeasureSeconds(3, [&]()
+    {
+        PickIndexBuilder builder;
+        builder.AddPrimitive("instanced", 0, mesh.data(), meshTriangleCount * 3, nullptr, 0, transforms.data(), instanceCount);
+
+        instanceIndex = builder.Build();
+    });
+
+    ReportRate("Build, 10000 instances", static_cast<double>(instanceCount), "instances", seconds);
+
+    const vector<float> rays = RandomRays(random, 200000, 100.0f);
+
+    MeasurePicks("Pick, 1M triangles", *sceneIndex, rays);
+    MeasurePicks("Pick, 10000 instances", *instanceIndex, rays);
+
+    return 0;
+}
@@ -0,0 +1,506 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "PickIndex.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// Every triangle a PickIndexBuilder was given, in the space of the scene, to test every one
+// of them against a ray.
+class ReferenceScene
+{
+public:
+    struct Triangle
+    {
+        double vertices[3][3];
+        string nodeId;
+        uint32_t primitiveIndex;
+        uint32_t instanceIndex;
+        uint32_t triangleIndex;
+    };
+
+    // Adds the primitive to both.
+    void AddPrimitive(
+        PickIndexBuilder& builder,
+        const string& nodeId,
+        uint32_t primitiveIndex,
+        const vector<float>& positions,
+        const vector<uint16_t>& indices,
+        const vector<float>& transforms)
+    {
+        const size_t transformCount = transforms.size() / 16;
+        const size_t triangleCount = (indices.empty() ? positions.size() / 3 : indices.size()) / 3;
+
+        builder.AddPrimitive(nodeId, primitiveIndex, positions.data(), positions.size() / 3,
+            indices.empty() ? nullptr : indices.data(), indices.size(), transforms.data(), transformCount);
+
+        for (size_t instance = 0; instance < transformCount; ++instance)
+        {
+            const float* m = &transforms[instance * 16];
+
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                Triangle triangle;
+                triangle.nodeId = nodeId;
+                triangle.primitiveIndex = primitiveIndex;
+                triangle.instanceIndex = (transformCount > 1) ? static_cast<uint32_t>(instance) : 0;
+                triangle.triangleIndex = static_cast<uint32_t>(t);
+
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const size_t vertex = indices.empty() ? t * 3 + corner : indices[t * 3 + corner];
+                    const float* p = &positions[vertex * 3];
+
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        triangle.vertices[corner][axis] = double(p[0]) * m[axis] + double(p[1]) * m[4 + axis] + double(p[2]) * m[8 + axis] + m[12 + axis];
+                    }
+                }
+
+                m_triangles.push_back(triangle);
+            }
+        }
+    }
+
+    // The distance and barycentrics of a ray through a triangle, from either side.
+    static bool Intersect(const Triangle& triangle, const float* origin, const float* direction, double* pDistance, double* pU, double* pV)
+    {
+        const auto& v = triangle.vertices;
+        double edge1[3], edge2[3], toOrigin[3];
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            edge1[axis] = v[1][axis] - v[0][axis];
+            edge2[axis] = v[2][axis] - v[0][axis];
+            toOrigin[axis] = origin[axis] - v[0][axis];
+        }
+
+        const double p[3] = {
+            direction[1] * edge2[2] - direction[2] * edge2[1],
+            direction[2] * edge2[0] - direction[0] * edge2[2],
+            direction[0] * edge2[1] - direction[1] * edge2[0] };
+
+        const double determinant = edge1[0] * p[0] + edge1[1] * p[1] + edge1[2] * p[2];
+
+        if (fabs(determinant) < 1e-12)
+        {
+            return false;
+        }
+
+        const double q[3] = {
+            toOrigin[1] * edge1[2] - toOrigin[2] * edge1[1],
+            toOrigin[2] * edge1[0] - toOrigin[0] * edge1[2],
+            toOrigin[0] * edge1[1] - toOrigin[1] * edge1[0] };
+
+        const double u = (toOrigin[0] * p[0] + toOrigin[1] * p[1] + toOrigin[2] * p[2]) / determinant;
+        const double w = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) / determinant;
+        const double distance = (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]) / determinant;
+
+        if (u < 0.0 || w < 0.0 || u + w > 1.0 || distance < 0.0)
+        {
+            return false;
+        }
+
+        *pDistance = distance;
+        *pU = u;
+        *pV = w;
+        return true;
+    }
+
+    // The closest hit of all, or nullptr.
+    const Triangle* Pick(const float* origin, const float* direction, double* pDistance) const
+    {
+        const Triangle* pClosest = nullptr;
+        *pDistance = DBL_MAX;
+
+        for (const auto& triangle : m_triangles)
+        {
+            double distance, u, v;
+
+            if (Intersect(triangle, origin, direction, &distance, &u, &v) && distance < *pDistance)
+            {
+                *pDistance = distance;
+                pClosest = &triangle;
+            }
+        }
+
+        return pClosest;
+    }
+
+    const Triangle* Find(const PickHit& hit) const
+    {
+        for (const auto& triangle : m_triangles)
+        {
+            if (triangle.nodeId == hit.nodeId && triangle.primitiveIndex == hit.primitiveIndex &&
+                triangle.instanceIndex == hit.instanceIndex && triangle.triangleIndex == hit.triangleIndex)
+            {
+                return &triangle;
+            }
+        }
+
+        return nullptr;
+    }
+
+    size_t TriangleCount() const { return m_triangles.size(); }
+
+private:
+    vector<Triangle> m_triangles;
+};
+
+static vector<float> Identity()
+{
+    return { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+}
+
+// Small triangles scattered through a cube of the given half size around the origin.
+static vector<float> ScatterTriangles(mt19937& random, size_t count, float halfSize, float triangleSize)
+{
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<float> positions(count * 9);
+
+    for (size_t t = 0; t < count; ++t)
+    {
+        const float center[3] = { value(random) * halfSize, value(random) * halfSize, value(random) * halfSize };
+
+        for (size_t corner = 0; corner < 3; ++corner)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                positions[t * 9 + corner * 3 + axis] = center[axis] + value(random) * triangleSize;
+            }
+        }
+    }
+
+    return positions;
+}
+
+// A rotation about y, a scale that differs per axis and a translation.
+static vector<float> RandomTransform(mt19937& random, float reach)
+{
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    const float angle = value(random) * 3.0f;
+    const float scale[3] = { 0.5f + fabsf(value(random)), 0.5f + fabsf(value(random)), 0.5f + fabsf(value(random)) };
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+
+    return {
+        c * scale[0], 0, -s * scale[0], 0,
+        0, scale[1], 0, 0,
+        s * scale[2], 0, c * scale[2], 0,
+        value(random) * reach, value(random) * reach, value(random) * reach, 1 };
+}
+
+struct Ray
+{
+    float origin[3];
+    float direction[3];
+};
+
+// From outside the scene towards points inside it, with directions of any length.
+static vector<Ray> RandomRays(mt19937& random, size_t count, float reach)
+{
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    vector<Ray> rays(count);
+
+    for (auto& ray : rays)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            ray.origin[axis] = value(random) * reach * 3.0f;
+            ray.direction[axis] = value(random) * reach - ray.origin[axis];
+        }
+    }
+
+    return rays;
+}
+
+// Every ray hits what the reference hits, at the same distance. When two triangles are hit at
+// the same distance either may be reported, so the hit is checked against the triangle it
+// names rather than the one the reference found.
+static void ExpectReferenceHits(const PickIndex& index, const ReferenceScene& reference, const vector<Ray>& rays, size_t* pHitCount)
+{
+    size_t hitCount = 0;
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        const Ray& ray = rays[i];
+
+        double expectedDistance;
+        const ReferenceScene::Triangle* pExpected = reference.Pick(ray.origin, ray.direction, &expectedDistance);
+
+        PickHit hit;
+        const bool isHit = index.Pick(ray.origin, ray.direction, &hit);
+
+        ASSERT_EQ(isHit, pExpected != nullptr) << "ray " << i;
+
+        if (!isHit)
+        {
+            continue;
+        }
+
+        ++hitCount;
+
+        const ReferenceScene::Triangle* pHit = reference.Find(hit);
+        ASSERT_NE(pHit, nullptr) << "ray " << i << " hit " << hit.nodeId << " " << hit.triangleIndex;
+
+        double distance, u, v;
+        ASSERT_TRUE(ReferenceScene::Intersect(*pHit, ray.origin, ray.direction, &distance, &u, &v)) << "ray " << i;
+
+        EXPECT_NEAR(hit.distance, expectedDistance, 1e-4 * max(1.0, expectedDistance)) << "ray " << i;
+        EXPECT_NEAR(hit.distance, distance, 1e-4 * max(1.0, distance)) << "ray " << i;
+        EXPECT_NEAR(hit.barycentrics[0], u, 1e-3) << "ray " << i;
+        EXPECT_NEAR(hit.barycentrics[1], v, 1e-3) << "ray " << i;
+    }
+
+    *pHitCount = hitCount;
+}
+
+TEST(PickIndexTest, EmptyScenesAreNeverHit)
+{
+    auto index = PickIndexBuilder().Build();
+
+    const float origin[3] = { 0, 0, 0 };
+    const float direction[3] = { 0, 0, 1 };
+    PickHit hit;
+
+    EXPECT_FALSE(index->Pick(origin, direction, &hit));
+    EXPECT_EQ(index->TriangleCount(), 0u);
+}
+
+TEST(PickIndexTest, HitsAQuad)
+{
+    PickIndexBuilder builder;
+
+    const vector<float> positions = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+    const vector<uint16_t> indices = { 0, 1, 2, 0, 2, 3 };
+    const vector<float> transform = Identity();
+
+    builder.AddPrimitive("quad", 2, positions.data(), 4, indices.data(), indices.size(), transform.data(), 1);
+    auto index = builder.Build();
+
+    const float origin[3] = { 0.75f, 0.25f, 2.0f };
+    const float direction[3] = { 0, 0, -0.5f };
+    PickHit hit;
+
+    ASSERT_TRUE(index->Pick(origin, direction, &hit));
+    EXPECT_EQ(hit.nodeId, "quad");
+    EXPECT_EQ(hit.primitiveIndex, 2u);
+    EXPECT_EQ(hit.instanceIndex, 0u);
+    EXPECT_EQ(hit.triangleIndex, 0u);
+
+    // In lengths of the direction.
+    EXPECT_FLOAT_EQ(hit.distance, 4.0f);
+    EXPECT_NEAR(hit.barycentrics[0], 0.5f, 1e-6f);
+    EXPECT_NEAR(hit.barycentrics[1], 0.25f, 1e-6f);
+
+    // From behind, and through the other triangle.
+    const float below[3] = { 0.25f, 0.75f, -1.0f };
+    const float up[3] = { 0, 0, 1 };
+
+    ASSERT_TRUE(index->Pick(below, up, &hit));
+    EXPECT_EQ(hit.triangleIndex, 1u);
+    EXPECT_FLOAT_EQ(hit.distance, 1.0f);
+
+    // Pointing away, and beside it.
+    const float away[3] = { 0, 0, 1 };
+    const float beside[3] = { 1.5f, 0.5f, 2.0f };
+
+    EXPECT_FALSE(index->Pick(origin, away, &hit));
+    EXPECT_FALSE(index->Pick(beside, direction, &hit));
+}
+
+TEST(PickIndexTest, TrianglesThatArentFiniteAreLeftOut)
+{
+    PickIndexBuilder builder;
+
+    const float nan = numeric_limits<float>::quiet_NaN();
+    const vector<float> positions = {
+        0, 0, 0, 1, 0, 0, 0, 1, 0,
+        0, 0, 1, nan, 0, 1, 0, 1, 1,
+        0, 0, 2, INFINITY, 0, 2, 0, 1, 2 };
+    const vector<float> transform = Identity();
+
+    builder.AddPrimitive("node", 0, positions.data(), 9, nullptr, 0, transform.data(), 1);
+    auto index = builder.Build();
+
+    EXPECT_EQ(index->TriangleCount(), 1u);
+
+    const float origin[3] = { 0.1f, 0.1f, 5.0f };
+    const float direction[3] = { 0, 0, -1 };
+    PickHit hit;
+
+    ASSERT_TRUE(index->Pick(origin, direction, &hit));
+    EXPECT_EQ(hit.triangleIndex, 0u);
+    EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+}
+
+// Triangles drawn once under rotated and scaled nodes, and an instanced primitive, in one scene.
+TEST(PickIndexTest, MatchesBruteForce)
+{
+    mt19937 random(7);
+    PickIndexBuilder builder;
+    ReferenceScene reference;
+
+    for (uint32_t primitive = 0; primitive < 3; ++primitive)
+    {
+        const vector<float> positions = ScatterTriangles(random, 2000, 10.0f, 0.3f);
+        vector<uint16_t> indices;
+
+        // Reversed, so triangle order and vertex order differ.
+        for (uint16_t t = 0; t < 2000; ++t)
+        {
+            indices.insert(indices.end(), { static_cast<uint16_t>(t * 3 + 1), static_cast<uint16_t>(t * 3), static_cast<uint16_t>(t * 3 + 2) });
+        }
+
+        reference.AddPrimitive(builder, "node" + to_string(primitive), primitive, positions, indices, RandomTransform(random, 5.0f));
+    }
+
+    vector<float> transforms;
+
+    for (int instance = 0; instance < 50; ++instance)
+    {
+        const vector<float> transform = RandomTransform(random, 15.0f);
+        transforms.insert(transforms.end(), transform.begin(), transform.end());
+    }
+
+    reference.AddPrimitive(builder, "instanced", 1, ScatterTriangles(random, 200, 1.0f, 0.2f), {}, transforms);
+
+    auto index = builder.Build();
+
+    // Instanced triangles are counted once.
+    EXPECT_EQ(index->TriangleCount(), 3 * 2000 + 200u);
+
+    size_t hitCount = 0;
+    ExpectReferenceHits(*index, reference, RandomRays(random, 2000, 15.0f), &hitCount);
+
+    // Enough of both to mean something.
+    EXPECT_GT(hitCount, 200u);
+    EXPECT_LT(hitCount, 1900u);
+}
+
+// Enough triangles, in primitives of up to 65536 vertices, to build the top of the hierarchy
+// in parallel.
+TEST(PickIndexTest, LargeScenesMatchBruteForce)
+{
+    mt19937 random(11);
+    PickIndexBuilder builder;
+    ReferenceScene reference;
+
+    for (uint32_t primitive = 0; primitive < 8; ++primitive)
+    {
+        reference.AddPrimitive(builder, "node", primitive, ScatterTriangles(random, 20000, 20.0f, 0.2f), {}, Identity());
+    }
+
+    auto index = builder.Build();
+
+    ASSERT_EQ(index->TriangleCount(), reference.TriangleCount());
+
+    size_t hitCount = 0;
+    ExpectReferenceHits(*index, reference, RandomRays(random, 300, 20.0f), &hitCount);
+
+    EXPECT_GT(hitCount, 30u);
+}
+
+// Long thin triangles and rays along the axes, which have zeros in their directions.
+TEST(PickIndexTest, AxisAlignedRaysMatchBruteForce)
+{
+    mt19937 random(3);
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+    PickIndexBuilder builder;
+    ReferenceScene reference;
+
+    vector<float> positions;
+
+    for (int t = 0; t < 3000; ++t)
+    {
+        const float start[3] = { value(random) * 10, value(random) * 10, value(random) * 10 };
+        const int axis = t % 3;
+
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            float vertex[3] = { start[0], start[1], start[2] };
+            vertex[axis] += (corner == 1) ? 8.0f : 0.0f;
+            vertex[(axis + 1) % 3] += (corner == 2) ? 0.5f : 0.0f;
+            positions.insert(positions.end(), vertex, vertex + 3);
+        }
+    }
+
+    reference.AddPrimitive(builder, "node", 0, positions, {}, Identity());
+    auto index = builder.Build();
+
+    vector<Ray> rays(1500);
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        Ray& ray = rays[i];
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            ray.origin[axis] = value(random) * 10;
+            ray.direction[axis] = 0.0f;
+        }
+
+        const int axis = i % 3;
+        ray.origin[axis] = (i & 1) ? 30.0f : -30.0f;
+        ray.direction[axis] = (i & 1) ? -1.0f : 1.0f;
+    }
+
+    size_t hitCount = 0;
+    ExpectReferenceHits(*index, reference, rays, &hitCount);
+
+    EXPECT_GT(hitCount, 100u);
+}
+
+TEST(PickIndexTest, PicksFromSeveralThreadsAgree)
+{
+    mt19937 random(5);
+    PickIndexBuilder builder;
+    ReferenceScene reference;
+
+    reference.AddPrimitive(builder, "node", 0, ScatterTriangles(random, 5000, 10.0f, 0.5f), {}, Identity());
+    auto index = builder.Build();
+
+    const vector<Ray> rays = RandomRays(random, 4000, 10.0f);
+    vector<PickHit> serial(rays.size());
+    vector<char> serialIsHit(rays.size());
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        serialIsHit[i] = index->Pick(rays[i].origin, rays[i].direction, &serial[i]);
+    }
+
+    atomic<size_t> mismatchCount{ 0 };
+    vector<thread> threads;
+
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (size_t i = t; i < rays.size(); i += 4)
+            {
+                PickHit hit;
+                const bool isHit = index->Pick(rays[i].origin, rays[i].direction, &hit);
+
+                if (isHit != static_cast<bool>(serialIsHit[i]) || (isHit && (hit.triangleIndex != serial[i].triangleIndex || hit.distance != serial[i].distance)))
+                {
+                    ++mismatchCount;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(mismatchCount, 0u);
+}
@@ -0,0 +1,93 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#pragma once
+
+// What SceneLoader\pch.h takes from PPL and the GLTF SDK on Windows, for the portable
+// modules built by this project.
+
+#include <future>
+
+// CMakeLists.txt defines SCENELOADER_HAS_GLTFSDK when it found the SDK, and only then builds
+// the modules that read documents.
+#ifdef SCENELOADER_HAS_GLTFSDK
+#include <GLTFSDK/GLTF.h>
+#include <GLTFSDK/Document.h>
+#include <GLTFSDK/Deserialize.h>
+#include <GLTFSDK/ExtensionsKHR.h>
+#include <GLTFSDK/GLTFResourceReader.h>
+#else
+// Only the exceptions, for the modules that throw them.
+namespace Microsoft::glTF
+{
+    class GLTFException : public std::runtime_error
+    {
+    public:
+        explicit GLTFException(const std::string& message) : std::runtime_error(message) {}
+    };
+
+    class InvalidGLTFException : public GLTFException
+    {
+    public:
+        explicit InvalidGLTFException(const std::string& message) : GLTFException(message) {}
+    };
+}
+#endif
+
+// The parallel algorithms of PPL the portable modules use, on threads of their own. Exceptions
+// reach the caller like they do with PPL.
+namespace concurrency
+{
+    template<typename Function1, typename Function2>
+    void parallel_invoke(const Function1& function1, const Function2& function2)
+    {
+        auto first = std::async(std::launch::async, function1);
+        function2();
+        first.get();
+    }
+
+    template<typename Index, typename Function>
+    void parallel_for(Index first, Index last, const Function& function)
+    {
+        if (!(first < last))
+        {
+            return;
+        }
+
+        const size_t count = static_cast<size_t>(last - first);
+        const size_t workerCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+        std::atomic<size_t> next{ 0 };
+
+        auto work = [&]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                function(static_cast<Index>(first + static_cast<Index>(i)));
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+
+        for (size_t w = 1; w < workerCount; ++w)
+        {
+            workers.push_back(std::async(std::launch::async, work));
+        }
+
+        work();
+
+        for (auto& worker : workers)
+        {
+            worker.get();
+        }
+    }
+
+    template<typename Iterator, typename Function>
+    void parallel_for_each(Iterator first, Iterator last, const Function& function)
+    {
+        parallel_for(size_t(0), static_cast<size_t>(std::distance(first, last)), [&](size_t i)
+        {
+            function(*std::next(first, i));
+        });
+    }
+}
@@ -0,0 +1,166 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "ResourceResolver.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// A folder of resources, next to a file that no uri may reach.
+class ResourceResolverTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto* pTest = testing::UnitTest::GetInstance()->current_test_info();
+        m_root = filesystem::path(testing::TempDir()) / (string("ResourceResolverTest-") + pTest->name());
+        m_folder = m_root / "model";
+
+        filesystem::remove_all(m_root);
+        filesystem::create_directories(m_folder / "textures");
+
+        WriteFile(m_folder / "scene.bin", "scene");
+        WriteFile(m_folder / "textures" / "wood.png", "wood");
+        WriteFile(m_root / "secret.bin", "secret");
+    }
+
+    void TearDown() override
+    {
+        error_code error;
+        filesystem::remove_all(m_root, error);
+    }
+
+    static void WriteFile(const filesystem::path& path, const string& text)
+    {
+        ofstream(path, ios::binary) << text;
+    }
+
+    static string Resolve(IResourceResolver& resolver, const string& uri)
+    {
+        ArenaArray<const uint8_t> bytes;
+
+        if (!resolver.TryResolve(uri, &bytes))
+        {
+            return "unresolved";
+        }
+
+        return string(reinterpret_cast<const char*>(bytes.data), bytes.size);
+    }
+
+    // Every uri that names the file next to the folder. They are all fine as far as the
+    // file system is concerned.
+    static vector<string> UrisOutsideTheFolder()
+    {
+        return
+        {
+            "../secret.bin",
+            "..\\secret.bin",
+            "textures/../../secret.bin",
+            "%2E%2E/secret.bin",
+            "%2e%2e%2fsecret.bin",
+            "..%2Fsecret.bin",
+            ".%2E/secret.bin",
+        };
+    }
+
+    template<typename Resolver>
+    void ExpectOnlyTheFolder()
+    {
+        Resolver resolver(m_folder.wstring());
+
+        EXPECT_EQ("scene", Resolve(resolver, "scene.bin"));
+        EXPECT_EQ("wood", Resolve(resolver, "textures/wood.png"));
+        EXPECT_EQ("wood", Resolve(resolver, "textures/../textures/wood.png"));
+        EXPECT_EQ("scene", Resolve(resolver, "textures/%2E%2E/scene.bin"));
+
+        string stamp;
+        EXPECT_TRUE(resolver.TryAppendStamp("scene.bin", &stamp));
+
+        for (const auto& uri : UrisOutsideTheFolder())
+        {
+            EXPECT_EQ("unresolved", Resolve(resolver, uri)) << uri;
+            EXPECT_FALSE(resolver.TryAppendStamp(uri, &stamp)) << uri;
+        }
+
+        const string absolute = (m_root / "secret.bin").string();
+        EXPECT_EQ("unresolved", Resolve(resolver, absolute));
+        EXPECT_FALSE(resolver.TryAppendStamp(absolute, &stamp));
+
+        EXPECT_EQ("unresolved", Resolve(resolver, "scene.bin%00.png"));
+        EXPECT_EQ("unresolved", Resolve(resolver, "."));
+    }
+
+    filesystem::path m_root;
+    filesystem::path m_folder;
+};
+
+TEST_F(ResourceResolverTest, DirectoryResolverStaysInTheFolder)
+{
+    ExpectOnlyTheFolder<DirectoryResourceResolver>();
+}
+
+TEST_F(ResourceResolverTest, MappedFileResolverStaysInTheFolder)
+{
+    ExpectOnlyTheFolder<MappedFileResourceResolver>();
+}
+
+static vector<uint8_t> ResolveDataUri(DataUriResourceResolver& resolver, const string& uri)
+{
+    ArenaArray<const uint8_t> bytes;
+    EXPECT_TRUE(resolver.TryResolve(uri, &bytes)) << uri;
+
+    return vector<uint8_t>(bytes.data, bytes.data + bytes.size);
+}
+
+TEST(DataUriResourceResolverTests, DecodesBase64)
+{
+    DataUriResourceResolver resolver;
+
+    EXPECT_EQ(vector<uint8_t>({ 1, 2, 3 }), ResolveDataUri(resolver, "data:application/octet-stream;base64,AQID"));
+
+    ArenaArray<const uint8_t> bytes;
+    EXPECT_FALSE(resolver.TryResolve("data:text/plain,123", &bytes));
+    EXPECT_FALSE(resolver.TryResolve("data:application/octet-stream;base64,A*ID", &bytes));
+}
+
+// Equal uris share their bytes, wherever their strings are.
+TEST(DataUriResourceResolverTests, SharesBytesOfEqualUris)
+{
+    DataUriResourceResolver resolver;
+    const string uri = "data:application/octet-stream;base64,AQID";
+    const string copy = uri;
+
+    ArenaArray<const uint8_t> first;
+    ArenaArray<const uint8_t> second;
+    ASSERT_TRUE(resolver.TryResolve(uri, &first));
+    ASSERT_TRUE(resolver.TryResolve(copy, &second));
+
+    EXPECT_EQ(first.data, second.data);
+}
+
+// A string that is reused for another uri, the way a freed and reallocated one would be, is
+// decoded again rather than taken for the uri that was there before.
+TEST(DataUriResourceResolverTests, DecodesAReusedStringAgain)
+{
+    DataUriResourceResolver resolver;
+    string uri = "data:application/octet-stream;base64,AQID";
+    const char* address = uri.data();
+
+    EXPECT_EQ(vector<uint8_t>({ 1, 2, 3 }), ResolveDataUri(resolver, uri));
+
+    uri.replace(uri.size() - 4, 4, "BAUG");
+    ASSERT_EQ(address, uri.data());
+    EXPECT_EQ(vector<uint8_t>({ 4, 5, 6 }), ResolveDataUri(resolver, uri));
+
+    uri.replace(uri.size() - 4, 4, "BAU");
+    ASSERT_EQ(address, uri.data());
+    EXPECT_EQ(vector<uint8_t>({ 4, 5 }), ResolveDataUri(resolver, uri));
+
+    uri.replace(uri.size() - 3, 3, "AQID");
+    EXPECT_EQ(vector<uint8_t>({ 1, 2, 3 }), ResolveDataUri(resolver, uri));
+}
@@ -0,0 +1,159 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "ResourceUri.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+#ifdef _WIN32
+static const wstring c_folder = L"C:\\models";
+static const wstring c_separator = L"\\";
+#else
+static const wstring c_folder = L"/models";
+static const wstring c_separator = L"/";
+#endif
+
+// The path under c_folder, or "rejected".
+static wstring Resolve(const string& uri)
+{
+    wstring path;
+    return TryGetPathFromRelativeUri(c_folder, uri, &path) ? path : L"rejected";
+}
+
+static wstring UnderFolder(const wstring& relative)
+{
+    wstring path = c_folder;
+
+    for (wchar_t c : relative)
+    {
+        path += c == L'/' ? c_separator : wstring(1, c);
+    }
+
+    return path;
+}
+
+TEST(ResourceUriTests, ResolvesRelativeUris)
+{
+    EXPECT_EQ(UnderFolder(L"/scene.bin"), Resolve("scene.bin"));
+    EXPECT_EQ(UnderFolder(L"/textures/wood.png"), Resolve("textures/wood.png"));
+    EXPECT_EQ(UnderFolder(L"/textures/wood.png"), Resolve("textures\\wood.png"));
+    EXPECT_EQ(UnderFolder(L"/my file.bin"), Resolve("my%20file.bin"));
+    EXPECT_EQ(UnderFolder(L"/caf\u00e9.png"), Resolve("caf%C3%A9.png"));
+    EXPECT_EQ(UnderFolder(L"/caf\u00e9.png"), Resolve("caf\xC3\xA9.png"));
+}
+
+TEST(ResourceUriTests, KeepsMalformedEscapes)
+{
+    EXPECT_EQ(UnderFolder(L"/100%.bin"), Resolve("100%.bin"));
+    EXPECT_EQ(UnderFolder(L"/a%zz.bin"), Resolve("a%zz.bin"));
+    EXPECT_EQ(UnderFolder(L"/a%4.bin"), Resolve("a%4.bin"));
+}
+
+TEST(ResourceUriTests, ResolvesDotSegmentsInsideTheFolder)
+{
+    EXPECT_EQ(UnderFolder(L"/scene.bin"), Resolve("./scene.bin"));
+    EXPECT_EQ(UnderFolder(L"/scene.bin"), Resolve("textures/../scene.bin"));
+    EXPECT_EQ(UnderFolder(L"/textures/wood.png"), Resolve("textures//./wood.png"));
+    EXPECT_EQ(UnderFolder(L"/scene.bin"), Resolve("textures/%2E%2E/scene.bin"));
+    EXPECT_EQ(UnderFolder(L"/..scene.bin"), Resolve("..scene.bin"));
+}
+
+TEST(ResourceUriTests, RejectsParentsOfTheFolder)
+{
+    EXPECT_EQ(L"rejected", Resolve("../secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("..\\secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("textures/../../secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("./../secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve(".."));
+}
+
+TEST(ResourceUriTests, RejectsEncodedParents)
+{
+    EXPECT_EQ(L"rejected", Resolve("%2E%2E/secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("%2e%2e%2fsecret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("..%2Fsecret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("..%5Csecret.bin"));
+    EXPECT_EQ(L"rejected", Resolve(".%2E/secret.bin"));
+}
+
+TEST(ResourceUriTests, RejectsSegmentsThatWindowsTrims)
+{
+    EXPECT_EQ(L"rejected", Resolve(".../secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve(".. /secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("..%20/secret.bin"));
+    EXPECT_EQ(L"rejected", Resolve("scene.bin."));
+}
+
+TEST(ResourceUriTests, RejectsRootedPaths)
+{
+    EXPECT_EQ(L"rejected", Resolve("/etc/passwd"));
+    EXPECT_EQ(L"rejected", Resolve("\\Windows\\win.ini"));
+    EXPECT_EQ(L"rejected", Resolve("\\\\server\\share\\scene.bin"));
+    EXPECT_EQ(L"rejected", Resolve("%2Fetc%2Fpasswd"));
+    EXPECT_EQ(L"rejected", Resolve("%5CWindows%5Cwin.ini"));
+}
+
+TEST(ResourceUriTests, RejectsDrivesAndSchemes)
+{
+    EXPECT_EQ(L"rejected", Resolve("C:\\Windows\\win.ini"));
+    EXPECT_EQ(L"rejected", Resolve("C:/Windows/win.ini"));
+    EXPECT_EQ(L"rejected", Resolve("C:scene.bin"));
+    EXPECT_EQ(L"rejected", Resolve("C%3A/Windows/win.ini"));
+    EXPECT_EQ(L"rejected", Resolve("file:///etc/passwd"));
+    EXPECT_EQ(L"rejected", Resolve("https://example.com/scene.bin"));
+    EXPECT_EQ(L"rejected", Resolve("scene.bin:stream"));
+}
+
+TEST(ResourceUriTests, RejectsNul)
+{
+    EXPECT_EQ(L"rejected", Resolve("scene.bin%00.png"));
+    EXPECT_EQ(L"rejected", Resolve("%00"));
+    EXPECT_EQ(L"rejected", Resolve(string("scene.bin\0.png", 14)));
+}
+
+TEST(ResourceUriTests, RejectsInvalidUtf8)
+{
+    EXPECT_EQ(L"rejected", Resolve("caf%C3"));
+    EXPECT_EQ(L"rejected", Resolve("caf\xC3"));
+    EXPECT_EQ(L"rejected", Resolve("%FF.bin"));
+
+    // An overlong encoding of '.', which a lenient decoder would turn into "..".
+    EXPECT_EQ(L"rejected", Resolve("%C0%AE%C0%AE/secret.bin"));
+}
+
+TEST(ResourceUriTests, RejectsTheFolderItself)
+{
+    EXPECT_EQ(L"rejected", Resolve(""));
+    EXPECT_EQ(L"rejected", Resolve("."));
+    EXPECT_EQ(L"rejected", Resolve("./"));
+    EXPECT_EQ(L"rejected", Resolve("textures/.."));
+}
+
+TEST(ResourceUriTests, ResolvesInAnEmptyFolder)
+{
+    wstring path;
+    ASSERT_TRUE(TryGetPathFromRelativeUri(L"", "textures/wood.png", &path));
+    EXPECT_EQ(L"textures" + c_separator + L"wood.png", path);
+
+    EXPECT_FALSE(TryGetPathFromRelativeUri(L"", "../wood.png", &path));
+}
+
+TEST(ResourceUriTests, GetsTheParentFolder)
+{
+    EXPECT_EQ(L"C:\\models", GetParentFolder(L"C:\\models\\scene.gltf"));
+    EXPECT_EQ(L"/models", GetParentFolder(L"/models/scene.gltf"));
+    EXPECT_EQ(L"", GetParentFolder(L"scene.gltf"));
+}
+
+TEST(ResourceUriTests, RecognizesDataUris)
+{
+    EXPECT_TRUE(IsDataUri("data:application/octet-stream;base64,AAAA"));
+    EXPECT_FALSE(IsDataUri("scene.bin"));
+    EXPECT_FALSE(IsDataUri("dat"));
+}
@@ -0,0 +1,380 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "SceneBounds.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+using Point = array<double, 3>;
+
+// A float4x4 for row vectors: a rotation about an axis, a scale and a translation.
+static vector<float> MakeTransform(mt19937& random)
+{
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    float axis[3] = { value(random), value(random), value(random) };
+    const float length = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]) + 1e-3f;
+
+    for (float& component : axis)
+    {
+        component /= length;
+    }
+
+    const float angle = value(random) * 3.0f;
+    const float c = cosf(angle);
+    const float s = sinf(angle);
+    const float t = 1.0f - c;
+    const float scale = 0.5f + (value(random) + 1.0f);
+
+    const float rotation[3][3] =
+    {
+        { t * axis[0] * axis[0] + c, t * axis[0] * axis[1] + s * axis[2], t * axis[0] * axis[2] - s * axis[1] },
+        { t * axis[0] * axis[1] - s * axis[2], t * axis[1] * axis[1] + c, t * axis[1] * axis[2] + s * axis[0] },
+        { t * axis[0] * axis[2] + s * axis[1], t * axis[1] * axis[2] - s * axis[0], t * axis[2] * axis[2] + c },
+    };
+
+    vector<float> transform(16, 0.0f);
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int column = 0; column < 3; ++column)
+        {
+            transform[row * 4 + column] = rotation[row][column] * scale;
+        }
+
+        transform[12 + row] = value(random) * 50.0f;
+    }
+
+    transform[15] = 1.0f;
+    return transform;
+}
+
+static Point Transform(const float* p, const float* m)
+{
+    Point result;
+
+    for (int column = 0; column < 3; ++column)
+    {
+        result[column] = double(p[0]) * m[column] + double(p[1]) * m[4 + column] + double(p[2]) * m[8 + column] + m[12 + column];
+    }
+
+    return result;
+}
+
+static double Distance(const Point& a, const Point& b)
+{
+    return sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+// Every position at every transform.
+static vector<Point> TransformAll(const vector<float>& positions, const vector<float>& transforms)
+{
+    vector<Point> points;
+
+    for (size_t m = 0; m < transforms.size(); m += 16)
+    {
+        for (size_t i = 0; i < positions.size(); i += 3)
+        {
+            points.push_back(Transform(&positions[i], &transforms[m]));
+        }
+    }
+
+    return points;
+}
+
+// Points scattered through a ball, and as many on its surface.
+static vector<float> MakeBall(mt19937& random, size_t count)
+{
+    normal_distribution<float> direction;
+    uniform_real_distribution<float> fraction(0.0f, 1.0f);
+    vector<float> positions;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        float p[3] = { direction(random), direction(random), direction(random) };
+        const float length = sqrtf(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]) + 1e-6f;
+        const float radius = (i % 2 == 0) ? 1.0f : cbrtf(fraction(random));
+
+        for (float& component : p)
+        {
+            positions.push_back(component / length * radius);
+        }
+    }
+
+    return positions;
+}
+
+static void ExpectContains(const BoundingBox& box, const vector<Point>& points)
+{
+    for (const auto& point : points)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const double tolerance = 1e-5 * (1.0 + fabs(point[axis]));
+            ASSERT_GE(point[axis], box.min[axis] - tolerance);
+            ASSERT_LE(point[axis], box.max[axis] + tolerance);
+        }
+    }
+}
+
+// The box is the box of the points, not more.
+static void ExpectBoxOf(const BoundingBox& box, const vector<Point>& points)
+{
+    ExpectContains(box, points);
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        double low = DBL_MAX;
+        double high = -DBL_MAX;
+
+        for (const auto& point : points)
+        {
+            low = min(low, point[axis]);
+            high = max(high, point[axis]);
+        }
+
+        EXPECT_NEAR(low, box.min[axis], 1e-5 * (1.0 + fabs(low)));
+        EXPECT_NEAR(high, box.max[axis], 1e-5 * (1.0 + fabs(high)));
+    }
+}
+
+static void ExpectContains(const BoundingSphere& sphere, const vector<Point>& points)
+{
+    ASSERT_FALSE(sphere.IsEmpty());
+
+    const Point center = { sphere.center[0], sphere.center[1], sphere.center[2] };
+
+    for (const auto& point : points)
+    {
+        ASSERT_LE(Distance(point, center), sphere.radius);
+    }
+}
+
+// The smallest sphere through two, three or four of the points that holds them all, which is
+// the smallest sphere of them all; only for a few points.
+static double MinimalRadius(const vector<Point>& points)
+{
+    double best = DBL_MAX;
+
+    auto consider = [&](const Point& center)
+    {
+        double radius = 0.0;
+
+        for (const auto& point : points)
+        {
+            radius = max(radius, Distance(point, center));
+        }
+
+        best = min(best, radius);
+    };
+
+    const size_t count = points.size();
+
+    for (size_t a = 0; a < count; ++a)
+    {
+        for (size_t b = a + 1; b < count; ++b)
+        {
+            const Point& p = points[a];
+            const Point& q = points[b];
+            consider({ (p[0] + q[0]) / 2, (p[1] + q[1]) / 2, (p[2] + q[2]) / 2 });
+
+            for (size_t c = b + 1; c < count; ++c)
+            {
+                // The center of the circle through p, q and r, in their plane.
+                const Point& r = points[c];
+                const Point u = { q[0] - p[0], q[1] - p[1], q[2] - p[2] };
+                const Point v = { r[0] - p[0], r[1] - p[1], r[2] - p[2] };
+                const Point n = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+                const double nn = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+
+                if (nn < 1e-12)
+                {
+                    continue;
+                }
+
+                const double uu = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+                const double vv = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+
+                // ((|u|^2 v - |v|^2 u) x n) / (2 |n|^2)
+                const Point w = { uu * v[0] - vv * u[0], uu * v[1] - vv * u[1], uu * v[2] - vv * u[2] };
+                const Point offset = { w[1] * n[2] - w[2] * n[1], w[2] * n[0] - w[0] * n[2], w[0] * n[1] - w[1] * n[0] };
+
+                const Point center = { p[0] + offset[0] / (2 * nn), p[1] + offset[1] / (2 * nn), p[2] + offset[2] / (2 * nn) };
+                consider(center);
+
+                for (size_t d = c + 1; d < count; ++d)
+                {
+                    // The center of the sphere through all four is on the line through the
+                    // center of the circle along n, as far from p as from s.
+                    const Point& s = points[d];
+                    const Point sp = { s[0] - center[0], s[1] - center[1], s[2] - center[2] };
+                    const Point pp = { p[0] - center[0], p[1] - center[1], p[2] - center[2] };
+                    const double along = 2 * (sp[0] * n[0] + sp[1] * n[1] + sp[2] * n[2]);
+
+                    if (fabs(along) < 1e-12)
+                    {
+                        continue;
+                    }
+
+                    const double k = (sp[0] * sp[0] + sp[1] * sp[1] + sp[2] * sp[2] - pp[0] * pp[0] - pp[1] * pp[1] - pp[2] * pp[2]) / along;
+                    consider({ center[0] + n[0] * k, center[1] + n[1] * k, center[2] + n[2] * k });
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+TEST(SceneBoundsTest, EmptyUntilPointsAreAdded)
+{
+    SceneBoundsBuilder builder;
+
+    EXPECT_TRUE(builder.Box().IsEmpty());
+    EXPECT_TRUE(builder.ComputeSphere().IsEmpty());
+
+    const vector<float> identity = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    EXPECT_TRUE(builder.AddInstances(nullptr, 0, identity.data(), 1).IsEmpty());
+    EXPECT_TRUE(builder.ComputeSphere().IsEmpty());
+
+    // Points that aren't numbers are left out.
+    const vector<float> nan = { NAN, 0, 0, 0, NAN, 0 };
+    EXPECT_TRUE(builder.AddInstances(nan.data(), 2, identity.data(), 1).IsEmpty());
+
+    const vector<float> point = { NAN, 0, 0, 1, 2, 3 };
+    const BoundingBox box = builder.AddInstances(point.data(), 2, identity.data(), 1);
+    EXPECT_EQ(1.0f, box.min[0]);
+    EXPECT_EQ(3.0f, box.max[2]);
+
+    const BoundingSphere sphere = builder.ComputeSphere();
+    EXPECT_FALSE(sphere.IsEmpty());
+    EXPECT_NEAR(2.0f, sphere.center[1], 1e-4f);
+    EXPECT_LT(sphere.radius, 1e-3f);
+}
+
+// Instances share the hull of their mesh; the bounds are those of every point of every
+// instance, whatever the shape.
+TEST(SceneBoundsTest, InstancesHaveTheBoundsOfEveryPoint)
+{
+    mt19937 random(7);
+
+    const vector<vector<float>> meshes =
+    {
+        MakeBall(random, 2000),
+        // A cube's corners and a grid across its inside, and on its faces.
+        [] { vector<float> p; for (int x = -2; x <= 2; ++x) for (int y = -2; y <= 2; ++y) for (int z = -2; z <= 2; ++z) p.insert(p.end(), { float(x), float(y), float(z) }); return p; }(),
+        // Flat, in a line, and one point over and over.
+        [] { vector<float> p; for (int x = 0; x < 10; ++x) for (int y = 0; y < 10; ++y) p.insert(p.end(), { float(x), float(y), 0.0f }); return p; }(),
+        { 0, 0, 0, 1, 1, 1, 2, 2, 2, 0.5f, 0.5f, 0.5f },
+        { 3, 4, 5, 3, 4, 5, 3, 4, 5 },
+    };
+
+    for (size_t m = 0; m < meshes.size(); ++m)
+    {
+        const vector<float>& positions = meshes[m];
+
+        vector<float> transforms;
+
+        for (int i = 0; i < 50; ++i)
+        {
+            const vector<float> transform = MakeTransform(random);
+            transforms.insert(transforms.end(), transform.begin(), transform.end());
+        }
+
+        SceneBoundsBuilder builder;
+        const BoundingBox box = builder.AddInstances(positions.data(), positions.size() / 3, transforms.data(), transforms.size() / 16);
+
+        const vector<Point> points = TransformAll(positions, transforms);
+
+        SCOPED_TRACE(m);
+        ExpectBoxOf(box, points);
+        ExpectBoxOf(builder.Box(), points);
+        ExpectContains(builder.ComputeSphere(), points);
+    }
+}
+
+// The sphere of a few points is close to the smallest there is.
+TEST(SceneBoundsTest, SpheresAreTight)
+{
+    mt19937 random(3);
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        const size_t count = 2 + trial % 9;
+        vector<float> positions;
+
+        for (size_t i = 0; i < count * 3; ++i)
+        {
+            positions.push_back(value(random) * (trial % 2 ? 10.0f : 1.0f));
+        }
+
+        const vector<float> transform = MakeTransform(random);
+
+        // As one mesh, and as instances of a mesh of one point.
+        SceneBoundsBuilder builder;
+        builder.AddInstances(positions.data(), count, transform.data(), 1);
+
+        vector<float> instances;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            instances.insert(instances.end(), transform.begin(), transform.begin() + 12);
+            const Point p = Transform(&positions[i * 3], transform.data());
+            instances.insert(instances.end(), { float(p[0]), float(p[1]), float(p[2]), 1.0f });
+        }
+
+        const vector<float> origin = { 0, 0, 0 };
+        SceneBoundsBuilder instanceBuilder;
+        instanceBuilder.AddInstances(origin.data(), 1, instances.data(), count);
+
+        const vector<Point> points = TransformAll(positions, transform);
+        const double minimal = MinimalRadius(points);
+
+        for (const auto& sphere : { builder.ComputeSphere(), instanceBuilder.ComputeSphere() })
+        {
+            ExpectContains(sphere, points);
+
+            // No sphere that holds the points is smaller than the smallest.
+            const double ratio = sphere.radius / minimal;
+            EXPECT_GE(ratio, 1.0 - 1e-6) << "trial " << trial;
+            EXPECT_LE(ratio, 1.1) << "trial " << trial;
+        }
+    }
+}
+
+// Groups far apart, each with its own transform: the refined sphere of the whole is still
+// close to the smallest.
+TEST(SceneBoundsTest, GroupsFarApartAreTight)
+{
+    mt19937 random(5);
+
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        SceneBoundsBuilder builder;
+        vector<Point> points;
+
+        for (int group = 0; group < 6; ++group)
+        {
+            const vector<float> positions = MakeBall(random, 4);
+            const vector<float> transform = MakeTransform(random);
+
+            builder.AddInstances(positions.data(), positions.size() / 3, transform.data(), 1);
+
+            const vector<Point> transformed = TransformAll(positions, transform);
+            points.insert(points.end(), transformed.begin(), transformed.end());
+        }
+
+        const BoundingSphere sphere = builder.ComputeSphere();
+
+        ExpectContains(sphere, points);
+        EXPECT_LE(sphere.radius / MinimalRadius(points), 1.1) << "trial " << trial;
+    }
+}
@@ -0,0 +1,373 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "SceneCacheFile.h"
+#include "TexelAnalysis.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static const SceneCacheKey c_key = { 0x0123456789abcdefull, 4096 };
+
+class SceneCacheFileTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        const auto* pTest = testing::UnitTest::GetInstance()->current_test_info();
+        m_folder = filesystem::path(testing::TempDir()) / (string("SceneCacheFileTest-") + pTest->name());
+
+        filesystem::remove_all(m_folder);
+        filesystem::create_directories(m_folder);
+
+        m_path = GetSceneCachePath(m_folder.wstring(), c_key);
+    }
+
+    void TearDown() override
+    {
+        error_code error;
+        filesystem::remove_all(m_folder, error);
+    }
+
+    // Two nodes drawing one mesh with a material whose base color is a 4x2 texture with
+    // its whole mip chain.
+    static SceneCacheContents MakeContents()
+    {
+        SceneCacheContents contents;
+
+        const float positions[9] = { 0, 0, 0, 1, 0, 0, 0, 1, 0 };
+        const uint16_t indices[3] = { 0, 1, 2 };
+
+        contents.meshes.push_back({ 4, 0, 2 });
+        contents.attributes.push_back({ 1, 6, contents.AppendStream(positions, sizeof(positions)) });
+        contents.attributes.push_back({ 0, 57, contents.AppendStream(indices, sizeof(indices)) });
+
+        uint32_t width = 4;
+        uint32_t height = 2;
+        CachedSurface surface = {};
+        surface.width = static_cast<int32_t>(width);
+        surface.height = static_cast<int32_t>(height);
+        surface.pixelFormat = 87;
+        surface.levelCount = 3;
+        contents.AppendString("texture", &surface.commentOffset, &surface.commentLength);
+
+        for (uint32_t level = 0; level < surface.levelCount; ++level)
+        {
+            vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4, static_cast<uint8_t>(level + 1));
+            contents.levels.push_back({ width, height, static_cast<uint32_t>(TexelLayout::Bgra8), contents.AppendStream(pixels.data(), pixels.size()) });
+
+            width = max(width / 2, 1u);
+            height = max(height / 2, 1u);
+        }
+
+        contents.surfaces.push_back(surface);
+        contents.inputs.push_back({ 0, 1, 0, 0 });
+
+        CachedMaterial material = {};
+        material.baseColorFactor[0] = 0.5f;
+        material.inputs[0] = 0;
+
+        for (size_t i = 1; i < c_cachedMaterialInputCount; ++i)
+        {
+            material.inputs[i] = -1;
+        }
+
+        contents.AppendString("material", &material.commentOffset, &material.commentLength);
+        contents.materials.push_back(material);
+
+        CachedNode root = {};
+        root.parent = -1;
+        root.mesh = -1;
+        root.material = -1;
+        root.scale[0] = root.scale[1] = root.scale[2] = 1.0f;
+        root.orientation[3] = 1.0f;
+        contents.AppendString("root", &root.commentOffset, &root.commentLength);
+        contents.nodes.push_back(root);
+
+        CachedNode child = root;
+        child.parent = 0;
+        child.mesh = 0;
+        child.material = 0;
+        child.translation[1] = 2.0f;
+        contents.AppendString("child", &child.commentOffset, &child.commentLength);
+
+        CachedUVMapping uvMapping = {};
+        contents.AppendString("baseColorTexture", &uvMapping.nameOffset, &uvMapping.nameLength);
+        uvMapping.semantic = 3;
+        child.uvMappingFirst = 0;
+        child.uvMappingCount = 1;
+        contents.uvMappings.push_back(uvMapping);
+        contents.nodes.push_back(child);
+
+        SceneMetadata metadata;
+        metadata.box.min[0] = metadata.box.min[1] = metadata.box.min[2] = 0.0f;
+        metadata.box.max[0] = metadata.box.max[1] = 1.0f;
+        metadata.box.max[2] = 0.0f;
+        metadata.sphere.radius = 0.75f;
+        metadata.nodeCount = 2;
+        metadata.primitiveCount = 1;
+        metadata.vertexCount = 3;
+        metadata.drawnTriangleCount = 1;
+        metadata.nodeBounds.push_back({ "child", metadata.box });
+        contents.SetMetadata(metadata);
+
+        return contents;
+    }
+
+    vector<uint8_t> ReadBytes() const
+    {
+        ifstream file(filesystem::path(m_path), ios::binary);
+        return vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+
+    void WriteBytes(const vector<uint8_t>& bytes) const
+    {
+        ofstream file(filesystem::path(m_path), ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<streamsize>(bytes.size()));
+    }
+
+    // Writes a good file, lets corrupt change its bytes and expects the result to be rejected.
+    template<typename Corrupt>
+    void ExpectRejected(const Corrupt& corrupt) const
+    {
+        ASSERT_TRUE(MakeContents().Write(m_path, c_key));
+
+        vector<uint8_t> bytes = ReadBytes();
+        CacheHeader header;
+        memcpy(&header, bytes.data(), sizeof(header));
+
+        corrupt(bytes, header);
+        memcpy(bytes.data(), &header, sizeof(header));
+        WriteBytes(bytes);
+
+        EXPECT_EQ(SceneCacheFile::Open(m_path, c_key), nullptr);
+    }
+
+    template<typename T>
+    static T* Element(vector<uint8_t>& bytes, const CacheTable& table, size_t index)
+    {
+        return reinterpret_cast<T*>(bytes.data() + table.offset) + index;
+    }
+
+    filesystem::path m_folder;
+    wstring m_path;
+};
+
+TEST_F(SceneCacheFileTest, RoundTrip)
+{
+    SceneCacheContents contents = MakeContents();
+    ASSERT_TRUE(contents.Write(m_path, c_key));
+
+    auto file = SceneCacheFile::Open(m_path, c_key);
+    ASSERT_NE(file, nullptr);
+
+    const CacheHeader& header = file->Header();
+    ASSERT_EQ(header.nodes.count, 2u);
+    ASSERT_EQ(header.meshes.count, 1u);
+    ASSERT_EQ(header.attributes.count, 2u);
+    ASSERT_EQ(header.surfaces.count, 1u);
+    ASSERT_EQ(header.levels.count, 3u);
+
+    // Every level is filled with a different byte, so no two streams are the same.
+    ASSERT_EQ(header.streams.count, 5u);
+
+    const CachedNode* pNodes = file->Table<CachedNode>(header.nodes);
+    EXPECT_EQ(pNodes[0].parent, -1);
+    EXPECT_EQ(pNodes[1].parent, 0);
+    EXPECT_EQ(pNodes[1].mesh, 0);
+    EXPECT_EQ(pNodes[1].translation[1], 2.0f);
+    EXPECT_EQ(file->String(pNodes[0].commentOffset, pNodes[0].commentLength), "root");
+    EXPECT_EQ(file->String(pNodes[1].commentOffset, pNodes[1].commentLength), "child");
+
+    const CachedUVMapping* pUVMappings = file->Table<CachedUVMapping>(header.uvMappings);
+    EXPECT_EQ(file->String(pUVMappings[0].nameOffset, pUVMappings[0].nameLength), "baseColorTexture");
+
+    const CachedAttribute* pAttributes = file->Table<CachedAttribute>(header.attributes);
+    ASSERT_EQ(file->StreamByteLength(pAttributes[0].stream), 9 * sizeof(float));
+
+    const float* pPositions = reinterpret_cast<const float*>(file->StreamData(pAttributes[0].stream));
+    EXPECT_EQ(pPositions[3], 1.0f);
+    EXPECT_EQ(pPositions[7], 1.0f);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pPositions) % 16, 0u);
+
+    const CachedLevel* pLevels = file->Table<CachedLevel>(header.levels);
+    EXPECT_EQ(pLevels[2].width, 1u);
+    EXPECT_EQ(pLevels[2].height, 1u);
+    EXPECT_EQ(file->StreamData(pLevels[2].stream)[0], 3);
+
+    const CachedMaterial* pMaterials = file->Table<CachedMaterial>(header.materials);
+    EXPECT_EQ(pMaterials[0].baseColorFactor[0], 0.5f);
+    EXPECT_EQ(pMaterials[0].inputs[0], 0);
+    EXPECT_EQ(pMaterials[0].inputs[1], -1);
+
+    SceneMetadata metadata = file->ReadMetadata();
+    EXPECT_EQ(metadata.box.max[1], 1.0f);
+    EXPECT_EQ(metadata.sphere.radius, 0.75f);
+    EXPECT_EQ(metadata.drawnTriangleCount, 1u);
+    ASSERT_EQ(metadata.nodeBounds.size(), 1u);
+    EXPECT_EQ(metadata.nodeBounds[0].nodeId, "child");
+}
+
+TEST_F(SceneCacheFileTest, StoresIdenticalStreamsOnce)
+{
+    SceneCacheContents contents;
+    const uint8_t data[5] = { 1, 2, 3, 4, 5 };
+    const uint8_t other[5] = { 1, 2, 3, 4, 6 };
+
+    EXPECT_EQ(contents.AppendStream(data, sizeof(data)), 0u);
+    EXPECT_EQ(contents.AppendStream(other, sizeof(other)), 1u);
+    EXPECT_EQ(contents.AppendStream(data, sizeof(data)), 0u);
+    EXPECT_EQ(contents.AppendStream(data, 4), 2u);
+}
+
+TEST_F(SceneCacheFileTest, ReplacesExistingFile)
+{
+    ASSERT_TRUE(MakeContents().Write(m_path, c_key));
+    ASSERT_TRUE(SceneCacheContents().Write(m_path, c_key));
+
+    auto file = SceneCacheFile::Open(m_path, c_key);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->Header().nodes.count, 0u);
+
+    // No temporary file is left behind.
+    EXPECT_EQ(distance(filesystem::directory_iterator(m_folder), filesystem::directory_iterator()), 1);
+}
+
+// Loads of the same scene write the same cache file at once; every write has a temporary file
+// of its own, so readers only ever see whole files.
+TEST_F(SceneCacheFileTest, ConcurrentWritersDontCollide)
+{
+    const SceneCacheContents contents = MakeContents();
+    atomic<int> failureCount{ 0 };
+    vector<thread> threads;
+
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int i = 0; i < 25; ++i)
+            {
+                if (!contents.Write(m_path, c_key) || !SceneCacheFile::Open(m_path, c_key))
+                {
+                    failureCount++;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(failureCount, 0);
+    EXPECT_EQ(distance(filesystem::directory_iterator(m_folder), filesystem::directory_iterator()), 1);
+}
+
+TEST_F(SceneCacheFileTest, RejectsOtherKeys)
+{
+    ASSERT_TRUE(MakeContents().Write(m_path, c_key));
+
+    EXPECT_EQ(SceneCacheFile::Open(m_path, { c_key.contentHash + 1, c_key.contentSize }), nullptr);
+    EXPECT_EQ(SceneCacheFile::Open(m_path, { c_key.contentHash, c_key.contentSize + 1 }), nullptr);
+    EXPECT_EQ(SceneCacheFile::Open(m_folder.wstring() + L"/missing.slcache", c_key), nullptr);
+}
+
+TEST_F(SceneCacheFileTest, RejectsTruncatedFiles)
+{
+    ASSERT_TRUE(MakeContents().Write(m_path, c_key));
+    const vector<uint8_t> bytes = ReadBytes();
+
+    for (size_t size : { size_t(0), size_t(1), sizeof(CacheHeader) - 1, sizeof(CacheHeader), bytes.size() / 2, bytes.size() - 1 })
+    {
+        WriteBytes(vector<uint8_t>(bytes.begin(), bytes.begin() + size));
+
+        EXPECT_EQ(SceneCacheFile::Open(m_path, c_key), nullptr) << "truncated to " << size;
+    }
+
+    // Nor may the header claim the size of a file that was cut short.
+    vector<uint8_t> shortened(bytes.begin(), bytes.end() - 16);
+    CacheHeader header;
+    memcpy(&header, shortened.data(), sizeof(header));
+    header.fileSize = shortened.size();
+    memcpy(shortened.data(), &header, sizeof(header));
+    WriteBytes(shortened);
+
+    EXPECT_EQ(SceneCacheFile::Open(m_path, c_key), nullptr);
+}
+
+TEST_F(SceneCacheFileTest, RejectsCorruptHeaders)
+{
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.magic[0] = 'X'; });
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.formatVersion++; });
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.loaderVersion++; });
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.nodes.offset += 4; });
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.streams.offset = header.fileSize + 16; });
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.levels.count = UINT64_MAX / 2; });
+    ExpectRejected([](vector<uint8_t>&, CacheHeader& header) { header.metadata.count = 0; });
+}
+
+TEST_F(SceneCacheFileTest, RejectsCorruptTables)
+{
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedNode>(bytes, header.nodes, 0)->parent = 1; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedNode>(bytes, header.nodes, 1)->mesh = 1; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedNode>(bytes, header.nodes, 1)->material = 7; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedNode>(bytes, header.nodes, 1)->uvMappingCount = 2; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedNode>(bytes, header.nodes, 1)->commentLength = 1000; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedMesh>(bytes, header.meshes, 0)->attributeCount = 3; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedAttribute>(bytes, header.attributes, 1)->stream = 5; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedMaterial>(bytes, header.materials, 0)->inputs[4] = 1; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedInput>(bytes, header.inputs, 0)->surface = -1; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedStream>(bytes, header.streams, 0)->byteLength = header.fileSize; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedLevel>(bytes, header.levels, 0)->layout = c_texelLayoutCount; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedLevel>(bytes, header.levels, 0)->stream = 0; });
+}
+
+TEST_F(SceneCacheFileTest, RejectsLevelsOutsideTheMipChain)
+{
+    // As many texels as the level should have, so only the dimensions are wrong.
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header)
+    {
+        CachedLevel* pLevel = Element<CachedLevel>(bytes, header.levels, 1);
+        pLevel->width = 1;
+        pLevel->height = 2;
+    });
+
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header)
+    {
+        CachedLevel* pLevel = Element<CachedLevel>(bytes, header.levels, 0);
+        pLevel->width = 2;
+        pLevel->height = 4;
+    });
+
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedSurface>(bytes, header.surfaces, 0)->width = 8; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedSurface>(bytes, header.surfaces, 0)->height = 0; });
+    ExpectRejected([](vector<uint8_t>& bytes, CacheHeader& header) { Element<CachedSurface>(bytes, header.surfaces, 0)->levelCount = 0; });
+}
+
+TEST_F(SceneCacheFileTest, RejectsLevelsPastTheEndOfTheMipChain)
+{
+    SceneCacheContents contents = MakeContents();
+
+    // A 1x1 surface has a single level.
+    const uint8_t pixel[4] = { 1, 2, 3, 4 };
+    const uint32_t stream = contents.AppendStream(pixel, sizeof(pixel));
+    const uint32_t levelFirst = static_cast<uint32_t>(contents.levels.size());
+
+    contents.levels.push_back({ 1, 1, static_cast<uint32_t>(TexelLayout::Bgra8), stream });
+    contents.levels.push_back({ 1, 1, static_cast<uint32_t>(TexelLayout::Bgra8), stream });
+    contents.surfaces.push_back({ 1, 1, 87, 0, levelFirst, 2, 0, 0 });
+
+    ASSERT_TRUE(contents.Write(m_path, c_key));
+    EXPECT_EQ(SceneCacheFile::Open(m_path, c_key), nullptr);
+
+    contents.surfaces.back().levelCount = 1;
+
+    ASSERT_TRUE(contents.Write(m_path, c_key));
+    EXPECT_NE(SceneCacheFile::Open(m_path, c_key), nullptr);
+}
@@ -0,0 +1,339 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+
+#include "GLBContainer.h"
+#include "SceneProbe.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+static string EncodeBase64(const vector<uint8_t>& bytes)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    string text;
+
+    for (size_t i = 0; i < bytes.size(); i += 3)
+    {
+        const size_t count = min<size_t>(3, bytes.size() - i);
+        uint32_t group = bytes[i] << 16;
+        group |= count > 1 ? bytes[i + 1] << 8 : 0;
+        group |= count > 2 ? bytes[i + 2] : 0;
+
+        text += alphabet[group >> 18];
+        text += alphabet[(group >> 12) & 63];
+        text += count > 1 ? alphabet[(group >> 6) & 63] : '=';
+        text += count > 2 ? alphabet[group & 63] : '=';
+    }
+
+    return text;
+}
+
+static string DataUri(const char* mediaType, const vector<uint8_t>& bytes)
+{
+    return string("data:") + mediaType + ";base64," + EncodeBase64(bytes);
+}
+
+static void AppendUInt32(vector<uint8_t>& bytes, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        bytes.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+static vector<uint8_t> MakeGLB(string json, vector<uint8_t> binaryChunk)
+{
+    json.resize((json.size() + 3) / 4 * 4, ' ');
+    binaryChunk.resize((binaryChunk.size() + 3) / 4 * 4, 0);
+
+    vector<uint8_t> glb;
+    AppendUInt32(glb, c_glbMagic);
+    AppendUInt32(glb, c_glbVersion);
+    AppendUInt32(glb, static_cast<uint32_t>(c_glbHeaderSize + 2 * c_glbChunkHeaderSize + json.size() + binaryChunk.size()));
+    AppendUInt32(glb, static_cast<uint32_t>(json.size()));
+    AppendUInt32(glb, c_glbChunkTypeJson);
+    glb.insert(glb.end(), json.begin(), json.end());
+    AppendUInt32(glb, static_cast<uint32_t>(binaryChunk.size()));
+    AppendUInt32(glb, c_glbChunkTypeBin);
+    glb.insert(glb.end(), binaryChunk.begin(), binaryChunk.end());
+
+    return glb;
+}
+
+// 32-bit texels of an image and its whole mip chain.
+static uint64_t MipChainBytes(uint64_t width, uint64_t height)
+{
+    uint64_t bytes = 0;
+
+    for (;;)
+    {
+        bytes += width * height * 4;
+
+        if (width == 1 && height == 1)
+        {
+            return bytes;
+        }
+
+        width = max<uint64_t>(width / 2, 1);
+        height = max<uint64_t>(height / 2, 1);
+    }
+}
+
+static const vector<uint8_t> c_png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R', 0, 0, 1, 44, 0, 0, 0, 200, 8, 6, 0, 0, 0 };
+static const vector<uint8_t> c_gif = { 'G', 'I', 'F', '8', '9', 'a', 10, 0, 10, 0, 0, 0 };
+
+// A 64 x 32 JPEG whose frame header sits behind two APP1 segments of almost 64 KB, past the
+// bytes of a data URI the probe decodes first.
+static vector<uint8_t> MakeJpegBehindMetadata()
+{
+    vector<uint8_t> jpeg = { 0xFF, 0xD8 };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        jpeg.insert(jpeg.end(), { 0xFF, 0xE1, 0xFF, 0xF0 });
+        jpeg.insert(jpeg.end(), 0xFFF0 - 2, 0x20);
+    }
+
+    jpeg.insert(jpeg.end(), { 0xFF, 0xC0, 0, 17, 8, 0, 32, 0, 64, 3 });
+    jpeg.insert(jpeg.end(), 20, 0);
+
+    return jpeg;
+}
+
+// Three nodes in the scene and one outside of it. Node 0 draws mesh 0, node 1 draws it with
+// 5 instances, and node 2 draws mesh 1:
+//
+// - Mesh 0 has an indexed primitive of 2 triangles with normals, texture coordinates and a
+//   normal mapped material, and a primitive of only 4 positions, which draws one triangle.
+// - Mesh 1 has a primitive of 4 positions and normals with a morph target, one triangle too.
+//
+// The material uses a PNG in the binary chunk, a JPEG data URI and an external GIF; a fourth
+// image is only used by the node outside the scene.
+class SceneProbeTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_binaryChunk.assign(8, 0);
+        m_binaryChunk.insert(m_binaryChunk.end(), c_png.begin(), c_png.end());
+
+        m_json = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],
+            "extensionsUsed":["EXT_mesh_gpu_instancing","KHR_texture_transform","KHR_draco_mesh_compression"],
+            "extensionsRequired":["KHR_draco_mesh_compression"],
+            "nodes":[
+                {"mesh":0,"children":[1]},
+                {"mesh":0,"children":[2],"extensions":{"EXT_mesh_gpu_instancing":{"attributes":{"TRANSLATION":4}}}},
+                {"mesh":1},
+                {"mesh":2}],
+            "meshes":[
+                {"primitives":[{"attributes":{"POSITION":0,"NORMAL":1,"TEXCOORD_0":2},"indices":3,"material":0},{"attributes":{"POSITION":0}}]},
+                {"primitives":[{"attributes":{"POSITION":0,"NORMAL":1},"targets":[{"POSITION":0,"NORMAL":1}]}]},
+                {"primitives":[{"attributes":{"POSITION":0},"material":1}]}],
+            "materials":[
+                {"normalTexture":{"index":0},"pbrMetallicRoughness":{"baseColorTexture":{"index":1}},"emissiveTexture":{"index":2}},
+                {"pbrMetallicRoughness":{"baseColorTexture":{"index":3}}}],
+            "textures":[{"source":0},{"source":1},{"source":2},{"source":3}],
+            "images":[
+                {"bufferView":0,"mimeType":"image/png"},
+                {"uri":")" + DataUri("image/jpeg", MakeJpegBehindMetadata()) + R"("},
+                {"uri":"external.gif"},
+                {"uri":"unused.png"}],
+            "bufferViews":[{"buffer":0,"byteOffset":8,"byteLength":29},{"buffer":0,"byteLength":8}],
+            "buffers":[{"byteLength":)" + to_string(m_binaryChunk.size()) + R"(}],
+            "accessors":[
+                {"bufferView":1,"componentType":5126,"count":4,"type":"VEC3"},
+                {"bufferView":1,"componentType":5126,"count":4,"type":"VEC3"},
+                {"bufferView":1,"componentType":5126,"count":4,"type":"VEC2"},
+                {"bufferView":1,"componentType":5123,"count":6,"type":"SCALAR"},
+                {"bufferView":1,"componentType":5126,"count":5,"type":"VEC3"}]})";
+
+        m_resolveUri = [this](const string& uri, ArenaArray<const uint8_t>* pBytes)
+        {
+            m_resolvedUris.push_back(uri);
+
+            if (uri != "external.gif")
+            {
+                return false;
+            }
+
+            *pBytes = { c_gif.data(), c_gif.size() };
+            return true;
+        };
+    }
+
+    ProbeResult ProbeGLB(const LoadOptions& loadOptions = LoadOptions())
+    {
+        const vector<uint8_t> glb = MakeGLB(m_json, m_binaryChunk);
+        return ProbeScene(glb.data(), glb.size(), loadOptions, m_resolveUri);
+    }
+
+    // Decoded vertices and 16-bit indices of the distinct primitives:
+    // - positions, normals, texture coordinates and generated tangents for 4 vertices, plus
+    //   6 indices;
+    // - positions and flat normals for the 3 corners of the one triangle, plus 3 indices;
+    // - positions and normals for 4 vertices, plus 3 indices.
+    static constexpr uint64_t c_meshBytes = 4 * (12 + 12 + 8 + 16) + 6 * 2 + 3 * (12 + 12) + 3 * 2 + 4 * (12 + 12) + 3 * 2;
+
+    // The position and normal offsets of the morph target of mesh 1.
+    static constexpr uint64_t c_morphTargetBytes = 2 * 4 * 12;
+
+    string m_json;
+    vector<uint8_t> m_binaryChunk;
+    vector<string> m_resolvedUris;
+    ProbeUriResolver m_resolveUri;
+};
+
+TEST_F(SceneProbeTest, CountsTheScene)
+{
+    const ProbeResult result = ProbeGLB();
+
+    EXPECT_EQ(3u, result.nodeCount);
+    EXPECT_EQ(2u, result.meshCount);
+    EXPECT_EQ(3u, result.primitiveCount);
+    EXPECT_EQ(1u, result.materialCount);
+    EXPECT_EQ(5u, result.meshInstanceCount);
+
+    EXPECT_EQ(4u + 3u + 4u, result.vertexCount);
+    EXPECT_EQ(6u + 3u + 3u, result.indexCount);
+
+    // Mesh 0 draws 3 triangles, once for node 0 and 5 times for node 1; mesh 1 draws one.
+    EXPECT_EQ(3u * 6u + 1u, result.drawnTriangleCount);
+}
+
+TEST_F(SceneProbeTest, ReadsTheImageHeaders)
+{
+    const ProbeResult result = ProbeGLB();
+
+    ASSERT_EQ(3u, result.images.size());
+
+    EXPECT_EQ("0", result.images[0].imageId);
+    EXPECT_EQ("image/png", result.images[0].mimeType);
+    EXPECT_EQ(300u, result.images[0].width);
+    EXPECT_EQ(200u, result.images[0].height);
+
+    EXPECT_EQ("1", result.images[1].imageId);
+    EXPECT_EQ("image/jpeg", result.images[1].mimeType);
+    EXPECT_EQ(64u, result.images[1].width);
+    EXPECT_EQ(32u, result.images[1].height);
+
+    EXPECT_EQ("2", result.images[2].imageId);
+    EXPECT_EQ("image/gif", result.images[2].mimeType);
+    EXPECT_EQ(10u, result.images[2].width);
+    EXPECT_EQ(10u, result.images[2].height);
+
+    // Only the image outside of the binary chunk and the data URIs.
+    EXPECT_EQ(vector<string>({ "external.gif" }), m_resolvedUris);
+}
+
+TEST_F(SceneProbeTest, EstimatesTheBytes)
+{
+    const ProbeResult result = ProbeGLB();
+
+    EXPECT_EQ(c_meshBytes + c_morphTargetBytes + (300 * 200 + 64 * 32 + 10 * 10) * 4, result.decodedBytes);
+    EXPECT_EQ(c_meshBytes + MipChainBytes(300, 200) + MipChainBytes(64, 32) + MipChainBytes(10, 10), result.gpuBytes);
+}
+
+TEST_F(SceneProbeTest, ListsUnsupportedExtensions)
+{
+    const ProbeResult result = ProbeGLB();
+
+    EXPECT_EQ(vector<string>({ "KHR_draco_mesh_compression", "KHR_texture_transform" }), result.unsupportedExtensions);
+    EXPECT_EQ(vector<string>({ "KHR_draco_mesh_compression" }), result.unsupportedRequiredExtensions);
+}
+
+// Generated smooth normals share the vertices; images that can't be resolved are listed
+// without a size and left out of the estimates.
+TEST_F(SceneProbeTest, FollowsTheLoadOptions)
+{
+    LoadOptions loadOptions;
+    loadOptions.smoothGeneratedNormals = true;
+
+    const vector<uint8_t> glb = MakeGLB(m_json, m_binaryChunk);
+    const ProbeResult result = ProbeScene(glb.data(), glb.size(), loadOptions, nullptr);
+
+    // The primitive of 4 positions keeps them.
+    EXPECT_EQ(4u + 4u + 4u, result.vertexCount);
+
+    ASSERT_EQ(3u, result.images.size());
+    EXPECT_EQ(0u, result.images[2].width);
+    EXPECT_EQ("", result.images[2].mimeType);
+
+    const uint64_t meshBytes = 4 * (12 + 12 + 8 + 16) + 6 * 2 + 4 * (12 + 12) + 3 * 2 + 4 * (12 + 12) + 3 * 2;
+    EXPECT_EQ(meshBytes + MipChainBytes(300, 200) + MipChainBytes(64, 32), result.gpuBytes);
+}
+
+TEST_F(SceneProbeTest, ReadsGltfWithDataUriBuffers)
+{
+    // The JPEG at an offset that isn't a multiple of 3, so that decoding starts inside a
+    // base64 group.
+    const vector<uint8_t> jpeg = MakeJpegBehindMetadata();
+    vector<uint8_t> buffer(7, 1);
+    buffer.insert(buffer.end(), jpeg.begin(), jpeg.end());
+
+    const string json = R"({"asset":{"version":"2.0"},"scenes":[{"nodes":[0]}],"nodes":[{"mesh":0}],
+        "meshes":[{"primitives":[{"attributes":{"POSITION":0},"material":0}]}],
+        "materials":[{"pbrMetallicRoughness":{"baseColorTexture":{"index":0}}}],
+        "textures":[{"source":0}],
+        "images":[{"bufferView":0,"mimeType":"image/jpeg"}],
+        "bufferViews":[{"buffer":0,"byteOffset":7,"byteLength":)" + to_string(jpeg.size()) + R"(}],
+        "buffers":[{"byteLength":)" + to_string(buffer.size()) + R"(,"uri":")" + DataUri("application/octet-stream", buffer) + R"("}],
+        "accessors":[{"componentType":5126,"count":3,"type":"VEC3"}]})";
+
+    const ProbeResult result = ProbeScene(reinterpret_cast<const uint8_t*>(json.data()), json.size(), LoadOptions(), nullptr);
+
+    EXPECT_EQ(1u, result.nodeCount);
+    EXPECT_EQ(3u, result.vertexCount);
+    EXPECT_EQ(3u, result.indexCount);
+
+    ASSERT_EQ(1u, result.images.size());
+    EXPECT_EQ(64u, result.images[0].width);
+    EXPECT_EQ(32u, result.images[0].height);
+}
+
+// Data URIs that end before the frame header, whole or through the buffer view, give an
+// image without a size but with the type of its signature.
+TEST_F(SceneProbeTest, ToleratesTruncatedDataUriImages)
+{
+    vector<uint8_t> jpeg = MakeJpegBehindMetadata();
+    jpeg.resize(jpeg.size() - 30);
+
+    const string json = R"({"asset":{"version":"2.0"},"scenes":[{"nodes":[0]}],"nodes":[{"mesh":0}],
+        "meshes":[{"primitives":[{"attributes":{"POSITION":0},"material":0}]}],
+        "materials":[{"pbrMetallicRoughness":{"baseColorTexture":{"index":0}},"emissiveTexture":{"index":1}}],
+        "textures":[{"source":0},{"source":1}],
+        "images":[{"uri":")" + DataUri("image/jpeg", jpeg) + R"("},{"bufferView":0,"mimeType":"image/png"}],
+        "bufferViews":[{"buffer":0,"byteLength":20}],
+        "buffers":[{"byteLength":)" + to_string(c_png.size()) + R"(,"uri":")" + DataUri("application/octet-stream", c_png) + R"("}],
+        "accessors":[{"componentType":5126,"count":3,"type":"VEC3"}]})";
+
+    const ProbeResult result = ProbeScene(reinterpret_cast<const uint8_t*>(json.data()), json.size(), LoadOptions(), nullptr);
+
+    ASSERT_EQ(2u, result.images.size());
+    EXPECT_EQ("image/jpeg", result.images[0].mimeType);
+    EXPECT_EQ(0u, result.images[0].width);
+    EXPECT_EQ("image/png", result.images[1].mimeType);
+    EXPECT_EQ(0u, result.images[1].width);
+
+    // Only the vertex buffer; the images are left out.
+    EXPECT_EQ(result.gpuBytes, result.decodedBytes);
+    EXPECT_EQ(3u * (12 + 12) + 3u * 2, result.gpuBytes);
+}
+
+TEST_F(SceneProbeTest, ThrowsForMalformedContainers)
+{
+    vector<uint8_t> glb = MakeGLB(m_json, m_binaryChunk);
+
+    // A declared length past the end of the file.
+    vector<uint8_t> longer = glb;
+    memset(&longer[8], 0xFF, 3);
+    EXPECT_THROW(ProbeScene(longer.data(), longer.size(), LoadOptions(), nullptr), Microsoft::glTF::InvalidGLTFException);
+
+    const string json = "{\"asset\":{\"version\":\"2.0\"},\"nodes\":[";
+    EXPECT_THROW(ProbeScene(reinterpret_cast<const uint8_t*>(json.data()), json.size(), LoadOptions(), nullptr), Microsoft::glTF::InvalidGLTFException);
+}
@@ -0,0 +1,98 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <random>
+
+#include "Benchmark.h"
+#include "SkinningKernel.h"
+
+using namespace std;
+using namespace SceneLoader;
+using namespace SceneLoaderBenchmark;
+
+// A million vertices with normals and 64 joints, skinned on one thread and then in the
+// chunks GLTFVisitor::SkinMeshPrimitive spreads over all cores.
+int main()
+{
+    const size_t vertexCount = 1 << 20;
+    const size_t jointCount = 64;
+    const size_t chunkVertices = 4096;
+
+    mt19937 random(1);
+    uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+    vector<float> positions[3];
+    vector<float> normals[3];
+    vector<uint16_t> joints[4];
+    vector<float> weights[4];
+
+    SkinningStreams streams;
+    streams.vertexCount = vertexCount;
+
+    for (size_t component = 0; component < 3; ++component)
+    {
+        positions[component].resize(vertexCount);
+        normals[component].resize(vertexCount);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            positions[component][vertex] = value(random);
+            normals[component][vertex] = value(random);
+        }
+
+        streams.position[component] = positions[component].data();
+        streams.normal[component] = normals[component].data();
+    }
+
+    for (size_t influence = 0; influence < 4; ++influence)
+    {
+        joints[influence].resize(vertexCount);
+        weights[influence].resize(vertexCount, 0.25f);
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            joints[influence][vertex] = static_cast<uint16_t>(random() % jointCount);
+        }
+
+        streams.joints[influence] = joints[influence].data();
+        streams.weights[influence] = weights[influence].data();
+    }
+
+    vector<SkinningMatrix> jointMatrices(jointCount);
+
+    for (auto& matrix : jointMatrices)
+    {
+        for (auto& row : matrix.rows)
+        {
+            for (auto& element : row)
+            {
+                element = value(random);
+            }
+        }
+    }
+
+    vector<float> skinnedPositions(vertexCount * 3);
+    vector<float> skinnedNormals(vertexCount * 3);
+
+    double seconds = MeasureSeconds(10, [&]()
+    {
+        SkinVertices(streams, jointMatrices.data(), 0, vertexCount, skinnedPositions.data(), skinnedNormals.data());
+    });
+
+    ReportRate("SkinVertices, 1 thread", static_cast<double>(vertexCount), "vertices", seconds);
+
+    seconds = MeasureSeconds(10, [&]()
+    {
+        concurrency::parallel_for(size_t(0), (vertexCount + chunkVertices - 1) / chunkVertices, [&](size_t chunk)
+        {
+            size_t begin = chunk * chunkVertices;
+            SkinVertices(streams, jointMatrices.data(), begin, min(vertexCount, begin + chunkVertices), skinnedPositions.data(), skinnedNormals.data());
+        });
+    });
+
+    string name = "SkinVertices, parallel_for, hardware threads: " + to_string(thread::hardware_concurrency());
+    ReportRate(name.c_str(), static_cast<double>(vertexCount), "vertices", seconds);
+}
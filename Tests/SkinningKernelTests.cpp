@@ -0,0 +1,233 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "SkinningKernel.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// Random vertices with four normalized influences each over jointCount random joints.
+class SkinningKernelTest : public testing::Test
+{
+protected:
+    void Build(size_t vertexCount, size_t jointCount, bool hasNormals)
+    {
+        mt19937 random(1);
+        uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+        for (size_t component = 0; component < 3; ++component)
+        {
+            m_positions[component].resize(vertexCount);
+            m_normals[component].resize(hasNormals ? vertexCount : 0);
+        }
+
+        for (size_t influence = 0; influence < 4; ++influence)
+        {
+            m_joints[influence].resize(vertexCount);
+            m_weights[influence].resize(vertexCount);
+        }
+
+        for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            for (size_t component = 0; component < 3; ++component)
+            {
+                m_positions[component][vertex] = value(random);
+
+                if (hasNormals)
+                {
+                    m_normals[component][vertex] = value(random);
+                }
+            }
+
+            float weightSum = 0.0f;
+
+            for (size_t influence = 0; influence < 4; ++influence)
+            {
+                m_joints[influence][vertex] = static_cast<uint16_t>(random() % jointCount);
+                m_weights[influence][vertex] = value(random) + 1.0f;
+                weightSum += m_weights[influence][vertex];
+            }
+
+            for (size_t influence = 0; influence < 4; ++influence)
+            {
+                m_weights[influence][vertex] /= weightSum;
+            }
+        }
+
+        m_jointMatrices.resize(jointCount);
+
+        for (auto& matrix : m_jointMatrices)
+        {
+            for (auto& row : matrix.rows)
+            {
+                for (auto& element : row)
+                {
+                    element = value(random);
+                }
+            }
+        }
+
+        m_streams.vertexCount = vertexCount;
+
+        for (size_t component = 0; component < 3; ++component)
+        {
+            m_streams.position[component] = m_positions[component].data();
+            m_streams.normal[component] = hasNormals ? m_normals[component].data() : nullptr;
+        }
+
+        for (size_t influence = 0; influence < 4; ++influence)
+        {
+            m_streams.joints[influence] = m_joints[influence].data();
+            m_streams.weights[influence] = m_weights[influence].data();
+        }
+    }
+
+    // Largest difference between the skinned vertices and skinning in double precision, one
+    // vertex at a time. Normals nearly cancelled out by the blend are too ill-conditioned
+    // to compare.
+    double MeasureError(const vector<float>& positions, const vector<float>& normals) const
+    {
+        double error = 0.0;
+
+        for (size_t vertex = 0; vertex < m_streams.vertexCount; ++vertex)
+        {
+            double blended[3][4] = {};
+
+            for (size_t influence = 0; influence < 4; ++influence)
+            {
+                const SkinningMatrix& matrix = m_jointMatrices[m_joints[influence][vertex]];
+
+                for (size_t row = 0; row < 3; ++row)
+                {
+                    for (size_t column = 0; column < 4; ++column)
+                    {
+                        blended[row][column] += m_weights[influence][vertex] * matrix.rows[row][column];
+                    }
+                }
+            }
+
+            double normal[3];
+
+            for (size_t row = 0; row < 3; ++row)
+            {
+                double position = blended[row][3];
+
+                for (size_t column = 0; column < 3; ++column)
+                {
+                    position += blended[row][column] * m_positions[column][vertex];
+                }
+
+                error = max(error, fabs(position - positions[vertex * 3 + row]));
+
+                normal[row] = 0.0;
+
+                for (size_t column = 0; column < 3 && !normals.empty(); ++column)
+                {
+                    normal[row] += blended[row][column] * m_normals[column][vertex];
+                }
+            }
+
+            double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            if (!normals.empty() && length > 1e-3)
+            {
+                for (size_t row = 0; row < 3; ++row)
+                {
+                    error = max(error, fabs(normal[row] / length - normals[vertex * 3 + row]));
+                }
+            }
+        }
+
+        return error;
+    }
+
+    SkinningStreams m_streams;
+    vector<SkinningMatrix> m_jointMatrices;
+
+private:
+    vector<float> m_positions[3];
+    vector<float> m_normals[3];
+    vector<uint16_t> m_joints[4];
+    vector<float> m_weights[4];
+};
+
+TEST_F(SkinningKernelTest, MatchesReferenceSkinning)
+{
+    Build(10000, 64, true);
+
+    vector<float> positions(m_streams.vertexCount * 3);
+    vector<float> normals(m_streams.vertexCount * 3);
+
+    SkinVertices(m_streams, m_jointMatrices.data(), 0, m_streams.vertexCount, positions.data(), normals.data());
+
+    EXPECT_LT(MeasureError(positions, normals), 1e-4);
+}
+
+// Ranges that don't start or end on a vector boundary take the scalar tail on both ends,
+// and together still write every vertex, to within rounding of what one call writes.
+TEST_F(SkinningKernelTest, SkinsRangesIndependently)
+{
+    Build(1027, 16, true);
+
+    vector<float> positions(m_streams.vertexCount * 3);
+    vector<float> normals(m_streams.vertexCount * 3);
+
+    const size_t splits[] = { 0, 1, 6, 7, 500, 1024, 1026, 1027 };
+
+    for (size_t i = 0; i + 1 < size(splits); ++i)
+    {
+        SkinVertices(m_streams, m_jointMatrices.data(), splits[i], splits[i + 1], positions.data(), normals.data());
+    }
+
+    vector<float> wholePositions(m_streams.vertexCount * 3);
+    vector<float> wholeNormals(m_streams.vertexCount * 3);
+
+    SkinVertices(m_streams, m_jointMatrices.data(), 0, m_streams.vertexCount, wholePositions.data(), wholeNormals.data());
+
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        ASSERT_NEAR(positions[i], wholePositions[i], 1e-5f) << "element " << i;
+        ASSERT_NEAR(normals[i], wholeNormals[i], 1e-5f) << "element " << i;
+    }
+
+    EXPECT_LT(MeasureError(positions, normals), 1e-4);
+}
+
+TEST_F(SkinningKernelTest, SkinsPrimitivesWithoutNormals)
+{
+    Build(333, 8, false);
+
+    vector<float> positions(m_streams.vertexCount * 3);
+
+    SkinVertices(m_streams, m_jointMatrices.data(), 0, m_streams.vertexCount, positions.data(), nullptr);
+
+    EXPECT_LT(MeasureError(positions, {}), 1e-4);
+}
+
+TEST_F(SkinningKernelTest, IdentityJointsKeepTheBindPose)
+{
+    Build(100, 4, false);
+
+    for (auto& matrix : m_jointMatrices)
+    {
+        matrix = SkinningMatrix{ { { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 0, 0, 1, 0 } } };
+    }
+
+    vector<float> positions(m_streams.vertexCount * 3);
+
+    SkinVertices(m_streams, m_jointMatrices.data(), 0, m_streams.vertexCount, positions.data(), nullptr);
+
+    for (size_t vertex = 0; vertex < m_streams.vertexCount; ++vertex)
+    {
+        for (size_t component = 0; component < 3; ++component)
+        {
+            ASSERT_NEAR(positions[vertex * 3 + component], m_streams.position[component][vertex], 1e-6f);
+        }
+    }
+}
@@ -0,0 +1,459 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <GLTFSDK/Serialize.h>
+
+#include "StreamingDeserializer.h"
+
+using namespace std;
+using namespace Microsoft::glTF;
+using namespace SceneLoader;
+
+static Document Read(const string& json, const LoadLimits& limits = LoadLimits())
+{
+    return DeserializeStreaming(json.data(), json.size(), limits);
+}
+
+// Every property DeserializeStreaming reads, each with a value other than its default.
+// Extensions and extras are compact, the way Serialize writes them.
+static const char c_everyProperty[] = R"({
+"asset":{"version":"2.0","minVersion":"2.0","generator":"test","copyright":"none","extras":{"a":1}},
+"scene":1,
+"extensionsUsed":["KHR_materials_unlit","EXT_test"],
+"extensionsRequired":["EXT_test"],
+"extensions":{"EXT_test":{"b":[1,2]}},
+"extras":{"c":"d"},
+"buffers":[
+    {"uri":"data.bin","byteLength":1024,"name":"buffer"},
+    {"byteLength":16}],
+"bufferViews":[
+    {"buffer":0,"byteOffset":4,"byteLength":512,"byteStride":12,"target":34962,"name":"vertices"},
+    {"buffer":0,"byteOffset":516,"byteLength":96,"target":34963},
+    {"buffer":1,"byteLength":16}],
+"accessors":[
+    {"bufferView":0,"byteOffset":0,"componentType":5126,"count":3,"type":"VEC3","max":[1,1,0],"min":[0,0,0],"name":"positions"},
+    {"bufferView":1,"byteOffset":2,"componentType":5123,"count":3,"type":"SCALAR"},
+    {"bufferView":0,"byteOffset":36,"componentType":5121,"normalized":true,"count":3,"type":"VEC4"},
+    {"componentType":5126,"count":2,"type":"SCALAR"},
+    {"componentType":5126,"count":2,"type":"VEC4"},
+    {"componentType":5126,"count":3,"type":"VEC3","sparse":{"count":1,"indices":{"bufferView":2,"byteOffset":4,"componentType":5125},"values":{"bufferView":2,"byteOffset":8}}},
+    {"componentType":5126,"count":2,"type":"MAT4"}],
+"images":[
+    {"uri":"wood.png","name":"wood"},
+    {"bufferView":2,"mimeType":"image/jpeg"}],
+"samplers":[{"magFilter":9728,"minFilter":9986,"wrapS":33071,"wrapT":33648,"name":"nearest"}],
+"textures":[{"sampler":0,"source":1,"name":"texture"},{"source":0}],
+"materials":[{
+    "name":"material",
+    "pbrMetallicRoughness":{"baseColorFactor":[0.5,0.25,0.125,0.75],"baseColorTexture":{"index":1,"texCoord":1},"metallicFactor":0.5,"roughnessFactor":0.25,"metallicRoughnessTexture":{"index":0}},
+    "normalTexture":{"index":0,"scale":2},
+    "occlusionTexture":{"index":1,"strength":0.5},
+    "emissiveTexture":{"index":0,"extensions":{"KHR_texture_transform":{"scale":[2,2]}}},
+    "emissiveFactor":[1,0.5,0.25],
+    "alphaMode":"MASK",
+    "alphaCutoff":0.25,
+    "doubleSided":true,
+    "extensions":{"KHR_materials_unlit":{}}}],
+"meshes":[{
+    "name":"mesh",
+    "primitives":[{"attributes":{"POSITION":0,"COLOR_0":2},"indices":1,"material":0,"mode":5,"targets":[{"POSITION":5}]}],
+    "weights":[0.5]}],
+"skins":[{"inverseBindMatrices":6,"skeleton":1,"joints":[1,2],"name":"skin"}],
+"nodes":[
+    {"children":[1,2],"name":"root","matrix":[2,0,0,0,0,2,0,0,0,0,2,0,1,2,3,1]},
+    {"mesh":0,"skin":0,"weights":[0.25],"translation":[1,2,3],"rotation":[0,0.6,0,0.8],"scale":[4,5,6]},
+    {"extras":{"e":true}}],
+"scenes":[{"nodes":[0],"name":"first"},{"nodes":[0,2]}],
+"animations":[{
+    "name":"animation",
+    "channels":[{"sampler":0,"target":{"node":1,"path":"rotation"}},{"sampler":1,"target":{"node":1,"path":"weights"}}],
+    "samplers":[{"input":3,"output":4,"interpolation":"STEP"},{"input":3,"output":3}]}]
+})";
+
+TEST(StreamingDeserializerTest, ReadsTheAssetAndTheDocumentMembers)
+{
+    const Document document = Read(c_everyProperty);
+
+    EXPECT_EQ("2.0", document.asset.version);
+    EXPECT_EQ("2.0", document.asset.minVersion);
+    EXPECT_EQ("test", document.asset.generator);
+    EXPECT_EQ("none", document.asset.copyright);
+    EXPECT_EQ("{\"a\":1}", document.asset.extras);
+
+    EXPECT_EQ("1", document.defaultSceneId);
+    EXPECT_EQ(unordered_set<string>({ "KHR_materials_unlit", "EXT_test" }), document.extensionsUsed);
+    EXPECT_EQ(unordered_set<string>({ "EXT_test" }), document.extensionsRequired);
+
+    ASSERT_EQ(1u, document.extensions.size());
+    EXPECT_EQ("{\"b\":[1,2]}", document.extensions.at("EXT_test"));
+    EXPECT_EQ("{\"c\":\"d\"}", document.extras);
+}
+
+TEST(StreamingDeserializerTest, ReadsBuffersAndBufferViews)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(2u, document.buffers.Size());
+    EXPECT_EQ("0", document.buffers.Get("0").id);
+    EXPECT_EQ("data.bin", document.buffers.Get("0").uri);
+    EXPECT_EQ(1024u, document.buffers.Get("0").byteLength);
+    EXPECT_EQ("buffer", document.buffers.Get("0").name);
+    EXPECT_EQ("", document.buffers.Get("1").uri);
+
+    ASSERT_EQ(3u, document.bufferViews.Size());
+    const BufferView& vertices = document.bufferViews.Get("0");
+    EXPECT_EQ("0", vertices.bufferId);
+    EXPECT_EQ(4u, vertices.byteOffset);
+    EXPECT_EQ(512u, vertices.byteLength);
+    ASSERT_TRUE(vertices.byteStride.HasValue());
+    EXPECT_EQ(12u, vertices.byteStride.Get());
+    ASSERT_TRUE(vertices.target.HasValue());
+    EXPECT_EQ(ARRAY_BUFFER, vertices.target.Get());
+    EXPECT_EQ("vertices", vertices.name);
+
+    const BufferView& indices = document.bufferViews.Get("1");
+    EXPECT_FALSE(indices.byteStride.HasValue());
+    EXPECT_EQ(ELEMENT_ARRAY_BUFFER, indices.target.Get());
+
+    const BufferView& other = document.bufferViews.Get("2");
+    EXPECT_EQ("1", other.bufferId);
+    EXPECT_EQ(0u, other.byteOffset);
+    EXPECT_FALSE(other.target.HasValue());
+}
+
+TEST(StreamingDeserializerTest, ReadsAccessors)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(7u, document.accessors.Size());
+
+    const Accessor& positions = document.accessors.Get("0");
+    EXPECT_EQ("0", positions.bufferViewId);
+    EXPECT_EQ(COMPONENT_FLOAT, positions.componentType);
+    EXPECT_EQ(3u, positions.count);
+    EXPECT_EQ(TYPE_VEC3, positions.type);
+    EXPECT_FALSE(positions.normalized);
+    EXPECT_EQ(vector<float>({ 1, 1, 0 }), positions.max);
+    EXPECT_EQ(vector<float>({ 0, 0, 0 }), positions.min);
+    EXPECT_EQ("positions", positions.name);
+
+    const Accessor& indices = document.accessors.Get("1");
+    EXPECT_EQ(2u, indices.byteOffset);
+    EXPECT_EQ(COMPONENT_UNSIGNED_SHORT, indices.componentType);
+    EXPECT_EQ(TYPE_SCALAR, indices.type);
+
+    const Accessor& colors = document.accessors.Get("2");
+    EXPECT_EQ(COMPONENT_UNSIGNED_BYTE, colors.componentType);
+    EXPECT_TRUE(colors.normalized);
+    EXPECT_EQ(TYPE_VEC4, colors.type);
+
+    const Accessor& times = document.accessors.Get("3");
+    EXPECT_EQ("", times.bufferViewId);
+
+    const Accessor& sparse = document.accessors.Get("5");
+    EXPECT_EQ(1u, sparse.sparse.count);
+    EXPECT_EQ("2", sparse.sparse.indicesBufferViewId);
+    EXPECT_EQ(4u, sparse.sparse.indicesByteOffset);
+    EXPECT_EQ(COMPONENT_UNSIGNED_INT, sparse.sparse.indicesComponentType);
+    EXPECT_EQ("2", sparse.sparse.valuesBufferViewId);
+    EXPECT_EQ(8u, sparse.sparse.valuesByteOffset);
+
+    EXPECT_EQ(TYPE_MAT4, document.accessors.Get("6").type);
+}
+
+TEST(StreamingDeserializerTest, ReadsImagesSamplersAndTextures)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(2u, document.images.Size());
+    EXPECT_EQ("wood.png", document.images.Get("0").uri);
+    EXPECT_EQ("wood", document.images.Get("0").name);
+    EXPECT_EQ("2", document.images.Get("1").bufferViewId);
+    EXPECT_EQ("image/jpeg", document.images.Get("1").mimeType);
+
+    ASSERT_EQ(1u, document.samplers.Size());
+    const Sampler& sampler = document.samplers.Get("0");
+    EXPECT_EQ(MagFilter_NEAREST, sampler.magFilter.Get());
+    EXPECT_EQ(MinFilter_NEAREST_MIPMAP_LINEAR, sampler.minFilter.Get());
+    EXPECT_EQ(Wrap_CLAMP_TO_EDGE, sampler.wrapS);
+    EXPECT_EQ(Wrap_MIRRORED_REPEAT, sampler.wrapT);
+    EXPECT_EQ("nearest", sampler.name);
+
+    ASSERT_EQ(2u, document.textures.Size());
+    EXPECT_EQ("0", document.textures.Get("0").samplerId);
+    EXPECT_EQ("1", document.textures.Get("0").imageId);
+    EXPECT_EQ("texture", document.textures.Get("0").name);
+    EXPECT_EQ("", document.textures.Get("1").samplerId);
+    EXPECT_EQ("0", document.textures.Get("1").imageId);
+}
+
+TEST(StreamingDeserializerTest, ReadsMaterials)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(1u, document.materials.Size());
+    const Material& material = document.materials.Get("0");
+    EXPECT_EQ("material", material.name);
+
+    const auto& pbr = material.metallicRoughness;
+    EXPECT_EQ(0.5f, pbr.baseColorFactor.r);
+    EXPECT_EQ(0.25f, pbr.baseColorFactor.g);
+    EXPECT_EQ(0.125f, pbr.baseColorFactor.b);
+    EXPECT_EQ(0.75f, pbr.baseColorFactor.a);
+    EXPECT_EQ("1", pbr.baseColorTexture.textureId);
+    EXPECT_EQ(1u, pbr.baseColorTexture.texCoord);
+    EXPECT_EQ(0.5f, pbr.metallicFactor);
+    EXPECT_EQ(0.25f, pbr.roughnessFactor);
+    EXPECT_EQ("0", pbr.metallicRoughnessTexture.textureId);
+    EXPECT_EQ(0u, pbr.metallicRoughnessTexture.texCoord);
+
+    EXPECT_EQ("0", material.normalTexture.textureId);
+    EXPECT_EQ(2.0f, material.normalTexture.scale);
+    EXPECT_EQ("1", material.occlusionTexture.textureId);
+    EXPECT_EQ(0.5f, material.occlusionTexture.strength);
+    EXPECT_EQ("0", material.emissiveTexture.textureId);
+    EXPECT_EQ("{\"scale\":[2,2]}", material.emissiveTexture.extensions.at("KHR_texture_transform"));
+
+    EXPECT_EQ(1.0f, material.emissiveFactor.r);
+    EXPECT_EQ(0.5f, material.emissiveFactor.g);
+    EXPECT_EQ(0.25f, material.emissiveFactor.b);
+    EXPECT_EQ(ALPHA_MASK, material.alphaMode);
+    EXPECT_EQ(0.25f, material.alphaCutoff);
+    EXPECT_TRUE(material.doubleSided);
+    EXPECT_EQ("{}", material.extensions.at("KHR_materials_unlit"));
+}
+
+TEST(StreamingDeserializerTest, ReadsMeshesAndSkins)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(1u, document.meshes.Size());
+    const Mesh& mesh = document.meshes.Get("0");
+    EXPECT_EQ("mesh", mesh.name);
+    EXPECT_EQ(vector<float>({ 0.5f }), mesh.weights);
+
+    ASSERT_EQ(1u, mesh.primitives.size());
+    const MeshPrimitive& primitive = mesh.primitives[0];
+    EXPECT_EQ(2u, primitive.attributes.size());
+    EXPECT_EQ("0", primitive.attributes.at(ACCESSOR_POSITION));
+    EXPECT_EQ("2", primitive.attributes.at(ACCESSOR_COLOR_0));
+    EXPECT_EQ("1", primitive.indicesAccessorId);
+    EXPECT_EQ("0", primitive.materialId);
+    EXPECT_EQ(MESH_TRIANGLE_STRIP, primitive.mode);
+    ASSERT_EQ(1u, primitive.targets.size());
+    EXPECT_EQ("5", primitive.targets[0].positionsAccessorId);
+    EXPECT_EQ("", primitive.targets[0].normalsAccessorId);
+
+    ASSERT_EQ(1u, document.skins.Size());
+    const Skin& skin = document.skins.Get("0");
+    EXPECT_EQ("6", skin.inverseBindMatricesAccessorId);
+    EXPECT_EQ("1", skin.skeletonId);
+    EXPECT_EQ(vector<string>({ "1", "2" }), skin.jointIds);
+    EXPECT_EQ("skin", skin.name);
+}
+
+TEST(StreamingDeserializerTest, ReadsNodesAndScenes)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(3u, document.nodes.Size());
+
+    const Node& root = document.nodes.Get("0");
+    EXPECT_EQ("root", root.name);
+    EXPECT_EQ(vector<string>({ "1", "2" }), root.children);
+    const array<float, 16> matrix = { 2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1 };
+    EXPECT_EQ(matrix, root.matrix.values);
+
+    const Node& child = document.nodes.Get("1");
+    EXPECT_EQ("0", child.meshId);
+    EXPECT_EQ("0", child.skinId);
+    EXPECT_EQ(vector<float>({ 0.25f }), child.weights);
+    EXPECT_EQ(1.0f, child.translation.x);
+    EXPECT_EQ(2.0f, child.translation.y);
+    EXPECT_EQ(3.0f, child.translation.z);
+    EXPECT_EQ(0.0f, child.rotation.x);
+    EXPECT_EQ(0.6f, child.rotation.y);
+    EXPECT_EQ(0.0f, child.rotation.z);
+    EXPECT_EQ(0.8f, child.rotation.w);
+    EXPECT_EQ(4.0f, child.scale.x);
+    EXPECT_EQ(5.0f, child.scale.y);
+    EXPECT_EQ(6.0f, child.scale.z);
+
+    EXPECT_EQ("{\"e\":true}", document.nodes.Get("2").extras);
+
+    ASSERT_EQ(2u, document.scenes.Size());
+    EXPECT_EQ(vector<string>({ "0" }), document.scenes.Get("0").nodes);
+    EXPECT_EQ("first", document.scenes.Get("0").name);
+    EXPECT_EQ(vector<string>({ "0", "2" }), document.scenes.Get("1").nodes);
+}
+
+TEST(StreamingDeserializerTest, ReadsAnimations)
+{
+    const Document document = Read(c_everyProperty);
+
+    ASSERT_EQ(1u, document.animations.Size());
+    const Animation& animation = document.animations.Get("0");
+    EXPECT_EQ("animation", animation.name);
+
+    ASSERT_EQ(2u, animation.channels.Size());
+    EXPECT_EQ("0", animation.channels.Get("0").samplerId);
+    EXPECT_EQ("1", animation.channels.Get("0").target.nodeId);
+    EXPECT_EQ(TARGET_ROTATION, animation.channels.Get("0").target.path);
+    EXPECT_EQ(TARGET_WEIGHTS, animation.channels.Get("1").target.path);
+
+    ASSERT_EQ(2u, animation.samplers.Size());
+    EXPECT_EQ("3", animation.samplers.Get("0").inputAccessorId);
+    EXPECT_EQ("4", animation.samplers.Get("0").outputAccessorId);
+    EXPECT_EQ(INTERPOLATION_STEP, animation.samplers.Get("0").interpolation);
+    EXPECT_EQ(INTERPOLATION_LINEAR, animation.samplers.Get("1").interpolation);
+}
+
+// Whitespace, members in another order and members that aren't glTF change nothing.
+TEST(StreamingDeserializerTest, SkipsUnknownMembers)
+{
+    const Document document = Read(R"( {
+        "unknown" : [ { "nested" : [1, "]"] } ],
+        "nodes" : [ { "camera" : 0, "future" : { }, "name" : "node" } ],
+        "cameras" : [ { "type" : "perspective", "perspective" : { "yfov" : 1, "znear" : 0.1 } } ],
+        "asset" : { "version" : "2.0", "unknown" : null }
+    } )");
+
+    EXPECT_EQ("2.0", document.asset.version);
+    ASSERT_EQ(1u, document.nodes.Size());
+    EXPECT_EQ("node", document.nodes.Get("0").name);
+    EXPECT_EQ(0u, document.cameras.Size());
+}
+
+// Documents DeserializeStreaming and the glTF SDK must read the same. Cameras are left out,
+// DeserializeStreaming skips them.
+static const char* const c_sameAsDeserialize[] =
+{
+    R"({"asset":{"version":"2.0"}})",
+    R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],"nodes":[{"translation":[1,2,3],"rotation":[0,0,0.6,0.8],"scale":[1,2,1]}]})",
+    R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":24}],"bufferViews":[{"buffer":0,"byteLength":24,"byteStride":12,"target":34962}],)"
+    R"("accessors":[{"bufferView":0,"componentType":5126,"count":2,"type":"VEC3","max":[1,1,1],"min":[0,0,0]}],)"
+    R"("meshes":[{"primitives":[{"attributes":{"POSITION":0},"mode":0}]}],"nodes":[{"mesh":0}]})",
+    c_everyProperty,
+};
+
+TEST(StreamingDeserializerTest, ReadsWhatDeserializeReads)
+{
+    for (const char* json : c_sameAsDeserialize)
+    {
+        EXPECT_TRUE(Deserialize(json) == Read(json)) << json;
+    }
+}
+
+// What Serialize writes of a document reads back as the same document.
+TEST(StreamingDeserializerTest, RoundTripsThroughSerialize)
+{
+    for (const char* json : c_sameAsDeserialize)
+    {
+        const Document document = Read(json);
+        const string serialized = Serialize(document);
+
+        EXPECT_TRUE(document == Read(serialized)) << serialized;
+    }
+}
+
+class StreamingDeserializerMalformedTest : public testing::TestWithParam<const char*>
+{
+};
+
+TEST_P(StreamingDeserializerMalformedTest, Throws)
+{
+    EXPECT_THROW(Read(GetParam()), InvalidGLTFException);
+}
+
+INSTANTIATE_TEST_SUITE_P(Documents, StreamingDeserializerMalformedTest, testing::Values(
+    "",
+    "[]",
+    R"({"asset":{"version":"2.0"})",
+    R"({"asset":{"version":"2.0"}} {})",
+    R"({"asset":{"version":2}})",
+    R"({"asset":{"version":"2.0"},"nodes":{}})",
+    R"({"asset":{"version":"2.0"},"nodes":[{"children":[-1]}]})",
+    R"({"asset":{"version":"2.0"},"nodes":[{"children":[1.5]}]})",
+    R"({"asset":{"version":"2.0"},"nodes":[{"translation":[1,2]}]})",
+    R"({"asset":{"version":"2.0"},"nodes":[{"rotation":[0,0,0,1,0]}]})",
+    R"({"asset":{"version":"2.0"},"nodes":[{"matrix":[1,0,0,0]}]})",
+    R"({"asset":{"version":"2.0"},"nodes":[{"mesh":"0"}]})",
+    R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5124,"count":1,"type":"SCALAR"}]})",
+    R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"count":1,"type":"VEC5"}]})",
+    R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"count":1,"type":"SCALAR","normalized":1}]})",
+    R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"count":1,"type":"SCALAR","sparse":{"count":1,"values":{"bufferView":0}}}]})",
+    R"({"asset":{"version":"2.0"},"bufferViews":[{"buffer":0,"byteLength":4,"target":1}]})",
+    R"({"asset":{"version":"2.0"},"samplers":[{"magFilter":9984}]})",
+    R"({"asset":{"version":"2.0"},"samplers":[{"minFilter":1}]})",
+    R"({"asset":{"version":"2.0"},"samplers":[{"wrapS":9729}]})",
+    R"({"asset":{"version":"2.0"},"materials":[{"alphaMode":"opaque"}]})",
+    R"({"asset":{"version":"2.0"},"materials":[{"emissiveFactor":[1,1,1,1]}]})",
+    R"({"asset":{"version":"2.0"},"meshes":[{"primitives":[{"attributes":{},"mode":7}]}]})",
+    R"({"asset":{"version":"2.0"},"meshes":[{"primitives":[]}]})",
+    R"({"asset":{"version":"2.0"},"meshes":[{"primitives":[{"attributes":{"POSITION":true}}]}]})",
+    R"({"asset":{"version":"2.0"},"animations":[{"channels":[{"sampler":0,"target":{"path":"skew"}}]}]})",
+    R"({"asset":{"version":"2.0"},"animations":[{"samplers":[{"input":0,"output":1,"interpolation":"CUBIC"}]}]})"));
+
+// Each member glTF requires, with the message naming the object it's missing from.
+struct MissingMember
+{
+    const char* json;
+    const char* message;
+};
+
+class StreamingDeserializerMissingMemberTest : public testing::TestWithParam<MissingMember>
+{
+};
+
+TEST_P(StreamingDeserializerMissingMemberTest, ThrowsNamingTheObject)
+{
+    try
+    {
+        Read(GetParam().json);
+        ADD_FAILURE() << "No exception for " << GetParam().json;
+    }
+    catch (const InvalidGLTFException& exception)
+    {
+        EXPECT_EQ(GetParam().message, string(exception.what()));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Documents, StreamingDeserializerMissingMemberTest, testing::Values(
+    MissingMember{ R"({})", "The document has no asset" },
+    MissingMember{ R"({"asset":{}})", "Asset has no version" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"accessors":[{"count":1,"type":"SCALAR"}]})", "Accessor 0 has no componentType" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"type":"SCALAR"}]})", "Accessor 0 has no count" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"count":1}]})", "Accessor 0 has no type" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":1},{"uri":"a.bin"}]})", "Buffer 1 has no byteLength" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"bufferViews":[{"byteLength":1}]})", "Buffer view 0 has no buffer" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"bufferViews":[{"buffer":0}]})", "Buffer view 0 has no byteLength" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"animations":[{"channels":[{"target":{"path":"scale"}}]}]})", "Animation channel 0 has no sampler" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"animations":[{"channels":[{"sampler":0,"target":{"node":0}}]}]})", "Animation channel 0 has no target path" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"animations":[{"samplers":[{"output":1}]}]})", "Animation sampler 0 has no input" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"animations":[{"samplers":[{"input":0}]}]})", "Animation sampler 0 has no output" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"materials":[{},{"normalTexture":{"scale":2}}]})", "Texture reference of material 1 has no index" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"skins":[{"skeleton":0}]})", "Skin 0 has no joints" },
+    MissingMember{ R"({"asset":{"version":"2.0"},"meshes":[{"name":"empty"}]})", "Mesh 0 has no primitives" }));
+
+// The limits are checked as the document is read, see LoadLimitsTests for DocumentLimitChecker.
+TEST(StreamingDeserializerTest, ChecksTheLimits)
+{
+    LoadLimits limits;
+    limits.maxNodeCount = 2;
+
+    EXPECT_NO_THROW(Read(R"({"asset":{"version":"2.0"},"nodes":[{"children":[1]},{}]})", limits));
+    EXPECT_THROW(Read(R"({"asset":{"version":"2.0"},"nodes":[{},{},{}]})", limits), LoadLimitException);
+
+    limits = LoadLimits();
+    limits.maxPrimitiveVertices = 100;
+
+    EXPECT_THROW(Read(R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"count":101,"type":"VEC3"}],)"
+        R"("meshes":[{"primitives":[{"attributes":{"POSITION":0}}]}]})", limits), LoadLimitException);
+
+    // Not a vertex accessor.
+    EXPECT_NO_THROW(Read(R"({"asset":{"version":"2.0"},"accessors":[{"componentType":5126,"count":101,"type":"SCALAR"}]})", limits));
+}
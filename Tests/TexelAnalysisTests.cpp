@@ -0,0 +1,169 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "TexelAnalysis.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// BGRA8 texels of unit normals whose x and y stay within half a unit of zero.
+static vector<uint8_t> MakeNormalMap(size_t texelCount, mt19937& random)
+{
+    uniform_real_distribution<float> component(-0.5f, 0.5f);
+    vector<uint8_t> texels(texelCount * 4);
+
+    for (size_t i = 0; i < texelCount; ++i)
+    {
+        float x = component(random);
+        float y = component(random);
+        float z = sqrt(max(0.0f, 1.0f - x * x - y * y));
+
+        texels[i * 4 + 0] = static_cast<uint8_t>(lrint(z * 127.5f + 127.5f));
+        texels[i * 4 + 1] = static_cast<uint8_t>(lrint(y * 127.5f + 127.5f));
+        texels[i * 4 + 2] = static_cast<uint8_t>(lrint(x * 127.5f + 127.5f));
+        texels[i * 4 + 3] = 255;
+    }
+
+    return texels;
+}
+
+static vector<uint8_t> RoundTrip(TexelLayout layout, const vector<uint8_t>& texels)
+{
+    const size_t texelCount = texels.size() / 4;
+
+    vector<uint8_t> packed(texelCount * GetTexelLayoutBytes(layout));
+    vector<uint8_t> unpacked(texels.size());
+
+    PackTexels(layout, texels.data(), texelCount, packed.data());
+    UnpackTexels(layout, packed.data(), texelCount, unpacked.data());
+
+    return unpacked;
+}
+
+// Counts around the 4 texel steps of the analysis and the blocks of the packers, so that
+// both the vector loops and their tails are covered.
+class TexelAnalysisTest : public testing::TestWithParam<size_t>
+{
+protected:
+    mt19937 m_random{ 3 };
+};
+
+TEST_P(TexelAnalysisTest, NormalMapsKeepRedAndGreen)
+{
+    const size_t texelCount = GetParam();
+    vector<uint8_t> texels = MakeNormalMap(texelCount, m_random);
+
+    TexelContent content = AnalyzeTexels(texels.data(), texelCount);
+
+    EXPECT_TRUE(content.isOpaque);
+    EXPECT_TRUE(content.isUnitNormal);
+
+    TexelLayout layout = ChooseTexelLayout(content, TexelUsage{ TexelChannel_Red | TexelChannel_Green | TexelChannel_Blue, true });
+
+    if (texelCount > 1)
+    {
+        EXPECT_EQ(layout, TexelLayout::RedGreenNormal8);
+    }
+
+    vector<uint8_t> unpacked = RoundTrip(layout, texels);
+
+    for (size_t i = 0; i < texels.size(); ++i)
+    {
+        ASSERT_NEAR(unpacked[i], texels[i], c_normalZTolerance) << "byte " << i;
+    }
+
+    // One bad texel, at the very end, is enough.
+    if (texelCount > 0)
+    {
+        texels[(texelCount - 1) * 4 + 3] = 200;
+        texels[(texelCount - 1) * 4 + 0] = 10;
+
+        content = AnalyzeTexels(texels.data(), texelCount);
+
+        EXPECT_FALSE(content.isOpaque);
+        EXPECT_FALSE(content.isUnitNormal);
+    }
+}
+
+TEST_P(TexelAnalysisTest, GrayscaleKeepsRedOnly)
+{
+    const size_t texelCount = GetParam();
+    vector<uint8_t> texels(texelCount * 4);
+
+    for (size_t i = 0; i < texelCount; ++i)
+    {
+        uint8_t value = static_cast<uint8_t>(m_random());
+        texels[i * 4 + 0] = texels[i * 4 + 1] = texels[i * 4 + 2] = value;
+        texels[i * 4 + 3] = 255;
+    }
+
+    TexelContent content = AnalyzeTexels(texels.data(), texelCount);
+
+    EXPECT_TRUE(content.isGrayscale);
+    EXPECT_TRUE(content.isOpaque);
+    EXPECT_EQ(ChooseTexelLayout(content, TexelUsage{}), TexelLayout::Red8);
+    EXPECT_EQ(RoundTrip(TexelLayout::Red8, texels), texels);
+
+    if (texelCount > 0)
+    {
+        texels[(texelCount / 2) * 4 + 1] ^= 1;
+        EXPECT_FALSE(AnalyzeTexels(texels.data(), texelCount).isGrayscale);
+    }
+}
+
+TEST_P(TexelAnalysisTest, ColorKeepsWhatIsSampled)
+{
+    const size_t texelCount = GetParam();
+    vector<uint8_t> texels(texelCount * 4);
+
+    for (auto& byte : texels)
+    {
+        byte = static_cast<uint8_t>(m_random());
+    }
+
+    if (texelCount > 0)
+    {
+        EXPECT_EQ(ChooseTexelLayout(AnalyzeTexels(texels.data(), texelCount), TexelUsage{}), TexelLayout::Bgra8);
+        EXPECT_EQ(RoundTrip(TexelLayout::Bgra8, texels), texels);
+    }
+
+    MakeTexelsOpaque(texels.data(), texelCount);
+
+    TexelContent content = AnalyzeTexels(texels.data(), texelCount);
+
+    EXPECT_TRUE(content.isOpaque);
+    EXPECT_EQ(RoundTrip(TexelLayout::Bgr8, texels), texels);
+
+    if (texelCount > 4)
+    {
+        EXPECT_EQ(ChooseTexelLayout(content, TexelUsage{}), TexelLayout::Bgr8);
+    }
+
+    // Occlusion only samples red.
+    EXPECT_EQ(ChooseTexelLayout(content, TexelUsage{ TexelChannel_Red, false }), TexelLayout::Red8);
+}
+
+INSTANTIATE_TEST_SUITE_P(TexelCounts, TexelAnalysisTest, testing::Values(0, 1, 3, 4, 5, 17, 1023, 1024, 1025, 5000));
+
+TEST(TexelLayoutTest, LayoutsHaveTheirSizes)
+{
+    EXPECT_EQ(GetTexelLayoutBytes(TexelLayout::Bgra8), 4u);
+    EXPECT_EQ(GetTexelLayoutBytes(TexelLayout::Bgr8), 3u);
+    EXPECT_EQ(GetTexelLayoutBytes(TexelLayout::Red8), 1u);
+    EXPECT_EQ(GetTexelLayoutBytes(TexelLayout::RedGreenNormal8), 2u);
+}
+
+// Alpha that is sampled keeps all four channels even when the color is gray.
+TEST(TexelLayoutTest, SampledAlphaIsKept)
+{
+    TexelContent content = { false, true, false };
+
+    EXPECT_EQ(ChooseTexelLayout(content, TexelUsage{}), TexelLayout::Bgra8);
+    EXPECT_EQ(ChooseTexelLayout(content, TexelUsage{ TexelChannel_Red | TexelChannel_Green | TexelChannel_Blue, false }), TexelLayout::Red8);
+}
@@ -0,0 +1,205 @@
+// Licensed to the .NET Foundation under one or more agreements.
+// The .NET Foundation licenses this file to you under the MIT license.
+// See the LICENSE file in the project root for more information.
+
+#include "pch.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "TextureAtlas.h"
+
+using namespace std;
+using namespace SceneLoader;
+
+// The aligned rectangle a tile takes on its page, gutter included.
+struct TileSlot
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+static TileSlot GetSlot(const AtlasTile& tile)
+{
+    auto align = [](uint32_t value) { return (value + c_atlasTileAlignment - 1) / c_atlasTileAlignment * c_atlasTileAlignment; };
+
+    return { tile.x - c_atlasGutter, tile.y - c_atlasGutter, align(tile.width + 2 * c_atlasGutter), align(tile.height + 2 * c_atlasGutter) };
+}
+
+// Where sampling texel i of an n texel axis lands inside the texture.
+static int WrapTexel(int i, int n, AtlasWrapMode mode)
+{
+    switch (mode)
+    {
+    case AtlasWrapMode::Repeat:
+        return ((i % n) + n) % n;
+
+    case AtlasWrapMode::MirroredRepeat:
+    {
+        int period = ((i % (2 * n)) + 2 * n) % (2 * n);
+        return period < n ? period : 2 * n - 1 - period;
+    }
+
+    default:
+        return min(max(i, 0), n - 1);
+    }
+}
+
+TEST(TextureAtlasTest, PacksTilesWithoutOverlap)
+{
+    mt19937 random(5);
+    const uint32_t dimensions[] = { 64, 96, 128, 200, 256, 32, 17, 1 };
+
+    vector<AtlasSize> sizes;
+
+    for (int i = 0; i < 300; ++i)
+    {
+        sizes.push_back({ dimensions[random() % size(dimensions)], dimensions[random() % size(dimensions)] });
+    }
+
+    AtlasLayout layout = PackAtlas(sizes);
+
+    ASSERT_EQ(layout.tiles.size(), sizes.size());
+
+    for (const auto& page : layout.pages)
+    {
+        EXPECT_LE(page.width, c_maxAtlasPageSize);
+        EXPECT_LE(page.height, c_maxAtlasPageSize);
+        EXPECT_EQ(page.width % c_atlasTileAlignment, 0u);
+        EXPECT_EQ(page.height % c_atlasTileAlignment, 0u);
+    }
+
+    for (size_t a = 0; a < sizes.size(); ++a)
+    {
+        const AtlasTile& tile = layout.tiles[a];
+        TileSlot slot = GetSlot(tile);
+
+        EXPECT_EQ(tile.width, sizes[a].width);
+        EXPECT_EQ(tile.height, sizes[a].height);
+        EXPECT_EQ(slot.x % c_atlasTileAlignment, 0u);
+        EXPECT_EQ(slot.y % c_atlasTileAlignment, 0u);
+
+        ASSERT_LT(tile.page, layout.pages.size());
+        EXPECT_LE(slot.x + slot.width, layout.pages[tile.page].width) << "tile " << a;
+        EXPECT_LE(slot.y + slot.height, layout.pages[tile.page].height) << "tile " << a;
+
+        for (size_t b = a + 1; b < sizes.size(); ++b)
+        {
+            if (layout.tiles[b].page != tile.page)
+            {
+                continue;
+            }
+
+            TileSlot other = GetSlot(layout.tiles[b]);
+
+            bool overlaps = slot.x < other.x + other.width && other.x < slot.x + slot.width &&
+                slot.y < other.y + other.height && other.y < slot.y + slot.height;
+
+            EXPECT_FALSE(overlaps) << "tiles " << a << " and " << b;
+        }
+    }
+}
+
+TEST(TextureAtlasTest, FitsAtlasPageLeavesRoomForTheGutter)
+{
+    EXPECT_TRUE(FitsAtlasPage(1, 1));
+    EXPECT_TRUE(FitsAtlasPage(c_maxAtlasPageSize - 2 * c_atlasGutter, 16));
+    EXPECT_FALSE(FitsAtlasPage(c_maxAtlasPageSize, 16));
+    EXPECT_FALSE(FitsAtlasPage(16, c_maxAtlasPageSize - 2 * c_atlasGutter + 1));
+}
+
+TEST(TextureAtlasTest, OverheadExcludesTheTextures)
+{
+    AtlasLayout layout = PackAtlas({ { 120, 120 } });
+
+    ASSERT_EQ(layout.pages.size(), 1u);
+
+    uint64_t pageBytes = uint64_t(layout.pages[0].width) * layout.pages[0].height * 4;
+    uint64_t overhead = GetAtlasOverheadBytes(layout);
+
+    EXPECT_GT(overhead, 0u);
+    EXPECT_LT(overhead, pageBytes * 4 / 3);
+}
+
+class TextureAtlasGutterTest : public testing::TestWithParam<AtlasWrapMode>
+{
+};
+
+// The gutter holds what sampling the texture just past its edges would give.
+TEST_P(TextureAtlasGutterTest, GutterRepeatsTheWrappedTexture)
+{
+    const AtlasWrapMode mode = GetParam();
+    const vector<AtlasSize> sizes = { { 5, 3 }, { 7, 9 } };
+
+    AtlasLayout layout = PackAtlas(sizes);
+
+    ASSERT_EQ(layout.pages.size(), 1u);
+
+    const uint32_t pageWidth = layout.pages[0].width;
+    vector<uint32_t> page(size_t(pageWidth) * layout.pages[0].height);
+
+    for (size_t t = 0; t < sizes.size(); ++t)
+    {
+        const AtlasTile& tile = layout.tiles[t];
+        vector<uint32_t> texels(size_t(tile.width) * tile.height);
+
+        for (size_t i = 0; i < texels.size(); ++i)
+        {
+            texels[i] = static_cast<uint32_t>(i + 1 + t * 1000);
+        }
+
+        CopyTileWithGutter(reinterpret_cast<uint8_t*>(page.data()), pageWidth * 4, tile, reinterpret_cast<const uint8_t*>(texels.data()), mode, mode);
+
+        const int gutter = static_cast<int>(c_atlasGutter);
+        const int width = static_cast<int>(tile.width);
+        const int height = static_cast<int>(tile.height);
+
+        for (int y = -gutter; y < height + gutter; ++y)
+        {
+            for (int x = -gutter; x < width + gutter; ++x)
+            {
+                uint32_t expected = texels[WrapTexel(y, height, mode) * width + WrapTexel(x, width, mode)];
+
+                ASSERT_EQ(page[(tile.y + y) * pageWidth + tile.x + x], expected) << "tile " << t << " at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(WrapModes, TextureAtlasGutterTest, testing::Values(AtlasWrapMode::ClampToEdge, AtlasWrapMode::Repeat, AtlasWrapMode::MirroredRepeat));
+
+// Texel centers of the texture land on texel centers of the tile; clamped coordinates are
+// clamped to the tile first.
+TEST(TextureAtlasTest, RemapsTexCoordsIntoTheTile)
+{
+    const AtlasTile tile = { 0, 24, 40, 64, 32 };
+    const AtlasSize page = { 256, 128 };
+
+    float texCoords[4] = { 0.5f / 64, 0.5f / 32, 1.5f, -0.2f };
+
+    RemapTexCoordsToTile(texCoords, 2, tile, page, AtlasWrapMode::ClampToEdge, AtlasWrapMode::ClampToEdge);
+
+    EXPECT_NEAR(texCoords[0] * page.width, 24.5f, 1e-3f);
+    EXPECT_NEAR(texCoords[1] * page.height, 40.5f, 1e-3f);
+    EXPECT_NEAR(texCoords[2] * page.width, 88.0f, 1e-3f);
+    EXPECT_NEAR(texCoords[3] * page.height, 40.0f, 1e-3f);
+}
+
+TEST(TextureAtlasTest, OnlyWrappedTexCoordsWithinTheGutterFit)
+{
+    const AtlasSize size = { 64, 32 };
+
+    const float pastTheGutter[2] = { 1.1f, 0.5f };
+    EXPECT_FALSE(TexCoordsFitTile(pastTheGutter, 1, size, AtlasWrapMode::Repeat, AtlasWrapMode::Repeat));
+
+    const float clamped[2] = { 1.05f, 0.5f };
+    EXPECT_TRUE(TexCoordsFitTile(clamped, 1, size, AtlasWrapMode::ClampToEdge, AtlasWrapMode::Repeat));
+
+    const float inside[2] = { 0.99f, 0.01f };
+    EXPECT_TRUE(TexCoordsFitTile(inside, 1, size, AtlasWrapMode::Repeat, AtlasWrapMode::MirroredRepeat));
+
+    const float notANumber[2] = { NAN, 0.5f };
+    EXPECT_FALSE(TexCoordsFitTile(notANumber, 1, size, AtlasWrapMode::ClampToEdge, AtlasWrapMode::Repeat));
+}